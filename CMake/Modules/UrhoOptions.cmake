@@ -189,6 +189,7 @@ option                (URHO3D_PHYSICS            "Physics subsystem enabled"
 cmake_dependent_option(URHO3D_PROFILING          "Profiler support enabled"                              ${URHO3D_ENABLE_ALL} "NOT EMSCRIPTEN;NOT MINGW;NOT UWP"     OFF)
 cmake_dependent_option(URHO3D_PROFILING_FALLBACK "Profiler uses low-precision timer"                     OFF                  "URHO3D_PROFILING"              OFF)
 cmake_dependent_option(URHO3D_PROFILING_SYSTRACE "Profiler systrace support enabled"                     OFF                  "URHO3D_PROFILING"              OFF)
+option                (URHO3D_FRAME_PROFILER     "Built-in frame profiler enabled"                       ${URHO3D_ENABLE_ALL})
 option                (URHO3D_SYSTEMUI           "Build SystemUI subsystem"                              ${URHO3D_ENABLE_ALL})
 option                (URHO3D_URHO2D             "2D subsystem enabled"                                  ${URHO3D_ENABLE_ALL})
 option                (URHO3D_PHYSICS2D          "2D physics subsystem enabled"                          ${URHO3D_ENABLE_ALL})
@@ -218,6 +219,8 @@ option                (URHO3D_MONOLITHIC_HEADER  "Create Urho3DAll.h which inclu
 cmake_dependent_option(URHO3D_MINIDUMPS          "Enable writing minidumps on crash"                     ${URHO3D_ENABLE_ALL} "MSVC;NOT UWP"                  OFF)
 cmake_dependent_option(URHO3D_PLUGINS            "Enable plugins"                                        ${URHO3D_ENABLE_ALL} "NOT EMSCRIPTEN;NOT UWP"               OFF)
 cmake_dependent_option(URHO3D_THREADING          "Enable multithreading"                                 ${URHO3D_ENABLE_ALL} "NOT EMSCRIPTEN"                       OFF)
+# Depends on URHO3D_THREADING and must be declared after it.
+cmake_dependent_option(URHO3D_PHYSICS_THREADED   "Thread-safe Bullet build for multithreaded physics"     OFF                  "URHO3D_PHYSICS;URHO3D_THREADING" OFF)
 option                (URHO3D_WEBP               "WebP support enabled"                                  ${URHO3D_ENABLE_ALL}                                    )
 cmake_dependent_option(URHO3D_TESTING            "Enable unit tests"                                     OFF                  "NOT EMSCRIPTEN;NOT MOBILE;NOT UWP"    OFF)
 option                (URHO3D_PACKAGING          "Enable *.pak file creation"                            OFF                                                     )
@@ -23,6 +23,7 @@
 #include "../Project/AssetManager.h"
 #include "../Project/Project.h"
 
+#include <Urho3D/Core/WorkQueue.h>
 #include <Urho3D/IO/ArchiveSerialization.h>
 #include <Urho3D/IO/Log.h>
 #include <Urho3D/Resource/JSONArchive.h>
@@ -63,6 +64,7 @@ AssetManager::AssetManager(Context* context)
     , project_(GetSubsystem<Project>())
     , dataWatcher_(MakeShared<FileWatcher>(context))
     , transformerHierarchy_(MakeShared<AssetTransformerHierarchy>(context_))
+    , cookingStore_(ea::make_shared<AssetCookingStore>(context_))
 {
     dataWatcher_->StartWatching(project_->GetDataPath(), true);
     context_->OnReflectionRemoved.Subscribe(this, &AssetManager::OnReflectionRemoved);
@@ -86,6 +88,7 @@ void AssetManager::SetProcessCallback(const OnProcessAssetQueued& callback, unsi
 void AssetManager::Initialize(bool readOnly)
 {
     autoProcessAssets_ = !readOnly;
+    cookingStore_->SetStorePath(project_->GetAssetStorePath());
 
     InitializeAssetPipelines();
     InvalidateOutdatedAssetsInPath("");
@@ -143,12 +146,66 @@ void AssetManager::ConsumeAssetQueue()
 
     for (const AssetTransformerInput& input : queue)
     {
-        processCallback_(input,
-            [this](const AssetTransformerInput& input, const ea::optional<AssetTransformerOutput>& output, const ea::string& message)
+        if (cookingStore_->IsEnabled())
+            RestoreCookedAssetAsync(input);
+        else
+            ProcessQueuedAsset(input);
+    }
+}
+
+void AssetManager::ProcessQueuedAsset(const AssetTransformerInput& input)
+{
+    processCallback_(input,
+        [this](const AssetTransformerInput& input, const ea::optional<AssetTransformerOutput>& output, const ea::string& message)
+    {
+        CompleteAssetProcessing(input, output, message);
+    });
+}
+
+void AssetManager::RestoreCookedAssetAsync(const AssetTransformerInput& input)
+{
+    // Calculate the key before processing because transformers may modify the source.
+    // Transformers are serialized here, files are hashed and restored in worker thread.
+    const AssetTransformerVector transformers = transformerHierarchy_->GetTransformerCandidates(
+        input.resourceName_, input.flavor_);
+    const unsigned long long transformersHash = cookingStore_->GetTransformersHash(transformers);
+
+    auto workQueue = GetSubsystem<WorkQueue>();
+    // Don't copy or release the weak pointer on worker thread, reference counting is not atomic.
+    // The store is released on main thread too because its destructor unregisters it from Context.
+    WeakPtr<AssetManager> weakSelf{this};
+    ea::shared_ptr<AssetCookingStore> cookingStore = cookingStore_;
+    const ea::string cachePath = project_->GetCachePath();
+    workQueue->PostTask([weakSelf, cookingStore, input, transformersHash, cachePath](
+        unsigned /*threadIndex*/, WorkQueue* queue) mutable
+    {
+        ea::string key = cookingStore->GetCookingKey(input, transformersHash);
+        ea::optional<AssetTransformerOutput> output;
+        if (!key.empty())
+            output = cookingStore->Restore(key, input, cachePath);
+
+        queue->PostTaskForMainThread([weakSelf = ea::move(weakSelf), cookingStore = ea::move(cookingStore), input,
+            key = ea::move(key), output = ea::move(output)]
         {
-            CompleteAssetProcessing(input, output, message);
+            if (const auto self = weakSelf.Lock())
+                self->CompleteCookedAssetRestore(input, key, output);
         });
+    }, TaskPriority::Low);
+}
+
+void AssetManager::CompleteCookedAssetRestore(
+    const AssetTransformerInput& input, const ea::string& key, const ea::optional<AssetTransformerOutput>& output)
+{
+    if (output)
+    {
+        URHO3D_LOGDEBUG("Asset {} was restored from the asset store ({})", input.resourceName_, key);
+        CompleteAssetProcessing(input, output, EMPTY_STRING);
+        return;
     }
+
+    if (!key.empty())
+        cookingKeys_[input.resourceName_] = key;
+    ProcessQueuedAsset(input);
 }
 
 void AssetManager::MarkCacheDirty(const ea::string& resourcePath)
@@ -601,6 +658,14 @@ void AssetManager::CompleteAssetProcessing(
 
     ++progress_.first;
 
+    const auto keyIter = cookingKeys_.find(input.resourceName_);
+    if (keyIter != cookingKeys_.end())
+    {
+        if (output)
+            cookingStore_->Store(keyIter->second, input, *output, project_->GetCachePath());
+        cookingKeys_.erase(keyIter);
+    }
+
     if (output)
     {
         AssetDesc& assetDesc = assets_[input.resourceName_];
@@ -26,11 +26,13 @@
 #include <Urho3D/IO/FileSystem.h>
 #include <Urho3D/IO/FileWatcher.h>
 #include <Urho3D/Scene/Serializable.h>
+#include <Urho3D/Utility/AssetCookingStore.h>
 #include <Urho3D/Utility/AssetPipeline.h>
 #include <Urho3D/Utility/AssetTransformerHierarchy.h>
 
 #include <EASTL/functional.h>
 #include <EASTL/map.h>
+#include <EASTL/shared_ptr.h>
 #include <EASTL/optional.h>
 #include <EASTL/unordered_set.h>
 
@@ -160,6 +162,10 @@ private:
     void ScanAssetsInPath(const ea::string& resourcePath, Stats& stats);
     bool QueueAssetProcessing(const ea::string& resourceName, const ApplicationFlavor& flavor);
     void ConsumeAssetQueue();
+    void ProcessQueuedAsset(const AssetTransformerInput& input);
+    void RestoreCookedAssetAsync(const AssetTransformerInput& input);
+    void CompleteCookedAssetRestore(const AssetTransformerInput& input, const ea::string& key,
+        const ea::optional<AssetTransformerOutput>& output);
 
     void CompleteAssetProcessing(
         const AssetTransformerInput& input, const ea::optional<AssetTransformerOutput>& output, const ea::string& message);
@@ -186,6 +192,11 @@ private:
     AssetPipelineList assetPipelineFiles_;
     ea::unordered_set<ea::string> ignoredAssetUpdates_;
 
+    /// Shared with restore tasks on worker threads, hence atomic reference counting.
+    ea::shared_ptr<AssetCookingStore> cookingStore_;
+    /// Cooking keys of ongoing requests, calculated before the asset is processed.
+    ea::unordered_map<ea::string, ea::string> cookingKeys_;
+
     ea::vector<AssetTransformerInput> requestQueue_;
     unsigned numOngoingRequests_{};
 
@@ -68,6 +68,7 @@ ImFont* monoFont = nullptr;
 unsigned numActiveProjects = 0;
 
 const ea::string selfIniEntry{"Project"};
+const ea::string defaultAssetStorePath{"AssetStore/"};
 
 bool IsEscapedChar(const char ch)
 {
@@ -216,6 +217,7 @@ Project::Project(
     , gitIgnorePath_(projectPath_ + ".gitignore")
     , previewPngPath_(projectPath_ + "Preview.png")
     , dataPath_(projectPath_ + "Data/")
+    , assetStorePath_(defaultAssetStorePath)
     , oldCacheState_(context)
     , hotkeyManager_(MakeShared<HotkeyManager>(context_))
     , undoManager_(MakeShared<UndoManager>(context_))
@@ -284,6 +286,7 @@ void Project::SerializeInBlock(Archive& archive)
 {
     SerializeOptionalValue(archive, "PluginManager", *pluginManager_, AlwaysSerialize{});
     SerializeOptionalValue(archive, "LaunchManager", *launchManager_, AlwaysSerialize{});
+    SerializeOptionalValue(archive, "AssetStorePath", assetStorePath_, defaultAssetStorePath);
 }
 
 void Project::ExecuteCommand(const ea::string& command, bool exitOnCompletion)
@@ -534,6 +537,13 @@ ea::string Project::GetRandomTemporaryPath() const
     return Format("{}{}/", tempPath_, GenerateUUID());
 }
 
+ea::string Project::GetAssetStorePath() const
+{
+    if (assetStorePath_.empty())
+        return EMPTY_STRING;
+    return AddTrailingSlash(IsAbsolutePath(assetStorePath_) ? assetStorePath_ : projectPath_ + assetStorePath_);
+}
+
 TemporaryDir Project::CreateTemporaryDir()
 {
     return TemporaryDir{context_, GetRandomTemporaryPath()};
@@ -725,6 +735,7 @@ void Project::SaveGitIgnore()
     content += "# Ignore asset cache\n";
     content += "/Cache/\n";
     content += "/Cache.json\n";
+    content += "/AssetStore/\n";
     content += "\n";
 
     content += "# Ignore temporary files\n";
@@ -209,6 +209,8 @@ public:
     const ea::string& GetCachePath() const { return cachePath_; }
     const ea::string& GetArtifactsPath() const { return artifactsPath_; }
     const ea::string& GetPreviewPngPath() const { return previewPngPath_; }
+    /// Return absolute path to the content-addressed store of cooked assets. Empty if disabled.
+    ea::string GetAssetStorePath() const;
     /// @}
 
     /// Return singletons
@@ -292,6 +294,8 @@ private:
     const ea::string previewPngPath_;
 
     ea::string dataPath_;
+    /// Path to cooked asset store, absolute or relative to the project. May be shared between projects and machines.
+    ea::string assetStorePath_;
 
     const ResourceCacheGuard oldCacheState_;
     /// @}
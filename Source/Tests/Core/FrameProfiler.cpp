@@ -0,0 +1,95 @@
+//
+// Copyright (c) 2017-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../CommonUtils.h"
+
+#include <Urho3D/Core/FrameProfiler.h>
+#include <Urho3D/Core/WorkQueue.h>
+#include <Urho3D/IO/VectorBuffer.h>
+#include <Urho3D/Resource/JSONFile.h>
+
+TEST_CASE("FrameProfiler collects scopes from all threads")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    auto workQueue = context->GetSubsystem<WorkQueue>();
+
+    auto profiler = MakeShared<FrameProfiler>(context);
+
+    // Nothing is recorded while disabled
+    {
+        FrameProfilerScope scope("Disabled");
+    }
+    profiler->SetEnabled(true);
+    profiler->EndFrame(1);
+    REQUIRE(profiler->GetFrames().size() == 1);
+    REQUIRE(profiler->GetScopeStats("Disabled") == nullptr);
+
+    static constexpr unsigned NumElements = 64;
+    {
+        FrameProfilerScope outerScope("Outer");
+        workQueue->ParallelFor(NumElements, 1, [&](unsigned beginIndex, unsigned endIndex)
+        {
+            for (unsigned i = beginIndex; i < endIndex; ++i)
+                FrameProfilerScope innerScope("Inner \"quoted\"");
+        });
+    }
+    profiler->EndFrame(2);
+    profiler->SetEnabled(false);
+
+    REQUIRE(profiler->GetFrames().size() == 2);
+    const FrameProfilerFrame& frame = profiler->GetFrames().back();
+    CHECK(frame.frameNumber_ == 2);
+    // Engine code may record its own scopes too
+    CHECK(frame.events_.size() >= NumElements + 1);
+    CHECK(frame.numDroppedEvents_ == 0);
+
+    const FrameProfilerScopeStats* outerStats = profiler->GetScopeStats("Outer");
+    const FrameProfilerScopeStats* innerStats = profiler->GetScopeStats("Inner \"quoted\"");
+    REQUIRE(outerStats);
+    REQUIRE(innerStats);
+    CHECK(outerStats->count_ == 1);
+    CHECK(innerStats->count_ == NumElements);
+    CHECK(outerStats->maxMs_ >= innerStats->maxMs_);
+
+    // Trace is valid JSON with one event per scope, frame and thread name
+    VectorBuffer buffer;
+    REQUIRE(profiler->ExportChromeTrace(buffer));
+    const ea::string trace{reinterpret_cast<const char*>(buffer.GetData()), buffer.GetSize()};
+
+    JSONFile jsonFile(context);
+    REQUIRE(jsonFile.FromString(trace));
+    const JSONArray& traceEvents = jsonFile.GetRoot()["traceEvents"].GetArray();
+    unsigned numScopeEvents = 0;
+    unsigned numFrameEvents = 0;
+    for (const JSONValue& event : traceEvents)
+    {
+        if (event["ph"].GetString() != "X")
+            continue;
+        if (event["name"].GetString().starts_with("Frame "))
+            ++numFrameEvents;
+        else
+            ++numScopeEvents;
+    }
+    CHECK(numFrameEvents == 2);
+    CHECK(numScopeEvents == profiler->GetFrames()[0].events_.size() + frame.events_.size());
+}
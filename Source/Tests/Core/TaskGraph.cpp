@@ -0,0 +1,139 @@
+//
+// Copyright (c) 2017-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../CommonUtils.h"
+
+#include <Urho3D/Core/TaskGraph.h>
+#include <Urho3D/Core/WorkQueue.h>
+
+#include <atomic>
+
+TEST_CASE("ParallelFor processes every element exactly once")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    auto workQueue = context->GetSubsystem<WorkQueue>();
+
+    static constexpr unsigned NumElements = 10000;
+    ea::vector<std::atomic<unsigned>> counters(NumElements);
+
+    // Nested loops should not deadlock
+    workQueue->ParallelFor(NumElements / 100, 1, [&](unsigned beginIndex, unsigned endIndex)
+    {
+        for (unsigned i = beginIndex; i < endIndex; ++i)
+        {
+            workQueue->ParallelFor(100, 10, [&, i](unsigned innerBegin, unsigned innerEnd, unsigned threadIndex)
+            {
+                CHECK(threadIndex < WorkQueue::GetThreadIndexCount());
+                for (unsigned j = innerBegin; j < innerEnd; ++j)
+                    ++counters[i * 100 + j];
+            });
+        }
+    });
+
+    for (unsigned i = 0; i < NumElements; ++i)
+        REQUIRE(counters[i] == 1);
+}
+
+TEST_CASE("TaskGraph executes tasks after their dependencies")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    auto workQueue = context->GetSubsystem<WorkQueue>();
+
+    static constexpr unsigned NumElements = 1000;
+    ea::vector<unsigned> values(NumElements);
+    std::atomic<unsigned> sum{};
+    unsigned result{};
+
+    // fill -> square -> sum -> store
+    TaskGraph graph(workQueue);
+    const auto fillTask = graph.AddParallelFor(NumElements, 16, [&](unsigned beginIndex, unsigned endIndex)
+    {
+        for (unsigned i = beginIndex; i < endIndex; ++i)
+            values[i] = i;
+    });
+    const auto squareTask = graph.AddParallelFor(NumElements, 16, [&](unsigned beginIndex, unsigned endIndex)
+    {
+        for (unsigned i = beginIndex; i < endIndex; ++i)
+            values[i] *= values[i];
+    });
+    const auto sumTask = graph.AddParallelFor(NumElements, 16, [&](unsigned beginIndex, unsigned endIndex)
+    {
+        unsigned localSum = 0;
+        for (unsigned i = beginIndex; i < endIndex; ++i)
+            localSum += values[i];
+        sum += localSum;
+    });
+    graph.AddContinuation(sumTask, [&] { result = sum.load(); });
+
+    // Dependencies don't have to follow the order of addition
+    graph.AddDependency(sumTask, squareTask);
+    graph.AddDependency(squareTask, fillTask);
+
+    unsigned expected = 0;
+    for (unsigned i = 0; i < NumElements; ++i)
+        expected += i * i;
+
+    graph.Execute();
+    REQUIRE(result == expected);
+
+    // Graph can be executed again
+    sum = 0;
+    result = 0;
+    graph.Execute();
+    REQUIRE(result == expected);
+    REQUIRE_FALSE(graph.IsRunning());
+}
+
+TEST_CASE("ParallelFor is faster than ForEachParallel", "[.][benchmark]")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    auto workQueue = context->GetSubsystem<WorkQueue>();
+
+    static constexpr unsigned NumElements = 100000;
+    ea::vector<float> values(NumElements, 1.0f);
+
+    const auto processRange = [&](unsigned beginIndex, unsigned endIndex)
+    {
+        for (unsigned i = beginIndex; i < endIndex; ++i)
+            values[i] = Sqrt(values[i] + static_cast<float>(i));
+    };
+
+    BENCHMARK("ForEachParallel")
+    {
+        ForEachParallel(workQueue, 64, NumElements, processRange);
+        return values[0];
+    };
+
+    BENCHMARK("ParallelFor")
+    {
+        workQueue->ParallelFor(NumElements, 64, processRange);
+        return values[0];
+    };
+
+    BENCHMARK("TaskGraph")
+    {
+        TaskGraph graph(workQueue);
+        graph.AddParallelFor(NumElements, 64, processRange);
+        graph.Execute();
+        return values[0];
+    };
+}
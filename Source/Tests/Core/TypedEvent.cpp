@@ -0,0 +1,189 @@
+//
+// Copyright (c) 2017-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../CommonUtils.h"
+
+#include <Urho3D/Core/TypedEvent.h>
+
+namespace
+{
+
+URHO3D_EVENT(E_TESTVARIANTEVENT, TestVariantEvent)
+{
+    URHO3D_PARAM(P_VALUE, Value); // int
+}
+
+struct TestTypedEvent
+{
+    URHO3D_TYPED_EVENT(TestTypedEvent);
+    int value_{};
+};
+
+class TestReceiver : public Object
+{
+    URHO3D_OBJECT(TestReceiver, Object);
+
+public:
+    explicit TestReceiver(Context* context) : Object(context) {}
+
+    void HandleTypedEvent(TestTypedEvent& event) { sum_ += event.value_; }
+    void HandleVariantEvent(StringHash eventType, VariantMap& eventData) { sum_ += eventData[TestVariantEvent::P_VALUE].GetInt(); }
+
+    int sum_{};
+};
+
+}
+
+TEST_CASE("Typed events are delivered to subscribers")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+
+    auto sender = MakeShared<TestReceiver>(context);
+    auto otherSender = MakeShared<TestReceiver>(context);
+    auto receiver = MakeShared<TestReceiver>(context);
+    auto specificReceiver = MakeShared<TestReceiver>(context);
+    auto memberReceiver = MakeShared<TestReceiver>(context);
+
+    receiver->SubscribeToTypedEvent<TestTypedEvent>([&](TestTypedEvent& event) { receiver->sum_ += event.value_; });
+    specificReceiver->SubscribeToTypedEvent<TestTypedEvent>(sender,
+        [](Object* receiver, TestTypedEvent& event) { static_cast<TestReceiver*>(receiver)->sum_ += event.value_; });
+    memberReceiver->SubscribeToTypedEvent<TestTypedEvent>(&TestReceiver::HandleTypedEvent);
+
+    TestTypedEvent event{1};
+    sender->SendTypedEvent(event);
+    event.value_ = 10;
+    otherSender->SendTypedEvent(event);
+
+    REQUIRE(receiver->sum_ == 11);
+    REQUIRE(specificReceiver->sum_ == 1);
+    REQUIRE(memberReceiver->sum_ == 11);
+
+    // Unsubscribed and destroyed receivers are skipped
+    receiver->UnsubscribeFromTypedEvent<TestTypedEvent>();
+    memberReceiver = nullptr;
+
+    event.value_ = 100;
+    sender->SendTypedEvent(event);
+
+    REQUIRE(receiver->sum_ == 11);
+    REQUIRE(specificReceiver->sum_ == 101);
+
+    auto& channel = context->GetTypedEventChannel<TestTypedEvent>();
+    REQUIRE(channel.GetNumSubscriptions() == 1);
+    REQUIRE(channel.HasSubscription(specificReceiver, sender));
+    REQUIRE_FALSE(channel.HasSubscription(receiver, nullptr));
+
+    // Subscriptions of destroyed sender expire
+    sender = nullptr;
+    otherSender->SendTypedEvent(event);
+    REQUIRE(channel.GetNumSubscriptions() == 0);
+}
+
+TEST_CASE("Typed events may be subscribed and unsubscribed during sending")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+
+    auto sender = MakeShared<TestReceiver>(context);
+    auto receiverA = MakeShared<TestReceiver>(context);
+    auto receiverB = MakeShared<TestReceiver>(context);
+
+    receiverA->SubscribeToTypedEvent<TestTypedEvent>([&](TestTypedEvent& event)
+    {
+        receiverA->sum_ += event.value_;
+        receiverA->UnsubscribeFromTypedEvent<TestTypedEvent>();
+        receiverB->SubscribeToTypedEvent<TestTypedEvent>(&TestReceiver::HandleTypedEvent);
+    });
+
+    TestTypedEvent event{1};
+    sender->SendTypedEvent(event);
+    REQUIRE(receiverA->sum_ == 1);
+    REQUIRE(receiverB->sum_ == 0);
+
+    sender->SendTypedEvent(event);
+    REQUIRE(receiverA->sum_ == 1);
+    REQUIRE(receiverB->sum_ == 1);
+
+    receiverB->UnsubscribeFromTypedEvent<TestTypedEvent>();
+    REQUIRE(context->GetTypedEventChannel<TestTypedEvent>().GetNumSubscriptions() == 1);
+    sender->SendTypedEvent(event);
+    REQUIRE(context->GetTypedEventChannel<TestTypedEvent>().GetNumSubscriptions() == 0);
+}
+
+TEST_CASE("Typed events resubscribed several times during sending are handled once")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+
+    auto sender = MakeShared<TestReceiver>(context);
+    auto receiver = MakeShared<TestReceiver>(context);
+
+    receiver->SubscribeToTypedEvent<TestTypedEvent>([&](TestTypedEvent& event)
+    {
+        receiver->sum_ += event.value_;
+        receiver->SubscribeToTypedEvent<TestTypedEvent>([&](TestTypedEvent& event) { receiver->sum_ += 10 * event.value_; });
+        receiver->SubscribeToTypedEvent<TestTypedEvent>([&](TestTypedEvent& event) { receiver->sum_ += 100 * event.value_; });
+    });
+
+    TestTypedEvent event{1};
+    sender->SendTypedEvent(event);
+    REQUIRE(receiver->sum_ == 1);
+    REQUIRE(context->GetTypedEventChannel<TestTypedEvent>().GetNumSubscriptions() == 1);
+
+    // Only the last handler is called
+    sender->SendTypedEvent(event);
+    REQUIRE(receiver->sum_ == 101);
+
+    receiver->UnsubscribeFromTypedEvent<TestTypedEvent>();
+    sender->SendTypedEvent(event);
+    REQUIRE(receiver->sum_ == 101);
+}
+
+TEST_CASE("Typed events are faster than VariantMap events", "[.][benchmark]")
+{
+    static constexpr unsigned NumSubscribers = 10000;
+
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+
+    auto sender = MakeShared<TestReceiver>(context);
+    ea::vector<SharedPtr<TestReceiver>> receivers;
+    for (unsigned i = 0; i < NumSubscribers; ++i)
+    {
+        auto receiver = MakeShared<TestReceiver>(context);
+        receiver->SubscribeToEvent(E_TESTVARIANTEVENT, URHO3D_HANDLER(TestReceiver, HandleVariantEvent));
+        receiver->SubscribeToTypedEvent<TestTypedEvent>(&TestReceiver::HandleTypedEvent);
+        receivers.push_back(receiver);
+    }
+
+    BENCHMARK("VariantMap event")
+    {
+        VariantMap& eventData = sender->GetEventDataMap();
+        eventData[TestVariantEvent::P_VALUE] = 1;
+        sender->SendEvent(E_TESTVARIANTEVENT, eventData);
+        return receivers.back()->sum_;
+    };
+
+    BENCHMARK("Typed event")
+    {
+        TestTypedEvent event{1};
+        sender->SendTypedEvent(event);
+        return receivers.back()->sum_;
+    };
+}
@@ -0,0 +1,125 @@
+//
+// Copyright (c) 2017-2021 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR rhs
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR rhsWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR rhs DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../CommonUtils.h"
+
+#include <Urho3D/Graphics/Animation.h>
+#include <Urho3D/IO/MemoryBuffer.h>
+#include <Urho3D/IO/VectorBuffer.h>
+
+namespace
+{
+
+Transform GetReferenceTransform(float time)
+{
+    const Vector3 position{time, Sin(time * 90.0f), 0.0f};
+    const Quaternion rotation{time * 60.0f, Vector3::UP};
+    const Vector3 scale = Vector3::ONE * (1.0f + time * 0.5f);
+    return {position, rotation, scale};
+}
+
+void FillTrack(AnimationTrack& track, float length, unsigned numKeyFrames)
+{
+    track.channelMask_ = CHANNEL_POSITION | CHANNEL_ROTATION | CHANNEL_SCALE;
+    for (unsigned i = 0; i < numKeyFrames; ++i)
+    {
+        const float time = length * i / (numKeyFrames - 1);
+        const Transform value = GetReferenceTransform(time);
+        track.keyFrames_.push_back({time, value.position_, value.rotation_, value.scale_});
+    }
+}
+
+void CheckTrack(const AnimationTrack& track, float length, const AnimationCompressionSettings& settings)
+{
+    unsigned frameIndex = 0;
+    for (unsigned i = 0; i <= 100; ++i)
+    {
+        const float time = length * i / 100;
+        const Transform expected = GetReferenceTransform(time);
+
+        Transform value;
+        track.Sample(time, length, false, frameIndex, value);
+
+        // Error between original keyframes is bounded by sampling rate of the source track
+        CHECK(value.position_.Equals(expected.position_, 0.01f));
+        CHECK(value.rotation_.Equivalent(expected.rotation_, 0.001f));
+        CHECK(value.scale_.Equals(expected.scale_, settings.scaleTolerance_));
+    }
+}
+
+}
+
+TEST_CASE("Animation track is compressed within tolerance")
+{
+    const float length = 2.0f;
+    const unsigned numKeyFrames = 121;
+    const AnimationCompressionSettings settings;
+
+    AnimationTrack track;
+    FillTrack(track, length, numKeyFrames);
+
+    const AnimationCompressionStats stats = track.Compress(settings);
+
+    REQUIRE(track.IsCompressed());
+    CHECK(track.keyFrames_.empty());
+    CHECK(stats.originalKeyFrames_ == numKeyFrames);
+    CHECK(stats.compressedKeyFrames_ < numKeyFrames);
+    CHECK(stats.compressedKeyFrames_ == track.compressedKeyFrames_.GetNumKeyFrames());
+    CHECK(stats.compressedSize_ * 4 < stats.originalSize_);
+    CHECK(stats.maxPositionError_ <= settings.positionTolerance_);
+    CHECK(stats.maxRotationError_ <= settings.rotationTolerance_);
+    CHECK(stats.maxScaleError_ <= settings.scaleTolerance_);
+
+    CHECK(track.compressedKeyFrames_.GetKeyFrameTime(0) == 0.0f);
+    CHECK(track.compressedKeyFrames_.GetKeyFrameTime(stats.compressedKeyFrames_ - 1) == length);
+    CHECK(track.GetFirstValue().position_.Equals(Vector3::ZERO, settings.positionTolerance_));
+    CheckTrack(track, length, settings);
+}
+
+TEST_CASE("Animation with compressed tracks is saved and loaded")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+
+    const float length = 2.0f;
+    const AnimationCompressionSettings settings;
+
+    auto animation = MakeShared<Animation>(context);
+    animation->SetLength(length);
+    FillTrack(*animation->CreateTrack("Bone"), length, 121);
+
+    const AnimationCompressionStats stats = animation->CompressTracks(settings);
+    CHECK(stats.compressedKeyFrames_ < stats.originalKeyFrames_);
+
+    VectorBuffer buffer;
+    REQUIRE(animation->Save(buffer));
+
+    auto loadedAnimation = MakeShared<Animation>(context);
+    MemoryBuffer source(buffer);
+    REQUIRE(loadedAnimation->Load(source));
+
+    const AnimationTrack* track = loadedAnimation->GetTrack(StringHash("Bone"));
+    REQUIRE(track);
+    REQUIRE(track->IsCompressed());
+    CHECK(track->compressedKeyFrames_.GetNumKeyFrames() == stats.compressedKeyFrames_);
+    CHECK(track->compressedKeyFrames_.GetDataSize() == stats.compressedSize_);
+    CheckTrack(*track, length, settings);
+}
@@ -0,0 +1,243 @@
+//
+// Copyright (c) 2017-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR rhs
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR rhsWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR rhs DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../CommonUtils.h"
+#include "../ModelUtils.h"
+
+#include <Urho3D/Graphics/AnimatedModel.h>
+#include <Urho3D/Graphics/AnimationController.h>
+#include <Urho3D/Graphics/AnimationScheduler.h>
+#include <Urho3D/Graphics/Camera.h>
+#include <Urho3D/Graphics/Octree.h>
+#include <Urho3D/Scene/Scene.h>
+
+namespace
+{
+
+SharedPtr<Model> CreateTestSkinnedModel(Context* context)
+{
+    return Tests::CreateSkinnedQuad_Model(context)->ExportModel();
+}
+
+SharedPtr<Animation> CreateTestTranslateXAnimation(Context* context)
+{
+    return Tests::CreateLoopedTranslationAnimation(context, "", "Quad 2", {0.0f, 1.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, 2.0f);
+}
+
+}
+
+TEST_CASE("AnimationScheduler updates animated models")
+{
+    const unsigned numModels = 8;
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    auto animationScheduler = context->GetSubsystem<AnimationScheduler>();
+    REQUIRE(animationScheduler);
+    REQUIRE(animationScheduler->IsEnabled());
+
+    auto model = Tests::GetOrCreateResource<Model>(context, "@Tests/AnimationScheduler/SkinnedModel.mdl", CreateTestSkinnedModel);
+    auto animation = Tests::GetOrCreateResource<Animation>(context, "@Tests/AnimationScheduler/TranslateX.ani", CreateTestTranslateXAnimation);
+
+    auto scene = MakeShared<Scene>(context);
+    scene->CreateComponent<Octree>();
+
+    const unsigned numModelsBefore = animationScheduler->GetNumModels();
+    ea::vector<Node*> nodes;
+    for (unsigned i = 0; i < numModels; ++i)
+    {
+        Node* node = scene->CreateChild("Node");
+        node->CreateComponent<AnimatedModel>()->SetModel(model);
+        node->CreateComponent<AnimationController>()->Play(animation->GetName(), 0, true);
+        nodes.push_back(node);
+    }
+    REQUIRE(animationScheduler->GetNumModels() == numModelsBefore + numModels);
+
+    // Without camera all models are in the first tier and are updated every frame
+    Tests::RunFrame(context, 0.5f);
+    Tests::RunFrame(context, 0.5f);
+    {
+        const AnimationSchedulerStats& stats = animationScheduler->GetStats();
+        CHECK(stats.tiers_[0].numModels_ == numModels);
+        CHECK(stats.tiers_[0].numUpdated_ == numModels);
+        CHECK(stats.tiers_[0].numDeferred_ == 0);
+        for (Node* node : nodes)
+            CHECK(node->GetChild("Quad 2", true)->GetPosition().Equals({0.0f, 1.0f, 0.0f}));
+    }
+
+    // Models are evaluated even with tiny time budget: at least one model is always updated
+    animationScheduler->SetTimeBudget(0.000001f);
+    for (unsigned i = 0; i < 4; ++i)
+        Tests::RunFrame(context, 0.25f);
+    animationScheduler->SetTimeBudget(0.0f);
+    Tests::RunFrame(context, 0.5f);
+    {
+        const AnimationSchedulerStats& stats = animationScheduler->GetStats();
+        CHECK(stats.tiers_[0].numUpdated_ == numModels);
+        for (Node* node : nodes)
+            CHECK(node->GetChild("Quad 2", true)->GetPosition().Equals({-1.0f, 1.0f, 0.0f}));
+    }
+
+    // Disabled scheduler falls back to per-model timers
+    animationScheduler->SetEnabled(false);
+    Tests::RunFrame(context, 0.25f);
+    animationScheduler->SetEnabled(true);
+    CHECK(animationScheduler->GetStats().tiers_[0].numModels_ == 0);
+    for (Node* node : nodes)
+        CHECK(node->GetChild("Quad 2", true)->GetPosition().Equals({-0.5f, 1.0f, 0.0f}));
+
+    // Models are unregistered on removal
+    scene->RemoveAllChildren();
+    CHECK(animationScheduler->GetNumModels() == numModelsBefore);
+}
+
+TEST_CASE("AnimationScheduler assigns LOD tiers by distance to camera")
+{
+    const float timeStep = 1.0f / 60.0f;
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    auto animationScheduler = context->GetSubsystem<AnimationScheduler>();
+    REQUIRE(animationScheduler);
+    REQUIRE(animationScheduler->IsEnabled());
+    REQUIRE(animationScheduler->GetTimeBudget() == 0.0f);
+
+    auto model = Tests::GetOrCreateResource<Model>(context, "@Tests/AnimationScheduler/SkinnedModel.mdl", CreateTestSkinnedModel);
+    auto animation = Tests::GetOrCreateResource<Animation>(context, "@Tests/AnimationScheduler/TranslateX.ani", CreateTestTranslateXAnimation);
+
+    auto scene = MakeShared<Scene>(context);
+    scene->CreateComponent<Octree>();
+
+    Node* cameraNode = scene->CreateChild("Camera");
+    auto camera = cameraNode->CreateComponent<Camera>();
+
+    // Place models in the middle of LOD tier ranges: tier N is used for 2^N..2^(N+1) frames per update
+    const float scale = model->GetBoundingBox().Size().DotProduct(DOT_SCALE);
+    const float tierDistance = timeStep * ANIMATION_LOD_BASESCALE * scale;
+    ea::vector<AnimatedModel*> animatedModels;
+    for (unsigned tier = 0; tier < MAX_ANIMATION_LOD_TIERS; ++tier)
+    {
+        Node* node = scene->CreateChild("Node");
+        node->SetPosition({0.0f, 0.0f, 1.5f * (1u << tier) * tierDistance});
+        auto animatedModel = node->CreateComponent<AnimatedModel>();
+        animatedModel->SetModel(model);
+        node->CreateComponent<AnimationController>()->Play(animation->GetName(), 0, true);
+        animatedModels.push_back(animatedModel);
+    }
+    REQUIRE(animationScheduler->GetNumModels() == MAX_ANIMATION_LOD_TIERS);
+
+    // Emulate view processing: animation is changed and models are seen by the camera every frame
+    const auto runFrame = [&](unsigned frameNumber)
+    {
+        scene->Update(timeStep);
+
+        FrameInfo frameInfo;
+        frameInfo.frameNumber_ = frameNumber;
+        frameInfo.timeStep_ = timeStep;
+        frameInfo.scene_ = scene;
+        frameInfo.camera_ = camera;
+        for (AnimatedModel* animatedModel : animatedModels)
+        {
+            animatedModel->MarkInView(frameInfo);
+            animatedModel->UpdateBatches(frameInfo);
+        }
+
+        animationScheduler->Schedule(frameNumber, timeStep);
+    };
+
+    // Warm up so the models settle in their tiers and phases
+    unsigned frameNumber = 1;
+    for (; frameNumber <= 16; ++frameNumber)
+        runFrame(frameNumber);
+
+    unsigned lastUpdateFrame[MAX_ANIMATION_LOD_TIERS]{};
+    unsigned numUpdates[MAX_ANIMATION_LOD_TIERS]{};
+    for (unsigned i = 0; i < 16; ++i, ++frameNumber)
+    {
+        runFrame(frameNumber);
+
+        const AnimationSchedulerStats& stats = animationScheduler->GetStats();
+        for (unsigned tier = 0; tier < MAX_ANIMATION_LOD_TIERS; ++tier)
+        {
+            const AnimationSchedule& schedule = animatedModels[tier]->GetAnimationSchedule();
+            REQUIRE(schedule.scheduled_);
+            CHECK(schedule.tier_ == tier);
+            CHECK(schedule.interval_ == 1u << tier);
+
+            CHECK(stats.tiers_[tier].numModels_ == 1);
+            CHECK(stats.tiers_[tier].numDeferred_ == 0);
+            CHECK(stats.tiers_[tier].numUpdated_ == (schedule.update_ ? 1 : 0));
+
+            // Skipped frames are interpolated towards the last evaluated pose
+            if (schedule.update_)
+            {
+                lastUpdateFrame[tier] = frameNumber;
+                ++numUpdates[tier];
+            }
+            if (lastUpdateFrame[tier] != 0)
+            {
+                const float expectedFactor = (frameNumber - lastUpdateFrame[tier] + 1.0f) / schedule.interval_;
+                CHECK(schedule.interpolationFactor_ == Catch::Approx(ea::min(expectedFactor, 1.0f)));
+            }
+        }
+    }
+
+    // Updates are evenly spaced
+    for (unsigned tier = 0; tier < MAX_ANIMATION_LOD_TIERS; ++tier)
+        CHECK(numUpdates[tier] == 16 / (1u << tier));
+
+    // Moving the model closer to the camera moves it to the first tier
+    animatedModels.back()->GetNode()->SetPosition({0.0f, 0.0f, 0.5f * tierDistance});
+    runFrame(frameNumber++);
+    CHECK(animatedModels.back()->GetAnimationSchedule().tier_ == 0);
+    CHECK(animatedModels.back()->GetAnimationSchedule().interval_ == 1);
+    CHECK(animatedModels.back()->GetAnimationSchedule().update_);
+    CHECK(animatedModels.back()->GetAnimationSchedule().interpolationFactor_ == 1.0f);
+    animatedModels.back()->GetNode()->SetPosition({0.0f, 0.0f, 12.0f * tierDistance});
+    runFrame(frameNumber++);
+
+    // When all models are overdue and time budget is exceeded, only the most stale model is updated
+    animationScheduler->ReportAnimationTime(1000);
+    animationScheduler->SetTimeBudget(0.000001f);
+    frameNumber += 64;
+    runFrame(frameNumber++);
+    {
+        const AnimationSchedulerStats& stats = animationScheduler->GetStats();
+        CHECK(animatedModels[0]->GetAnimationSchedule().update_);
+        CHECK(stats.tiers_[0].numUpdated_ == 1);
+        CHECK(stats.tiers_[0].numDeferred_ == 0);
+        for (unsigned tier = 1; tier < MAX_ANIMATION_LOD_TIERS; ++tier)
+        {
+            CHECK_FALSE(animatedModels[tier]->GetAnimationSchedule().update_);
+            CHECK(stats.tiers_[tier].numUpdated_ == 0);
+            CHECK(stats.tiers_[tier].numDeferred_ == 1);
+        }
+    }
+
+    // Deferred models are updated first on the next frame
+    runFrame(frameNumber++);
+    {
+        const AnimationSchedulerStats& stats = animationScheduler->GetStats();
+        CHECK(animatedModels[1]->GetAnimationSchedule().update_);
+        CHECK(stats.tiers_[0].numDeferred_ == 1);
+        CHECK(stats.tiers_[1].numDeferred_ == 0);
+        CHECK(stats.tiers_[2].numDeferred_ == 1);
+        CHECK(stats.tiers_[3].numDeferred_ == 1);
+    }
+    animationScheduler->SetTimeBudget(0.0f);
+}
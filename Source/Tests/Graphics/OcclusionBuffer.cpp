@@ -0,0 +1,230 @@
+//
+// Copyright (c) 2017-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../CommonUtils.h"
+
+#include <Urho3D/Graphics/Camera.h>
+#include <Urho3D/Graphics/OcclusionBuffer.h>
+#include <Urho3D/Math/RandomEngine.h>
+#include <Urho3D/Scene/Scene.h>
+
+namespace
+{
+
+/// Append quad facing the camera to the list of non-indexed triangles.
+void AppendQuad(ea::vector<Vector3>& vertices, const Vector3& center, float size)
+{
+    const Vector3 v0 = center + Vector3(-size, -size, 0.0f);
+    const Vector3 v1 = center + Vector3(-size, size, 0.0f);
+    const Vector3 v2 = center + Vector3(size, size, 0.0f);
+    const Vector3 v3 = center + Vector3(size, -size, 0.0f);
+    vertices.insert(vertices.end(), {v0, v1, v2, v0, v2, v3});
+}
+
+/// Create camera at origin looking at positive Z.
+SharedPtr<Scene> CreateCameraScene(Context* context, Camera*& camera)
+{
+    auto scene = MakeShared<Scene>(context);
+    camera = scene->CreateChild("Camera")->CreateComponent<Camera>();
+    camera->SetNearClip(0.1f);
+    camera->SetFarClip(100.0f);
+    camera->SetAspectRatio(2.0f);
+    return scene;
+}
+
+/// Draw occluder vertices to the buffer.
+void DrawOccluders(OcclusionBuffer* buffer, Camera* camera, const ea::vector<Vector3>& vertices)
+{
+    buffer->SetView(camera);
+    buffer->SetCullMode(CULL_NONE);
+    buffer->SetMaxTriangles(M_MAX_UNSIGNED);
+    buffer->Clear();
+    buffer->AddTriangles(Matrix3x4::IDENTITY, vertices.data(), sizeof(Vector3), 0, vertices.size());
+    buffer->DrawTriangles();
+    buffer->BuildDepthHierarchy();
+}
+
+}
+
+TEST_CASE("OcclusionBuffer culls boxes behind occluders")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+
+    Camera* camera{};
+    auto scene = CreateCameraScene(context, camera);
+
+    ea::vector<Vector3> vertices;
+    AppendQuad(vertices, {0.0f, 0.0f, 10.0f}, 4.0f);
+
+    for (bool threaded : {false, true})
+    {
+        auto buffer = MakeShared<OcclusionBuffer>(context);
+        REQUIRE(buffer->SetSize(256, 128, threaded));
+        DrawOccluders(buffer, camera, vertices);
+
+        REQUIRE_FALSE(buffer->IsVisible(BoundingBox{{-1.0f, -1.0f, 20.0f}, {1.0f, 1.0f, 22.0f}}));
+        REQUIRE(buffer->IsVisible(BoundingBox{{-1.0f, -1.0f, 5.0f}, {1.0f, 1.0f, 6.0f}}));
+        REQUIRE(buffer->IsVisible(BoundingBox{{6.0f, -1.0f, 20.0f}, {8.0f, 1.0f, 22.0f}}));
+        REQUIRE(buffer->IsVisible(BoundingBox{{3.0f, -1.0f, 11.0f}, {5.0f, 1.0f, 12.0f}}));
+
+        const BoundingBox boxes[] = {
+            {{-1.0f, -1.0f, 20.0f}, {1.0f, 1.0f, 22.0f}},
+            {{-1.0f, -1.0f, 5.0f}, {1.0f, 1.0f, 6.0f}},
+            {{-2.0f, -2.0f, 30.0f}, {-1.0f, -1.0f, 31.0f}},
+        };
+        bool isVisible[3]{};
+        buffer->AreVisible(boxes, isVisible);
+        REQUIRE_FALSE(isVisible[0]);
+        REQUIRE(isVisible[1]);
+        REQUIRE_FALSE(isVisible[2]);
+    }
+}
+
+TEST_CASE("OcclusionBuffer rasterizes the same depth in tiles and in single pass")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+
+    Camera* camera{};
+    auto scene = CreateCameraScene(context, camera);
+
+    // Random triangles, including ones crossing the screen edges and the near plane
+    RandomEngine re(0);
+    ea::vector<Vector3> vertices;
+    for (unsigned i = 0; i < 300; ++i)
+    {
+        const Vector3 center{re.GetFloat(-20.0f, 20.0f), re.GetFloat(-10.0f, 10.0f), re.GetFloat(-1.0f, 40.0f)};
+        for (unsigned j = 0; j < 3; ++j)
+            vertices.push_back(center + Vector3{re.GetFloat(-5.0f, 5.0f), re.GetFloat(-5.0f, 5.0f), re.GetFloat(-2.0f, 2.0f)});
+    }
+
+    auto singleBuffer = MakeShared<OcclusionBuffer>(context);
+    REQUIRE(singleBuffer->SetSize(256, 128, false));
+    DrawOccluders(singleBuffer, camera, vertices);
+
+    auto tiledBuffer = MakeShared<OcclusionBuffer>(context);
+    REQUIRE(tiledBuffer->SetSize(256, 128, true));
+    if (!tiledBuffer->IsThreaded())
+    {
+        WARN("Worker threads are not available, tiled rasterization is not used");
+        return;
+    }
+    DrawOccluders(tiledBuffer, camera, vertices);
+
+    const int* singleData = singleBuffer->GetBuffer();
+    const int* tiledData = tiledBuffer->GetBuffer();
+    REQUIRE(ea::equal(singleData, singleData + 256 * 128, tiledData));
+}
+
+TEST_CASE("OcclusionBuffer tests batches of boxes the same way as single boxes")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+
+    Camera* camera{};
+    auto scene = CreateCameraScene(context, camera);
+
+    RandomEngine re(0);
+    ea::vector<Vector3> vertices;
+    for (unsigned i = 0; i < 100; ++i)
+        AppendQuad(vertices, {re.GetFloat(-20.0f, 20.0f), re.GetFloat(-10.0f, 10.0f), re.GetFloat(5.0f, 30.0f)}, 1.0f);
+
+    auto buffer = MakeShared<OcclusionBuffer>(context);
+    REQUIRE(buffer->SetSize(256, 128, false));
+    DrawOccluders(buffer, camera, vertices);
+
+    // Number of boxes is not a multiple of batch size, some boxes cross the near plane or are off screen
+    ea::vector<BoundingBox> boxes;
+    for (unsigned i = 0; i < 1001; ++i)
+    {
+        const Vector3 center{re.GetFloat(-40.0f, 40.0f), re.GetFloat(-20.0f, 20.0f), re.GetFloat(-1.0f, 50.0f)};
+        const Vector3 halfSize{re.GetFloat(0.1f, 2.0f), re.GetFloat(0.1f, 2.0f), re.GetFloat(0.1f, 2.0f)};
+        boxes.emplace_back(center - halfSize, center + halfSize);
+    }
+
+    ea::vector<bool> isVisible(boxes.size());
+    buffer->AreVisible(boxes, isVisible);
+
+    unsigned numOccluded = 0;
+    for (unsigned i = 0; i < boxes.size(); ++i)
+    {
+        REQUIRE(isVisible[i] == buffer->IsVisible(boxes[i]));
+        if (!isVisible[i])
+            ++numOccluded;
+    }
+    CHECK(numOccluded > 0);
+    CHECK(numOccluded < boxes.size());
+
+    // Visible boxes are kept visible
+    ea::fill(isVisible.begin(), isVisible.end(), true);
+    buffer->AreVisible(boxes, isVisible);
+    CHECK(ea::count(isVisible.begin(), isVisible.end(), false) == 0);
+}
+
+TEST_CASE("OcclusionBuffer throughput", "[.][benchmark]")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+
+    Camera* camera{};
+    auto scene = CreateCameraScene(context, camera);
+
+    // Wall of occluders with grid of occludees behind
+    ea::vector<Vector3> vertices;
+    for (int x = -10; x <= 10; ++x)
+    {
+        for (int y = -5; y <= 5; ++y)
+            AppendQuad(vertices, {x * 2.0f, y * 2.0f, 15.0f}, 1.0f);
+    }
+
+    ea::vector<BoundingBox> boxes;
+    for (int x = -50; x <= 50; ++x)
+    {
+        for (int y = -25; y <= 25; ++y)
+        {
+            const Vector3 center{x * 0.8f, y * 0.8f, 30.0f};
+            boxes.emplace_back(center - Vector3::ONE * 0.3f, center + Vector3::ONE * 0.3f);
+        }
+    }
+    ea::vector<bool> isVisible(boxes.size());
+
+    for (bool threaded : {false, true})
+    {
+        auto buffer = MakeShared<OcclusionBuffer>(context);
+        REQUIRE(buffer->SetSize(512, 256, threaded));
+
+        BENCHMARK(threaded ? "Rasterize occluders in tiles" : "Rasterize occluders")
+        {
+            DrawOccluders(buffer, camera, vertices);
+            return buffer->GetBuffer()[0];
+        };
+
+        DrawOccluders(buffer, camera, vertices);
+        BENCHMARK(threaded ? "Test occludees after tiled rasterization" : "Test occludees")
+        {
+            ea::fill(isVisible.begin(), isVisible.end(), false);
+            buffer->AreVisible(boxes, isVisible);
+            return ea::count(isVisible.begin(), isVisible.end(), false);
+        };
+    }
+
+    const auto numOccluded = ea::count(isVisible.begin(), isVisible.end(), false);
+    WARN("Occluded " << numOccluded << " of " << boxes.size() << " drawables");
+}
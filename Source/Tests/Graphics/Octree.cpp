@@ -0,0 +1,239 @@
+//
+// Copyright (c) 2017-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../CommonUtils.h"
+
+#include <Urho3D/Graphics/Model.h>
+#include <Urho3D/Graphics/Octree.h>
+#include <Urho3D/Graphics/StaticModel.h>
+#include <Urho3D/Math/RandomEngine.h>
+#include <Urho3D/Resource/ResourceCache.h>
+#include <Urho3D/Scene/Scene.h>
+
+namespace
+{
+
+/// Scene with boxes stored in octree with given spatial index.
+struct BoxScene
+{
+    BoxScene(Context* context, SpatialIndexType type)
+        : scene_(MakeShared<Scene>(context))
+        , octree_(scene_->CreateComponent<Octree>())
+        , model_(context->GetSubsystem<ResourceCache>()->GetResource<Model>("Models/Box.mdl"))
+    {
+        octree_->SetSpatialIndexType(type);
+    }
+
+    void AddBox(const Vector3& position, bool occludee)
+    {
+        Node* node = scene_->CreateChild();
+        node->SetPosition(position);
+        auto staticModel = node->CreateComponent<StaticModel>();
+        staticModel->SetModel(model_);
+        staticModel->SetOccludee(occludee);
+        nodes_.push_back(node);
+    }
+
+    void RemoveBox(unsigned index)
+    {
+        nodes_[index]->Remove();
+        nodes_.erase_unsorted(nodes_.begin() + index);
+    }
+
+    void Update()
+    {
+        FrameInfo frame;
+        frame.timeStep_ = 0.1f;
+        octree_->Update(frame);
+    }
+
+    SharedPtr<Scene> scene_;
+    Octree* octree_{};
+    Model* model_{};
+    ea::vector<Node*> nodes_;
+};
+
+/// Return sorted IDs of nodes of drawables.
+ea::vector<unsigned> GetNodeIDs(const ea::vector<Drawable*>& drawables)
+{
+    ea::vector<unsigned> result;
+    for (Drawable* drawable : drawables)
+        result.push_back(drawable->GetNode()->GetID());
+    ea::sort(result.begin(), result.end());
+    return result;
+}
+
+/// Return sorted IDs of nodes hit by ray.
+ea::vector<unsigned> GetNodeIDs(const ea::vector<RayQueryResult>& results)
+{
+    ea::vector<unsigned> result;
+    for (const RayQueryResult& hit : results)
+        result.push_back(hit.node_->GetID());
+    ea::sort(result.begin(), result.end());
+    return result;
+}
+
+/// Check that all kinds of queries return the same objects.
+void CheckQueries(Octree* octree, Octree* referenceOctree, RandomEngine& re)
+{
+    ea::vector<Drawable*> result;
+    ea::vector<Drawable*> referenceResult;
+
+    const Vector3 position = re.GetVector3(-Vector3::ONE * 50.0f, Vector3::ONE * 50.0f);
+    const Quaternion rotation = re.GetQuaternion();
+
+    Frustum frustum;
+    frustum.Define(60.0f, 1.5f, 1.0f, 0.5f, 80.0f, Matrix3x4(position, rotation, 1.0f));
+    FrustumOctreeQuery frustumQuery(result, frustum);
+    FrustumOctreeQuery referenceFrustumQuery(referenceResult, frustum);
+    octree->GetDrawables(frustumQuery);
+    referenceOctree->GetDrawables(referenceFrustumQuery);
+    REQUIRE_FALSE(result.empty());
+    REQUIRE(GetNodeIDs(result) == GetNodeIDs(referenceResult));
+
+    const Sphere sphere{position, 20.0f};
+    SphereOctreeQuery sphereQuery(result, sphere);
+    SphereOctreeQuery referenceSphereQuery(referenceResult, sphere);
+    octree->GetDrawables(sphereQuery);
+    referenceOctree->GetDrawables(referenceSphereQuery);
+    REQUIRE(GetNodeIDs(result) == GetNodeIDs(referenceResult));
+
+    const BoundingBox box{position - Vector3::ONE * 15.0f, position + Vector3::ONE * 15.0f};
+    BoxOctreeQuery boxQuery(result, box);
+    BoxOctreeQuery referenceBoxQuery(referenceResult, box);
+    octree->GetDrawables(boxQuery);
+    referenceOctree->GetDrawables(referenceBoxQuery);
+    REQUIRE(GetNodeIDs(result) == GetNodeIDs(referenceResult));
+
+    PointOctreeQuery pointQuery(result, position);
+    PointOctreeQuery referencePointQuery(referenceResult, position);
+    octree->GetDrawables(pointQuery);
+    referenceOctree->GetDrawables(referencePointQuery);
+    REQUIRE(GetNodeIDs(result) == GetNodeIDs(referenceResult));
+
+    ea::vector<RayQueryResult> rayResult;
+    ea::vector<RayQueryResult> referenceRayResult;
+    const Ray ray{position, rotation * Vector3::FORWARD};
+    RayOctreeQuery rayQuery(rayResult, ray, RAY_AABB, 100.0f);
+    RayOctreeQuery referenceRayQuery(referenceRayResult, ray, RAY_AABB, 100.0f);
+    octree->Raycast(rayQuery);
+    referenceOctree->Raycast(referenceRayQuery);
+    REQUIRE(GetNodeIDs(rayResult) == GetNodeIDs(referenceRayResult));
+
+    octree->RaycastSingle(rayQuery);
+    referenceOctree->RaycastSingle(referenceRayQuery);
+    REQUIRE(rayResult.size() == referenceRayResult.size());
+    if (!rayResult.empty())
+        REQUIRE(rayResult[0].distance_ == Catch::Approx(referenceRayResult[0].distance_));
+}
+
+}
+
+TEST_CASE("BVH spatial index returns the same drawables as octree")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+
+    BoxScene scene(context, SpatialIndexType::BVH);
+    BoxScene referenceScene(context, SpatialIndexType::Octree);
+
+    RandomEngine re(0);
+    const auto addBoxes = [&](unsigned count)
+    {
+        for (unsigned i = 0; i < count; ++i)
+        {
+            const Vector3 position = re.GetVector3(-Vector3::ONE * 60.0f, Vector3::ONE * 60.0f);
+            const bool occludee = i % 10 != 0;
+            scene.AddBox(position, occludee);
+            referenceScene.AddBox(position, occludee);
+        }
+    };
+
+    addBoxes(2000);
+    scene.Update();
+    referenceScene.Update();
+    REQUIRE(scene.octree_->GetBVH().GetNumRebuilds() > 0);
+    REQUIRE(scene.octree_->GetBVH().GetNumTreeDrawables() == 1800);
+
+    for (unsigned frame = 0; frame < 20; ++frame)
+    {
+        // Move some boxes, remove some and add new ones
+        for (unsigned i = 0; i < 200; ++i)
+        {
+            const unsigned index = re.GetUInt(scene.nodes_.size());
+            const Vector3 offset = re.GetVector3(-Vector3::ONE * 5.0f, Vector3::ONE * 5.0f);
+            scene.nodes_[index]->Translate(offset, TS_WORLD);
+            referenceScene.nodes_[index]->Translate(offset, TS_WORLD);
+        }
+        for (unsigned i = 0; i < 20; ++i)
+        {
+            const unsigned index = re.GetUInt(scene.nodes_.size());
+            scene.RemoveBox(index);
+            referenceScene.RemoveBox(index);
+        }
+        addBoxes(20);
+
+        scene.Update();
+        referenceScene.Update();
+
+        REQUIRE(scene.octree_->GetAllDrawables().size() == referenceScene.octree_->GetAllDrawables().size());
+        for (unsigned query = 0; query < 5; ++query)
+            CheckQueries(scene.octree_, referenceScene.octree_, re);
+    }
+
+    // Drawables are moved when index type is changed
+    scene.octree_->SetSpatialIndexType(SpatialIndexType::Octree);
+    referenceScene.octree_->SetSpatialIndexType(SpatialIndexType::BVH);
+    for (unsigned query = 0; query < 5; ++query)
+        CheckQueries(scene.octree_, referenceScene.octree_, re);
+}
+
+TEST_CASE("BVH spatial index is faster than octree for moving drawables", "[.][benchmark]")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+
+    static constexpr unsigned NumBoxes = 50000;
+    for (const SpatialIndexType type : {SpatialIndexType::Octree, SpatialIndexType::BVH})
+    {
+        BoxScene scene(context, type);
+        RandomEngine re(0);
+        for (unsigned i = 0; i < NumBoxes; ++i)
+            scene.AddBox(re.GetVector3(-Vector3::ONE * 200.0f, Vector3::ONE * 200.0f), true);
+        scene.Update();
+
+        Frustum frustum;
+        frustum.Define(60.0f, 1.5f, 1.0f, 0.5f, 150.0f, Matrix3x4::IDENTITY);
+        ea::vector<Drawable*> result;
+
+        const char* name = type == SpatialIndexType::BVH ? "BVH" : "Octree";
+        BENCHMARK(name)
+        {
+            for (Node* node : scene.nodes_)
+                node->Translate(re.GetVector3(-Vector3::ONE, Vector3::ONE), TS_WORLD);
+            scene.Update();
+
+            FrustumOctreeQuery query(result, frustum);
+            scene.octree_->GetDrawables(query);
+            return result.size();
+        };
+    }
+}
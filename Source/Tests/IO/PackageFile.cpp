@@ -0,0 +1,249 @@
+//
+// Copyright (c) 2017-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../CommonUtils.h"
+
+#include <Urho3D/Core/Format.h>
+#include <Urho3D/IO/File.h>
+#include <Urho3D/IO/FileSystem.h>
+#include <Urho3D/IO/MemoryMappedFile.h>
+#include <Urho3D/IO/PackageBuilder.h>
+#include <Urho3D/IO/PackageFile.h>
+#include <Urho3D/IO/VirtualFileSystem.h>
+#include <Urho3D/Math/RandomEngine.h>
+
+namespace
+{
+
+void WriteZstdPackage(Context* context, const ea::string& fileName, unsigned blockSize,
+    const ea::vector<ea::pair<ea::string, ByteVector>>& files, bool writeEntryIndex = true)
+{
+    auto builder = MakeShared<PackageBuilder>(context);
+    builder->SetEntryIndexEnabled(writeEntryIndex);
+    REQUIRE(builder->Create(fileName, blockSize, 3));
+    for (const auto& [name, data] : files)
+        REQUIRE(builder->Append(name, data));
+    REQUIRE(builder->Build());
+}
+
+void WriteUncompressedPackage(Context* context, const ea::string& fileName,
+    const ea::vector<ea::pair<ea::string, ByteVector>>& files)
+{
+    auto builder = MakeShared<PackageBuilder>(context);
+    builder->SetCompression(PackageCompression::None);
+    REQUIRE(builder->Create(fileName));
+    for (const auto& [name, data] : files)
+        REQUIRE(builder->Append(name, data));
+    REQUIRE(builder->Build());
+}
+
+}
+
+TEST_CASE("Zstd compressed package supports random access")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    auto fileSystem = context->GetSubsystem<FileSystem>();
+
+    static constexpr unsigned BlockSize = 1024;
+
+    ByteVector text;
+    for (unsigned i = 0; i < 40; ++i)
+    {
+        const ea::string line = Format("Line {} of compressible text file\n", i);
+        text.insert(text.end(), line.begin(), line.end());
+    }
+
+    RandomEngine randomEngine(0);
+    ByteVector noise(BlockSize * 3 + 100);
+    for (unsigned char& value : noise)
+        value = static_cast<unsigned char>(randomEngine.GetUInt(256));
+
+    const ea::string packageName = fileSystem->GetTemporaryDir() + "ZstdPackageTest.pak";
+    WriteZstdPackage(context, packageName, BlockSize, {{"Text.txt", text}, {"Noise.bin", noise}, {"Empty.bin", {}}});
+
+    auto package = MakeShared<PackageFile>(context, packageName);
+    REQUIRE(package->GetCompression() == PackageCompression::Zstd);
+    REQUIRE(package->GetBlockSize() == BlockSize);
+    REQUIRE(package->GetNumFiles() == 3);
+    REQUIRE(package->GetEntry("Noise.bin")->blockOffsets_.size() == 5);
+
+    // Sequential read
+    {
+        File file(context, package, "Text.txt");
+        ByteVector data(text.size());
+        REQUIRE(file.Read(data.data(), data.size()) == text.size());
+        REQUIRE(data == text);
+    }
+
+    // Random access across block boundaries, both forward and backward
+    {
+        File file(context, package, "Noise.bin");
+        REQUIRE(file.GetSize() == noise.size());
+
+        ByteVector data(BlockSize * 2 + 50);
+        for (unsigned position : {BlockSize * 2 + 10, 100u, 0u, BlockSize, BlockSize * 3 - 30})
+        {
+            const unsigned expectedSize = ea::min<unsigned>(data.size(), noise.size() - position);
+            REQUIRE(file.Seek(position) == position);
+            REQUIRE(file.Read(data.data(), data.size()) == expectedSize);
+            REQUIRE(ea::equal(data.begin(), data.begin() + expectedSize, noise.begin() + position));
+            REQUIRE(file.GetPosition() == position + expectedSize);
+        }
+    }
+
+    // Empty file
+    {
+        File file(context, package, "Empty.bin");
+        REQUIRE(file.IsOpen());
+        REQUIRE(file.GetSize() == 0);
+        REQUIRE(file.IsEof());
+    }
+
+    package = nullptr;
+    fileSystem->Delete(packageName);
+}
+
+TEST_CASE("Packages are looked up by name hash in VirtualFileSystem")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    auto fileSystem = context->GetSubsystem<FileSystem>();
+    auto vfs = context->GetSubsystem<VirtualFileSystem>();
+
+    const auto toBytes = [](ea::string_view text) { return ByteVector(text.begin(), text.end()); };
+    const auto readText = [&](const ea::string& fileName) { return vfs->ReadAllText(FileIdentifier{"", fileName}); };
+
+    const ea::string basePackageName = fileSystem->GetTemporaryDir() + "HashedPackageBase.pak";
+    const ea::string patchPackageName = fileSystem->GetTemporaryDir() + "HashedPackagePatch.pak";
+    WriteZstdPackage(context, basePackageName, 1024,
+        {{"Test/Shared.txt", toBytes("base")}, {"Test/Base.txt", toBytes("base only")}}, true);
+    // Old packages without entry index are indexed on load
+    WriteZstdPackage(context, patchPackageName, 1024,
+        {{"Test/Shared.txt", toBytes("patch")}, {"Test/Patch.txt", toBytes("patch only")}}, false);
+
+    auto basePackage = MakeShared<PackageFile>(context, basePackageName);
+    auto patchPackage = MakeShared<PackageFile>(context, patchPackageName);
+    REQUIRE(basePackage->GetNumFiles() == 2);
+    REQUIRE(basePackage->GetEntryName(1) == "Test/Base.txt");
+    REQUIRE(basePackage->GetEntry("Test/Base.txt"));
+    REQUIRE_FALSE(basePackage->GetEntry("Test/Patch.txt"));
+    REQUIRE(patchPackage->Exists("Test/Patch.txt"));
+
+    // Packages mounted later take priority
+    vfs->Mount(basePackage);
+    vfs->Mount(patchPackage);
+    REQUIRE(readText("Test/Shared.txt") == "patch");
+    REQUIRE(readText("Test/Base.txt") == "base only");
+    REQUIRE(readText("Test/Patch.txt") == "patch only");
+    REQUIRE_FALSE(vfs->Exists(FileIdentifier{"", "Test/Missing.txt"}));
+
+    // Index is updated on unmount
+    vfs->Unmount(patchPackage);
+    REQUIRE(readText("Test/Shared.txt") == "base");
+    REQUIRE_FALSE(vfs->Exists(FileIdentifier{"", "Test/Patch.txt"}));
+
+    vfs->Unmount(basePackage);
+    REQUIRE_FALSE(vfs->Exists(FileIdentifier{"", "Test/Base.txt"}));
+
+    basePackage = nullptr;
+    patchPackage = nullptr;
+    fileSystem->Delete(basePackageName);
+    fileSystem->Delete(patchPackageName);
+}
+
+TEST_CASE("Memory-mapped package entries match buffered reads")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    auto fileSystem = context->GetSubsystem<FileSystem>();
+
+    ByteVector noise(100000);
+    RandomEngine randomEngine(0);
+    for (unsigned char& value : noise)
+        value = static_cast<unsigned char>(randomEngine.GetUInt(256));
+
+    const ea::string text = "Text file stored between binary files";
+    const ea::vector<ea::pair<ea::string, ByteVector>> files{
+        {"Data/First.bin", ByteVector(noise.begin(), noise.begin() + 1000)},
+        {"Data/Text.txt", ByteVector(text.begin(), text.end())},
+        {"Data/Noise.bin", noise},
+    };
+
+    const ea::string packageName = fileSystem->GetTemporaryDir() + "MappedPackageTest.pak";
+    WriteUncompressedPackage(context, packageName, files);
+
+    auto package = MakeShared<PackageFile>(context, packageName);
+    REQUIRE(package->GetCompression() == PackageCompression::None);
+    REQUIRE(package->GetNumFiles() == files.size());
+
+    if (!MemoryMapping::IsSupported())
+    {
+        WARN("Memory mapping is not supported on this platform");
+        package = nullptr;
+        fileSystem->Delete(packageName);
+        return;
+    }
+
+    for (const auto& [name, data] : files)
+    {
+        AbstractFilePtr mappedFile = package->OpenMappedFile(FileIdentifier{"", name});
+        REQUIRE(mappedFile);
+        REQUIRE(dynamic_cast<MemoryMappedFile*>(mappedFile.Get()));
+
+        File bufferedFile(context, package, name);
+        REQUIRE(bufferedFile.IsOpen());
+        REQUIRE(mappedFile->GetSize() == bufferedFile.GetSize());
+        REQUIRE(mappedFile->GetSize() == data.size());
+
+        // Whole entry is visible in place, without reading
+        const unsigned char* mappedData = mappedFile->GetContiguousData();
+        REQUIRE(mappedData);
+        REQUIRE(ea::equal(data.begin(), data.end(), mappedData));
+
+        // Same data is returned at the same positions, both forward and backward
+        const unsigned size = data.size();
+        ByteVector mappedBuffer(777);
+        ByteVector buffer(777);
+        for (unsigned position : {0u, size / 2, 1u, size - 10, size / 3})
+        {
+            REQUIRE(mappedFile->Seek(position) == bufferedFile.Seek(position));
+
+            const unsigned mappedRead = mappedFile->Read(mappedBuffer.data(), mappedBuffer.size());
+            const unsigned bufferedRead = bufferedFile.Read(buffer.data(), buffer.size());
+            REQUIRE(mappedRead == bufferedRead);
+            REQUIRE(mappedRead == ea::min<unsigned>(buffer.size(), size - position));
+            REQUIRE(ea::equal(mappedBuffer.begin(), mappedBuffer.begin() + mappedRead, buffer.begin()));
+            REQUIRE(mappedFile->GetPosition() == bufferedFile.GetPosition());
+            REQUIRE(mappedFile->IsEof() == bufferedFile.IsEof());
+        }
+    }
+
+    // Compressed entries cannot be mapped
+    const ea::string compressedPackageName = fileSystem->GetTemporaryDir() + "MappedPackageTestZstd.pak";
+    WriteZstdPackage(context, compressedPackageName, 1024, files);
+    auto compressedPackage = MakeShared<PackageFile>(context, compressedPackageName);
+    REQUIRE_FALSE(compressedPackage->OpenMappedFile(FileIdentifier{"", "Data/Text.txt"}));
+
+    package = nullptr;
+    compressedPackage = nullptr;
+    fileSystem->Delete(packageName);
+    fileSystem->Delete(compressedPackageName);
+}
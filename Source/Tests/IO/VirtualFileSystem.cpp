@@ -21,7 +21,9 @@
 //
 #include "../CommonUtils.h"
 
+#include <Urho3D/IO/MemoryMappedFile.h>
 #include <Urho3D/IO/VirtualFileSystem.h>
+#include <Urho3D/Resource/BinaryFile.h>
 
 TEST_CASE("FileIdentifier tests")
 {
@@ -54,3 +56,39 @@ TEST_CASE("VirtualFileSystem can read and write text")
     auto restoredText = vfs->ReadAllText(fileId);
     REQUIRE(testString == restoredText);
 }
+
+TEST_CASE("VirtualFileSystem opens memory-mapped files")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    auto vfs = context->GetSubsystem<VirtualFileSystem>();
+
+    FileIdentifier fileId{"conf", "test_mapped_file.txt"};
+    ea::string testString{"Memory mapped file contents"};
+    REQUIRE(vfs->WriteAllText(fileId, testString));
+
+    AbstractFilePtr file = vfs->OpenMappedFile(fileId);
+    REQUIRE(file);
+    REQUIRE(file->GetSize() == testString.size());
+    if (MemoryMapping::IsSupported())
+    {
+        REQUIRE(dynamic_cast<MemoryMappedFile*>(file.Get()));
+        const unsigned char* data = file->GetContiguousData();
+        REQUIRE(data);
+        REQUIRE(ea::string(reinterpret_cast<const char*>(data), file->GetSize()) == testString);
+
+        // Binary file references the mapping until the data is requested as vector
+        auto binaryFile = MakeShared<BinaryFile>(context);
+        REQUIRE(binaryFile->Load(*file));
+        REQUIRE(binaryFile->GetSpan().data() == data);
+        REQUIRE(binaryFile->GetText() == testString);
+        REQUIRE(binaryFile->GetData().size() == testString.size());
+        REQUIRE(binaryFile->GetSpan().data() != data);
+        REQUIRE(binaryFile->GetText() == testString);
+    }
+
+    file->Seek(7);
+    REQUIRE(file->ReadLine() == "mapped file contents");
+
+    // Mapped files are read-only
+    REQUIRE(file->Write("X", 1) == 0);
+}
@@ -27,11 +27,13 @@
 #include "../CommonUtils.h"
 #include "../SceneUtils.h"
 
+#include <Urho3D/Core/WorkQueue.h>
 #include <Urho3D/Scene/Scene.h>
 #include <Urho3D/Resource/ResourceCache.h>
 #include <Urho3D/Navigation/CrowdAgent.h>
 #include <Urho3D/Navigation/DynamicNavigationMesh.h>
 #include <Urho3D/Navigation/Navigable.h>
+#include <Urho3D/Navigation/Obstacle.h>
 #include <Urho3D/Physics/CollisionShape.h>
 #include <Urho3D/Physics/RigidBody.h>
 #include <Urho3D/Graphics/Octree.h>
@@ -82,6 +84,120 @@ SharedPtr<Scene> CreateTestScene(Context* context, int numObjects)
 }
 
 
+SharedPtr<Scene> CreateObstacleTestScene(Context* context)
+{
+    auto scene = MakeShared<Scene>(context);
+    scene->CreateComponent<Octree>();
+    scene->CreateComponent<Navigable>();
+
+    Node* planeNode = scene->CreateChild("Plane");
+    planeNode->SetScale(Vector3(60.0f, 0.01f, 60.0f));
+    planeNode->CreateComponent<RigidBody>();
+    planeNode->CreateComponent<CollisionShape>()->SetBox(Vector3::ONE);
+
+    Node* boxNode = scene->CreateChild("Box");
+    boxNode->SetPosition(Vector3(-15.0f, 2.5f, -15.0f));
+    boxNode->SetScale(5.0f);
+    boxNode->CreateComponent<RigidBody>();
+    boxNode->CreateComponent<CollisionShape>()->SetBox(Vector3::ONE);
+
+    return scene;
+}
+
+template <class T> T* CreateObstacleTestNavigationMesh(Scene* scene)
+{
+    auto navMesh = scene->CreateComponent<T>();
+    navMesh->SetTileSize(16);
+    navMesh->SetPadding(Vector3(0.0f, 10.0f, 0.0f));
+    REQUIRE(navMesh->Rebuild());
+    return navMesh;
+}
+
+/// Return nearest points on the navigation mesh for the grid of points on the ground.
+ea::vector<Vector3> SampleNavigationMesh(NavigationMesh* navMesh)
+{
+    ea::vector<Vector3> result;
+    for (int x = -28; x <= 28; x += 2)
+    {
+        for (int z = -28; z <= 28; z += 2)
+            result.push_back(navMesh->FindNearestPoint(Vector3(x, 0.0f, z), Vector3::ONE));
+    }
+    return result;
+}
+
+template <class T> void TestAsyncTileRebuild()
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    auto workQueue = context->GetSubsystem<WorkQueue>();
+
+    auto sceneSync = CreateObstacleTestScene(context);
+    auto sceneAsync = CreateObstacleTestScene(context);
+    auto navMeshSync = CreateObstacleTestNavigationMesh<T>(sceneSync);
+    auto navMeshAsync = CreateObstacleTestNavigationMesh<T>(sceneAsync);
+
+    const auto originalSamples = SampleNavigationMesh(navMeshAsync);
+    REQUIRE(SampleNavigationMesh(navMeshSync) == originalSamples);
+
+    // Move static geometry and rebuild old and new areas
+    const BoundingBox oldBox{Vector3(-17.5f, 0.0f, -17.5f), Vector3(-12.5f, 5.0f, -12.5f)};
+    const BoundingBox newBox{Vector3(12.5f, 0.0f, 12.5f), Vector3(17.5f, 5.0f, 17.5f)};
+    sceneSync->GetChild("Box")->SetPosition(Vector3(15.0f, 2.5f, 15.0f));
+    sceneAsync->GetChild("Box")->SetPosition(Vector3(15.0f, 2.5f, 15.0f));
+
+    REQUIRE(navMeshSync->BuildTilesInRegion(oldBox));
+    REQUIRE(navMeshSync->BuildTilesInRegion(newBox));
+
+    navMeshAsync->MarkRegionDirty(oldBox);
+    navMeshAsync->MarkRegionDirty(newBox);
+    REQUIRE(navMeshAsync->GetNumDirtyTiles() > 0);
+
+    navMeshAsync->BuildDirtyTilesAsync();
+    REQUIRE(navMeshAsync->GetNumDirtyTiles() == 0);
+    REQUIRE(navMeshAsync->IsBuildingTiles());
+    REQUIRE(SampleNavigationMesh(navMeshAsync) == originalSamples);
+
+    workQueue->CompleteAll();
+    REQUIRE_FALSE(navMeshAsync->IsBuildingTiles());
+
+    const auto rebuiltSamples = SampleNavigationMesh(navMeshAsync);
+    REQUIRE(rebuiltSamples != originalSamples);
+    REQUIRE(rebuiltSamples == SampleNavigationMesh(navMeshSync));
+}
+
+/// Return positions of the path points.
+ea::vector<Vector3> GetPathPositions(const ea::vector<NavigationPathPoint>& path)
+{
+    ea::vector<Vector3> result;
+    for (const NavigationPathPoint& point : path)
+        result.push_back(point.position_);
+    return result;
+}
+
+/// Create crowd of agents on the grid walking to the opposite side of the navigation mesh.
+CrowdManager* CreateTestCrowd(Scene* scene, unsigned gridSize, bool multiThreaded)
+{
+    auto crowdManager = scene->CreateComponent<CrowdManager>();
+    crowdManager->SetMaxAgents(gridSize * gridSize);
+    crowdManager->SetMultiThreaded(multiThreaded);
+
+    Node* agentsNode = scene->CreateChild("Agents");
+    const float step = 50.0f / gridSize;
+    for (unsigned x = 0; x < gridSize; ++x)
+    {
+        for (unsigned z = 0; z < gridSize; ++z)
+        {
+            Node* agentNode = agentsNode->CreateChild("Agent");
+            agentNode->SetWorldPosition(Vector3(x * step - 25.0f, 0.0f, z * step - 25.0f));
+            auto agent = agentNode->CreateComponent<CrowdAgent>();
+            agent->SetHeight(2.0f);
+            agent->SetMaxSpeed(3.0f);
+            agent->SetMaxAccel(5.0f);
+            agent->SetTargetPosition(Vector3(25.0f - x * step, 0.0f, 25.0f - z * step));
+        }
+    }
+    return crowdManager;
+}
+
 CrowdAgentTest SpawnCrowdAgent(Vector3 pos, Node* agentsSceneNode, bool isValid)
 {
     CrowdAgentTest return_agent;
@@ -185,5 +301,159 @@ TEST_CASE("Recast/Detour Crowdmanager test with DynamicNavigationMesh")
 
 }
 
+TEST_CASE("NavigationMesh tiles are rebuilt asynchronously")
+{
+    TestAsyncTileRebuild<NavigationMesh>();
+}
+
+TEST_CASE("DynamicNavigationMesh tiles are rebuilt asynchronously")
+{
+    TestAsyncTileRebuild<DynamicNavigationMesh>();
+}
+
+TEST_CASE("Asynchronous path requests match synchronous queries")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+
+    auto scene = CreateObstacleTestScene(context);
+    auto navMesh = CreateObstacleTestNavigationMesh<NavigationMesh>(scene);
+    navMesh->SetPathIterationBudget(1);
+
+    const Vector3 start{-25.0f, 0.0f, -25.0f};
+    const Vector3 end{25.0f, 0.0f, 25.0f};
+
+    ea::vector<NavigationPathPoint> expectedPath;
+    navMesh->FindPath(expectedPath, start, end);
+    REQUIRE(expectedPath.size() > 2);
+
+    bool completed = false;
+    ea::vector<NavigationPathPoint> path;
+    const auto onCompleted = [&](const ea::vector<NavigationPathPoint>& result)
+    {
+        completed = true;
+        path = result;
+    };
+
+    // Search is sliced between updates
+    REQUIRE(navMesh->FindPathAsync(start, end, onCompleted) != 0);
+    REQUIRE(navMesh->GetNumPendingPathRequests() == 1);
+
+    unsigned numUpdates = 0;
+    for (; numUpdates < 1000 && !completed; ++numUpdates)
+        navMesh->ProcessPathRequests();
+    REQUIRE(completed);
+    REQUIRE(numUpdates > 1);
+    REQUIRE(navMesh->GetNumPendingPathRequests() == 0);
+    REQUIRE(GetPathPositions(path) == GetPathPositions(expectedPath));
+
+    // Path between the same polygons is taken from the cache
+    completed = false;
+    path.clear();
+    REQUIRE(navMesh->FindPathAsync(start, end, onCompleted) != 0);
+    navMesh->ProcessPathRequests();
+    REQUIRE(completed);
+    REQUIRE(GetPathPositions(path) == GetPathPositions(expectedPath));
+
+    // Cancelled requests are never completed
+    completed = false;
+    const unsigned requestId = navMesh->FindPathAsync(end, start, onCompleted);
+    REQUIRE(navMesh->CancelPathRequest(requestId));
+    REQUIRE_FALSE(navMesh->CancelPathRequest(requestId));
+    for (unsigned i = 0; i < 100; ++i)
+        navMesh->ProcessPathRequests();
+    REQUIRE_FALSE(completed);
+    REQUIRE(navMesh->GetNumPendingPathRequests() == 0);
+}
+
+TEST_CASE("Asynchronous path request is completed while obstacle moves every frame")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+
+    auto scene = CreateObstacleTestScene(context);
+    auto navMesh = CreateObstacleTestNavigationMesh<DynamicNavigationMesh>(scene);
+    navMesh->SetPathIterationBudget(1);
+
+    Node* obstacleNode = scene->CreateChild("Obstacle");
+    auto obstacle = obstacleNode->CreateComponent<Obstacle>();
+    obstacle->SetRadius(2.0f);
+    obstacle->SetHeight(2.0f);
+
+    const Vector3 start{-25.0f, 0.0f, -25.0f};
+    const Vector3 end{25.0f, 0.0f, 25.0f};
+
+    bool completed = false;
+    ea::vector<NavigationPathPoint> path;
+    REQUIRE(navMesh->FindPathAsync(start, end,
+        [&](const ea::vector<NavigationPathPoint>& result)
+    {
+        completed = true;
+        path = result;
+    }) != 0);
+
+    // Obstacle crosses the path and tiles are rebuilt on every frame
+    unsigned numFrames = 0;
+    for (; numFrames < 1000 && !completed; ++numFrames)
+    {
+        obstacleNode->SetPosition(Vector3(Sin(numFrames * 10.0f) * 8.0f, 0.0f, 0.0f));
+        Tests::RunFrame(context, 1.0f / 60.0f);
+    }
+
+    REQUIRE(completed);
+    CHECK(numFrames > 1);
+    REQUIRE_FALSE(path.empty());
+    CHECK(path.back().position_.Equals(navMesh->FindNearestPoint(end), 0.1f));
+}
+
+TEST_CASE("Multithreaded crowd update matches single-threaded update")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    if (WorkQueue::GetThreadIndexCount() == 1)
+    {
+        WARN("Worker threads are not available, crowd update is single-threaded");
+        return;
+    }
+
+    auto sceneSerial = CreateObstacleTestScene(context);
+    auto sceneParallel = CreateObstacleTestScene(context);
+    CreateObstacleTestNavigationMesh<NavigationMesh>(sceneSerial);
+    CreateObstacleTestNavigationMesh<NavigationMesh>(sceneParallel);
+    CreateTestCrowd(sceneSerial, 16, false);
+    CreateTestCrowd(sceneParallel, 16, true);
+
+    Tests::RunFrame(context, 2.0f, 0.05f);
+
+    const auto& agentsSerial = sceneSerial->GetChild("Agents")->GetChildren();
+    const auto& agentsParallel = sceneParallel->GetChild("Agents")->GetChildren();
+    REQUIRE(agentsSerial.size() == agentsParallel.size());
+    for (unsigned i = 0; i < agentsSerial.size(); ++i)
+        REQUIRE(agentsSerial[i]->GetWorldPosition() == agentsParallel[i]->GetWorldPosition());
+}
+
+TEST_CASE("Crowd update with many agents", "[.][benchmark]")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+
+    for (const unsigned gridSize : {32, 71, 100})
+    {
+        for (const bool multiThreaded : {false, true})
+        {
+            auto scene = CreateObstacleTestScene(context);
+            CreateObstacleTestNavigationMesh<NavigationMesh>(scene);
+            auto crowdManager = CreateTestCrowd(scene, gridSize, multiThreaded);
+
+            // Let the agents plan their paths and start moving
+            Tests::RunFrame(context, 0.5f, 0.05f);
+
+            const ea::string name = Format("{} agents, {}", gridSize * gridSize,
+                multiThreaded ? "multithreaded" : "single-threaded");
+            BENCHMARK(name.c_str())
+            {
+                Tests::RunFrame(context, 1.0f / 60.0f);
+                return crowdManager->GetMaxAgents();
+            };
+        }
+    }
+}
+
 #endif
 #endif
@@ -0,0 +1,348 @@
+//
+// Copyright (c) 2025-2025 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR rhs
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR rhsWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR rhs DEALINGS IN
+// THE SOFTWARE.
+//
+
+#if URHO3D_PHYSICS
+
+#include "../CommonUtils.h"
+
+#include <Urho3D/Math/Ray.h>
+#include <Urho3D/Physics/CollisionShape.h>
+#include <Urho3D/Physics/PhysicsSnapshot.h>
+#include <Urho3D/Physics/PhysicsWorld.h>
+#include <Urho3D/Physics/RigidBody.h>
+#include <Urho3D/Scene/Scene.h>
+
+namespace
+{
+
+/// Create scene similar to 12_PhysicsStressTest sample: large floor and columns of falling boxes.
+SharedPtr<Scene> CreatePhysicsStressScene(Context* context, bool multiThreaded, unsigned gridSize, unsigned columnHeight)
+{
+    const bool oldMultiThreaded = PhysicsWorld::config.multiThreaded_;
+    PhysicsWorld::config.multiThreaded_ = multiThreaded;
+
+    auto scene = MakeShared<Scene>(context);
+    scene->CreateComponent<PhysicsWorld>();
+
+    PhysicsWorld::config.multiThreaded_ = oldMultiThreaded;
+
+    Node* floorNode = scene->CreateChild("Floor");
+    floorNode->SetPosition(Vector3(0.0f, -0.5f, 0.0f));
+    floorNode->SetScale(Vector3(500.0f, 1.0f, 500.0f));
+    floorNode->CreateComponent<RigidBody>();
+    floorNode->CreateComponent<CollisionShape>()->SetBox(Vector3::ONE);
+
+    for (unsigned x = 0; x < gridSize; ++x)
+    {
+        for (unsigned z = 0; z < gridSize; ++z)
+        {
+            for (unsigned i = 0; i < columnHeight; ++i)
+            {
+                // Slightly offset boxes so the columns collapse
+                Node* boxNode = scene->CreateChild("Box");
+                boxNode->SetPosition(Vector3(x * 4.0f + i * 0.1f, i * 2.0f + 1.0f, z * 4.0f));
+
+                auto body = boxNode->CreateComponent<RigidBody>();
+                body->SetMass(1.0f);
+                body->SetFriction(1.0f);
+                body->SetCollisionEventMode(COLLISION_NEVER);
+                boxNode->CreateComponent<CollisionShape>()->SetBox(Vector3::ONE);
+            }
+        }
+    }
+
+    return scene;
+}
+
+ea::vector<Vector3> GetBoxPositions(Scene* scene)
+{
+    ea::vector<Vector3> result;
+    for (Node* node : scene->GetChildren())
+    {
+        if (node->GetName() == "Box")
+            result.push_back(node->GetWorldPosition());
+    }
+    return result;
+}
+
+bool IsSameBodyState(const PhysicsBodySnapshot& lhs, const PhysicsBodySnapshot& rhs)
+{
+    return lhs.componentId_ == rhs.componentId_ && lhs.activationState_ == rhs.activationState_
+        && lhs.deactivationTime_ == rhs.deactivationTime_ && lhs.worldTransform_ == rhs.worldTransform_
+        && lhs.interpolationWorldTransform_ == rhs.interpolationWorldTransform_
+        && lhs.linearVelocity_ == rhs.linearVelocity_ && lhs.angularVelocity_ == rhs.angularVelocity_
+        && lhs.interpolationLinearVelocity_ == rhs.interpolationLinearVelocity_
+        && lhs.interpolationAngularVelocity_ == rhs.interpolationAngularVelocity_;
+}
+
+bool IsSameState(const PhysicsSnapshot& lhs, const PhysicsSnapshot& rhs)
+{
+    const auto& lhsBodies = lhs.GetBodies();
+    const auto& rhsBodies = rhs.GetBodies();
+    return lhsBodies.size() == rhsBodies.size()
+        && ea::equal(lhsBodies.begin(), lhsBodies.end(), rhsBodies.begin(), IsSameBodyState);
+}
+
+void StepPhysics(PhysicsWorld* physicsWorld, unsigned numSteps)
+{
+    for (unsigned i = 0; i < numSteps; ++i)
+        physicsWorld->CustomUpdate(1, 1.0f / 60.0f, 0.0f, ea::nullopt);
+}
+
+}
+
+TEST_CASE("Multithreaded physics simulation is deterministic")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+
+    auto sceneA = CreatePhysicsStressScene(context, true, 4, 8);
+    auto sceneB = CreatePhysicsStressScene(context, true, 4, 8);
+    auto physicsWorldA = sceneA->GetComponent<PhysicsWorld>();
+    auto physicsWorldB = sceneB->GetComponent<PhysicsWorld>();
+    REQUIRE(physicsWorldA->IsMultiThreaded() == physicsWorldB->IsMultiThreaded());
+#if BT_THREADSAFE
+    REQUIRE(physicsWorldA->IsMultiThreaded());
+#endif
+    if (!physicsWorldA->IsMultiThreaded())
+    {
+        WARN("Multithreaded physics is not available in this build");
+        return;
+    }
+
+    for (unsigned i = 0; i < 120; ++i)
+    {
+        physicsWorldA->Update(1.0f / 60.0f);
+        physicsWorldB->Update(1.0f / 60.0f);
+    }
+
+    const auto positionsA = GetBoxPositions(sceneA);
+    const auto positionsB = GetBoxPositions(sceneB);
+    REQUIRE(positionsA.size() == 4 * 4 * 8);
+    REQUIRE(positionsA == positionsB);
+
+    // Boxes have fallen and are resting on the floor
+    for (const Vector3& position : positionsA)
+    {
+        REQUIRE(position.y_ > 0.0f);
+        REQUIRE(position.y_ < 16.0f);
+    }
+}
+
+TEST_CASE("Physics stress test", "[.][benchmark]")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+
+    for (const bool multiThreaded : {false, true})
+    {
+        auto scene = CreatePhysicsStressScene(context, multiThreaded, 10, 40);
+        auto physicsWorld = scene->GetComponent<PhysicsWorld>();
+        if (multiThreaded && !physicsWorld->IsMultiThreaded())
+        {
+            WARN("Multithreaded physics is not available in this build");
+            continue;
+        }
+
+        // Let the columns collapse so there are many contacts
+        for (unsigned i = 0; i < 60; ++i)
+            physicsWorld->Update(1.0f / 60.0f);
+
+        BENCHMARK(multiThreaded ? "Multithreaded" : "Single-threaded")
+        {
+            physicsWorld->Update(1.0f / 60.0f);
+            return scene->GetNumChildren();
+        };
+    }
+}
+
+TEST_CASE("Batched physics queries match single queries")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+
+    auto scene = CreatePhysicsStressScene(context, false, 4, 4);
+    auto physicsWorld = scene->GetComponent<PhysicsWorld>();
+    for (unsigned i = 0; i < 60; ++i)
+        physicsWorld->Update(1.0f / 60.0f);
+
+    auto shapeNode = scene->CreateChild("Probe");
+    auto probeShape = shapeNode->CreateComponent<CollisionShape>();
+    probeShape->SetBox(Vector3(0.5f, 0.5f, 0.5f));
+
+    PhysicsQueryBatch batch;
+    ea::vector<Ray> rays;
+    ea::vector<Sphere> spheres;
+    for (unsigned x = 0; x < 16; ++x)
+    {
+        for (unsigned z = 0; z < 16; ++z)
+        {
+            const Vector3 position{x - 1.5f, 20.0f, z - 1.5f};
+            const Ray ray{position, Vector3::DOWN};
+            rays.push_back(ray);
+            spheres.emplace_back(Vector3{position.x_, 1.0f, position.z_}, 1.5f);
+
+            batch.AddRaycast(ray, 30.0f);
+            batch.AddSphereCast(ray, 0.5f, 30.0f);
+            batch.AddConvexCast(probeShape, ray.origin_, Quaternion::IDENTITY, ray.origin_ + ray.direction_ * 30.0f,
+                Quaternion::IDENTITY);
+            batch.AddOverlap(spheres.back());
+        }
+    }
+    physicsWorld->ExecuteQueryBatch(batch);
+
+    REQUIRE(batch.GetNumCasts() == rays.size() * 3);
+    REQUIRE(batch.GetNumOverlaps() == spheres.size());
+
+    const auto checkCastResult = [](const PhysicsRaycastResult& actual, const PhysicsRaycastResult& expected)
+    {
+        REQUIRE(actual.body_ == expected.body_);
+        REQUIRE(actual.position_.Equals(expected.position_));
+        REQUIRE(actual.normal_.Equals(expected.normal_));
+    };
+
+    unsigned numHits = 0;
+    unsigned numOverlaps = 0;
+    for (unsigned i = 0; i < rays.size(); ++i)
+    {
+        PhysicsRaycastResult expected;
+
+        physicsWorld->RaycastSingle(expected, rays[i], 30.0f);
+        checkCastResult(batch.GetCastResult(i * 3), expected);
+        numHits += expected.body_ != nullptr;
+
+        physicsWorld->SphereCast(expected, rays[i], 0.5f, 30.0f);
+        checkCastResult(batch.GetCastResult(i * 3 + 1), expected);
+
+        physicsWorld->ConvexCast(expected, probeShape, rays[i].origin_, Quaternion::IDENTITY,
+            rays[i].origin_ + rays[i].direction_ * 30.0f, Quaternion::IDENTITY);
+        checkCastResult(batch.GetCastResult(i * 3 + 2), expected);
+
+        ea::vector<RigidBody*> expectedBodies;
+        physicsWorld->GetRigidBodies(expectedBodies, spheres[i]);
+        const auto actualSpan = batch.GetOverlapResult(i);
+        ea::vector<RigidBody*> actualBodies(actualSpan.begin(), actualSpan.end());
+        ea::sort(expectedBodies.begin(), expectedBodies.end());
+        ea::sort(actualBodies.begin(), actualBodies.end());
+        REQUIRE(actualBodies == expectedBodies);
+        numOverlaps += actualBodies.size();
+    }
+
+    // Every ray hits at least the floor, and overlaps near the floor always find something
+    REQUIRE(numHits == rays.size());
+    REQUIRE(numOverlaps >= spheres.size());
+}
+
+TEST_CASE("Physics snapshot restores simulation state")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+
+    auto scene = CreatePhysicsStressScene(context, false, 2, 4);
+    auto physicsWorld = scene->GetComponent<PhysicsWorld>();
+
+    StepPhysics(physicsWorld, 30);
+
+    PhysicsSnapshot snapshot;
+    physicsWorld->CaptureSnapshot(snapshot, true);
+    const auto capturedPositions = GetBoxPositions(scene);
+    REQUIRE(snapshot.GetBodies().size() == 1 + 2 * 2 * 4);
+    REQUIRE(snapshot.HasContacts());
+    REQUIRE(!snapshot.GetManifolds().empty());
+
+    StepPhysics(physicsWorld, 30);
+    REQUIRE(GetBoxPositions(scene) != capturedPositions);
+
+    physicsWorld->RestoreSnapshot(snapshot);
+
+    PhysicsSnapshot restoredSnapshot;
+    physicsWorld->CaptureSnapshot(restoredSnapshot, true);
+    REQUIRE(IsSameState(snapshot, restoredSnapshot));
+    REQUIRE(restoredSnapshot.GetManifolds().size() <= snapshot.GetManifolds().size());
+
+    const auto restoredPositions = GetBoxPositions(scene);
+    REQUIRE(restoredPositions.size() == capturedPositions.size());
+    for (unsigned i = 0; i < capturedPositions.size(); ++i)
+        REQUIRE(restoredPositions[i].Equals(capturedPositions[i]));
+}
+
+TEST_CASE("Physics snapshot resimulation of free bodies is exact")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+
+    auto scene = MakeShared<Scene>(context);
+    auto physicsWorld = scene->CreateComponent<PhysicsWorld>();
+
+    for (unsigned i = 0; i < 4; ++i)
+    {
+        Node* boxNode = scene->CreateChild("Box");
+        boxNode->SetPosition(Vector3(i * 4.0f, 10.0f, 0.0f));
+
+        auto body = boxNode->CreateComponent<RigidBody>();
+        body->SetMass(1.0f);
+        body->SetLinearVelocity(Vector3(1.0f, 2.0f, 0.0f));
+        body->SetAngularVelocity(Vector3(0.0f, i * 1.0f, 1.0f));
+        boxNode->CreateComponent<CollisionShape>()->SetBox(Vector3::ONE);
+    }
+
+    StepPhysics(physicsWorld, 10);
+
+    PhysicsSnapshot snapshot;
+    physicsWorld->CaptureSnapshot(snapshot);
+    REQUIRE(!snapshot.HasContacts());
+
+    StepPhysics(physicsWorld, 20);
+    PhysicsSnapshot expectedSnapshot;
+    physicsWorld->CaptureSnapshot(expectedSnapshot);
+    const auto expectedPositions = GetBoxPositions(scene);
+
+    physicsWorld->RestoreSnapshot(snapshot);
+    StepPhysics(physicsWorld, 20);
+    PhysicsSnapshot actualSnapshot;
+    physicsWorld->CaptureSnapshot(actualSnapshot);
+
+    REQUIRE(IsSameState(expectedSnapshot, actualSnapshot));
+    REQUIRE(GetBoxPositions(scene) == expectedPositions);
+}
+
+TEST_CASE("Physics snapshot buffer keeps most recent frames")
+{
+    PhysicsSnapshotBuffer buffer(4);
+    REQUIRE(buffer.GetCapacity() == 4);
+
+    for (unsigned i = 0; i < 6; ++i)
+        buffer.Allocate(static_cast<NetworkFrame>(i));
+
+    REQUIRE(buffer.Find(NetworkFrame{0}) == nullptr);
+    REQUIRE(buffer.Find(NetworkFrame{1}) == nullptr);
+    REQUIRE(buffer.Find(NetworkFrame{2}) != nullptr);
+    REQUIRE(buffer.Find(NetworkFrame{5}) != nullptr);
+    REQUIRE(buffer.Find(NetworkFrame{6}) == nullptr);
+
+    buffer.DiscardFrom(NetworkFrame{4});
+    REQUIRE(buffer.Find(NetworkFrame{3}) != nullptr);
+    REQUIRE(buffer.Find(NetworkFrame{4}) == nullptr);
+    REQUIRE(buffer.Find(NetworkFrame{5}) == nullptr);
+
+    // Negative frames are mapped to valid slots as well
+    buffer.Allocate(NetworkFrame{-1});
+    REQUIRE(buffer.Find(NetworkFrame{-1}) != nullptr);
+    REQUIRE(buffer.Find(NetworkFrame{3}) == nullptr);
+}
+
+#endif
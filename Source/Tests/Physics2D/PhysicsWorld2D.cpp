@@ -0,0 +1,98 @@
+//
+// Copyright (c) 2025-2025 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR rhs
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR rhsWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR rhs DEALINGS IN
+// THE SOFTWARE.
+//
+
+#if URHO3D_PHYSICS2D
+
+#include "../CommonUtils.h"
+
+#include <Urho3D/Physics2D/CollisionBox2D.h>
+#include <Urho3D/Physics2D/CollisionCircle2D.h>
+#include <Urho3D/Physics2D/PhysicsWorld2D.h>
+#include <Urho3D/Physics2D/RigidBody2D.h>
+#include <Urho3D/Scene/Scene.h>
+
+TEST_CASE("Batched 2D physics queries match single queries")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+
+    auto scene = MakeShared<Scene>(context);
+    auto physicsWorld = scene->CreateComponent<PhysicsWorld2D>();
+
+    Node* groundNode = scene->CreateChild("Ground");
+    groundNode->CreateComponent<RigidBody2D>()->SetBodyType(BT_STATIC);
+    groundNode->CreateComponent<CollisionBox2D>()->SetSize(Vector2(100.0f, 1.0f));
+
+    for (unsigned i = 0; i < 32; ++i)
+    {
+        Node* node = scene->CreateChild("Body");
+        node->SetPosition2D(Vector2(i * 1.5f - 24.0f, 1.0f + (i % 4) * 2.0f));
+        node->CreateComponent<RigidBody2D>()->SetBodyType(BT_DYNAMIC);
+        if (i % 2)
+            node->CreateComponent<CollisionBox2D>()->SetSize(Vector2::ONE);
+        else
+            node->CreateComponent<CollisionCircle2D>()->SetRadius(0.5f);
+    }
+
+    for (unsigned i = 0; i < 30; ++i)
+        physicsWorld->Update(1.0f / 60.0f);
+
+    PhysicsQueryBatch2D batch;
+    ea::vector<Vector2> points;
+    ea::vector<Rect> boxes;
+    for (unsigned i = 0; i < 128; ++i)
+    {
+        const Vector2 point{i * 0.4f - 25.0f, 20.0f};
+        points.push_back(point);
+        boxes.emplace_back(Vector2(point.x_ - 1.0f, 0.0f), Vector2(point.x_ + 1.0f, 4.0f));
+
+        batch.AddRaycast(point, point - Vector2(0.0f, 30.0f));
+        batch.AddCircleCast(point, point - Vector2(0.0f, 30.0f), 0.25f);
+        batch.AddOverlap(boxes.back());
+    }
+    physicsWorld->ExecuteQueryBatch(batch);
+
+    REQUIRE(batch.GetNumCasts() == points.size() * 2);
+    REQUIRE(batch.GetNumOverlaps() == points.size());
+
+    for (unsigned i = 0; i < points.size(); ++i)
+    {
+        PhysicsRaycastResult2D expected;
+        physicsWorld->RaycastSingle(expected, points[i], points[i] - Vector2(0.0f, 30.0f));
+
+        const PhysicsRaycastResult2D& ray = batch.GetCastResult(i * 2);
+        REQUIRE(expected.body_);
+        REQUIRE(ray.body_ == expected.body_);
+        REQUIRE(ray.position_.Equals(expected.position_));
+
+        // Circle hits no later than the ray
+        const PhysicsRaycastResult2D& circle = batch.GetCastResult(i * 2 + 1);
+        REQUIRE(circle.body_);
+        REQUIRE(circle.distance_ <= ray.distance_ + M_LARGE_EPSILON);
+
+        ea::vector<RigidBody2D*> expectedBodies;
+        physicsWorld->GetRigidBodies(expectedBodies, boxes[i]);
+        const auto actualBodies = batch.GetOverlapResult(i);
+        REQUIRE(ea::vector<RigidBody2D*>(actualBodies.begin(), actualBodies.end()) == expectedBodies);
+    }
+}
+
+#endif
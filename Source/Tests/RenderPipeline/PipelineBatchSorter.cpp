@@ -0,0 +1,154 @@
+//
+// Copyright (c) 2017-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../CommonUtils.h"
+
+#include <Urho3D/Core/WorkQueue.h>
+#include <Urho3D/Math/RandomEngine.h>
+#include <Urho3D/RenderPipeline/PipelineBatchSortKey.h>
+#include <Urho3D/RenderPipeline/PipelineBatchSorter.h>
+
+namespace
+{
+
+/// Create batches with random keys. Keys use only some bits, like object IDs do.
+ea::vector<PipelineBatchByState> CreateBatchesByState(RandomEngine& re, unsigned numBatches)
+{
+    ea::vector<PipelineBatchByState> batches(numBatches);
+    for (PipelineBatchByState& batch : batches)
+    {
+        batch.primaryKey_ = (static_cast<unsigned long long>(re.GetUInt(64)) << PipelineBatchByState::PipelineStateOffset)
+            | (static_cast<unsigned long long>(re.GetUInt(256)) << PipelineBatchByState::MaterialOffset);
+        batch.secondaryKey_ = static_cast<unsigned long long>(re.GetUInt(1024)) << PipelineBatchByState::GeometryOffset;
+    }
+    return batches;
+}
+
+ea::vector<PipelineBatchBackToFront> CreateBatchesBackToFront(RandomEngine& re, unsigned numBatches)
+{
+    ea::vector<PipelineBatchBackToFront> batches(numBatches);
+    for (PipelineBatchBackToFront& batch : batches)
+    {
+        batch.renderOrder_ = static_cast<unsigned char>(re.GetUInt(3) * 64);
+        batch.distance_ = re.GetFloat(-10.0f, 1000.0f);
+    }
+    return batches;
+}
+
+template <class T> bool IsSorted(const ea::vector<T>& batches)
+{
+    for (unsigned i = 1; i < batches.size(); ++i)
+    {
+        if (batches[i] < batches[i - 1])
+            return false;
+    }
+    return true;
+}
+
+}
+
+TEST_CASE("PipelineBatchSorter sorts batches in the same order as comparison")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    auto workQueue = context->GetSubsystem<WorkQueue>();
+
+    RandomEngine re(0);
+    for (unsigned numBatches : {0u, 1u, 100u, 5000u, 50000u})
+    {
+        PipelineBatchSorter<PipelineBatchByState> sorterByState;
+        auto batchesByState = CreateBatchesByState(re, numBatches);
+        sorterByState.Sort(workQueue, batchesByState);
+        REQUIRE(IsSorted(batchesByState));
+
+        PipelineBatchSorter<PipelineBatchBackToFront> sorterBackToFront;
+        auto batchesBackToFront = CreateBatchesBackToFront(re, numBatches);
+        sorterBackToFront.Sort(workQueue, batchesBackToFront);
+        REQUIRE(IsSorted(batchesBackToFront));
+    }
+}
+
+TEST_CASE("PipelineBatchSorter reuses order from previous sort")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    auto workQueue = context->GetSubsystem<WorkQueue>();
+
+    RandomEngine re(0);
+    PipelineBatchSorter<PipelineBatchBackToFront> sorter;
+    const auto unsortedBatches = CreateBatchesBackToFront(re, 10000);
+
+    auto batches = unsortedBatches;
+    sorter.Sort(workQueue, batches);
+    REQUIRE_FALSE(sorter.IsOrderReused());
+    REQUIRE(IsSorted(batches));
+
+    // Same input in the next frame
+    batches = unsortedBatches;
+    sorter.Sort(workQueue, batches);
+    REQUIRE(sorter.IsOrderReused());
+    REQUIRE(IsSorted(batches));
+
+    // Order changed
+    batches = unsortedBatches;
+    ea::swap(batches[0].distance_, batches[1].distance_);
+    ea::swap(batches[0].renderOrder_, batches[1].renderOrder_);
+    sorter.Sort(workQueue, batches);
+    REQUIRE_FALSE(sorter.IsOrderReused());
+    REQUIRE(IsSorted(batches));
+}
+
+TEST_CASE("PipelineBatchSorter is faster than comparison sort", "[.][benchmark]")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    auto workQueue = context->GetSubsystem<WorkQueue>();
+
+    RandomEngine re(0);
+    for (unsigned numBatches : {1000u, 10000u, 100000u, 1000000u})
+    {
+        const auto unsortedBatches = CreateBatchesByState(re, numBatches);
+        ea::vector<PipelineBatchByState> batches;
+        PipelineBatchSorter<PipelineBatchByState> sorter;
+
+        BENCHMARK(Format("ea::sort {}", numBatches).c_str())
+        {
+            batches = unsortedBatches;
+            ea::sort(batches.begin(), batches.end());
+            return batches.size();
+        };
+
+        BENCHMARK(Format("Radix sort {}", numBatches).c_str())
+        {
+            // Use new sorter so that order is not reused
+            PipelineBatchSorter<PipelineBatchByState> newSorter;
+            batches = unsortedBatches;
+            newSorter.Sort(workQueue, batches);
+            return batches.size();
+        };
+
+        BENCHMARK(Format("Reused order {}", numBatches).c_str())
+        {
+            batches = unsortedBatches;
+            sorter.Sort(workQueue, batches);
+            return batches.size();
+        };
+    }
+}
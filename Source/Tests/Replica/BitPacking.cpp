@@ -0,0 +1,236 @@
+// Copyright (c) 2025-2025 the rbfx project.
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT> or the accompanying LICENSE file.
+
+#include "../CommonUtils.h"
+#include "../NetworkUtils.h"
+#include "../SceneUtils.h"
+
+#include <Urho3D/IO/MemoryBuffer.h>
+#include <Urho3D/IO/VectorBuffer.h>
+#include <Urho3D/Math/RandomEngine.h>
+#include <Urho3D/Network/Network.h>
+#include <Urho3D/Replica/BehaviorNetworkObject.h>
+#include <Urho3D/Replica/BitPacking.h>
+#include <Urho3D/Replica/ReplicatedTransform.h>
+#include <Urho3D/Replica/ReplicationManager.h>
+#include <Urho3D/Scene/PrefabResource.h>
+#include <Urho3D/Scene/Scene.h>
+#include <Urho3D/Scene/SceneEvents.h>
+
+namespace
+{
+
+SharedPtr<PrefabResource> CreateTransformTestPrefab(Context* context)
+{
+    auto node = MakeShared<Node>(context);
+    node->CreateComponent<ReplicatedTransform>();
+
+    return Tests::ConvertNodeToPrefab(node);
+}
+
+}
+
+TEST_CASE("BitWriter and BitReader consume the same number of bytes")
+{
+    VectorBuffer buffer;
+    {
+        BitWriter writer{buffer};
+        writer.WriteBool(true);
+        writer.WriteBits(5, 3);
+        writer.WriteVarInt(0);
+        writer.WriteVarInt(-1);
+        writer.WriteVarInt(123456);
+        writer.WriteVarInt(-(1 << 29));
+        writer.WriteBits(0xdeadbeef, 32);
+    }
+    buffer.WriteUByte(42);
+
+    MemoryBuffer src{buffer.GetBuffer()};
+    {
+        BitReader reader{src};
+        CHECK(reader.ReadBool() == true);
+        CHECK(reader.ReadBits(3) == 5);
+        CHECK(reader.ReadVarInt() == 0);
+        CHECK(reader.ReadVarInt() == -1);
+        CHECK(reader.ReadVarInt() == 123456);
+        CHECK(reader.ReadVarInt() == -(1 << 29));
+        CHECK(reader.ReadBits(32) == 0xdeadbeef);
+    }
+    CHECK(src.ReadUByte() == 42);
+    CHECK(src.IsEof());
+}
+
+TEST_CASE("Quaternion is compressed with smallest-three encoding")
+{
+    RandomEngine re(0);
+    for (unsigned i = 0; i < 1000; ++i)
+    {
+        const Quaternion rotation = re.GetQuaternion();
+
+        VectorBuffer buffer;
+        {
+            BitWriter writer{buffer};
+            WriteCompressedQuaternion(writer, rotation, 12);
+        }
+        CHECK(buffer.GetSize() == 5);
+
+        MemoryBuffer src{buffer.GetBuffer()};
+        BitReader reader{src};
+        const Quaternion decodedRotation = ReadCompressedQuaternion(reader, 12);
+        CHECK(Abs(rotation.DotProduct(decodedRotation)) > 0.99999f);
+    }
+}
+
+TEST_CASE("Quantized vector is delta-encoded against baseline")
+{
+    QuantizedVector3Baseline serverBaseline;
+    QuantizedVector3Baseline clientBaseline;
+
+    const auto sendFrame = [&](NetworkFrame frame, const IntVector3& value, bool lost)
+    {
+        serverBaseline.Update(frame, value, 4);
+
+        VectorBuffer buffer;
+        {
+            BitWriter writer{buffer};
+            serverBaseline.Write(writer, frame, value);
+        }
+
+        if (lost)
+            return ea::optional<IntVector3>{};
+
+        MemoryBuffer src{buffer.GetBuffer()};
+        BitReader reader{src};
+        return clientBaseline.Read(reader, frame);
+    };
+
+    // Baseline is sent as absolute value, then deltas
+    CHECK(sendFrame(NetworkFrame{10}, {1000, 0, 0}, false) == IntVector3{1000, 0, 0});
+    CHECK(sendFrame(NetworkFrame{11}, {1010, 0, 0}, false) == IntVector3{1010, 0, 0});
+    CHECK(sendFrame(NetworkFrame{13}, {1030, 0, 0}, false) == IntVector3{1030, 0, 0});
+
+    // Lost baseline invalidates deltas until the next baseline
+    CHECK_FALSE(sendFrame(NetworkFrame{14}, {1040, 0, 0}, true));
+    CHECK_FALSE(sendFrame(NetworkFrame{15}, {1050, 0, 0}, false));
+    CHECK(sendFrame(NetworkFrame{18}, {1080, 0, 0}, false) == IntVector3{1080, 0, 0});
+    CHECK(sendFrame(NetworkFrame{19}, {1090, 0, 0}, false) == IntVector3{1090, 0, 0});
+}
+
+TEST_CASE("Quantized ReplicatedTransform uses less bandwidth than raw")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    context->GetSubsystem<Network>()->SetUpdateFps(Tests::NetworkSimulator::FramesInSecond);
+
+    auto prefab = Tests::GetOrCreateResource<PrefabResource>(context, "@/BitPacking/TransformTest.prefab", CreateTransformTestPrefab);
+
+    // Setup scenes
+    const auto quality = Tests::ConnectionQuality{0.08f, 0.12f, 0.20f, 0, 0};
+    auto serverScene = MakeShared<Scene>(context);
+    auto clientScene = MakeShared<Scene>(context);
+
+    Node* rawNode = Tests::SpawnOnServer<BehaviorNetworkObject>(serverScene, prefab, "Raw Node", {100.0f, 0.0f, 0.0f});
+    auto rawTransform = rawNode->GetComponent<ReplicatedTransform>();
+
+    Node* quantizedNode = Tests::SpawnOnServer<BehaviorNetworkObject>(serverScene, prefab, "Quantized Node", {100.0f, 0.0f, 0.0f});
+    auto quantizedTransform = quantizedNode->GetComponent<ReplicatedTransform>();
+    quantizedTransform->SetQuantize(true);
+
+    // Animate objects forever
+    serverScene->SubscribeToEvent(serverScene, E_SCENEUPDATE,
+        [&](VariantMap& eventData)
+    {
+        const float timeStep = eventData[SceneUpdate::P_TIMESTEP].GetFloat();
+        for (Node* node : {rawNode, quantizedNode})
+        {
+            node->Translate(timeStep * Vector3::LEFT, TS_PARENT);
+            node->Rotate({timeStep * 10.0f, Vector3::UP}, TS_PARENT);
+        }
+    });
+
+    Tests::NetworkSimulator sim(serverScene);
+    sim.AddClient(clientScene, quality);
+    sim.SimulateTime(9.0f);
+
+    // Measure size of unreliable updates
+    const auto& serverReplicator = *serverScene->GetComponent<ReplicationManager>()->GetServerReplicator();
+    unsigned rawBytes = 0;
+    unsigned quantizedBytes = 0;
+    static constexpr unsigned numFrames = Tests::NetworkSimulator::FramesInSecond * 4;
+    for (unsigned i = 0; i < numFrames; ++i)
+    {
+        sim.SimulateTime(1.0f / Tests::NetworkSimulator::FramesInSecond);
+
+        VectorBuffer buffer;
+        rawTransform->WriteUnreliableDelta(serverReplicator.GetCurrentFrame(), buffer);
+        rawBytes += buffer.GetSize();
+
+        buffer.Clear();
+        quantizedTransform->WriteUnreliableDelta(serverReplicator.GetCurrentFrame(), buffer);
+        quantizedBytes += buffer.GetSize();
+    }
+
+    const float rawBytesPerFrame = static_cast<float>(rawBytes) / numFrames;
+    const float quantizedBytesPerFrame = static_cast<float>(quantizedBytes) / numFrames;
+    INFO("Bytes per object per frame: raw " << rawBytesPerFrame << ", quantized " << quantizedBytesPerFrame);
+    CHECK(quantizedBytesPerFrame * 2.0f < rawBytesPerFrame);
+
+    // Expect both objects to be synchronized with the precision of quantization
+    const auto& clientReplica = *clientScene->GetComponent<ReplicationManager>()->GetClientReplica();
+    const NetworkTime replicaTime = clientReplica.GetReplicaTime();
+
+    auto clientRawNode = clientScene->GetChild("Raw Node", true);
+    auto clientQuantizedNode = clientScene->GetChild("Quantized Node", true);
+    REQUIRE(clientRawNode);
+    REQUIRE(clientQuantizedNode);
+
+    const float positionError = ReplicatedTransform::DefaultMovementThreshold + ReplicatedTransform::DefaultPositionPrecision;
+    CHECK(clientRawNode->GetWorldPosition().Equals(clientQuantizedNode->GetWorldPosition(), positionError));
+    CHECK(quantizedTransform->SampleTemporalPosition(replicaTime).value_.Equals(clientQuantizedNode->GetWorldPosition(), positionError));
+    CHECK(Abs(clientRawNode->GetWorldRotation().DotProduct(clientQuantizedNode->GetWorldRotation())) > 0.9999f);
+}
+
+TEST_CASE("Quantized ReplicatedTransform sends absolute position on first and last upload after a move")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    context->GetSubsystem<Network>()->SetUpdateFps(Tests::NetworkSimulator::FramesInSecond);
+
+    auto prefab = Tests::GetOrCreateResource<PrefabResource>(context, "@/BitPacking/TransformTest.prefab", CreateTransformTestPrefab);
+
+    const auto quality = Tests::ConnectionQuality{0.08f, 0.12f, 0.20f, 0, 0};
+    auto serverScene = MakeShared<Scene>(context);
+    auto clientScene = MakeShared<Scene>(context);
+
+    Node* serverNode = Tests::SpawnOnServer<BehaviorNetworkObject>(serverScene, prefab, "Node", {100.0f, 0.0f, 0.0f});
+    auto serverTransform = serverNode->GetComponent<ReplicatedTransform>();
+    serverTransform->SetQuantize(true);
+
+    Tests::NetworkSimulator sim(serverScene);
+    sim.AddClient(clientScene, quality);
+    sim.SimulateTime(1.0f);
+
+    // Move object once and collect all uploads
+    serverNode->Translate(Vector3::LEFT, TS_PARENT);
+
+    const auto& serverReplicator = *serverScene->GetComponent<ReplicationManager>()->GetServerReplicator();
+    ea::vector<bool> isAbsolute;
+    for (unsigned i = 0; i < Tests::NetworkSimulator::FramesInSecond; ++i)
+    {
+        sim.SimulateTime(1.0f / Tests::NetworkSimulator::FramesInSecond);
+
+        const NetworkFrame frame = serverReplicator.GetCurrentFrame();
+        if (!serverTransform->PrepareUnreliableDelta(frame))
+            continue;
+
+        VectorBuffer buffer;
+        serverTransform->WriteUnreliableDelta(frame, buffer);
+        MemoryBuffer src{buffer.GetBuffer()};
+        BitReader reader{src};
+        isAbsolute.push_back(reader.ReadBool());
+    }
+
+    REQUIRE(isAbsolute.size() == ReplicatedTransform::DefaultNumUploadAttempts);
+    CHECK(isAbsolute.front());
+    CHECK(isAbsolute.back());
+    CHECK(ea::count(isAbsolute.begin(), isAbsolute.end(), false) > 0);
+}
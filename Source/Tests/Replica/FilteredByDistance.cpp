@@ -24,6 +24,7 @@
 #include "../NetworkUtils.h"
 #include "../SceneUtils.h"
 
+#include <Urho3D/Math/RandomEngine.h>
 #include <Urho3D/Network/Network.h>
 #include <Urho3D/Network/NetworkEvents.h>
 #include <Urho3D/Scene/PrefabResource.h>
@@ -31,6 +32,7 @@
 #include <Urho3D/Scene/SceneEvents.h>
 #include <Urho3D/Replica/BehaviorNetworkObject.h>
 #include <Urho3D/Replica/FilteredByDistance.h>
+#include <Urho3D/Replica/NetworkInterestIndex.h>
 #include <Urho3D/Replica/ReplicationManager.h>
 #include <Urho3D/Replica/ReplicatedTransform.h>
 
@@ -49,6 +51,21 @@ SharedPtr<PrefabResource> CreateFilteredTestPrefab(Context* context)
     return Tests::ConvertNodeToPrefab(node);
 }
 
+/// Network object that reports doubled distance to other objects when used as filtering origin.
+class ScaledDistanceNetworkObject : public BehaviorNetworkObject
+{
+    URHO3D_OBJECT(ScaledDistanceNetworkObject, BehaviorNetworkObject);
+
+public:
+    using BehaviorNetworkObject::BehaviorNetworkObject;
+
+    ea::optional<float> CalculateDistanceForFiltering(NetworkObject* otherNetworkObject) override
+    {
+        const auto distance = BaseClassName::CalculateDistanceForFiltering(otherNetworkObject);
+        return distance ? ea::make_optional(*distance * 2.0f) : ea::nullopt;
+    }
+};
+
 SharedPtr<PrefabResource> CreateUnfilteredTestPrefab(Context* context)
 {
     auto node = MakeShared<Node>(context);
@@ -162,3 +179,180 @@ TEST_CASE("FilteredByDistance handles object hierarchies")
         REQUIRE_FALSE(unfilteredChildNode);
     }
 }
+
+TEST_CASE("FilteredByDistance uses spatial index for connections with many owned objects")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    context->GetSubsystem<Network>()->SetUpdateFps(Tests::NetworkSimulator::FramesInSecond);
+
+    auto filteredPrefab = Tests::GetOrCreateResource<PrefabResource>(context, "@/FilteredByDistance/FilteredTest.prefab", CreateFilteredTestPrefab);
+
+    // Create scenes
+    auto serverScene = MakeShared<Scene>(context);
+    auto clientScene = MakeShared<Scene>(context);
+
+    const auto quality = Tests::ConnectionQuality{ 0.08f, 0.12f, 0.20f, 0.02f, 0.02f };
+    Tests::NetworkSimulator sim(serverScene);
+    sim.AddClient(clientScene, quality);
+    sim.SimulateTime(5.0f);
+
+    auto replicationManager = serverScene->GetComponent<ReplicationManager>();
+    replicationManager->SetParallelClientUpdate(true);
+    replicationManager->SetInterestCellSize(16.0f);
+
+    // Spawn many owned objects so the index has to use the grid
+    AbstractConnection* connection = sim.GetServerToClientConnection(clientScene);
+    for (unsigned i = 0; i < 50; ++i)
+    {
+        auto ownedNode = Tests::SpawnOnServer<BehaviorNetworkObject>(serverScene, filteredPrefab, Format("Owned Node {}", i));
+        ownedNode->GetComponent<BehaviorNetworkObject>()->SetOwner(connection);
+        ownedNode->SetWorldPosition(Vector3(i * 10.0f, 0.0f, 0.0f));
+    }
+
+    auto nearNode = Tests::SpawnOnServer<BehaviorNetworkObject>(serverScene, filteredPrefab, "Near Node");
+    nearNode->SetWorldPosition(Vector3(255.0f, 0.0f, 5.0f));
+
+    auto farNode = Tests::SpawnOnServer<BehaviorNetworkObject>(serverScene, filteredPrefab, "Far Node");
+    farNode->SetWorldPosition(Vector3(255.0f, 0.0f, -30.0f));
+
+    sim.SimulateTime(8.0f);
+
+    const NetworkInterestIndex& interestIndex = replicationManager->GetServerReplicator()->GetInterestIndex();
+    CHECK(interestIndex.GetNumOrigins(connection) == 50);
+    CHECK(interestIndex.GetDistanceToConnection(connection, nearNode->GetComponent<BehaviorNetworkObject>(), 10.0f)
+        == Catch::Approx(Sqrt(50.0f)));
+    CHECK(interestIndex.GetDistanceToConnection(connection, farNode->GetComponent<BehaviorNetworkObject>(), 10.0f)
+        == M_LARGE_VALUE);
+
+    CHECK(clientScene->GetChild("Owned Node 0", true));
+    CHECK(clientScene->GetChild("Owned Node 49", true));
+    CHECK(clientScene->GetChild("Near Node", true));
+    CHECK_FALSE(clientScene->GetChild("Far Node", true));
+
+    // Move far object close to the last owned object
+    serverScene->GetChild("Far Node", true)->SetWorldPosition(Vector3{490.0f, 0.0f, 2.0f});
+    sim.SimulateTime(8.0f);
+
+    CHECK(clientScene->GetChild("Far Node", true));
+}
+
+TEST_CASE("FilteredByDistance evaluates only objects close to connection origins")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    context->GetSubsystem<Network>()->SetUpdateFps(Tests::NetworkSimulator::FramesInSecond);
+    auto guard = Tests::MakeScopedReflection<ScaledDistanceNetworkObject>(context);
+
+    auto filteredPrefab = Tests::GetOrCreateResource<PrefabResource>(context, "@/FilteredByDistance/FilteredTest.prefab", CreateFilteredTestPrefab);
+    auto unfilteredPrefab = Tests::GetOrCreateResource<PrefabResource>(context, "@/FilteredByDistance/UnfilteredTest.prefab", CreateUnfilteredTestPrefab);
+
+    // Create scenes
+    auto serverScene = MakeShared<Scene>(context);
+    auto clientScene = MakeShared<Scene>(context);
+
+    const auto quality = Tests::ConnectionQuality{ 0.08f, 0.12f, 0.20f, 0.02f, 0.02f };
+    Tests::NetworkSimulator sim(serverScene);
+    sim.AddClient(clientScene, quality);
+    sim.SimulateTime(5.0f);
+
+    // Origin reports doubled distance, so the objects are filtered at half of the distance
+    AbstractConnection* connection = sim.GetServerToClientConnection(clientScene);
+    auto originNode = Tests::SpawnOnServer<ScaledDistanceNetworkObject>(serverScene, filteredPrefab, "Origin Node");
+    originNode->GetComponent<ScaledDistanceNetworkObject>()->SetOwner(connection);
+
+    auto nearNode = Tests::SpawnOnServer<BehaviorNetworkObject>(serverScene, filteredPrefab, "Near Node", {3.0f, 0.0f, 0.0f});
+    auto scaledNode = Tests::SpawnOnServer<BehaviorNetworkObject>(serverScene, filteredPrefab, "Scaled Node", {7.0f, 0.0f, 0.0f});
+    auto farNode = Tests::SpawnOnServer<BehaviorNetworkObject>(serverScene, filteredPrefab, "Far Node", {50.0f, 0.0f, 0.0f});
+    auto unfilteredNode = Tests::SpawnOnServer<BehaviorNetworkObject>(serverScene, unfilteredPrefab, "Unfiltered Node", {50.0f, 0.0f, 0.0f});
+
+    sim.SimulateTime(8.0f);
+
+    const auto getNetworkObject = [](Node* node) { return node->GetDerivedComponent<NetworkObject>(); };
+    auto replicationManager = serverScene->GetComponent<ReplicationManager>();
+    const NetworkInterestIndex& interestIndex = replicationManager->GetServerReplicator()->GetInterestIndex();
+
+    CHECK(interestIndex.GetDistanceToConnection(connection, getNetworkObject(nearNode), 10.0f) == Catch::Approx(6.0f));
+    CHECK(interestIndex.GetDistanceToConnection(connection, getNetworkObject(scaledNode), 10.0f) == M_LARGE_VALUE);
+    CHECK(interestIndex.GetDistanceToConnection(connection, getNetworkObject(scaledNode), 20.0f) == Catch::Approx(14.0f));
+
+    // Far filtered objects are not evaluated at all
+    ea::vector<unsigned> candidates;
+    interestIndex.CollectRelevanceCandidates(connection, candidates);
+    const auto isCandidate = [&](Node* node)
+    {
+        const unsigned index = DeconstructComponentReference(getNetworkObject(node)->GetNetworkId()).first;
+        return ea::find(candidates.begin(), candidates.end(), index) != candidates.end();
+    };
+    CHECK(isCandidate(originNode));
+    CHECK(isCandidate(nearNode));
+    CHECK(isCandidate(scaledNode));
+    CHECK(isCandidate(unfilteredNode));
+    CHECK_FALSE(isCandidate(farNode));
+
+    CHECK(clientScene->GetChild("Origin Node", true));
+    CHECK(clientScene->GetChild("Near Node", true));
+    CHECK_FALSE(clientScene->GetChild("Scaled Node", true));
+    CHECK_FALSE(clientScene->GetChild("Far Node", true));
+    CHECK(clientScene->GetChild("Unfiltered Node", true));
+
+    // Relevant object is removed when it moves away
+    nearNode->SetWorldPosition({30.0f, 0.0f, 0.0f});
+    sim.SimulateTime(8.0f);
+
+    CHECK_FALSE(clientScene->GetChild("Near Node", true));
+}
+
+TEST_CASE("ServerReplicator handles many clients and objects", "[.][benchmark]")
+{
+    static constexpr unsigned NumClients = 100;
+    static constexpr unsigned NumObjects = 20000;
+    static constexpr float WorldSize = 2000.0f;
+
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    context->GetSubsystem<Network>()->SetUpdateFps(Tests::NetworkSimulator::FramesInSecond);
+
+    auto filteredPrefab = Tests::GetOrCreateResource<PrefabResource>(context, "@/FilteredByDistance/FilteredTest.prefab", CreateFilteredTestPrefab);
+
+    for (const bool parallel : {false, true})
+    {
+        auto serverScene = MakeShared<Scene>(context);
+        ea::vector<SharedPtr<Scene>> clientScenes;
+
+        const auto quality = Tests::ConnectionQuality{ 0.08f, 0.12f, 0.20f, 0.02f, 0.02f };
+        Tests::NetworkSimulator sim(serverScene);
+        for (unsigned i = 0; i < NumClients; ++i)
+        {
+            clientScenes.push_back(MakeShared<Scene>(context));
+            sim.AddClient(clientScenes.back(), quality);
+        }
+        sim.SimulateTime(2.0f);
+
+        auto replicationManager = serverScene->GetComponent<ReplicationManager>();
+        replicationManager->SetParallelClientUpdate(parallel);
+
+        // Spawn one avatar per client and a lot of filtered objects
+        RandomEngine& re = sim.GetRandom();
+        ea::vector<Node*> nodes;
+        for (unsigned i = 0; i < NumClients; ++i)
+        {
+            auto node = Tests::SpawnOnServer<BehaviorNetworkObject>(serverScene, filteredPrefab, "Client Node");
+            node->GetComponent<BehaviorNetworkObject>()->SetOwner(sim.GetServerToClientConnection(clientScenes[i]));
+            node->SetWorldPosition(re.GetVector3(-Vector3::ONE * WorldSize * 0.5f, Vector3::ONE * WorldSize * 0.5f) * Vector3(1.0f, 0.0f, 1.0f));
+            nodes.push_back(node);
+        }
+        for (unsigned i = 0; i < NumObjects; ++i)
+        {
+            auto node = Tests::SpawnOnServer<BehaviorNetworkObject>(serverScene, filteredPrefab, "Object Node");
+            node->SetWorldPosition(re.GetVector3(-Vector3::ONE * WorldSize * 0.5f, Vector3::ONE * WorldSize * 0.5f) * Vector3(1.0f, 0.0f, 1.0f));
+            nodes.push_back(node);
+        }
+        sim.SimulateTime(1.0f);
+
+        BENCHMARK(parallel ? "Parallel" : "Sequential")
+        {
+            for (Node* node : nodes)
+                node->Translate(re.GetVector3(-Vector3::ONE, Vector3::ONE) * Vector3(1.0f, 0.0f, 1.0f), TS_WORLD);
+            sim.SimulateTime(1.0f / Tests::NetworkSimulator::FramesInSecond);
+            return nodes.size();
+        };
+    }
+}
@@ -22,13 +22,54 @@
 
 #include "../CommonUtils.h"
 
+#include <Urho3D/Core/CoreEvents.h>
+#include <Urho3D/Core/Timer.h>
+#include <Urho3D/Graphics/Texture2D.h>
+#include <Urho3D/IO/Deserializer.h>
 #include <Urho3D/IO/MountedExternalMemory.h>
 #include <Urho3D/IO/VirtualFileSystem.h>
+#include <Urho3D/Resource/BackgroundLoader.h>
+#include <Urho3D/Resource/BinaryFile.h>
 #include <Urho3D/Resource/ResourceCache.h>
+#include <Urho3D/RenderAPI/RenderDevice.h>
+#include <Urho3D/Resource/XMLFile.h>
 
 namespace Tests
 {
 
+namespace
+{
+
+/// Resource that can unload its data and restores it on use, like a texture.
+class UnloadableResource : public Resource
+{
+    URHO3D_OBJECT(UnloadableResource, Resource);
+
+public:
+    explicit UnloadableResource(Context* context) : Resource(context) {}
+
+    bool BeginLoad(Deserializer& source) override
+    {
+        SetMemoryUse(source.GetSize());
+        unloaded_ = false;
+        return true;
+    }
+
+    bool UnloadResidentData() override
+    {
+        SetMemoryUse(0);
+        unloaded_ = true;
+        return true;
+    }
+
+    bool IsResidentDataUnloaded() const override { return unloaded_; }
+
+private:
+    bool unloaded_{};
+};
+
+} // namespace
+
 TEST_CASE("ResourceCache loads resources from memory")
 {
     const auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
@@ -52,4 +93,189 @@ TEST_CASE("ResourceCache loads resources from memory")
     CHECK(xmlFile->GetRoot().GetName() == "something_else");
 }
 
+TEST_CASE("ResourceCache loads resources in background")
+{
+    const auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    const auto resourceCache = context->GetSubsystem<ResourceCache>();
+    auto mountPoint = MakeShared<MountedExternalMemory>(context, "memory");
+    const MountPointGuard mountPointGuard(mountPoint);
+
+    static constexpr unsigned NumFiles = 100;
+    for (unsigned i = 0; i < NumFiles; ++i)
+        mountPoint->LinkMemory(Format("background/{}.xml", i), Format("<file index=\"{}\"/>", i));
+
+    BackgroundLoader* backgroundLoader = resourceCache->GetBackgroundLoader();
+    REQUIRE(backgroundLoader);
+    const unsigned numLoadedBefore = backgroundLoader->GetTypeStats()[XMLFile::GetTypeStatic()].numResources_;
+
+    for (unsigned i = 0; i < NumFiles; ++i)
+        REQUIRE(resourceCache->BackgroundLoadResource<XMLFile>(Format("memory://background/{}.xml", i)));
+
+    for (unsigned i = 0; i < NumFiles; ++i)
+    {
+        auto xmlFile = resourceCache->GetResource<XMLFile>(Format("memory://background/{}.xml", i));
+        REQUIRE(xmlFile);
+        CHECK(xmlFile->GetRoot().GetUInt("index") == i);
+    }
+
+    CHECK(resourceCache->GetNumBackgroundLoadResources() == 0);
+    CHECK(backgroundLoader->GetNumPendingDecodeResources() == 0);
+    CHECK(backgroundLoader->GetTypeStats()[XMLFile::GetTypeStatic()].numResources_ == numLoadedBefore + NumFiles);
+
+    for (unsigned i = 0; i < NumFiles; ++i)
+        resourceCache->ReleaseResource<XMLFile>(Format("memory://background/{}.xml", i), true);
+}
+
+TEST_CASE("ResourceCache releases least recently used resources over memory budget")
+{
+    const auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    const auto resourceCache = context->GetSubsystem<ResourceCache>();
+    const auto time = context->GetSubsystem<Time>();
+    auto mountPoint = MakeShared<MountedExternalMemory>(context, "memory");
+    const MountPointGuard mountPointGuard(mountPoint);
+
+    const auto nextFrame = [&]
+    {
+        time->BeginFrame(0.01f);
+        time->EndFrame();
+    };
+    const auto getFileName = [](unsigned index) { return Format("memory://residency/{}.bin", index); };
+
+    static constexpr unsigned NumFiles = 4;
+    for (unsigned i = 0; i < NumFiles; ++i)
+        mountPoint->LinkMemory(Format("residency/{}.bin", i), ea::string(1000, 'x'));
+
+    // Don't count resources of other tests
+    resourceCache->ReleaseAllResources();
+    resourceCache->UpdateResidency();
+    const unsigned long long baseMemoryUse = resourceCache->GetResidencyStats().memoryUse_;
+
+    // First file is referenced, second file is used again after the others
+    SharedPtr<BinaryFile> referencedFile;
+    for (unsigned i = 0; i < NumFiles; ++i)
+    {
+        nextFrame();
+        auto file = resourceCache->GetResource<BinaryFile>(getFileName(i));
+        REQUIRE(file);
+        if (i == 0)
+            referencedFile = file;
+    }
+    nextFrame();
+    REQUIRE(resourceCache->GetResource<BinaryFile>(getFileName(1)));
+
+    const unsigned fileSize = referencedFile->GetMemoryUse();
+    REQUIRE(fileSize > 0);
+    resourceCache->SetGlobalMemoryBudget(baseMemoryUse + fileSize * 5 / 2);
+    nextFrame();
+
+    const ResourceResidencyStats& stats = resourceCache->GetResidencyStats();
+    CHECK(stats.numEvicted_ == 2);
+    CHECK(stats.numUnloaded_ == 0);
+    CHECK(stats.memoryUse_ == baseMemoryUse + fileSize * 2);
+    CHECK(resourceCache->GetExistingResource<BinaryFile>(getFileName(0)) == referencedFile);
+    CHECK(resourceCache->GetExistingResource<BinaryFile>(getFileName(1)));
+    CHECK_FALSE(resourceCache->GetExistingResource<BinaryFile>(getFileName(2)));
+    CHECK_FALSE(resourceCache->GetExistingResource<BinaryFile>(getFileName(3)));
+
+    resourceCache->SetGlobalMemoryBudget(0);
+    for (unsigned i = 0; i < NumFiles; ++i)
+        resourceCache->ReleaseResource<BinaryFile>(getFileName(i), true);
+}
+
+TEST_CASE("ResourceCache unloads referenced resources only when allowed")
+{
+    const auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    const auto guard = Tests::MakeScopedReflection<UnloadableResource>(context);
+    const auto resourceCache = context->GetSubsystem<ResourceCache>();
+    const auto time = context->GetSubsystem<Time>();
+    auto mountPoint = MakeShared<MountedExternalMemory>(context, "memory");
+    const MountPointGuard mountPointGuard(mountPoint);
+
+    const auto nextFrame = [&]
+    {
+        time->BeginFrame(0.01f);
+        time->EndFrame();
+    };
+
+    mountPoint->LinkMemory("residency/unloadable.bin", ea::string(1000, 'x'));
+    SharedPtr<UnloadableResource> resource{
+        resourceCache->GetResource<UnloadableResource>("memory://residency/unloadable.bin")};
+    REQUIRE(resource);
+    REQUIRE(resource->GetMemoryUse() == 1000);
+
+    // Neither per-type nor global budget affects referenced resources by default
+    resourceCache->SetMemoryBudget(UnloadableResource::GetTypeStatic(), 1);
+    resourceCache->SetGlobalMemoryBudget(1);
+    for (unsigned i = 0; i < 4; ++i)
+        nextFrame();
+    CHECK_FALSE(resource->IsResidentDataUnloaded());
+    CHECK(resourceCache->GetResidencyStats().numUnloaded_ == 0);
+
+    // Referenced resource is unloaded when unused for long enough
+    resourceCache->SetResidentDataUnloadFrames(2);
+    for (unsigned i = 0; i < 3 && !resource->IsResidentDataUnloaded(); ++i)
+        nextFrame();
+    REQUIRE(resource->IsResidentDataUnloaded());
+    CHECK(resource->GetMemoryUse() == 0);
+    CHECK(resourceCache->GetResidencyStats().numNonResident_ == 1);
+
+    // Resource is reloaded once it is used again
+    resourceCache->SetGlobalMemoryBudget(0);
+    REQUIRE(resourceCache->GetResource<UnloadableResource>("memory://residency/unloadable.bin") == resource);
+    nextFrame();
+    CHECK_FALSE(resource->IsResidentDataUnloaded());
+    CHECK(resource->GetMemoryUse() == 1000);
+    CHECK(resourceCache->GetResidencyStats().numReloaded_ == 1);
+    CHECK(resourceCache->GetResidencyStats().numNonResident_ == 0);
+
+    resourceCache->SetMemoryBudget(UnloadableResource::GetTypeStatic(), 0);
+    resourceCache->SetResidentDataUnloadFrames(0);
+    resource = nullptr;
+    resourceCache->ReleaseResource<UnloadableResource>("memory://residency/unloadable.bin", true);
+}
+
+TEST_CASE("ResourceCache restores unloaded texture on the next frame after it is bound")
+{
+    const auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    if (!context->GetSubsystem<RenderDevice>())
+    {
+        WARN("Texture unloading requires render device");
+        return;
+    }
+
+    const auto resourceCache = context->GetSubsystem<ResourceCache>();
+    const auto time = context->GetSubsystem<Time>();
+    const auto nextFrame = [&]
+    {
+        time->BeginFrame(0.01f);
+        time->EndFrame();
+    };
+
+    SharedPtr<Texture2D> texture{resourceCache->GetResource<Texture2D>("Textures/Ramp.png")};
+    REQUIRE(texture);
+    REQUIRE(texture->GetHandles());
+    const IntVector3 size = texture->GetParams().size_;
+
+    resourceCache->SetGlobalMemoryBudget(1);
+    resourceCache->SetResidentDataUnloadFrames(1);
+    for (unsigned i = 0; i < 3 && !texture->IsUnloaded(); ++i)
+        nextFrame();
+    resourceCache->SetGlobalMemoryBudget(0);
+    resourceCache->SetResidentDataUnloadFrames(0);
+
+    REQUIRE(texture->IsUnloaded());
+    CHECK_FALSE(texture->GetHandles());
+
+    // This is what DrawCommandQueue does when the texture is added as shader resource
+    texture->RequestRestoreIfUnloaded();
+    CHECK(texture->IsUnloaded());
+
+    // Texture is reloaded on the next frame
+    nextFrame();
+    CHECK_FALSE(texture->IsUnloaded());
+    CHECK(texture->GetHandles());
+    CHECK(texture->GetParams().size_ == size);
+    CHECK(texture->GetMemoryUse() > 0);
+}
+
 } // namespace Tests
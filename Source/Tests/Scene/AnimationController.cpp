@@ -521,6 +521,77 @@ TEST_CASE("Animation is filtered when start bone is specified")
     }
 }
 
+TEST_CASE("Node-less skeleton is animated the same way as skeleton with bone nodes")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+
+    auto model = Tests::GetOrCreateResource<Model>(context, "@Tests/AnimationController/SkinnedModel.mdl", CreateTestSkinnedModel);
+    auto animationTranslateX = Tests::GetOrCreateResource<Animation>(context, "@Tests/AnimationController/TranslateX.ani", CreateTestTranslateXAnimation);
+    auto animationRotate = Tests::GetOrCreateResource<Animation>(context, "@Tests/AnimationController/Rotation.ani", CreateTestRotationAnimation);
+
+    auto scene = MakeShared<Scene>(context);
+    scene->CreateComponent<Octree>();
+
+    for (bool nodelessSkeleton : {false, true})
+    {
+        auto node = scene->CreateChild(nodelessSkeleton ? "Nodeless" : "Reference");
+        node->SetPosition({1.0f, 0.0f, 2.0f});
+
+        auto animatedModel = node->CreateComponent<AnimatedModel>();
+        animatedModel->SetNodelessSkeleton(nodelessSkeleton);
+        animatedModel->SetModel(model);
+
+        auto animationController = node->CreateComponent<AnimationController>();
+        animationController->PlayNew(AnimationParameters{animationRotate}.Looped());
+        animationController->PlayNew(AnimationParameters{animationTranslateX}.Looped().Layer(1).Weight(0.5f));
+    }
+
+    // Bone nodes are created only on demand
+    {
+        Node* nodelessNode = scene->GetChild("Nodeless");
+        auto nodelessModel = nodelessNode->GetComponent<AnimatedModel>();
+        REQUIRE(nodelessNode->GetNumChildren() == 0);
+
+        Node* attachedNode = nodelessModel->GetOrCreateBoneNode("Quad 2");
+        REQUIRE(attachedNode);
+        REQUIRE(nodelessModel->GetOrCreateBoneNode("Quad 2") == attachedNode);
+        REQUIRE(nodelessNode->GetNumChildren() == 1);
+    }
+
+    const auto checkPose = [&]()
+    {
+        auto referenceModel = scene->GetChild("Reference")->GetComponent<AnimatedModel>();
+        auto nodelessModel = scene->GetChild("Nodeless")->GetComponent<AnimatedModel>();
+        Node* referenceBoneNode = scene->GetChild("Reference")->GetChild("Quad 2", true);
+        Node* attachedNode = scene->GetChild("Nodeless")->GetChild("Quad 2");
+
+        REQUIRE(attachedNode);
+        REQUIRE(attachedNode->GetWorldPosition().Equals(referenceBoneNode->GetWorldPosition(), M_LARGE_EPSILON));
+
+        referenceModel->UpdateGeometry(FrameInfo{});
+        nodelessModel->UpdateGeometry(FrameInfo{});
+
+        const auto& referenceSkinMatrices = referenceModel->GetSkinMatrices();
+        const auto& nodelessSkinMatrices = nodelessModel->GetSkinMatrices();
+        REQUIRE(referenceSkinMatrices.size() == nodelessSkinMatrices.size());
+        for (unsigned i = 0; i < referenceSkinMatrices.size(); ++i)
+            REQUIRE(nodelessSkinMatrices[i].Equals(referenceSkinMatrices[i], M_LARGE_EPSILON));
+    };
+
+    for (unsigned i = 0; i < 4; ++i)
+    {
+        Tests::RunFrame(context, 0.3f, 0.05f);
+        checkPose();
+    }
+
+    // Attached nodes are restored after loading
+    Tests::SerializeAndDeserializeScene(scene);
+    REQUIRE(scene->GetChild("Nodeless")->GetNumChildren() == 1);
+
+    Tests::RunFrame(context, 0.3f, 0.05f);
+    checkPose();
+}
+
 TEST_CASE("VariantCurve is sample with looping and without it")
 {
     VariantCurve curve;
@@ -0,0 +1,148 @@
+//
+// Copyright (c) 2017-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../CommonUtils.h"
+#include "../SceneUtils.h"
+
+#include <Urho3D/Scene/LogicComponent.h>
+#include <Urho3D/Scene/SceneEvents.h>
+#include <Urho3D/Scene/SceneUpdateGraph.h>
+
+namespace
+{
+
+class ScheduledTestComponent : public LogicComponent
+{
+    URHO3D_OBJECT(ScheduledTestComponent, LogicComponent);
+
+public:
+    explicit ScheduledTestComponent(Context* context)
+        : LogicComponent(context)
+    {
+        SetUpdateEventMask(USE_UPDATE | USE_POSTUPDATE);
+        SetScheduledUpdate(true);
+    }
+
+    void DeclareUpdateAccess(SceneUpdateAccess& access) const override
+    {
+        LogicComponent::DeclareUpdateAccess(access);
+        if (sharedResource_)
+            access.Write(sharedResource_);
+        if (exclusive_)
+            access.Exclusive();
+    }
+
+    void DelayedStart() override { ++numStarts_; }
+    void Update(float timeStep) override
+    {
+        ++numUpdates_;
+        node_->Translate(Vector3::RIGHT * timeStep);
+    }
+    void PostUpdate(float timeStep) override { ++numPostUpdates_; }
+
+    StringHash sharedResource_;
+    bool exclusive_{};
+
+    unsigned numStarts_{};
+    unsigned numUpdates_{};
+    unsigned numPostUpdates_{};
+};
+
+}
+
+TEST_CASE("Scheduled scene update executes components in parallel stages")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    auto guard = Tests::MakeScopedReflection<ScheduledTestComponent>(context);
+
+    auto scene = MakeShared<Scene>(context);
+    scene->SetScheduledUpdate(true);
+    SceneUpdateGraph* updateGraph = scene->GetUpdateGraph();
+
+    // Independent components on independent nodes
+    ea::vector<ScheduledTestComponent*> components;
+    for (unsigned i = 0; i < 100; ++i)
+        components.push_back(scene->CreateChild()->CreateComponent<ScheduledTestComponent>());
+
+    // Components in the same hierarchy
+    Node* parentNode = scene->CreateChild();
+    components.push_back(parentNode->CreateComponent<ScheduledTestComponent>());
+    components.push_back(parentNode->CreateChild()->CreateComponent<ScheduledTestComponent>());
+
+    REQUIRE(updateGraph->GetNumComponents(E_SCENEUPDATE) == 102);
+    REQUIRE(updateGraph->GetNumComponents(E_SCENEPOSTUPDATE) == 102);
+
+    Tests::RunFrame(context, 0.5f);
+
+    REQUIRE(updateGraph->GetNumStages(E_SCENEUPDATE) == 2);
+    for (ScheduledTestComponent* component : components)
+    {
+        REQUIRE(component->numStarts_ == 1);
+        REQUIRE(component->numUpdates_ == 1);
+        REQUIRE(component->numPostUpdates_ == 1);
+    }
+    REQUIRE(components[0]->GetNode()->GetWorldPosition().Equals(Vector3::RIGHT * 0.5f));
+    REQUIRE(components[101]->GetNode()->GetWorldPosition().Equals(Vector3::RIGHT * 1.0f));
+
+    // Shared resources are accessed by one component at a time
+    components[0]->sharedResource_ = "Resource";
+    components[1]->sharedResource_ = "Resource";
+    components[2]->sharedResource_ = "Resource";
+    updateGraph->MarkDirty();
+
+    Tests::RunFrame(context, 0.5f);
+
+    REQUIRE(updateGraph->GetNumStages(E_SCENEUPDATE) == 3);
+
+    // Exclusive component splits the graph
+    components[50]->exclusive_ = true;
+    updateGraph->MarkDirty();
+
+    Tests::RunFrame(context, 0.5f);
+
+    REQUIRE(updateGraph->GetNumStages(E_SCENEUPDATE) == 6);
+    for (ScheduledTestComponent* component : components)
+    {
+        REQUIRE(component->numStarts_ == 1);
+        REQUIRE(component->numUpdates_ == 3);
+        REQUIRE(component->numPostUpdates_ == 3);
+    }
+
+    // Disabled components are removed from the graph
+    components[0]->SetEnabled(false);
+    REQUIRE(updateGraph->GetNumComponents(E_SCENEUPDATE) == 101);
+
+    Tests::RunFrame(context, 0.5f);
+
+    REQUIRE(components[0]->numUpdates_ == 3);
+    REQUIRE(components[1]->numUpdates_ == 4);
+
+    // Components fall back to events when scheduled update is disabled
+    scene->SetScheduledUpdate(false);
+    REQUIRE(updateGraph->GetNumComponents(E_SCENEUPDATE) == 0);
+
+    Tests::RunFrame(context, 0.5f);
+
+    REQUIRE(components[0]->numUpdates_ == 3);
+    REQUIRE(components[1]->numUpdates_ == 5);
+    REQUIRE(components[1]->numPostUpdates_ == 5);
+}
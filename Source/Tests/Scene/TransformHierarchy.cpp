@@ -0,0 +1,167 @@
+//
+// Copyright (c) 2017-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../CommonUtils.h"
+
+#include <Urho3D/Scene/Scene.h>
+#include <Urho3D/Scene/TransformHierarchy.h>
+
+namespace
+{
+
+class DirtyListener : public Component
+{
+    URHO3D_OBJECT(DirtyListener, Component);
+
+public:
+    using Component::Component;
+
+    void OnNodeSet(Node* previousNode, Node* currentNode) override
+    {
+        if (currentNode)
+            currentNode->AddListener(this);
+    }
+
+    void OnMarkedDirty(Node* node) override
+    {
+        ++numNotifications_;
+        lastWorldPosition_ = node->GetWorldPosition();
+    }
+
+    unsigned numNotifications_{};
+    Vector3 lastWorldPosition_;
+};
+
+}
+
+TEST_CASE("Batched transform update matches lazy evaluation")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    auto guard = Tests::MakeScopedReflection<DirtyListener>(context);
+
+    auto scene = MakeShared<Scene>(context);
+    scene->SetBatchedTransformUpdate(true);
+    TransformHierarchy* hierarchy = scene->GetTransformHierarchy();
+
+    auto referenceScene = MakeShared<Scene>(context);
+
+    // Create the same chains of nodes in both scenes
+    ea::vector<Node*> nodes;
+    ea::vector<Node*> referenceNodes;
+    for (unsigned chainIndex = 0; chainIndex < 10; ++chainIndex)
+    {
+        Node* parent = scene;
+        Node* referenceParent = referenceScene;
+        for (unsigned depth = 0; depth < 8; ++depth)
+        {
+            const Vector3 position{1.0f, static_cast<float>(chainIndex), 0.5f};
+            const Quaternion rotation{10.0f * depth, Vector3::UP};
+
+            parent = parent->CreateChild();
+            parent->SetTransform(position, rotation);
+            nodes.push_back(parent);
+
+            referenceParent = referenceParent->CreateChild();
+            referenceParent->SetTransform(position, rotation);
+            referenceNodes.push_back(referenceParent);
+        }
+    }
+
+    // Nodes are attached on first update, nodes dirty before that are updated by the batch
+    REQUIRE_FALSE(hierarchy->IsAttached());
+    scene->UpdateTransforms();
+
+    REQUIRE(hierarchy->IsAttached());
+    REQUIRE(hierarchy->GetNumNodes() == 80);
+    REQUIRE(hierarchy->GetNumLevels() == 8);
+    REQUIRE(hierarchy->GetNumUpdatedNodes() == 80);
+    for (unsigned i = 0; i < nodes.size(); ++i)
+    {
+        REQUIRE_FALSE(nodes[i]->IsDirty());
+        REQUIRE(nodes[i]->GetWorldTransform().Equals(referenceNodes[i]->GetWorldTransform()));
+        REQUIRE(nodes[i]->GetWorldRotation().Equivalent(referenceNodes[i]->GetWorldRotation()));
+    }
+
+    // Listeners are notified by the batch, not when the node is marked dirty
+    auto listener = nodes[5]->CreateComponent<DirtyListener>();
+    nodes[3]->Translate(Vector3::FORWARD);
+    referenceNodes[3]->Translate(Vector3::FORWARD);
+
+    REQUIRE(listener->numNotifications_ == 0);
+    REQUIRE_FALSE(nodes[2]->IsDirty());
+    REQUIRE(nodes[3]->IsDirty());
+    REQUIRE(nodes[7]->IsDirty());
+
+    // Dirty nodes are evaluated on demand
+    REQUIRE(nodes[6]->GetWorldTransform().Equals(referenceNodes[6]->GetWorldTransform()));
+
+    // Only subtree of the moved node is updated
+    scene->UpdateTransforms();
+
+    REQUIRE(hierarchy->GetNumUpdatedNodes() == 5);
+    REQUIRE(listener->numNotifications_ == 1);
+    REQUIRE(listener->lastWorldPosition_.Equals(referenceNodes[5]->GetWorldPosition()));
+    for (unsigned i = 0; i < nodes.size(); ++i)
+    {
+        REQUIRE_FALSE(nodes[i]->IsDirty());
+        REQUIRE(nodes[i]->GetWorldTransform().Equals(referenceNodes[i]->GetWorldTransform()));
+    }
+
+    // Scene update commits transforms
+    nodes[12]->Rotate(Quaternion{30.0f, Vector3::RIGHT});
+    referenceNodes[12]->Rotate(Quaternion{30.0f, Vector3::RIGHT});
+    scene->Update(0.1f);
+
+    REQUIRE_FALSE(nodes[15]->IsDirty());
+    for (unsigned i = 0; i < nodes.size(); ++i)
+        REQUIRE(nodes[i]->GetWorldTransform().Equals(referenceNodes[i]->GetWorldTransform()));
+
+    // Reparenting detaches nodes until next update
+    nodes[20]->SetParent(nodes[7]);
+    referenceNodes[20]->SetParent(referenceNodes[7]);
+
+    REQUIRE_FALSE(hierarchy->IsAttached());
+    for (unsigned i = 0; i < nodes.size(); ++i)
+        REQUIRE(nodes[i]->GetWorldTransform().Equals(referenceNodes[i]->GetWorldTransform()));
+
+    scene->UpdateTransforms();
+
+    REQUIRE(hierarchy->IsAttached());
+    REQUIRE(hierarchy->GetNumNodes() == 80);
+    REQUIRE(hierarchy->GetNumLevels() == 12);
+    for (unsigned i = 0; i < nodes.size(); ++i)
+        REQUIRE(nodes[i]->GetWorldTransform().Equals(referenceNodes[i]->GetWorldTransform()));
+
+    // Nothing is updated if nothing is dirty
+    scene->UpdateTransforms();
+    REQUIRE(hierarchy->GetNumUpdatedNodes() == 0);
+
+    // Pending changes are committed when batched update is disabled
+    nodes[0]->Translate(Vector3::UP);
+    referenceNodes[0]->Translate(Vector3::UP);
+    const unsigned numNotifications = listener->numNotifications_;
+    scene->SetBatchedTransformUpdate(false);
+
+    REQUIRE(listener->numNotifications_ == numNotifications + 1);
+    for (unsigned i = 0; i < nodes.size(); ++i)
+        REQUIRE(nodes[i]->GetWorldTransform().Equals(referenceNodes[i]->GetWorldTransform()));
+}
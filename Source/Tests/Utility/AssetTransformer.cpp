@@ -22,6 +22,8 @@
 
 #include "../CommonUtils.h"
 
+#include <Urho3D/IO/File.h>
+#include <Urho3D/Utility/AssetCookingStore.h>
 #include <Urho3D/Utility/AssetTransformerHierarchy.h>
 
 namespace
@@ -33,10 +35,12 @@ class TestAssetTransformer : public AssetTransformer
 
 public:
     bool singleInstanced_{};
+    unsigned version_{};
 
     using AssetTransformer::AssetTransformer;
 
     bool IsSingleInstanced() override { return singleInstanced_; }
+    unsigned GetVersion() const override { return version_; }
 };
 
 class TestAssetTransformerA : public AssetTransformer
@@ -221,3 +225,89 @@ TEST_CASE("Asset transformer sorts by type")
     REQUIRE(getTransformerCandidates("foo/bar", "platform=*") == TestVector{t0, t4, t2});
     REQUIRE(getTransformerCandidates("foo/bar", "platform=mobile") == TestVector{t0, t4, t2});
 }
+
+TEST_CASE("Asset cooking store restores outputs by content")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    auto fs = context->GetSubsystem<FileSystem>();
+
+    const TemporaryDir tempDir{context, fs->GetTemporaryDir() + "AssetCookingStoreTest/"};
+    const ea::string dataPath = tempDir.GetPath() + "Data/";
+    const ea::string cachePath = tempDir.GetPath() + "Cache/";
+
+    const auto writeFile = [&](const ea::string& fileName, const ea::string& content)
+    {
+        fs->CreateDirsRecursive(GetPath(fileName));
+        File file(context, fileName, FILE_WRITE);
+        file.Write(content.data(), content.length());
+    };
+    const auto readFile = [&](const ea::string& fileName)
+    {
+        File file(context, fileName);
+        ea::string content(file.GetSize(), '\0');
+        file.Read(content.data(), content.length());
+        return content;
+    };
+
+    writeFile(dataPath + "Models/Box.gltf", "box");
+    writeFile(dataPath + "Models/Box.bin", "buffer");
+    writeFile(cachePath + "Models/Box.gltf.d/Box.mdl", "model");
+
+    auto store = MakeShared<AssetCookingStore>(context);
+    store->SetStorePath(tempDir.GetPath() + "Store");
+
+    const auto transformer = MakeShared<TestAssetTransformer>(context);
+    const TestVector transformers{transformer};
+    const AssetTransformerInput input{ApplicationFlavor::Empty, "Models/Box.gltf", dataPath + "Models/Box.gltf", 1};
+
+    AssetTransformerOutput output;
+    output.outputResourceNames_ = {"Models/Box.gltf.d/Box.mdl"};
+    output.appliedTransformers_ = {TestAssetTransformer::GetTypeNameStatic()};
+    output.dependencyModificationTimes_["Models/Box.bin"] = 1;
+
+    const ea::string key = store->GetCookingKey(input, transformers);
+    REQUIRE(key.length() == 16);
+    REQUIRE(store->Store(key, input, output, cachePath));
+
+    // Modification time doesn't affect the key
+    const AssetTransformerInput touchedInput{input.flavor_, input.resourceName_, input.inputFileName_, 2};
+    REQUIRE(store->GetCookingKey(touchedInput, transformers) == key);
+
+    // Outputs are restored into clean cache
+    fs->RemoveDir(cachePath, true);
+    const auto restoredOutput = store->Restore(key, input, cachePath);
+    REQUIRE(restoredOutput);
+    REQUIRE(restoredOutput->outputResourceNames_ == output.outputResourceNames_);
+    REQUIRE(restoredOutput->appliedTransformers_ == output.appliedTransformers_);
+    REQUIRE(restoredOutput->dependencyModificationTimes_.contains("Models/Box.bin"));
+    REQUIRE(readFile(cachePath + "Models/Box.gltf.d/Box.mdl") == "model");
+
+    // Transformer version, flavor and source content are part of the key
+    transformer->version_ = 1;
+    REQUIRE(store->GetCookingKey(input, transformers) != key);
+    transformer->version_ = 0;
+
+    const AssetTransformerInput mobileInput{
+        ApplicationFlavor{"platform=mobile"}, input.resourceName_, input.inputFileName_, 1};
+    REQUIRE(store->GetCookingKey(mobileInput, transformers) != key);
+
+    writeFile(dataPath + "Models/Box.gltf", "modified box");
+    REQUIRE(store->GetCookingKey(input, transformers) != key);
+    writeFile(dataPath + "Models/Box.gltf", "box");
+    REQUIRE(store->GetCookingKey(input, transformers) == key);
+
+    // Modified dependency invalidates stored entry
+    writeFile(dataPath + "Models/Box.bin", "modified buffer");
+    REQUIRE_FALSE(store->Restore(key, input, cachePath));
+
+    // Stale entry is replaced when the asset is cooked again
+    writeFile(cachePath + "Models/Box.gltf.d/Box.mdl", "modified model");
+    REQUIRE(store->Store(key, input, output, cachePath));
+
+    fs->RemoveDir(cachePath, true);
+    REQUIRE(store->Restore(key, input, cachePath));
+    REQUIRE(readFile(cachePath + "Models/Box.gltf.d/Box.mdl") == "modified model");
+
+    // Key may be calculated in two steps
+    REQUIRE(store->GetCookingKey(input, store->GetTransformersHash(transformers)) == key);
+}
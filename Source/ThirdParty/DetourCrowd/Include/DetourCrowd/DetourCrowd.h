@@ -204,6 +204,15 @@ struct dtCrowdAgentDebugInfo
 /// Type for the update callback.
 typedef void (*dtUpdateCallback)(bool positionUpdate, dtCrowdAgent* agent, float* pos, float dt);
 
+// Urho3D: Add parallel update support
+/// Type for the function that processes the active agents [begin, end) in the thread with the specified index.
+typedef void (*dtCrowdRangeFunc)(void* data, int begin, int end, int threadIndex);
+
+/// Type for the parallel dispatcher. The dispatcher must call @p func for subranges covering [0, count)
+/// and return when all the calls are finished. Concurrent calls must have different thread indices
+/// less than the number of threads passed to dtCrowd::setParallelFor().
+typedef void (*dtCrowdParallelFor)(void* userData, int count, dtCrowdRangeFunc func, void* data);
+
 /// Provides local steering behaviors for a group of agents. 
 /// @ingroup crowd
 class dtCrowd
@@ -234,6 +243,21 @@ class dtCrowd
 
 	dtNavMeshQuery* m_navquery;
 
+	// Urho3D: Add parallel update support
+	dtCrowdParallelFor m_parallelFor;
+	void* m_parallelForUserData;
+	int m_maxThreads;
+	dtObstacleAvoidanceQuery** m_threadObstacleQueries;
+	int* m_threadVelocitySampleCounts;
+
+	void parallelFor(const int count, dtCrowdRangeFunc func, void* data);
+	static void updateNeighboursRange(void* data, int begin, int end, int threadIndex);
+	static void updateCornersRange(void* data, int begin, int end, int threadIndex);
+	static void updateVelocityPlanningRange(void* data, int begin, int end, int threadIndex);
+	static void integrateRange(void* data, int begin, int end, int threadIndex);
+	static void updateCollisionsRange(void* data, int begin, int end, int threadIndex);
+	void purgeThreadData();
+
 	void updateTopologyOptimization(dtCrowdAgent** agents, const int nagents, const float dt);
 	void updateMoveRequest(const float dt);
 	void checkPathValidity(dtCrowdAgent** agents, const int nagents, const float dt);
@@ -255,6 +279,16 @@ public:
 	///  @param[in]		nav				The navigation mesh to use for planning.
 	/// @return True if the initialization succeeded.
 	bool init(const int maxAgents, const float maxAgentRadius, dtNavMesh* nav, dtUpdateCallback cb = 0);
+
+	// Urho3D: Add parallel update support
+	/// Sets the dispatcher used to run independent per-agent update steps in parallel.
+	/// Neighbour queries, corner search, velocity planning, integration and collision resolution
+	/// are dispatched. The results are the same as for the serial update. Must be called after #init().
+	///  @param[in]		parallelFor		The dispatcher, or null to update serially.
+	///  @param[in]		userData		The user data passed to the dispatcher.
+	///  @param[in]		maxThreads		The number of threads used by the dispatcher. [Limit: >= 1]
+	/// @return True if the per-thread data was allocated.
+	bool setParallelFor(dtCrowdParallelFor parallelFor, void* userData, const int maxThreads);
 	
 	/// Sets the shared avoidance configuration for the specified index.
 	///  @param[in]		idx		The index. [Limits: 0 <= value < #DT_CROWD_MAX_OBSTAVOIDANCE_PARAMS]
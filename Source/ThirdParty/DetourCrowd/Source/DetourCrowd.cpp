@@ -343,7 +343,12 @@ dtCrowd::dtCrowd() :
 	m_maxPathResult(0),
 	m_maxAgentRadius(0),
 	m_velocitySampleCount(0),
-	m_navquery(0)
+	m_navquery(0),
+	m_parallelFor(0), // Urho3D: Add parallel update support
+	m_parallelForUserData(0),
+	m_maxThreads(1),
+	m_threadObstacleQueries(0),
+	m_threadVelocitySampleCounts(0)
 {
 	// Urho3D: initialize all class members
 	memset(&m_agentPlacementHalfExtents, 0, sizeof(m_agentPlacementHalfExtents));
@@ -357,6 +362,8 @@ dtCrowd::~dtCrowd()
 
 void dtCrowd::purge()
 {
+	purgeThreadData(); // Urho3D
+
 	for (int i = 0; i < m_maxAgents; ++i)
 		m_agents[i].~dtCrowdAgent();
 	dtFree(m_agents);
@@ -382,6 +389,23 @@ void dtCrowd::purge()
 	m_navquery = 0;
 }
 
+// Urho3D: Add parallel update support
+void dtCrowd::purgeThreadData()
+{
+	// Thread 0 uses the shared obstacle query
+	for (int i = 1; i < m_maxThreads && m_threadObstacleQueries; ++i)
+		dtFreeObstacleAvoidanceQuery(m_threadObstacleQueries[i]);
+	dtFree(m_threadObstacleQueries);
+	m_threadObstacleQueries = 0;
+
+	dtFree(m_threadVelocitySampleCounts);
+	m_threadVelocitySampleCounts = 0;
+
+	m_parallelFor = 0;
+	m_parallelForUserData = 0;
+	m_maxThreads = 1;
+}
+
 // Urho3D: Add update callback support
 /// @par
 ///
@@ -470,6 +494,56 @@ bool dtCrowd::init(const int maxAgents, const float maxAgentRadius, dtNavMesh* n
 	return true;
 }
 
+// Urho3D: Add parallel update support
+/// @par
+///
+/// Each thread except the calling one gets its own obstacle avoidance query.
+/// Path requests, boundary updates, steering and movement along the navigation mesh
+/// use the shared navigation mesh query and the update callback, so they are always serial.
+bool dtCrowd::setParallelFor(dtCrowdParallelFor parallelFor, void* userData, const int maxThreads)
+{
+	purgeThreadData();
+
+	if (!parallelFor || maxThreads <= 1)
+		return true;
+
+	m_threadObstacleQueries = (dtObstacleAvoidanceQuery**)dtAlloc(sizeof(dtObstacleAvoidanceQuery*)*maxThreads, DT_ALLOC_PERM);
+	if (!m_threadObstacleQueries)
+		return false;
+	memset(m_threadObstacleQueries, 0, sizeof(dtObstacleAvoidanceQuery*)*maxThreads);
+	m_maxThreads = maxThreads;
+
+	for (int i = 1; i < maxThreads; ++i)
+	{
+		m_threadObstacleQueries[i] = dtAllocObstacleAvoidanceQuery();
+		if (!m_threadObstacleQueries[i] || !m_threadObstacleQueries[i]->init(6, 8))
+		{
+			purgeThreadData();
+			return false;
+		}
+	}
+
+	m_threadVelocitySampleCounts = (int*)dtAlloc(sizeof(int)*maxThreads, DT_ALLOC_PERM);
+	if (!m_threadVelocitySampleCounts)
+	{
+		purgeThreadData();
+		return false;
+	}
+	memset(m_threadVelocitySampleCounts, 0, sizeof(int)*maxThreads);
+
+	m_parallelFor = parallelFor;
+	m_parallelForUserData = userData;
+	return true;
+}
+
+void dtCrowd::parallelFor(const int count, dtCrowdRangeFunc func, void* data)
+{
+	if (m_parallelFor && count > 1)
+		m_parallelFor(m_parallelForUserData, count, func, data);
+	else
+		func(data, 0, count, 0);
+}
+
 void dtCrowd::setObstacleAvoidanceParams(const int idx, const dtObstacleAvoidanceParams* params)
 {
 	if (idx >= 0 && idx < DT_CROWD_MAX_OBSTAVOIDANCE_PARAMS)
@@ -1055,6 +1129,220 @@ void dtCrowd::checkPathValidity(dtCrowdAgent** agents, const int nagents, const
 	}
 }
 	
+// Urho3D: Add parallel update support
+struct dtCrowdUpdateContext
+{
+	dtCrowd* crowd;
+	dtCrowdAgent** agents;
+	int nagents;
+	float dt;
+	int debugIdx;
+	dtCrowdAgentDebugInfo* debug;
+};
+
+void dtCrowd::updateNeighboursRange(void* data, int begin, int end, int /*threadIndex*/)
+{
+	const dtCrowdUpdateContext* ctx = (const dtCrowdUpdateContext*)data;
+	const dtCrowd* crowd = ctx->crowd;
+	for (int i = begin; i < end; ++i)
+	{
+		dtCrowdAgent* ag = ctx->agents[i];
+		if (ag->state != DT_CROWDAGENT_STATE_WALKING)
+			continue;
+
+		// Query neighbour agents
+		ag->nneis = getNeighbours(ag->npos, ag->params.height, ag->params.collisionQueryRange,
+								  ag, ag->neis, DT_CROWDAGENT_MAX_NEIGHBOURS,
+								  ctx->agents, ctx->nagents, crowd->m_grid);
+		for (int j = 0; j < ag->nneis; j++)
+			ag->neis[j].idx = crowd->getAgentIndex(ctx->agents[ag->neis[j].idx]);
+	}
+}
+
+void dtCrowd::updateCornersRange(void* data, int begin, int end, int /*threadIndex*/)
+{
+	const dtCrowdUpdateContext* ctx = (const dtCrowdUpdateContext*)data;
+	const dtCrowd* crowd = ctx->crowd;
+	for (int i = begin; i < end; ++i)
+	{
+		dtCrowdAgent* ag = ctx->agents[i];
+		
+		if (ag->state != DT_CROWDAGENT_STATE_WALKING)
+			continue;
+		if (ag->targetState == DT_CROWDAGENT_TARGET_NONE || ag->targetState == DT_CROWDAGENT_TARGET_VELOCITY)
+			continue;
+		
+		// Find corners for steering
+		ag->ncorners = ag->corridor.findCorners(ag->cornerVerts, ag->cornerFlags, ag->cornerPolys,
+												DT_CROWDAGENT_MAX_CORNERS, crowd->m_navquery, &crowd->m_filters[ag->params.queryFilterType]);
+		
+		// Check to see if the corner after the next corner is directly visible,
+		// and short cut to there.
+		if ((ag->params.updateFlags & DT_CROWD_OPTIMIZE_VIS) && ag->ncorners > 0)
+		{
+			const float* target = &ag->cornerVerts[dtMin(1,ag->ncorners-1)*3];
+			ag->corridor.optimizePathVisibility(target, ag->params.pathOptimizationRange, crowd->m_navquery, &crowd->m_filters[ag->params.queryFilterType]);
+			
+			// Copy data for debug purposes.
+			if (ctx->debugIdx == i)
+			{
+				dtVcopy(ctx->debug->optStart, ag->corridor.getPos());
+				dtVcopy(ctx->debug->optEnd, target);
+			}
+		}
+		else
+		{
+			// Copy data for debug purposes.
+			if (ctx->debugIdx == i)
+			{
+				dtVset(ctx->debug->optStart, 0,0,0);
+				dtVset(ctx->debug->optEnd, 0,0,0);
+			}
+		}
+	}
+}
+
+void dtCrowd::updateVelocityPlanningRange(void* data, int begin, int end, int threadIndex)
+{
+	const dtCrowdUpdateContext* ctx = (const dtCrowdUpdateContext*)data;
+	dtCrowd* crowd = ctx->crowd;
+
+	// Thread 0 is never run concurrently with itself, it uses the shared obstacle query
+	dtObstacleAvoidanceQuery* obstacleQuery = threadIndex > 0 ? crowd->m_threadObstacleQueries[threadIndex] : crowd->m_obstacleQuery;
+	int* velocitySampleCount = threadIndex > 0 ? &crowd->m_threadVelocitySampleCounts[threadIndex] : &crowd->m_velocitySampleCount;
+
+	for (int i = begin; i < end; ++i)
+	{
+		dtCrowdAgent* ag = ctx->agents[i];
+		
+		if (ag->state != DT_CROWDAGENT_STATE_WALKING)
+			continue;
+		
+		if (ag->params.updateFlags & DT_CROWD_OBSTACLE_AVOIDANCE)
+		{
+			obstacleQuery->reset();
+			
+			// Add neighbours as obstacles.
+			for (int j = 0; j < ag->nneis; ++j)
+			{
+				const dtCrowdAgent* nei = &crowd->m_agents[ag->neis[j].idx];
+				obstacleQuery->addCircle(nei->npos, nei->params.radius, nei->vel, nei->dvel);
+			}
+
+			// Append neighbour segments as obstacles.
+			for (int j = 0; j < ag->boundary.getSegmentCount(); ++j)
+			{
+				const float* s = ag->boundary.getSegment(j);
+				if (dtTriArea2D(ag->npos, s, s+3) < 0.0f)
+					continue;
+				obstacleQuery->addSegment(s, s+3);
+			}
+
+			dtObstacleAvoidanceDebugData* vod = 0;
+			if (ctx->debugIdx == i) 
+				vod = ctx->debug->vod;
+			
+			// Sample new safe velocity.
+			bool adaptive = true;
+			int ns = 0;
+
+			const dtObstacleAvoidanceParams* params = &crowd->m_obstacleQueryParams[ag->params.obstacleAvoidanceType];
+				
+			if (adaptive)
+			{
+				ns = obstacleQuery->sampleVelocityAdaptive(ag->npos, ag->params.radius, ag->desiredSpeed,
+														   ag->vel, ag->dvel, ag->nvel, params, vod);
+			}
+			else
+			{
+				ns = obstacleQuery->sampleVelocityGrid(ag->npos, ag->params.radius, ag->desiredSpeed,
+													   ag->vel, ag->dvel, ag->nvel, params, vod);
+			}
+			*velocitySampleCount += ns;
+		}
+		else
+		{
+			// If not using velocity planning, new velocity is directly the desired velocity.
+			dtVcopy(ag->nvel, ag->dvel);
+		}
+	}
+}
+
+void dtCrowd::integrateRange(void* data, int begin, int end, int /*threadIndex*/)
+{
+	const dtCrowdUpdateContext* ctx = (const dtCrowdUpdateContext*)data;
+	for (int i = begin; i < end; ++i)
+	{
+		dtCrowdAgent* ag = ctx->agents[i];
+		if (ag->state != DT_CROWDAGENT_STATE_WALKING)
+			continue;
+		integrate(ag, ctx->dt);
+	}
+}
+
+void dtCrowd::updateCollisionsRange(void* data, int begin, int end, int /*threadIndex*/)
+{
+	static const float COLLISION_RESOLVE_FACTOR = 0.7f;
+
+	const dtCrowdUpdateContext* ctx = (const dtCrowdUpdateContext*)data;
+	const dtCrowd* crowd = ctx->crowd;
+	for (int i = begin; i < end; ++i)
+	{
+		dtCrowdAgent* ag = ctx->agents[i];
+		const int idx0 = crowd->getAgentIndex(ag);
+		
+		if (ag->state != DT_CROWDAGENT_STATE_WALKING)
+			continue;
+
+		dtVset(ag->disp, 0,0,0);
+		
+		float w = 0;
+
+		for (int j = 0; j < ag->nneis; ++j)
+		{
+			const dtCrowdAgent* nei = &crowd->m_agents[ag->neis[j].idx];
+			const int idx1 = crowd->getAgentIndex(nei);
+
+			float diff[3];
+			dtVsub(diff, ag->npos, nei->npos);
+			diff[1] = 0;
+			
+			float dist = dtVlenSqr(diff);
+			if (dist > dtSqr(ag->params.radius + nei->params.radius))
+				continue;
+			dist = dtMathSqrtf(dist);
+			float pen = (ag->params.radius + nei->params.radius) - dist;
+			if (dist < 0.0001f)
+			{
+				// Agents on top of each other, try to choose diverging separation directions.
+				if (idx0 > idx1)
+					dtVset(diff, -ag->dvel[2],0,ag->dvel[0]);
+				else
+					dtVset(diff, ag->dvel[2],0,-ag->dvel[0]);
+				pen = 0.01f;
+			}
+			else
+			{
+				pen = (1.0f/dist) * (pen*0.5f) * COLLISION_RESOLVE_FACTOR;
+			}
+			
+			// Urho3D: Avoid tremble when another agent can not move away
+			if (ag->params.separationWeight < 0.0001f)
+				continue;
+			
+			dtVmad(ag->disp, ag->disp, diff, pen);			
+			
+			w += 1.0f;
+		}
+		
+		if (w > 0.0001f)
+		{
+			const float iw = 1.0f / w;
+			dtVscale(ag->disp, ag->disp, iw);
+		}
+	}
+}
+
 void dtCrowd::update(const float dt, dtCrowdAgentDebugInfo* debug)
 {
 	m_velocitySampleCount = 0;
@@ -1083,7 +1371,17 @@ void dtCrowd::update(const float dt, dtCrowdAgentDebugInfo* debug)
 		m_grid->addItem((unsigned short)i, p[0]-r, p[2]-r, p[0]+r, p[2]+r);
 	}
 	
+	// Urho3D: Add parallel update support
+	dtCrowdUpdateContext ctx;
+	ctx.crowd = this;
+	ctx.agents = agents;
+	ctx.nagents = nagents;
+	ctx.dt = dt;
+	ctx.debugIdx = debugIdx;
+	ctx.debug = debug;
+
 	// Get nearby navmesh segments and agents to collide with.
+	// Urho3D: Boundary update uses the node pool of the shared query, so it stays serial
 	for (int i = 0; i < nagents; ++i)
 	{
 		dtCrowdAgent* ag = agents[i];
@@ -1099,52 +1397,11 @@ void dtCrowd::update(const float dt, dtCrowdAgentDebugInfo* debug)
 			ag->boundary.update(ag->corridor.getFirstPoly(), ag->npos, ag->params.collisionQueryRange,
 								m_navquery, &m_filters[ag->params.queryFilterType]);
 		}
-		// Query neighbour agents
-		ag->nneis = getNeighbours(ag->npos, ag->params.height, ag->params.collisionQueryRange,
-								  ag, ag->neis, DT_CROWDAGENT_MAX_NEIGHBOURS,
-								  agents, nagents, m_grid);
-		for (int j = 0; j < ag->nneis; j++)
-			ag->neis[j].idx = getAgentIndex(agents[ag->neis[j].idx]);
 	}
+	parallelFor(nagents, updateNeighboursRange, &ctx);
 	
 	// Find next corner to steer to.
-	for (int i = 0; i < nagents; ++i)
-	{
-		dtCrowdAgent* ag = agents[i];
-		
-		if (ag->state != DT_CROWDAGENT_STATE_WALKING)
-			continue;
-		if (ag->targetState == DT_CROWDAGENT_TARGET_NONE || ag->targetState == DT_CROWDAGENT_TARGET_VELOCITY)
-			continue;
-		
-		// Find corners for steering
-		ag->ncorners = ag->corridor.findCorners(ag->cornerVerts, ag->cornerFlags, ag->cornerPolys,
-												DT_CROWDAGENT_MAX_CORNERS, m_navquery, &m_filters[ag->params.queryFilterType]);
-		
-		// Check to see if the corner after the next corner is directly visible,
-		// and short cut to there.
-		if ((ag->params.updateFlags & DT_CROWD_OPTIMIZE_VIS) && ag->ncorners > 0)
-		{
-			const float* target = &ag->cornerVerts[dtMin(1,ag->ncorners-1)*3];
-			ag->corridor.optimizePathVisibility(target, ag->params.pathOptimizationRange, m_navquery, &m_filters[ag->params.queryFilterType]);
-			
-			// Copy data for debug purposes.
-			if (debugIdx == i)
-			{
-				dtVcopy(debug->optStart, ag->corridor.getPos());
-				dtVcopy(debug->optEnd, target);
-			}
-		}
-		else
-		{
-			// Copy data for debug purposes.
-			if (debugIdx == i)
-			{
-				dtVset(debug->optStart, 0,0,0);
-				dtVset(debug->optEnd, 0,0,0);
-			}
-		}
-	}
+	parallelFor(nagents, updateCornersRange, &ctx);
 	
 	// Trigger off-mesh connections (depends on corners).
 	for (int i = 0; i < nagents; ++i)
@@ -1271,131 +1528,19 @@ void dtCrowd::update(const float dt, dtCrowdAgentDebugInfo* debug)
 	}
 	
 	// Velocity planning.	
-	for (int i = 0; i < nagents; ++i)
-	{
-		dtCrowdAgent* ag = agents[i];
-		
-		if (ag->state != DT_CROWDAGENT_STATE_WALKING)
-			continue;
-		
-		if (ag->params.updateFlags & DT_CROWD_OBSTACLE_AVOIDANCE)
-		{
-			m_obstacleQuery->reset();
-			
-			// Add neighbours as obstacles.
-			for (int j = 0; j < ag->nneis; ++j)
-			{
-				const dtCrowdAgent* nei = &m_agents[ag->neis[j].idx];
-				m_obstacleQuery->addCircle(nei->npos, nei->params.radius, nei->vel, nei->dvel);
-			}
-
-			// Append neighbour segments as obstacles.
-			for (int j = 0; j < ag->boundary.getSegmentCount(); ++j)
-			{
-				const float* s = ag->boundary.getSegment(j);
-				if (dtTriArea2D(ag->npos, s, s+3) < 0.0f)
-					continue;
-				m_obstacleQuery->addSegment(s, s+3);
-			}
-
-			dtObstacleAvoidanceDebugData* vod = 0;
-			if (debugIdx == i) 
-				vod = debug->vod;
-			
-			// Sample new safe velocity.
-			bool adaptive = true;
-			int ns = 0;
-
-			const dtObstacleAvoidanceParams* params = &m_obstacleQueryParams[ag->params.obstacleAvoidanceType];
-				
-			if (adaptive)
-			{
-				ns = m_obstacleQuery->sampleVelocityAdaptive(ag->npos, ag->params.radius, ag->desiredSpeed,
-															 ag->vel, ag->dvel, ag->nvel, params, vod);
-			}
-			else
-			{
-				ns = m_obstacleQuery->sampleVelocityGrid(ag->npos, ag->params.radius, ag->desiredSpeed,
-														 ag->vel, ag->dvel, ag->nvel, params, vod);
-			}
-			m_velocitySampleCount += ns;
-		}
-		else
-		{
-			// If not using velocity planning, new velocity is directly the desired velocity.
-			dtVcopy(ag->nvel, ag->dvel);
-		}
-	}
+	for (int i = 1; i < m_maxThreads; ++i)
+		m_threadVelocitySampleCounts[i] = 0;
+	parallelFor(nagents, updateVelocityPlanningRange, &ctx);
+	for (int i = 1; i < m_maxThreads; ++i)
+		m_velocitySampleCount += m_threadVelocitySampleCounts[i];
 
 	// Integrate.
-	for (int i = 0; i < nagents; ++i)
-	{
-		dtCrowdAgent* ag = agents[i];
-		if (ag->state != DT_CROWDAGENT_STATE_WALKING)
-			continue;
-		integrate(ag, dt);
-	}
+	parallelFor(nagents, integrateRange, &ctx);
 	
 	// Handle collisions.
-	static const float COLLISION_RESOLVE_FACTOR = 0.7f;
-	
 	for (int iter = 0; iter < 4; ++iter)
 	{
-		for (int i = 0; i < nagents; ++i)
-		{
-			dtCrowdAgent* ag = agents[i];
-			const int idx0 = getAgentIndex(ag);
-			
-			if (ag->state != DT_CROWDAGENT_STATE_WALKING)
-				continue;
-
-			dtVset(ag->disp, 0,0,0);
-			
-			float w = 0;
-
-			for (int j = 0; j < ag->nneis; ++j)
-			{
-				const dtCrowdAgent* nei = &m_agents[ag->neis[j].idx];
-				const int idx1 = getAgentIndex(nei);
-
-				float diff[3];
-				dtVsub(diff, ag->npos, nei->npos);
-				diff[1] = 0;
-				
-				float dist = dtVlenSqr(diff);
-				if (dist > dtSqr(ag->params.radius + nei->params.radius))
-					continue;
-				dist = dtMathSqrtf(dist);
-				float pen = (ag->params.radius + nei->params.radius) - dist;
-				if (dist < 0.0001f)
-				{
-					// Agents on top of each other, try to choose diverging separation directions.
-					if (idx0 > idx1)
-						dtVset(diff, -ag->dvel[2],0,ag->dvel[0]);
-					else
-						dtVset(diff, ag->dvel[2],0,-ag->dvel[0]);
-					pen = 0.01f;
-				}
-				else
-				{
-					pen = (1.0f/dist) * (pen*0.5f) * COLLISION_RESOLVE_FACTOR;
-				}
-				
-				// Urho3D: Avoid tremble when another agent can not move away
-				if (ag->params.separationWeight < 0.0001f)
-					continue;
-				
-				dtVmad(ag->disp, ag->disp, diff, pen);			
-				
-				w += 1.0f;
-			}
-			
-			if (w > 0.0001f)
-			{
-				const float iw = 1.0f / w;
-				dtVscale(ag->disp, ag->disp, iw);
-			}
-		}
+		parallelFor(nagents, updateCollisionsRange, &ctx);
 		
 		for (int i = 0; i < nagents; ++i)
 		{
@@ -0,0 +1,137 @@
+//
+// Copyright (c) 2017-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include <Urho3D/Core/Context.h>
+#include <Urho3D/Core/Format.h>
+#include <Urho3D/Core/ProcessUtils.h>
+#include <Urho3D/Engine/Engine.h>
+#include <Urho3D/Graphics/Animation.h>
+#include <Urho3D/IO/File.h>
+#include <Urho3D/IO/FileSystem.h>
+
+#ifdef WIN32
+#include <windows.h>
+#endif
+
+#include <Urho3D/DebugNew.h>
+
+using namespace Urho3D;
+
+static const char* usage =
+    "Usage: AnimationCompressor <input files> [options]\n"
+    "\n"
+    "Compresses skeletal animation tracks and prints size and max error for each clip.\n"
+    "\n"
+    "Options:\n"
+    "-p <tolerance>  Max position error, default is 0.001\n"
+    "-r <tolerance>  Max rotation error in degrees, default is 0.05\n"
+    "-s <tolerance>  Max scale error, default is 0.001\n"
+    "-o <path>       Save compressed animations to directory, report only if not specified\n";
+
+int main(int argc, char** argv);
+void Run(const ea::vector<ea::string>& arguments);
+
+int main(int argc, char** argv)
+{
+    ea::vector<ea::string> arguments;
+
+    #ifdef WIN32
+    arguments = ParseArguments(GetCommandLineW());
+    #else
+    arguments = ParseArguments(argc, argv);
+    #endif
+
+    Run(arguments);
+    return 0;
+}
+
+void PrintStats(const ea::string& name, const AnimationCompressionStats& stats)
+{
+    const double ratio = stats.compressedSize_ ? static_cast<double>(stats.originalSize_) / stats.compressedSize_ : 0.0;
+    PrintLine(Format("{}\tkeyframes: {} -> {}\tsize: {} -> {} bytes\tratio: {:.2f}\t"
+        "max error: position {:.6f}, rotation {:.4f} deg, scale {:.6f}",
+        name, stats.originalKeyFrames_, stats.compressedKeyFrames_, stats.originalSize_, stats.compressedSize_, ratio,
+        stats.maxPositionError_, stats.maxRotationError_, stats.maxScaleError_));
+}
+
+void Run(const ea::vector<ea::string>& arguments)
+{
+    AnimationCompressionSettings settings;
+    ea::string outputPath;
+    ea::vector<ea::string> inputFileNames;
+
+    for (unsigned i = 0; i < arguments.size(); ++i)
+    {
+        const ea::string& argument = arguments[i];
+        const bool hasValue = i + 1 < arguments.size();
+        if (argument == "-p" && hasValue)
+            settings.positionTolerance_ = ToFloat(arguments[++i]);
+        else if (argument == "-r" && hasValue)
+            settings.rotationTolerance_ = ToFloat(arguments[++i]);
+        else if (argument == "-s" && hasValue)
+            settings.scaleTolerance_ = ToFloat(arguments[++i]);
+        else if (argument == "-o" && hasValue)
+            outputPath = AddTrailingSlash(arguments[++i]);
+        else if (!argument.starts_with("-"))
+            inputFileNames.push_back(argument);
+        else
+            ErrorExit(usage);
+    }
+
+    if (inputFileNames.empty())
+        ErrorExit(usage);
+
+    auto context = MakeShared<Context>();
+    // Engine is not initialized, only subsystems required to load and save resources are used
+    auto engine = MakeShared<Engine>(context);
+    auto fs = context->GetSubsystem<FileSystem>();
+
+    if (!outputPath.empty() && !fs->CreateDirsRecursive(outputPath))
+        ErrorExit("Cannot create output directory " + outputPath);
+
+    AnimationCompressionStats totalStats;
+    for (const ea::string& inputFileName : inputFileNames)
+    {
+        auto animation = MakeShared<Animation>(context);
+        File inputFile(context, inputFileName);
+        if (!inputFile.IsOpen() || !animation->Load(inputFile))
+        {
+            PrintLine("Cannot load " + inputFileName, true);
+            continue;
+        }
+
+        const AnimationCompressionStats stats = animation->CompressTracks(settings);
+        PrintStats(GetFileNameAndExtension(inputFileName), stats);
+        totalStats.Merge(stats);
+
+        if (!outputPath.empty())
+        {
+            const ea::string outputFileName = outputPath + GetFileNameAndExtension(inputFileName);
+            File outputFile(context, outputFileName, FILE_WRITE);
+            if (!outputFile.IsOpen() || !animation->Save(outputFile))
+                ErrorExit("Cannot write " + outputFileName);
+        }
+    }
+
+    if (inputFileNames.size() > 1)
+        PrintStats("Total", totalStats);
+}
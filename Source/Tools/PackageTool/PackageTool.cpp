@@ -24,8 +24,11 @@
 
 #include <Urho3D/Core/Context.h>
 #include <Urho3D/Core/ProcessUtils.h>
+#include <Urho3D/Core/Timer.h>
+#include <Urho3D/IO/Compression.h>
 #include <Urho3D/IO/File.h>
 #include <Urho3D/IO/FileSystem.h>
+#include <Urho3D/IO/PackageBuilder.h>
 #include <Urho3D/IO/PackageFile.h>
 
 #ifdef WIN32
@@ -42,6 +45,10 @@
 using namespace Urho3D;
 
 static const unsigned COMPRESSED_BLOCK_SIZE = 32768;
+static const unsigned ZSTD_BLOCK_SIZE = 65536;
+static const int ZSTD_COMPRESSION_LEVEL = 19;
+static const unsigned ZSTD_DICTIONARY_SIZE = 112640;
+static const unsigned ZSTD_MAX_DICTIONARY_SAMPLES_SIZE = 100 * ZSTD_DICTIONARY_SIZE;
 
 struct FileEntry
 {
@@ -49,6 +56,21 @@ struct FileEntry
     unsigned offset_{};
     unsigned size_{};
     unsigned checksum_{};
+    ea::vector<unsigned> blockSizes_;
+};
+
+struct CompressionStats
+{
+    unsigned long long unpackedSize_{};
+    unsigned long long packedSize_{};
+    long long decodeTime_{};
+
+    void Print(const ea::string& name) const
+    {
+        const double ratio = packedSize_ ? static_cast<double>(unpackedSize_) / packedSize_ : 0.0;
+        const double throughput = decodeTime_ ? static_cast<double>(unpackedSize_) / decodeTime_ : 0.0;
+        PrintLine(ea::string{}.sprintf("%s\tratio: %f\tdecode: %.1f MB/s", name.c_str(), ratio, throughput));
+    }
 };
 
 Context* context_ = nullptr;
@@ -57,6 +79,8 @@ ea::string basePath_;
 ea::vector<FileEntry> entries_;
 unsigned checksum_ = 0;
 bool compress_ = false;
+bool compressZstd_ = false;
+bool trainDictionary_ = false;
 bool quiet_ = false;
 unsigned blockSize_ = COMPRESSED_BLOCK_SIZE;
 
@@ -70,6 +94,8 @@ void Run(const ea::vector<ea::string>& arguments);
 void ProcessFile(const ea::string& fileName, const ea::string& rootDir);
 void WritePackageFile(const ea::string& fileName, const ea::string& rootDir);
 void WriteHeader(File& dest);
+ByteVector TrainDictionary(const ea::string& rootDir);
+void WriteZstdPackageFile(const ea::string& fileName, const ea::string& rootDir);
 
 int main(int argc, char** argv)
 {
@@ -97,6 +123,8 @@ void Run(const ea::vector<ea::string>& arguments)
             "\n"
             "Options:\n"
             "-c      Enable package file LZ4 compression\n"
+            "-z      Enable package file Zstd compression with seekable blocks, compare with LZ4\n"
+            "-d      Train Zstd dictionary on package contents (used with -z)\n"
             "-q      Enable quiet mode\n"
             "\n"
             "Basepath is an optional prefix that will be added to the file entries.\n\n"
@@ -125,6 +153,12 @@ void Run(const ea::vector<ea::string>& arguments)
                     case 'c':
                         compress_ = true;
                         break;
+                    case 'z':
+                        compressZstd_ = true;
+                        break;
+                    case 'd':
+                        trainDictionary_ = true;
+                        break;
                     case 'q':
                         quiet_ = true;
                         break;
@@ -192,7 +226,10 @@ void Run(const ea::vector<ea::string>& arguments)
         for (unsigned i = 0; i < fileNames.size(); ++i)
             ProcessFile(fileNames[i], dirName);
 
-        WritePackageFile(packageName, dirName);
+        if (compressZstd_)
+            WriteZstdPackageFile(packageName, dirName);
+        else
+            WritePackageFile(packageName, dirName);
     }
     else
     {
@@ -206,6 +243,12 @@ void Run(const ea::vector<ea::string>& arguments)
             PrintLine("Package size: " + ea::to_string(packageFile->GetTotalSize()));
             PrintLine("Checksum: " + ea::to_string(packageFile->GetChecksum()));
             PrintLine("Compressed: " + ea::string(packageFile->IsCompressed() ? "yes" : "no"));
+            if (packageFile->GetCompression() == PackageCompression::Zstd)
+            {
+                PrintLine("Block size: " + ea::to_string(packageFile->GetBlockSize()));
+                const ZstdDictionary* dictionary = packageFile->GetDictionary();
+                PrintLine("Dictionary size: " + ea::to_string(dictionary ? dictionary->GetData().size() : 0));
+            }
             break;
         case 'L':
             if (!packageFile->IsCompressed())
@@ -221,9 +264,16 @@ void Run(const ea::vector<ea::string>& arguments)
                     ea::string fileEntry(current->first);
                     if (outputCompressionRatio)
                     {
-                        unsigned compressedSize =
-                            (i == entries.end() ? packageFile->GetTotalSize() - sizeof(unsigned) : i->second.offset_) -
-                            current->second.offset_;
+                        const PackageEntry& entry = current->second;
+                        unsigned compressedSize = 0;
+                        if (!entry.blockOffsets_.empty())
+                            compressedSize = entry.blockOffsets_.back() - entry.offset_;
+                        else
+                        {
+                            compressedSize =
+                                (i == entries.end() ? packageFile->GetTotalSize() - sizeof(unsigned) : i->second.offset_) -
+                                entry.offset_;
+                        }
                         fileEntry.append_sprintf("\tin: %u\tout: %u\tratio: %f", current->second.size_, compressedSize,
                             compressedSize ? 1.f * current->second.size_ / compressedSize : 0.f);
                     }
@@ -375,3 +425,158 @@ void WriteHeader(File& dest)
     dest.WriteUInt(entries_.size());
     dest.WriteUInt(checksum_);
 }
+
+ByteVector TrainDictionary(const ea::string& rootDir)
+{
+    if (!quiet_)
+        PrintLine("Training dictionary");
+
+    // Blocks are compressed independently, so every block is a separate sample
+    ByteVector samples;
+    ea::vector<unsigned> sampleSizes;
+    for (const FileEntry& entry : entries_)
+    {
+        if (samples.size() >= ZSTD_MAX_DICTIONARY_SAMPLES_SIZE)
+            break;
+
+        File srcFile(context_, rootDir + "/" + entry.name_);
+        if (!srcFile.IsOpen())
+            continue;
+
+        const unsigned sampleSize = Min(entry.size_, ZSTD_BLOCK_SIZE);
+        if (sampleSize == 0)
+            continue;
+
+        const unsigned oldSize = samples.size();
+        samples.resize(oldSize + sampleSize);
+        if (srcFile.Read(&samples[oldSize], sampleSize) != sampleSize)
+        {
+            samples.resize(oldSize);
+            continue;
+        }
+        sampleSizes.push_back(sampleSize);
+    }
+
+    ByteVector dictionary = TrainZstdDictionary(samples, sampleSizes, ZSTD_DICTIONARY_SIZE);
+    if (!quiet_)
+        PrintLine("Dictionary size: " + ea::to_string(dictionary.size()));
+    return dictionary;
+}
+
+void WriteZstdPackageFile(const ea::string& fileName, const ea::string& rootDir)
+{
+    const ByteVector dictionary = trainDictionary_ ? TrainDictionary(rootDir) : ByteVector{};
+
+    if (!quiet_)
+        PrintLine("Writing package");
+
+    auto builder = MakeShared<PackageBuilder>(context_);
+    if (!builder->Create(fileName, ZSTD_BLOCK_SIZE, ZSTD_COMPRESSION_LEVEL, dictionary))
+        ErrorExit("Could not open output file " + fileName);
+
+    ByteVector lz4CompressBuffer(LZ4_compressBound(ZSTD_BLOCK_SIZE));
+    ByteVector decompressBuffer(ZSTD_BLOCK_SIZE);
+
+    CompressionStats zstdStats;
+    CompressionStats lz4Stats;
+    HiresTimer timer;
+
+    for (const FileEntry& entry : entries_)
+    {
+        const ea::string fileFullPath = rootDir + "/" + entry.name_;
+
+        File srcFile(context_, fileFullPath);
+        if (!srcFile.IsOpen())
+            ErrorExit("Could not open file " + fileFullPath);
+
+        const unsigned dataSize = entry.size_;
+        ByteVector buffer(dataSize);
+        if (dataSize && srcFile.Read(buffer.data(), dataSize) != dataSize)
+            ErrorExit("Could not read file " + fileFullPath);
+        srcFile.Close();
+
+        const unsigned long long packedSizeBefore = builder->GetTotalPackedSize();
+        if (!builder->Append(basePath_ + entry.name_, buffer))
+            ErrorExit("Could not write file " + entry.name_);
+        const auto totalPackedBytes = static_cast<unsigned>(builder->GetTotalPackedSize() - packedSizeBefore);
+
+        zstdStats.unpackedSize_ += dataSize;
+        zstdStats.packedSize_ += totalPackedBytes;
+
+        // Compress the same blocks with LZ4 for comparison
+        for (unsigned pos = 0; pos < dataSize; pos += ZSTD_BLOCK_SIZE)
+        {
+            const unsigned unpackedSize = Min(ZSTD_BLOCK_SIZE, dataSize - pos);
+            const unsigned char* blockData = &buffer[pos];
+
+            const auto lz4PackedSize = (unsigned)LZ4_compress_HC((const char*)blockData, (char*)lz4CompressBuffer.data(),
+                unpackedSize, lz4CompressBuffer.size(), 0);
+            if (!lz4PackedSize)
+                ErrorExit("LZ4 compression failed for file " + entry.name_ + " at offset " + ea::to_string(pos));
+
+            timer.Reset();
+            LZ4_decompress_safe((const char*)lz4CompressBuffer.data(), (char*)decompressBuffer.data(), lz4PackedSize, unpackedSize);
+            lz4Stats.decodeTime_ += timer.GetUSec(false);
+            lz4Stats.unpackedSize_ += unpackedSize;
+            lz4Stats.packedSize_ += lz4PackedSize;
+        }
+
+        if (!quiet_)
+        {
+            ea::string fileEntry(entry.name_);
+            fileEntry.append_sprintf("\tin: %u\tout: %u\tratio: %f", dataSize, totalPackedBytes,
+                totalPackedBytes ? 1.f * dataSize / totalPackedBytes : 0.f);
+            PrintLine(fileEntry);
+        }
+    }
+
+    const unsigned numFiles = builder->GetNumFiles();
+    const unsigned long long totalDataSize = builder->GetTotalDataSize();
+    checksum_ = builder->GetChecksum();
+    if (!builder->Build())
+        ErrorExit("Could not write package " + fileName);
+
+    if (!quiet_)
+    {
+        // Decode blocks of the package from memory on one thread, the same way as LZ4 blocks are decoded above
+        auto packageFile = MakeShared<PackageFile>(context_, fileName);
+        File packageData(context_, fileName);
+        ZstdDecompressor decompressor(packageFile->GetDictionary());
+        ByteVector packedData;
+        for (const ea::string& entryName : packageFile->GetEntryNames())
+        {
+            const PackageEntry* entry = packageFile->GetEntry(entryName);
+            const ea::vector<unsigned>& blockOffsets = entry->blockOffsets_;
+            if (blockOffsets.size() < 2)
+                continue;
+
+            packedData.resize(blockOffsets.back() - blockOffsets.front());
+            packageData.Seek(blockOffsets.front());
+            if (packageData.Read(packedData.data(), packedData.size()) != packedData.size())
+                ErrorExit("Could not read package " + fileName);
+
+            for (unsigned blockIndex = 0; blockIndex + 1 < blockOffsets.size(); ++blockIndex)
+            {
+                const unsigned unpackedSize = Min(ZSTD_BLOCK_SIZE, entry->size_ - blockIndex * ZSTD_BLOCK_SIZE);
+                const unsigned packedSize = blockOffsets[blockIndex + 1] - blockOffsets[blockIndex];
+                const unsigned char* blockData = &packedData[blockOffsets[blockIndex] - blockOffsets.front()];
+
+                timer.Reset();
+                // Incompressible blocks are stored as is
+                if (packedSize == unpackedSize)
+                    memcpy(decompressBuffer.data(), blockData, unpackedSize);
+                else if (!decompressor.Decompress(decompressBuffer.data(), unpackedSize, blockData, packedSize))
+                    ErrorExit("Zstd decompression failed for file " + entryName);
+                zstdStats.decodeTime_ += timer.GetUSec(false);
+            }
+        }
+
+        PrintLine("Number of files: " + ea::to_string(numFiles));
+        PrintLine("File data size: " + ea::to_string(totalDataSize));
+        PrintLine("Package size: " + ea::to_string(packageFile->GetTotalSize()));
+        PrintLine("Checksum: " + ea::to_string(checksum_));
+        PrintLine("Compressed: yes");
+        zstdStats.Print("Zstd");
+        lz4Stats.Print("LZ4");
+    }
+}
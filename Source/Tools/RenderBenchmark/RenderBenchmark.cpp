@@ -0,0 +1,507 @@
+//
+// Copyright (c) 2017-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include <Urho3D/Core/Context.h>
+#include <Urho3D/Core/ProcessUtils.h>
+#include <Urho3D/Core/Timer.h>
+#include <Urho3D/Core/WorkQueue.h>
+#include <Urho3D/Engine/Engine.h>
+#include <Urho3D/Engine/EngineDefs.h>
+#include <Urho3D/Graphics/Camera.h>
+#include <Urho3D/Graphics/Graphics.h>
+#include <Urho3D/Graphics/Light.h>
+#include <Urho3D/Graphics/Material.h>
+#include <Urho3D/Graphics/Model.h>
+#include <Urho3D/Graphics/Octree.h>
+#include <Urho3D/Graphics/Renderer.h>
+#include <Urho3D/Graphics/StaticModel.h>
+#include <Urho3D/Graphics/Viewport.h>
+#include <Urho3D/IO/FileSystem.h>
+#include <Urho3D/Math/RandomEngine.h>
+#include <Urho3D/RenderAPI/PipelineState.h>
+#include <Urho3D/RenderPipeline/DrawableProcessor.h>
+#include <Urho3D/RenderPipeline/InstancingBuffer.h>
+#include <Urho3D/RenderPipeline/LightProcessor.h>
+#include <Urho3D/RenderPipeline/RenderPipelineDebugger.h>
+#include <Urho3D/RenderPipeline/SceneProcessor.h>
+#include <Urho3D/RenderPipeline/ScenePass.h>
+#include <Urho3D/RenderPipeline/ShadowMapAllocator.h>
+#include <Urho3D/Resource/JSONFile.h>
+#include <Urho3D/Resource/ResourceCache.h>
+#include <Urho3D/Scene/Scene.h>
+
+#ifdef WIN32
+#include <windows.h>
+#endif
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// DebugNew.h is not included because global allocation functions are replaced to count allocations.
+
+using namespace Urho3D;
+
+#if defined(URHO3D_STATIC) || !defined(_WIN32)
+/// Number of allocations done via global operator new.
+/// EASTL allocator of static Urho3D calls global operator new via Urho3D allocation hooks,
+/// and EASTL allocator of shared Urho3D calls global operator new directly.
+/// Replacement of global operator new in the executable also applies to shared libraries everywhere but on Windows.
+static std::atomic<unsigned long long> numAllocations{0};
+
+void* operator new(std::size_t size)
+{
+    numAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size ? size : 1))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+static const bool allocationsCounted = true;
+static unsigned long long GetNumAllocations() { return numAllocations.load(std::memory_order_relaxed); }
+#else
+static const bool allocationsCounted = false;
+static unsigned long long GetNumAllocations() { return 0; }
+#endif
+
+namespace
+{
+
+/// CPU stages of scene rendering, in execution order.
+enum BenchmarkStage
+{
+    STAGE_UPDATE_SCENE,
+    STAGE_PROCESS_SCENE,
+    STAGE_UPDATE_GEOMETRIES,
+    STAGE_FILL_INSTANCING_BUFFER,
+    MAX_BENCHMARK_STAGES
+};
+
+static const char* stageNames[MAX_BENCHMARK_STAGES] = {
+    "UpdateScene",
+    "ProcessScene",
+    "UpdateGeometries",
+    "FillInstancingBuffer",
+};
+
+/// Number of distinct materials in the scene.
+static const unsigned NUM_MATERIALS = 32;
+/// Fraction of drawables moved every frame.
+static const float MOVING_FRACTION = 0.1f;
+/// Size of the benchmark viewport.
+static const IntVector2 VIEWPORT_SIZE{1920, 1080};
+
+/// Accumulated statistics of the stage.
+struct StageStats
+{
+    long long totalUSec_{};
+    unsigned long long numAllocations_{};
+};
+
+/// Synthetic scene with boxes, point lights and shadowed directional light,
+/// processed by the same SceneProcessor that is used by default render pipeline.
+/// Nothing is rendered, only CPU stages are executed.
+class BenchmarkRenderPipeline : public Object, public RenderPipelineInterface
+{
+    URHO3D_OBJECT(BenchmarkRenderPipeline, Object);
+
+public:
+    BenchmarkRenderPipeline(Context* context, unsigned numDrawables, unsigned numLights, SpatialIndexType spatialIndex);
+
+    /// Implement RenderPipelineInterface.
+    /// @{
+    Context* GetContext() const override { return Object::GetContext(); }
+    RenderPipelineDebugger* GetDebugger() override { return &debugger_; }
+    bool IsLinearColorSpace() const override { return false; }
+    /// @}
+
+    /// Run all stages of one frame.
+    void RunFrame(StageStats (&stats)[MAX_BENCHMARK_STAGES]);
+
+    /// Return number of visible geometries in the last frame.
+    unsigned GetNumVisibleDrawables() const { return sceneProcessor_->GetDrawableProcessor()->GetGeometries().Size(); }
+    /// Return number of scene batches in the last frame.
+    unsigned GetNumBatches() const;
+    /// Return number of shadow splits in the last frame.
+    unsigned GetNumShadowSplits() const;
+    /// Return number of shadow batches in the last frame.
+    unsigned GetNumShadowBatches() const;
+
+private:
+    void UpdateScene();
+    void ProcessScene();
+    void UpdateGeometries();
+    void FillInstancingBuffer();
+
+    WorkQueue* workQueue_{};
+    RandomEngine random_{0};
+
+    SharedPtr<Scene> scene_;
+    Octree* octree_{};
+    Camera* camera_{};
+    ea::vector<Node*> drawableNodes_;
+    FrameInfo sceneFrameInfo_;
+
+    RenderPipelineDebugger debugger_;
+    RenderPipelineSettings settings_;
+    SharedPtr<Viewport> viewport_;
+    CommonFrameInfo frameInfo_;
+    SharedPtr<ShadowMapAllocator> shadowMapAllocator_;
+    SharedPtr<InstancingBuffer> instancingBuffer_;
+    SharedPtr<SceneProcessor> sceneProcessor_;
+    SharedPtr<UnorderedScenePass> opaquePass_;
+    SharedPtr<BackToFrontScenePass> alphaPass_;
+};
+
+BenchmarkRenderPipeline::BenchmarkRenderPipeline(
+    Context* context, unsigned numDrawables, unsigned numLights, SpatialIndexType spatialIndex)
+    : Object(context)
+    , workQueue_(context->GetSubsystem<WorkQueue>())
+    , scene_(MakeShared<Scene>(context))
+{
+    auto cache = context_->GetSubsystem<ResourceCache>();
+    auto model = cache->GetResource<Model>("Models/Box.mdl");
+    auto material = cache->GetResource<Material>("Materials/DefaultGrey.xml");
+    if (!model || !material)
+        ErrorExit("Cannot load Models/Box.mdl or Materials/DefaultGrey.xml, check resource paths");
+
+    // Keep density of the scene constant
+    const float size = Sqrt(static_cast<float>(numDrawables)) * 3.0f;
+    const BoundingBox sceneBox{Vector3(-size, 0.0f, -size), Vector3(size, 10.0f, size)};
+
+    octree_ = scene_->CreateComponent<Octree>();
+    octree_->SetSize(sceneBox, 8);
+    octree_->SetSpatialIndexType(spatialIndex);
+
+    Node* cameraNode = scene_->CreateChild("Camera");
+    cameraNode->SetPosition({0.0f, 30.0f, -size});
+    cameraNode->LookAt(Vector3::ZERO);
+    camera_ = cameraNode->CreateComponent<Camera>();
+    camera_->SetFarClip(size * 2.0f);
+    camera_->SetAspectRatio(static_cast<float>(VIEWPORT_SIZE.x_) / VIEWPORT_SIZE.y_);
+
+    // Materials are cloned so batches cannot be merged across materials
+    ea::vector<SharedPtr<Material>> materials;
+    for (unsigned i = 0; i < NUM_MATERIALS; ++i)
+        materials.push_back(material->Clone());
+
+    for (unsigned i = 0; i < numDrawables; ++i)
+    {
+        Node* node = scene_->CreateChild();
+        node->SetPosition(random_.GetVector3(sceneBox));
+        node->SetRotation(random_.GetQuaternion());
+        auto staticModel = node->CreateComponent<StaticModel>();
+        staticModel->SetModel(model);
+        staticModel->SetMaterial(materials[random_.GetUInt(NUM_MATERIALS)]);
+        staticModel->SetCastShadows(true);
+        drawableNodes_.push_back(node);
+    }
+
+    for (unsigned i = 0; i < numLights; ++i)
+    {
+        Node* node = scene_->CreateChild();
+        node->SetPosition(random_.GetVector3(sceneBox));
+        auto light = node->CreateComponent<Light>();
+        light->SetLightType(LIGHT_POINT);
+        light->SetRange(20.0f);
+    }
+
+    // Directional light covers the whole scene with all shadow cascades
+    Node* sunNode = scene_->CreateChild("Sun");
+    sunNode->SetDirection({0.3f, -1.0f, 0.5f});
+    auto sun = sunNode->CreateComponent<Light>();
+    sun->SetLightType(LIGHT_DIRECTIONAL);
+    sun->SetCastShadows(true);
+    sun->SetShadowCascade(CascadeParameters(size * 0.1f, size * 0.3f, size * 0.8f, size * 2.0f, 0.8f));
+
+    sceneFrameInfo_.camera_ = camera_;
+    sceneFrameInfo_.timeStep_ = 1.0f / 60.0f;
+    sceneFrameInfo_.viewSize_ = VIEWPORT_SIZE;
+    sceneFrameInfo_.viewRect_ = {IntVector2::ZERO, VIEWPORT_SIZE};
+
+    // Initial update inserts all drawables into the octree
+    octree_->Update(sceneFrameInfo_);
+
+    // Set up scene processor the same way as default render pipeline does for forward lighting
+    settings_.instancingBuffer_.enableInstancing_ = true;
+    settings_.Validate();
+    settings_.AdjustToSupported(context_);
+
+    viewport_ = MakeShared<Viewport>(context_, scene_, camera_, IntRect{IntVector2::ZERO, VIEWPORT_SIZE});
+    frameInfo_.viewport_ = viewport_;
+    frameInfo_.viewportRect_ = viewport_->GetRect();
+    frameInfo_.viewportSize_ = frameInfo_.viewportRect_.Size();
+    frameInfo_.timeStep_ = sceneFrameInfo_.timeStep_;
+
+    shadowMapAllocator_ = MakeShared<ShadowMapAllocator>(context_);
+    instancingBuffer_ = MakeShared<InstancingBuffer>(context_);
+    sceneProcessor_ = MakeShared<SceneProcessor>(this, "shadow", shadowMapAllocator_, instancingBuffer_);
+
+    opaquePass_ = sceneProcessor_->CreatePass<UnorderedScenePass>(
+        DrawableProcessorPassFlag::HasAmbientLighting, "", "base", "litbase", "light");
+    alphaPass_ = sceneProcessor_->CreatePass<BackToFrontScenePass>(
+        DrawableProcessorPassFlag::HasAmbientLighting | DrawableProcessorPassFlag::NeedReadableDepth
+            | DrawableProcessorPassFlag::RefractionPass | DrawableProcessorPassFlag::ReadOnlyDepth,
+        "", "alpha", "alpha", "litalpha");
+
+    sceneProcessor_->SetSettings(settings_);
+    instancingBuffer_->SetSettings(settings_.instancingBuffer_);
+    shadowMapAllocator_->SetSettings(settings_.shadowMapAllocator_);
+    sceneProcessor_->SetPasses({opaquePass_, alphaPass_});
+
+    if (!sceneProcessor_->Define(frameInfo_))
+        ErrorExit("Cannot set up scene processor");
+    sceneProcessor_->SetRenderCamera(camera_);
+}
+
+void BenchmarkRenderPipeline::RunFrame(StageStats (&stats)[MAX_BENCHMARK_STAGES])
+{
+    const auto measure = [&](BenchmarkStage stage, void (BenchmarkRenderPipeline::*function)())
+    {
+        const unsigned long long allocationsBefore = GetNumAllocations();
+        HiresTimer timer;
+        (this->*function)();
+        stats[stage].totalUSec_ += timer.GetUSec(false);
+        stats[stage].numAllocations_ += GetNumAllocations() - allocationsBefore;
+    };
+
+    ++sceneFrameInfo_.frameNumber_;
+    ++frameInfo_.frameNumber_;
+    measure(STAGE_UPDATE_SCENE, &BenchmarkRenderPipeline::UpdateScene);
+    measure(STAGE_PROCESS_SCENE, &BenchmarkRenderPipeline::ProcessScene);
+    measure(STAGE_UPDATE_GEOMETRIES, &BenchmarkRenderPipeline::UpdateGeometries);
+    measure(STAGE_FILL_INSTANCING_BUFFER, &BenchmarkRenderPipeline::FillInstancingBuffer);
+}
+
+unsigned BenchmarkRenderPipeline::GetNumBatches() const
+{
+    return opaquePass_->GetBaseBatches().batches_.size() + opaquePass_->GetLightBatches().batches_.size()
+        + alphaPass_->GetBatches().batches_.size();
+}
+
+unsigned BenchmarkRenderPipeline::GetNumShadowSplits() const
+{
+    unsigned numSplits = 0;
+    for (LightProcessor* lightProcessor : sceneProcessor_->GetDrawableProcessor()->GetLightProcessors())
+        numSplits += lightProcessor->GetNumSplits();
+    return numSplits;
+}
+
+unsigned BenchmarkRenderPipeline::GetNumShadowBatches() const
+{
+    unsigned numBatches = 0;
+    for (LightProcessor* lightProcessor : sceneProcessor_->GetDrawableProcessor()->GetLightProcessors())
+    {
+        for (const ShadowSplitProcessor& split : lightProcessor->GetSplits())
+            numBatches += split.GetShadowBatches().batches_.size();
+    }
+    return numBatches;
+}
+
+void BenchmarkRenderPipeline::UpdateScene()
+{
+    const auto numMovingNodes = static_cast<unsigned>(drawableNodes_.size() * MOVING_FRACTION);
+    for (unsigned i = 0; i < numMovingNodes; ++i)
+    {
+        Node* node = drawableNodes_[random_.GetUInt(drawableNodes_.size())];
+        node->Translate(random_.GetVector3(-Vector3::ONE, Vector3::ONE) * 0.1f, TS_WORLD);
+    }
+
+    octree_->Update(sceneFrameInfo_);
+}
+
+void BenchmarkRenderPipeline::ProcessScene()
+{
+    // Occlusion, frustum culling, drawable and light processing, shadow splits, batch composition and sorting
+    shadowMapAllocator_->ResetAllShadowMaps();
+    OnUpdateBegin(this, frameInfo_);
+    sceneProcessor_->Update();
+    OnUpdateEnd(this, frameInfo_);
+}
+
+void BenchmarkRenderPipeline::UpdateGeometries()
+{
+    OnRenderBegin(this, frameInfo_);
+    sceneProcessor_->PrepareDrawablesBeforeRendering();
+}
+
+void BenchmarkRenderPipeline::FillInstancingBuffer()
+{
+    sceneProcessor_->PrepareInstancingBuffer();
+    OnRenderEnd(this, frameInfo_);
+}
+
+SharedPtr<Context> CreateContext()
+{
+    auto context = MakeShared<Context>();
+    auto engine = new Engine(context);
+    auto fs = context->GetSubsystem<FileSystem>();
+    const ea::string exeDir = GetParentPath(fs->GetProgramFileName());
+
+    // Nothing is rendered, so neither window nor render device is created
+    StringVariantMap parameters;
+    parameters[EP_HEADLESS] = true;
+    parameters[EP_SOUND] = false;
+    parameters[EP_LOG_QUIET] = true;
+    parameters[EP_RESOURCE_PATHS] = "CoreData;Data";
+    parameters[EP_RESOURCE_PREFIX_PATHS] = Format("{};{}", exeDir, GetParentPath(exeDir));
+    if (!engine->Initialize(parameters, {}))
+        ErrorExit("Cannot initialize engine");
+
+    // Graphics and Renderer provide shaders and defaults for the render pipeline even without render device.
+    // Pipeline states are created without render device as placeholders, so batches are not discarded.
+    context->RegisterSubsystem(new Graphics(context));
+    context->RegisterSubsystem(new Renderer(context));
+    context->RegisterSubsystem<PipelineStateCache>();
+    return context;
+}
+
+}
+
+int main(int argc, char** argv);
+void Run(const ea::vector<ea::string>& arguments);
+
+int main(int argc, char** argv)
+{
+    ea::vector<ea::string> arguments;
+
+    #ifdef WIN32
+    arguments = ParseArguments(GetCommandLineW());
+    #else
+    arguments = ParseArguments(argc, argv);
+    #endif
+
+    Run(arguments);
+    return 0;
+}
+
+void Run(const ea::vector<ea::string>& arguments)
+{
+    ea::vector<unsigned> drawableCounts = {1000, 10000, 100000};
+    ea::vector<unsigned> lightCounts = {4, 16, 64};
+    unsigned numFrames = 60;
+    SpatialIndexType spatialIndex = SpatialIndexType::Octree;
+    ea::string outputFileName;
+
+    for (unsigned i = 0; i < arguments.size(); ++i)
+    {
+        const ea::string& argument = arguments[i];
+        const bool hasValue = i + 1 < arguments.size();
+        if (argument == "-drawables" && hasValue)
+            drawableCounts = {ToUInt(arguments[++i])};
+        else if (argument == "-lights" && hasValue)
+            lightCounts = {ToUInt(arguments[++i])};
+        else if (argument == "-frames" && hasValue)
+            numFrames = Max(ToUInt(arguments[++i]), 1u);
+        else if (argument == "-output" && hasValue)
+            outputFileName = arguments[++i];
+        else if (argument == "-bvh")
+            spatialIndex = SpatialIndexType::BVH;
+        else
+        {
+            ErrorExit(
+                "Usage: RenderBenchmark [options]\n"
+                "\n"
+                "Runs CPU stages of scene rendering on synthetic scenes using SceneProcessor\n"
+                "of the render pipeline and prints average time per frame for each stage as JSON.\n"
+                "Nothing is rendered, render device is not created.\n"
+                "Allocations are not counted on Windows if Urho3D is linked dynamically.\n"
+                "\n"
+                "Options:\n"
+                "-drawables <count>  Number of drawables, default is 1000, 10000 and 100000\n"
+                "-lights <count>     Number of point lights, default is 4, 16 and 64\n"
+                "-frames <count>     Number of measured frames per scene, default is 60\n"
+                "-bvh                Use BVH spatial index instead of octree\n"
+                "-output <file>      Write JSON to file instead of standard output\n"
+            );
+        }
+    }
+
+    SharedPtr<Context> context = CreateContext();
+
+    auto jsonFile = MakeShared<JSONFile>(context);
+    JSONValue& root = jsonFile->GetRoot();
+    root.Set("spatialIndex", spatialIndex == SpatialIndexType::BVH ? "BVH" : "Octree");
+    root.Set("frames", numFrames);
+    root.Set("threads", WorkQueue::GetThreadIndexCount());
+    root.Set("allocationsCounted", allocationsCounted);
+
+    JSONValue scenes;
+    for (unsigned numDrawables : drawableCounts)
+    {
+        for (unsigned numLights : lightCounts)
+        {
+            auto scene = MakeShared<BenchmarkRenderPipeline>(context, numDrawables, numLights, spatialIndex);
+
+            // Warm up caches and buffers
+            StageStats stats[MAX_BENCHMARK_STAGES]{};
+            scene->RunFrame(stats);
+
+            ea::fill(ea::begin(stats), ea::end(stats), StageStats{});
+            for (unsigned frame = 0; frame < numFrames; ++frame)
+                scene->RunFrame(stats);
+
+            JSONValue sceneValue;
+            sceneValue.Set("drawables", numDrawables);
+            sceneValue.Set("lights", numLights);
+            sceneValue.Set("visibleDrawables", scene->GetNumVisibleDrawables());
+            sceneValue.Set("batches", scene->GetNumBatches());
+            sceneValue.Set("shadowSplits", scene->GetNumShadowSplits());
+            sceneValue.Set("shadowBatches", scene->GetNumShadowBatches());
+
+            JSONValue stagesValue;
+            double totalMs = 0.0;
+            for (unsigned stage = 0; stage < MAX_BENCHMARK_STAGES; ++stage)
+            {
+                const double stageMs = stats[stage].totalUSec_ / (1000.0 * numFrames);
+                const double stageAllocations = static_cast<double>(stats[stage].numAllocations_) / numFrames;
+                totalMs += stageMs;
+
+                JSONValue stageValue;
+                stageValue.Set("ms", stageMs);
+                if (allocationsCounted)
+                    stageValue.Set("allocations", stageAllocations);
+                stagesValue.Set(stageNames[stage], stageValue);
+            }
+            sceneValue.Set("stages", stagesValue);
+            sceneValue.Set("totalMs", totalMs);
+            scenes.Push(sceneValue);
+        }
+    }
+    root.Set("scenes", scenes);
+
+    if (outputFileName.empty())
+        PrintLine(jsonFile->ToString("  "));
+    else if (!jsonFile->SaveFile(outputFileName))
+        ErrorExit("Cannot write " + outputFileName);
+}
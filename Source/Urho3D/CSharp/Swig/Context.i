@@ -1,5 +1,7 @@
 %ignore Urho3D::Context::RegisterFactory;
 %ignore Urho3D::Context::GetEventHandler;
+%ignore Urho3D::Context::GetTypedEventChannel;
+%ignore Urho3D::Context::AddTypedEventChannel;
 
 
 // Extend Context with extra code
@@ -429,12 +429,19 @@ public:
 %ignore Urho3D::Serializer::WriteString(std::string_view value);
 %include "Urho3D/IO/Serializer.h"
 %interface_custom("%s", "I%s", Urho3D::Deserializer);
+%ignore Urho3D::Deserializer::GetContiguousData;
+%ignore Urho3D::MemoryBuffer::GetContiguousData;
+%ignore Urho3D::VectorBuffer::GetContiguousData;
 %include "Urho3D/IO/Deserializer.h"
 %interface_custom("%s", "I%s", Urho3D::AbstractFile);
 URHO3D_REFCOUNTED_INTERFACE(Urho3D::AbstractFile, Urho3D::RefCounted);
 %ignore Urho3D::MountPointGuard;
 %include "Urho3D/IO/AbstractFile.h"
 %include "Urho3D/IO/ScanFlags.h"
+%ignore Urho3D::ZstdDictionary;
+%ignore Urho3D::ZstdCompressor;
+%ignore Urho3D::ZstdDecompressor;
+%ignore Urho3D::TrainZstdDictionary;
 %include "Urho3D/IO/Compression.h"
 %include "Urho3D/IO/File.h"
 %include "Urho3D/IO/Log.h"
@@ -444,6 +451,7 @@ URHO3D_REFCOUNTED_INTERFACE(Urho3D::AbstractFile, Urho3D::RefCounted);
 %include "Urho3D/IO/FileIdentifier.h"
 %include "Urho3D/IO/MountPoint.h"
 %include "Urho3D/IO/VirtualFileSystem.h"
+%ignore Urho3D::PackageFile::GetDictionary;
 %include "Urho3D/IO/PackageFile.h"
 
 %ignore Urho3D::NonCopyable;
@@ -526,6 +534,10 @@ public:
 %ignore Urho3D::Node::SetEntity;
 %ignore Urho3D::Scene::GetRegistry;
 %ignore Urho3D::Scene::GetComponentIndex;
+%ignore Urho3D::Scene::GetUpdateGraph;
+%ignore Urho3D::ResourceCache::GetBackgroundLoader;
+%ignore Urho3D::Scene::GetTransformHierarchy;
+%ignore Urho3D::LogicComponent::DeclareUpdateAccess;
 %ignore Urho3D::Animatable::animationEnabled_;
 %ignore Urho3D::Animatable::objectAnimation_;
 %ignore Urho3D::Component::node_;
@@ -640,6 +652,16 @@ public:
 %ignore Urho3D::PointOctreeQuery::TestDrawables;
 %ignore Urho3D::BoxOctreeQuery::TestDrawables;
 %ignore Urho3D::OctreeQuery::TestDrawables;
+%ignore Urho3D::OctreeQuery::TestOctantBatch;
+%ignore Urho3D::OctreeQuery::TestDrawableBatch;
+%ignore Urho3D::FrustumOctreeQuery::TestOctantBatch;
+%ignore Urho3D::FrustumOctreeQuery::TestDrawableBatch;
+%ignore Urho3D::SphereOctreeQuery::TestOctantBatch;
+%ignore Urho3D::SphereOctreeQuery::TestDrawableBatch;
+%ignore Urho3D::BoxOctreeQuery::TestOctantBatch;
+%ignore Urho3D::BoxOctreeQuery::TestDrawableBatch;
+%ignore Urho3D::BoundingBoxBatch;
+%ignore Urho3D::Octree::GetBVH;
 %ignore Urho3D::ProcessLightWork;
 %ignore Urho3D::CheckVisibilityWork;
 %ignore Urho3D::ELEMENT_TYPESIZES;
@@ -666,6 +688,9 @@ public:
 %ignore Urho3D::CustomGeometry::MakeCircleGraph;
 %ignore Urho3D::CustomGeometry::ProcessRayQuery;
 %ignore Urho3D::OcclusionBufferData::dataWithSafety_;
+%ignore Urho3D::OcclusionBinData;
+%ignore Urho3D::OcclusionTriangle;
+%ignore Urho3D::OcclusionBuffer::AreVisible;
 %ignore Urho3D::Drawable::GetMutableLightProbeTetrahedronHint;
 %ignore Urho3D::Skybox::GetImage;   // Needs ImageCube
 %ignore Urho3D::Drawable2D::layer_;
@@ -792,7 +817,12 @@ public:
 }
 %ignore Urho3D::CrowdManager::SetVelocityCallback;
 %ignore Urho3D::NavBuildData::navAreas_;
+%ignore Urho3D::NavBuildData::config_;
+%ignore Urho3D::NavBuildData::tileData_;
+%ignore Urho3D::CrowdManager::FindPathAsync;
 %ignore Urho3D::NavigationMesh::FindPath;
+%ignore Urho3D::NavigationMesh::FindPathAsync;
+%ignore Urho3D::NavigationPathCallback;
 %include "generated/Urho3D/_pre_navigation.i"
 %include "Urho3D/Navigation/CrowdAgent.h"
 %include "Urho3D/Navigation/CrowdManager.h"
@@ -30,6 +30,7 @@
 #include "../Engine/Engine.h"
 #include "../Core/WorkQueue.h"
 #include "../Core/Thread.h"
+#include "../Core/TypedEvent.h"
 #include "../Graphics/Graphics.h"
 #include "../Graphics/Renderer.h"
 #include "../IO/FileSystem.h"
@@ -283,6 +284,20 @@ Object* Context::GetEventSender() const
         return nullptr;
 }
 
+TypedEventChannelBase* Context::GetTypedEventChannel(StringHash eventType) const
+{
+    const auto iter = typedEventChannels_.find(eventType);
+    return iter != typedEventChannels_.end() ? iter->second.get() : nullptr;
+}
+
+TypedEventChannelBase* Context::AddTypedEventChannel(
+    StringHash eventType, ea::unique_ptr<TypedEventChannelBase> channel)
+{
+    auto& storage = typedEventChannels_[eventType];
+    storage = ea::move(channel);
+    return storage.get();
+}
+
 const ea::string& Context::GetTypeName(StringHash objectType) const
 {
     // Search factories to find the hash-to-name mapping
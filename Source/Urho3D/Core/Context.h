@@ -33,6 +33,9 @@
 namespace Urho3D
 {
 
+class TypedEventChannelBase;
+template <class T> class TypedEventChannel;
+
 /// Tracking structure for event receivers.
 class URHO3D_API EventReceiverGroup : public RefCounted
 {
@@ -159,6 +162,14 @@ public:
         return i != eventReceivers_.end() ? i->second : nullptr;
     }
 
+    /// Return typed event channel by payload type, or null if it does not exist.
+    TypedEventChannelBase* GetTypedEventChannel(StringHash eventType) const;
+    /// Add typed event channel for payload type. Return added channel.
+    TypedEventChannelBase* AddTypedEventChannel(StringHash eventType, ea::unique_ptr<TypedEventChannelBase> channel);
+    /// Return typed event channel, create if missing. Defined in Urho3D/Core/TypedEvent.h.
+    /// Returned reference stays valid while Context exists, so it may be cached by frequent senders.
+    template <class T> TypedEventChannel<T>& GetTypedEventChannel();
+
 private:
     /// Add event receiver.
     void AddEventReceiver(Object* receiver, StringHash eventType);
@@ -184,6 +195,8 @@ private:
     ea::unordered_map<StringHash, SharedPtr<EventReceiverGroup> > eventReceivers_;
     /// Event receivers for specific senders' events.
     ea::unordered_map<Object*, ea::unordered_map<StringHash, SharedPtr<EventReceiverGroup> > > specificEventReceivers_;
+    /// Typed event channels by payload type.
+    ea::unordered_map<StringHash, ea::unique_ptr<TypedEventChannelBase>> typedEventChannels_;
     /// Event sender stack.
     ea::vector<Object*> eventSenders_;
     /// Event data stack.
@@ -64,6 +64,27 @@ URHO3D_EVENT(E_POSTRENDERUPDATE, PostRenderUpdate)
     URHO3D_PARAM(P_TIMESTEP, TimeStep);            // float
 }
 
+/// Typed versions of per-frame events. Sent right after corresponding events.
+/// @{
+struct UpdateTypedEvent
+{
+    URHO3D_TYPED_EVENT(UpdateTypedEvent);
+    float timeStep_{};
+};
+
+struct PostUpdateTypedEvent
+{
+    URHO3D_TYPED_EVENT(PostUpdateTypedEvent);
+    float timeStep_{};
+};
+
+struct RenderUpdateTypedEvent
+{
+    URHO3D_TYPED_EVENT(RenderUpdateTypedEvent);
+    float timeStep_{};
+};
+/// @}
+
 /// Frame end event.
 URHO3D_EVENT(E_ENDFRAME, EndFrame)
 {
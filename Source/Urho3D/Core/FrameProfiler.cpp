@@ -0,0 +1,370 @@
+//
+// Copyright (c) 2017-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "Urho3D/Precompiled.h"
+
+#include "Urho3D/Core/FrameProfiler.h"
+
+#include "Urho3D/Core/CoreEvents.h"
+#include "Urho3D/Core/Format.h"
+#include "Urho3D/Core/Mutex.h"
+#include "Urho3D/Core/Timer.h"
+#include "Urho3D/IO/File.h"
+#include "Urho3D/IO/Log.h"
+
+#include <EASTL/sort.h>
+#include <EASTL/unique_ptr.h>
+#include <EASTL/unordered_map.h>
+
+#include <chrono>
+
+#include "Urho3D/DebugNew.h"
+
+namespace Urho3D
+{
+
+namespace
+{
+
+/// Max number of not collected events per thread.
+static constexpr unsigned ThreadBufferSize = 8 * 1024;
+
+/// Single-producer single-consumer ring buffer of events of one thread.
+struct ThreadBuffer
+{
+    /// Name of the thread. Protected by ProfilerState::mutex_.
+    ea::string name_;
+    /// Index of the thread.
+    unsigned index_{};
+    /// Events.
+    ea::vector<FrameProfilerEvent> events_ = ea::vector<FrameProfilerEvent>(ThreadBufferSize);
+    /// Number of written events.
+    std::atomic<unsigned> writeIndex_{};
+    /// Number of collected events.
+    std::atomic<unsigned> readIndex_{};
+    /// Number of events dropped because buffer was full.
+    std::atomic<unsigned> numDropped_{};
+    /// Whether the thread has exited and the buffer can be reused.
+    std::atomic<bool> released_{};
+};
+
+/// Buffers of all threads.
+struct ProfilerState
+{
+    Mutex mutex_;
+    ea::vector<ea::unique_ptr<ThreadBuffer>> threads_;
+};
+
+ProfilerState& GetProfilerState()
+{
+    static ProfilerState state;
+    return state;
+}
+
+/// Releases thread buffer on thread exit.
+struct ThreadBufferOwner
+{
+    ~ThreadBufferOwner()
+    {
+        if (buffer_)
+            buffer_->released_.store(true, std::memory_order_release);
+    }
+
+    ThreadBuffer* buffer_{};
+    ea::string threadName_;
+};
+
+thread_local ThreadBufferOwner threadBufferOwner;
+
+const auto startTime = std::chrono::steady_clock::now();
+
+long long GetProfilerTime()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+ThreadBuffer* GetThreadBuffer()
+{
+    if (threadBufferOwner.buffer_)
+        return threadBufferOwner.buffer_;
+
+    ProfilerState& state = GetProfilerState();
+    MutexLock lock(state.mutex_);
+
+    // Reuse buffer of exited thread if all its events are collected
+    ThreadBuffer* buffer = nullptr;
+    for (const auto& threadBuffer : state.threads_)
+    {
+        if (threadBuffer->released_.load(std::memory_order_acquire)
+            && threadBuffer->readIndex_.load(std::memory_order_relaxed) == threadBuffer->writeIndex_.load(std::memory_order_relaxed))
+        {
+            buffer = threadBuffer.get();
+            buffer->released_.store(false, std::memory_order_relaxed);
+            break;
+        }
+    }
+
+    if (!buffer)
+    {
+        state.threads_.push_back(ea::make_unique<ThreadBuffer>());
+        buffer = state.threads_.back().get();
+        buffer->index_ = state.threads_.size() - 1;
+    }
+
+    buffer->name_ = !threadBufferOwner.threadName_.empty() ? threadBufferOwner.threadName_ : Format("Thread {}", buffer->index_);
+    threadBufferOwner.buffer_ = buffer;
+    return buffer;
+}
+
+void WriteJsonString(ea::string& dest, ea::string_view value)
+{
+    dest += '"';
+    for (const char ch : value)
+    {
+        if (ch == '"' || ch == '\\')
+        {
+            dest += '\\';
+            dest += ch;
+        }
+        else if (static_cast<unsigned char>(ch) < 0x20)
+            dest += Format("\\u{:04x}", static_cast<unsigned>(ch));
+        else
+            dest += ch;
+    }
+    dest += '"';
+}
+
+}
+
+std::atomic<bool> FrameProfilerScope::enabled_{};
+
+void FrameProfilerScope::Begin(const char* name)
+{
+    name_ = name;
+    beginTime_ = GetProfilerTime();
+}
+
+void FrameProfilerScope::End()
+{
+    const long long endTime = GetProfilerTime();
+    ThreadBuffer* buffer = GetThreadBuffer();
+
+    const unsigned writeIndex = buffer->writeIndex_.load(std::memory_order_relaxed);
+    if (writeIndex - buffer->readIndex_.load(std::memory_order_acquire) >= ThreadBufferSize)
+    {
+        buffer->numDropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    buffer->events_[writeIndex % ThreadBufferSize] = FrameProfilerEvent{name_, buffer->index_, beginTime_, endTime};
+    buffer->writeIndex_.store(writeIndex + 1, std::memory_order_release);
+}
+
+FrameProfiler::FrameProfiler(Context* context)
+    : Object(context)
+{
+    SubscribeToEvent(E_ENDFRAME, [this]
+    {
+        if (enabled_)
+            EndFrame(GetSubsystem<Time>()->GetFrameNumber());
+    });
+}
+
+FrameProfiler::~FrameProfiler()
+{
+    if (enabled_)
+        FrameProfilerScope::enabled_.store(false, std::memory_order_relaxed);
+}
+
+void FrameProfiler::SetEnabled(bool enabled)
+{
+    if (enabled_ == enabled)
+        return;
+
+    enabled_ = enabled;
+    FrameProfilerScope::enabled_.store(enabled, std::memory_order_relaxed);
+
+    // Discard events recorded before the first frame
+    if (enabled_)
+    {
+        EndFrame(0);
+        Clear();
+    }
+}
+
+void FrameProfiler::SetMaxFrames(unsigned maxFrames)
+{
+    maxFrames_ = ea::max(maxFrames, 1u);
+    if (frames_.size() > maxFrames_)
+        frames_.erase(frames_.begin(), frames_.end() - maxFrames_);
+}
+
+void FrameProfiler::SetThreadName(const char* name)
+{
+    threadBufferOwner.threadName_ = name;
+    if (ThreadBuffer* buffer = threadBufferOwner.buffer_)
+    {
+        MutexLock lock(GetProfilerState().mutex_);
+        buffer->name_ = name;
+    }
+}
+
+void FrameProfiler::EndFrame(unsigned frameNumber)
+{
+    FrameProfilerFrame frame;
+    frame.frameNumber_ = frameNumber;
+    frame.beginTime_ = frameBeginTime_;
+    frame.endTime_ = GetProfilerTime();
+    frameBeginTime_ = frame.endTime_;
+
+    {
+        ProfilerState& state = GetProfilerState();
+        MutexLock lock(state.mutex_);
+
+        for (const auto& buffer : state.threads_)
+        {
+            const unsigned writeIndex = buffer->writeIndex_.load(std::memory_order_acquire);
+            for (unsigned readIndex = buffer->readIndex_.load(std::memory_order_relaxed); readIndex != writeIndex; ++readIndex)
+                frame.events_.push_back(buffer->events_[readIndex % ThreadBufferSize]);
+            buffer->readIndex_.store(writeIndex, std::memory_order_release);
+            frame.numDroppedEvents_ += buffer->numDropped_.exchange(0, std::memory_order_relaxed);
+        }
+    }
+
+    frames_.push_back(ea::move(frame));
+    if (frames_.size() > maxFrames_)
+        frames_.erase(frames_.begin(), frames_.end() - maxFrames_);
+
+    UpdateFrameStats();
+}
+
+void FrameProfiler::Clear()
+{
+    frames_.clear();
+    frameStats_.clear();
+}
+
+void FrameProfiler::UpdateFrameStats()
+{
+    frameStats_.clear();
+    if (frames_.empty())
+        return;
+
+    ea::unordered_map<ea::string_view, unsigned> statsIndices;
+    for (const FrameProfilerEvent& event : frames_.back().events_)
+    {
+        const ea::string_view name{event.name_};
+        const auto [iter, isNew] = statsIndices.emplace(name, frameStats_.size());
+        if (isNew)
+            frameStats_.push_back(FrameProfilerScopeStats{name});
+
+        FrameProfilerScopeStats& stats = frameStats_[iter->second];
+        const float durationMs = static_cast<float>(event.endTime_ - event.beginTime_) * 0.000001f;
+        ++stats.count_;
+        stats.totalMs_ += durationMs;
+        stats.maxMs_ = ea::max(stats.maxMs_, durationMs);
+    }
+
+    ea::sort(frameStats_.begin(), frameStats_.end(),
+        [](const FrameProfilerScopeStats& lhs, const FrameProfilerScopeStats& rhs) { return lhs.totalMs_ > rhs.totalMs_; });
+}
+
+const FrameProfilerScopeStats* FrameProfiler::GetScopeStats(ea::string_view name) const
+{
+    for (const FrameProfilerScopeStats& stats : frameStats_)
+    {
+        if (stats.name_ == name)
+            return &stats;
+    }
+    return nullptr;
+}
+
+ea::string FrameProfiler::GetThreadName(unsigned threadIndex) const
+{
+    ProfilerState& state = GetProfilerState();
+    MutexLock lock(state.mutex_);
+    return threadIndex < state.threads_.size() ? state.threads_[threadIndex]->name_ : EMPTY_STRING;
+}
+
+bool FrameProfiler::ExportChromeTrace(Serializer& dest) const
+{
+    ea::string buffer;
+    buffer += "{\"traceEvents\":[\n";
+
+    // Thread names
+    unsigned numThreads = 0;
+    {
+        ProfilerState& state = GetProfilerState();
+        MutexLock lock(state.mutex_);
+        numThreads = state.threads_.size();
+        for (const auto& threadBuffer : state.threads_)
+        {
+            buffer += Format("{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":{},\"args\":{{\"name\":", threadBuffer->index_);
+            WriteJsonString(buffer, threadBuffer->name_);
+            buffer += "}},\n";
+        }
+    }
+
+    // Frames are shown as separate track
+    const unsigned framesThreadIndex = numThreads;
+    buffer += Format("{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":{},\"args\":{{\"name\":\"Frames\"}}}}", framesThreadIndex);
+
+    for (const FrameProfilerFrame& frame : frames_)
+    {
+        buffer += Format(",\n{{\"name\":\"Frame {}\",\"ph\":\"X\",\"pid\":0,\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}}}",
+            frame.frameNumber_, framesThreadIndex, frame.beginTime_ * 0.001, (frame.endTime_ - frame.beginTime_) * 0.001);
+
+        for (const FrameProfilerEvent& event : frame.events_)
+        {
+            buffer += ",\n{\"name\":";
+            WriteJsonString(buffer, event.name_);
+            buffer += Format(",\"ph\":\"X\",\"pid\":0,\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}}}", event.threadIndex_,
+                event.beginTime_ * 0.001, (event.endTime_ - event.beginTime_) * 0.001);
+        }
+
+        // Flush buffer once in a while to avoid huge allocations
+        if (buffer.size() > 1024 * 1024)
+        {
+            if (dest.Write(buffer.data(), buffer.size()) != buffer.size())
+                return false;
+            buffer.clear();
+        }
+    }
+
+    buffer += "\n]}\n";
+    return dest.Write(buffer.data(), buffer.size()) == buffer.size();
+}
+
+bool FrameProfiler::SaveChromeTrace(const ea::string& fileName) const
+{
+    File file(context_, fileName, FILE_WRITE);
+    if (!file.IsOpen())
+    {
+        URHO3D_LOGERROR("Cannot save profiler trace to {}", fileName);
+        return false;
+    }
+
+    return ExportChromeTrace(file);
+}
+
+}
@@ -0,0 +1,143 @@
+//
+// Copyright (c) 2017-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+/// \file
+
+#pragma once
+
+#include "Urho3D/Core/Object.h"
+
+#include <EASTL/string_view.h>
+#include <EASTL/vector.h>
+
+namespace Urho3D
+{
+
+class Serializer;
+
+/// Scope recorded by FrameProfiler. Time is in nanoseconds since the application start.
+struct FrameProfilerEvent
+{
+    /// Name of the scope.
+    const char* name_{};
+    /// Index of the thread in FrameProfiler.
+    unsigned threadIndex_{};
+    /// Time when the scope began.
+    long long beginTime_{};
+    /// Time when the scope ended.
+    long long endTime_{};
+};
+
+/// Aggregated statistics of scopes with the same name within a frame.
+struct FrameProfilerScopeStats
+{
+    /// Name of the scope.
+    ea::string_view name_;
+    /// Number of times the scope was executed.
+    unsigned count_{};
+    /// Total duration in milliseconds, summed over all threads.
+    float totalMs_{};
+    /// Maximum duration of single scope in milliseconds.
+    float maxMs_{};
+};
+
+/// Recorded frame.
+struct FrameProfilerFrame
+{
+    /// Frame number.
+    unsigned frameNumber_{};
+    /// Time when the frame began.
+    long long beginTime_{};
+    /// Time when the frame ended.
+    long long endTime_{};
+    /// Recorded scopes.
+    ea::vector<FrameProfilerEvent> events_;
+    /// Number of scopes that were dropped because thread buffer was full.
+    unsigned numDroppedEvents_{};
+
+    /// Return duration of the frame in milliseconds.
+    float GetDurationMs() const { return static_cast<float>(endTime_ - beginTime_) * 0.000001f; }
+};
+
+/// Built-in frame profiler. Collects scopes of URHO3D_PROFILE macros from all threads into per-thread lock-free buffers.
+/// Scopes are aggregated once per frame on the main thread and recent frames are kept for export.
+/// Only one instance should be enabled at a time.
+class URHO3D_API FrameProfiler : public Object
+{
+    URHO3D_OBJECT(FrameProfiler, Object);
+
+public:
+    /// Construct.
+    explicit FrameProfiler(Context* context);
+    /// Destruct.
+    ~FrameProfiler() override;
+
+    /// Enable or disable recording of scopes.
+    void SetEnabled(bool enabled);
+    /// Set how many recent frames are kept for export.
+    void SetMaxFrames(unsigned maxFrames);
+    /// Set name of the current thread.
+    static void SetThreadName(const char* name);
+
+    /// Finish the current frame: collect recorded scopes and update statistics. Called automatically on end of frame.
+    void EndFrame(unsigned frameNumber);
+    /// Discard recorded frames.
+    void Clear();
+
+    /// Return whether recording is enabled.
+    bool IsEnabled() const { return enabled_; }
+    /// Return how many recent frames are kept for export.
+    unsigned GetMaxFrames() const { return maxFrames_; }
+    /// Return recent frames, oldest first.
+    const ea::vector<FrameProfilerFrame>& GetFrames() const { return frames_; }
+    /// Return statistics of the last frame sorted by total duration.
+    const ea::vector<FrameProfilerScopeStats>& GetFrameStats() const { return frameStats_; }
+    /// Return statistics of the last frame for given scope name, or null if scope was not recorded.
+    const FrameProfilerScopeStats* GetScopeStats(ea::string_view name) const;
+    /// Return duration of the last frame in milliseconds.
+    float GetFrameDurationMs() const { return frames_.empty() ? 0.0f : frames_.back().GetDurationMs(); }
+    /// Return name of the thread by index.
+    ea::string GetThreadName(unsigned threadIndex) const;
+
+    /// Write recent frames in Chrome trace event format (chrome://tracing, Perfetto).
+    bool ExportChromeTrace(Serializer& dest) const;
+    /// Save recent frames in Chrome trace event format to file.
+    bool SaveChromeTrace(const ea::string& fileName) const;
+
+private:
+    /// Aggregate statistics of the last frame.
+    void UpdateFrameStats();
+
+    /// Whether recording is enabled.
+    bool enabled_{};
+    /// Max number of frames to keep.
+    unsigned maxFrames_{120};
+    /// Time when the current frame began.
+    long long frameBeginTime_{};
+    /// Recent frames.
+    ea::vector<FrameProfilerFrame> frames_;
+    /// Statistics of the last frame.
+    ea::vector<FrameProfilerScopeStats> frameStats_;
+};
+
+}
@@ -168,6 +168,18 @@ public:
         SendEvent(eventType, eventData);
     }
 
+    /// Typed events. Include Urho3D/Core/TypedEvent.h to use these functions.
+    /// @{
+    /// Subscribe to typed event that can be sent by any sender.
+    template <class T, class Callback> void SubscribeToTypedEvent(Callback handler);
+    /// Subscribe to a specific sender's typed event.
+    template <class T, class Callback> void SubscribeToTypedEvent(Object* sender, Callback handler);
+    /// Unsubscribe from typed event of specific sender, or from non-specific typed event if sender is null.
+    template <class T> void UnsubscribeFromTypedEvent(Object* sender = nullptr);
+    /// Send typed event to all subscribers.
+    template <class T> void SendTypedEvent(T& event);
+    /// @}
+
     /// Return execution context.
     Context* GetContext() const { return context_; }
     /// Return global variable based on key.
@@ -364,6 +376,8 @@ URHO3D_API StringHashRegister& GetEventParamRegister();
 #define URHO3D_EVENT(eventID, eventName) static const Urho3D::StringHash eventID(Urho3D::GetEventNameRegister().RegisterString(#eventName)); namespace eventName
 /// Describe an event's parameter hash ID. Should be used inside an event namespace.
 #define URHO3D_PARAM(paramID, paramName) static const Urho3D::StringHash paramID(Urho3D::GetEventParamRegister().RegisterString(#paramName))
+/// Describe typed event payload. Should be placed inside plain struct that is passed to handlers by reference.
+#define URHO3D_TYPED_EVENT(typeName) static constexpr Urho3D::StringHash TypedEventId{#typeName, Urho3D::StringHash::NoReverse{}}
 /// Deprecated. Just use &className::function instead.
 #define URHO3D_HANDLER(className, function) (&className::function)
 
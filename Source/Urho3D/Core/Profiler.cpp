@@ -32,6 +32,7 @@
 #endif
 #endif
 #include "Profiler.h"
+#include "FrameProfiler.h"
 
 namespace Urho3D
 {
@@ -41,6 +42,7 @@ void SetProfilerThreadName(const char* name)
 #if URHO3D_PROFILING
     tracy::SetThreadName(name);
 #endif
+    FrameProfiler::SetThreadName(name);
 }
 
 }
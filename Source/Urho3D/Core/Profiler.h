@@ -22,11 +22,15 @@
 
 #pragma once
 
+#include <Urho3D/Urho3D.h>
+
 #include <tracy/Tracy.hpp>
 #if URHO3D_PROFILING
 #include <client/TracyLock.hpp>
 #endif
 
+#include <atomic>
+
 namespace Urho3D
 {
 
@@ -35,11 +39,57 @@ static const unsigned PROFILER_COLOR_RESOURCES = 0x006b82;
 
 void SetProfilerThreadName(const char* name);
 
+/// Scope of the built-in frame profiler. Does nothing but a single check unless FrameProfiler is enabled.
+/// Name should be a string with static storage duration.
+class URHO3D_API FrameProfilerScope
+{
+public:
+    /// Construct and begin scope.
+    explicit FrameProfilerScope(const char* name)
+    {
+        if (enabled_.load(std::memory_order_relaxed))
+            Begin(name);
+    }
+    /// Destruct and end scope.
+    ~FrameProfilerScope()
+    {
+        if (name_)
+            End();
+    }
+
+    /// Return whether scopes are recorded.
+    static bool IsEnabled() { return enabled_.load(std::memory_order_relaxed); }
+
+private:
+    friend class FrameProfiler;
+
+    /// Begin scope.
+    void Begin(const char* name);
+    /// End scope and record event.
+    void End();
+
+    /// Name of the scope, null if not recorded.
+    const char* name_{};
+    /// Time when the scope began.
+    long long beginTime_{};
+
+    /// Whether scopes are recorded.
+    static std::atomic<bool> enabled_;
+};
+
 }
 
-#define URHO3D_PROFILE_FUNCTION()                   ZoneScopedN(__FUNCTION__)
-#define URHO3D_PROFILE_C(name, color)               ZoneScopedNC(name, color)
-#define URHO3D_PROFILE(name)                        ZoneScopedN(name)
+#define URHO3D_PROFILE_CONCAT_IMPL(x, y)            x##y
+#define URHO3D_PROFILE_CONCAT(x, y)                 URHO3D_PROFILE_CONCAT_IMPL(x, y)
+#ifdef URHO3D_FRAME_PROFILER
+#   define URHO3D_FRAME_PROFILE(name)               Urho3D::FrameProfilerScope URHO3D_PROFILE_CONCAT(frameProfilerScope, __LINE__){name}
+#else
+#   define URHO3D_FRAME_PROFILE(name)
+#endif
+
+#define URHO3D_PROFILE_FUNCTION()                   ZoneScopedN(__FUNCTION__); URHO3D_FRAME_PROFILE(__FUNCTION__)
+#define URHO3D_PROFILE_C(name, color)               ZoneScopedNC(name, color); URHO3D_FRAME_PROFILE(name)
+#define URHO3D_PROFILE(name)                        ZoneScopedN(name); URHO3D_FRAME_PROFILE(name)
 #define URHO3D_PROFILE_THREAD(name)                 Urho3D::SetProfilerThreadName(name)
 #define URHO3D_PROFILE_VALUE(name, value)           TracyPlot(name, value)
 #define URHO3D_PROFILE_FRAME()                      FrameMark
@@ -0,0 +1,241 @@
+//
+// Copyright (c) 2017-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "Urho3D/Precompiled.h"
+
+#include "Urho3D/Core/TaskGraph.h"
+
+#include "Urho3D/IO/Log.h"
+
+#ifdef URHO3D_THREADING
+#include <enkiTS/src/TaskScheduler.h>
+#endif
+
+#include "Urho3D/DebugNew.h"
+
+namespace Urho3D
+{
+
+#ifdef URHO3D_THREADING
+class TaskGraph::InternalTask : public enki::ITaskSet
+#else
+class TaskGraph::InternalTask
+#endif
+{
+public:
+    RangeFunction function_;
+    unsigned size_{};
+    unsigned minRange_{};
+    ea::vector<unsigned> dependencies_;
+
+#ifdef URHO3D_THREADING
+    ea::vector<enki::Dependency> internalDependencies_;
+    enki::Dependency observerDependency_;
+
+    void ExecuteRange(enki::TaskSetPartition range, uint32_t threadNum) override
+    {
+        // Empty loops are still scheduled as single element so that dependencies are resolved
+        if (size_ > 0)
+            function_(range.start, range.end, threadNum);
+    }
+#endif
+};
+
+#ifdef URHO3D_THREADING
+class TaskGraph::CompletionObserver : public enki::ICompletable
+{
+};
+#else
+class TaskGraph::CompletionObserver
+{
+};
+#endif
+
+TaskGraph::TaskGraph(WorkQueue* workQueue)
+    : workQueue_(workQueue)
+    , completionObserver_(ea::make_unique<CompletionObserver>())
+{
+#ifdef URHO3D_THREADING
+    completionObserver_->m_Priority = static_cast<enki::TaskPriority>(TaskPriority::Immediate);
+#endif
+}
+
+TaskGraph::~TaskGraph()
+{
+    Wait();
+    Clear();
+}
+
+void TaskGraph::AddDependency(TaskHandle task, TaskHandle dependency)
+{
+    URHO3D_ASSERT(!isRunning_);
+    URHO3D_ASSERT(task < tasks_.size() && dependency < tasks_.size());
+
+    tasks_[task]->dependencies_.push_back(dependency);
+    dirty_ = true;
+}
+
+void TaskGraph::Clear()
+{
+    URHO3D_ASSERT(!isRunning_);
+
+    // Dependencies refer to other tasks, unlink them before destruction
+    for (const auto& task : tasks_)
+    {
+#ifdef URHO3D_THREADING
+        task->internalDependencies_.clear();
+        task->observerDependency_.ClearDependency();
+#endif
+    }
+
+    tasks_.clear();
+    sortedTasks_.clear();
+    dirty_ = false;
+}
+
+TaskGraph::TaskHandle TaskGraph::AddTaskInternal(unsigned size, unsigned minRange, RangeFunction function)
+{
+    URHO3D_ASSERT(!isRunning_);
+
+    auto task = ea::make_unique<InternalTask>();
+    task->function_ = ea::move(function);
+    task->size_ = size;
+    task->minRange_ = ea::max(minRange, 1u);
+#ifdef URHO3D_THREADING
+    task->m_SetSize = ea::max(size, 1u);
+    task->m_MinRange = task->minRange_;
+    task->m_Priority = static_cast<enki::TaskPriority>(TaskPriority::Immediate);
+#endif
+
+    tasks_.push_back(ea::move(task));
+    dirty_ = true;
+    return tasks_.size() - 1;
+}
+
+void TaskGraph::Run()
+{
+    URHO3D_ASSERT(!isRunning_);
+
+    if (dirty_)
+    {
+        dirty_ = false;
+        if (!SortTasks())
+        {
+            URHO3D_LOGERROR("Cannot run task graph with cyclic dependencies");
+            sortedTasks_.clear();
+            return;
+        }
+        LinkTasks();
+    }
+
+    if (sortedTasks_.empty())
+        return;
+
+#ifdef URHO3D_THREADING
+    enki::TaskScheduler* taskScheduler = workQueue_ ? workQueue_->taskScheduler_.get() : nullptr;
+    if (taskScheduler && WorkQueue::IsProcessingThread())
+    {
+        isRunning_ = true;
+
+        // Dependent tasks are started by the scheduler
+        for (const auto& task : tasks_)
+        {
+            if (task->dependencies_.empty())
+                taskScheduler->AddTaskSetToPipe(task.get());
+        }
+        return;
+    }
+#endif
+
+    const unsigned threadIndex = WorkQueue::GetThreadIndex();
+    for (unsigned taskIndex : sortedTasks_)
+    {
+        InternalTask& task = *tasks_[taskIndex];
+        if (task.size_ > 0)
+            task.function_(0, task.size_, threadIndex);
+    }
+}
+
+void TaskGraph::Wait()
+{
+    if (!isRunning_)
+        return;
+
+#ifdef URHO3D_THREADING
+    static const auto priority = static_cast<enki::TaskPriority>(TaskPriority::Immediate);
+    workQueue_->taskScheduler_->WaitforTask(completionObserver_.get(), priority);
+#endif
+
+    isRunning_ = false;
+}
+
+bool TaskGraph::SortTasks()
+{
+    const unsigned numTasks = tasks_.size();
+
+    ea::vector<unsigned> numDependencies(numTasks);
+    ea::vector<ea::vector<unsigned>> dependents(numTasks);
+    for (unsigned taskIndex = 0; taskIndex < numTasks; ++taskIndex)
+    {
+        for (unsigned dependency : tasks_[taskIndex]->dependencies_)
+        {
+            ++numDependencies[taskIndex];
+            dependents[dependency].push_back(taskIndex);
+        }
+    }
+
+    sortedTasks_.clear();
+    for (unsigned taskIndex = 0; taskIndex < numTasks; ++taskIndex)
+    {
+        if (numDependencies[taskIndex] == 0)
+            sortedTasks_.push_back(taskIndex);
+    }
+
+    for (unsigned i = 0; i < sortedTasks_.size(); ++i)
+    {
+        for (unsigned dependent : dependents[sortedTasks_[i]])
+        {
+            if (--numDependencies[dependent] == 0)
+                sortedTasks_.push_back(dependent);
+        }
+    }
+
+    return sortedTasks_.size() == numTasks;
+}
+
+void TaskGraph::LinkTasks()
+{
+#ifdef URHO3D_THREADING
+    for (const auto& task : tasks_)
+    {
+        const unsigned numDependencies = task->dependencies_.size();
+        task->internalDependencies_.clear();
+        task->internalDependencies_.resize(numDependencies);
+        for (unsigned i = 0; i < numDependencies; ++i)
+            task->SetDependency(task->internalDependencies_[i], tasks_[task->dependencies_[i]].get());
+
+        completionObserver_->SetDependency(task->observerDependency_, task.get());
+    }
+#endif
+}
+
+}
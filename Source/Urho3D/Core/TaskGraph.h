@@ -0,0 +1,141 @@
+//
+// Copyright (c) 2017-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/// \file
+
+#pragma once
+
+#include "Urho3D/Core/NonCopyable.h"
+#include "Urho3D/Core/WorkQueue.h"
+
+#include <EASTL/functional.h>
+#include <EASTL/unique_ptr.h>
+#include <EASTL/vector.h>
+
+namespace Urho3D
+{
+
+/// Graph of tasks with explicit dependencies executed on WorkQueue.
+/// Each task is either a single function or a parallel loop over range that is split between threads.
+/// Task is started as soon as all its dependencies are complete, without returning to the caller.
+/// The graph may be executed multiple times, tasks and dependencies should not be modified while it's running.
+class URHO3D_API TaskGraph : public NonCopyable
+{
+public:
+    /// Handle of the task in the graph.
+    using TaskHandle = unsigned;
+    /// Range function of the task.
+    using RangeFunction = ea::function<void(unsigned beginIndex, unsigned endIndex, unsigned threadIndex)>;
+
+    /// Construct.
+    explicit TaskGraph(WorkQueue* workQueue);
+    /// Destruct. Waits for completion if running.
+    ~TaskGraph();
+
+    /// Add single task.
+    /// Signature of callback: void([unsigned threadIndex])
+    template <class Callback> TaskHandle AddTask(Callback callback);
+    /// Add parallel loop over range [0, size). See WorkQueue::ParallelFor.
+    /// Signature of callback: void(unsigned beginIndex, unsigned endIndex [, unsigned threadIndex])
+    template <class Callback> TaskHandle AddParallelFor(unsigned size, unsigned minRange, Callback callback);
+    /// Add task that is started after given task is complete.
+    template <class Callback> TaskHandle AddContinuation(TaskHandle dependency, Callback callback);
+    /// Make task wait for completion of another task.
+    void AddDependency(TaskHandle task, TaskHandle dependency);
+    /// Remove all tasks. Graph should not be running.
+    void Clear();
+
+    /// Start execution of all tasks. Tasks are executed immediately if there are no worker threads.
+    void Run();
+    /// Wait for completion of all tasks. Waiting thread executes other tasks instead of blocking.
+    void Wait();
+    /// Start execution and wait for completion.
+    void Execute() { Run(); Wait(); }
+
+    /// Return number of tasks.
+    unsigned GetNumTasks() const { return tasks_.size(); }
+    /// Return whether the graph is running.
+    bool IsRunning() const { return isRunning_; }
+
+private:
+    class InternalTask;
+    class CompletionObserver;
+
+    /// Add task with type-erased function.
+    TaskHandle AddTaskInternal(unsigned size, unsigned minRange, RangeFunction function);
+    /// Sort tasks in execution order. Return false if there are cyclic dependencies.
+    bool SortTasks();
+    /// Link internal tasks according to dependencies.
+    void LinkTasks();
+
+    /// Work queue.
+    WorkQueue* workQueue_{};
+    /// Tasks.
+    ea::vector<ea::unique_ptr<InternalTask>> tasks_;
+    /// Task indices in execution order.
+    ea::vector<unsigned> sortedTasks_;
+    /// Observer of all tasks completion.
+    ea::unique_ptr<CompletionObserver> completionObserver_;
+    /// Whether the tasks should be sorted and linked.
+    bool dirty_{};
+    /// Whether the graph is running in worker threads.
+    bool isRunning_{};
+};
+
+template <class Callback> TaskGraph::TaskHandle TaskGraph::AddTask(Callback callback)
+{
+    static constexpr bool hasThreadIndex = ea::is_invocable_r_v<void, Callback, unsigned>;
+    static constexpr bool hasNone = ea::is_invocable_r_v<void, Callback>;
+    static_assert(hasThreadIndex || hasNone, "Invalid callback signature");
+
+    if constexpr (hasThreadIndex)
+    {
+        return AddTaskInternal(1, 1, [callback = ea::move(callback)](unsigned, unsigned, unsigned threadIndex) mutable
+        { callback(threadIndex); });
+    }
+    else
+        return AddTaskInternal(1, 1, [callback = ea::move(callback)](unsigned, unsigned, unsigned) mutable { callback(); });
+}
+
+template <class Callback> TaskGraph::TaskHandle TaskGraph::AddParallelFor(unsigned size, unsigned minRange, Callback callback)
+{
+    static constexpr bool hasThreadIndex = ea::is_invocable_r_v<void, Callback, unsigned, unsigned, unsigned>;
+    static constexpr bool hasRange = ea::is_invocable_r_v<void, Callback, unsigned, unsigned>;
+    static_assert(hasThreadIndex || hasRange, "Invalid callback signature");
+
+    if constexpr (hasThreadIndex)
+        return AddTaskInternal(size, minRange, ea::move(callback));
+    else
+    {
+        return AddTaskInternal(size, minRange, [callback = ea::move(callback)](unsigned beginIndex, unsigned endIndex, unsigned)
+        { callback(beginIndex, endIndex); });
+    }
+}
+
+template <class Callback> TaskGraph::TaskHandle TaskGraph::AddContinuation(TaskHandle dependency, Callback callback)
+{
+    const TaskHandle task = AddTask(ea::move(callback));
+    AddDependency(task, dependency);
+    return task;
+}
+
+}
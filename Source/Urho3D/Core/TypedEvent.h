@@ -0,0 +1,310 @@
+//
+// Copyright (c) 2017-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/// \file
+
+#pragma once
+
+#include "../Core/Assert.h"
+#include "../Core/Context.h"
+#include "../Core/NonCopyable.h"
+#include "../Core/Thread.h"
+#include "../Core/TypeTrait.h"
+
+#include <EASTL/algorithm.h>
+#include <EASTL/fixed_function.h>
+#include <EASTL/unordered_map.h>
+#include <EASTL/vector.h>
+
+namespace Urho3D
+{
+
+/// Base class of typed event channel. Channels are owned by Context, one per payload type.
+class URHO3D_API TypedEventChannelBase : public NonCopyable
+{
+public:
+    /// Destruct.
+    virtual ~TypedEventChannelBase() = default;
+};
+
+/// Channel of typed events with payload T.
+/// Subscriptions are stored contiguously with handlers stored in-place,
+/// so sending an event is a loop over array without hash lookups and heap allocations.
+/// Like VariantMap events, typed events should be sent from main thread only.
+template <class T>
+class TypedEventChannel : public TypedEventChannelBase
+{
+public:
+    /// Small object optimization buffer size. Larger handlers are rejected at compile time.
+    static constexpr unsigned HandlerSize = 4 * sizeof(void*);
+    /// Handler type.
+    using Handler = ea::fixed_function<HandlerSize, void(Object* receiver, T& event)>;
+
+    /// Subscribe receiver to events from given sender, or from any sender if null.
+    /// Existing subscription of the same receiver to the same sender is replaced.
+    template <class Callback> void Subscribe(Object* receiver, Object* sender, Callback callback);
+    /// Unsubscribe receiver from events from given sender, or from non-specific events if null.
+    void Unsubscribe(Object* receiver, Object* sender);
+    /// Send event to all subscribers.
+    void Send(Object* sender, T& event);
+
+    /// Return whether the receiver is subscribed to events from given sender, or to non-specific events if null.
+    bool HasSubscription(Object* receiver, Object* sender) const;
+    /// Return number of subscriptions. May include expired subscriptions.
+    unsigned GetNumSubscriptions() const { return subscriptions_.size(); }
+
+private:
+    /// Subscription key: receiver and sender.
+    using SubscriptionKey = ea::pair<Object*, Object*>;
+
+    /// Subscription.
+    struct Subscription
+    {
+        /// Receiver. Subscription is expired if receiver is destroyed.
+        WeakPtr<Object> receiver_;
+        /// Sender. Subscription is expired if specific sender is destroyed.
+        WeakPtr<Object> sender_;
+        /// Whether the subscription is for specific sender.
+        bool isSpecific_{};
+        /// Handler.
+        Handler handler_;
+    };
+
+    /// Wrap callback into handler.
+    template <class Callback> static Handler WrapHandler(Callback callback);
+    /// Apply subscriptions added during send and remove expired ones.
+    void Cleanup();
+
+    /// Subscriptions. May contain expired elements.
+    ea::vector<Subscription> subscriptions_;
+    /// Index of subscription by key.
+    ea::unordered_map<SubscriptionKey, unsigned> subscriptionIndex_;
+    /// Subscriptions added during send. Appended after send is finished.
+    ea::vector<Subscription> pendingSubscriptions_;
+
+    /// Recursion depth of Send.
+    unsigned sendDepth_{};
+    /// Whether there are expired subscriptions.
+    bool hasExpired_{};
+};
+
+template <class T>
+template <class Callback>
+void TypedEventChannel<T>::Subscribe(Object* receiver, Object* sender, Callback callback)
+{
+    const SubscriptionKey key{receiver, sender};
+    const auto iter = subscriptionIndex_.find(key);
+    if (iter != subscriptionIndex_.end() && sendDepth_ == 0)
+    {
+        Subscription& subscription = subscriptions_[iter->second];
+        subscription.receiver_ = receiver;
+        subscription.sender_ = sender;
+        subscription.isSpecific_ = sender != nullptr;
+        subscription.handler_ = WrapHandler(ea::move(callback));
+        return;
+    }
+
+    if (iter != subscriptionIndex_.end())
+    {
+        // Handler may be executing now, disable old subscription and add new one after send
+        subscriptions_[iter->second].receiver_ = nullptr;
+        subscriptionIndex_.erase(iter);
+        hasExpired_ = true;
+    }
+
+    Subscription subscription;
+    subscription.receiver_ = receiver;
+    subscription.sender_ = sender;
+    subscription.isSpecific_ = sender != nullptr;
+    subscription.handler_ = WrapHandler(ea::move(callback));
+
+    if (sendDepth_ > 0)
+    {
+        // Same key may be subscribed several times during send, keep only the last handler
+        const auto isSameKey = [&](const Subscription& pending)
+        { return pending.receiver_ == receiver && pending.sender_ == sender; };
+        const auto pendingIter = ea::find_if(pendingSubscriptions_.begin(), pendingSubscriptions_.end(), isSameKey);
+        if (pendingIter != pendingSubscriptions_.end())
+            *pendingIter = ea::move(subscription);
+        else
+            pendingSubscriptions_.push_back(ea::move(subscription));
+    }
+    else
+    {
+        subscriptionIndex_.emplace(key, subscriptions_.size());
+        subscriptions_.push_back(ea::move(subscription));
+    }
+}
+
+template <class T>
+void TypedEventChannel<T>::Unsubscribe(Object* receiver, Object* sender)
+{
+    const SubscriptionKey key{receiver, sender};
+    const auto iter = subscriptionIndex_.find(key);
+    if (iter != subscriptionIndex_.end())
+    {
+        // Don't compact array here so mass unsubscription stays linear
+        subscriptions_[iter->second].receiver_ = nullptr;
+        subscriptionIndex_.erase(iter);
+        hasExpired_ = true;
+    }
+
+    for (Subscription& subscription : pendingSubscriptions_)
+    {
+        if (subscription.receiver_ == receiver && subscription.sender_ == sender)
+            subscription.receiver_ = nullptr;
+    }
+}
+
+template <class T>
+void TypedEventChannel<T>::Send(Object* sender, T& event)
+{
+    URHO3D_ASSERTLOG(Thread::IsMainThread(), "Sending events is only supported from the main thread");
+
+    if (sender && sender->GetBlockEvents())
+        return;
+
+    if (sendDepth_ == 0 && hasExpired_)
+        Cleanup();
+
+    // Make a weak pointer to sender to check for destruction during event handling
+    WeakPtr<Object> self(sender);
+
+    ++sendDepth_;
+    const unsigned numSubscriptions = subscriptions_.size();
+    for (unsigned i = 0; i < numSubscriptions; ++i)
+    {
+        Subscription& subscription = subscriptions_[i];
+        Object* receiver = subscription.receiver_.Get();
+        if (!receiver)
+        {
+            hasExpired_ = true;
+            continue;
+        }
+
+        if (subscription.isSpecific_)
+        {
+            Object* expectedSender = subscription.sender_.Get();
+            if (!expectedSender)
+            {
+                subscription.receiver_ = nullptr;
+                hasExpired_ = true;
+                continue;
+            }
+            if (expectedSender != sender)
+                continue;
+        }
+
+        if (receiver->GetBlockEvents())
+            continue;
+
+        subscription.handler_(receiver, event);
+
+        if (sender && self.Expired())
+            break;
+    }
+    --sendDepth_;
+
+    if (sendDepth_ == 0 && (hasExpired_ || !pendingSubscriptions_.empty()))
+        Cleanup();
+}
+
+template <class T>
+bool TypedEventChannel<T>::HasSubscription(Object* receiver, Object* sender) const
+{
+    const auto iter = subscriptionIndex_.find(SubscriptionKey{receiver, sender});
+    return iter != subscriptionIndex_.end() && subscriptions_[iter->second].receiver_;
+}
+
+template <class T>
+template <class Callback>
+typename TypedEventChannel<T>::Handler TypedEventChannel<T>::WrapHandler(Callback callback)
+{
+    if constexpr (ea::is_member_function_pointer_v<Callback>)
+    {
+        using ReceiverType = MemberFunctionObject<Callback>;
+        static_assert(ea::is_invocable_r_v<void, Callback, ReceiverType*, T&>, "Handler should accept (T&)");
+        return [callback](Object* receiver, T& event) { (static_cast<ReceiverType*>(receiver)->*callback)(event); };
+    }
+    else
+    {
+        static constexpr bool hasReceiverEvent = ea::is_invocable_r_v<void, Callback, Object*, T&>;
+        static constexpr bool hasEvent = ea::is_invocable_r_v<void, Callback, T&>;
+        static_assert(hasReceiverEvent || hasEvent, "Handler should accept either (T&) or (Object*, T&)");
+
+        if constexpr (hasReceiverEvent)
+            return [callback = ea::move(callback)](Object* receiver, T& event) mutable { callback(receiver, event); };
+        else
+            return [callback = ea::move(callback)](Object*, T& event) mutable { callback(event); };
+    }
+}
+
+template <class T>
+void TypedEventChannel<T>::Cleanup()
+{
+    hasExpired_ = false;
+
+    for (Subscription& subscription : pendingSubscriptions_)
+        subscriptions_.push_back(ea::move(subscription));
+    pendingSubscriptions_.clear();
+
+    const auto isExpired = [](const Subscription& subscription) { return !subscription.receiver_; };
+    ea::erase_if(subscriptions_, isExpired);
+
+    subscriptionIndex_.clear();
+    for (unsigned i = 0; i < subscriptions_.size(); ++i)
+    {
+        const Subscription& subscription = subscriptions_[i];
+        const SubscriptionKey key{subscription.receiver_.Get(), subscription.sender_.Get()};
+        subscriptionIndex_[key] = i;
+    }
+}
+
+template <class T> TypedEventChannel<T>& Context::GetTypedEventChannel()
+{
+    TypedEventChannelBase* channel = GetTypedEventChannel(T::TypedEventId);
+    if (!channel)
+        channel = AddTypedEventChannel(T::TypedEventId, ea::make_unique<TypedEventChannel<T>>());
+    return *static_cast<TypedEventChannel<T>*>(channel);
+}
+
+template <class T, class Callback> void Object::SubscribeToTypedEvent(Callback handler)
+{
+    context_->GetTypedEventChannel<T>().Subscribe(this, nullptr, ea::move(handler));
+}
+
+template <class T, class Callback> void Object::SubscribeToTypedEvent(Object* sender, Callback handler)
+{
+    context_->GetTypedEventChannel<T>().Subscribe(this, sender, ea::move(handler));
+}
+
+template <class T> void Object::UnsubscribeFromTypedEvent(Object* sender)
+{
+    context_->GetTypedEventChannel<T>().Unsubscribe(this, sender);
+}
+
+template <class T> void Object::SendTypedEvent(T& event)
+{
+    context_->GetTypedEventChannel<T>().Send(this, event);
+}
+
+}
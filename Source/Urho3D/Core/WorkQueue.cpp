@@ -248,6 +248,18 @@ public:
     }
 };
 
+class WorkQueue::ParallelForTask : public enki::ITaskSet
+{
+public:
+    const void* callback_{};
+    RangeFunction function_{};
+
+    void ExecuteRange(enki::TaskSetPartition range, uint32_t threadNum) override
+    {
+        function_(callback_, range.start, range.end, threadNum);
+    }
+};
+
 #endif
 
 WorkQueue::WorkQueue(Context* context)
@@ -530,6 +542,34 @@ void WorkQueue::CompleteAll()
     }
 }
 
+void WorkQueue::ParallelForInternal(unsigned size, unsigned minRange, const void* callback, RangeFunction function)
+{
+    if (size == 0)
+        return;
+
+    minRange = ea::max(minRange, 1u);
+
+#ifdef URHO3D_THREADING
+    static const auto priority = static_cast<enki::TaskPriority>(TaskPriority::Immediate);
+    if (taskScheduler_ && size > minRange && IsProcessingThread())
+    {
+        ParallelForTask task;
+        task.m_SetSize = size;
+        task.m_MinRange = minRange;
+        task.m_Priority = priority;
+        task.callback_ = callback;
+        task.function_ = function;
+
+        // Waiting thread executes tasks of the same or higher priority, including nested ParallelFor
+        taskScheduler_->AddTaskSetToPipe(&task);
+        taskScheduler_->WaitforTask(&task, priority);
+        return;
+    }
+#endif
+
+    function(callback, 0, size, GetThreadIndex());
+}
+
 SharedPtr<WorkItem> WorkQueue::GetFreeItem()
 {
     // This function is deprecated, so we don't care about performance here.
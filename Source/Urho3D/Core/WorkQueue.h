@@ -118,6 +118,7 @@ class URHO3D_API WorkQueue : public Object
 {
     URHO3D_OBJECT(WorkQueue, Object);
 
+    friend class TaskGraph;
     friend class WorkerThread;
 
 public:
@@ -151,6 +152,14 @@ public:
     /// Should be called only from main thread.
     void CompleteAll();
 
+    /// Process range [0, size) in multiple threads and wait for completion.
+    /// Range is split by the scheduler according to the number of threads, idle threads steal sub-ranges
+    /// of at least minRange elements. Waiting thread executes other tasks instead of blocking,
+    /// so it's safe to call ParallelFor from within other tasks.
+    /// Range is processed in current thread if called from outside of processing threads.
+    /// Signature of callback: void(unsigned beginIndex, unsigned endIndex [, unsigned threadIndex])
+    template <class Callback> void ParallelFor(unsigned size, unsigned minRange, const Callback& callback);
+
     /// Return number of incomplete tasks.
     unsigned GetNumIncomplete() const;
     /// Return whether all work is finished.
@@ -191,6 +200,10 @@ private:
 
     template <class T> static TaskFunction WrapTask(T&& task);
 
+    /// Type-erased reference to ParallelFor callback.
+    using RangeFunction = void(*)(const void* callback, unsigned beginIndex, unsigned endIndex, unsigned threadIndex);
+    void ParallelForInternal(unsigned size, unsigned minRange, const void* callback, RangeFunction function);
+
 #ifdef URHO3D_THREADING
     template <class T> void SetupInternalTask(T* internalTask, TaskFunction&& task, TaskPriority priority);
 
@@ -234,6 +247,7 @@ private:
     class InternalTaskInStack;
     class InternalPinnedTaskInStack;
     class TaskCompletionObserver;
+    class ParallelForTask;
 
     /// Task scheduler.
     ea::unique_ptr<enki::TaskScheduler> taskScheduler_;
@@ -366,6 +380,24 @@ template <class T> TaskFunction WorkQueue::WrapTask(T&& task)
         return [task = ea::move(task)](unsigned, WorkQueue*) mutable { task(); };
 }
 
+template <class Callback> void WorkQueue::ParallelFor(unsigned size, unsigned minRange, const Callback& callback)
+{
+    static constexpr bool hasThreadIndex = ea::is_invocable_r_v<void, Callback, unsigned, unsigned, unsigned>;
+    static constexpr bool hasRange = ea::is_invocable_r_v<void, Callback, unsigned, unsigned>;
+    static_assert(hasThreadIndex || hasRange, "Invalid callback signature");
+
+    const auto function = [](const void* callbackPtr, unsigned beginIndex, unsigned endIndex, unsigned threadIndex)
+    {
+        const auto& callback = *static_cast<const Callback*>(callbackPtr);
+        if constexpr (hasThreadIndex)
+            callback(beginIndex, endIndex, threadIndex);
+        else
+            callback(beginIndex, endIndex);
+    };
+
+    ParallelForInternal(size, minRange, &callback, function);
+}
+
 template <class T> void WorkQueue::PostTask(T task, TaskPriority priority)
 {
     if (!IsProcessingThread())
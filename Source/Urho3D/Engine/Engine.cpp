@@ -25,9 +25,13 @@
 #include "../Audio/Audio.h"
 #include "../Core/Context.h"
 #include "../Core/CoreEvents.h"
+#ifdef URHO3D_FRAME_PROFILER
+#include "../Core/FrameProfiler.h"
+#endif
 #include "../Core/Profiler.h"
 #include "../Core/ProcessUtils.h"
 #include "../Core/Thread.h"
+#include "../Core/TypedEvent.h"
 #include "../Core/WorkQueue.h"
 #ifdef URHO3D_SYSTEMUI
 #include "../SystemUI/SystemUI.h"
@@ -38,6 +42,7 @@
 #include "../Engine/Engine.h"
 #include "../Engine/EngineDefs.h"
 #include "../Engine/StateManager.h"
+#include "../Graphics/AnimationScheduler.h"
 #include "../Graphics/Graphics.h"
 #include "../Graphics/GraphicsEvents.h"
 #include "../Graphics/Texture2D.h"
@@ -98,6 +103,7 @@
 #include "../Particles/ParticleGraphSystem.h"
 #endif
 #include "../Plugins/PluginManager.h"
+#include "../Utility/AnimationCompressor.h"
 #include "../Utility/AnimationVelocityExtractor.h"
 #include "../Utility/AssetPipeline.h"
 #include "../Utility/AssetTransformer.h"
@@ -252,6 +258,9 @@ Engine::Engine(Context* context) :
     // Create subsystems which do not depend on engine initialization or startup parameters
     context_->RegisterSubsystem(new Time(context_));
     context_->RegisterSubsystem(new WorkQueue(context_));
+#ifdef URHO3D_FRAME_PROFILER
+    context_->RegisterSubsystem(new FrameProfiler(context_));
+#endif
     context_->RegisterSubsystem(new FileSystem(context_));
     context_->RegisterSubsystem(new VirtualFileSystem(context_));
 #ifdef URHO3D_LOGGING
@@ -264,6 +273,7 @@ Engine::Engine(Context* context) :
 #endif
     // Required in headless mode as well.
     RegisterGraphicsLibrary(context_);
+    context_->RegisterSubsystem(new AnimationScheduler(context_));
     // Register object factories for libraries which are not automatically registered along with subsystem creation
     RegisterSceneLibrary(context_);
     // Register UI library object factories before creation of subsystem. This is not done inside subsystem because
@@ -315,6 +325,7 @@ Engine::Engine(Context* context) :
     SceneViewerApplication::RegisterObject();
     context_->AddFactoryReflection<AssetPipeline>();
     context_->AddFactoryReflection<AssetTransformer>();
+    AnimationCompressor::RegisterObject(context_);
     AnimationVelocityExtractor::RegisterObject(context_);
 
     SubscribeToEvent(E_EXITREQUESTED, URHO3D_HANDLER(Engine, HandleExitRequested));
@@ -343,6 +354,10 @@ bool Engine::Initialize(const StringVariantMap& applicationParameters, const Str
     if (GetParameter(EP_PROFILE).GetBool())
         tracy::StartupProfiler();
 #endif
+#ifdef URHO3D_FRAME_PROFILER
+    if (GetParameter(EP_PROFILE).GetBool())
+        GetSubsystem<FrameProfiler>()->SetEnabled(true);
+#endif
 
     auto* fileSystem = GetSubsystem<FileSystem>();
 
@@ -984,12 +999,18 @@ void Engine::Update()
 
     // Logic update event
     SendEvent(E_UPDATE, eventData);
+    UpdateTypedEvent updateEvent{timeStep_};
+    SendTypedEvent(updateEvent);
 
     // Logic post-update event
     SendEvent(E_POSTUPDATE, eventData);
+    PostUpdateTypedEvent postUpdateEvent{timeStep_};
+    SendTypedEvent(postUpdateEvent);
 
     // Rendering update event
     SendEvent(E_RENDERUPDATE, eventData);
+    RenderUpdateTypedEvent renderUpdateEvent{timeStep_};
+    SendTypedEvent(renderUpdateEvent);
 
     // Post-render update event
     SendEvent(E_POSTRENDERUPDATE, eventData);
@@ -23,6 +23,7 @@
 #pragma once
 
 #include "../Core/Context.h"
+#include "../Core/WorkQueue.h"
 #include "../Graphics/Material.h"
 #include "../Graphics/StaticModel.h"
 #include "../Graphics/Renderer.h"
@@ -43,6 +44,25 @@ namespace Urho3D
 template <class T>
 void ParallelFor(unsigned count, unsigned numTasks, const T& callback)
 {
+    // Use WorkQueue if called from processing thread, so nested loops don't oversubscribe CPU
+    Context* context = Context::GetInstance();
+    auto workQueue = context ? context->GetSubsystem<WorkQueue>() : nullptr;
+    if (workQueue && workQueue->IsMultithreaded() && WorkQueue::IsProcessingThread())
+    {
+        const unsigned chunkSize = (count + numTasks - 1) / numTasks;
+        workQueue->ParallelFor(numTasks, 1, [&](unsigned beginTask, unsigned endTask)
+        {
+            for (unsigned i = beginTask; i < endTask; ++i)
+            {
+                const unsigned fromIndex = i * chunkSize;
+                const unsigned toIndex = ea::min(fromIndex + chunkSize, count);
+                if (fromIndex < toIndex)
+                    callback(fromIndex, toIndex);
+            }
+        });
+        return;
+    }
+
     // Post async tasks
     ea::vector<std::future<void>> tasks;
     const unsigned chunkSize = (count + numTasks - 1) / numTasks;
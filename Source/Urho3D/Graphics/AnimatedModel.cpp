@@ -26,8 +26,10 @@
 
 #include "../Core/Context.h"
 #include "../Core/Profiler.h"
+#include "../Core/Timer.h"
 #include "../Graphics/AnimatedModel.h"
 #include "../Graphics/Animation.h"
+#include "../Graphics/AnimationScheduler.h"
 #include "../Graphics/AnimationState.h"
 #include "../Graphics/Camera.h"
 #include "../Graphics/DebugRenderer.h"
@@ -68,6 +70,9 @@ AnimatedModel::AnimatedModel(Context* context) :
 
 AnimatedModel::~AnimatedModel()
 {
+    if (animationScheduler_)
+        animationScheduler_->RemoveModel(this);
+
     // When being destroyed, remove the bone hierarchy if appropriate (last AnimatedModel in the node)
     Bone* rootBone = skeleton_.GetRootBone();
     if (rootBone && rootBone->node_)
@@ -102,11 +107,14 @@ void AnimatedModel::RegisterObject(Context* context)
         Variant::emptyVariantVector, AM_DEFAULT | AM_NOEDIT);
     URHO3D_ACCESSOR_ATTRIBUTE("Morphs", GetMorphsAttr, SetMorphsAttr, ea::vector<unsigned char>, Variant::emptyBuffer,
         AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Nodeless Skeleton", GetNodelessSkeleton, SetNodelessSkeleton, bool, false, AM_DEFAULT);
 }
 
 void AnimatedModel::ApplyAttributes()
 {
-    if (assignBonesPending_)
+    if (nodelessSkeleton_)
+        AssignAttachedBoneNodes();
+    else if (assignBonesPending_)
         AssignBoneNodes();
 }
 
@@ -131,14 +139,16 @@ void AnimatedModel::ProcessCustomRayQuery(const RayOctreeQuery& query, const Bou
     for (unsigned i = 0; i < bones.size(); ++i)
     {
         const Bone& bone = bones[i];
-        if (!bone.node_)
+        const bool hasNodelessPose = nodelessSkeleton_ && isMaster_;
+        if (!bone.node_ && !hasNodelessPose)
             continue;
 
         float distance;
 
         // Keep this check to reuse this function for normal raycast without dedicated array of matrices.
-        const Matrix3x4& transform =
-            i < boneWorldTransforms.size() ? boneWorldTransforms[i] : bone.node_->GetWorldTransform();
+        const Matrix3x4 transform = i < boneWorldTransforms.size() ? boneWorldTransforms[i]
+            : hasNodelessPose ? worldTransform * skeletonData_[i].localToComponent_
+            : bone.node_->GetWorldTransform();
 
         // Use hitbox if available
         if (bone.collisionMask_ & BONECOLLISION_BOX)
@@ -230,7 +240,7 @@ void AnimatedModel::Update(const FrameInfo& frame)
     {
         // On main component, update animation and bounding box
         bool transformsDirty = false;
-        if (animationDirty_ || boneBoundingBoxDirty_)
+        if (animationDirty_ || boneBoundingBoxDirty_ || poseInterpolated_)
         {
             InitializeLocalBoneTransforms(false);
 
@@ -238,16 +248,28 @@ void AnimatedModel::Update(const FrameInfo& frame)
             {
                 if (UpdateAndCheckAnimationTimers(frame.timeStep_))
                 {
-                    CalculateAnimations();
+                    CalculateScheduledAnimations();
                     transformsDirty = true;
                 }
             }
 
+            if (poseInterpolated_)
+            {
+                InterpolatePose();
+                transformsDirty = true;
+            }
+
             if (boneBoundingBoxDirty_)
                 CalculateLocalBoundingBox();
         }
 
-        if (transformsDirty)
+        if (transformsDirty && nodelessSkeleton_)
+        {
+            // Pose is consumed directly by skinning, only attached nodes need to be moved
+            skinningDirty_ = true;
+            QueueAttachedBoneNodeUpdates();
+        }
+        else if (transformsDirty)
         {
             Octree* octree = octant_->GetOctree();
             for (unsigned boneIndex = 0; boneIndex < skeleton_.GetNumBones(); ++boneIndex)
@@ -281,6 +303,10 @@ void AnimatedModel::InitializeLocalBoneTransforms(bool reset)
         ModelAnimationOutput& output = skeletonData_[i];
 
         output.dirty_ = CHANNEL_NONE;
+        // In node-less mode the pose is kept between updates
+        if (!reset && nodelessSkeleton_)
+            continue;
+
         if (!reset && bone->node_)
         {
             output.localToParent_.position_ = bone->node_->GetPosition();
@@ -308,6 +334,8 @@ void AnimatedModel::CalculateFinalBoneTransforms()
         else
             output.localToComponent_ = skeletonData_[bone->parentIndex_].localToComponent_ * output.localToParent_.ToMatrix3x4();
     }
+
+    ++poseRevision_;
 }
 
 void AnimatedModel::UpdateBatches(const FrameInfo& frame)
@@ -359,7 +387,7 @@ void AnimatedModel::UpdateGeometry(const FrameInfo& frame)
         forceAnimationUpdate_ = false;
     }
 
-    if (skinningDirty_)
+    if (skinningDirty_ || IsMasterPoseChanged())
         UpdateSkinning();
 
     if (morphsDirty_)
@@ -368,9 +396,10 @@ void AnimatedModel::UpdateGeometry(const FrameInfo& frame)
 
 UpdateGeometryType AnimatedModel::GetUpdateGeometryType()
 {
-    if (morphsDirty_ || forceAnimationUpdate_ || (skinningDirty_ && softwareSkinning_))
+    const bool skinningDirty = skinningDirty_ || IsMasterPoseChanged();
+    if (morphsDirty_ || forceAnimationUpdate_ || (skinningDirty && softwareSkinning_))
         return UPDATE_MAIN_THREAD;
-    else if (skinningDirty_)
+    else if (skinningDirty)
         return UPDATE_WORKER_THREAD;
     else
         return UPDATE_NONE;
@@ -381,7 +410,23 @@ void AnimatedModel::DrawDebugGeometry(DebugRenderer* debug, bool depthTest)
     if (debug && IsEnabledEffective())
     {
         debug->AddBoundingBox(GetWorldBoundingBox(), Color::GREEN, depthTest);
-        debug->AddSkeleton(skeleton_, Color(0.75f, 0.75f, 0.75f), false);
+        if (!nodelessSkeleton_)
+            debug->AddSkeleton(skeleton_, Color(0.75f, 0.75f, 0.75f), false);
+        else if (isMaster_)
+        {
+            const Matrix3x4& worldTransform = node_->GetWorldTransform();
+            const ea::vector<Bone>& bones = skeleton_.GetBones();
+            for (unsigned i = 0; i < bones.size(); ++i)
+            {
+                const unsigned parentIndex = bones[i].parentIndex_;
+                if (parentIndex == i || parentIndex >= bones.size())
+                    continue;
+
+                const Vector3 start = worldTransform * skeletonData_[i].localToComponent_.Translation();
+                const Vector3 end = worldTransform * skeletonData_[parentIndex].localToComponent_.Translation();
+                debug->AddLine(start, end, Color(0.75f, 0.75f, 0.75f), false);
+            }
+        }
     }
 }
 
@@ -440,6 +485,13 @@ void AnimatedModel::SetModel(Model* model, bool createBones)
         skeletonData_.resize(skeleton_.GetNumBones());
         SetGeometryBoneMappings();
 
+        if (nodelessSkeleton_)
+        {
+            InitializeLocalBoneTransforms(true);
+            CalculateFinalBoneTransforms();
+            AssignAttachedBoneNodes();
+        }
+
         // Reconsider software skinning
         UpdateSoftwareSkinningState();
 
@@ -498,6 +550,41 @@ void AnimatedModel::SetAnimationLodBias(float bias)
     animationLodBias_ = Max(bias, 0.0f);
 }
 
+void AnimatedModel::SetNodelessSkeleton(bool enable)
+{
+    if (enable == nodelessSkeleton_)
+        return;
+
+    nodelessSkeleton_ = enable;
+    attachedBoneNodes_.clear();
+
+    // If the model is being loaded, bone nodes are resolved later in ApplyAttributes
+    if (!model_ || assignBonesPending_)
+    {
+        if (enable)
+        {
+            InitializeLocalBoneTransforms(true);
+            CalculateFinalBoneTransforms();
+        }
+        return;
+    }
+
+    if (enable && isMaster_)
+        RemoveRootBone();
+
+    for (Bone& bone : skeleton_.GetModifiableBones())
+    {
+        if (bone.node_)
+            bone.node_->RemoveListener(this);
+        bone.node_.Reset();
+    }
+
+    // Re-create the skeleton in the new mode
+    SharedPtr<Model> model{model_};
+    model_.Reset();
+    SetModel(model, !enable);
+}
+
 void AnimatedModel::SetUpdateInvisible(bool enable)
 {
     updateInvisible_ = enable;
@@ -583,6 +670,19 @@ void AnimatedModel::ResetMorphWeights()
 void AnimatedModel::ResetBones()
 {
     skeleton_.Reset();
+
+    if (nodelessSkeleton_ && isMaster_)
+    {
+        for (unsigned i = 0; i < skeleton_.GetNumBones(); ++i)
+        {
+            const Bone* bone = skeleton_.GetBone(i);
+            if (bone->animated_)
+                skeletonData_[i].localToParent_ = {bone->initialPosition_, bone->initialRotation_, bone->initialScale_};
+        }
+        CalculateLocalBoundingBox();
+        ApplyBoneTransformsToNodes();
+    }
+
     MarkAnimationDirty();
 }
 
@@ -621,6 +721,10 @@ float AnimatedModel::GetMorphWeight(StringHash nameHash) const
 
 void AnimatedModel::SetSkeleton(const Skeleton& skeleton, bool createBones)
 {
+    // Nodes for bones are created on demand in node-less mode
+    if (nodelessSkeleton_)
+        createBones = false;
+
     if (!node_ && createBones)
     {
         URHO3D_LOGERROR("AnimatedModel not attached to a scene node, can not create bone nodes");
@@ -723,7 +827,7 @@ void AnimatedModel::SetSkeleton(const Skeleton& skeleton, bool createBones)
         }
     }
 
-    assignBonesPending_ = !createBones;
+    assignBonesPending_ = !createBones && !nodelessSkeleton_;
 }
 
 void AnimatedModel::SetModelAttr(const ResourceRef& value)
@@ -816,6 +920,25 @@ void AnimatedModel::OnNodeSet(Node* previousNode, Node* currentNode)
     }
 }
 
+void AnimatedModel::OnSceneSet(Scene* previousScene, Scene* scene)
+{
+    StaticModel::OnSceneSet(previousScene, scene);
+
+    if (scene)
+    {
+        if (auto* animationScheduler = GetSubsystem<AnimationScheduler>())
+        {
+            animationScheduler_ = animationScheduler;
+            animationScheduler->AddModel(this);
+        }
+    }
+    else if (animationScheduler_)
+    {
+        animationScheduler_->RemoveModel(this);
+        animationScheduler_ = nullptr;
+    }
+}
+
 void AnimatedModel::OnMarkedDirty(Node* node)
 {
     Drawable::OnMarkedDirty(node);
@@ -881,6 +1004,32 @@ void AnimatedModel::AssignBoneNodes()
         animationStateSource_->MarkAnimationStateTracksDirty();
 }
 
+void AnimatedModel::AssignAttachedBoneNodes()
+{
+    assignBonesPending_ = false;
+    attachedBoneNodes_.clear();
+
+    if (!node_)
+        return;
+
+    // Only direct children with bone names are attached
+    const ea::vector<Bone>& bones = skeleton_.GetBones();
+    for (unsigned boneIndex = 0; boneIndex < bones.size(); ++boneIndex)
+    {
+        if (Node* boneNode = node_->GetChild(bones[boneIndex].nameHash_, false))
+            attachedBoneNodes_.emplace_back(boneIndex, WeakPtr<Node>(boneNode));
+    }
+}
+
+bool AnimatedModel::IsMasterPoseChanged() const
+{
+    if (!nodelessSkeleton_ || isMaster_ || !node_)
+        return false;
+
+    const auto* master = node_->GetComponent<AnimatedModel>();
+    return master && master != this && master->poseRevision_ != masterPoseRevision_;
+}
+
 void AnimatedModel::FinalizeBoneBoundingBoxes()
 {
     ea::vector<Bone>& bones = skeleton_.GetModifiableBones();
@@ -1015,6 +1164,19 @@ void AnimatedModel::SetGeometryBoneMappings()
 
 bool AnimatedModel::UpdateAndCheckAnimationTimers(float timeStep)
 {
+    // Scheduler decides for all models at once
+    if (animationSchedule_.scheduled_)
+    {
+        // The first update after becoming visible is performed immediately and is not interpolated
+        if (animationLodTimer_ < 0.0f)
+        {
+            animationLodTimer_ = 0.0f;
+            animationSchedule_.interpolationFactor_ = 1.0f;
+            return true;
+        }
+        return animationSchedule_.update_;
+    }
+
     // If using animation LOD, accumulate time and see if it is time to update
     const bool throttlingAllowed = !animationStateSource_ || animationStateSource_->IsAnimationThrottlingAllowed();
     if (throttlingAllowed && animationLodBias_ > 0.0f && animationLodDistance_ > 0.0f)
@@ -1049,12 +1211,75 @@ void AnimatedModel::CalculateAnimations()
     boneBoundingBoxDirty_ = true;
 }
 
+void AnimatedModel::CalculateScheduledAnimations()
+{
+    if (!animationSchedule_.scheduled_)
+    {
+        CalculateAnimations();
+        poseInterpolated_ = false;
+        return;
+    }
+
+    HiresTimer timer;
+
+    const unsigned numBones = skeletonData_.size();
+    const bool interpolate = animationSchedule_.interpolationFactor_ < 1.0f;
+    if (interpolate)
+    {
+        // Interpolate from the pose that is currently shown
+        interpolationSource_.resize(numBones);
+        for (unsigned i = 0; i < numBones; ++i)
+            interpolationSource_[i] = skeletonData_[i].localToParent_;
+    }
+
+    CalculateAnimations();
+
+    if (interpolate)
+    {
+        interpolationTarget_.resize(numBones);
+        for (unsigned i = 0; i < numBones; ++i)
+            interpolationTarget_[i] = skeletonData_[i].localToParent_;
+    }
+    poseInterpolated_ = interpolate;
+
+    if (animationScheduler_)
+        animationScheduler_->ReportAnimationTime(timer.GetUSec(false));
+}
+
+void AnimatedModel::InterpolatePose()
+{
+    const unsigned numBones = skeletonData_.size();
+    if (interpolationSource_.size() != numBones || interpolationTarget_.size() != numBones)
+    {
+        poseInterpolated_ = false;
+        return;
+    }
+
+    const float factor = animationSchedule_.scheduled_ ? animationSchedule_.interpolationFactor_ : 1.0f;
+    for (unsigned i = 0; i < numBones; ++i)
+        skeletonData_[i].localToParent_ = interpolationSource_[i].Lerp(interpolationTarget_[i], factor);
+
+    if (factor >= 1.0f)
+        poseInterpolated_ = false;
+    boneBoundingBoxDirty_ = true;
+}
+
+unsigned AnimatedModel::GetAnimationCost() const
+{
+    if (!animationDirty_)
+        return 0;
+
+    const unsigned numStates = animationStateSource_ ? animationStateSource_->GetAnimationStates().size() : 0;
+    return skeleton_.GetNumBones() * ea::max(numStates, 1u);
+}
+
 void AnimatedModel::ApplyAnimation()
 {
     // Reset skeleton, apply all animations, calculate bones' bounding box. Make sure this is only done for the master model
     // (first AnimatedModel in a node)
     if (isMaster_)
     {
+        poseInterpolated_ = false;
         InitializeLocalBoneTransforms(false);
         CalculateAnimations();
         CalculateLocalBoundingBox();
@@ -1064,6 +1289,15 @@ void AnimatedModel::ApplyAnimation()
 
 void AnimatedModel::ApplyBoneTransformsToNodes()
 {
+    for (const auto& [boneIndex, boneNode] : attachedBoneNodes_)
+    {
+        if (boneNode)
+        {
+            const Transform transform = Transform::FromMatrix3x4(skeletonData_[boneIndex].localToComponent_);
+            boneNode->SetTransformSilent(transform.position_, transform.rotation_, transform.scale_);
+        }
+    }
+
     for (unsigned boneIndex = 0; boneIndex < skeleton_.GetNumBones(); ++boneIndex)
     {
         Bone* bone = skeleton_.GetBone(boneIndex);
@@ -1076,11 +1310,57 @@ void AnimatedModel::ApplyBoneTransformsToNodes()
     node_->MarkDirty();
 }
 
+void AnimatedModel::QueueAttachedBoneNodeUpdates()
+{
+    Octree* octree = octant_->GetOctree();
+    for (const auto& [boneIndex, boneNode] : attachedBoneNodes_)
+    {
+        if (boneNode)
+            octree->QueueNodeTransformUpdate(boneNode, Transform::FromMatrix3x4(skeletonData_[boneIndex].localToComponent_));
+    }
+}
+
 void AnimatedModel::ConnectToAnimationStateSource(AnimationStateSource* source)
 {
     animationStateSource_ = source;
 }
 
+Node* AnimatedModel::GetOrCreateBoneNode(const ea::string& boneName)
+{
+    if (!node_)
+        return nullptr;
+
+    // Non-master models share bones of the master model
+    if (nodelessSkeleton_ && !isMaster_)
+    {
+        auto* master = node_->GetComponent<AnimatedModel>();
+        return master && master != this ? master->GetOrCreateBoneNode(boneName) : nullptr;
+    }
+
+    const unsigned boneIndex = skeleton_.GetBoneIndex(boneName);
+    if (boneIndex == M_MAX_UNSIGNED)
+    {
+        URHO3D_LOGERROR("Bone '{}' is not found in the skeleton", boneName);
+        return nullptr;
+    }
+
+    if (!nodelessSkeleton_)
+        return skeleton_.GetBone(boneIndex)->node_;
+
+    for (const auto& [index, boneNode] : attachedBoneNodes_)
+    {
+        if (index == boneIndex && boneNode)
+            return boneNode;
+    }
+
+    const Transform transform = Transform::FromMatrix3x4(skeletonData_[boneIndex].localToComponent_);
+    Node* boneNode = node_->CreateChild(boneName);
+    boneNode->SetTransform(transform.position_, transform.rotation_, transform.scale_);
+    boneNode->SetTemporary(IsTemporary());
+    attachedBoneNodes_.emplace_back(boneIndex, WeakPtr<Node>(boneNode));
+    return boneNode;
+}
+
 void AnimatedModel::UpdateSkinning()
 {
     // Note: the model's world transform will be baked in the skin matrices
@@ -1088,8 +1368,10 @@ void AnimatedModel::UpdateSkinning()
     // Use model's world transform in case a bone is missing
     const Matrix3x4& worldTransform = node_->GetWorldTransform();
 
+    if (nodelessSkeleton_)
+        UpdateNodelessSkinning();
     // Skinning with global matrices only
-    if (!geometrySkinMatrices_.size())
+    else if (!geometrySkinMatrices_.size())
     {
         for (unsigned i = 0; i < bones.size(); ++i)
         {
@@ -1124,6 +1406,50 @@ void AnimatedModel::UpdateSkinning()
         morphsDirty_ = true;
 }
 
+void AnimatedModel::UpdateNodelessSkinning()
+{
+    const ea::vector<Bone>& bones = skeleton_.GetBones();
+    const Matrix3x4& worldTransform = node_->GetWorldTransform();
+
+    // Non-master models use the pose of the master model, bones are matched by name
+    const ModelAnimationOutput* pose = skeletonData_.data();
+    const unsigned* mapping = nullptr;
+    if (!isMaster_)
+    {
+        auto* master = node_->GetComponent<AnimatedModel>();
+        if (master && master != this)
+        {
+            if (masterBoneMappingModel_.Get() != master->GetModel() || masterBoneMapping_.size() != bones.size())
+            {
+                masterBoneMappingModel_ = master->GetModel();
+                masterBoneMapping_.resize(bones.size());
+                for (unsigned i = 0; i < bones.size(); ++i)
+                    masterBoneMapping_[i] = master->skeleton_.GetBoneIndex(bones[i].nameHash_);
+            }
+
+            pose = master->skeletonData_.data();
+            mapping = masterBoneMapping_.data();
+            masterPoseRevision_ = master->poseRevision_;
+        }
+    }
+
+    for (unsigned i = 0; i < bones.size(); ++i)
+    {
+        const unsigned poseIndex = mapping ? mapping[i] : i;
+        if (poseIndex != M_MAX_UNSIGNED)
+            skinMatrices_[i] = worldTransform * pose[poseIndex].localToComponent_ * bones[i].offsetMatrix_;
+        else
+            skinMatrices_[i] = worldTransform;
+    }
+
+    // Copy the skin matrices to per-geometry matrices as needed
+    for (unsigned i = 0; i < geometrySkinMatrixPtrs_.size(); ++i)
+    {
+        for (Matrix3x4* dest : geometrySkinMatrixPtrs_[i])
+            *dest = skinMatrices_[i];
+    }
+}
+
 void AnimatedModel::UpdateMorphs()
 {
     auto* graphics = GetSubsystem<Graphics>();
@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include "../Graphics/AnimationScheduler.h"
 #include "../Graphics/AnimationStateSource.h"
 #include "../Graphics/Model.h"
 #include "../Graphics/Skeleton.h"
@@ -40,6 +41,7 @@ class URHO3D_API AnimatedModel : public StaticModel
     URHO3D_OBJECT(AnimatedModel, StaticModel);
 
     friend class AnimationState;
+    friend class AnimationScheduler;
 
 public:
     /// Construct.
@@ -80,6 +82,11 @@ public:
     /// Set whether to update animation and the bounding box when not visible. Recommended to enable for physically controlled models like ragdolls.
     /// @property
     void SetUpdateInvisible(bool enable);
+    /// Set whether the skeleton pose is stored without scene nodes. Existing bone nodes are removed.
+    /// Nodes for individual bones may be created on demand via GetOrCreateBoneNode.
+    /// All AnimatedModels in the node are expected to use the same mode.
+    /// @property
+    void SetNodelessSkeleton(bool enable);
     /// Set vertex morph weight by index.
     void SetMorphWeight(unsigned index, float weight);
     /// Set vertex morph weight by name.
@@ -93,6 +100,8 @@ public:
     void ResetBones();
     /// Apply all animation states to nodes.
     void ApplyAnimation();
+    /// Return node that follows the bone. In node-less skeleton mode the node is created on demand as direct child.
+    Node* GetOrCreateBoneNode(const ea::string& boneName);
     /// Connect to AnimationStateSource that provides animation states.
     void ConnectToAnimationStateSource(AnimationStateSource* source);
 
@@ -103,11 +112,20 @@ public:
     /// Return animation LOD bias.
     /// @property
     float GetAnimationLodBias() const { return animationLodBias_; }
+    /// Return animation update schedule assigned by AnimationScheduler for the current frame.
+    const AnimationSchedule& GetAnimationSchedule() const { return animationSchedule_; }
 
     /// Return whether to update animation when not visible.
     /// @property
     bool GetUpdateInvisible() const { return updateInvisible_; }
 
+    /// Return whether the skeleton pose is stored without scene nodes.
+    /// @property
+    bool GetNodelessSkeleton() const { return nodelessSkeleton_; }
+
+    /// Return local-to-component transform of the bone in the last calculated pose.
+    const Matrix3x4& GetBoneModelTransform(unsigned index) const { return skeletonData_[index].localToComponent_; }
+
     /// Return all vertex morphs.
     const ea::vector<ModelMorph>& GetMorphs() const { return morphs_; }
 
@@ -145,6 +163,9 @@ public:
     /// Return per-geometry bone mappings.
     const ea::vector<ea::vector<unsigned> >& GetGeometryBoneMappings() const { return geometryBoneMappings_; }
 
+    /// Return global skin matrices.
+    const ea::vector<Matrix3x4>& GetSkinMatrices() const { return skinMatrices_; }
+
     /// Return per-geometry skin matrices. If empty, uses global skinning.
     const ea::vector<ea::vector<Matrix3x4> >& GetGeometrySkinMatrices() const { return geometrySkinMatrices_; }
 
@@ -154,6 +175,8 @@ public:
 protected:
     /// Handle node being assigned.
     void OnNodeSet(Node* previousNode, Node* currentNode) override;
+    /// Handle scene being assigned.
+    void OnSceneSet(Scene* previousScene, Scene* scene) override;
     /// Handle node transform being dirtied.
     void OnMarkedDirty(Node* node) override;
     /// Recalculate the world-space bounding box.
@@ -180,6 +203,12 @@ private:
     void HandleModelReloadFinished(StringHash eventType, VariantMap& eventData);
     /// Reconsider whether to use software skinning.
     void UpdateSoftwareSkinningState();
+    /// Find direct child nodes that follow bones in node-less skeleton mode.
+    void AssignAttachedBoneNodes();
+    /// Return whether the skinning should follow updated pose of the master model.
+    bool IsMasterPoseChanged() const;
+    /// Return estimated cost of animation evaluation for AnimationScheduler. 0 if there's nothing to evaluate.
+    unsigned GetAnimationCost() const;
 
     /// Animation update sequence. Called from Update whenever possible, and from UpdateGeometry in other cases.
     /// @{
@@ -190,9 +219,13 @@ private:
     void CalculateFinalBoneTransforms();
     void CalculateLocalBoundingBox();
     void CalculateAnimations();
+    void CalculateScheduledAnimations();
+    void InterpolatePose();
     void ApplyBoneTransformsToNodes();
+    void QueueAttachedBoneNodeUpdates();
 
     void UpdateSkinning();
+    void UpdateNodelessSkinning();
     void UpdateMorphs();
     /// @}
 
@@ -246,6 +279,30 @@ private:
     bool assignBonesPending_;
     /// Force animation update after becoming visible flag.
     bool forceAnimationUpdate_;
+
+    /// Node-less skeleton mode flag.
+    bool nodelessSkeleton_{};
+    /// Nodes that follow bones in node-less skeleton mode.
+    ea::vector<ea::pair<unsigned, WeakPtr<Node>>> attachedBoneNodes_;
+    /// Revision of local-to-component bone transforms, incremented whenever they are recalculated.
+    unsigned poseRevision_{};
+    /// Revision of the master model pose used for the last skinning update.
+    unsigned masterPoseRevision_{};
+    /// Model of the master model used to build the bone mapping.
+    WeakPtr<Model> masterBoneMappingModel_;
+    /// Mapping from own bone indices to bone indices of the master model.
+    ea::vector<unsigned> masterBoneMapping_;
+
+    /// Scheduler of animation updates.
+    WeakPtr<AnimationScheduler> animationScheduler_;
+    /// Animation update decision for the current frame.
+    AnimationSchedule animationSchedule_;
+    /// Whether the pose is being interpolated between evaluated poses.
+    bool poseInterpolated_{};
+    /// Pose to interpolate from.
+    ea::vector<Transform> interpolationSource_;
+    /// The last evaluated pose to interpolate to.
+    ea::vector<Transform> interpolationTarget_;
 };
 
 }
@@ -68,6 +68,51 @@ void ReadTransform(Deserializer& source, Transform& transform, AnimationChannelF
         transform.scale_ = source.ReadVector3();
 }
 
+/// Return size of serialized key frame with given channels.
+unsigned GetKeyFrameSize(AnimationChannelFlags channelMask)
+{
+    unsigned size = sizeof(float);
+    if (channelMask & CHANNEL_POSITION)
+        size += 3 * sizeof(float);
+    if (channelMask & CHANNEL_ROTATION)
+        size += 4 * sizeof(float);
+    if (channelMask & CHANNEL_SCALE)
+        size += 3 * sizeof(float);
+    return size;
+}
+
+/// Read key frames directly from memory, in the same format as ReadTransform does.
+void ReadKeyFrames(const unsigned char* data, ea::vector<AnimationKeyFrame>& keyFrames, AnimationChannelFlags channelMask)
+{
+    float values[4];
+    const auto readValues = [&](unsigned count)
+    {
+        memcpy(values, data, count * sizeof(float));
+        data += count * sizeof(float);
+    };
+
+    for (AnimationKeyFrame& keyFrame : keyFrames)
+    {
+        readValues(1);
+        keyFrame.time_ = values[0];
+        if (channelMask & CHANNEL_POSITION)
+        {
+            readValues(3);
+            keyFrame.position_ = Vector3(values);
+        }
+        if (channelMask & CHANNEL_ROTATION)
+        {
+            readValues(4);
+            keyFrame.rotation_ = Quaternion(values);
+        }
+        if (channelMask & CHANNEL_SCALE)
+        {
+            readValues(3);
+            keyFrame.scale_ = Vector3(values);
+        }
+    }
+}
+
 void WriteTransform(Serializer& dest, const Transform& transform, AnimationChannelFlags channelMask)
 {
     if (channelMask & CHANNEL_POSITION)
@@ -269,10 +314,28 @@ bool Animation::BeginLoad(Deserializer& source)
             newTrack->scaleWeight_ = weight;
         }
 
+        if (version >= compressedTrackVersion && source.ReadBool())
+        {
+            newTrack->compressedKeyFrames_.Read(source);
+            memoryUse += newTrack->compressedKeyFrames_.GetDataSize();
+            continue;
+        }
+
         const unsigned keyFrames = source.ReadUInt();
         newTrack->keyFrames_.resize(keyFrames);
         memoryUse += keyFrames * sizeof(AnimationKeyFrame);
 
+        // Parse keyframes directly from memory if possible
+        const unsigned position = source.GetPosition();
+        const unsigned keyFramesSize = keyFrames * GetKeyFrameSize(newTrack->channelMask_);
+        const unsigned char* contiguousData = source.GetContiguousData();
+        if (contiguousData && position + keyFramesSize <= source.GetSize())
+        {
+            ReadKeyFrames(contiguousData + position, newTrack->keyFrames_, newTrack->channelMask_);
+            source.Seek(position + keyFramesSize);
+            continue;
+        }
+
         // Read keyframes of the track
         for (unsigned j = 0; j < keyFrames; ++j)
         {
@@ -379,6 +442,13 @@ bool Animation::Save(Serializer& dest) const
         dest.WriteFloat(track.positionWeight_);
         dest.WriteFloat(track.rotationWeight_);
         dest.WriteFloat(track.scaleWeight_);
+        dest.WriteBool(track.IsCompressed());
+        if (track.IsCompressed())
+        {
+            track.compressedKeyFrames_.Write(dest);
+            continue;
+        }
+
         dest.WriteUInt(track.keyFrames_.size());
 
         // Write keyframes of the track
@@ -633,4 +703,20 @@ void Animation::SetTracks(const ea::vector<AnimationTrack>& tracks)
     }
 }
 
+AnimationCompressionStats Animation::CompressTracks(const AnimationCompressionSettings& settings)
+{
+    MarkRevisionUpdated();
+
+    AnimationCompressionStats stats;
+    unsigned memoryUse = GetMemoryUse();
+    for (auto& [nameHash, track] : tracks_)
+    {
+        const AnimationCompressionStats trackStats = track.Compress(settings);
+        memoryUse -= ea::min(memoryUse, trackStats.originalSize_ - trackStats.compressedSize_);
+        stats.Merge(trackStats);
+    }
+    SetMemoryUse(memoryUse);
+    return stats;
+}
+
 }
@@ -144,6 +144,8 @@ public:
 
     /// Set all animation tracks.
     void SetTracks(const ea::vector<AnimationTrack>& tracks);
+    /// Compress all animation tracks. Return total size and max error of compression.
+    AnimationCompressionStats CompressTracks(const AnimationCompressionSettings& settings);
 
 private:
     void LoadTracksFromXML(const XMLElement& source);
@@ -156,8 +158,9 @@ private:
     static const unsigned variantTrackVersion = 2; // VariantAnimationTrack support added here
     static const unsigned trackWeightVersion = 3; // Per-track weights added here
     static const unsigned channelWeightVersion = 4; // Per-channel weights added here
+    static const unsigned compressedTrackVersion = 5; // Compressed tracks added here
 
-    static const unsigned currentVersion = channelWeightVersion;
+    static const unsigned currentVersion = compressedTrackVersion;
     /// @}
 
     /// Animation name.
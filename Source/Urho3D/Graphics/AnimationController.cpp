@@ -102,6 +102,18 @@ bool IsFilteredOut(const AnimationParameters& params, ea::span<const unsigned> l
     return !layers.empty() && ea::find(layers.begin(), layers.end(), params.layer_) == layers.end();
 }
 
+bool IsBoneChildOf(const Skeleton& skeleton, unsigned boneIndex, unsigned parentIndex)
+{
+    const ea::vector<Bone>& bones = skeleton.GetBones();
+    while (bones[boneIndex].parentIndex_ != boneIndex)
+    {
+        boneIndex = bones[boneIndex].parentIndex_;
+        if (boneIndex == parentIndex)
+            return true;
+    }
+    return false;
+}
+
 } // namespace
 
 const AnimationParameters AnimationParameters::EMPTY {};
@@ -1245,6 +1257,11 @@ void AnimationController::UpdateAnimationStateTracks(AnimationState* state)
     if (!startNode)
         startNode = node_;
 
+    // Bones of node-less skeleton are filtered by the start bone in the skeleton itself
+    const bool nodelessSkeleton = model && model->GetNodelessSkeleton();
+    const unsigned startBoneIndex = nodelessSkeleton && !startBoneName.empty()
+        ? model->GetSkeleton().GetBoneIndex(startBoneName) : M_MAX_UNSIGNED;
+
     // Setup model and node tracks
     const auto& tracks = animation->GetTracks();
     for (const auto& item : tracks)
@@ -1254,7 +1271,10 @@ void AnimationController::UpdateAnimationStateTracks(AnimationState* state)
         // Try to find bone first, filter by start bone node
         const unsigned trackBoneIndex = model ? model->GetSkeleton().GetBoneIndex(track.nameHash_) : M_MAX_UNSIGNED;
         Bone* trackBone = trackBoneIndex != M_MAX_UNSIGNED ? model->GetSkeleton().GetBone(trackBoneIndex) : nullptr;
-        if (trackBone && trackBone->node_ && (startNode == node_ || trackBone->node_->IsChildOf(startNode)))
+        const bool isBoneTrack = !trackBone ? false
+            : nodelessSkeleton ? startBoneIndex == M_MAX_UNSIGNED || IsBoneChildOf(model->GetSkeleton(), trackBoneIndex, startBoneIndex)
+            : trackBone->node_ && (startNode == node_ || trackBone->node_->IsChildOf(startNode));
+        if (isBoneTrack)
         {
             ModelAnimationStateTrack stateTrack;
             stateTrack.track_ = &track;
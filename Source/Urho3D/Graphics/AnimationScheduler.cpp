@@ -0,0 +1,227 @@
+//
+// Copyright (c) 2017-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "Urho3D/Precompiled.h"
+
+#include "Urho3D/Graphics/AnimationScheduler.h"
+
+#include "Urho3D/Core/CoreEvents.h"
+#include "Urho3D/Core/Profiler.h"
+#include "Urho3D/Core/Timer.h"
+#include "Urho3D/Graphics/AnimatedModel.h"
+
+#include <EASTL/sort.h>
+
+#include "Urho3D/DebugNew.h"
+
+namespace Urho3D
+{
+
+AnimationScheduler::AnimationScheduler(Context* context)
+    : Object(context)
+{
+    SubscribeToEvent(E_POSTUPDATE, URHO3D_HANDLER(AnimationScheduler, HandlePostUpdate));
+}
+
+AnimationScheduler::~AnimationScheduler()
+{
+    for (AnimatedModel* model : models_)
+        model->animationSchedule_ = AnimationSchedule{};
+}
+
+void AnimationScheduler::AddModel(AnimatedModel* model)
+{
+    AnimationSchedule& schedule = model->animationSchedule_;
+    if (schedule.index_ != M_MAX_UNSIGNED)
+        return;
+
+    schedule = AnimationSchedule{};
+    schedule.index_ = models_.size();
+    models_.push_back(model);
+}
+
+void AnimationScheduler::RemoveModel(AnimatedModel* model)
+{
+    AnimationSchedule& schedule = model->animationSchedule_;
+    const unsigned index = schedule.index_;
+    if (index == M_MAX_UNSIGNED)
+        return;
+
+    URHO3D_ASSERT(models_[index] == model);
+    if (index + 1 != models_.size())
+    {
+        models_[index] = models_.back();
+        models_[index]->animationSchedule_.index_ = index;
+    }
+    models_.pop_back();
+    schedule = AnimationSchedule{};
+}
+
+void AnimationScheduler::Schedule(unsigned frameNumber, float timeStep)
+{
+    URHO3D_PROFILE("ScheduleAnimations");
+
+    UpdateCostEstimate();
+
+    const long long animationTime = stats_.animationTime_;
+    stats_ = AnimationSchedulerStats{};
+    stats_.animationTime_ = animationTime;
+
+    // Collect models due for update
+    candidates_.clear();
+    for (AnimatedModel* model : models_)
+    {
+        AnimationSchedule& schedule = model->animationSchedule_;
+        schedule.scheduled_ = enabled_;
+        schedule.update_ = true;
+        schedule.interpolationFactor_ = 1.0f;
+        if (!enabled_)
+            continue;
+
+        // Invisible models are not updated at all unless requested, the model handles it on its own
+        const bool isVisible = model->viewFrameNumber_ == 0 || frameNumber - model->viewFrameNumber_ <= 1;
+        if (!isVisible && !model->updateInvisible_)
+        {
+            schedule.scheduled_ = false;
+            continue;
+        }
+
+        const unsigned tier = isVisible ? GetModelTier(model, timeStep) : MAX_ANIMATION_LOD_TIERS;
+        const unsigned interval = isVisible ? 1u << tier : invisibleUpdateInterval_;
+        if (tier != schedule.tier_ || interval != schedule.interval_)
+        {
+            schedule.tier_ = tier;
+            schedule.interval_ = interval;
+            schedule.phase_ = nextPhase_[tier]++ % interval;
+        }
+
+        // Deferred models are updated as soon as possible, others wait for their phase
+        const unsigned framesSinceUpdate = frameNumber - schedule.lastUpdateFrame_;
+        const bool isDue = interval == 1 || schedule.lastUpdateFrame_ == 0 || framesSinceUpdate > interval
+            || (framesSinceUpdate > 0 && (frameNumber + schedule.phase_) % interval == 0);
+        if (!isDue)
+        {
+            schedule.update_ = false;
+            continue;
+        }
+
+        Candidate candidate;
+        candidate.model_ = model;
+        candidate.staleness_ = static_cast<float>(framesSinceUpdate) / interval;
+        candidate.cost_ = model->GetAnimationCost();
+        candidates_.push_back(candidate);
+    }
+
+    // Keep time budget, the most stale models go first
+    const bool hasBudget = timeBudget_ > 0.0f && timePerCost_ > 0.0f;
+    const double maxCost = hasBudget ? timeBudget_ * 1000.0 / timePerCost_ : 0.0;
+    if (hasBudget)
+    {
+        const auto compare = [](const Candidate& lhs, const Candidate& rhs) { return lhs.staleness_ > rhs.staleness_; };
+        ea::sort(candidates_.begin(), candidates_.end(), compare);
+    }
+
+    scheduledCost_ = 0;
+    for (const Candidate& candidate : candidates_)
+    {
+        AnimationSchedule& schedule = candidate.model_->animationSchedule_;
+        if (hasBudget && candidate.cost_ > 0 && scheduledCost_ > 0 && scheduledCost_ + candidate.cost_ > maxCost)
+        {
+            schedule.update_ = false;
+            ++GetTierStats(schedule.tier_).numDeferred_;
+            continue;
+        }
+
+        scheduledCost_ += candidate.cost_;
+        schedule.lastUpdateFrame_ = frameNumber;
+    }
+
+    // Assign interpolation factors and collect counters
+    for (AnimatedModel* model : models_)
+    {
+        AnimationSchedule& schedule = model->animationSchedule_;
+        if (!schedule.scheduled_)
+            continue;
+
+        if (interpolationEnabled_ && schedule.interval_ > 1)
+        {
+            const unsigned framesSinceUpdate = frameNumber - schedule.lastUpdateFrame_;
+            schedule.interpolationFactor_ = Min(1.0f, (framesSinceUpdate + 1.0f) / schedule.interval_);
+        }
+
+        AnimationLodTierStats& tierStats = GetTierStats(schedule.tier_);
+        ++tierStats.numModels_;
+        if (schedule.update_ && model->animationDirty_)
+            ++tierStats.numUpdated_;
+
+        // Interpolation should proceed even if the animation is not changed anymore
+        if (model->poseInterpolated_)
+        {
+            ++tierStats.numInterpolated_;
+            model->MarkForUpdate();
+        }
+    }
+}
+
+void AnimationScheduler::HandlePostUpdate(StringHash eventType, VariantMap& eventData)
+{
+    using namespace PostUpdate;
+
+    const unsigned frameNumber = GetSubsystem<Time>()->GetFrameNumber();
+    Schedule(frameNumber, eventData[P_TIMESTEP].GetFloat());
+}
+
+void AnimationScheduler::UpdateCostEstimate()
+{
+    const long long animationTime = animationTime_.exchange(0, std::memory_order_relaxed);
+    stats_.animationTime_ = animationTime;
+
+    if (scheduledCost_ > 0 && animationTime > 0)
+    {
+        const float timePerCost = static_cast<float>(animationTime) / scheduledCost_;
+        timePerCost_ = timePerCost_ > 0.0f ? Lerp(timePerCost_, timePerCost, 0.1f) : timePerCost;
+    }
+}
+
+AnimationLodTierStats& AnimationScheduler::GetTierStats(unsigned tier)
+{
+    return tier < MAX_ANIMATION_LOD_TIERS ? stats_.tiers_[tier] : stats_.invisible_;
+}
+
+unsigned AnimationScheduler::GetModelTier(const AnimatedModel* model, float timeStep) const
+{
+    const AnimationStateSource* animationStateSource = model->animationStateSource_;
+    const bool throttlingAllowed = !animationStateSource || animationStateSource->IsAnimationThrottlingAllowed();
+    const float lodBias = model->animationLodBias_;
+    const float lodDistance = model->animationLodDistance_;
+    if (!throttlingAllowed || lodBias <= 0.0f || lodDistance <= 0.0f || timeStep <= 0.0f)
+        return 0;
+
+    // Same rate as per-model LOD timer, rounded down to power of two
+    const float intervalFrames = lodDistance / (lodBias * timeStep * ANIMATION_LOD_BASESCALE);
+    unsigned tier = 0;
+    while (tier + 1 < MAX_ANIMATION_LOD_TIERS && intervalFrames >= static_cast<float>(2u << tier))
+        ++tier;
+    return tier;
+}
+
+}
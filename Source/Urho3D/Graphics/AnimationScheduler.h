@@ -0,0 +1,177 @@
+//
+// Copyright (c) 2017-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/// \file
+
+#pragma once
+
+#include "Urho3D/Core/Object.h"
+
+#include <EASTL/vector.h>
+
+#include <atomic>
+
+namespace Urho3D
+{
+
+class AnimatedModel;
+
+/// Number of animation LOD tiers. Visible models in tier N are updated every 2^N frames.
+static const unsigned MAX_ANIMATION_LOD_TIERS = 4;
+
+/// Per-model state of AnimationScheduler. Written on the main thread before drawable update.
+struct AnimationSchedule
+{
+    /// Index of the model in the scheduler. M_MAX_UNSIGNED if not registered.
+    unsigned index_{M_MAX_UNSIGNED};
+    /// Whether the schedule is used instead of per-model LOD timer this frame.
+    bool scheduled_{};
+    /// Whether the animation should be evaluated this frame.
+    bool update_{true};
+    /// Factor of interpolation from the previous pose to the last evaluated pose. 1 if there's nothing to interpolate.
+    float interpolationFactor_{1.0f};
+    /// LOD tier. MAX_ANIMATION_LOD_TIERS for models updated when invisible.
+    unsigned tier_{};
+    /// Update interval in frames.
+    unsigned interval_{1};
+    /// Frame offset used to spread updates of the tier evenly across frames.
+    unsigned phase_{};
+    /// Frame number of the last scheduled update.
+    unsigned lastUpdateFrame_{};
+};
+
+/// Animation update counters of LOD tier for the last frame.
+struct AnimationLodTierStats
+{
+    /// Number of models in the tier.
+    unsigned numModels_{};
+    /// Number of models that evaluated animation.
+    unsigned numUpdated_{};
+    /// Number of models that interpolated between evaluated poses.
+    unsigned numInterpolated_{};
+    /// Number of models that were due for update but were deferred to keep time budget.
+    unsigned numDeferred_{};
+};
+
+/// Animation update counters for the last frame.
+struct AnimationSchedulerStats
+{
+    /// Counters of visible models per LOD tier.
+    AnimationLodTierStats tiers_[MAX_ANIMATION_LOD_TIERS];
+    /// Counters of invisible models that are updated anyway.
+    AnimationLodTierStats invisible_;
+    /// Time spent on animation evaluation during the last frame, in microseconds.
+    long long animationTime_{};
+};
+
+/// Subsystem that schedules animation updates of all AnimatedModels.
+/// Update rate of each model is assigned from animation LOD distance, which accounts for screen size and distance,
+/// and from animation LOD bias that serves as importance. Updates of the same tier are spread evenly across frames,
+/// skipped frames are optionally interpolated, and animation evaluation is limited by per-frame time budget.
+class URHO3D_API AnimationScheduler : public Object
+{
+    URHO3D_OBJECT(AnimationScheduler, Object);
+
+public:
+    /// Construct.
+    explicit AnimationScheduler(Context* context);
+    /// Destruct.
+    ~AnimationScheduler() override;
+
+    /// Set whether the scheduler is used. Models use their own LOD timers if disabled.
+    void SetEnabled(bool enabled) { enabled_ = enabled; }
+    /// Set time budget of animation evaluation per frame in milliseconds. 0 means unlimited.
+    void SetTimeBudget(float budgetMs) { timeBudget_ = Max(budgetMs, 0.0f); }
+    /// Set whether to interpolate between evaluated poses on skipped frames.
+    void SetInterpolationEnabled(bool enabled) { interpolationEnabled_ = enabled; }
+    /// Set update interval in frames for invisible models that are updated when invisible.
+    void SetInvisibleUpdateInterval(unsigned interval) { invisibleUpdateInterval_ = Max(interval, 1u); }
+
+    /// Return whether the scheduler is used.
+    bool IsEnabled() const { return enabled_; }
+    /// Return time budget of animation evaluation per frame in milliseconds.
+    float GetTimeBudget() const { return timeBudget_; }
+    /// Return whether to interpolate between evaluated poses on skipped frames.
+    bool IsInterpolationEnabled() const { return interpolationEnabled_; }
+    /// Return update interval in frames for invisible models.
+    unsigned GetInvisibleUpdateInterval() const { return invisibleUpdateInterval_; }
+    /// Return counters of the last frame.
+    const AnimationSchedulerStats& GetStats() const { return stats_; }
+    /// Return number of registered models.
+    unsigned GetNumModels() const { return models_.size(); }
+
+    /// Register model. Called by AnimatedModel.
+    void AddModel(AnimatedModel* model);
+    /// Unregister model. Called by AnimatedModel.
+    void RemoveModel(AnimatedModel* model);
+    /// Add time spent on animation evaluation. May be called from worker threads.
+    void ReportAnimationTime(long long usec) { animationTime_.fetch_add(usec, std::memory_order_relaxed); }
+    /// Assign updates for the frame. Called automatically on post-update.
+    void Schedule(unsigned frameNumber, float timeStep);
+
+private:
+    /// Model due for update.
+    struct Candidate
+    {
+        AnimatedModel* model_{};
+        /// Number of frames since the last update divided by update interval.
+        float staleness_{};
+        /// Estimated cost of animation evaluation.
+        unsigned cost_{};
+    };
+
+    /// Handle post-update event.
+    void HandlePostUpdate(StringHash eventType, VariantMap& eventData);
+    /// Collect counters of the previous frame and update cost estimate.
+    void UpdateCostEstimate();
+    /// Return counters of LOD tier.
+    AnimationLodTierStats& GetTierStats(unsigned tier);
+    /// Return LOD tier of the model.
+    unsigned GetModelTier(const AnimatedModel* model, float timeStep) const;
+
+    /// Whether the scheduler is used.
+    bool enabled_{true};
+    /// Time budget per frame in milliseconds.
+    float timeBudget_{};
+    /// Whether to interpolate skipped frames.
+    bool interpolationEnabled_{true};
+    /// Update interval for invisible models.
+    unsigned invisibleUpdateInterval_{8};
+
+    /// Registered models.
+    ea::vector<AnimatedModel*> models_;
+    /// Next phase to assign per tier, including invisible tier.
+    unsigned nextPhase_[MAX_ANIMATION_LOD_TIERS + 1]{};
+    /// Models due for update this frame.
+    ea::vector<Candidate> candidates_;
+
+    /// Time spent on animation evaluation since the last scheduling.
+    std::atomic<long long> animationTime_{};
+    /// Estimated cost of animation updated during the last frame.
+    unsigned long long scheduledCost_{};
+    /// Estimated time per unit of cost in microseconds.
+    float timePerCost_{};
+    /// Counters of the last frame.
+    AnimationSchedulerStats stats_;
+};
+
+}
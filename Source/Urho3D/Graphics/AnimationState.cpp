@@ -283,7 +283,7 @@ void AnimationState::CalculateAttributeTracks(ea::unordered_map<AnimatedAttribut
 void AnimationState::CalculateTransformTrack(
     NodeAnimationOutput& output, const AnimationTrack& track, unsigned& frame, float baseWeight) const
 {
-    if (track.keyFrames_.empty())
+    if (track.IsEmpty())
         return;
 
     const float positionWeight = baseWeight * track.positionWeight_;
@@ -294,7 +294,7 @@ void AnimationState::CalculateTransformTrack(
     const bool isFullRotationWeight = Equals(rotationWeight, 1.0f);
     const bool isFullScaleWeight = Equals(scaleWeight, 1.0f);
 
-    const AnimationKeyFrame& baseValue = track.keyFrames_.front();
+    const Transform& baseValue = track.GetFirstValue();
 
     Transform sampledValue;
     track.Sample(time_, animation_->GetLength(), looped_, frame, sampledValue);
@@ -24,14 +24,438 @@
 
 #include "../Graphics/AnimationTrack.h"
 #include "../IO/ArchiveSerialization.h"
+#include "../IO/Deserializer.h"
+#include "../IO/Serializer.h"
 
 #include "../DebugNew.h"
 
 namespace Urho3D
 {
 
+namespace
+{
+
+/// Max value of 16-bit quantized value.
+const float maxQuantizedValue = 65535.0f;
+/// Max value of 15-bit quantized rotation component. The highest bit is used to store index of the largest component.
+const float maxQuantizedRotationComponent = 32767.0f;
+/// Max absolute value of any component of normalized quaternion except the largest one.
+const float maxSmallestComponent = 0.70710678f;
+
+unsigned short QuantizeUnorm(float value, float maxValue)
+{
+    return static_cast<unsigned short>(RoundToInt(Clamp(value, 0.0f, 1.0f) * maxValue));
+}
+
+float DequantizeUnorm(unsigned value, float maxValue)
+{
+    return value / maxValue;
+}
+
+void QuantizeVector3(const Vector3& value, const Vector3& minValue, const Vector3& range, unsigned short* dest)
+{
+    for (unsigned i = 0; i < 3; ++i)
+    {
+        const float normalized = range.Data()[i] > 0.0f ? (value.Data()[i] - minValue.Data()[i]) / range.Data()[i] : 0.0f;
+        dest[i] = QuantizeUnorm(normalized, maxQuantizedValue);
+    }
+}
+
+Vector3 DequantizeVector3(const unsigned short* source, const Vector3& minValue, const Vector3& range)
+{
+    return minValue + range * Vector3{
+        DequantizeUnorm(source[0], maxQuantizedValue),
+        DequantizeUnorm(source[1], maxQuantizedValue),
+        DequantizeUnorm(source[2], maxQuantizedValue)};
+}
+
+/// Pack rotation with smallest-three method: three smallest components are stored as 15-bit values,
+/// index of the largest component is stored in the highest bits of the first two values.
+void QuantizeRotation(const Quaternion& value, unsigned short* dest)
+{
+    const Quaternion rotation = value.Normalized();
+    const float components[4] = {rotation.w_, rotation.x_, rotation.y_, rotation.z_};
+
+    unsigned largestIndex = 0;
+    for (unsigned i = 1; i < 4; ++i)
+    {
+        if (Abs(components[i]) > Abs(components[largestIndex]))
+            largestIndex = i;
+    }
+
+    // q and -q are the same rotation, so the largest component is always positive and can be restored from the others
+    const float sign = components[largestIndex] < 0.0f ? -1.0f : 1.0f;
+    unsigned destIndex = 0;
+    for (unsigned i = 0; i < 4; ++i)
+    {
+        if (i == largestIndex)
+            continue;
+
+        const float normalized = (components[i] * sign / maxSmallestComponent + 1.0f) * 0.5f;
+        dest[destIndex++] = QuantizeUnorm(normalized, maxQuantizedRotationComponent);
+    }
+
+    dest[0] |= (largestIndex & 1) << 15;
+    dest[1] |= (largestIndex >> 1) << 15;
+}
+
+Quaternion DequantizeRotation(const unsigned short* source)
+{
+    const unsigned largestIndex = (source[0] >> 15) | ((source[1] >> 15) << 1);
+
+    float components[4]{};
+    float sumSquared = 0.0f;
+    unsigned sourceIndex = 0;
+    for (unsigned i = 0; i < 4; ++i)
+    {
+        if (i == largestIndex)
+            continue;
+
+        const float normalized = DequantizeUnorm(source[sourceIndex++] & 0x7fff, maxQuantizedRotationComponent);
+        components[i] = (normalized * 2.0f - 1.0f) * maxSmallestComponent;
+        sumSquared += components[i] * components[i];
+    }
+    components[largestIndex] = Sqrt(Max(0.0f, 1.0f - sumSquared));
+
+    return {components[0], components[1], components[2], components[3]};
+}
+
+/// Return rotation error in degrees. Acos of dot product is too imprecise for small angles in single precision.
+float GetRotationError(const Quaternion& lhs, const Quaternion& rhs)
+{
+    const Quaternion delta = lhs.Normalized().Conjugate() * rhs.Normalized();
+    return 2.0f * Atan2(Vector3{delta.x_, delta.y_, delta.z_}.Length(), Abs(delta.w_));
+}
+
+/// Return whether the keyframe can be restored from neighbor keyframes within tolerance.
+bool IsKeyFrameInterpolated(const AnimationKeyFrame& keyFrame, const AnimationKeyFrame& prevKeyFrame,
+    const AnimationKeyFrame& nextKeyFrame, AnimationChannelFlags channelMask, const AnimationCompressionSettings& settings)
+{
+    const float timeInterval = nextKeyFrame.time_ - prevKeyFrame.time_;
+    const float factor = timeInterval > 0.0f ? (keyFrame.time_ - prevKeyFrame.time_) / timeInterval : 0.0f;
+
+    if (channelMask.Test(CHANNEL_POSITION))
+    {
+        const Vector3 position = prevKeyFrame.position_.Lerp(nextKeyFrame.position_, factor);
+        if ((position - keyFrame.position_).Length() > settings.positionTolerance_)
+            return false;
+    }
+    if (channelMask.Test(CHANNEL_ROTATION))
+    {
+        const Quaternion rotation = prevKeyFrame.rotation_.Slerp(nextKeyFrame.rotation_, factor);
+        if (GetRotationError(rotation, keyFrame.rotation_) > settings.rotationTolerance_)
+            return false;
+    }
+    if (channelMask.Test(CHANNEL_SCALE))
+    {
+        const Vector3 scale = prevKeyFrame.scale_.Lerp(nextKeyFrame.scale_, factor);
+        if ((scale - keyFrame.scale_).Length() > settings.scaleTolerance_)
+            return false;
+    }
+    return true;
+}
+
+/// Return whether all keyframes between first and last can be removed.
+/// Kept keyframes are taken after quantization, so the tolerance accounts for quantization error too.
+bool IsSegmentInterpolated(ea::span<const AnimationKeyFrame> keyFrames, ea::span<const AnimationKeyFrame> decodedKeyFrames,
+    unsigned first, unsigned last, AnimationChannelFlags channelMask, const AnimationCompressionSettings& settings)
+{
+    for (unsigned i = first + 1; i < last; ++i)
+    {
+        if (!IsKeyFrameInterpolated(keyFrames[i], decodedKeyFrames[first], decodedKeyFrames[last], channelMask, settings))
+            return false;
+    }
+    return true;
+}
+
+void GetVector3Range(const Vector3& value, Vector3& minValue, Vector3& maxValue)
+{
+    minValue = VectorMin(minValue, value);
+    maxValue = VectorMax(maxValue, value);
+}
+
+}
+
+void AnimationCompressionStats::Merge(const AnimationCompressionStats& other)
+{
+    originalKeyFrames_ += other.originalKeyFrames_;
+    compressedKeyFrames_ += other.compressedKeyFrames_;
+    originalSize_ += other.originalSize_;
+    compressedSize_ += other.compressedSize_;
+    maxPositionError_ = Max(maxPositionError_, other.maxPositionError_);
+    maxRotationError_ = Max(maxRotationError_, other.maxRotationError_);
+    maxScaleError_ = Max(maxScaleError_, other.maxScaleError_);
+}
+
+void CompressedAnimationTrack::Compress(ea::span<const AnimationKeyFrame> keyFrames, AnimationChannelFlags channelMask,
+    const AnimationCompressionSettings& settings)
+{
+    Clear();
+    if (keyFrames.empty())
+        return;
+
+    // Evaluate ranges
+    Vector3 positionMax{-M_INFINITY, -M_INFINITY, -M_INFINITY};
+    Vector3 scaleMax{-M_INFINITY, -M_INFINITY, -M_INFINITY};
+    positionMin_ = Vector3{M_INFINITY, M_INFINITY, M_INFINITY};
+    scaleMin_ = Vector3{M_INFINITY, M_INFINITY, M_INFINITY};
+    for (const AnimationKeyFrame& keyFrame : keyFrames)
+    {
+        GetVector3Range(keyFrame.position_, positionMin_, positionMax);
+        GetVector3Range(keyFrame.scale_, scaleMin_, scaleMax);
+    }
+    positionRange_ = positionMax - positionMin_;
+    scaleRange_ = scaleMax - scaleMin_;
+
+    const unsigned lastIndex = keyFrames.size() - 1;
+    numKeyFrames_ = keyFrames.size();
+    channelMask_ = channelMask;
+    startTime_ = keyFrames[0].time_;
+    timeRange_ = keyFrames[lastIndex].time_ - startTime_;
+    UpdateLayout();
+
+    // Write interleaved keyframes
+    data_.resize(numKeyFrames_ * stride_);
+    unsigned short* dest = data_.data();
+    for (const AnimationKeyFrame& keyFrame : keyFrames)
+    {
+        dest[0] = QuantizeUnorm(timeRange_ > 0.0f ? (keyFrame.time_ - startTime_) / timeRange_ : 0.0f, maxQuantizedValue);
+        dest += 1;
+
+        if (channelMask_.Test(CHANNEL_POSITION))
+        {
+            QuantizeVector3(keyFrame.position_, positionMin_, positionRange_, dest);
+            dest += 3;
+        }
+        if (channelMask_.Test(CHANNEL_ROTATION))
+        {
+            QuantizeRotation(keyFrame.rotation_, dest);
+            dest += 3;
+        }
+        if (channelMask_.Test(CHANNEL_SCALE))
+        {
+            QuantizeVector3(keyFrame.scale_, scaleMin_, scaleRange_, dest);
+            dest += 3;
+        }
+    }
+
+    // Decode keyframes back so the error of removed keyframes is measured against what will be sampled
+    ea::vector<AnimationKeyFrame> decodedKeyFrames(numKeyFrames_);
+    for (unsigned i = 0; i < numKeyFrames_; ++i)
+    {
+        const Transform value = GetKeyFrameValue(i);
+        decodedKeyFrames[i] = AnimationKeyFrame{GetKeyFrameTime(i), value.position_, value.rotation_, value.scale_};
+    }
+
+    // Greedily extend each segment while removed keyframes stay within tolerance
+    ea::vector<unsigned> keptIndices{0u};
+    unsigned first = 0;
+    while (first < lastIndex)
+    {
+        unsigned last = first + 1;
+        while (last < lastIndex
+            && IsSegmentInterpolated(keyFrames, decodedKeyFrames, first, last + 1, channelMask, settings))
+            ++last;
+        keptIndices.push_back(last);
+        first = last;
+    }
+
+    // Keep only selected keyframes, indices are increasing so data may be moved in-place
+    for (unsigned i = 0; i < keptIndices.size(); ++i)
+    {
+        const unsigned short* source = &data_[keptIndices[i] * stride_];
+        ea::copy(source, source + stride_, &data_[i * stride_]);
+    }
+    numKeyFrames_ = keptIndices.size();
+    data_.resize(numKeyFrames_ * stride_);
+
+    firstValue_ = GetKeyFrameValue(0);
+}
+
+void CompressedAnimationTrack::Clear()
+{
+    *this = CompressedAnimationTrack{};
+}
+
+void CompressedAnimationTrack::Sample(
+    float time, float duration, bool isLooped, unsigned& frameIndex, Transform& value) const
+{
+    if (numKeyFrames_ == 0)
+        return;
+
+    if (time < 0.0f)
+        time = 0.0f;
+
+    if (frameIndex >= numKeyFrames_)
+        frameIndex = numKeyFrames_ - 1;
+
+    // Previous keyframe index is usually at most one keyframe behind, so the search is O(1) on playback
+    while (frameIndex && time < GetKeyFrameTime(frameIndex))
+        --frameIndex;
+    while (frameIndex < numKeyFrames_ - 1 && time >= GetKeyFrameTime(frameIndex + 1))
+        ++frameIndex;
+
+    const unsigned nextFrameIndex = isLooped
+        ? (frameIndex + 1) % numKeyFrames_
+        : ea::min(frameIndex + 1, numKeyFrames_ - 1);
+
+    float blendFactor = 0.0f;
+    if (frameIndex != nextFrameIndex)
+    {
+        const float frameTime = GetKeyFrameTime(frameIndex);
+        const float nextFrameTime = GetKeyFrameTime(nextFrameIndex);
+
+        float timeInterval = nextFrameTime - frameTime;
+        if (timeInterval < 0.0f)
+            timeInterval += duration;
+        blendFactor = timeInterval > 0.0f ? (time - frameTime) / timeInterval : 1.0f;
+    }
+
+    const Transform keyFrame = GetKeyFrameValue(frameIndex);
+    if (blendFactor >= M_EPSILON)
+    {
+        const Transform nextKeyFrame = GetKeyFrameValue(nextFrameIndex);
+        if (channelMask_ & CHANNEL_POSITION)
+            value.position_ = keyFrame.position_.Lerp(nextKeyFrame.position_, blendFactor);
+        if (channelMask_ & CHANNEL_ROTATION)
+            value.rotation_ = keyFrame.rotation_.Slerp(nextKeyFrame.rotation_, blendFactor);
+        if (channelMask_ & CHANNEL_SCALE)
+            value.scale_ = keyFrame.scale_.Lerp(nextKeyFrame.scale_, blendFactor);
+    }
+    else
+    {
+        if (channelMask_ & CHANNEL_POSITION)
+            value.position_ = keyFrame.position_;
+        if (channelMask_ & CHANNEL_ROTATION)
+            value.rotation_ = keyFrame.rotation_;
+        if (channelMask_ & CHANNEL_SCALE)
+            value.scale_ = keyFrame.scale_;
+    }
+}
+
+void CompressedAnimationTrack::Read(Deserializer& source)
+{
+    Clear();
+
+    numKeyFrames_ = source.ReadUInt();
+    channelMask_ = AnimationChannelFlags(source.ReadUByte());
+    startTime_ = source.ReadFloat();
+    timeRange_ = source.ReadFloat();
+    if (channelMask_ & CHANNEL_POSITION)
+    {
+        positionMin_ = source.ReadVector3();
+        positionRange_ = source.ReadVector3();
+    }
+    if (channelMask_ & CHANNEL_SCALE)
+    {
+        scaleMin_ = source.ReadVector3();
+        scaleRange_ = source.ReadVector3();
+    }
+
+    UpdateLayout();
+    data_.resize(numKeyFrames_ * stride_);
+    source.Read(data_.data(), GetDataSize());
+
+    if (numKeyFrames_ != 0)
+        firstValue_ = GetKeyFrameValue(0);
+}
+
+void CompressedAnimationTrack::Write(Serializer& dest) const
+{
+    dest.WriteUInt(numKeyFrames_);
+    dest.WriteUByte(channelMask_);
+    dest.WriteFloat(startTime_);
+    dest.WriteFloat(timeRange_);
+    if (channelMask_ & CHANNEL_POSITION)
+    {
+        dest.WriteVector3(positionMin_);
+        dest.WriteVector3(positionRange_);
+    }
+    if (channelMask_ & CHANNEL_SCALE)
+    {
+        dest.WriteVector3(scaleMin_);
+        dest.WriteVector3(scaleRange_);
+    }
+    dest.Write(data_.data(), GetDataSize());
+}
+
+float CompressedAnimationTrack::GetKeyFrameTime(unsigned index) const
+{
+    return startTime_ + DequantizeUnorm(data_[index * stride_], maxQuantizedValue) * timeRange_;
+}
+
+Transform CompressedAnimationTrack::GetKeyFrameValue(unsigned index) const
+{
+    Transform value;
+    const unsigned short* source = &data_[index * stride_ + 1];
+    if (channelMask_.Test(CHANNEL_POSITION))
+    {
+        value.position_ = DequantizeVector3(source, positionMin_, positionRange_);
+        source += 3;
+    }
+    if (channelMask_.Test(CHANNEL_ROTATION))
+    {
+        value.rotation_ = DequantizeRotation(source);
+        source += 3;
+    }
+    if (channelMask_.Test(CHANNEL_SCALE))
+        value.scale_ = DequantizeVector3(source, scaleMin_, scaleRange_);
+    return value;
+}
+
+void CompressedAnimationTrack::UpdateLayout()
+{
+    stride_ = 1;
+    if (channelMask_.Test(CHANNEL_POSITION))
+        stride_ += 3;
+    if (channelMask_.Test(CHANNEL_ROTATION))
+        stride_ += 3;
+    if (channelMask_.Test(CHANNEL_SCALE))
+        stride_ += 3;
+}
+
+AnimationCompressionStats AnimationTrack::Compress(const AnimationCompressionSettings& settings)
+{
+    AnimationCompressionStats stats;
+    if (keyFrames_.empty())
+        return stats;
+
+    compressedKeyFrames_.Compress(keyFrames_, channelMask_, settings);
+
+    stats.originalKeyFrames_ = keyFrames_.size();
+    stats.compressedKeyFrames_ = compressedKeyFrames_.GetNumKeyFrames();
+    stats.originalSize_ = keyFrames_.size() * sizeof(AnimationKeyFrame);
+    stats.compressedSize_ = compressedKeyFrames_.GetDataSize();
+
+    // Measure actual error including quantization at each original keyframe
+    const float duration = keyFrames_.back().time_;
+    unsigned frameIndex = 0;
+    for (const AnimationKeyFrame& keyFrame : keyFrames_)
+    {
+        Transform value;
+        compressedKeyFrames_.Sample(keyFrame.time_, duration, false, frameIndex, value);
+
+        if (channelMask_.Test(CHANNEL_POSITION))
+            stats.maxPositionError_ = Max(stats.maxPositionError_, (value.position_ - keyFrame.position_).Length());
+        if (channelMask_.Test(CHANNEL_ROTATION))
+            stats.maxRotationError_ = Max(stats.maxRotationError_, GetRotationError(value.rotation_, keyFrame.rotation_));
+        if (channelMask_.Test(CHANNEL_SCALE))
+            stats.maxScaleError_ = Max(stats.maxScaleError_, (value.scale_ - keyFrame.scale_).Length());
+    }
+
+    keyFrames_.clear();
+    keyFrames_.shrink_to_fit();
+    return stats;
+}
+
 void AnimationTrack::Sample(float time, float duration, bool isLooped, unsigned& frameIndex, Transform& value) const
 {
+    if (IsCompressed())
+    {
+        compressedKeyFrames_.Sample(time, duration, isLooped, frameIndex, value);
+        return;
+    }
+
     float blendFactor{};
     unsigned nextFrameIndex{};
     GetKeyFrames(time, duration, isLooped, frameIndex, nextFrameIndex, blendFactor);
@@ -61,11 +485,13 @@ void AnimationTrack::Sample(float time, float duration, bool isLooped, unsigned&
 
 bool AnimationTrack::IsLooped(float positionThreshold, float rotationThreshold, float scaleThreshold) const
 {
-    if (keyFrames_.empty())
+    if (IsEmpty())
         return true;
 
-    const Transform& firstTransform = keyFrames_.front();
-    const Transform& lastTransform = keyFrames_.back();
+    const Transform& firstTransform = GetFirstValue();
+    const Transform lastTransform = IsCompressed()
+        ? compressedKeyFrames_.GetKeyFrameValue(compressedKeyFrames_.GetNumKeyFrames() - 1)
+        : static_cast<const Transform&>(keyFrames_.back());
 
     if (channelMask_.Test(CHANNEL_POSITION) && !firstTransform.position_.Equals(lastTransform.position_, positionThreshold))
         return false;
@@ -30,9 +30,14 @@
 #include "../Graphics/Skeleton.h"
 #include "../Math/Transform.h"
 
+#include <EASTL/span.h>
+
 namespace Urho3D
 {
 
+class Deserializer;
+class Serializer;
+
 /// Skeletal animation keyframe.
 /// TODO: Replace inheritance with composition?
 struct AnimationKeyFrame : public Transform
@@ -49,6 +54,101 @@ struct AnimationKeyFrame : public Transform
     }
 };
 
+/// Settings of skeletal animation track compression.
+/// Tolerances include quantization error. They are not exceeded at the original keyframes as long as
+/// the quantization step (1/65535 of the track range for position and scale) is smaller than the tolerance.
+struct AnimationCompressionSettings
+{
+    /// Max position error.
+    float positionTolerance_{0.001f};
+    /// Max rotation error in degrees.
+    float rotationTolerance_{0.05f};
+    /// Max scale error.
+    float scaleTolerance_{0.001f};
+};
+
+/// Size and error of compressed skeletal animation track or animation.
+struct URHO3D_API AnimationCompressionStats
+{
+    /// Number of keyframes before compression.
+    unsigned originalKeyFrames_{};
+    /// Number of keyframes after compression.
+    unsigned compressedKeyFrames_{};
+    /// Size of keyframe data before compression in bytes.
+    unsigned originalSize_{};
+    /// Size of keyframe data after compression in bytes.
+    unsigned compressedSize_{};
+    /// Max position error.
+    float maxPositionError_{};
+    /// Max rotation error in degrees.
+    float maxRotationError_{};
+    /// Max scale error.
+    float maxScaleError_{};
+
+    /// Accumulate stats of another track.
+    void Merge(const AnimationCompressionStats& other);
+};
+
+/// Compressed keyframes of skeletal animation track.
+/// Keyframes are interleaved and stored as 16-bit values: normalized time, position and scale quantized within
+/// the range of the track, and rotation packed with smallest-three method.
+class URHO3D_API CompressedAnimationTrack
+{
+public:
+    /// Compress keyframes. Keyframes that can be interpolated from neighbors within tolerance are removed.
+    void Compress(ea::span<const AnimationKeyFrame> keyFrames, AnimationChannelFlags channelMask,
+        const AnimationCompressionSettings& settings);
+    /// Remove all keyframes.
+    void Clear();
+    /// Sample value at given time. Previous keyframe index is used as hint.
+    void Sample(float time, float duration, bool isLooped, unsigned& frameIndex, Transform& value) const;
+
+    /// Read from stream.
+    void Read(Deserializer& source);
+    /// Write to stream.
+    void Write(Serializer& dest) const;
+
+    /// Return whether there are no keyframes.
+    bool IsEmpty() const { return numKeyFrames_ == 0; }
+    /// Return number of keyframes.
+    unsigned GetNumKeyFrames() const { return numKeyFrames_; }
+    /// Return size of keyframe data in bytes.
+    unsigned GetDataSize() const { return data_.size() * sizeof(unsigned short); }
+    /// Return decoded value of the first keyframe.
+    const Transform& GetFirstValue() const { return firstValue_; }
+    /// Return time of keyframe.
+    float GetKeyFrameTime(unsigned index) const;
+    /// Return decoded value of keyframe.
+    Transform GetKeyFrameValue(unsigned index) const;
+
+private:
+    /// Calculate stride and decode the first keyframe.
+    void UpdateLayout();
+
+    /// Number of keyframes.
+    unsigned numKeyFrames_{};
+    /// Size of keyframe in 16-bit values.
+    unsigned stride_{};
+    /// Included channels.
+    AnimationChannelFlags channelMask_;
+    /// Time of the first keyframe.
+    float startTime_{};
+    /// Time between the first and the last keyframes.
+    float timeRange_{};
+    /// Min position.
+    Vector3 positionMin_;
+    /// Range of positions.
+    Vector3 positionRange_;
+    /// Min scale.
+    Vector3 scaleMin_;
+    /// Range of scales.
+    Vector3 scaleRange_;
+    /// Decoded first keyframe.
+    Transform firstValue_;
+    /// Interleaved keyframe data.
+    ea::vector<unsigned short> data_;
+};
+
 /// Skeletal animation track, stores keyframes of a single bone.
 /// @fakeref
 struct URHO3D_API AnimationTrack : public KeyFrameSet<AnimationKeyFrame>
@@ -66,10 +166,22 @@ struct URHO3D_API AnimationTrack : public KeyFrameSet<AnimationKeyFrame>
     /// Weight of the scale channel.
     float scaleWeight_{1.0f};
 
+    /// Compressed keyframes. If not empty, used instead of `keyFrames_`.
+    CompressedAnimationTrack compressedKeyFrames_;
+
+    /// Replace keyframes with compressed keyframes. Return size and error of compression.
+    AnimationCompressionStats Compress(const AnimationCompressionSettings& settings);
     /// Sample value at given time.
     void Sample(float time, float duration, bool isLooped, unsigned& frameIndex, Transform& transform) const;
     /// Return whether the track is looped, i.e. the first and the last keyframes have the same value.
     bool IsLooped(float positionThreshold = 0.001f, float rotationThreshold = 0.001f, float scaleThreshold = 0.001f) const;
+
+    /// Return whether the track has no keyframes, either compressed or not.
+    bool IsEmpty() const { return keyFrames_.empty() && compressedKeyFrames_.IsEmpty(); }
+    /// Return whether the track is compressed.
+    bool IsCompressed() const { return !compressedKeyFrames_.IsEmpty(); }
+    /// Return value of the first keyframe. Track should not be empty.
+    const Transform& GetFirstValue() const { return IsCompressed() ? compressedKeyFrames_.GetFirstValue() : keyFrames_.front(); }
 };
 
 /// Generic variant animation keyframe.
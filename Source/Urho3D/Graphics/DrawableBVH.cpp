@@ -0,0 +1,584 @@
+//
+// Copyright (c) 2017-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "Urho3D/Precompiled.h"
+
+#include "Urho3D/Graphics/DrawableBVH.h"
+
+#include "Urho3D/Core/WorkQueue.h"
+#include "Urho3D/Graphics/DebugRenderer.h"
+#include "Urho3D/Graphics/Drawable.h"
+
+#include <EASTL/sort.h>
+
+#ifdef URHO3D_SSE
+#include <emmintrin.h>
+#endif
+
+#include "Urho3D/DebugNew.h"
+
+namespace Urho3D
+{
+
+namespace
+{
+
+/// Max depth of traversal stack. Enough for any hierarchy that fits into memory.
+static constexpr unsigned MaxStackSize = 64;
+/// Max number of root drawables tested against ray at once.
+static constexpr unsigned RayBatchSize = 64;
+
+/// Insert two zero bits after each of 10 lower bits.
+unsigned SpreadBits(unsigned value)
+{
+    value = (value * 0x00010001u) & 0xFF0000FFu;
+    value = (value * 0x00000101u) & 0x0F00F00Fu;
+    value = (value * 0x00000011u) & 0xC30C30C3u;
+    value = (value * 0x00000005u) & 0x49249249u;
+    return value;
+}
+
+/// Return 30-bit Morton code of position normalized to [0, 1] range.
+unsigned GetMortonCode(const Vector3& position)
+{
+    const auto x = static_cast<unsigned>(Clamp(position.x_ * 1024.0f, 0.0f, 1023.0f));
+    const auto y = static_cast<unsigned>(Clamp(position.y_ * 1024.0f, 0.0f, 1023.0f));
+    const auto z = static_cast<unsigned>(Clamp(position.z_ * 1024.0f, 0.0f, 1023.0f));
+    return (SpreadBits(x) << 2u) | (SpreadBits(y) << 1u) | SpreadBits(z);
+}
+
+/// Ray prepared for batched slab tests.
+class RayBatchTester
+{
+public:
+    explicit RayBatchTester(const Ray& ray)
+        : origin_(ray.origin_)
+    {
+        // Avoid infinities so that boxes touching the ray are not rejected because of NaNs
+        static const float minDirection = 1e-20f;
+        const auto safeInverse = [](float value)
+        {
+            if (Abs(value) < minDirection)
+                value = value < 0.0f ? -minDirection : minDirection;
+            return 1.0f / value;
+        };
+        invDirection_ = Vector3{safeInverse(ray.direction_.x_), safeInverse(ray.direction_.y_), safeInverse(ray.direction_.z_)};
+    }
+
+    /// Compute hit distances for batch of boxes. Boxes that are not hit get infinite distance.
+    void HitDistances(const BoundingBoxBatch& boxes, float* result) const
+    {
+        unsigned i = 0;
+#ifdef URHO3D_SSE
+        const __m128 originX = _mm_set1_ps(origin_.x_);
+        const __m128 originY = _mm_set1_ps(origin_.y_);
+        const __m128 originZ = _mm_set1_ps(origin_.z_);
+        const __m128 invDirectionX = _mm_set1_ps(invDirection_.x_);
+        const __m128 invDirectionY = _mm_set1_ps(invDirection_.y_);
+        const __m128 invDirectionZ = _mm_set1_ps(invDirection_.z_);
+        const __m128 infinity = _mm_set1_ps(M_INFINITY);
+        for (; i + 4 <= boxes.size_; i += 4)
+        {
+            const __m128 x1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(boxes.minX_ + i), originX), invDirectionX);
+            const __m128 x2 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(boxes.maxX_ + i), originX), invDirectionX);
+            const __m128 y1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(boxes.minY_ + i), originY), invDirectionY);
+            const __m128 y2 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(boxes.maxY_ + i), originY), invDirectionY);
+            const __m128 z1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(boxes.minZ_ + i), originZ), invDirectionZ);
+            const __m128 z2 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(boxes.maxZ_ + i), originZ), invDirectionZ);
+
+            const __m128 nearDistance = _mm_max_ps(_mm_max_ps(_mm_min_ps(x1, x2), _mm_min_ps(y1, y2)),
+                _mm_max_ps(_mm_min_ps(z1, z2), _mm_setzero_ps()));
+            const __m128 farDistance = _mm_min_ps(_mm_min_ps(_mm_max_ps(x1, x2), _mm_max_ps(y1, y2)), _mm_max_ps(z1, z2));
+            const __m128 isHit = _mm_cmple_ps(nearDistance, farDistance);
+            _mm_storeu_ps(result + i, _mm_or_ps(_mm_and_ps(isHit, nearDistance), _mm_andnot_ps(isHit, infinity)));
+        }
+#endif
+        for (; i < boxes.size_; ++i)
+        {
+            const float x1 = (boxes.minX_[i] - origin_.x_) * invDirection_.x_;
+            const float x2 = (boxes.maxX_[i] - origin_.x_) * invDirection_.x_;
+            const float y1 = (boxes.minY_[i] - origin_.y_) * invDirection_.y_;
+            const float y2 = (boxes.maxY_[i] - origin_.y_) * invDirection_.y_;
+            const float z1 = (boxes.minZ_[i] - origin_.z_) * invDirection_.z_;
+            const float z2 = (boxes.maxZ_[i] - origin_.z_) * invDirection_.z_;
+
+            const float nearDistance = Max(Max(Min(x1, x2), Min(y1, y2)), Max(Min(z1, z2), 0.0f));
+            const float farDistance = Min(Min(Max(x1, x2), Max(y1, y2)), Max(z1, z2));
+            result[i] = nearDistance <= farDistance ? nearDistance : M_INFINITY;
+        }
+    }
+
+private:
+    /// Ray origin.
+    Vector3 origin_;
+    /// Inverse ray direction.
+    Vector3 invDirection_;
+};
+
+}
+
+void DrawableBVH::BoundingBoxArray::Resize(unsigned size)
+{
+    minX_.resize(size);
+    minY_.resize(size);
+    minZ_.resize(size);
+    maxX_.resize(size);
+    maxY_.resize(size);
+    maxZ_.resize(size);
+}
+
+void DrawableBVH::BoundingBoxArray::Set(unsigned index, const BoundingBox& box)
+{
+    minX_[index] = box.min_.x_;
+    minY_[index] = box.min_.y_;
+    minZ_[index] = box.min_.z_;
+    maxX_[index] = box.max_.x_;
+    maxY_[index] = box.max_.y_;
+    maxZ_[index] = box.max_.z_;
+}
+
+void DrawableBVH::BoundingBoxArray::Copy(unsigned destIndex, unsigned sourceIndex)
+{
+    minX_[destIndex] = minX_[sourceIndex];
+    minY_[destIndex] = minY_[sourceIndex];
+    minZ_[destIndex] = minZ_[sourceIndex];
+    maxX_[destIndex] = maxX_[sourceIndex];
+    maxY_[destIndex] = maxY_[sourceIndex];
+    maxZ_[destIndex] = maxZ_[sourceIndex];
+}
+
+BoundingBox DrawableBVH::BoundingBoxArray::Get(unsigned index) const
+{
+    return GetBatch(0, minX_.size()).Get(index);
+}
+
+BoundingBoxBatch DrawableBVH::BoundingBoxArray::GetBatch(unsigned offset, unsigned count) const
+{
+    return {minX_.data() + offset, minY_.data() + offset, minZ_.data() + offset,
+        maxX_.data() + offset, maxY_.data() + offset, maxZ_.data() + offset, count};
+}
+
+bool DrawableBVH::IsTreeDrawable(Drawable* drawable)
+{
+    return drawable->IsOccludee() && drawable->GetWorldBoundingBox().Defined();
+}
+
+void DrawableBVH::AddDrawable(Drawable* drawable)
+{
+    const unsigned index = drawable->GetDrawableIndex();
+    if (index >= locations_.size())
+        locations_.resize(index + 1, InvalidLocation);
+
+    AddRootDrawable(drawable);
+}
+
+void DrawableBVH::RemoveDrawable(Drawable* drawable)
+{
+    const unsigned index = drawable->GetDrawableIndex();
+    if (index >= locations_.size() || locations_[index] == InvalidLocation)
+        return;
+
+    const unsigned location = locations_[index];
+    if (location & RootFlag)
+        RemoveRootDrawable(location & ~RootFlag);
+    else
+        RemoveTreeDrawable(location);
+    locations_[index] = InvalidLocation;
+}
+
+void DrawableBVH::RenameDrawable(unsigned oldIndex, unsigned newIndex)
+{
+    if (oldIndex == newIndex || oldIndex >= locations_.size())
+        return;
+
+    if (newIndex >= locations_.size())
+        locations_.resize(newIndex + 1, InvalidLocation);
+    locations_[newIndex] = locations_[oldIndex];
+    locations_[oldIndex] = InvalidLocation;
+}
+
+void DrawableBVH::UpdateDrawables(ea::span<Drawable* const> drawables)
+{
+    for (Drawable* drawable : drawables)
+    {
+        const unsigned index = drawable->GetDrawableIndex();
+        if (index >= locations_.size() || locations_[index] == InvalidLocation)
+            continue;
+
+        const unsigned location = locations_[index];
+        if (location & RootFlag)
+            rootBounds_.Set(location & ~RootFlag, drawable->GetWorldBoundingBox());
+        else if (!IsTreeDrawable(drawable))
+        {
+            RemoveTreeDrawable(location);
+            AddRootDrawable(drawable);
+        }
+        else
+        {
+            treeBounds_.Set(location, drawable->GetWorldBoundingBox());
+            refitNeeded_ = true;
+        }
+    }
+
+    numUpdatesSinceRebuild_ += drawables.size();
+}
+
+void DrawableBVH::Commit(WorkQueue* workQueue)
+{
+    const unsigned numNewRootDrawables = rootDrawables_.size() - ea::min(numRootDrawablesAfterRebuild_, rootDrawables_.size());
+    const bool rebuildNeeded = numNewRootDrawables > ea::max(MinRootDrawablesForRebuild, numTreeDrawables_ / 8)
+        || numRemovedSinceRebuild_ > ea::max(MinRootDrawablesForRebuild, numTreeDrawables_ / 4)
+        || numUpdatesSinceRebuild_ > 8 * numTreeDrawables_ + MinRootDrawablesForRebuild;
+
+    if (rebuildNeeded)
+        Rebuild(workQueue);
+    else if (refitNeeded_)
+        Refit(workQueue);
+}
+
+void DrawableBVH::Rebuild(WorkQueue* workQueue)
+{
+    ++numRebuilds_;
+
+    // Collect all drawables and keep ones that cannot be culled in the root list
+    ea::vector<Drawable*> drawables;
+    drawables.reserve(numTreeDrawables_ + rootDrawables_.size());
+    for (const Node& node : nodes_)
+    {
+        for (unsigned i = 0; i < node.numDrawables_; ++i)
+            drawables.push_back(treeDrawables_[node.firstDrawable_ + i]);
+    }
+    drawables.insert(drawables.end(), rootDrawables_.begin(), rootDrawables_.end());
+
+    rootDrawables_.clear();
+    rootBounds_.Resize(0);
+    ea::vector<ea::pair<unsigned, Drawable*>> sortedDrawables;
+    sortedDrawables.reserve(drawables.size());
+
+    BoundingBox centerBounds;
+    for (Drawable* drawable : drawables)
+    {
+        if (IsTreeDrawable(drawable))
+        {
+            centerBounds.Merge(drawable->GetWorldBoundingBox().Center());
+            sortedDrawables.emplace_back(0u, drawable);
+        }
+        else
+            AddRootDrawable(drawable);
+    }
+
+    // Sort drawables along Morton curve so that ranges of drawables are spatially coherent
+    const Vector3 centerOffset = centerBounds.Defined() ? centerBounds.min_ : Vector3::ZERO;
+    const Vector3 centerSize = centerBounds.Defined() ? centerBounds.Size() : Vector3::ONE;
+    const Vector3 centerScale = VectorMax(centerSize, Vector3::ONE * M_EPSILON);
+    for (auto& [code, drawable] : sortedDrawables)
+        code = GetMortonCode((drawable->GetWorldBoundingBox().Center() - centerOffset) / centerScale);
+    ea::sort(sortedDrawables.begin(), sortedDrawables.end(),
+        [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+
+    const unsigned numDrawables = sortedDrawables.size();
+    treeDrawables_.resize(numDrawables);
+    treeBounds_.Resize(numDrawables);
+    treeLeaves_.resize(numDrawables);
+    for (unsigned i = 0; i < numDrawables; ++i)
+    {
+        Drawable* drawable = sortedDrawables[i].second;
+        treeDrawables_[i] = drawable;
+        treeBounds_.Set(i, drawable->GetWorldBoundingBox());
+        locations_[drawable->GetDrawableIndex()] = i;
+    }
+
+    // Split ranges of drawables evenly, children of each node are allocated contiguously
+    nodes_.clear();
+    leafNodes_.clear();
+    if (numDrawables > 0)
+    {
+        ea::vector<ea::pair<unsigned, unsigned>> nodeRanges;
+        nodes_.emplace_back();
+        nodeRanges.emplace_back(0u, numDrawables);
+        for (unsigned nodeIndex = 0; nodeIndex < nodes_.size(); ++nodeIndex)
+        {
+            const auto [beginIndex, endIndex] = nodeRanges[nodeIndex];
+            const unsigned count = endIndex - beginIndex;
+            Node node;
+            if (count <= MaxLeafSize)
+            {
+                node.firstDrawable_ = beginIndex;
+                node.numDrawables_ = count;
+                leafNodes_.push_back(nodeIndex);
+                for (unsigned i = beginIndex; i < endIndex; ++i)
+                    treeLeaves_[i] = nodeIndex;
+            }
+            else
+            {
+                node.firstChild_ = nodes_.size();
+                node.numChildren_ = ea::min(MaxChildren, (count + MaxLeafSize - 1) / MaxLeafSize);
+                for (unsigned childIndex = 0; childIndex < node.numChildren_; ++childIndex)
+                {
+                    const unsigned childBegin = beginIndex + count * childIndex / node.numChildren_;
+                    const unsigned childEnd = beginIndex + count * (childIndex + 1) / node.numChildren_;
+                    nodes_.emplace_back();
+                    nodeRanges.emplace_back(childBegin, childEnd);
+                }
+            }
+            nodes_[nodeIndex] = node;
+        }
+    }
+    nodeBounds_.Resize(nodes_.size());
+
+    numTreeDrawables_ = numDrawables;
+    numRootDrawablesAfterRebuild_ = rootDrawables_.size();
+    numRemovedSinceRebuild_ = 0;
+    numUpdatesSinceRebuild_ = 0;
+
+    Refit(workQueue);
+}
+
+void DrawableBVH::Clear()
+{
+    nodes_.clear();
+    nodeBounds_.Resize(0);
+    leafNodes_.clear();
+    treeDrawables_.clear();
+    treeBounds_.Resize(0);
+    treeLeaves_.clear();
+    numTreeDrawables_ = 0;
+    rootDrawables_.clear();
+    rootBounds_.Resize(0);
+    numRootDrawablesAfterRebuild_ = 0;
+    locations_.clear();
+    refitNeeded_ = false;
+    numRemovedSinceRebuild_ = 0;
+    numUpdatesSinceRebuild_ = 0;
+}
+
+void DrawableBVH::GetDrawables(OctreeQuery& query) const
+{
+    if (!nodes_.empty())
+    {
+        ea::pair<unsigned, bool> stack[MaxStackSize];
+        unsigned stackSize = 0;
+
+        Intersection rootIntersection{};
+        query.TestOctantBatch(nodeBounds_.GetBatch(0, 1), false, &rootIntersection);
+        if (rootIntersection != OUTSIDE)
+            stack[stackSize++] = {0u, rootIntersection == INSIDE};
+
+        while (stackSize > 0)
+        {
+            const auto [nodeIndex, inside] = stack[--stackSize];
+            const Node& node = nodes_[nodeIndex];
+            if (node.numChildren_ == 0)
+            {
+                if (node.numDrawables_ > 0)
+                {
+                    auto drawables = const_cast<Drawable**>(&treeDrawables_[node.firstDrawable_]);
+                    query.TestDrawableBatch(drawables, treeBounds_.GetBatch(node.firstDrawable_, node.numDrawables_), inside);
+                }
+                continue;
+            }
+
+            Intersection intersections[MaxChildren];
+            query.TestOctantBatch(nodeBounds_.GetBatch(node.firstChild_, node.numChildren_), inside, intersections);
+            for (unsigned i = 0; i < node.numChildren_; ++i)
+            {
+                if (intersections[i] != OUTSIDE)
+                {
+                    URHO3D_ASSERT(stackSize < MaxStackSize);
+                    stack[stackSize++] = {node.firstChild_ + i, inside || intersections[i] == INSIDE};
+                }
+            }
+        }
+    }
+
+    if (!rootDrawables_.empty())
+    {
+        auto drawables = const_cast<Drawable**>(rootDrawables_.data());
+        query.TestDrawableBatch(drawables, rootBounds_.GetBatch(0, rootDrawables_.size()), false);
+    }
+}
+
+void DrawableBVH::GetDrawables(RayOctreeQuery& query, ea::vector<Drawable*>& drawables) const
+{
+    const RayBatchTester tester{query.ray_};
+    const auto addDrawables = [&](Drawable* const* candidates, const BoundingBoxBatch& boxes)
+    {
+        float distances[RayBatchSize];
+        tester.HitDistances(boxes, distances);
+        for (unsigned i = 0; i < boxes.size_; ++i)
+        {
+            Drawable* drawable = candidates[i];
+            if (distances[i] < query.maxDistance_ && (drawable->GetDrawableFlags() & query.drawableFlags_)
+                && (drawable->GetViewMask() & query.viewMask_))
+            {
+                drawables.push_back(drawable);
+            }
+        }
+    };
+
+    if (!nodes_.empty())
+    {
+        unsigned stack[MaxStackSize];
+        unsigned stackSize = 0;
+
+        float rootDistance{};
+        tester.HitDistances(nodeBounds_.GetBatch(0, 1), &rootDistance);
+        if (rootDistance < query.maxDistance_)
+            stack[stackSize++] = 0;
+
+        while (stackSize > 0)
+        {
+            const Node& node = nodes_[stack[--stackSize]];
+            if (node.numChildren_ == 0)
+            {
+                addDrawables(&treeDrawables_[node.firstDrawable_], treeBounds_.GetBatch(node.firstDrawable_, node.numDrawables_));
+                continue;
+            }
+
+            float distances[MaxChildren];
+            tester.HitDistances(nodeBounds_.GetBatch(node.firstChild_, node.numChildren_), distances);
+            for (unsigned i = 0; i < node.numChildren_; ++i)
+            {
+                if (distances[i] < query.maxDistance_)
+                {
+                    URHO3D_ASSERT(stackSize < MaxStackSize);
+                    stack[stackSize++] = node.firstChild_ + i;
+                }
+            }
+        }
+    }
+
+    for (unsigned offset = 0; offset < rootDrawables_.size(); offset += RayBatchSize)
+    {
+        const unsigned count = ea::min<unsigned>(rootDrawables_.size() - offset, RayBatchSize);
+        addDrawables(&rootDrawables_[offset], rootBounds_.GetBatch(offset, count));
+    }
+}
+
+void DrawableBVH::DrawDebugGeometry(DebugRenderer* debug, bool depthTest) const
+{
+    for (unsigned nodeIndex : leafNodes_)
+    {
+        const BoundingBox box = nodeBounds_.Get(nodeIndex);
+        if (nodes_[nodeIndex].numDrawables_ > 0 && debug->IsInside(box))
+            debug->AddBoundingBox(box, Color(0.25f, 0.25f, 0.25f), depthTest);
+    }
+}
+
+void DrawableBVH::AddRootDrawable(Drawable* drawable)
+{
+    const unsigned rootIndex = rootDrawables_.size();
+    rootDrawables_.push_back(drawable);
+    rootBounds_.Resize(rootIndex + 1);
+    rootBounds_.Set(rootIndex, drawable->GetWorldBoundingBox());
+    locations_[drawable->GetDrawableIndex()] = RootFlag | rootIndex;
+}
+
+void DrawableBVH::RemoveRootDrawable(unsigned rootIndex)
+{
+    const unsigned lastIndex = rootDrawables_.size() - 1;
+    if (rootIndex != lastIndex)
+    {
+        Drawable* movedDrawable = rootDrawables_[lastIndex];
+        rootDrawables_[rootIndex] = movedDrawable;
+        rootBounds_.Copy(rootIndex, lastIndex);
+        locations_[movedDrawable->GetDrawableIndex()] = RootFlag | rootIndex;
+    }
+
+    rootDrawables_.pop_back();
+    rootBounds_.Resize(lastIndex);
+    numRootDrawablesAfterRebuild_ = ea::min(numRootDrawablesAfterRebuild_, lastIndex);
+}
+
+void DrawableBVH::RemoveTreeDrawable(unsigned slot)
+{
+    // Keep drawables of the leaf contiguous, the unused tail is ignored until rebuild
+    Node& leaf = nodes_[treeLeaves_[slot]];
+    const unsigned lastSlot = leaf.firstDrawable_ + leaf.numDrawables_ - 1;
+    if (slot != lastSlot)
+    {
+        Drawable* movedDrawable = treeDrawables_[lastSlot];
+        treeDrawables_[slot] = movedDrawable;
+        treeBounds_.Copy(slot, lastSlot);
+        locations_[movedDrawable->GetDrawableIndex()] = slot;
+    }
+
+    treeDrawables_[lastSlot] = nullptr;
+    --leaf.numDrawables_;
+    --numTreeDrawables_;
+    ++numRemovedSinceRebuild_;
+    refitNeeded_ = true;
+}
+
+void DrawableBVH::Refit(WorkQueue* workQueue)
+{
+    refitNeeded_ = false;
+    if (nodes_.empty())
+        return;
+
+    // Leaves are independent and can be refit in parallel. Empty leaves keep old bounds
+    const auto refitLeaves = [this](unsigned beginIndex, unsigned endIndex)
+    {
+        for (unsigned i = beginIndex; i < endIndex; ++i)
+        {
+            const unsigned nodeIndex = leafNodes_[i];
+            const Node& node = nodes_[nodeIndex];
+            if (node.numDrawables_ == 0)
+                continue;
+
+            const unsigned beginSlot = node.firstDrawable_;
+            const unsigned endSlot = node.firstDrawable_ + node.numDrawables_;
+            nodeBounds_.minX_[nodeIndex] = *ea::min_element(&treeBounds_.minX_[beginSlot], &treeBounds_.minX_[0] + endSlot);
+            nodeBounds_.minY_[nodeIndex] = *ea::min_element(&treeBounds_.minY_[beginSlot], &treeBounds_.minY_[0] + endSlot);
+            nodeBounds_.minZ_[nodeIndex] = *ea::min_element(&treeBounds_.minZ_[beginSlot], &treeBounds_.minZ_[0] + endSlot);
+            nodeBounds_.maxX_[nodeIndex] = *ea::max_element(&treeBounds_.maxX_[beginSlot], &treeBounds_.maxX_[0] + endSlot);
+            nodeBounds_.maxY_[nodeIndex] = *ea::max_element(&treeBounds_.maxY_[beginSlot], &treeBounds_.maxY_[0] + endSlot);
+            nodeBounds_.maxZ_[nodeIndex] = *ea::max_element(&treeBounds_.maxZ_[beginSlot], &treeBounds_.maxZ_[0] + endSlot);
+        }
+    };
+
+    static constexpr unsigned leavesPerTask = 64;
+    if (workQueue)
+        workQueue->ParallelFor(leafNodes_.size(), leavesPerTask, refitLeaves);
+    else
+        refitLeaves(0, leafNodes_.size());
+
+    // Children are always stored after parents, so internal nodes can be refit in reverse order
+    for (unsigned nodeIndex = nodes_.size(); nodeIndex-- > 0;)
+    {
+        const Node& node = nodes_[nodeIndex];
+        if (node.numChildren_ == 0)
+            continue;
+
+        const unsigned beginChild = node.firstChild_;
+        const unsigned endChild = node.firstChild_ + node.numChildren_;
+        nodeBounds_.minX_[nodeIndex] = *ea::min_element(&nodeBounds_.minX_[beginChild], &nodeBounds_.minX_[0] + endChild);
+        nodeBounds_.minY_[nodeIndex] = *ea::min_element(&nodeBounds_.minY_[beginChild], &nodeBounds_.minY_[0] + endChild);
+        nodeBounds_.minZ_[nodeIndex] = *ea::min_element(&nodeBounds_.minZ_[beginChild], &nodeBounds_.minZ_[0] + endChild);
+        nodeBounds_.maxX_[nodeIndex] = *ea::max_element(&nodeBounds_.maxX_[beginChild], &nodeBounds_.maxX_[0] + endChild);
+        nodeBounds_.maxY_[nodeIndex] = *ea::max_element(&nodeBounds_.maxY_[beginChild], &nodeBounds_.maxY_[0] + endChild);
+        nodeBounds_.maxZ_[nodeIndex] = *ea::max_element(&nodeBounds_.maxZ_[beginChild], &nodeBounds_.maxZ_[0] + endChild);
+    }
+}
+
+}
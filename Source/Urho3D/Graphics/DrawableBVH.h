@@ -0,0 +1,174 @@
+//
+// Copyright (c) 2017-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+/// \file
+
+#pragma once
+
+#include "Urho3D/Core/NonCopyable.h"
+#include "Urho3D/Graphics/OctreeQuery.h"
+
+#include <EASTL/span.h>
+#include <EASTL/vector.h>
+
+namespace Urho3D
+{
+
+class DebugRenderer;
+class WorkQueue;
+
+/// Bounding volume hierarchy of drawables, used by Octree as an alternative to octants.
+/// Bounding boxes are stored as structure of arrays in leaf order.
+/// Moved drawables only update their boxes, and the hierarchy is refit in parallel.
+/// Drawables added since the last rebuild and drawables that cannot be culled by the hierarchy
+/// (non-occludees and drawables without bounds) are stored in flat root list.
+/// The hierarchy is rebuilt from Morton-sorted drawables when root list or removals grow too large.
+class URHO3D_API DrawableBVH : public NonCopyable
+{
+public:
+    /// Max number of drawables in leaf node.
+    static constexpr unsigned MaxLeafSize = 16;
+    /// Max number of children of internal node.
+    static constexpr unsigned MaxChildren = 4;
+    /// Number of root drawables that always triggers rebuild.
+    static constexpr unsigned MinRootDrawablesForRebuild = 64;
+
+    /// Add drawable. Drawable index should be assigned.
+    void AddDrawable(Drawable* drawable);
+    /// Remove drawable.
+    void RemoveDrawable(Drawable* drawable);
+    /// Notify that drawable index has changed.
+    void RenameDrawable(unsigned oldIndex, unsigned newIndex);
+    /// Update bounding boxes of moved drawables.
+    void UpdateDrawables(ea::span<Drawable* const> drawables);
+    /// Rebuild or refit the hierarchy if needed.
+    void Commit(WorkQueue* workQueue);
+    /// Rebuild the hierarchy from scratch.
+    void Rebuild(WorkQueue* workQueue);
+    /// Remove all drawables.
+    void Clear();
+
+    /// Return drawable objects by a query.
+    void GetDrawables(OctreeQuery& query) const;
+    /// Return drawable objects whose bounding boxes are hit by the ray within max distance of the query.
+    void GetDrawables(RayOctreeQuery& query, ea::vector<Drawable*>& drawables) const;
+    /// Draw leaf bounds to the debug graphics.
+    void DrawDebugGeometry(DebugRenderer* debug, bool depthTest) const;
+
+    /// Return number of nodes in hierarchy.
+    unsigned GetNumNodes() const { return nodes_.size(); }
+    /// Return number of drawables in hierarchy.
+    unsigned GetNumTreeDrawables() const { return numTreeDrawables_; }
+    /// Return number of drawables stored outside of the hierarchy.
+    unsigned GetNumRootDrawables() const { return rootDrawables_.size(); }
+    /// Return number of rebuilds.
+    unsigned GetNumRebuilds() const { return numRebuilds_; }
+
+private:
+    /// Node of the hierarchy. Children of one node are stored contiguously.
+    struct Node
+    {
+        /// Index of first child.
+        unsigned firstChild_{};
+        /// Number of children. Zero for leaf nodes.
+        unsigned numChildren_{};
+        /// Index of first drawable, for leaf nodes.
+        unsigned firstDrawable_{};
+        /// Number of drawables, for leaf nodes.
+        unsigned numDrawables_{};
+    };
+
+    /// Bounding boxes as structure of arrays.
+    struct BoundingBoxArray
+    {
+        /// Resize arrays.
+        void Resize(unsigned size);
+        /// Set bounding box.
+        void Set(unsigned index, const BoundingBox& box);
+        /// Copy bounding box from other index.
+        void Copy(unsigned destIndex, unsigned sourceIndex);
+        /// Return bounding box.
+        BoundingBox Get(unsigned index) const;
+        /// Return batch view.
+        BoundingBoxBatch GetBatch(unsigned offset, unsigned count) const;
+
+        ea::vector<float> minX_;
+        ea::vector<float> minY_;
+        ea::vector<float> minZ_;
+        ea::vector<float> maxX_;
+        ea::vector<float> maxY_;
+        ea::vector<float> maxZ_;
+    };
+
+    /// Location of drawable in tree or root list.
+    static constexpr unsigned RootFlag = 0x80000000u;
+    static constexpr unsigned InvalidLocation = M_MAX_UNSIGNED;
+
+    /// Return whether the drawable can be culled by the hierarchy.
+    static bool IsTreeDrawable(Drawable* drawable);
+    /// Add drawable to root list.
+    void AddRootDrawable(Drawable* drawable);
+    /// Remove drawable from root list.
+    void RemoveRootDrawable(unsigned rootIndex);
+    /// Remove drawable from hierarchy.
+    void RemoveTreeDrawable(unsigned slot);
+    /// Refit node bounds.
+    void Refit(WorkQueue* workQueue);
+
+    /// Nodes in level order.
+    ea::vector<Node> nodes_;
+    /// Node bounds.
+    BoundingBoxArray nodeBounds_;
+    /// Indices of leaf nodes.
+    ea::vector<unsigned> leafNodes_;
+
+    /// Drawables in hierarchy in leaf order. Leaf ranges may have unused tail after removals.
+    ea::vector<Drawable*> treeDrawables_;
+    /// Bounds of drawables in hierarchy.
+    BoundingBoxArray treeBounds_;
+    /// Leaf node index of each drawable slot.
+    ea::vector<unsigned> treeLeaves_;
+    /// Number of drawables in hierarchy.
+    unsigned numTreeDrawables_{};
+
+    /// Drawables outside of hierarchy.
+    ea::vector<Drawable*> rootDrawables_;
+    /// Bounds of drawables outside of hierarchy.
+    BoundingBoxArray rootBounds_;
+    /// Number of root drawables left after last rebuild.
+    unsigned numRootDrawablesAfterRebuild_{};
+
+    /// Location of each drawable by drawable index.
+    ea::vector<unsigned> locations_;
+
+    /// Whether the node bounds should be refit.
+    bool refitNeeded_{};
+    /// Number of drawables removed from the hierarchy since last rebuild.
+    unsigned numRemovedSinceRebuild_{};
+    /// Number of drawable updates since last rebuild.
+    unsigned numUpdatesSinceRebuild_{};
+    /// Number of rebuilds.
+    unsigned numRebuilds_{};
+};
+
+}
@@ -32,6 +32,7 @@
 #include "../IO/Log.h"
 #include "../IO/File.h"
 #include "../IO/FileSystem.h"
+#include "../IO/MemoryMappedFile.h"
 #include "../IO/VirtualFileSystem.h"
 #include "../Resource/ResourceCache.h"
 #include "../Resource/XMLFile.h"
@@ -97,6 +98,20 @@ bool Model::BeginLoad(Deserializer& source)
     unsigned memoryUse = sizeof(Model);
     bool async = GetAsyncLoadState() == ASYNC_LOADING;
 
+    // When loading asynchronously from memory mapped file, vertex and index data is uploaded from the mapping
+    auto mappedFile = async ? dynamic_cast<MemoryMappedFile*>(&source) : nullptr;
+    const unsigned char* mappedData = mappedFile ? mappedFile->GetContiguousData() : nullptr;
+    loadMapping_ = mappedData ? mappedFile->GetMapping() : nullptr;
+
+    const auto skipMappedData = [&](unsigned size) -> const unsigned char*
+    {
+        const unsigned position = source.GetPosition();
+        if (!mappedData || position + size > source.GetSize())
+            return nullptr;
+        source.Seek(position + size);
+        return mappedData + position;
+    };
+
     // Read vertex buffers
     unsigned numVertexBuffers = source.ReadUInt();
     vertexBuffers_.reserve(numVertexBuffers);
@@ -137,15 +152,20 @@ bool Model::BeginLoad(Deserializer& source)
         buffer->SetDebugName(Format("Model '{}' Vertex Buffer #{}", GetName(), i));
 
         // Prepare vertex buffer data to be uploaded during EndLoad()
+        desc.data_.reset(); // Make sure no previous data
+        desc.mappedData_ = nullptr;
         if (async)
         {
-            desc.data_ = new unsigned char[desc.dataSize_];
-            source.Read(desc.data_.get(), desc.dataSize_);
+            desc.mappedData_ = skipMappedData(desc.dataSize_);
+            if (!desc.mappedData_)
+            {
+                desc.data_ = new unsigned char[desc.dataSize_];
+                source.Read(desc.data_.get(), desc.dataSize_);
+            }
         }
         else
         {
             // If not async loading, use locking to avoid extra allocation & copy
-            desc.data_.reset(); // Make sure no previous data
             buffer->SetShadowed(true);
             buffer->SetSize(desc.vertexCount_, desc.vertexElements_);
             void* dest = buffer->Map();
@@ -170,18 +190,23 @@ bool Model::BeginLoad(Deserializer& source)
         buffer->SetDebugName(Format("Model '{}' Index Buffer #{}", GetName(), i));
 
         // Prepare index buffer data to be uploaded during EndLoad()
+        loadIBData_[i].data_.reset(); // Make sure no previous data
+        loadIBData_[i].mappedData_ = nullptr;
         if (async)
         {
             loadIBData_[i].indexCount_ = indexCount;
             loadIBData_[i].indexSize_ = indexSize;
             loadIBData_[i].dataSize_ = indexCount * indexSize;
-            loadIBData_[i].data_ = new unsigned char[loadIBData_[i].dataSize_];
-            source.Read(loadIBData_[i].data_.get(), loadIBData_[i].dataSize_);
+            loadIBData_[i].mappedData_ = skipMappedData(loadIBData_[i].dataSize_);
+            if (!loadIBData_[i].mappedData_)
+            {
+                loadIBData_[i].data_ = new unsigned char[loadIBData_[i].dataSize_];
+                source.Read(loadIBData_[i].data_.get(), loadIBData_[i].dataSize_);
+            }
         }
         else
         {
             // If not async loading, use locking to avoid extra allocation & copy
-            loadIBData_[i].data_.reset(); // Make sure no previous data
             buffer->SetShadowed(true);
             buffer->SetSize(indexCount, indexSize > sizeof(unsigned short));
             void* dest = buffer->Map();
@@ -229,6 +254,7 @@ bool Model::BeginLoad(Deserializer& source)
                 loadVBData_.clear();
                 loadIBData_.clear();
                 loadGeometries_.clear();
+                loadMapping_ = nullptr;
                 return false;
             }
             if (ibRef >= indexBuffers_.size())
@@ -237,6 +263,7 @@ bool Model::BeginLoad(Deserializer& source)
                 loadVBData_.clear();
                 loadIBData_.clear();
                 loadGeometries_.clear();
+                loadMapping_ = nullptr;
                 return false;
             }
 
@@ -332,11 +359,11 @@ bool Model::EndLoad()
     {
         VertexBuffer* buffer = vertexBuffers_[i];
         VertexBufferDesc& desc = loadVBData_[i];
-        if (desc.data_)
+        if (const unsigned char* data = desc.data_ ? desc.data_.get() : desc.mappedData_)
         {
             buffer->SetShadowed(true);
             buffer->SetSize(desc.vertexCount_, desc.vertexElements_);
-            buffer->Update(desc.data_.get());
+            buffer->Update(data);
         }
     }
 
@@ -345,11 +372,11 @@ bool Model::EndLoad()
     {
         IndexBuffer* buffer = indexBuffers_[i];
         IndexBufferDesc& desc = loadIBData_[i];
-        if (desc.data_)
+        if (const unsigned char* data = desc.data_ ? desc.data_.get() : desc.mappedData_)
         {
             buffer->SetShadowed(true);
             buffer->SetSize(desc.indexCount_, desc.indexSize_ > sizeof(unsigned short));
-            buffer->Update(desc.data_.get());
+            buffer->Update(data);
         }
     }
 
@@ -369,6 +396,7 @@ bool Model::EndLoad()
     loadVBData_.clear();
     loadIBData_.clear();
     loadGeometries_.clear();
+    loadMapping_ = nullptr;
     return true;
 }
 
@@ -23,6 +23,7 @@
 #pragma once
 
 #include <EASTL/shared_array.h>
+#include <EASTL/shared_ptr.h>
 
 #include "../Container/Ptr.h"
 #include "../Graphics/GraphicsDefs.h"
@@ -36,6 +37,7 @@ namespace Urho3D
 class Geometry;
 class IndexBuffer;
 class Graphics;
+class MemoryMapping;
 class VertexBuffer;
 
 /// Vertex buffer morph data.
@@ -75,6 +77,8 @@ struct VertexBufferDesc
     unsigned dataSize_;
     /// Vertex data.
     ea::shared_array<unsigned char> data_;
+    /// Vertex data in the memory mapping, used if data_ is empty.
+    const unsigned char* mappedData_{};
 };
 
 /// Description of index buffer data for asynchronous loading.
@@ -88,6 +92,8 @@ struct IndexBufferDesc
     unsigned dataSize_;
     /// Index data.
     ea::shared_array<unsigned char> data_;
+    /// Index data in the memory mapping, used if data_ is empty.
+    const unsigned char* mappedData_{};
 };
 
 /// Description of a geometry for asynchronous loading.
@@ -257,6 +263,8 @@ private:
     ea::vector<IndexBufferDesc> loadIBData_;
     /// Geometry definitions for asynchronous loading.
     ea::vector<ea::vector<GeometryDesc> > loadGeometries_;
+    /// Memory mapping referenced by vertex and index buffer data for asynchronous loading.
+    ea::shared_ptr<MemoryMapping> loadMapping_;
 };
 
 }
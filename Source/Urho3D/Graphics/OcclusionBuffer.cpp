@@ -29,6 +29,12 @@
 #include "../Graphics/OcclusionBuffer.h"
 #include "../IO/Log.h"
 
+#ifdef URHO3D_SSE
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 #include "../DebugNew.h"
 
 namespace Urho3D
@@ -45,6 +51,129 @@ enum ClipMask : unsigned
 };
 URHO3D_FLAGSET(ClipMask, ClipMaskFlags);
 
+namespace
+{
+
+/// Vertex transform with matrix stored in columns for SIMD evaluation.
+struct VertexTransform
+{
+    explicit VertexTransform(const Matrix4& matrix)
+    {
+#ifdef URHO3D_SSE
+        columns_[0] = _mm_setr_ps(matrix.m00_, matrix.m10_, matrix.m20_, matrix.m30_);
+        columns_[1] = _mm_setr_ps(matrix.m01_, matrix.m11_, matrix.m21_, matrix.m31_);
+        columns_[2] = _mm_setr_ps(matrix.m02_, matrix.m12_, matrix.m22_, matrix.m32_);
+        columns_[3] = _mm_setr_ps(matrix.m03_, matrix.m13_, matrix.m23_, matrix.m33_);
+#elif defined(__ARM_NEON)
+        const Matrix4 transposed = matrix.Transpose();
+        for (unsigned i = 0; i < 4; ++i)
+            columns_[i] = vld1q_f32(&transposed.Data()[i * 4]);
+#else
+        matrix_ = matrix;
+#endif
+    }
+
+    /// Transform vertex position.
+    Vector4 Transform(const Vector3& vertex) const
+    {
+        Vector4 result;
+#ifdef URHO3D_SSE
+        const __m128 xy = _mm_add_ps(
+            _mm_mul_ps(columns_[0], _mm_set1_ps(vertex.x_)), _mm_mul_ps(columns_[1], _mm_set1_ps(vertex.y_)));
+        const __m128 zw = _mm_add_ps(_mm_mul_ps(columns_[2], _mm_set1_ps(vertex.z_)), columns_[3]);
+        _mm_storeu_ps(&result.x_, _mm_add_ps(xy, zw));
+#elif defined(__ARM_NEON)
+        float32x4_t value = vmlaq_n_f32(columns_[3], columns_[0], vertex.x_);
+        value = vmlaq_n_f32(value, columns_[1], vertex.y_);
+        value = vmlaq_n_f32(value, columns_[2], vertex.z_);
+        vst1q_f32(&result.x_, value);
+#else
+        result = matrix_ * Vector4(vertex, 1.0f);
+#endif
+        return result;
+    }
+
+#ifdef URHO3D_SSE
+    __m128 columns_[4];
+#elif defined(__ARM_NEON)
+    float32x4_t columns_[4];
+#else
+    Matrix4 matrix_;
+#endif
+};
+
+/// Write minimum of existing and interpolated depth to the span [dest, end).
+inline void FillSpan(int* dest, int* end, int invZ, int dInvZdX)
+{
+#ifdef URHO3D_SSE
+    if (end - dest >= 4)
+    {
+        const __m128i step = _mm_set1_epi32(dInvZdX * 4);
+        __m128i depth = _mm_setr_epi32(invZ, invZ + dInvZdX, invZ + dInvZdX * 2, invZ + dInvZdX * 3);
+        while (end - dest >= 4)
+        {
+            // SSE2 has no signed 32-bit minimum, so blend with comparison mask
+            const __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dest));
+            const __m128i closer = _mm_cmplt_epi32(depth, value);
+            const __m128i result = _mm_or_si128(_mm_and_si128(closer, depth), _mm_andnot_si128(closer, value));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), result);
+
+            depth = _mm_add_epi32(depth, step);
+            invZ += dInvZdX * 4;
+            dest += 4;
+        }
+    }
+#elif defined(__ARM_NEON)
+    if (end - dest >= 4)
+    {
+        const int32x4_t step = vdupq_n_s32(dInvZdX * 4);
+        const int32_t offsets[4] = {0, dInvZdX, dInvZdX * 2, dInvZdX * 3};
+        int32x4_t depth = vaddq_s32(vdupq_n_s32(invZ), vld1q_s32(offsets));
+        while (end - dest >= 4)
+        {
+            vst1q_s32(dest, vminq_s32(depth, vld1q_s32(dest)));
+
+            depth = vaddq_s32(depth, step);
+            invZ += dInvZdX * 4;
+            dest += 4;
+        }
+    }
+#endif
+
+    while (dest < end)
+    {
+        if (invZ < *dest)
+            *dest = invZ;
+        invZ += dInvZdX;
+        ++dest;
+    }
+}
+
+/// Return whether any depth value in [src, end] is greater or equal than given depth.
+inline bool AnyDepthNotCloser(const int* src, const int* end, int depth)
+{
+#ifdef URHO3D_SSE
+    const __m128i threshold = _mm_set1_epi32(depth - 1);
+    while (end - src >= 3)
+    {
+        const __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+        if (_mm_movemask_epi8(_mm_cmpgt_epi32(value, threshold)))
+            return true;
+        src += 4;
+    }
+#endif
+
+    while (src <= end)
+    {
+        if (depth <= *src)
+            return true;
+        ++src;
+    }
+    return false;
+}
+
+}
+
 OcclusionBuffer::OcclusionBuffer(Context* context) :
     Object(context)
 {
@@ -63,6 +192,9 @@ bool OcclusionBuffer::SetSize(int width, int height, bool threaded)
     if (height & 1u)
         ++height;
 
+    auto* workQueue = GetSubsystem<WorkQueue>();
+    threaded_ = threaded && workQueue && workQueue->GetNumProcessingThreads() > 1;
+
     if (width == width_ && height == height_)
         return true;
 
@@ -78,16 +210,18 @@ bool OcclusionBuffer::SetSize(int width, int height, bool threaded)
     width_ = width;
     height_ = height;
 
-    // Build work buffers for threading
-    unsigned numThreadBuffers = threaded ? GetSubsystem<WorkQueue>()->GetNumProcessingThreads() : 1;
-    buffers_.resize(numThreadBuffers);
-    for (unsigned i = 0; i < numThreadBuffers; ++i)
+    // Reserve extra memory in case 3D clipping is not exact
+    buffer_.dataWithSafety_ = new int[width * (height + 2) + 2];
+    buffer_.data_ = buffer_.dataWithSafety_.get() + width + 1;
+
+    // Tiles are written by one thread each, so the buffer is shared between threads
+    numTiles_ = (height + OCCLUSION_TILE_HEIGHT - 1) / OCCLUSION_TILE_HEIGHT;
+    binData_.resize(WorkQueue::GetThreadIndexCount());
+    for (OcclusionBinData& binData : binData_)
     {
-        // Reserve extra memory in case 3D clipping is not exact
-        OcclusionBufferData& buffer = buffers_[i];
-        buffer.dataWithSafety_ = new int[width * (height + 2) + 2];
-        buffer.data_ = buffer.dataWithSafety_.get() + width + 1;
-        buffer.used_ = false;
+        binData.triangles_.clear();
+        binData.tiles_.clear();
+        binData.tiles_.resize(numTiles_);
     }
 
     mipBuffers_.clear();
@@ -105,7 +239,7 @@ bool OcclusionBuffer::SetSize(int width, int height, bool threaded)
     }
 
     URHO3D_LOGDEBUG("Set occlusion buffer size " + ea::to_string(width_) + "x" + ea::to_string(height_) + " with " +
-             ea::to_string(mipBuffers_.size()) + " mip levels and " + ea::to_string(numThreadBuffers) + " thread buffers");
+             ea::to_string(mipBuffers_.size()) + " mip levels and " + ea::to_string(numTiles_) + " tiles");
 
     CalculateViewport();
     return true;
@@ -151,11 +285,7 @@ void OcclusionBuffer::Reset()
 void OcclusionBuffer::Clear()
 {
     Reset();
-
-    // Only clear the main thread buffer. Rest are cleared on-demand when drawing the first batch
-    ClearBuffer(0);
-    for (unsigned i = 1; i < buffers_.size(); ++i)
-        buffers_[i].used_ = false;
+    ClearBuffer();
 
     depthHierarchyDirty_ = true;
 }
@@ -200,33 +330,59 @@ void OcclusionBuffer::DrawTriangles()
 {
     URHO3D_PROFILE("DrawOcclusionBatchWork");
 
-    if (buffers_.size() == 1)
-    {
-        // Not threaded
-        for (auto i = batches_.begin(); i != batches_.end(); ++i)
-            DrawBatch(*i, 0);
+    if (!buffer_.data_)
+        return;
 
-        depthHierarchyDirty_ = true;
+    if (!threaded_)
+    {
+        // Not threaded, rasterize whole triangles immediately
+        OcclusionBinData& binData = binData_[0];
+        for (const OcclusionBatch& batch : batches_)
+            DrawBatch(batch, 0);
+        for (const OcclusionTriangle& triangle : binData.triangles_)
+            DrawTriangle2D(triangle, 0, height_);
     }
-    else if (buffers_.size() > 1)
+    else
     {
-        // Threaded
+        // Threaded, transform and bin batches first, then rasterize each tile in exactly one thread
         auto* queue = GetSubsystem<WorkQueue>();
-        ForEachParallel(queue, batches_, [this](unsigned, const OcclusionBatch& batch)
+        queue->ParallelFor(batches_.size(), 1, [this](unsigned beginIndex, unsigned endIndex, unsigned threadIndex)
         {
-            DrawBatch(batch, WorkQueue::GetThreadIndex());
+            for (unsigned i = beginIndex; i < endIndex; ++i)
+                DrawBatch(batches_[i], threadIndex);
         });
 
-        MergeBuffers();
-        depthHierarchyDirty_ = true;
+        queue->ParallelFor(numTiles_, 1, [this](unsigned beginIndex, unsigned endIndex)
+        {
+            for (unsigned tileIndex = beginIndex; tileIndex < endIndex; ++tileIndex)
+            {
+                const int rowBegin = tileIndex * OCCLUSION_TILE_HEIGHT;
+                const int rowEnd = Min(rowBegin + OCCLUSION_TILE_HEIGHT, height_);
+                for (const OcclusionBinData& binData : binData_)
+                {
+                    for (unsigned triangleIndex : binData.tiles_[tileIndex])
+                        DrawTriangle2D(binData.triangles_[triangleIndex], rowBegin, rowEnd);
+                }
+            }
+        });
+    }
+
+    for (OcclusionBinData& binData : binData_)
+    {
+        numTriangles_ += binData.numTriangles_;
+        binData.numTriangles_ = 0;
+        binData.triangles_.clear();
+        for (ea::vector<unsigned>& tile : binData.tiles_)
+            tile.clear();
     }
 
+    depthHierarchyDirty_ = true;
     batches_.clear();
 }
 
 void OcclusionBuffer::BuildDepthHierarchy()
 {
-    if (buffers_.empty() || !depthHierarchyDirty_)
+    if (!buffer_.data_ || !depthHierarchyDirty_)
         return;
 
     URHO3D_PROFILE("BuildDepthHierarchy");
@@ -238,7 +394,7 @@ void OcclusionBuffer::BuildDepthHierarchy()
     {
         for (int y = 0; y < height; ++y)
         {
-            int* src = buffers_[0].data_ + (y * 2) * width_;
+            int* src = buffer_.data_ + (y * 2) * width_;
             DepthValue* dest = mipBuffers_[0].get() + y * width;
             DepthValue* end = dest + width;
 
@@ -328,49 +484,25 @@ void OcclusionBuffer::ResetUseTimer()
 
 bool OcclusionBuffer::IsVisible(const BoundingBox& worldSpaceBox) const
 {
-    if (buffers_.empty())
+    if (!buffer_.data_)
         return true;
 
-    // Transform corners to projection space
-    Vector4 vertices[8];
-    vertices[0] = ModelTransform(viewProj_, worldSpaceBox.min_);
-    vertices[1] = ModelTransform(viewProj_, Vector3(worldSpaceBox.max_.x_, worldSpaceBox.min_.y_, worldSpaceBox.min_.z_));
-    vertices[2] = ModelTransform(viewProj_, Vector3(worldSpaceBox.min_.x_, worldSpaceBox.max_.y_, worldSpaceBox.min_.z_));
-    vertices[3] = ModelTransform(viewProj_, Vector3(worldSpaceBox.max_.x_, worldSpaceBox.max_.y_, worldSpaceBox.min_.z_));
-    vertices[4] = ModelTransform(viewProj_, Vector3(worldSpaceBox.min_.x_, worldSpaceBox.min_.y_, worldSpaceBox.max_.z_));
-    vertices[5] = ModelTransform(viewProj_, Vector3(worldSpaceBox.max_.x_, worldSpaceBox.min_.y_, worldSpaceBox.max_.z_));
-    vertices[6] = ModelTransform(viewProj_, Vector3(worldSpaceBox.min_.x_, worldSpaceBox.max_.y_, worldSpaceBox.max_.z_));
-    vertices[7] = ModelTransform(viewProj_, worldSpaceBox.max_);
-
-    // Apply a far clip relative bias
-    for (auto& vertice : vertices)
-        vertice.z_ -= OCCLUSION_RELATIVE_BIAS;
-
     // Transform to screen space. If any of the corners cross the near plane, assume visible
-    float minX, maxX, minY, maxY, minZ;
-
-    if (vertices[0].z_ <= 0.0f)
+    Vector3 minProjected;
+    Vector3 maxProjected;
+    if (!ProjectBoundingBox(worldSpaceBox, minProjected, maxProjected))
         return true;
 
-    Vector3 projected = ViewportTransform(vertices[0]);
-    minX = maxX = projected.x_;
-    minY = maxY = projected.y_;
-    minZ = projected.z_;
-
-    // Project the rest
-    for (unsigned i = 1; i < 8; ++i)
-    {
-        if (vertices[i].z_ <= 0.0f)
-            return true;
-
-        projected = ViewportTransform(vertices[i]);
+    return IsProjectedBoxVisible(minProjected, maxProjected);
+}
 
-        if (projected.x_ < minX) minX = projected.x_;
-        if (projected.x_ > maxX) maxX = projected.x_;
-        if (projected.y_ < minY) minY = projected.y_;
-        if (projected.y_ > maxY) maxY = projected.y_;
-        if (projected.z_ < minZ) minZ = projected.z_;
-    }
+bool OcclusionBuffer::IsProjectedBoxVisible(const Vector3& minProjected, const Vector3& maxProjected) const
+{
+    const float minX = minProjected.x_;
+    const float minY = minProjected.y_;
+    const float minZ = minProjected.z_;
+    const float maxX = maxProjected.x_;
+    const float maxY = maxProjected.y_;
 
     // Expand the bounding box 1 pixel in each direction to be conservative and correct rasterization offset
     IntRect rect((int)(minX - 1.5f), (int)(minY - 1.5f), RoundToInt(maxX), RoundToInt(maxY));
@@ -430,24 +562,114 @@ bool OcclusionBuffer::IsVisible(const BoundingBox& worldSpaceBox) const
     }
 
     // If no conclusive result, finally check the pixel-level data
-    int* row = buffers_[0].data_ + rect.top_ * width_;
-    int* endRow = buffers_[0].data_ + rect.bottom_ * width_;
+    int* row = buffer_.data_ + rect.top_ * width_;
+    int* endRow = buffer_.data_ + rect.bottom_ * width_;
     while (row <= endRow)
     {
-        int* src = row + rect.left_;
-        int* end = row + rect.right_;
-        while (src <= end)
-        {
-            if (z <= *src)
-                return true;
-            ++src;
-        }
+        if (AnyDepthNotCloser(row + rect.left_, row + rect.right_, z))
+            return true;
         row += width_;
     }
 
     return false;
 }
 
+void OcclusionBuffer::AreVisible(ea::span<const BoundingBox> worldSpaceBoxes, ea::span<bool> result) const
+{
+    URHO3D_ASSERT(worldSpaceBoxes.size() == result.size());
+
+    if (!buffer_.data_)
+    {
+        ea::fill(result.begin(), result.end(), true);
+        return;
+    }
+
+    const unsigned numBoxes = worldSpaceBoxes.size();
+    unsigned i = 0;
+
+#ifdef URHO3D_SSE
+    // Project 4 boxes at once, one box per lane. Operations match ProjectBoundingBox so the results are the same
+    const Matrix4& m = viewProj_;
+    for (; i + 4 <= numBoxes; i += 4)
+    {
+        if (result[i] && result[i + 1] && result[i + 2] && result[i + 3])
+            continue;
+
+        const BoundingBox* boxes = &worldSpaceBoxes[i];
+        const __m128 boxMinX = _mm_setr_ps(boxes[0].min_.x_, boxes[1].min_.x_, boxes[2].min_.x_, boxes[3].min_.x_);
+        const __m128 boxMinY = _mm_setr_ps(boxes[0].min_.y_, boxes[1].min_.y_, boxes[2].min_.y_, boxes[3].min_.y_);
+        const __m128 boxMinZ = _mm_setr_ps(boxes[0].min_.z_, boxes[1].min_.z_, boxes[2].min_.z_, boxes[3].min_.z_);
+        const __m128 boxMaxX = _mm_setr_ps(boxes[0].max_.x_, boxes[1].max_.x_, boxes[2].max_.x_, boxes[3].max_.x_);
+        const __m128 boxMaxY = _mm_setr_ps(boxes[0].max_.y_, boxes[1].max_.y_, boxes[2].max_.y_, boxes[3].max_.y_);
+        const __m128 boxMaxZ = _mm_setr_ps(boxes[0].max_.z_, boxes[1].max_.z_, boxes[2].max_.z_, boxes[3].max_.z_);
+
+        __m128 minX = _mm_set1_ps(M_INFINITY);
+        __m128 minY = _mm_set1_ps(M_INFINITY);
+        __m128 minZ = _mm_set1_ps(M_INFINITY);
+        __m128 maxX = _mm_set1_ps(-M_INFINITY);
+        __m128 maxY = _mm_set1_ps(-M_INFINITY);
+        __m128 crossesNearPlane = _mm_setzero_ps();
+        for (unsigned corner = 0; corner < 8; ++corner)
+        {
+            const __m128 xs = corner & 1u ? boxMaxX : boxMinX;
+            const __m128 ys = corner & 2u ? boxMaxY : boxMinY;
+            const __m128 zs = corner & 4u ? boxMaxZ : boxMinZ;
+            const auto transformRow = [&](float m0, float m1, float m2, float m3)
+            {
+                const __m128 xy = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(m0), xs), _mm_mul_ps(_mm_set1_ps(m1), ys));
+                return _mm_add_ps(xy, _mm_add_ps(_mm_mul_ps(_mm_set1_ps(m2), zs), _mm_set1_ps(m3)));
+            };
+
+            const __m128 clipX = transformRow(m.m00_, m.m01_, m.m02_, m.m03_);
+            const __m128 clipY = transformRow(m.m10_, m.m11_, m.m12_, m.m13_);
+            // Apply a far clip relative bias
+            const __m128 clipZ = _mm_sub_ps(transformRow(m.m20_, m.m21_, m.m22_, m.m23_), _mm_set1_ps(OCCLUSION_RELATIVE_BIAS));
+            const __m128 clipW = transformRow(m.m30_, m.m31_, m.m32_, m.m33_);
+            crossesNearPlane = _mm_or_ps(crossesNearPlane, _mm_cmple_ps(clipZ, _mm_setzero_ps()));
+
+            const __m128 invW = _mm_div_ps(_mm_set1_ps(1.0f), clipW);
+            const __m128 x = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(invW, clipX), _mm_set1_ps(scaleX_)), _mm_set1_ps(offsetX_));
+            const __m128 y = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(invW, clipY), _mm_set1_ps(scaleY_)), _mm_set1_ps(offsetY_));
+            const __m128 depth = _mm_mul_ps(_mm_mul_ps(invW, clipZ), _mm_set1_ps(OCCLUSION_Z_SCALE));
+
+            minX = _mm_min_ps(minX, x);
+            minY = _mm_min_ps(minY, y);
+            minZ = _mm_min_ps(minZ, depth);
+            maxX = _mm_max_ps(maxX, x);
+            maxY = _mm_max_ps(maxY, y);
+        }
+
+        alignas(16) float minXs[4];
+        alignas(16) float minYs[4];
+        alignas(16) float minZs[4];
+        alignas(16) float maxXs[4];
+        alignas(16) float maxYs[4];
+        _mm_store_ps(minXs, minX);
+        _mm_store_ps(minYs, minY);
+        _mm_store_ps(minZs, minZ);
+        _mm_store_ps(maxXs, maxX);
+        _mm_store_ps(maxYs, maxY);
+
+        // If any of the corners cross the near plane, assume visible
+        const int crossesNearPlaneMask = _mm_movemask_ps(crossesNearPlane);
+        for (unsigned j = 0; j < 4; ++j)
+        {
+            if (!result[i + j])
+            {
+                result[i + j] = (crossesNearPlaneMask & (1 << j))
+                    || IsProjectedBoxVisible(Vector3(minXs[j], minYs[j], minZs[j]), Vector3(maxXs[j], maxYs[j], 0.0f));
+            }
+        }
+    }
+#endif
+
+    for (; i < numBoxes; ++i)
+    {
+        if (!result[i])
+            result[i] = IsVisible(worldSpaceBoxes[i]);
+    }
+}
+
 unsigned OcclusionBuffer::GetUseTimer()
 {
     return useTimer_.GetMSec(false);
@@ -456,14 +678,8 @@ unsigned OcclusionBuffer::GetUseTimer()
 
 void OcclusionBuffer::DrawBatch(const OcclusionBatch& batch, unsigned threadIndex)
 {
-    // If buffer not yet used, clear it
-    if (threadIndex > 0 && !buffers_[threadIndex].used_)
-    {
-        ClearBuffer(threadIndex);
-        buffers_[threadIndex].used_ = true;
-    }
-
-    Matrix4 modelViewProj = viewProj_ * batch.model_;
+    OcclusionBinData& binData = binData_[threadIndex];
+    const VertexTransform modelViewProj{viewProj_ * batch.model_};
 
     // Theoretical max. amount of vertices if each of the 6 clipping planes doubles the triangle count
     Vector4 vertices[64 * 3];
@@ -479,10 +695,10 @@ void OcclusionBuffer::DrawBatch(const OcclusionBatch& batch, unsigned threadInde
             const Vector3& v1 = *((const Vector3*)(&srcData[(index + 1) * batch.vertexSize_]));
             const Vector3& v2 = *((const Vector3*)(&srcData[(index + 2) * batch.vertexSize_]));
 
-            vertices[0] = ModelTransform(modelViewProj, v0);
-            vertices[1] = ModelTransform(modelViewProj, v1);
-            vertices[2] = ModelTransform(modelViewProj, v2);
-            DrawTriangle(vertices, threadIndex);
+            vertices[0] = modelViewProj.Transform(v0);
+            vertices[1] = modelViewProj.Transform(v1);
+            vertices[2] = modelViewProj.Transform(v2);
+            SetupTriangle(vertices, binData);
 
             index += 3;
         }
@@ -503,10 +719,10 @@ void OcclusionBuffer::DrawBatch(const OcclusionBatch& batch, unsigned threadInde
                 const Vector3& v1 = *((const Vector3*)(&srcData[indices[1] * batch.vertexSize_]));
                 const Vector3& v2 = *((const Vector3*)(&srcData[indices[2] * batch.vertexSize_]));
 
-                vertices[0] = ModelTransform(modelViewProj, v0);
-                vertices[1] = ModelTransform(modelViewProj, v1);
-                vertices[2] = ModelTransform(modelViewProj, v2);
-                DrawTriangle(vertices, threadIndex);
+                vertices[0] = modelViewProj.Transform(v0);
+                vertices[1] = modelViewProj.Transform(v1);
+                vertices[2] = modelViewProj.Transform(v2);
+                SetupTriangle(vertices, binData);
 
                 indices += 3;
             }
@@ -522,10 +738,10 @@ void OcclusionBuffer::DrawBatch(const OcclusionBatch& batch, unsigned threadInde
                 const Vector3& v1 = *((const Vector3*)(&srcData[indices[1] * batch.vertexSize_]));
                 const Vector3& v2 = *((const Vector3*)(&srcData[indices[2] * batch.vertexSize_]));
 
-                vertices[0] = ModelTransform(modelViewProj, v0);
-                vertices[1] = ModelTransform(modelViewProj, v1);
-                vertices[2] = ModelTransform(modelViewProj, v2);
-                DrawTriangle(vertices, threadIndex);
+                vertices[0] = modelViewProj.Transform(v0);
+                vertices[1] = modelViewProj.Transform(v1);
+                vertices[2] = modelViewProj.Transform(v2);
+                SetupTriangle(vertices, binData);
 
                 indices += 3;
             }
@@ -533,16 +749,6 @@ void OcclusionBuffer::DrawBatch(const OcclusionBatch& batch, unsigned threadInde
     }
 }
 
-inline Vector4 OcclusionBuffer::ModelTransform(const Matrix4& transform, const Vector3& vertex) const
-{
-    return Vector4(
-        transform.m00_ * vertex.x_ + transform.m01_ * vertex.y_ + transform.m02_ * vertex.z_ + transform.m03_,
-        transform.m10_ * vertex.x_ + transform.m11_ * vertex.y_ + transform.m12_ * vertex.z_ + transform.m13_,
-        transform.m20_ * vertex.x_ + transform.m21_ * vertex.y_ + transform.m22_ * vertex.z_ + transform.m23_,
-        transform.m30_ * vertex.x_ + transform.m31_ * vertex.y_ + transform.m32_ * vertex.z_ + transform.m33_
-    );
-}
-
 inline Vector3 OcclusionBuffer::ViewportTransform(const Vector4& vertex) const
 {
     float invW = 1.0f / vertex.w_;
@@ -579,7 +785,94 @@ void OcclusionBuffer::CalculateViewport()
     projOffsetScaleY_ = projection_.m11_ * scaleY_;
 }
 
-void OcclusionBuffer::DrawTriangle(Vector4* vertices, unsigned threadIndex)
+bool OcclusionBuffer::ProjectBoundingBox(const BoundingBox& worldSpaceBox, Vector3& minProjected, Vector3& maxProjected) const
+{
+    const Matrix4& m = viewProj_;
+    const Vector3& boxMin = worldSpaceBox.min_;
+    const Vector3& boxMax = worldSpaceBox.max_;
+
+#ifdef URHO3D_SSE
+    // Process 4 corners at once, first with minimum Z and then with maximum Z
+    const __m128 xs = _mm_setr_ps(boxMin.x_, boxMax.x_, boxMin.x_, boxMax.x_);
+    const __m128 ys = _mm_setr_ps(boxMin.y_, boxMin.y_, boxMax.y_, boxMax.y_);
+    const auto transformRow = [&](const __m128& zs, float m0, float m1, float m2, float m3)
+    {
+        const __m128 xy = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(m0), xs), _mm_mul_ps(_mm_set1_ps(m1), ys));
+        return _mm_add_ps(xy, _mm_add_ps(_mm_mul_ps(_mm_set1_ps(m2), zs), _mm_set1_ps(m3)));
+    };
+    const auto horizontalMin = [](__m128 value)
+    {
+        value = _mm_min_ps(value, _mm_shuffle_ps(value, value, _MM_SHUFFLE(2, 3, 0, 1)));
+        value = _mm_min_ps(value, _mm_shuffle_ps(value, value, _MM_SHUFFLE(1, 0, 3, 2)));
+        return _mm_cvtss_f32(value);
+    };
+    const auto horizontalMax = [](__m128 value)
+    {
+        value = _mm_max_ps(value, _mm_shuffle_ps(value, value, _MM_SHUFFLE(2, 3, 0, 1)));
+        value = _mm_max_ps(value, _mm_shuffle_ps(value, value, _MM_SHUFFLE(1, 0, 3, 2)));
+        return _mm_cvtss_f32(value);
+    };
+
+    __m128 minX = _mm_set1_ps(M_INFINITY);
+    __m128 minY = _mm_set1_ps(M_INFINITY);
+    __m128 minZ = _mm_set1_ps(M_INFINITY);
+    __m128 maxX = _mm_set1_ps(-M_INFINITY);
+    __m128 maxY = _mm_set1_ps(-M_INFINITY);
+    for (const float z : {boxMin.z_, boxMax.z_})
+    {
+        const __m128 zs = _mm_set1_ps(z);
+        const __m128 clipX = transformRow(zs, m.m00_, m.m01_, m.m02_, m.m03_);
+        const __m128 clipY = transformRow(zs, m.m10_, m.m11_, m.m12_, m.m13_);
+        // Apply a far clip relative bias
+        const __m128 clipZ = _mm_sub_ps(transformRow(zs, m.m20_, m.m21_, m.m22_, m.m23_), _mm_set1_ps(OCCLUSION_RELATIVE_BIAS));
+        const __m128 clipW = transformRow(zs, m.m30_, m.m31_, m.m32_, m.m33_);
+
+        if (_mm_movemask_ps(_mm_cmple_ps(clipZ, _mm_setzero_ps())))
+            return false;
+
+        const __m128 invW = _mm_div_ps(_mm_set1_ps(1.0f), clipW);
+        const __m128 x = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(invW, clipX), _mm_set1_ps(scaleX_)), _mm_set1_ps(offsetX_));
+        const __m128 y = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(invW, clipY), _mm_set1_ps(scaleY_)), _mm_set1_ps(offsetY_));
+        const __m128 depth = _mm_mul_ps(_mm_mul_ps(invW, clipZ), _mm_set1_ps(OCCLUSION_Z_SCALE));
+
+        minX = _mm_min_ps(minX, x);
+        minY = _mm_min_ps(minY, y);
+        minZ = _mm_min_ps(minZ, depth);
+        maxX = _mm_max_ps(maxX, x);
+        maxY = _mm_max_ps(maxY, y);
+    }
+
+    minProjected = Vector3(horizontalMin(minX), horizontalMin(minY), horizontalMin(minZ));
+    maxProjected = Vector3(horizontalMax(maxX), horizontalMax(maxY), 0.0f);
+#else
+    const VertexTransform transform{m};
+    for (unsigned i = 0; i < 8; ++i)
+    {
+        const Vector3 corner{i & 1u ? boxMax.x_ : boxMin.x_, i & 2u ? boxMax.y_ : boxMin.y_, i & 4u ? boxMax.z_ : boxMin.z_};
+        Vector4 vertex = transform.Transform(corner);
+
+        // Apply a far clip relative bias
+        vertex.z_ -= OCCLUSION_RELATIVE_BIAS;
+        if (vertex.z_ <= 0.0f)
+            return false;
+
+        const Vector3 projected = ViewportTransform(vertex);
+        if (i == 0)
+        {
+            minProjected = projected;
+            maxProjected = projected;
+        }
+        else
+        {
+            minProjected = VectorMin(minProjected, projected);
+            maxProjected = VectorMax(maxProjected, projected);
+        }
+    }
+#endif
+    return true;
+}
+
+void OcclusionBuffer::SetupTriangle(Vector4* vertices, OcclusionBinData& binData)
 {
     ClipMaskFlags clipMask{};
     ClipMaskFlags andClipMask{};
@@ -626,7 +919,7 @@ void OcclusionBuffer::DrawTriangle(Vector4* vertices, unsigned threadIndex)
         bool clockwise = SignedArea(projected[0], projected[1], projected[2]) < 0.0f;
         if (cullMode_ == CULL_NONE || (cullMode_ == CULL_CCW && clockwise) || (cullMode_ == CULL_CW && !clockwise))
         {
-            DrawTriangle2D(projected, clockwise, threadIndex);
+            AddTriangle(projected, clockwise, binData);
             drawOk = true;
         }
     }
@@ -664,7 +957,7 @@ void OcclusionBuffer::DrawTriangle(Vector4* vertices, unsigned threadIndex)
                 bool clockwise = SignedArea(projected[0], projected[1], projected[2]) < 0.0f;
                 if (cullMode_ == CULL_NONE || (cullMode_ == CULL_CCW && clockwise) || (cullMode_ == CULL_CW && !clockwise))
                 {
-                    DrawTriangle2D(projected, clockwise, threadIndex);
+                    AddTriangle(projected, clockwise, binData);
                     drawOk = true;
                 }
             }
@@ -672,7 +965,30 @@ void OcclusionBuffer::DrawTriangle(Vector4* vertices, unsigned threadIndex)
     }
 
     if (drawOk)
-        ++numTriangles_;
+        ++binData.numTriangles_;
+}
+
+void OcclusionBuffer::AddTriangle(const Vector3* vertices, bool clockwise, OcclusionBinData& binData)
+{
+    const auto topY = static_cast<int>(Min(vertices[0].y_, Min(vertices[1].y_, vertices[2].y_)));
+    const auto bottomY = static_cast<int>(Max(vertices[0].y_, Max(vertices[1].y_, vertices[2].y_)));
+
+    // Degenerate triangles don't cover any rows
+    if (topY == bottomY)
+        return;
+
+    const unsigned triangleIndex = binData.triangles_.size();
+    binData.triangles_.push_back(OcclusionTriangle{{vertices[0], vertices[1], vertices[2]}, clockwise});
+
+    // Bins are only needed for threaded rasterization
+    if (!threaded_)
+        return;
+
+    // Rows [topY, bottomY) are covered
+    const int firstTile = Clamp(topY, 0, height_ - 1) / OCCLUSION_TILE_HEIGHT;
+    const int lastTile = Clamp(bottomY - 1, 0, height_ - 1) / OCCLUSION_TILE_HEIGHT;
+    for (int tileIndex = firstTile; tileIndex <= lastTile; ++tileIndex)
+        binData.tiles_[tileIndex].push_back(triangleIndex);
 }
 
 void OcclusionBuffer::ClipVertices(const Vector4& plane, Vector4* vertices, bool* triangles, unsigned& numTriangles)
@@ -754,6 +1070,24 @@ struct Gradients
     /// Construct from vertices.
     explicit Gradients(const Vector3* vertices)
     {
+#ifdef URHO3D_SSE
+        // Evaluate determinant and both depth cross products at once in lanes (x, z, z)
+        const __m128 a0 = _mm_setr_ps(vertices[0].x_, vertices[0].z_, vertices[0].z_, 0.0f);
+        const __m128 a1 = _mm_setr_ps(vertices[1].x_, vertices[1].z_, vertices[1].z_, 0.0f);
+        const __m128 a2 = _mm_setr_ps(vertices[2].x_, vertices[2].z_, vertices[2].z_, 0.0f);
+        const __m128 b0 = _mm_setr_ps(vertices[0].y_, vertices[0].y_, vertices[0].x_, 0.0f);
+        const __m128 b1 = _mm_setr_ps(vertices[1].y_, vertices[1].y_, vertices[1].x_, 0.0f);
+        const __m128 b2 = _mm_setr_ps(vertices[2].y_, vertices[2].y_, vertices[2].x_, 0.0f);
+        const __m128 cross = _mm_sub_ps(_mm_mul_ps(_mm_sub_ps(a1, a2), _mm_sub_ps(b0, b2)),
+            _mm_mul_ps(_mm_sub_ps(a0, a2), _mm_sub_ps(b1, b2)));
+
+        const __m128 invdX = _mm_div_ps(_mm_set1_ps(1.0f), _mm_shuffle_ps(cross, cross, _MM_SHUFFLE(0, 0, 0, 0)));
+        alignas(16) float result[4];
+        _mm_store_ps(result, _mm_mul_ps(_mm_mul_ps(invdX, cross), _mm_setr_ps(0.0f, 1.0f, -1.0f, 0.0f)));
+
+        dInvZdX_ = result[1];
+        dInvZdY_ = result[2];
+#else
         float invdX = 1.0f / (((vertices[1].x_ - vertices[2].x_) *
                                (vertices[0].y_ - vertices[2].y_)) -
                               ((vertices[0].x_ - vertices[2].x_) *
@@ -766,6 +1100,7 @@ struct Gradients
 
         dInvZdY_ = invdY * (((vertices[1].z_ - vertices[2].z_) * (vertices[0].x_ - vertices[2].x_)) -
                             ((vertices[0].z_ - vertices[2].z_) * (vertices[1].x_ - vertices[2].x_)));
+#endif
 
         dInvZdXInt_ = (int)dInvZdX_;
     }
@@ -781,6 +1116,8 @@ struct Gradients
 /// %Edge of a software rasterized triangle.
 struct Edge
 {
+    /// Construct uninitialized.
+    Edge() = default;
     /// Construct from gradients and top & bottom vertices.
     Edge(const Gradients& gradients, const Vector3& top, const Vector3& bottom, int topY)
     {
@@ -795,6 +1132,20 @@ struct Edge
         invZStep_ = RoundToInt(slope * gradients.dInvZdX_ + gradients.dInvZdY_);
     }
 
+    /// Step to the next row.
+    void Step()
+    {
+        x_ += xStep_;
+        invZ_ += invZStep_;
+    }
+
+    /// Skip rows.
+    void Advance(int numRows)
+    {
+        x_ += xStep_ * numRows;
+        invZ_ += invZStep_ * numRows;
+    }
+
     /// X coordinate.
     int x_;
     /// X coordinate step.
@@ -805,8 +1156,107 @@ struct Edge
     int invZStep_;
 };
 
-void OcclusionBuffer::DrawTriangle2D(const Vector3* vertices, bool clockwise, unsigned threadIndex)
+#ifdef URHO3D_SSE
+/// Round to nearest integer with halfway cases rounded away from zero, same as RoundToInt.
+static inline __m128i RoundToIntSSE(__m128 value)
+{
+    const __m128i truncated = _mm_cvttps_epi32(value);
+    const __m128 fraction = _mm_sub_ps(value, _mm_cvtepi32_ps(truncated));
+    // Comparison masks are -1 in matching lanes. Out of range values are left as is, same as scalar conversion
+    const __m128i outOfRange = _mm_cmpeq_epi32(truncated, _mm_set1_epi32(M_MIN_INT));
+    const __m128i roundUp = _mm_andnot_si128(outOfRange, _mm_castps_si128(_mm_cmpge_ps(fraction, _mm_set1_ps(0.5f))));
+    const __m128i roundDown = _mm_andnot_si128(outOfRange, _mm_castps_si128(_mm_cmple_ps(fraction, _mm_set1_ps(-0.5f))));
+    return _mm_add_epi32(_mm_sub_epi32(truncated, roundUp), roundDown);
+}
+#endif
+
+/// Set up top-to-bottom, top-to-middle and middle-to-bottom edges of the triangle.
+static void SetupEdges(const Gradients& gradients, const Vector3& top, const Vector3& middle, const Vector3& bottom,
+    int topY, int middleY, Edge (&edges)[3])
+{
+#ifdef URHO3D_SSE
+    // Evaluate all edges at once, one edge per lane
+    const __m128 beginX = _mm_setr_ps(top.x_, top.x_, middle.x_, 0.0f);
+    const __m128 beginY = _mm_setr_ps(top.y_, top.y_, middle.y_, 0.0f);
+    const __m128 beginZ = _mm_setr_ps(top.z_, top.z_, middle.z_, 0.0f);
+    const __m128 endX = _mm_setr_ps(bottom.x_, middle.x_, bottom.x_, 0.0f);
+    const __m128 endY = _mm_setr_ps(bottom.y_, middle.y_, bottom.y_, 0.0f);
+    const __m128i beginRow = _mm_setr_epi32(topY + 1, topY + 1, middleY + 1, 0);
+    const __m128 dInvZdX = _mm_set1_ps(gradients.dInvZdX_);
+    const __m128 dInvZdY = _mm_set1_ps(gradients.dInvZdY_);
+    const __m128 scaleX = _mm_set1_ps(OCCLUSION_X_SCALE);
+
+    const __m128 height = _mm_sub_ps(endY, beginY);
+    const __m128 hasHeight = _mm_cmpneq_ps(height, _mm_setzero_ps());
+    const __m128 slope = _mm_and_ps(hasHeight, _mm_div_ps(_mm_sub_ps(endX, beginX), height));
+    const __m128 yPreStep = _mm_sub_ps(_mm_cvtepi32_ps(beginRow), beginY);
+    const __m128 xPreStep = _mm_mul_ps(slope, yPreStep);
+
+    alignas(16) int x[4];
+    alignas(16) int xStep[4];
+    alignas(16) int invZ[4];
+    alignas(16) int invZStep[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(x), RoundToIntSSE(_mm_mul_ps(_mm_add_ps(xPreStep, beginX), scaleX)));
+    _mm_store_si128(reinterpret_cast<__m128i*>(xStep), RoundToIntSSE(_mm_mul_ps(slope, scaleX)));
+    _mm_store_si128(reinterpret_cast<__m128i*>(invZ), RoundToIntSSE(
+        _mm_add_ps(_mm_add_ps(beginZ, _mm_mul_ps(xPreStep, dInvZdX)), _mm_mul_ps(yPreStep, dInvZdY))));
+    _mm_store_si128(reinterpret_cast<__m128i*>(invZStep),
+        RoundToIntSSE(_mm_add_ps(_mm_mul_ps(slope, dInvZdX), dInvZdY)));
+
+    for (unsigned i = 0; i < 3; ++i)
+    {
+        edges[i].x_ = x[i];
+        edges[i].xStep_ = xStep[i];
+        edges[i].invZ_ = invZ[i];
+        edges[i].invZStep_ = invZStep[i];
+    }
+#else
+    edges[0] = Edge(gradients, top, bottom, topY);
+    edges[1] = Edge(gradients, top, middle, topY);
+    edges[2] = Edge(gradients, middle, bottom, middleY);
+#endif
+}
+
+/// Draw spans between left and right edges for rows [beginY, endY) clipped to rows [rowBegin, rowEnd).
+/// Spans are clipped horizontally so that threads drawing different rows never touch the same pixels.
+static void DrawSpans(int* bufferData, int width, int dInvZdX, Edge& left, Edge& right,
+    int beginY, int endY, int rowBegin, int rowEnd)
 {
+    // Skip rows above the clip range
+    const int firstY = Max(beginY, Min(rowBegin, endY));
+    if (firstY > beginY)
+    {
+        left.Advance(firstY - beginY);
+        right.Advance(firstY - beginY);
+    }
+
+    const int lastY = Max(firstY, Min(endY, rowEnd));
+    int* row = bufferData + firstY * width;
+    for (int y = firstY; y < lastY; ++y)
+    {
+        const int leftX = left.x_ >> 16u;
+        const int rightX = Min(right.x_ >> 16u, width);
+        if (leftX >= 0)
+            FillSpan(row + leftX, row + rightX, left.invZ_, dInvZdX);
+        else
+            FillSpan(row, row + rightX, left.invZ_ - leftX * dInvZdX, dInvZdX);
+
+        left.Step();
+        right.Step();
+        row += width;
+    }
+
+    // Skip rows below the clip range, edges may be used for the next half of the triangle
+    if (endY > lastY)
+    {
+        left.Advance(endY - lastY);
+        right.Advance(endY - lastY);
+    }
+}
+
+void OcclusionBuffer::DrawTriangle2D(const OcclusionTriangle& triangle, int rowBegin, int rowEnd)
+{
+    const Vector3* vertices = triangle.vertices_;
     int top, middle, bottom;
     bool middleIsRight;
 
@@ -868,162 +1318,55 @@ void OcclusionBuffer::DrawTriangle2D(const Vector3* vertices, bool clockwise, un
     auto middleY = (int)vertices[middle].y_;
     auto bottomY = (int)vertices[bottom].y_;
 
-    // Check for degenerate triangle
-    if (topY == bottomY)
+    // Check for degenerate triangle or triangle outside of the clip range
+    if (topY == bottomY || topY >= rowEnd || bottomY <= rowBegin)
         return;
 
     // Reverse middleIsRight test if triangle is counterclockwise
-    if (!clockwise)
+    if (!triangle.clockwise_)
         middleIsRight = !middleIsRight;
 
     const bool topDegenerate = topY == middleY;
     const bool bottomDegenerate = middleY == bottomY;
 
     Gradients gradients(vertices);
-    Edge topToBottom(gradients, vertices[top], vertices[bottom], topY);
+    Edge edges[3];
+    SetupEdges(gradients, vertices[top], vertices[middle], vertices[bottom], topY, middleY, edges);
+    Edge& topToBottom = edges[0];
+    Edge& topToMiddle = edges[1];
+    Edge& middleToBottom = edges[2];
 
-    int* bufferData = buffers_[threadIndex].data_;
+    int* bufferData = buffer_.data_;
+    const int dInvZdX = gradients.dInvZdXInt_;
 
     if (middleIsRight)
     {
         // Top half
         if (!topDegenerate)
-        {
-            Edge topToMiddle(gradients, vertices[top], vertices[middle], topY);
-            int* row = bufferData + topY * width_;
-            int* endRow = bufferData + middleY * width_;
-            while (row < endRow)
-            {
-                int invZ = topToBottom.invZ_;
-                int* dest = row + (topToBottom.x_ >> 16u);
-                int* end = row + (topToMiddle.x_ >> 16u);
-                while (dest < end)
-                {
-                    if (invZ < *dest)
-                        *dest = invZ;
-                    invZ += gradients.dInvZdXInt_;
-                    ++dest;
-                }
-
-                topToBottom.x_ += topToBottom.xStep_;
-                topToBottom.invZ_ += topToBottom.invZStep_;
-                topToMiddle.x_ += topToMiddle.xStep_;
-                row += width_;
-            }
-        }
+            DrawSpans(bufferData, width_, dInvZdX, topToBottom, topToMiddle, topY, middleY, rowBegin, rowEnd);
 
         // Bottom half
         if (!bottomDegenerate)
-        {
-            Edge middleToBottom(gradients, vertices[middle], vertices[bottom], middleY);
-            int* row = bufferData + middleY * width_;
-            int* endRow = bufferData + bottomY * width_;
-            while (row < endRow)
-            {
-                int invZ = topToBottom.invZ_;
-                int* dest = row + (topToBottom.x_ >> 16u);
-                int* end = row + (middleToBottom.x_ >> 16u);
-                while (dest < end)
-                {
-                    if (invZ < *dest)
-                        *dest = invZ;
-                    invZ += gradients.dInvZdXInt_;
-                    ++dest;
-                }
-
-                topToBottom.x_ += topToBottom.xStep_;
-                topToBottom.invZ_ += topToBottom.invZStep_;
-                middleToBottom.x_ += middleToBottom.xStep_;
-                row += width_;
-            }
-        }
+            DrawSpans(bufferData, width_, dInvZdX, topToBottom, middleToBottom, middleY, bottomY, rowBegin, rowEnd);
     }
     else
     {
         // Top half
         if (!topDegenerate)
-        {
-            Edge topToMiddle(gradients, vertices[top], vertices[middle], topY);
-            int* row = bufferData + topY * width_;
-            int* endRow = bufferData + middleY * width_;
-            while (row < endRow)
-            {
-                int invZ = topToMiddle.invZ_;
-                int* dest = row + (topToMiddle.x_ >> 16u);
-                int* end = row + (topToBottom.x_ >> 16u);
-                while (dest < end)
-                {
-                    if (invZ < *dest)
-                        *dest = invZ;
-                    invZ += gradients.dInvZdXInt_;
-                    ++dest;
-                }
-
-                topToMiddle.x_ += topToMiddle.xStep_;
-                topToMiddle.invZ_ += topToMiddle.invZStep_;
-                topToBottom.x_ += topToBottom.xStep_;
-                row += width_;
-            }
-        }
+            DrawSpans(bufferData, width_, dInvZdX, topToMiddle, topToBottom, topY, middleY, rowBegin, rowEnd);
 
         // Bottom half
         if (!bottomDegenerate)
-        {
-            Edge middleToBottom(gradients, vertices[middle], vertices[bottom], middleY);
-            int* row = bufferData + middleY * width_;
-            int* endRow = bufferData + bottomY * width_;
-            while (row < endRow)
-            {
-                int invZ = middleToBottom.invZ_;
-                int* dest = row + (middleToBottom.x_ >> 16u);
-                int* end = row + (topToBottom.x_ >> 16u);
-                while (dest < end)
-                {
-                    if (invZ < *dest)
-                        *dest = invZ;
-                    invZ += gradients.dInvZdXInt_;
-                    ++dest;
-                }
-
-                middleToBottom.x_ += middleToBottom.xStep_;
-                middleToBottom.invZ_ += middleToBottom.invZStep_;
-                topToBottom.x_ += topToBottom.xStep_;
-                row += width_;
-            }
-        }
-    }
-}
-
-void OcclusionBuffer::MergeBuffers()
-{
-    URHO3D_PROFILE("MergeBuffers");
-
-    for (unsigned i = 1; i < buffers_.size(); ++i)
-    {
-        if (!buffers_[i].used_)
-            continue;
-
-        int* src = buffers_[i].data_;
-        int* dest = buffers_[0].data_;
-        int count = width_ * height_;
-
-        while (count--)
-        {
-            // If thread buffer's depth value is closer, overwrite the original
-            if (*src < *dest)
-                *dest = *src;
-            ++src;
-            ++dest;
-        }
+            DrawSpans(bufferData, width_, dInvZdX, middleToBottom, topToBottom, middleY, bottomY, rowBegin, rowEnd);
     }
 }
 
-void OcclusionBuffer::ClearBuffer(unsigned threadIndex)
+void OcclusionBuffer::ClearBuffer()
 {
-    if (threadIndex >= buffers_.size())
+    if (!buffer_.data_)
         return;
 
-    int* dest = buffers_[threadIndex].data_;
+    int* dest = buffer_.data_;
     int count = width_ * height_;
     auto fillValue = (int)OCCLUSION_Z_SCALE;
 
@@ -25,6 +25,7 @@
 #pragma once
 
 #include <EASTL/shared_array.h>
+#include <EASTL/span.h>
 
 #include "../Core/Object.h"
 #include "../Core/Timer.h"
@@ -51,15 +52,33 @@ struct DepthValue
     int max_;
 };
 
-/// Per-thread occlusion buffer data.
+/// Occlusion buffer data.
 struct OcclusionBufferData
 {
     /// Full buffer data with safety padding.
     ea::shared_array<int> dataWithSafety_;
     /// Buffer data.
-    int* data_;
-    /// Use flag.
-    bool used_;
+    int* data_{};
+};
+
+/// Clipped and projected occluder triangle waiting for rasterization.
+struct OcclusionTriangle
+{
+    /// Vertices in screen space.
+    Vector3 vertices_[3];
+    /// Whether the triangle is clockwise.
+    bool clockwise_;
+};
+
+/// Per-thread triangles binned into screen tiles.
+struct OcclusionBinData
+{
+    /// Triangles.
+    ea::vector<OcclusionTriangle> triangles_;
+    /// Indices of triangles overlapping each tile.
+    ea::vector<ea::vector<unsigned>> tiles_;
+    /// Number of source triangles that produced any visible triangle.
+    unsigned numTriangles_{};
 };
 
 /// Stored occlusion render job.
@@ -87,6 +106,7 @@ static const float OCCLUSION_RELATIVE_BIAS = 0.00001f;
 static const int OCCLUSION_FIXED_BIAS = 16;
 static const float OCCLUSION_X_SCALE = 65536.0f;
 static const float OCCLUSION_Z_SCALE = 16777216.0f;
+static const int OCCLUSION_TILE_HEIGHT = 16;
 
 /// Software renderer for occlusion.
 class URHO3D_API OcclusionBuffer : public Object
@@ -102,7 +122,7 @@ public:
     /// Register object with the engine.
     static void RegisterObject(Context* context);
 
-    /// Set occlusion buffer size and whether to reserve multiple buffers for threading optimization.
+    /// Set occlusion buffer size and whether to rasterize screen tiles in worker threads.
     bool SetSize(int width, int height, bool threaded);
     /// Set camera view to render from.
     void SetView(Camera* camera);
@@ -119,7 +139,7 @@ public:
     /// Submit a triangle mesh to the buffer using indexed geometry. Return true if did not overflow the allowed triangle count.
     bool AddTriangles(const Matrix3x4& model, const void* vertexData, unsigned vertexSize, const void* indexData, unsigned indexSize,
         unsigned indexStart, unsigned indexCount);
-    /// Draw submitted batches. Uses worker threads if enabled during SetSize().
+    /// Draw submitted batches. Bins triangles into screen tiles and rasterizes tiles in worker threads if enabled during SetSize().
     void DrawTriangles();
     /// Build reduced size mip levels.
     void BuildDepthHierarchy();
@@ -127,7 +147,7 @@ public:
     void ResetUseTimer();
 
     /// Return highest level depth values.
-    int* GetBuffer() const { return buffers_.size() ? buffers_[0].data_ : nullptr; }
+    int* GetBuffer() const { return buffer_.data_; }
 
     /// Return view transform matrix.
     const Matrix3x4& GetView() const { return view_; }
@@ -151,19 +171,19 @@ public:
     CullMode GetCullMode() const { return cullMode_; }
 
     /// Return whether is using threads to speed up rendering.
-    bool IsThreaded() const { return buffers_.size() > 1; }
+    bool IsThreaded() const { return threaded_; }
 
     /// Test a bounding box for visibility. For best performance, build depth hierarchy first.
     bool IsVisible(const BoundingBox& worldSpaceBox) const;
+    /// Test multiple bounding boxes for visibility. Result is OR-ed into the output, so several buffers may be tested in turn.
+    void AreVisible(ea::span<const BoundingBox> worldSpaceBoxes, ea::span<bool> result) const;
     /// Return time since last use in milliseconds.
     unsigned GetUseTimer();
 
-    /// Draw a batch. Called internally.
+    /// Transform, clip and bin triangles of a batch. Called internally.
     void DrawBatch(const OcclusionBatch& batch, unsigned threadIndex);
 
 private:
-    /// Apply modelview transform to vertex.
-    inline Vector4 ModelTransform(const Matrix4& transform, const Vector3& vertex) const;
     /// Apply projection and viewport transform to vertex.
     inline Vector3 ViewportTransform(const Vector4& vertex) const;
     /// Clip an edge.
@@ -172,19 +192,25 @@ private:
     inline float SignedArea(const Vector3& v0, const Vector3& v1, const Vector3& v2) const;
     /// Calculate viewport transform.
     void CalculateViewport();
-    /// Draw a triangle.
-    void DrawTriangle(Vector4* vertices, unsigned threadIndex);
+    /// Project bounding box to screen space. Return false if the box crosses the near plane.
+    bool ProjectBoundingBox(const BoundingBox& worldSpaceBox, Vector3& minProjected, Vector3& maxProjected) const;
+    /// Test screen space bounding box against the depth buffer.
+    bool IsProjectedBoxVisible(const Vector3& minProjected, const Vector3& maxProjected) const;
+    /// Clip, project and bin a triangle.
+    void SetupTriangle(Vector4* vertices, OcclusionBinData& binData);
+    /// Add projected triangle to the bins.
+    void AddTriangle(const Vector3* vertices, bool clockwise, OcclusionBinData& binData);
     /// Clip vertices against a plane.
     void ClipVertices(const Vector4& plane, Vector4* vertices, bool* triangles, unsigned& numTriangles);
-    /// Draw a clipped triangle.
-    void DrawTriangle2D(const Vector3* vertices, bool clockwise, unsigned threadIndex);
-    /// Clear a thread work buffer.
-    void ClearBuffer(unsigned threadIndex);
-    /// Merge thread work buffers into the first buffer.
-    void MergeBuffers();
-
-    /// Highest-level buffer data per thread.
-    ea::vector<OcclusionBufferData> buffers_;
+    /// Draw rows [rowBegin, rowEnd) of a projected triangle.
+    void DrawTriangle2D(const OcclusionTriangle& triangle, int rowBegin, int rowEnd);
+    /// Clear the buffer data.
+    void ClearBuffer();
+
+    /// Highest-level buffer data.
+    OcclusionBufferData buffer_;
+    /// Binned triangles per thread.
+    ea::vector<OcclusionBinData> binData_;
     /// Reduced size depth buffers.
     ea::vector<ea::shared_array<DepthValue> > mipBuffers_;
     /// Submitted render jobs.
@@ -193,6 +219,10 @@ private:
     int width_{};
     /// Buffer height.
     int height_{};
+    /// Number of screen tiles.
+    int numTiles_{};
+    /// Whether to rasterize tiles in worker threads.
+    bool threaded_{};
     /// Number of rendered triangles.
     unsigned numTriangles_{};
     /// Maximum number of triangles.
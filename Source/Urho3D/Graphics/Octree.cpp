@@ -50,6 +50,11 @@ namespace Urho3D
 static const float DEFAULT_OCTREE_SIZE = 1000.0f;
 static const int DEFAULT_OCTREE_LEVELS = 8;
 
+static const ea::vector<ea::string> spatialIndexTypeNames = {
+    "Octree",
+    "BVH",
+};
+
 inline bool CompareRayQueryResults(const RayQueryResult& lhs, const RayQueryResult& rhs)
 {
     return lhs.distance_ < rhs.distance_;
@@ -420,6 +425,15 @@ Octree::~Octree()
     // Reset root pointer from all child octants now so that they do not move their drawables to root
     drawableUpdates_.clear();
     rootOctant_.ResetOctree();
+
+    if (spatialIndexType_ == SpatialIndexType::BVH)
+    {
+        for (Drawable* drawable : drawables_)
+        {
+            drawable->SetOctant(nullptr);
+            drawable->SetDrawableIndex(M_MAX_UNSIGNED);
+        }
+    }
 }
 
 void Octree::RegisterObject(Context* context)
@@ -432,6 +446,7 @@ void Octree::RegisterObject(Context* context)
     URHO3D_ATTRIBUTE_EX("Bounding Box Min", Vector3, worldBoundingBox_.min_, UpdateOctreeSize, defaultBoundsMin, AM_DEFAULT);
     URHO3D_ATTRIBUTE_EX("Bounding Box Max", Vector3, worldBoundingBox_.max_, UpdateOctreeSize, defaultBoundsMax, AM_DEFAULT);
     URHO3D_ATTRIBUTE_EX("Number of Levels", int, numLevels_, UpdateOctreeSize, DEFAULT_OCTREE_LEVELS, AM_DEFAULT);
+    URHO3D_ENUM_ACCESSOR_ATTRIBUTE("Spatial Index", GetSpatialIndexType, SetSpatialIndexType, SpatialIndexType, spatialIndexTypeNames, SpatialIndexType::Octree, AM_DEFAULT);
 }
 
 void Octree::DrawDebugGeometry(DebugRenderer* debug, bool depthTest)
@@ -440,7 +455,10 @@ void Octree::DrawDebugGeometry(DebugRenderer* debug, bool depthTest)
     {
         URHO3D_PROFILE("OctreeDrawDebug");
 
-        rootOctant_.DrawDebugGeometry(debug, depthTest);
+        if (spatialIndexType_ == SpatialIndexType::BVH)
+            bvh_.DrawDebugGeometry(debug, depthTest);
+        else
+            rootOctant_.DrawDebugGeometry(debug, depthTest);
     }
 }
 
@@ -453,6 +471,37 @@ void Octree::SetSize(const BoundingBox& box, unsigned numLevels)
     numLevels_ = Max(numLevels, 1U);
 }
 
+void Octree::SetSpatialIndexType(SpatialIndexType type)
+{
+    if (spatialIndexType_ == type)
+        return;
+
+    URHO3D_PROFILE("ChangeSpatialIndex");
+
+    spatialIndexType_ = type;
+    if (type == SpatialIndexType::BVH)
+    {
+        // Drawables in BVH refer to the empty root octant
+        for (Drawable* drawable : drawables_)
+        {
+            drawable->GetOctant()->RemoveDrawable(drawable, false);
+            drawable->SetOctant(&rootOctant_);
+            bvh_.AddDrawable(drawable);
+        }
+        rootOctant_.SetRootSize(worldBoundingBox_);
+        bvh_.Rebuild(GetSubsystem<WorkQueue>());
+    }
+    else
+    {
+        bvh_.Clear();
+        for (Drawable* drawable : drawables_)
+        {
+            drawable->SetOctant(nullptr);
+            rootOctant_.InsertDrawable(drawable);
+        }
+    }
+}
+
 void Octree::Update(const FrameInfo& frame)
 {
     if (!Thread::IsMainThread())
@@ -461,6 +510,10 @@ void Octree::Update(const FrameInfo& frame)
         return;
     }
 
+    // Commit transforms of nodes moved after scene update, so that their drawables are queued for update
+    if (Scene* scene = GetScene())
+        scene->UpdateTransforms();
+
     // Let drawables update themselves before reinsertion. This can be used for animation
     if (!drawableUpdates_.empty())
     {
@@ -474,10 +527,13 @@ void Octree::Update(const FrameInfo& frame)
 
         pendingNodeTransforms_.Clear();
 
-        ForEachParallel(queue, drawableUpdates_, [this, &frame](unsigned, Drawable* drawable)
+        queue->ParallelFor(drawableUpdates_.size(), DrawablesPerTask, [this, &frame](unsigned beginIndex, unsigned endIndex)
         {
-            if (drawable)
-                drawable->Update(frame);
+            for (unsigned i = beginIndex; i < endIndex; ++i)
+            {
+                if (Drawable* drawable = drawableUpdates_[i])
+                    drawable->Update(frame);
+            }
         });
 
         scene->EndThreadedUpdate();
@@ -521,9 +577,26 @@ void Octree::Update(const FrameInfo& frame)
         scene->SendEvent(E_SCENEDRAWABLEUPDATEFINISHED, eventData);
     }
 
+    // Update bounding boxes in BVH and refit or rebuild it
+    if (spatialIndexType_ == SpatialIndexType::BVH)
+    {
+        URHO3D_PROFILE("UpdateBVH");
+
+        // Skip drawables that do not belong to this octree anymore
+        const auto isRemoved = [this](Drawable* drawable)
+        {
+            drawable->updateQueued_ = false;
+            Octant* octant = drawable->GetOctant();
+            return !octant || octant->GetOctree() != this;
+        };
+        drawableUpdates_.erase(ea::remove_if(drawableUpdates_.begin(), drawableUpdates_.end(), isRemoved), drawableUpdates_.end());
+
+        bvh_.UpdateDrawables(drawableUpdates_);
+        bvh_.Commit(GetSubsystem<WorkQueue>());
+    }
     // Reinsert drawables that have been moved or resized, or that have been newly added to the octree and do not sit inside
     // the proper octant yet
-    if (!drawableUpdates_.empty())
+    else if (!drawableUpdates_.empty())
     {
         URHO3D_PROFILE("ReinsertToOctree");
 
@@ -604,7 +677,13 @@ void Octree::AddDrawable(Drawable* drawable)
     drawable->SetDrawableIndex(index);
 
     // Insert drawable to common Octree
-    rootOctant_.InsertDrawable(drawable);
+    if (spatialIndexType_ == SpatialIndexType::BVH)
+    {
+        drawable->SetOctant(&rootOctant_);
+        bvh_.AddDrawable(drawable);
+    }
+    else
+        rootOctant_.InsertDrawable(drawable);
 
     // Insert drawable to zone index
     if (drawable->GetDrawableFlags().Test(DRAWABLE_ZONE))
@@ -631,7 +710,13 @@ void Octree::RemoveDrawable(Drawable* drawable, Octant* octant)
     }
 
     // Remove drawable from Octree
-    octant->RemoveDrawable(drawable);
+    if (spatialIndexType_ == SpatialIndexType::BVH)
+    {
+        bvh_.RemoveDrawable(drawable);
+        drawable->SetOctant(nullptr);
+    }
+    else
+        octant->RemoveDrawable(drawable);
 
     // Remove drawable from Zone index
     if (drawable->GetDrawableFlags().Test(DRAWABLE_ZONE))
@@ -646,6 +731,7 @@ void Octree::RemoveDrawable(Drawable* drawable, Octant* octant)
     {
         Drawable* replacement = drawables_.back();
         drawables_[index] = replacement;
+        bvh_.RenameDrawable(replacement->GetDrawableIndex(), index);
         replacement->SetDrawableIndex(index);
     }
     drawables_.pop_back();
@@ -664,7 +750,10 @@ void Octree::MarkZoneDirty(Zone* zone)
 void Octree::GetDrawables(OctreeQuery& query) const
 {
     query.result_.clear();
-    rootOctant_.GetDrawablesInternal(query, false);
+    if (spatialIndexType_ == SpatialIndexType::BVH)
+        bvh_.GetDrawables(query);
+    else
+        rootOctant_.GetDrawablesInternal(query, false);
 }
 
 void Octree::Raycast(RayOctreeQuery& query) const
@@ -672,7 +761,15 @@ void Octree::Raycast(RayOctreeQuery& query) const
     URHO3D_PROFILE("Raycast");
 
     query.result_.clear();
-    rootOctant_.GetDrawablesInternal(query);
+    if (spatialIndexType_ == SpatialIndexType::BVH)
+    {
+        rayQueryDrawables_.clear();
+        bvh_.GetDrawables(query, rayQueryDrawables_);
+        for (Drawable* drawable : rayQueryDrawables_)
+            drawable->ProcessRayQuery(query, query.result_);
+    }
+    else
+        rootOctant_.GetDrawablesInternal(query);
     ea::quick_sort(query.result_.begin(), query.result_.end(), CompareRayQueryResults);
 }
 
@@ -682,7 +779,10 @@ void Octree::RaycastSingle(RayOctreeQuery& query) const
 
     query.result_.clear();
     rayQueryDrawables_.clear();
-    rootOctant_.GetDrawablesOnlyInternal(query, rayQueryDrawables_);
+    if (spatialIndexType_ == SpatialIndexType::BVH)
+        bvh_.GetDrawables(query, rayQueryDrawables_);
+    else
+        rootOctant_.GetDrawablesOnlyInternal(query, rayQueryDrawables_);
 
     // Sort by increasing hit distance to AABB
     for (auto i = rayQueryDrawables_.begin(); i != rayQueryDrawables_.end(); ++i)
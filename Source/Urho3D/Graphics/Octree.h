@@ -26,6 +26,7 @@
 #include "../Core/Mutex.h"
 #include "../Core/WorkQueue.h"
 #include "../Graphics/Drawable.h"
+#include "../Graphics/DrawableBVH.h"
 #include "../Graphics/OctreeQuery.h"
 #include "../Math/Transform.h"
 
@@ -210,12 +211,24 @@ private:
     bool zonesDirty_{};
 };
 
+/// Spatial index used by Octree to store drawables.
+enum class SpatialIndexType
+{
+    /// Loose octree. Drawables are reinserted when they leave their octant.
+    Octree,
+    /// Bounding volume hierarchy that is refit on update and rebuilt occasionally. Better for many moving drawables.
+    BVH,
+};
+
 /// %Octree component. Should be added only to the root scene node.
 class URHO3D_API Octree : public Component
 {
     URHO3D_OBJECT(Octree, Component);
 
 public:
+    /// Minimal number of drawables updated by one task.
+    static constexpr unsigned DrawablesPerTask = 16;
+
     /// Construct.
     explicit Octree(Context* context);
     /// Destruct.
@@ -229,6 +242,9 @@ public:
 
     /// Set size and maximum subdivision levels. If octree is not empty, drawable objects will be temporarily moved to the root.
     void SetSize(const BoundingBox& box, unsigned numLevels);
+    /// Set spatial index type. Drawable objects are moved to the new index.
+    /// @property
+    void SetSpatialIndexType(SpatialIndexType type);
     /// Update and reinsert drawable objects.
     void Update(const FrameInfo& frame);
     /// Add a drawable manually.
@@ -267,6 +283,13 @@ public:
     /// @property
     unsigned GetNumLevels() const { return numLevels_; }
 
+    /// Return spatial index type.
+    /// @property
+    SpatialIndexType GetSpatialIndexType() const { return spatialIndexType_; }
+
+    /// Return bounding volume hierarchy. Used only if spatial index type is BVH.
+    const DrawableBVH& GetBVH() const { return bvh_; }
+
     /// Return all drawables in all octants.
     const ea::vector<Drawable*>& GetAllDrawables() const { return drawables_; }
 
@@ -288,6 +311,10 @@ private:
 
     /// Root octant.
     Octant rootOctant_;
+    /// Spatial index type.
+    SpatialIndexType spatialIndexType_{SpatialIndexType::Octree};
+    /// Bounding volume hierarchy. Drawables refer to the root octant when stored here.
+    DrawableBVH bvh_;
     /// Drawable objects that require update.
     ea::vector<Drawable*> drawableUpdates_;
     /// Drawable objects that were inserted during threaded update phase.
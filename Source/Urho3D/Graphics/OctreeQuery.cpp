@@ -24,11 +24,228 @@
 
 #include "../Graphics/OctreeQuery.h"
 
+#ifdef URHO3D_SSE
+#include <emmintrin.h>
+#endif
+
 #include "../DebugNew.h"
 
 namespace Urho3D
 {
 
+namespace
+{
+
+/// Max number of drawables forwarded to TestDrawables at once.
+static constexpr unsigned MaxDrawableBatchSize = 64;
+
+#ifdef URHO3D_SSE
+/// Load up to 4 floats, missing values are zero.
+inline __m128 LoadPartial(const float* data, unsigned count)
+{
+    if (count >= 4)
+        return _mm_loadu_ps(data);
+
+    float values[4]{};
+    for (unsigned i = 0; i < count; ++i)
+        values[i] = data[i];
+    return _mm_loadu_ps(values);
+}
+
+/// Box coordinates of 4 boxes.
+struct BoxQuad
+{
+    BoxQuad(const BoundingBoxBatch& boxes, unsigned offset)
+    {
+        const unsigned count = boxes.size_ - offset;
+        minX_ = LoadPartial(boxes.minX_ + offset, count);
+        minY_ = LoadPartial(boxes.minY_ + offset, count);
+        minZ_ = LoadPartial(boxes.minZ_ + offset, count);
+        maxX_ = LoadPartial(boxes.maxX_ + offset, count);
+        maxY_ = LoadPartial(boxes.maxY_ + offset, count);
+        maxZ_ = LoadPartial(boxes.maxZ_ + offset, count);
+    }
+
+    __m128 minX_, minY_, minZ_;
+    __m128 maxX_, maxY_, maxZ_;
+};
+
+/// Store results for 4 boxes.
+inline void StoreIntersections(__m128 outside, __m128 intersects, Intersection* result, unsigned count)
+{
+    const int outsideMask = _mm_movemask_ps(outside);
+    const int intersectsMask = _mm_movemask_ps(intersects);
+    for (unsigned i = 0; i < ea::min(count, 4u); ++i)
+    {
+        const int bit = 1 << i;
+        result[i] = (outsideMask & bit) ? OUTSIDE : (intersectsMask & bit) ? INTERSECTS : INSIDE;
+    }
+}
+#endif
+
+/// Test batch of boxes against frustum. Equivalent to Frustum::IsInside.
+void IntersectBoxes(const Frustum& frustum, const BoundingBoxBatch& boxes, Intersection* result)
+{
+#ifdef URHO3D_SSE
+    const __m128 half = _mm_set1_ps(0.5f);
+    for (unsigned i = 0; i < boxes.size_; i += 4)
+    {
+        const BoxQuad quad{boxes, i};
+        const __m128 centerX = _mm_mul_ps(_mm_add_ps(quad.maxX_, quad.minX_), half);
+        const __m128 centerY = _mm_mul_ps(_mm_add_ps(quad.maxY_, quad.minY_), half);
+        const __m128 centerZ = _mm_mul_ps(_mm_add_ps(quad.maxZ_, quad.minZ_), half);
+        const __m128 edgeX = _mm_sub_ps(centerX, quad.minX_);
+        const __m128 edgeY = _mm_sub_ps(centerY, quad.minY_);
+        const __m128 edgeZ = _mm_sub_ps(centerZ, quad.minZ_);
+
+        __m128 outside = _mm_setzero_ps();
+        __m128 intersects = _mm_setzero_ps();
+        for (const Plane& plane : frustum.planes_)
+        {
+            const __m128 dist = _mm_add_ps(_mm_add_ps(_mm_add_ps(
+                _mm_mul_ps(_mm_set1_ps(plane.normal_.x_), centerX),
+                _mm_mul_ps(_mm_set1_ps(plane.normal_.y_), centerY)),
+                _mm_mul_ps(_mm_set1_ps(plane.normal_.z_), centerZ)),
+                _mm_set1_ps(plane.d_));
+            const __m128 absDist = _mm_add_ps(_mm_add_ps(
+                _mm_mul_ps(_mm_set1_ps(plane.absNormal_.x_), edgeX),
+                _mm_mul_ps(_mm_set1_ps(plane.absNormal_.y_), edgeY)),
+                _mm_mul_ps(_mm_set1_ps(plane.absNormal_.z_), edgeZ));
+
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(dist, _mm_sub_ps(_mm_setzero_ps(), absDist)));
+            intersects = _mm_or_ps(intersects, _mm_cmplt_ps(dist, absDist));
+        }
+
+        StoreIntersections(outside, intersects, result + i, boxes.size_ - i);
+    }
+#else
+    for (unsigned i = 0; i < boxes.size_; ++i)
+        result[i] = frustum.IsInside(boxes.Get(i));
+#endif
+}
+
+/// Test batch of boxes against sphere. Equivalent to Sphere::IsInside.
+void IntersectBoxes(const Sphere& sphere, const BoundingBoxBatch& boxes, Intersection* result)
+{
+#ifdef URHO3D_SSE
+    const __m128 centerX = _mm_set1_ps(sphere.center_.x_);
+    const __m128 centerY = _mm_set1_ps(sphere.center_.y_);
+    const __m128 centerZ = _mm_set1_ps(sphere.center_.z_);
+    const __m128 radiusSquared = _mm_set1_ps(sphere.radius_ * sphere.radius_);
+    const auto square = [](__m128 value) { return _mm_mul_ps(value, value); };
+    for (unsigned i = 0; i < boxes.size_; i += 4)
+    {
+        const BoxQuad quad{boxes, i};
+
+        // Distance to the closest point of the box
+        const __m128 closestX = _mm_sub_ps(centerX, _mm_min_ps(_mm_max_ps(centerX, quad.minX_), quad.maxX_));
+        const __m128 closestY = _mm_sub_ps(centerY, _mm_min_ps(_mm_max_ps(centerY, quad.minY_), quad.maxY_));
+        const __m128 closestZ = _mm_sub_ps(centerZ, _mm_min_ps(_mm_max_ps(centerZ, quad.minZ_), quad.maxZ_));
+        const __m128 closestDistSquared = _mm_add_ps(_mm_add_ps(square(closestX), square(closestY)), square(closestZ));
+
+        // Distance to the farthest corner of the box
+        const __m128 farthestX = _mm_max_ps(square(_mm_sub_ps(quad.minX_, centerX)), square(_mm_sub_ps(quad.maxX_, centerX)));
+        const __m128 farthestY = _mm_max_ps(square(_mm_sub_ps(quad.minY_, centerY)), square(_mm_sub_ps(quad.maxY_, centerY)));
+        const __m128 farthestZ = _mm_max_ps(square(_mm_sub_ps(quad.minZ_, centerZ)), square(_mm_sub_ps(quad.maxZ_, centerZ)));
+        const __m128 farthestDistSquared = _mm_add_ps(_mm_add_ps(farthestX, farthestY), farthestZ);
+
+        const __m128 outside = _mm_cmpge_ps(closestDistSquared, radiusSquared);
+        const __m128 intersects = _mm_cmpge_ps(farthestDistSquared, radiusSquared);
+        StoreIntersections(outside, intersects, result + i, boxes.size_ - i);
+    }
+#else
+    for (unsigned i = 0; i < boxes.size_; ++i)
+        result[i] = sphere.IsInside(boxes.Get(i));
+#endif
+}
+
+/// Test batch of boxes against bounding box. Equivalent to BoundingBox::IsInside.
+void IntersectBoxes(const BoundingBox& box, const BoundingBoxBatch& boxes, Intersection* result)
+{
+#ifdef URHO3D_SSE
+    const __m128 minX = _mm_set1_ps(box.min_.x_);
+    const __m128 minY = _mm_set1_ps(box.min_.y_);
+    const __m128 minZ = _mm_set1_ps(box.min_.z_);
+    const __m128 maxX = _mm_set1_ps(box.max_.x_);
+    const __m128 maxY = _mm_set1_ps(box.max_.y_);
+    const __m128 maxZ = _mm_set1_ps(box.max_.z_);
+    for (unsigned i = 0; i < boxes.size_; i += 4)
+    {
+        const BoxQuad quad{boxes, i};
+        const __m128 outside = _mm_or_ps(_mm_or_ps(
+            _mm_or_ps(_mm_cmplt_ps(quad.maxX_, minX), _mm_cmpgt_ps(quad.minX_, maxX)),
+            _mm_or_ps(_mm_cmplt_ps(quad.maxY_, minY), _mm_cmpgt_ps(quad.minY_, maxY))),
+            _mm_or_ps(_mm_cmplt_ps(quad.maxZ_, minZ), _mm_cmpgt_ps(quad.minZ_, maxZ)));
+        const __m128 intersects = _mm_or_ps(_mm_or_ps(
+            _mm_or_ps(_mm_cmplt_ps(quad.minX_, minX), _mm_cmpgt_ps(quad.maxX_, maxX)),
+            _mm_or_ps(_mm_cmplt_ps(quad.minY_, minY), _mm_cmpgt_ps(quad.maxY_, maxY))),
+            _mm_or_ps(_mm_cmplt_ps(quad.minZ_, minZ), _mm_cmpgt_ps(quad.maxZ_, maxZ)));
+        StoreIntersections(outside, intersects, result + i, boxes.size_ - i);
+    }
+#else
+    for (unsigned i = 0; i < boxes.size_; ++i)
+        result[i] = box.IsInside(boxes.Get(i));
+#endif
+}
+
+/// Test nodes against the query shape, then let the query do its own checks for the nodes that passed.
+template <class Shape>
+void TestOctantBatchWithShape(OctreeQuery& query, const Shape& shape, const BoundingBoxBatch& boxes, bool inside, Intersection* result)
+{
+    if (!inside)
+        IntersectBoxes(shape, boxes, result);
+
+    for (unsigned i = 0; i < boxes.size_; ++i)
+    {
+        if (inside)
+            result[i] = query.TestOctant(boxes.Get(i), true);
+        else if (result[i] != OUTSIDE && query.TestOctant(boxes.Get(i), true) == OUTSIDE)
+            result[i] = OUTSIDE;
+    }
+}
+
+/// Test drawables against the query shape, then forward the drawables that passed to the query.
+template <class Shape>
+void TestDrawableBatchWithShape(OctreeQuery& query, const Shape& shape, Drawable** drawables, const BoundingBoxBatch& boxes, bool inside)
+{
+    if (inside)
+    {
+        query.TestDrawables(drawables, drawables + boxes.size_, true);
+        return;
+    }
+
+    Intersection intersections[MaxDrawableBatchSize];
+    Drawable* passed[MaxDrawableBatchSize];
+    for (unsigned offset = 0; offset < boxes.size_; offset += MaxDrawableBatchSize)
+    {
+        const unsigned count = ea::min(boxes.size_ - offset, MaxDrawableBatchSize);
+        IntersectBoxes(shape, boxes.Subrange(offset, count), intersections);
+
+        unsigned numPassed = 0;
+        for (unsigned i = 0; i < count; ++i)
+        {
+            if (intersections[i] != OUTSIDE)
+                passed[numPassed++] = drawables[offset + i];
+        }
+
+        if (numPassed > 0)
+            query.TestDrawables(passed, passed + numPassed, true);
+    }
+}
+
+}
+
+void OctreeQuery::TestOctantBatch(const BoundingBoxBatch& boxes, bool inside, Intersection* result)
+{
+    for (unsigned i = 0; i < boxes.size_; ++i)
+        result[i] = TestOctant(boxes.Get(i), inside);
+}
+
+void OctreeQuery::TestDrawableBatch(Drawable** drawables, const BoundingBoxBatch& boxes, bool inside)
+{
+    TestDrawables(drawables, drawables + boxes.size_, inside);
+}
+
 Intersection PointOctreeQuery::TestOctant(const BoundingBox& box, bool inside)
 {
     if (inside)
@@ -51,6 +268,16 @@ void PointOctreeQuery::TestDrawables(Drawable** start, Drawable** end, bool insi
     }
 }
 
+void SphereOctreeQuery::TestOctantBatch(const BoundingBoxBatch& boxes, bool inside, Intersection* result)
+{
+    TestOctantBatchWithShape(*this, sphere_, boxes, inside, result);
+}
+
+void SphereOctreeQuery::TestDrawableBatch(Drawable** drawables, const BoundingBoxBatch& boxes, bool inside)
+{
+    TestDrawableBatchWithShape(*this, sphere_, drawables, boxes, inside);
+}
+
 Intersection SphereOctreeQuery::TestOctant(const BoundingBox& box, bool inside)
 {
     if (inside)
@@ -73,6 +300,16 @@ void SphereOctreeQuery::TestDrawables(Drawable** start, Drawable** end, bool ins
     }
 }
 
+void BoxOctreeQuery::TestOctantBatch(const BoundingBoxBatch& boxes, bool inside, Intersection* result)
+{
+    TestOctantBatchWithShape(*this, box_, boxes, inside, result);
+}
+
+void BoxOctreeQuery::TestDrawableBatch(Drawable** drawables, const BoundingBoxBatch& boxes, bool inside)
+{
+    TestDrawableBatchWithShape(*this, box_, drawables, boxes, inside);
+}
+
 Intersection BoxOctreeQuery::TestOctant(const BoundingBox& box, bool inside)
 {
     if (inside)
@@ -95,6 +332,16 @@ void BoxOctreeQuery::TestDrawables(Drawable** start, Drawable** end, bool inside
     }
 }
 
+void FrustumOctreeQuery::TestOctantBatch(const BoundingBoxBatch& boxes, bool inside, Intersection* result)
+{
+    TestOctantBatchWithShape(*this, frustum_, boxes, inside, result);
+}
+
+void FrustumOctreeQuery::TestDrawableBatch(Drawable** drawables, const BoundingBoxBatch& boxes, bool inside)
+{
+    TestDrawableBatchWithShape(*this, frustum_, drawables, boxes, inside);
+}
+
 Intersection FrustumOctreeQuery::TestOctant(const BoundingBox& box, bool inside)
 {
     if (inside)
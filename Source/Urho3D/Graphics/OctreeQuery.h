@@ -37,6 +37,37 @@ namespace Urho3D
 class Drawable;
 class Node;
 
+/// Bounding boxes stored as structure of arrays for batched intersection tests.
+struct URHO3D_API BoundingBoxBatch
+{
+    /// Return bounding box at given index.
+    BoundingBox Get(unsigned index) const
+    {
+        return BoundingBox{Vector3{minX_[index], minY_[index], minZ_[index]}, Vector3{maxX_[index], maxY_[index], maxZ_[index]}};
+    }
+
+    /// Return sub-range of the batch.
+    BoundingBoxBatch Subrange(unsigned offset, unsigned count) const
+    {
+        return {minX_ + offset, minY_ + offset, minZ_ + offset, maxX_ + offset, maxY_ + offset, maxZ_ + offset, count};
+    }
+
+    /// Minimum X coordinates.
+    const float* minX_{};
+    /// Minimum Y coordinates.
+    const float* minY_{};
+    /// Minimum Z coordinates.
+    const float* minZ_{};
+    /// Maximum X coordinates.
+    const float* maxX_{};
+    /// Maximum Y coordinates.
+    const float* maxY_{};
+    /// Maximum Z coordinates.
+    const float* maxZ_{};
+    /// Number of boxes.
+    unsigned size_{};
+};
+
 /// Base class for octree queries.
 class URHO3D_API OctreeQuery : private NonCopyable
 {
@@ -56,6 +87,11 @@ public:
     virtual Intersection TestOctant(const BoundingBox& box, bool inside) = 0;
     /// Intersection test for drawables.
     virtual void TestDrawables(Drawable** start, Drawable** end, bool inside) = 0;
+    /// Intersection test for a batch of spatial index nodes. Default implementation calls TestOctant for each box.
+    virtual void TestOctantBatch(const BoundingBoxBatch& boxes, bool inside, Intersection* result);
+    /// Intersection test for drawables with bounding boxes stored in the spatial index.
+    /// Default implementation calls TestDrawables for all drawables.
+    virtual void TestDrawableBatch(Drawable** drawables, const BoundingBoxBatch& boxes, bool inside);
 
     /// Result vector reference.
     ea::vector<Drawable*>& result_;
@@ -104,6 +140,10 @@ public:
     Intersection TestOctant(const BoundingBox& box, bool inside) override;
     /// Intersection test for drawables.
     void TestDrawables(Drawable** start, Drawable** end, bool inside) override;
+    /// Intersection test for a batch of spatial index nodes. Boxes that pass the test are also checked by TestOctant.
+    void TestOctantBatch(const BoundingBoxBatch& boxes, bool inside, Intersection* result) override;
+    /// Intersection test for drawables. Drawables that pass the test are forwarded to TestDrawables as inside.
+    void TestDrawableBatch(Drawable** drawables, const BoundingBoxBatch& boxes, bool inside) override;
 
     /// Sphere.
     Sphere sphere_;
@@ -126,6 +166,10 @@ public:
     Intersection TestOctant(const BoundingBox& box, bool inside) override;
     /// Intersection test for drawables.
     void TestDrawables(Drawable** start, Drawable** end, bool inside) override;
+    /// Intersection test for a batch of spatial index nodes. Boxes that pass the test are also checked by TestOctant.
+    void TestOctantBatch(const BoundingBoxBatch& boxes, bool inside, Intersection* result) override;
+    /// Intersection test for drawables. Drawables that pass the test are forwarded to TestDrawables as inside.
+    void TestDrawableBatch(Drawable** drawables, const BoundingBoxBatch& boxes, bool inside) override;
 
     /// Bounding box.
     BoundingBox box_;
@@ -148,6 +192,10 @@ public:
     Intersection TestOctant(const BoundingBox& box, bool inside) override;
     /// Intersection test for drawables.
     void TestDrawables(Drawable** start, Drawable** end, bool inside) override;
+    /// Intersection test for a batch of spatial index nodes. Boxes that pass the test are also checked by TestOctant.
+    void TestOctantBatch(const BoundingBoxBatch& boxes, bool inside, Intersection* result) override;
+    /// Intersection test for drawables. Drawables that pass the test are forwarded to TestDrawables as inside.
+    void TestDrawableBatch(Drawable** drawables, const BoundingBoxBatch& boxes, bool inside) override;
 
     /// Frustum.
     Frustum frustum_;
@@ -22,6 +22,7 @@
 
 #include "../Precompiled.h"
 
+#include "../Core/Timer.h"
 #include "../Graphics/Graphics.h"
 #include "../Graphics/GraphicsEvents.h"
 #include "../Graphics/Material.h"
@@ -298,6 +299,21 @@ void Texture::OnDestroyGPU()
         renderSurface->Invalidate();
 }
 
+bool Texture::UnloadResidentData()
+{
+    if (!GetHandles() || IsRenderTarget() || IsDepthStencil() || IsUnorderedAccess())
+        return false;
+
+    // Only textures loaded from file can be restored
+    auto* cache = GetSubsystem<ResourceCache>();
+    if (GetName().empty() || !cache->Exists(GetName()))
+        return false;
+
+    Unload();
+    SetMemoryUse(0);
+    return true;
+}
+
 bool Texture::TryRestore()
 {
     auto* cache = GetSubsystem<ResourceCache>();
@@ -306,6 +322,12 @@ bool Texture::TryRestore()
     return false;
 }
 
+void Texture::OnRestoreRequested()
+{
+    // Reloading in the middle of rendering is expensive, ResourceCache reloads used textures on the next frame
+    MarkUsed(GetSubsystem<Time>()->GetFrameNumber());
+}
+
 void Texture::CheckTextureBudget(StringHash type)
 {
     auto* cache = GetSubsystem<ResourceCache>();
@@ -186,6 +186,11 @@ public:
     /// @property
     unsigned GetComponents() const;
 
+    /// Implement Resource. Destroy GPU texture if it can be reloaded from file. Texture is reloaded by ResourceCache on the next frame after it is bound.
+    bool UnloadResidentData() override;
+    /// Implement Resource.
+    bool IsResidentDataUnloaded() const override { return IsUnloaded(); }
+
     /// Set additional parameters from an XML file.
     void SetParameters(XMLFile* file);
     /// Set additional parameters from an XML element.
@@ -204,6 +209,7 @@ private:
     void OnCreateGPU() override;
     void OnDestroyGPU() override;
     bool TryRestore() override;
+    void OnRestoreRequested() override;
     /// @}
 
     /// Handle render surface update event.
@@ -27,10 +27,13 @@
 #include "../IO/Compression.h"
 #include "../IO/Deserializer.h"
 #include "../IO/Serializer.h"
+#include "../IO/Log.h"
 #include "../IO/VectorBuffer.h"
 
 #include <LZ4/lz4.h>
 #include <LZ4/lz4hc.h>
+#include <zdict.h>
+#include <zstd.h>
 
 namespace Urho3D
 {
@@ -123,4 +126,98 @@ VectorBuffer DecompressVectorBuffer(VectorBuffer& src)
     return ret;
 }
 
+ZstdDictionary::ZstdDictionary(ByteVector data)
+    : data_(ea::move(data))
+{
+    if (!data_.empty())
+        decompressionDictionary_ = ZSTD_createDDict(data_.data(), data_.size());
+}
+
+ZstdDictionary::~ZstdDictionary()
+{
+    ZSTD_freeDDict(static_cast<ZSTD_DDict*>(decompressionDictionary_));
+}
+
+ZstdCompressor::ZstdCompressor(int compressionLevel, const ByteVector& dictionary)
+    : context_(ZSTD_createCCtx())
+{
+    if (!dictionary.empty())
+    {
+        auto compressionDictionary = ZSTD_createCDict(dictionary.data(), dictionary.size(), compressionLevel);
+        ZSTD_CCtx_refCDict(static_cast<ZSTD_CCtx*>(context_), compressionDictionary);
+        compressionDictionary_ = compressionDictionary;
+    }
+    else
+        ZSTD_CCtx_setParameter(static_cast<ZSTD_CCtx*>(context_), ZSTD_c_compressionLevel, compressionLevel);
+
+    // Blocks are always decompressed into buffers of known size
+    ZSTD_CCtx_setParameter(static_cast<ZSTD_CCtx*>(context_), ZSTD_c_checksumFlag, 0);
+    ZSTD_CCtx_setParameter(static_cast<ZSTD_CCtx*>(context_), ZSTD_c_dictIDFlag, 0);
+}
+
+ZstdCompressor::~ZstdCompressor()
+{
+    ZSTD_freeCCtx(static_cast<ZSTD_CCtx*>(context_));
+    ZSTD_freeCDict(static_cast<ZSTD_CDict*>(compressionDictionary_));
+}
+
+unsigned ZstdCompressor::Compress(void* dest, unsigned destCapacity, const void* src, unsigned srcSize)
+{
+    const size_t result = ZSTD_compress2(static_cast<ZSTD_CCtx*>(context_), dest, destCapacity, src, srcSize);
+    if (ZSTD_isError(result))
+    {
+        URHO3D_LOGERROR("Zstd compression failed: {}", ZSTD_getErrorName(result));
+        return 0;
+    }
+    return static_cast<unsigned>(result);
+}
+
+unsigned ZstdCompressor::EstimateCompressBound(unsigned srcSize)
+{
+    return static_cast<unsigned>(ZSTD_compressBound(srcSize));
+}
+
+ZstdDecompressor::ZstdDecompressor(const ZstdDictionary* dictionary)
+    : context_(ZSTD_createDCtx())
+{
+    if (dictionary && dictionary->GetDecompressionDictionary())
+    {
+        const auto decompressionDictionary = static_cast<const ZSTD_DDict*>(dictionary->GetDecompressionDictionary());
+        ZSTD_DCtx_refDDict(static_cast<ZSTD_DCtx*>(context_), decompressionDictionary);
+    }
+}
+
+ZstdDecompressor::~ZstdDecompressor()
+{
+    ZSTD_freeDCtx(static_cast<ZSTD_DCtx*>(context_));
+}
+
+bool ZstdDecompressor::Decompress(void* dest, unsigned destSize, const void* src, unsigned srcSize)
+{
+    const size_t result = ZSTD_decompressDCtx(static_cast<ZSTD_DCtx*>(context_), dest, destSize, src, srcSize);
+    if (ZSTD_isError(result) || result != destSize)
+    {
+        URHO3D_LOGERROR("Zstd decompression failed: {}", ZSTD_isError(result) ? ZSTD_getErrorName(result) : "size mismatch");
+        return false;
+    }
+    return true;
+}
+
+ByteVector TrainZstdDictionary(const ByteVector& samples, const ea::vector<unsigned>& sampleSizes, unsigned maxSize)
+{
+    ea::vector<size_t> samplesSizesInternal(sampleSizes.begin(), sampleSizes.end());
+
+    ByteVector dictionary(maxSize);
+    const size_t result = ZDICT_trainFromBuffer(dictionary.data(), dictionary.size(), samples.data(),
+        samplesSizesInternal.data(), samplesSizesInternal.size());
+    if (ZDICT_isError(result))
+    {
+        URHO3D_LOGWARNING("Cannot train Zstd dictionary: {}", ZDICT_getErrorName(result));
+        return {};
+    }
+
+    dictionary.resize(result);
+    return dictionary;
+}
+
 }
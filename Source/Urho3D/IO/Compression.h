@@ -22,7 +22,9 @@
 
 #pragma once
 
-#include <Urho3D/Urho3D.h>
+#include <Urho3D/Container/ByteVector.h>
+#include <Urho3D/Container/RefCounted.h>
+#include <Urho3D/Core/NonCopyable.h>
 
 namespace Urho3D
 {
@@ -46,4 +48,66 @@ URHO3D_API VectorBuffer CompressVectorBuffer(VectorBuffer& src);
 /// Decompress a VectorBuffer produced using CompressVectorBuffer().
 URHO3D_API VectorBuffer DecompressVectorBuffer(VectorBuffer& src);
 
+/// Zstandard dictionary. Immutable after creation and may be shared between threads.
+class URHO3D_API ZstdDictionary : public RefCounted
+{
+public:
+    /// Construct from raw dictionary data.
+    explicit ZstdDictionary(ByteVector data);
+    /// Destruct.
+    ~ZstdDictionary() override;
+
+    /// Return raw dictionary data.
+    const ByteVector& GetData() const { return data_; }
+    /// Return internal decompression dictionary.
+    void* GetDecompressionDictionary() const { return decompressionDictionary_; }
+
+private:
+    /// Raw dictionary data.
+    ByteVector data_;
+    /// Digested dictionary for decompression.
+    void* decompressionDictionary_{};
+};
+
+/// Zstandard compression context. Should be used by one thread at a time.
+class URHO3D_API ZstdCompressor : public NonCopyable
+{
+public:
+    /// Construct with compression level and optional raw dictionary.
+    explicit ZstdCompressor(int compressionLevel, const ByteVector& dictionary = {});
+    /// Destruct.
+    ~ZstdCompressor();
+
+    /// Compress block of data. Return compressed size or 0 on error.
+    unsigned Compress(void* dest, unsigned destCapacity, const void* src, unsigned srcSize);
+    /// Return worst case compressed output size in bytes for given input size.
+    static unsigned EstimateCompressBound(unsigned srcSize);
+
+private:
+    /// Compression context.
+    void* context_{};
+    /// Digested dictionary for compression.
+    void* compressionDictionary_{};
+};
+
+/// Zstandard decompression context. Should be used by one thread at a time.
+class URHO3D_API ZstdDecompressor : public NonCopyable
+{
+public:
+    /// Construct with optional dictionary.
+    explicit ZstdDecompressor(const ZstdDictionary* dictionary = nullptr);
+    /// Destruct.
+    ~ZstdDecompressor();
+
+    /// Decompress block of data of known uncompressed size. Return true on success.
+    bool Decompress(void* dest, unsigned destSize, const void* src, unsigned srcSize);
+
+private:
+    /// Decompression context.
+    void* context_{};
+};
+
+/// Train Zstandard dictionary from samples stored sequentially in one buffer. Return empty vector on failure.
+URHO3D_API ByteVector TrainZstdDictionary(const ByteVector& samples, const ea::vector<unsigned>& sampleSizes, unsigned maxSize);
+
 }
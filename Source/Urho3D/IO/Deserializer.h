@@ -57,6 +57,9 @@ public:
     /// Return whether the end of stream has been reached.
     /// @property
     virtual bool IsEof() const { return position_ >= size_; }
+    /// Return pointer to the whole stream data if it's stored in contiguous memory, null otherwise.
+    /// Allows to parse the stream without copying the data.
+    virtual const unsigned char* GetContiguousData() const { return nullptr; }
 
     /// Set position relative to current position. Return actual new position.
     unsigned SeekRelative(int delta);
@@ -23,6 +23,7 @@
 #include "../Precompiled.h"
 
 #include "../Core/Profiler.h"
+#include "../Core/WorkQueue.h"
 #include "../IO/File.h"
 #include "../IO/FileSystem.h"
 #include "../IO/Log.h"
@@ -37,6 +38,7 @@
 #include <emscripten/emscripten.h>
 #endif
 
+#include <atomic>
 #include <cstdio>
 #include <LZ4/lz4.h>
 
@@ -67,6 +69,7 @@ static const char* openMode[] =
 static const unsigned READ_BUFFER_SIZE = 32768;
 #endif
 static const unsigned SKIP_BUFFER_SIZE = 1024;
+static const unsigned BLOCKS_PER_DECOMPRESSION_TASK = 4;
 
 File::File(Context* context) :
     Object(context),
@@ -153,6 +156,13 @@ bool File::Open(PackageFile* package, const ea::string& fileName)
     size_ = entry->size_;
     compressed_ = package->IsCompressed();
 
+    if (package->GetCompression() == PackageCompression::Zstd)
+    {
+        blockSize_ = package->GetBlockSize();
+        blockOffsets_ = entry->blockOffsets_;
+        package_ = package;
+    }
+
     // Seek to beginning of package entry's file data
     SeekInternal(offset_);
     return true;
@@ -212,6 +222,9 @@ unsigned File::Read(void* dest, unsigned size)
     }
 #endif
 
+    if (blockSize_)
+        return ReadBlocks(dest, size);
+
     if (compressed_)
     {
         unsigned sizeLeft = size;
@@ -285,6 +298,13 @@ unsigned File::Seek(unsigned position)
     if (mode_ == FILE_READ && position > size_)
         position = size_;
 
+    // Any block can be decompressed independently
+    if (blockSize_)
+    {
+        position_ = Min(position, size_);
+        return position_;
+    }
+
     if (compressed_)
     {
         // Start over from the beginning
@@ -401,6 +421,12 @@ void File::Close()
 
     readBuffer_.reset();
     inputBuffer_.reset();
+    compressedBuffer_.clear();
+    blockSize_ = 0;
+    blockOffsets_.clear();
+    readBufferBlock_ = M_MAX_UNSIGNED;
+    package_ = nullptr;
+    decompressor_ = nullptr;
 
     if (handle_)
     {
@@ -555,6 +581,119 @@ void File::SeekInternal(unsigned newPosition)
         fseek((FILE*)handle_, newPosition, SEEK_SET);
 }
 
+unsigned File::ReadBlocks(void* dest, unsigned size)
+{
+    const unsigned numBlocks = blockOffsets_.size() - 1;
+    unsigned sizeLeft = size;
+    auto* destPtr = static_cast<unsigned char*>(dest);
+
+    while (sizeLeft)
+    {
+        const unsigned blockIndex = position_ / blockSize_;
+        const unsigned offsetInBlock = position_ % blockSize_;
+
+        // Blocks that are read completely are decompressed directly to the destination
+        const unsigned endPosition = position_ + sizeLeft;
+        const unsigned endBlock = endPosition == size_ ? numBlocks : endPosition / blockSize_;
+        const unsigned numWholeBlocks = offsetInBlock == 0 ? endBlock - blockIndex : 0;
+        if (numWholeBlocks > 0)
+        {
+            if (!DecompressBlocks(destPtr, blockIndex, numWholeBlocks))
+                break;
+
+            const unsigned copySize = Min(numWholeBlocks * blockSize_, size_ - position_);
+            destPtr += copySize;
+            sizeLeft -= copySize;
+            position_ += copySize;
+            continue;
+        }
+
+        if (readBufferBlock_ != blockIndex)
+        {
+            if (!readBuffer_)
+                readBuffer_ = new unsigned char[blockSize_];
+
+            readBufferBlock_ = M_MAX_UNSIGNED;
+            if (!DecompressBlocks(readBuffer_.get(), blockIndex, 1))
+                break;
+            readBufferBlock_ = blockIndex;
+        }
+
+        const unsigned copySize = Min(GetBlockUnpackedSize(blockIndex) - offsetInBlock, sizeLeft);
+        memcpy(destPtr, readBuffer_.get() + offsetInBlock, copySize);
+        destPtr += copySize;
+        sizeLeft -= copySize;
+        position_ += copySize;
+    }
+
+    return size - sizeLeft;
+}
+
+bool File::DecompressBlocks(unsigned char* dest, unsigned firstBlock, unsigned numBlocks)
+{
+    const unsigned packedBegin = blockOffsets_[firstBlock];
+    const unsigned packedSize = blockOffsets_[firstBlock + numBlocks] - packedBegin;
+
+    compressedBuffer_.resize(packedSize);
+    SeekInternal(packedBegin);
+    if (!ReadInternal(compressedBuffer_.data(), packedSize))
+    {
+        URHO3D_LOGERROR("Error while reading from file " + GetName());
+        return false;
+    }
+
+    const auto decompressBlock = [&](ZstdDecompressor& decompressor, unsigned index)
+    {
+        const unsigned blockIndex = firstBlock + index;
+        const unsigned unpackedSize = GetBlockUnpackedSize(blockIndex);
+        const unsigned blockPackedSize = blockOffsets_[blockIndex + 1] - blockOffsets_[blockIndex];
+        const unsigned char* blockData = compressedBuffer_.data() + blockOffsets_[blockIndex] - packedBegin;
+        unsigned char* blockDest = dest + index * blockSize_;
+
+        // Incompressible blocks are stored as is
+        if (blockPackedSize == unpackedSize)
+        {
+            memcpy(blockDest, blockData, unpackedSize);
+            return true;
+        }
+        return decompressor.Decompress(blockDest, unpackedSize, blockData, blockPackedSize);
+    };
+
+    auto workQueue = GetSubsystem<WorkQueue>();
+    if (numBlocks > BLOCKS_PER_DECOMPRESSION_TASK && workQueue && WorkQueue::IsProcessingThread())
+    {
+        std::atomic<bool> success{true};
+        workQueue->ParallelFor(numBlocks, BLOCKS_PER_DECOMPRESSION_TASK,
+            [&](unsigned beginIndex, unsigned endIndex, unsigned threadIndex)
+        {
+            ZstdDecompressor& decompressor = *package_->GetDecompressor(threadIndex);
+            for (unsigned index = beginIndex; index < endIndex; ++index)
+            {
+                if (!decompressBlock(decompressor, index))
+                    success = false;
+            }
+        });
+        return success;
+    }
+
+    ZstdDecompressor* decompressor = nullptr;
+    if (WorkQueue::IsProcessingThread())
+        decompressor = package_->GetDecompressor(WorkQueue::GetThreadIndex());
+    else
+    {
+        if (!decompressor_)
+            decompressor_ = ea::make_unique<ZstdDecompressor>(package_->GetDictionary());
+        decompressor = decompressor_.get();
+    }
+
+    for (unsigned index = 0; index < numBlocks; ++index)
+    {
+        if (!decompressBlock(*decompressor, index))
+            return false;
+    }
+    return true;
+}
+
 void File::ReadBinary(ea::vector<unsigned char>& buffer)
 {
     buffer.clear();
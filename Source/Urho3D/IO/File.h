@@ -28,6 +28,7 @@
 
 #include "../Core/Object.h"
 #include "../IO/AbstractFile.h"
+#include "../IO/Compression.h"
 
 #ifdef __ANDROID__
 struct SDL_RWops;
@@ -127,6 +128,12 @@ private:
     bool ReadInternal(void* dest, unsigned size);
     /// Seek in file internally using either C standard IO functions or SDL RWops for Android asset files.
     void SeekInternal(unsigned newPosition);
+    /// Read from Zstd compressed package file. Return number of bytes actually read.
+    unsigned ReadBlocks(void* dest, unsigned size);
+    /// Decompress sequential Zstd blocks. Blocks are decompressed in parallel if possible. Return true if successful.
+    bool DecompressBlocks(unsigned char* dest, unsigned firstBlock, unsigned numBlocks);
+    /// Return uncompressed size of Zstd block.
+    unsigned GetBlockUnpackedSize(unsigned blockIndex) const { return Min(blockSize_, size_ - blockIndex * blockSize_); }
 
     /// Absolute file name.
     ea::string absoluteFileName_;
@@ -152,6 +159,18 @@ private:
     unsigned checksum_;
     /// Compression flag.
     bool compressed_;
+    /// Uncompressed size of Zstd blocks, 0 if the file is not block compressed.
+    unsigned blockSize_{};
+    /// Offsets of Zstd blocks within a package file.
+    ea::vector<unsigned> blockOffsets_;
+    /// Index of Zstd block stored in the read buffer.
+    unsigned readBufferBlock_{M_MAX_UNSIGNED};
+    /// Buffer for compressed Zstd blocks.
+    ByteVector compressedBuffer_;
+    /// Package of Zstd compressed file, owns decompression contexts of WorkQueue threads.
+    SharedPtr<PackageFile> package_;
+    /// Zstd decompression context for threads outside of WorkQueue, created on demand.
+    ea::unique_ptr<ZstdDecompressor> decompressor_;
     /// Synchronization needed before read -flag.
     bool readSyncNeeded_;
     /// Synchronization needed before write -flag.
@@ -54,6 +54,8 @@ public:
     unsigned Seek(unsigned position) override;
     /// Write bytes to the memory area.
     unsigned Write(const void* data, unsigned size) override;
+    /// Return memory area.
+    const unsigned char* GetContiguousData() const override { return buffer_; }
 
     /// Return memory area.
     unsigned char* GetData() const { return buffer_; }
@@ -0,0 +1,208 @@
+//
+// Copyright (c) 2017-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "Urho3D/Precompiled.h"
+
+#include "Urho3D/IO/MemoryMappedFile.h"
+
+#include "Urho3D/IO/FileSystem.h"
+#include "Urho3D/IO/Log.h"
+
+#ifdef __ANDROID__
+#include "Urho3D/IO/File.h"
+#endif
+
+#ifdef _WIN32
+#include <windows.h>
+#elif !defined(__EMSCRIPTEN__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "Urho3D/DebugNew.h"
+
+namespace Urho3D
+{
+
+namespace
+{
+
+#if defined(_WIN32)
+size_t GetMappingAlignment()
+{
+    SYSTEM_INFO systemInfo;
+    GetSystemInfo(&systemInfo);
+    return systemInfo.dwAllocationGranularity;
+}
+#elif !defined(__EMSCRIPTEN__)
+size_t GetMappingAlignment()
+{
+    return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+#endif
+
+}
+
+bool MemoryMapping::IsSupported()
+{
+#if defined(__EMSCRIPTEN__)
+    return false;
+#else
+    return true;
+#endif
+}
+
+ea::shared_ptr<MemoryMapping> MemoryMapping::Create(const ea::string& fileName, unsigned offset, unsigned size)
+{
+#if defined(__EMSCRIPTEN__)
+    return nullptr;
+#else
+#ifdef __ANDROID__
+    // Assets are stored inside APK and cannot be mapped by name
+    if (URHO3D_IS_ASSET(fileName))
+        return nullptr;
+#endif
+
+    // View offset should be aligned, so the view may contain some extra data in the beginning
+    const size_t alignment = GetMappingAlignment();
+    const size_t viewOffset = offset / alignment * alignment;
+    const size_t viewPadding = offset - viewOffset;
+
+#ifdef _WIN32
+    HANDLE fileHandle = CreateFileW(GetWideNativePath(fileName).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE)
+        return nullptr;
+
+    LARGE_INTEGER fileSize{};
+    GetFileSizeEx(fileHandle, &fileSize);
+    const auto totalSize = static_cast<unsigned long long>(fileSize.QuadPart);
+#else
+    const int fileDescriptor = open(GetNativePath(fileName).c_str(), O_RDONLY);
+    if (fileDescriptor < 0)
+        return nullptr;
+
+    struct stat fileStat{};
+    fstat(fileDescriptor, &fileStat);
+    const auto totalSize = static_cast<unsigned long long>(fileStat.st_size);
+#endif
+
+    if (offset > totalSize)
+        size = 0;
+    else if (size == M_MAX_UNSIGNED || offset + static_cast<unsigned long long>(size) > totalSize)
+        size = static_cast<unsigned>(totalSize - offset);
+
+    auto mapping = ea::shared_ptr<MemoryMapping>(new MemoryMapping());
+    mapping->size_ = size;
+
+    // Empty files cannot be mapped but are still valid
+    static const unsigned char emptyData[1]{};
+    if (size == 0)
+    {
+        mapping->data_ = emptyData;
+#ifdef _WIN32
+        CloseHandle(fileHandle);
+#else
+        close(fileDescriptor);
+#endif
+        return mapping;
+    }
+
+    const size_t viewSize = viewPadding + size;
+#ifdef _WIN32
+    HANDLE mappingHandle = CreateFileMappingW(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    void* viewAddress = mappingHandle
+        ? MapViewOfFile(mappingHandle, FILE_MAP_READ, static_cast<DWORD>(viewOffset >> 32),
+            static_cast<DWORD>(viewOffset & 0xffffffff), viewSize)
+        : nullptr;
+    // View keeps the file mapped even after handles are closed
+    if (mappingHandle)
+        CloseHandle(mappingHandle);
+    CloseHandle(fileHandle);
+#else
+    void* viewAddress = mmap(nullptr, viewSize, PROT_READ, MAP_SHARED, fileDescriptor, static_cast<off_t>(viewOffset));
+    if (viewAddress == MAP_FAILED)
+        viewAddress = nullptr;
+    // Mapping keeps the file referenced even after descriptor is closed
+    close(fileDescriptor);
+#endif
+
+    if (!viewAddress)
+    {
+        URHO3D_LOGWARNING("Cannot map file {}", fileName);
+        return nullptr;
+    }
+
+    mapping->viewAddress_ = viewAddress;
+    mapping->viewSize_ = viewSize;
+    mapping->data_ = static_cast<const unsigned char*>(viewAddress) + viewPadding;
+    return mapping;
+#endif
+}
+
+MemoryMapping::~MemoryMapping()
+{
+    if (!viewAddress_)
+        return;
+
+#if defined(_WIN32)
+    UnmapViewOfFile(viewAddress_);
+#elif !defined(__EMSCRIPTEN__)
+    munmap(viewAddress_, viewSize_);
+#endif
+}
+
+void MemoryMapping::Prefetch(unsigned offset, unsigned size) const
+{
+    if (!viewAddress_ || offset >= size_)
+        return;
+
+    size = ea::min(size, size_ - offset);
+
+#if defined(_WIN32)
+    WIN32_MEMORY_RANGE_ENTRY range{const_cast<unsigned char*>(data_ + offset), size};
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#elif !defined(__EMSCRIPTEN__)
+    // Address passed to madvise should be aligned
+    const auto alignment = static_cast<uintptr_t>(GetMappingAlignment());
+    const auto beginAddress = reinterpret_cast<uintptr_t>(data_ + offset);
+    const auto alignedBeginAddress = beginAddress / alignment * alignment;
+    madvise(reinterpret_cast<void*>(alignedBeginAddress), beginAddress - alignedBeginAddress + size, MADV_WILLNEED);
+#endif
+}
+
+MemoryMappedFile::MemoryMappedFile(ea::shared_ptr<MemoryMapping> mapping, unsigned offset, unsigned size)
+    : MemoryBuffer(mapping->GetData() + offset, size)
+    , mapping_(ea::move(mapping))
+    , offset_(offset)
+{
+}
+
+void MemoryMappedFile::Prefetch() const
+{
+    mapping_->Prefetch(offset_, GetSize());
+}
+
+}
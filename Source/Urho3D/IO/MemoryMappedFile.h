@@ -0,0 +1,90 @@
+//
+// Copyright (c) 2017-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+/// \file
+
+#pragma once
+
+#include "Urho3D/Core/NonCopyable.h"
+#include "Urho3D/IO/MemoryBuffer.h"
+
+#include <EASTL/shared_ptr.h>
+
+namespace Urho3D
+{
+
+/// Read-only memory mapping of the file region.
+/// Mapping may be referenced from different threads, hence it's owned via atomic reference counting.
+class URHO3D_API MemoryMapping : public NonCopyable
+{
+public:
+    /// Map region of the file. Map the rest of the file if size is M_MAX_UNSIGNED. Return null if mapping failed.
+    static ea::shared_ptr<MemoryMapping> Create(const ea::string& fileName, unsigned offset = 0, unsigned size = M_MAX_UNSIGNED);
+    /// Destruct. Unmap the memory.
+    ~MemoryMapping();
+
+    /// Return whether memory mapping is supported on current platform.
+    static bool IsSupported();
+
+    /// Return mapped data.
+    const unsigned char* GetData() const { return data_; }
+    /// Return size of mapped data.
+    unsigned GetSize() const { return size_; }
+    /// Hint the OS to load part of the mapping into memory in advance.
+    void Prefetch(unsigned offset, unsigned size) const;
+
+private:
+    /// Construct.
+    MemoryMapping() = default;
+
+    /// Address of the mapped view, aligned to page boundary.
+    void* viewAddress_{};
+    /// Size of the mapped view.
+    size_t viewSize_{};
+    /// Requested data within the view.
+    const unsigned char* data_{};
+    /// Size of requested data.
+    unsigned size_{};
+};
+
+/// Read-only file backed by memory mapping. Data is read directly from the mapping without intermediate buffers.
+/// May share the mapping with other files, e.g. when opened from the package file.
+class URHO3D_API MemoryMappedFile : public RefCounted, public MemoryBuffer
+{
+public:
+    /// Construct from region of the mapping.
+    MemoryMappedFile(ea::shared_ptr<MemoryMapping> mapping, unsigned offset, unsigned size);
+
+    /// Hint the OS to load the whole file into memory in advance.
+    void Prefetch() const;
+    /// Return the mapping.
+    const ea::shared_ptr<MemoryMapping>& GetMapping() const { return mapping_; }
+
+private:
+    /// Underlying mapping.
+    ea::shared_ptr<MemoryMapping> mapping_;
+    /// Offset within the mapping.
+    unsigned offset_{};
+};
+
+}
@@ -34,6 +34,21 @@ MountPoint::MountPoint(Context* context)
 
 MountPoint::~MountPoint() = default;
 
+StringHash MountPoint::GetFileNameHash(const ea::string& fileName)
+{
+#ifdef _WIN32
+    // File names are case-insensitive on Windows
+    return StringHash(fileName.to_lower());
+#else
+    return StringHash(fileName);
+#endif
+}
+
+AbstractFilePtr MountPoint::OpenMappedFile(const FileIdentifier& fileName)
+{
+    return nullptr;
+}
+
 ea::optional<FileTime> MountPoint::GetLastModifiedTime(
     const FileIdentifier& fileName, bool creationIsModification) const
 {
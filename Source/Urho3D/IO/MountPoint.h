@@ -54,6 +54,17 @@ public:
     /// The file name may be be case-insensitive on Windows and case-sensitive on other platforms.
     virtual AbstractFilePtr OpenFile(const FileIdentifier& fileName, FileMode mode) = 0;
 
+    /// Open read-only memory-mapped view of the file. Returns null if file not found or cannot be mapped.
+    virtual AbstractFilePtr OpenMappedFile(const FileIdentifier& fileName);
+
+    /// Return whether the set of files never changes while mounted and files are accessible without scheme.
+    /// Immutable mount points are indexed by VirtualFileSystem.
+    virtual bool IsImmutable() const { return false; }
+    /// Append hashes of all file names, see GetFileNameHash. Used only for immutable mount points.
+    virtual void GetFileNameHashes(ea::vector<StringHash>& hashes) const {}
+    /// Return hash of the file name used for indexing. Hash is case-insensitive on Windows.
+    static StringHash GetFileNameHash(const ea::string& fileName);
+
     /// Return modification time, or 0 if not supported.
     /// Return nullopt if file does not exist.
     virtual ea::optional<FileTime> GetLastModifiedTime(
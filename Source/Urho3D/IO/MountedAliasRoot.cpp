@@ -90,6 +90,19 @@ AbstractFilePtr MountedAliasRoot::OpenFile(const FileIdentifier& fileName, FileM
     return mountPoint->OpenFile(resolvedFileName, mode);
 }
 
+AbstractFilePtr MountedAliasRoot::OpenMappedFile(const FileIdentifier& fileName)
+{
+    if (!AcceptsScheme(fileName.scheme_))
+        return nullptr;
+
+    const auto [mountPoint, alias, scheme] = FindMountPoint(fileName.fileName_);
+    if (!mountPoint)
+        return nullptr;
+
+    const FileIdentifier resolvedFileName = StripFileIdentifier(fileName, alias, scheme);
+    return mountPoint->OpenMappedFile(resolvedFileName);
+}
+
 ea::optional<FileTime> MountedAliasRoot::GetLastModifiedTime(
     const FileIdentifier& fileName, bool creationIsModification) const
 {
@@ -36,6 +36,8 @@ public:
 
     AbstractFilePtr OpenFile(const FileIdentifier& fileName, FileMode mode) override;
 
+    AbstractFilePtr OpenMappedFile(const FileIdentifier& fileName) override;
+
     ea::optional<FileTime> GetLastModifiedTime(
         const FileIdentifier& fileName, bool creationIsModification) const override;
 
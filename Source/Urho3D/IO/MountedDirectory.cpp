@@ -27,6 +27,7 @@
 #include "Urho3D/IO/File.h"
 #include "Urho3D/IO/FileSystem.h"
 #include "Urho3D/IO/Log.h"
+#include "Urho3D/IO/MemoryMappedFile.h"
 #include "Urho3D/Resource/ResourceEvents.h"
 
 namespace Urho3D
@@ -142,6 +143,27 @@ AbstractFilePtr MountedDirectory::OpenFile(const FileIdentifier& fileName, FileM
     return file;
 }
 
+AbstractFilePtr MountedDirectory::OpenMappedFile(const FileIdentifier& fileName)
+{
+    // File system directory only reacts on specific scheme.
+    if (!AcceptsScheme(fileName.scheme_))
+        return nullptr;
+
+    const auto fileSystem = context_->GetSubsystem<FileSystem>();
+    const ea::string fullPath = directory_ + fileName.fileName_;
+    if (!fileSystem->CheckAccess(GetPath(fullPath)) || !fileSystem->FileExists(fullPath))
+        return nullptr;
+
+    auto mapping = MemoryMapping::Create(fullPath);
+    if (!mapping)
+        return nullptr;
+
+    const unsigned size = mapping->GetSize();
+    auto file = MakeShared<MemoryMappedFile>(ea::move(mapping), 0, size);
+    file->SetName(fileName.ToUri());
+    return file;
+}
+
 ea::optional<FileTime> MountedDirectory::GetLastModifiedTime(
     const FileIdentifier& fileName, bool creationIsModification) const
 {
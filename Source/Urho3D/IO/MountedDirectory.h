@@ -45,6 +45,7 @@ public:
     bool AcceptsScheme(const ea::string& scheme) const override;
     bool Exists(const FileIdentifier& fileName) const override;
     AbstractFilePtr OpenFile(const FileIdentifier& fileName, FileMode mode) override;
+    AbstractFilePtr OpenMappedFile(const FileIdentifier& fileName) override;
     ea::optional<FileTime> GetLastModifiedTime(
         const FileIdentifier& fileName, bool creationIsModification) const override;
 
@@ -0,0 +1,229 @@
+//
+// Copyright (c) 2017-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "Urho3D/Precompiled.h"
+
+#include "Urho3D/IO/PackageBuilder.h"
+
+#include "Urho3D/IO/File.h"
+#include "Urho3D/IO/Log.h"
+
+#include <EASTL/sort.h>
+
+#include "Urho3D/DebugNew.h"
+
+namespace Urho3D
+{
+
+namespace
+{
+
+/// Version 1 has no entry index, version 2 stores index sorted by name hash after the file list.
+const unsigned packageVersion = 1;
+const unsigned packageVersionWithIndex = 2;
+
+}
+
+PackageBuilder::PackageBuilder(Context* context)
+    : Object(context)
+{
+}
+
+PackageBuilder::~PackageBuilder() = default;
+
+bool PackageBuilder::Create(const ea::string& fileName, unsigned blockSize, int compressionLevel, const ByteVector& dictionary)
+{
+    entries_.clear();
+    checksum_ = 0;
+    totalDataSize_ = 0;
+    totalPackedSize_ = 0;
+
+    if (compression_ != PackageCompression::None && compression_ != PackageCompression::Zstd)
+    {
+        URHO3D_LOGERROR("Cannot create package {} with unsupported compression", fileName);
+        return false;
+    }
+
+    if (blockSize == 0)
+    {
+        URHO3D_LOGERROR("Cannot create package {} with zero block size", fileName);
+        return false;
+    }
+
+    file_ = MakeShared<File>(context_);
+    if (!file_->Open(fileName, FILE_WRITE))
+    {
+        URHO3D_LOGERROR("Cannot open package {} for writing", fileName);
+        file_ = nullptr;
+        return false;
+    }
+
+    blockSize_ = blockSize;
+    dictionary_ = dictionary;
+    if (compression_ == PackageCompression::Zstd)
+    {
+        compressor_ = ea::make_unique<ZstdCompressor>(compressionLevel, dictionary_);
+        compressBuffer_.resize(ZstdCompressor::EstimateCompressBound(blockSize_));
+    }
+
+    // Write header with placeholders for the number of files, checksum and file list offset
+    WriteHeader(0);
+    return true;
+}
+
+bool PackageBuilder::Append(const ea::string& name, ea::span<const unsigned char> data)
+{
+    if (!file_)
+    {
+        URHO3D_LOGERROR("Package is not created");
+        return false;
+    }
+
+    Entry entry;
+    entry.name_ = name;
+    entry.offset_ = file_->GetSize();
+    entry.size_ = data.size();
+
+    for (unsigned char value : data)
+    {
+        checksum_ = SDBMHash(checksum_, value);
+        entry.checksum_ = SDBMHash(entry.checksum_, value);
+    }
+
+    if (compression_ == PackageCompression::None)
+    {
+        if (entry.size_ && file_->Write(data.data(), entry.size_) != entry.size_)
+        {
+            URHO3D_LOGERROR("Cannot write file {} to package", name);
+            return false;
+        }
+
+        totalDataSize_ += entry.size_;
+        totalPackedSize_ += entry.size_;
+        entries_.push_back(ea::move(entry));
+        return true;
+    }
+
+    for (unsigned pos = 0; pos < entry.size_; pos += blockSize_)
+    {
+        const unsigned unpackedSize = Min(blockSize_, entry.size_ - pos);
+        const unsigned char* blockData = &data[pos];
+
+        unsigned packedSize = compressor_->Compress(compressBuffer_.data(), compressBuffer_.size(), blockData, unpackedSize);
+        if (!packedSize)
+        {
+            URHO3D_LOGERROR("Zstd compression failed for file {} at offset {}", name, pos);
+            return false;
+        }
+
+        // Store incompressible blocks as is, they are recognized by size
+        if (packedSize >= unpackedSize)
+        {
+            packedSize = unpackedSize;
+            file_->Write(blockData, unpackedSize);
+        }
+        else
+            file_->Write(compressBuffer_.data(), packedSize);
+
+        entry.blockSizes_.push_back(packedSize);
+        totalPackedSize_ += packedSize;
+    }
+
+    totalDataSize_ += entry.size_;
+    entries_.push_back(ea::move(entry));
+    return true;
+}
+
+bool PackageBuilder::Build()
+{
+    if (!file_)
+    {
+        URHO3D_LOGERROR("Package is not created");
+        return false;
+    }
+
+    // Write file list with block index to the end of file
+    const unsigned fileListOffset = file_->GetSize();
+    for (const Entry& entry : entries_)
+    {
+        file_->WriteString(entry.name_);
+        file_->WriteUInt(entry.offset_);
+        file_->WriteUInt(entry.size_);
+        file_->WriteUInt(entry.checksum_);
+        for (unsigned blockSize : entry.blockSizes_)
+            file_->WriteVLE(blockSize);
+    }
+
+    // Write entry index sorted by name hash
+    if (compression_ == PackageCompression::Zstd && entryIndexEnabled_)
+    {
+        ea::vector<ea::pair<StringHash, unsigned>> entryIndex;
+        for (unsigned i = 0; i < entries_.size(); ++i)
+            entryIndex.emplace_back(StringHash(entries_[i].name_), i);
+        ea::sort(entryIndex.begin(), entryIndex.end());
+
+        file_->WriteUInt(entryIndex.size());
+        for (const auto& [hash, index] : entryIndex)
+        {
+            file_->WriteUInt(hash.Value());
+            file_->WriteUInt(index);
+        }
+    }
+
+    // Write package size to the end of file to allow finding it linked to an executable file
+    const unsigned currentSize = file_->GetSize();
+    file_->WriteUInt(currentSize + sizeof(unsigned));
+
+    // Write header again with correct number of files, checksum and file list offset
+    file_->Seek(0);
+    WriteHeader(fileListOffset);
+
+    file_->Close();
+    file_ = nullptr;
+    compressor_ = nullptr;
+    return true;
+}
+
+void PackageBuilder::WriteHeader(unsigned long long fileListOffset)
+{
+    if (compression_ == PackageCompression::None)
+    {
+        // Uncompressed package with file list in the end, version is reserved and always 0
+        file_->WriteFileID("RPAK");
+        file_->WriteUInt(entries_.size());
+        file_->WriteUInt(checksum_);
+        file_->WriteUInt(0);
+        file_->WriteInt64(static_cast<long long>(fileListOffset));
+        return;
+    }
+
+    file_->WriteFileID("RZST");
+    file_->WriteUInt(entries_.size());
+    file_->WriteUInt(checksum_);
+    file_->WriteUInt(entryIndexEnabled_ ? packageVersionWithIndex : packageVersion);
+    file_->WriteInt64(static_cast<long long>(fileListOffset));
+    file_->WriteUInt(blockSize_);
+    file_->WriteBuffer(dictionary_);
+}
+
+}
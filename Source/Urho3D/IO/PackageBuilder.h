@@ -0,0 +1,124 @@
+//
+// Copyright (c) 2017-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+/// \file
+
+#pragma once
+
+#include "Urho3D/Core/Object.h"
+#include "Urho3D/IO/Compression.h"
+#include "Urho3D/IO/PackageFile.h"
+
+#include <EASTL/span.h>
+#include <EASTL/unique_ptr.h>
+
+namespace Urho3D
+{
+
+class File;
+
+/// Writes package files that are read by PackageFile: Zstd packages with independently compressed blocks
+/// or uncompressed packages that may be memory-mapped.
+/// Files are appended one by one, the file list and the entry index are written on build.
+class URHO3D_API PackageBuilder : public Object
+{
+    URHO3D_OBJECT(PackageBuilder, Object);
+
+public:
+    /// Default uncompressed size of blocks.
+    static constexpr unsigned DefaultBlockSize = 65536;
+    /// Default Zstd compression level.
+    static constexpr int DefaultCompressionLevel = 19;
+
+    /// Construct.
+    explicit PackageBuilder(Context* context);
+    /// Destruct.
+    ~PackageBuilder() override;
+
+    /// Start writing the package. Return false if the file cannot be opened.
+    bool Create(const ea::string& fileName, unsigned blockSize = DefaultBlockSize,
+        int compressionLevel = DefaultCompressionLevel, const ByteVector& dictionary = {});
+    /// Append file to the package. Return false on failure.
+    bool Append(const ea::string& name, ea::span<const unsigned char> data);
+    /// Write the file list and finish the package. Return false on failure.
+    bool Build();
+
+    /// Set compression of the files. Only Zstd and no compression are supported. Should be called before Create.
+    void SetCompression(PackageCompression compression) { compression_ = compression; }
+    /// Set whether to write index of entries sorted by name hash. Packages without index are indexed on load.
+    /// Only Zstd packages store the index.
+    void SetEntryIndexEnabled(bool enabled) { entryIndexEnabled_ = enabled; }
+
+    /// Return compression of the files.
+    PackageCompression GetCompression() const { return compression_; }
+    /// Return whether the index of entries is written.
+    bool IsEntryIndexEnabled() const { return entryIndexEnabled_; }
+    /// Return number of appended files.
+    unsigned GetNumFiles() const { return entries_.size(); }
+    /// Return checksum of appended files.
+    unsigned GetChecksum() const { return checksum_; }
+    /// Return total uncompressed size of appended files.
+    unsigned long long GetTotalDataSize() const { return totalDataSize_; }
+    /// Return total stored size of appended files.
+    unsigned long long GetTotalPackedSize() const { return totalPackedSize_; }
+
+private:
+    /// Appended file.
+    struct Entry
+    {
+        ea::string name_;
+        unsigned offset_{};
+        unsigned size_{};
+        unsigned checksum_{};
+        ea::vector<unsigned> blockSizes_;
+    };
+
+    /// Write header. File list offset is unknown until the package is built.
+    void WriteHeader(unsigned long long fileListOffset);
+
+    /// Destination file.
+    SharedPtr<File> file_;
+    /// Compressor.
+    ea::unique_ptr<ZstdCompressor> compressor_;
+    /// Buffer for compressed block.
+    ByteVector compressBuffer_;
+    /// Uncompressed size of blocks.
+    unsigned blockSize_{};
+    /// Zstd dictionary.
+    ByteVector dictionary_;
+    /// Compression of the files.
+    PackageCompression compression_{PackageCompression::Zstd};
+    /// Whether to write index of entries.
+    bool entryIndexEnabled_{true};
+
+    /// Appended files.
+    ea::vector<Entry> entries_;
+    /// Checksum of appended files.
+    unsigned checksum_{};
+    /// Total uncompressed size.
+    unsigned long long totalDataSize_{};
+    /// Total stored size.
+    unsigned long long totalPackedSize_{};
+};
+
+}
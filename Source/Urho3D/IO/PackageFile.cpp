@@ -27,6 +27,8 @@
 #include "../IO/PackageFile.h"
 #include "../IO/FileSystem.h"
 
+#include <EASTL/sort.h>
+
 namespace Urho3D
 {
 
@@ -34,8 +36,7 @@ PackageFile::PackageFile(Context* context) :
     MountPoint(context),
     totalSize_(0),
     totalDataSize_(0),
-    checksum_(0),
-    compressed_(false)
+    checksum_(0)
 {
 }
 
@@ -43,8 +44,7 @@ PackageFile::PackageFile(Context* context, const ea::string& fileName, unsigned
     MountPoint(context),
     totalSize_(0),
     totalDataSize_(0),
-    checksum_(0),
-    compressed_(false)
+    checksum_(0)
 {
     Open(fileName, startOffset);
 }
@@ -60,7 +60,7 @@ bool PackageFile::Open(const ea::string& fileName, unsigned startOffset)
     // Check ID, then read the directory
     file->Seek(startOffset);
     ea::string id = file->ReadFileID();
-    if (id != "UPAK" && id != "ULZ4" && id != "RPAK" && id != "RLZ4")
+    if (id != "UPAK" && id != "ULZ4" && id != "RPAK" && id != "RLZ4" && id != "RZST")
     {
         // If start offset has not been explicitly specified, also try to read package size from the end of file
         // to know how much we must rewind to find the package start
@@ -77,7 +77,7 @@ bool PackageFile::Open(const ea::string& fileName, unsigned startOffset)
             }
         }
 
-        if (id != "UPAK" && id != "ULZ4" && id != "RPAK" && id != "RLZ4")
+        if (id != "UPAK" && id != "ULZ4" && id != "RPAK" && id != "RLZ4" && id != "RZST")
         {
             URHO3D_LOGERROR(fileName + " is not a valid package file");
             return false;
@@ -87,17 +87,51 @@ bool PackageFile::Open(const ea::string& fileName, unsigned startOffset)
     fileName_ = fileName;
     nameHash_ = fileName_;
     totalSize_ = file->GetSize();
-    compressed_ = id == "ULZ4" || id == "RLZ4";
+    if (id == "ULZ4" || id == "RLZ4")
+        compression_ = PackageCompression::LZ4;
+    else if (id == "RZST")
+        compression_ = PackageCompression::Zstd;
+    else
+        compression_ = PackageCompression::None;
     unsigned numFiles = file->ReadUInt();
     checksum_ = file->ReadUInt();
+    unsigned version = 0;
+
+    entries_.clear();
+    entryNames_.clear();
+    entryList_.clear();
+    entryIndex_.clear();
+    totalDataSize_ = 0;
 
-    if (id == "RPAK" || id == "RLZ4")
+    if (id == "RZST")
+    {
+        // Zstd PAK file format is versioned and stores block size and optional dictionary in the header.
+        // File list contains compressed sizes of all blocks, so any block can be found without decompressing the file.
+        version = file->ReadUInt();
+        if (version != 1 && version != 2)
+        {
+            URHO3D_LOGERROR("{} has unsupported package version {}", fileName, version);
+            return false;
+        }
+        const int64_t fileListOffset = file->ReadInt64();
+        blockSize_ = file->ReadUInt();
+        ByteVector dictionary = file->ReadBuffer();
+        if (blockSize_ == 0)
+        {
+            URHO3D_LOGERROR("{} has invalid block size", fileName);
+            return false;
+        }
+        if (!dictionary.empty())
+            dictionary_ = MakeShared<ZstdDictionary>(ea::move(dictionary));
+        file->Seek(fileListOffset);
+    }
+    else if (id == "RPAK" || id == "RLZ4")
     {
         // New PAK file format includes two extra PAK header fields:
         // * Version. At this time this field is unused and is always 0. It will be used in the future if PAK format needs to be extended.
         // * File list offset. New format writes file list in the end of the file. This allows PAK creation without knowing entire file list
         //   beforehand.
-        unsigned version = file->ReadUInt();                        // Reserved for future use.
+        version = file->ReadUInt();                                 // Reserved for future use.
         assert(version == 0);
         int64_t fileListOffset = file->ReadInt64();                 // New format has file list at the end of the file.
         file->Seek(fileListOffset);                                 // TODO: Serializer/Deserializer do not support files bigger than 4 GB
@@ -110,55 +144,116 @@ bool PackageFile::Open(const ea::string& fileName, unsigned startOffset)
         newEntry.offset_ = file->ReadUInt() + startOffset;
         totalDataSize_ += (newEntry.size_ = file->ReadUInt());
         newEntry.checksum_ = file->ReadUInt();
-        if (!compressed_ && newEntry.offset_ + newEntry.size_ > totalSize_)
+        if (compression_ == PackageCompression::Zstd)
+        {
+            const unsigned numBlocks = (newEntry.size_ + blockSize_ - 1) / blockSize_;
+            newEntry.blockOffsets_.resize(numBlocks + 1);
+            newEntry.blockOffsets_[0] = newEntry.offset_;
+            for (unsigned j = 0; j < numBlocks; ++j)
+                newEntry.blockOffsets_[j + 1] = newEntry.blockOffsets_[j] + file->ReadVLE();
+        }
+
+        const unsigned storedEnd = compression_ == PackageCompression::Zstd
+            ? newEntry.blockOffsets_.back() : newEntry.offset_ + newEntry.size_;
+        if (compression_ != PackageCompression::LZ4 && storedEnd > totalSize_)
         {
             URHO3D_LOGERROR("File entry " + entryName + " outside package file");
             return false;
         }
-        else
-            entries_[entryName] = newEntry;
+
+        const auto iter = entries_.find(entryName);
+        if (iter != entries_.end())
+        {
+            iter->second = ea::move(newEntry);
+            continue;
+        }
+
+        const auto newIter = entries_.emplace(entryName, ea::move(newEntry)).first;
+        entryNames_.push_back(entryName);
+        entryList_.push_back(&newIter->second);
     }
 
+    // Zstd PAK file format version 2 stores sorted index after the file list
+    const bool hasEntryIndex = id == "RZST" && version >= 2;
+    if (!hasEntryIndex || !ReadEntryIndex(*file))
+        BuildEntryIndex();
+
     return true;
 }
 
-bool PackageFile::Exists(const ea::string& fileName) const
+bool PackageFile::ReadEntryIndex(Deserializer& source)
 {
-    bool found = entries_.find(fileName) != entries_.end();
+    const unsigned numEntries = source.ReadUInt();
+    if (numEntries != entryNames_.size())
+        return false;
 
-#ifdef _WIN32
-    // On Windows perform a fallback case-insensitive search
-    if (!found)
+    entryIndex_.resize(numEntries);
+    for (unsigned i = 0; i < numEntries; ++i)
     {
-        for (auto i = entries_.begin(); i != entries_.end(); ++i)
+        const StringHash hash{source.ReadUInt()};
+        const unsigned index = source.ReadUInt();
+        // Hashes are trusted without rehashing entry names, lookup compares names anyway
+        if (index >= numEntries || (i > 0 && hash < entryIndex_[i - 1].first))
         {
-            if (!i->first.comparei(fileName))
-            {
-                found = true;
-                break;
-            }
+            URHO3D_LOGWARNING("Package file {} has invalid entry index", fileName_);
+            entryIndex_.clear();
+            return false;
         }
+        entryIndex_[i] = {hash, index};
     }
-#endif
+    return true;
+}
+
+void PackageFile::BuildEntryIndex()
+{
+    const unsigned numEntries = entryNames_.size();
+    entryIndex_.resize(numEntries);
+    for (unsigned i = 0; i < numEntries; ++i)
+        entryIndex_[i] = {StringHash(entryNames_[i]), i};
+    ea::sort(entryIndex_.begin(), entryIndex_.end());
+}
+
+void PackageFile::GetFileNameHashes(ea::vector<StringHash>& hashes) const
+{
+    for (const ea::string& entryName : entryNames_)
+        hashes.push_back(GetFileNameHash(entryName));
+}
 
-    return found;
+bool PackageFile::Exists(const ea::string& fileName) const
+{
+    return GetEntry(fileName) != nullptr;
+}
+
+ZstdDecompressor* PackageFile::GetDecompressor(unsigned threadIndex)
+{
+    MutexLock lock(decompressorsMutex_);
+
+    if (threadIndex >= decompressors_.size())
+        decompressors_.resize(threadIndex + 1);
+    if (!decompressors_[threadIndex])
+        decompressors_[threadIndex] = ea::make_unique<ZstdDecompressor>(dictionary_);
+    return decompressors_[threadIndex].get();
 }
 
 const PackageEntry* PackageFile::GetEntry(const ea::string& fileName) const
 {
-    auto i = entries_.find(fileName);
-    if (i != entries_.end())
-        return &i->second;
+    const StringHash nameHash{fileName};
+    const auto isLess = [](const ea::pair<StringHash, unsigned>& lhs, StringHash rhs) { return lhs.first < rhs; };
+    auto iter = ea::lower_bound(entryIndex_.begin(), entryIndex_.end(), nameHash, isLess);
+
+    // Names with the same hash are stored sequentially
+    for (; iter != entryIndex_.end() && iter->first == nameHash; ++iter)
+    {
+        if (entryNames_[iter->second] == fileName)
+            return entryList_[iter->second];
+    }
 
 #ifdef _WIN32
     // On Windows perform a fallback case-insensitive search
-    else
+    for (auto j = entries_.begin(); j != entries_.end(); ++j)
     {
-        for (auto j = entries_.begin(); j != entries_.end(); ++j)
-        {
-            if (!j->first.comparei(fileName))
-                return &j->second;
-        }
+        if (!j->first.comparei(fileName))
+            return &j->second;
     }
 #endif
 
@@ -225,6 +320,39 @@ AbstractFilePtr PackageFile::OpenFile(const FileIdentifier& fileName, FileMode m
     return file;
 }
 
+AbstractFilePtr PackageFile::OpenMappedFile(const FileIdentifier& fileName)
+{
+    // Compressed files cannot be accessed directly.
+    if (compression_ != PackageCompression::None)
+        return {};
+
+    if (!fileName.scheme_.empty() && fileName.scheme_ != GetName())
+        return {};
+
+    const PackageEntry* entry = GetEntry(fileName.fileName_);
+    if (!entry)
+        return {};
+
+    // All files share the mapping of the whole package.
+    ea::shared_ptr<MemoryMapping> mapping;
+    {
+        MutexLock lock(mappingMutex_);
+        if (!mappingCreated_)
+        {
+            mappingCreated_ = true;
+            mapping_ = MemoryMapping::Create(fileName_);
+        }
+        mapping = mapping_;
+    }
+
+    if (!mapping || entry->offset_ + entry->size_ > mapping->GetSize())
+        return {};
+
+    auto file = MakeShared<MemoryMappedFile>(ea::move(mapping), entry->offset_, entry->size_);
+    file->SetName(fileName.ToUri());
+    return file;
+}
+
 ea::optional<FileTime> PackageFile::GetLastModifiedTime(
     const FileIdentifier& fileName, bool creationIsModification) const
 {
@@ -22,6 +22,9 @@
 
 #pragma once
 
+#include "Urho3D/Core/Mutex.h"
+#include "Urho3D/IO/Compression.h"
+#include "Urho3D/IO/MemoryMappedFile.h"
 #include "Urho3D/IO/MountPoint.h"
 #include "Urho3D/IO/ScanFlags.h"
 
@@ -37,6 +40,19 @@ struct PackageEntry
     unsigned size_;
     /// File checksum.
     unsigned checksum_;
+    /// Offsets of independently compressed blocks, including the end of the last block. Used by Zstd packages only.
+    ea::vector<unsigned> blockOffsets_;
+};
+
+/// Compression of package file entries.
+enum class PackageCompression
+{
+    /// Files are stored as is.
+    None,
+    /// Files are stored as sequence of LZ4 blocks.
+    LZ4,
+    /// Files are stored as indexed Zstd blocks of fixed uncompressed size.
+    Zstd
 };
 
 /// Stores files of a directory tree sequentially for convenient access.
@@ -67,7 +83,7 @@ public:
 
     /// Return number of files.
     /// @property
-    unsigned GetNumFiles() const { return entries_.size(); }
+    unsigned GetNumFiles() const { return entryNames_.size(); }
 
     /// Return total size of the package file.
     /// @property
@@ -83,28 +99,29 @@ public:
 
     /// Return whether the files are compressed.
     /// @property
-    bool IsCompressed() const { return compressed_; }
-
-    /// Return list of file names in the package.
-    const ea::vector<ea::string> GetEntryNames() const { return entries_.keys(); }
+    bool IsCompressed() const { return compression_ != PackageCompression::None; }
+    /// Return compression of the files.
+    PackageCompression GetCompression() const { return compression_; }
+    /// Return uncompressed size of Zstd blocks.
+    unsigned GetBlockSize() const { return blockSize_; }
+    /// Return Zstd dictionary, if used.
+    ZstdDictionary* GetDictionary() const { return dictionary_; }
+    /// Return Zstd decompression context of WorkQueue thread with given index.
+    /// Contexts are created on demand and shared by all files opened from the package.
+    ZstdDecompressor* GetDecompressor(unsigned threadIndex);
+
+    /// Return list of file names in the package in the order of storage.
+    const ea::vector<ea::string>& GetEntryNames() const { return entryNames_; }
 
     /// Return a file name in the package at the specified index
-    const ea::string& GetEntryName(unsigned index) const
-    {
-        unsigned nn = 0;
-        for (auto j = entries_.begin(); j != entries_.end(); ++j)
-        {
-            if (nn == index) return j->first;
-            nn++;
-        }
-        return EMPTY_STRING;
-    }
+    const ea::string& GetEntryName(unsigned index) const { return index < entryNames_.size() ? entryNames_[index] : EMPTY_STRING; }
 
     /// Implement MountPoint.
     /// @{
     bool AcceptsScheme(const ea::string& scheme) const override;
     bool Exists(const FileIdentifier& fileName) const override;
     AbstractFilePtr OpenFile(const FileIdentifier& fileName, FileMode mode) override;
+    AbstractFilePtr OpenMappedFile(const FileIdentifier& fileName) override;
     ea::optional<FileTime> GetLastModifiedTime(
         const FileIdentifier& fileName, bool creationIsModification) const override;
 
@@ -112,11 +129,25 @@ public:
 
     void Scan(ea::vector<ea::string>& result, const ea::string& pathName, const ea::string& filter,
         ScanFlags flags) const override;
+
+    bool IsImmutable() const override { return true; }
+    void GetFileNameHashes(ea::vector<StringHash>& hashes) const override;
     /// @}
 
 private:
+    /// Read precomputed index of entries. Return false if it's invalid.
+    bool ReadEntryIndex(Deserializer& source);
+    /// Build index of entries from names.
+    void BuildEntryIndex();
+
     /// File entries.
     ea::unordered_map<ea::string, PackageEntry> entries_;
+    /// File names in the order of storage.
+    ea::vector<ea::string> entryNames_;
+    /// File entries in the order of storage.
+    ea::vector<const PackageEntry*> entryList_;
+    /// Pairs of name hash and entry index sorted by hash.
+    ea::vector<ea::pair<StringHash, unsigned>> entryIndex_;
     /// File name.
     ea::string fileName_;
     /// Package file name hash.
@@ -127,8 +158,22 @@ private:
     unsigned totalDataSize_;
     /// Package file checksum.
     unsigned checksum_;
-    /// Compressed flag.
-    bool compressed_;
+    /// Compression of the files.
+    PackageCompression compression_{};
+    /// Uncompressed size of Zstd blocks.
+    unsigned blockSize_{};
+    /// Zstd dictionary.
+    SharedPtr<ZstdDictionary> dictionary_;
+    /// Zstd decompression contexts indexed by WorkQueue thread index.
+    ea::vector<ea::unique_ptr<ZstdDecompressor>> decompressors_;
+    /// Mutex for the decompression contexts creation.
+    Mutex decompressorsMutex_;
+    /// Memory mapping of the whole package, created on demand.
+    ea::shared_ptr<MemoryMapping> mapping_;
+    /// Whether the mapping was attempted.
+    bool mappingCreated_{};
+    /// Mutex for the mapping creation.
+    Mutex mappingMutex_;
 };
 
 }
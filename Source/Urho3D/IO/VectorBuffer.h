@@ -50,6 +50,8 @@ public:
     unsigned Seek(unsigned position) override;
     /// Write bytes to the buffer. Return number of bytes actually written.
     unsigned Write(const void* data, unsigned size) override;
+    /// Return data.
+    const unsigned char* GetContiguousData() const override { return GetData(); }
 
     /// Set data from another buffer.
     void SetData(const ByteVector& data);
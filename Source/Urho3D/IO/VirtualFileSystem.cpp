@@ -9,6 +9,7 @@
 
 #include "Urho3D/Core/Context.h"
 #include "Urho3D/Core/CoreEvents.h"
+#include "Urho3D/Core/Profiler.h"
 #include "Urho3D/IO/FileSystem.h"
 #include "Urho3D/IO/Log.h"
 #include "Urho3D/IO/MountPoint.h"
@@ -40,6 +41,7 @@ MountedAliasRoot* VirtualFileSystem::GetOrCreateAliasRoot()
     {
         aliasMountPoint_ = MakeShared<MountedAliasRoot>(context_);
         mountPoints_.push_back(aliasMountPoint_);
+        lookupSegmentsDirty_ = true;
     }
 
     return aliasMountPoint_;
@@ -122,6 +124,7 @@ void VirtualFileSystem::Mount(MountPoint* mountPoint)
         return;
     }
     mountPoints_.push_back(pointPtr);
+    lookupSegmentsDirty_ = true;
 
     mountPoint->SetWatching(isWatching_);
 
@@ -200,6 +203,7 @@ void VirtualFileSystem::Unmount(MountPoint* mountPoint)
     {
         // Erase the slow way because order of the mount points matters.
         mountPoints_.erase(i);
+        lookupSegmentsDirty_ = true;
     }
 }
 
@@ -209,6 +213,7 @@ void VirtualFileSystem::UnmountAll()
 
     mountPoints_.clear();
     aliasMountPoint_ = nullptr;
+    lookupSegmentsDirty_ = true;
 }
 
 MountPoint* VirtualFileSystem::GetMountPoint(unsigned index) const
@@ -218,6 +223,81 @@ MountPoint* VirtualFileSystem::GetMountPoint(unsigned index) const
     return (index < mountPoints_.size()) ? mountPoints_[index].Get() : nullptr;
 }
 
+void VirtualFileSystem::UpdateLookupSegments() const
+{
+    if (!lookupSegmentsDirty_)
+        return;
+
+    URHO3D_PROFILE("UpdateFileLookup");
+
+    lookupSegmentsDirty_ = false;
+    lookupSegments_.clear();
+
+    ea::vector<StringHash> hashes;
+    for (MountPoint* mountPoint : ea::reverse(mountPoints_))
+    {
+        if (!mountPoint->IsImmutable())
+        {
+            lookupSegments_.push_back(LookupSegment{mountPoint});
+            continue;
+        }
+
+        if (lookupSegments_.empty() || lookupSegments_.back().mountPoint_)
+            lookupSegments_.emplace_back();
+
+        // Mount points are iterated from highest priority, so existing entries are kept
+        LookupSegment& segment = lookupSegments_.back();
+        segment.indexedMountPoints_.push_back(mountPoint);
+
+        hashes.clear();
+        mountPoint->GetFileNameHashes(hashes);
+        for (StringHash hash : hashes)
+            segment.index_.emplace(hash, mountPoint);
+    }
+}
+
+template <class T> bool VirtualFileSystem::VisitMountPoints(const FileIdentifier& fileName, const T& callback) const
+{
+    // Immutable mount points accept only empty scheme (among others), check all mount points otherwise
+    if (!fileName.scheme_.empty())
+    {
+        for (MountPoint* mountPoint : ea::reverse(mountPoints_))
+        {
+            if (callback(mountPoint))
+                return true;
+        }
+        return false;
+    }
+
+    UpdateLookupSegments();
+
+    const StringHash nameHash = MountPoint::GetFileNameHash(fileName.fileName_);
+    for (const LookupSegment& segment : lookupSegments_)
+    {
+        if (segment.mountPoint_)
+        {
+            if (callback(segment.mountPoint_))
+                return true;
+            continue;
+        }
+
+        const auto iter = segment.index_.find(nameHash);
+        if (iter == segment.index_.end())
+            continue;
+
+        if (callback(iter->second))
+            return true;
+
+        // Hash collision, file may be in mount point with lower priority
+        for (MountPoint* mountPoint : segment.indexedMountPoints_)
+        {
+            if (mountPoint != iter->second && callback(mountPoint))
+                return true;
+        }
+    }
+    return false;
+}
+
 AbstractFilePtr VirtualFileSystem::OpenFile(const FileIdentifier& fileName, FileMode mode) const
 {
     if (!fileName)
@@ -225,13 +305,39 @@ AbstractFilePtr VirtualFileSystem::OpenFile(const FileIdentifier& fileName, File
 
     MutexLock lock(mountMutex_);
 
-    for (MountPoint* mountPoint : ea::reverse(mountPoints_))
+    AbstractFilePtr result;
+    // Immutable mount points cannot be written to, so writes go through all mount points
+    if (mode == FILE_READ)
+        VisitMountPoints(fileName, [&](MountPoint* mountPoint) { return !!(result = mountPoint->OpenFile(fileName, mode)); });
+    else
     {
-        if (AbstractFilePtr result = mountPoint->OpenFile(fileName, mode))
-            return result;
+        for (MountPoint* mountPoint : ea::reverse(mountPoints_))
+        {
+            if ((result = mountPoint->OpenFile(fileName, mode)))
+                break;
+        }
     }
 
-    return nullptr;
+    return result;
+}
+
+AbstractFilePtr VirtualFileSystem::OpenMappedFile(const FileIdentifier& fileName) const
+{
+    if (!fileName)
+        return nullptr;
+
+    MutexLock lock(mountMutex_);
+
+    AbstractFilePtr result;
+    VisitMountPoints(fileName, [&](MountPoint* mountPoint)
+    {
+        result = mountPoint->OpenMappedFile(fileName);
+        if (!result)
+            result = mountPoint->OpenFile(fileName, FILE_READ);
+        return !!result;
+    });
+
+    return result;
 }
 
 ea::string VirtualFileSystem::ReadAllText(const FileIdentifier& fileName) const
@@ -263,13 +369,16 @@ FileTime VirtualFileSystem::GetLastModifiedTime(const FileIdentifier& fileName,
 {
     MutexLock lock(mountMutex_);
 
-    for (MountPoint* mountPoint : ea::reverse(mountPoints_))
+    FileTime result = 0;
+    VisitMountPoints(fileName, [&](MountPoint* mountPoint)
     {
-        if (const auto result = mountPoint->GetLastModifiedTime(fileName, creationIsModification))
-            return *result;
-    }
+        const auto time = mountPoint->GetLastModifiedTime(fileName, creationIsModification);
+        if (time)
+            result = *time;
+        return time.has_value();
+    });
 
-    return 0;
+    return result;
 }
 
 ea::string VirtualFileSystem::GetAbsoluteNameFromIdentifier(const FileIdentifier& fileName) const
@@ -291,8 +400,11 @@ FileIdentifier VirtualFileSystem::GetCanonicalIdentifier(const FileIdentifier& f
     FileIdentifier result = fileName;
 
     // .. is not supported
-    result.fileName_.replace("../", "");
-    result.fileName_.replace("./", "");
+    if (result.fileName_.find("./") != ea::string::npos)
+    {
+        result.fileName_.replace("../", "");
+        result.fileName_.replace("./", "");
+    }
     result.fileName_.trim();
 
     // Attempt to go from "file" scheme to local schemes
@@ -376,12 +488,7 @@ bool VirtualFileSystem::Exists(const FileIdentifier& fileName) const
 {
     MutexLock lock(mountMutex_);
 
-    for (MountPoint* mountPoint : ea::reverse(mountPoints_))
-    {
-        if (mountPoint->Exists(fileName))
-            return true;
-    }
-    return false;
+    return VisitMountPoints(fileName, [&](MountPoint* mountPoint) { return mountPoint->Exists(fileName); });
 }
 
 MountPointGuard::MountPointGuard(MountPoint* mountPoint)
@@ -61,6 +61,9 @@ public:
     bool Exists(const FileIdentifier& fileName) const;
     /// Open file in the virtual file system. Returns null if file not found.
     AbstractFilePtr OpenFile(const FileIdentifier& fileName, FileMode mode) const;
+    /// Open file for reading as read-only memory-mapped view if possible, or as regular file otherwise.
+    /// Returns null if file not found.
+    AbstractFilePtr OpenMappedFile(const FileIdentifier& fileName) const;
     /// Read text file from the virtual file system. Returns empty string if file not found.
     ea::string ReadAllText(const FileIdentifier& fileName) const;
     /// Write text file to the virtual file system. Returns true if file is written successfully.
@@ -89,8 +92,24 @@ public:
         ScanFlags flags) const;
 
 private:
+    /// Segment of mount points for file lookup.
+    struct LookupSegment
+    {
+        /// Mount point that is not indexed.
+        MountPoint* mountPoint_{};
+        /// Sequential immutable mount points in priority order.
+        ea::vector<MountPoint*> indexedMountPoints_;
+        /// Indexed mount point with highest priority for each file name hash.
+        ea::unordered_map<StringHash, MountPoint*> index_;
+    };
+
     /// Return or create internal alias:// mount point.
     MountedAliasRoot* GetOrCreateAliasRoot();
+    /// Rebuild lookup segments if mount points have changed. Should be called under lock.
+    void UpdateLookupSegments() const;
+    /// Call function for each mount point that may contain the file in priority order, until function returns true.
+    /// Should be called under lock.
+    template <class T> bool VisitMountPoints(const FileIdentifier& fileName, const T& callback) const;
 
     /// Mutex for thread-safe access to the mount points.
     mutable Mutex mountMutex_;
@@ -98,6 +117,10 @@ private:
     ea::vector<SharedPtr<MountPoint>> mountPoints_;
     /// Alias mount point.
     SharedPtr<MountedAliasRoot> aliasMountPoint_;
+    /// Mount points grouped for fast lookup, in priority order. Sequential immutable mount points are merged.
+    mutable ea::vector<LookupSegment> lookupSegments_;
+    /// Whether the lookup segments should be rebuilt.
+    mutable bool lookupSegmentsDirty_{true};
     /// Are file watchers enabled.
     bool isWatching_{};
 };
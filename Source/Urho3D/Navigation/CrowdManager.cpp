@@ -24,6 +24,7 @@
 
 #include "../Core/Context.h"
 #include "../Core/Profiler.h"
+#include "../Core/WorkQueue.h"
 #include "../Graphics/DebugRenderer.h"
 #include "../IO/Log.h"
 #include "../Navigation/CrowdAgent.h"
@@ -43,6 +44,9 @@ namespace Urho3D
 
 static const unsigned DEFAULT_MAX_AGENTS = 512;
 static const float DEFAULT_MAX_AGENT_RADIUS = 0.f;
+static const bool DEFAULT_MULTITHREADED = true;
+/// Minimum number of agents processed by one crowd update task.
+static const unsigned MIN_AGENTS_PER_TASK = 64;
 
 static const StringVector filterTypesStructureElementNames =
 {
@@ -76,10 +80,26 @@ void CrowdAgentUpdateCallback(bool positionUpdate, dtCrowdAgent* ag, float* pos,
         crowdAgent->OnCrowdVelocityUpdate(ag, pos, dt);
 }
 
+void CrowdParallelFor(void* userData, int count, dtCrowdRangeFunc func, void* data)
+{
+    // Thread index is only meaningful for WorkQueue threads, anything else uses the slot of the main thread
+    auto workQueue = static_cast<WorkQueue*>(userData);
+    if (!WorkQueue::IsProcessingThread())
+    {
+        func(data, 0, count, 0);
+        return;
+    }
+
+    workQueue->ParallelFor(count, MIN_AGENTS_PER_TASK,
+        [&](unsigned beginIndex, unsigned endIndex, unsigned threadIndex)
+    { func(data, static_cast<int>(beginIndex), static_cast<int>(endIndex), static_cast<int>(threadIndex)); });
+}
+
 CrowdManager::CrowdManager(Context* context) :
     Component(context),
     maxAgents_(DEFAULT_MAX_AGENTS),
-    maxAgentRadius_(DEFAULT_MAX_AGENT_RADIUS)
+    maxAgentRadius_(DEFAULT_MAX_AGENT_RADIUS),
+    multiThreaded_(DEFAULT_MULTITHREADED)
 {
     // The actual buffer is allocated inside dtCrowd, we only track the number of "slots" being configured explicitly
     numAreas_.reserve(DT_CROWD_MAX_QUERY_FILTER_TYPE);
@@ -100,6 +120,7 @@ void CrowdManager::RegisterObject(Context* context)
     URHO3D_ATTRIBUTE("Max Agents", unsigned, maxAgents_, DEFAULT_MAX_AGENTS, AM_DEFAULT);
     URHO3D_ATTRIBUTE("Max Agent Radius", float, maxAgentRadius_, DEFAULT_MAX_AGENT_RADIUS, AM_DEFAULT);
     URHO3D_ATTRIBUTE("Navigation Mesh", unsigned, navigationMeshId_, 0, AM_DEFAULT | AM_COMPONENTID);
+    URHO3D_ACCESSOR_ATTRIBUTE("Multithreaded", IsMultiThreaded, SetMultiThreaded, bool, DEFAULT_MULTITHREADED, AM_DEFAULT);
     URHO3D_MIXED_ACCESSOR_ATTRIBUTE("Filter Types", GetQueryFilterTypesAttr, SetQueryFilterTypesAttr,
         VariantVector, Variant::emptyVariantVector, AM_DEFAULT)
         .SetMetadata(AttributeMetadata::VectorStructElements, filterTypesStructureElementNames);
@@ -260,6 +281,15 @@ void CrowdManager::SetMaxAgents(unsigned maxAgents)
     }
 }
 
+void CrowdManager::SetMultiThreaded(bool enable)
+{
+    if (enable != multiThreaded_)
+    {
+        multiThreaded_ = enable;
+        SetupParallelUpdate();
+    }
+}
+
 void CrowdManager::SetMaxAgentRadius(float maxAgentRadius)
 {
     if (maxAgentRadius != maxAgentRadius_ && maxAgentRadius > 0.f)
@@ -419,6 +449,13 @@ void CrowdManager::FindPath(ea::vector<Vector3>& dest, const Vector3& start, con
         navigationMesh_->FindPath(dest, start, end, Vector3(crowd_->getQueryExtents()), crowd_->getFilter(queryFilterType));
 }
 
+unsigned CrowdManager::FindPathAsync(
+    const Vector3& start, const Vector3& end, int queryFilterType, const NavigationPathCallback& callback)
+{
+    return crowd_ && navigationMesh_ ? navigationMesh_->FindPathAsync(start, end, callback,
+        Vector3(crowd_->getQueryExtents()), crowd_->getFilter(queryFilterType)) : 0;
+}
+
 Vector3 CrowdManager::GetRandomPoint(int queryFilterType, dtPolyRef* randomRef)
 {
     if (randomRef)
@@ -601,6 +638,8 @@ bool CrowdManager::CreateCrowd()
         return false;
     }
 
+    SetupParallelUpdate();
+
     // Reconfigure the newly initialized crowd
     SetQueryFilterTypesAttr(queryFilterTypeConfiguration);
     SetObstacleAvoidanceTypesAttr(obstacleAvoidanceTypeConfiguration);
@@ -620,6 +659,22 @@ bool CrowdManager::CreateCrowd()
     return true;
 }
 
+void CrowdManager::SetupParallelUpdate()
+{
+    if (!crowd_)
+        return;
+
+    auto workQueue = GetSubsystem<WorkQueue>();
+    const unsigned numThreads = WorkQueue::GetThreadIndexCount();
+    if (multiThreaded_ && workQueue && numThreads > 1)
+    {
+        if (!crowd_->setParallelFor(CrowdParallelFor, workQueue, static_cast<int>(numThreads)))
+            URHO3D_LOGERROR("Could not allocate per-thread crowd data, crowd is updated in one thread");
+    }
+    else
+        crowd_->setParallelFor(nullptr, nullptr, 1);
+}
+
 int CrowdManager::AddAgent(CrowdAgent* agent, const Vector3& pos)
 {
     if (!crowd_ || !navigationMesh_ || !agent)
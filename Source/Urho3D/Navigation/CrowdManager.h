@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include "../Navigation/NavigationMesh.h"
 #include "../Scene/Component.h"
 
 #ifdef DT_POLYREF64
@@ -106,6 +107,10 @@ public:
     /// Set the maximum radius of any agent.
     /// @property
     void SetMaxAgentRadius(float maxAgentRadius);
+    /// Set whether independent per-agent steps of the crowd update are distributed between WorkQueue threads.
+    /// Steering callbacks and agent position updates are always invoked in the main thread.
+    /// @property
+    void SetMultiThreaded(bool enable);
     /// Assigns the navigation mesh for the crowd.
     /// @property{set_navMesh}
     void SetNavigationMesh(NavigationMesh* navMesh);
@@ -130,6 +135,9 @@ public:
     Vector3 MoveAlongSurface(const Vector3& start, const Vector3& end, int queryFilterType, int maxVisited = 3);
     /// Find a path between world space points using the crowd initialized query extent (based on maxAgentRadius) and the specified query filter type. Return non-empty list of points if successful.
     void FindPath(ea::vector<Vector3>& dest, const Vector3& start, const Vector3& end, int queryFilterType);
+    /// Request a path between world space points asynchronously using the crowd initialized query extent and the specified query filter type.
+    /// The query filter type shall not be reconfigured until the request is completed. Return request ID, or 0 if the request cannot be started.
+    unsigned FindPathAsync(const Vector3& start, const Vector3& end, int queryFilterType, const NavigationPathCallback& callback);
     /// Return a random point on the navigation mesh using the crowd initialized query extent (based on maxAgentRadius) and the specified query filter type.
     Vector3 GetRandomPoint(int queryFilterType, dtPolyRef* randomRef = nullptr);
     /// Return a random point on the navigation mesh within a circle using the crowd initialized query extent (based on maxAgentRadius) and the specified query filter type. The circle radius is only a guideline and in practice the returned point may be further away.
@@ -147,6 +155,10 @@ public:
     /// @property
     float GetMaxAgentRadius() const { return maxAgentRadius_; }
 
+    /// Return whether the crowd update is distributed between WorkQueue threads.
+    /// @property
+    bool IsMultiThreaded() const { return multiThreaded_; }
+
     /// Get the Navigation mesh assigned to the crowd.
     /// @property{get_navMesh}
     NavigationMesh* GetNavigationMesh() const { return navigationMesh_; }
@@ -179,6 +191,8 @@ public:
 protected:
     /// Create and initialized internal Detour crowd object. When it is a recreate, it preserves the configuration and attempts to re-add existing agents in the previous crowd back to the newly created crowd.
     bool CreateCrowd();
+    /// Configure parallel update of internal Detour crowd object.
+    void SetupParallelUpdate();
     /// Create and adds an detour crowd agent, Agent's radius and height is set through the navigation mesh. Return -1 on error, agent ID on success.
     int AddAgent(CrowdAgent* agent, const Vector3& pos);
     /// Removes the detour crowd agent.
@@ -221,6 +235,8 @@ private:
     unsigned maxAgents_{};
     /// The maximum radius of any agent that will be added to the crowd.
     float maxAgentRadius_{};
+    /// Whether the crowd update is distributed between WorkQueue threads.
+    bool multiThreaded_{};
     /// Number of query filter types configured in the crowd. Limit to DT_CROWD_MAX_QUERY_FILTER_TYPE.
     unsigned numQueryFilterTypes_{};
     /// Number of configured area in each filter type. Limit to DT_MAX_AREAS.
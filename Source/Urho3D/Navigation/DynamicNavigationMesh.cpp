@@ -58,12 +58,6 @@ namespace Urho3D
 static const int DEFAULT_MAX_OBSTACLES = 1024;
 static const int DEFAULT_MAX_LAYERS = 16;
 
-struct DynamicNavigationMesh::TileCacheData
-{
-    unsigned char* data;
-    int dataSize;
-};
-
 struct TileCompressor : public dtTileCacheCompressor
 {
     int maxCompressedSize(const int bufferSize) override
@@ -548,6 +542,9 @@ bool DynamicNavigationMesh::ReadTiles(Deserializer& source, bool silent)
     for (unsigned i = 0; i < tileQueue_.size(); ++i)
         tileCache_->buildNavMeshTilesAt(tileQueue_[i].x_, tileQueue_[i].y_, navMesh_);
 
+    if (!tileQueue_.empty())
+        InvalidatePathRequests();
+
     // Send event
     if (!silent)
     {
@@ -557,153 +554,115 @@ bool DynamicNavigationMesh::ReadTiles(Deserializer& source, bool silent)
     return true;
 }
 
-int DynamicNavigationMesh::BuildTile(ea::vector<NavigationGeometryInfo>& geometryList, int x, int z, TileCacheData* tiles)
+bool DynamicNavBuildData::BuildTileData()
 {
     URHO3D_PROFILE("BuildNavigationMeshTile");
 
-    dtCompressedTileRef tilesToRemove[MaxLayers];
-    const int numTilesToRemove = tileCache_->getTilesAt(x, z, tilesToRemove, MaxLayers);
-    for (int i = 0; i < numTilesToRemove; ++i)
-        tileCache_->removeTile(tilesToRemove[i], nullptr, nullptr);
-
-    const BoundingBox tileColumn = GetTileBoundingBoxColumn(IntVector2{x, z});
-    const BoundingBox tileBoundingBox =
-        IsHeightRangeValid() ? tileColumn : CalculateTileBoundingBox(geometryList, tileColumn);
-
-    DynamicNavBuildData build(allocator_.get());
-
-    rcConfig cfg;   // NOLINT(hicpp-member-init)
-    memset(&cfg, 0, sizeof(cfg));
-    cfg.cs = cellSize_;
-    cfg.ch = cellHeight_;
-    cfg.walkableSlopeAngle = agentMaxSlope_;
-    cfg.walkableHeight = (int)ceilf(agentHeight_ / cfg.ch);
-    cfg.walkableClimb = (int)floorf(agentMaxClimb_ / cfg.ch);
-    cfg.walkableRadius = (int)ceilf(agentRadius_ / cfg.cs);
-    cfg.maxEdgeLen = (int)(edgeMaxLength_ / cellSize_);
-    cfg.maxSimplificationError = edgeMaxError_;
-    cfg.minRegionArea = (int)sqrtf(regionMinSize_);
-    cfg.mergeRegionArea = (int)sqrtf(regionMergeSize_);
-    cfg.maxVertsPerPoly = 6;
-    cfg.tileSize = tileSize_;
-    cfg.borderSize = cfg.walkableRadius + 3; // Add padding
-    cfg.width = cfg.tileSize + cfg.borderSize * 2;
-    cfg.height = cfg.tileSize + cfg.borderSize * 2;
-    cfg.detailSampleDist = detailSampleDistance_ < 0.9f ? 0.0f : cellSize_ * detailSampleDistance_;
-    cfg.detailSampleMaxError = cellHeight_ * detailSampleMaxError_;
-
-    rcVcopy(cfg.bmin, &tileBoundingBox.min_.x_);
-    rcVcopy(cfg.bmax, &tileBoundingBox.max_.x_);
-    cfg.bmin[0] -= cfg.borderSize * cfg.cs;
-    cfg.bmin[1] -= padding_.y_;
-    cfg.bmin[2] -= cfg.borderSize * cfg.cs;
-    cfg.bmax[0] += cfg.borderSize * cfg.cs;
-    cfg.bmax[1] += padding_.y_;
-    cfg.bmax[2] += cfg.borderSize * cfg.cs;
-
-    BoundingBox expandedBox(*reinterpret_cast<Vector3*>(cfg.bmin), *reinterpret_cast<Vector3*>(cfg.bmax));
-    GetTileGeometry(&build, geometryList, expandedBox);
-
-    if (build.vertices_.empty() || build.indices_.empty())
-        return 0; // Nothing to do
-
-    build.heightField_ = rcAllocHeightfield();
-    if (!build.heightField_)
+    if (!config_)
+        return false;
+
+    const rcConfig& cfg = *config_;
+
+    if (vertices_.empty() || indices_.empty())
+        return true; // Nothing to do
+
+    heightField_ = rcAllocHeightfield();
+    if (!heightField_)
     {
         URHO3D_LOGERROR("Could not allocate heightfield");
-        return 0;
+        return false;
     }
 
-    if (!rcCreateHeightfield(build.ctx_, *build.heightField_, cfg.width, cfg.height, cfg.bmin, cfg.bmax, cfg.cs,
+    if (!rcCreateHeightfield(ctx_, *heightField_, cfg.width, cfg.height, cfg.bmin, cfg.bmax, cfg.cs,
         cfg.ch))
     {
         URHO3D_LOGERROR("Could not create heightfield");
-        return 0;
+        return false;
     }
 
-    const unsigned numTriangles = build.indices_.size() / 3;
-    URHO3D_ASSERT(numTriangles == build.areaIds_.size());
+    const unsigned numTriangles = indices_.size() / 3;
+    URHO3D_ASSERT(numTriangles == areaIds_.size());
 
-    DeduceAreaIds(cfg.walkableSlopeAngle, &build.vertices_[0].x_, &build.indices_[0], numTriangles, &build.areaIds_[0]);
+    DeduceAreaIds(cfg.walkableSlopeAngle, &vertices_[0].x_, &indices_[0], numTriangles, &areaIds_[0]);
 
-    rcRasterizeTriangles(build.ctx_, &build.vertices_[0].x_, build.vertices_.size(), &build.indices_[0],
-        &build.areaIds_[0], numTriangles, *build.heightField_, cfg.walkableClimb);
-    rcFilterLowHangingWalkableObstacles(build.ctx_, cfg.walkableClimb, *build.heightField_);
+    rcRasterizeTriangles(ctx_, &vertices_[0].x_, vertices_.size(), &indices_[0],
+        &areaIds_[0], numTriangles, *heightField_, cfg.walkableClimb);
+    rcFilterLowHangingWalkableObstacles(ctx_, cfg.walkableClimb, *heightField_);
 
-    rcFilterLedgeSpans(build.ctx_, cfg.walkableHeight, cfg.walkableClimb, *build.heightField_);
-    rcFilterWalkableLowHeightSpans(build.ctx_, cfg.walkableHeight, *build.heightField_);
+    rcFilterLedgeSpans(ctx_, cfg.walkableHeight, cfg.walkableClimb, *heightField_);
+    rcFilterWalkableLowHeightSpans(ctx_, cfg.walkableHeight, *heightField_);
 
-    build.compactHeightField_ = rcAllocCompactHeightfield();
-    if (!build.compactHeightField_)
+    compactHeightField_ = rcAllocCompactHeightfield();
+    if (!compactHeightField_)
     {
         URHO3D_LOGERROR("Could not allocate create compact heightfield");
-        return 0;
+        return false;
     }
-    if (!rcBuildCompactHeightfield(build.ctx_, cfg.walkableHeight, cfg.walkableClimb, *build.heightField_,
-        *build.compactHeightField_))
+    if (!rcBuildCompactHeightfield(ctx_, cfg.walkableHeight, cfg.walkableClimb, *heightField_,
+        *compactHeightField_))
     {
         URHO3D_LOGERROR("Could not build compact heightfield");
-        return 0;
+        return false;
     }
-    if (!rcErodeWalkableArea(build.ctx_, cfg.walkableRadius, *build.compactHeightField_))
+    if (!rcErodeWalkableArea(ctx_, cfg.walkableRadius, *compactHeightField_))
     {
         URHO3D_LOGERROR("Could not erode compact heightfield");
-        return 0;
+        return false;
     }
 
     // area volumes
-    for (unsigned i = 0; i < build.navAreas_.size(); ++i)
-        rcMarkBoxArea(build.ctx_, &build.navAreas_[i].bounds_.min_.x_, &build.navAreas_[i].bounds_.max_.x_,
-            build.navAreas_[i].areaID_, *build.compactHeightField_);
+    for (unsigned i = 0; i < navAreas_.size(); ++i)
+        rcMarkBoxArea(ctx_, &navAreas_[i].bounds_.min_.x_, &navAreas_[i].bounds_.max_.x_,
+            navAreas_[i].areaID_, *compactHeightField_);
 
-    if (this->partitionType_ == NAVMESH_PARTITION_WATERSHED)
+    if (!monotonePartition_)
     {
-        if (!rcBuildDistanceField(build.ctx_, *build.compactHeightField_))
+        if (!rcBuildDistanceField(ctx_, *compactHeightField_))
         {
             URHO3D_LOGERROR("Could not build distance field");
-            return 0;
+            return false;
         }
-        if (!rcBuildRegions(build.ctx_, *build.compactHeightField_, cfg.borderSize, cfg.minRegionArea,
+        if (!rcBuildRegions(ctx_, *compactHeightField_, cfg.borderSize, cfg.minRegionArea,
             cfg.mergeRegionArea))
         {
             URHO3D_LOGERROR("Could not build regions");
-            return 0;
+            return false;
         }
     }
     else
     {
-        if (!rcBuildRegionsMonotone(build.ctx_, *build.compactHeightField_, cfg.borderSize, cfg.minRegionArea, cfg.mergeRegionArea))
+        if (!rcBuildRegionsMonotone(ctx_, *compactHeightField_, cfg.borderSize, cfg.minRegionArea, cfg.mergeRegionArea))
         {
             URHO3D_LOGERROR("Could not build monotone regions");
-            return 0;
+            return false;
         }
     }
 
-    build.heightFieldLayers_ = rcAllocHeightfieldLayerSet();
-    if (!build.heightFieldLayers_)
+    heightFieldLayers_ = rcAllocHeightfieldLayerSet();
+    if (!heightFieldLayers_)
     {
         URHO3D_LOGERROR("Could not allocate height field layer set");
-        return 0;
+        return false;
     }
 
-    if (!rcBuildHeightfieldLayers(build.ctx_, *build.compactHeightField_, cfg.borderSize, cfg.walkableHeight,
-        *build.heightFieldLayers_))
+    if (!rcBuildHeightfieldLayers(ctx_, *compactHeightField_, cfg.borderSize, cfg.walkableHeight,
+        *heightFieldLayers_))
     {
         URHO3D_LOGERROR("Could not build height field layers");
-        return 0;
+        return false;
     }
 
-    int retCt = 0;
-    for (int i = 0; i < build.heightFieldLayers_->nlayers; ++i)
+    TileCompressor compressor;
+    for (int i = 0; i < heightFieldLayers_->nlayers; ++i)
     {
         dtTileCacheLayerHeader header;      // NOLINT(hicpp-member-init)
         header.magic = DT_TILECACHE_MAGIC;
         header.version = DT_TILECACHE_VERSION;
-        header.tx = x;
-        header.ty = z;
+        header.tx = tileIndex_.x_;
+        header.ty = tileIndex_.y_;
         header.tlayer = i;
 
-        rcHeightfieldLayer* layer = &build.heightFieldLayers_->layers[i];
+        rcHeightfieldLayer* layer = &heightFieldLayers_->layers[i];
 
         // Tile info.
         rcVcopy(header.bmin, layer->bmin);
@@ -717,68 +676,61 @@ int DynamicNavigationMesh::BuildTile(ea::vector<NavigationGeometryInfo>& geometr
         header.hmin = (unsigned short)layer->hmin;
         header.hmax = (unsigned short)layer->hmax;
 
+        NavTileData tile;
         if (dtStatusFailed(
-            dtBuildTileCacheLayer(compressor_.get()/*compressor*/, &header, layer->heights, layer->areas/*areas*/, layer->cons,
-                &(tiles[retCt].data), &tiles[retCt].dataSize)))
+            dtBuildTileCacheLayer(&compressor, &header, layer->heights, layer->areas/*areas*/, layer->cons,
+                &tile.data_, &tile.dataSize_)))
         {
             URHO3D_LOGERROR("Failed to build tile cache layers");
-            return 0;
+            ReleaseTileData();
+            return false;
         }
-        else
-            ++retCt;
-    }
 
-    // Send a notification of the rebuild of this tile to anyone interested
-    {
-        using namespace NavigationAreaRebuilt;
-        VariantMap& eventData = GetContext()->GetEventDataMap();
-        eventData[P_NODE] = GetNode();
-        eventData[P_MESH] = this;
-        eventData[P_BOUNDSMIN] = Variant(tileBoundingBox.min_);
-        eventData[P_BOUNDSMAX] = Variant(tileBoundingBox.max_);
-        SendEvent(E_NAVIGATION_AREA_REBUILT, eventData);
+        tileData_.push_back(tile);
     }
 
-    return retCt;
+    return true;
 }
 
-unsigned DynamicNavigationMesh::BuildTilesFromGeometry(
-    ea::vector<NavigationGeometryInfo>& geometryList, const IntVector2& from, const IntVector2& to)
+ea::unique_ptr<NavBuildData> DynamicNavigationMesh::CreateTileBuildData()
 {
-    unsigned numTiles = 0;
+    return ea::make_unique<DynamicNavBuildData>(allocator_.get());
+}
+
+unsigned DynamicNavigationMesh::CommitTileBuild(NavBuildData& build)
+{
+    const int x = build.tileIndex_.x_;
+    const int z = build.tileIndex_.y_;
 
-    for (int z = from.y_; z <= to.y_; ++z)
+    dtCompressedTileRef existing[MaxLayers];
+    const int existingCt = tileCache_->getTilesAt(x, z, existing, maxLayers_);
+    for (int i = 0; i < existingCt; ++i)
+        tileCache_->removeTile(existing[i], nullptr, nullptr);
+
+    unsigned numTiles = 0;
+    for (NavTileData& tile : build.tileData_)
     {
-        for (int x = from.x_; x <= to.x_; ++x)
-        {
-            dtCompressedTileRef existing[MaxLayers];
-            const int existingCt = tileCache_->getTilesAt(x, z, existing, maxLayers_);
-            for (int i = 0; i < existingCt; ++i)
-                tileCache_->removeTile(existing[i], nullptr, nullptr);
-
-            TileCacheData tiles[MaxLayers];
-            int layerCt = BuildTile(geometryList, x, z, tiles);
-            for (int i = 0; i < layerCt; ++i)
-            {
-                dtCompressedTileRef tileRef;
-                int status = tileCache_->addTile(tiles[i].data, tiles[i].dataSize, DT_COMPRESSEDTILE_FREE_DATA, &tileRef);
-                if (dtStatusFailed((dtStatus)status))
-                {
-                    dtFree(tiles[i].data);
-                    tiles[i].data = nullptr;
-                }
-                else
-                {
-                    tileCache_->buildNavMeshTile(tileRef, navMesh_);
-                    ++numTiles;
-                }
-            }
+        dtCompressedTileRef tileRef;
+        int status = tileCache_->addTile(tile.data_, tile.dataSize_, DT_COMPRESSEDTILE_FREE_DATA, &tileRef);
+        if (dtStatusFailed((dtStatus)status))
+            continue;
 
-            for (int i = layerCt; i < existingCt; ++i)
-                navMesh_->removeTile(navMesh_->getTileRefAt(x, z, i), 0, 0);
-        }
+        // Tile cache owns the data now
+        tile.data_ = nullptr;
+        tileCache_->buildNavMeshTile(tileRef, navMesh_);
+        ++numTiles;
     }
 
+    const int layerCt = static_cast<int>(build.tileData_.size());
+    for (int i = layerCt; i < existingCt; ++i)
+        navMesh_->removeTile(navMesh_->getTileRefAt(x, z, i), 0, 0);
+
+    InvalidatePathRequests();
+
+    // Send a notification of the rebuild of this tile to anyone interested
+    if (layerCt > 0)
+        SendAreaRebuiltEvent(build.worldBoundingBox_);
+
     return numTiles;
 }
 
@@ -850,6 +802,8 @@ void DynamicNavigationMesh::AddObstacle(Obstacle* obstacle, bool silent)
         }
         obstacle->obstacleId_ = refHolder;
         assert(refHolder > 0);
+        // Tiles are rebuilt on the next tile cache update, which happens before path requests are processed
+        InvalidatePathRequests();
 
         if (!silent)
         {
@@ -888,6 +842,7 @@ void DynamicNavigationMesh::RemoveObstacle(Obstacle* obstacle, bool silent)
             return;
         }
         obstacle->obstacleId_ = 0;
+        InvalidatePathRequests();
         // Require a node in order to send an event
         if (!silent && obstacle->GetNode())
         {
@@ -907,8 +862,11 @@ void DynamicNavigationMesh::HandleSceneSubsystemUpdate(StringHash eventType, Var
 {
     using namespace SceneSubsystemUpdate;
 
+    // Apply pending obstacle changes before asynchronous path requests are processed
     if (tileCache_ && navMesh_ && IsEnabledEffective())
         UpdateTileCache();
+
+    NavigationMesh::HandleSceneSubsystemUpdate(eventType, eventData);
 }
 
 }
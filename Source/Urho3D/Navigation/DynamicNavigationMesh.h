@@ -103,14 +103,12 @@ public:
     bool GetDrawObstacles() const { return drawObstacles_; }
 
 protected:
-    struct TileCacheData;
-
     /// Override NavigationMesh.
     /// @{
     bool AllocateMesh(unsigned maxTiles) override;
     bool RebuildMesh() override;
-    unsigned BuildTilesFromGeometry(
-        ea::vector<NavigationGeometryInfo>& geometryList, const IntVector2& from, const IntVector2& to) override;
+    ea::unique_ptr<NavBuildData> CreateTileBuildData() override;
+    unsigned CommitTileBuild(NavBuildData& build) override;
     /// @}
 
     /// Subscribe to events when assigned to a scene.
@@ -125,8 +123,6 @@ protected:
     /// Used by Obstacle class to remove itself from the tile cache, if 'silent' an event will not be raised.
     void RemoveObstacle(Obstacle* obstacle, bool silent = false);
 
-    /// Build one tile of the navigation mesh. Return true if successful.
-    int BuildTile(ea::vector<NavigationGeometryInfo>& geometryList, int x, int z, TileCacheData* tiles);
     /// Off-mesh connections to be rebuilt in the mesh processor.
     ea::vector<OffMeshConnection*> CollectOffMeshConnections(const BoundingBox& bounds);
     /// Release the navigation mesh, query, and tile cache.
@@ -26,6 +26,7 @@
 
 #include "../Navigation/NavBuildData.h"
 
+#include <Detour/DetourAlloc.h>
 #include <DetourTileCache/DetourTileCacheBuilder.h>
 #include <Recast/Recast.h>
 
@@ -41,6 +42,7 @@ NavBuildData::NavBuildData() :
 
 NavBuildData::~NavBuildData()
 {
+    ReleaseTileData();
     delete(ctx_);
     ctx_ = nullptr;
     rcFreeHeightField(heightField_);
@@ -49,6 +51,13 @@ NavBuildData::~NavBuildData()
     compactHeightField_ = nullptr;
 }
 
+void NavBuildData::ReleaseTileData()
+{
+    for (const NavTileData& tile : tileData_)
+        dtFree(tile.data_);
+    tileData_.clear();
+}
+
 SimpleNavBuildData::SimpleNavBuildData() :
     NavBuildData(),
     contourSet_(nullptr),
@@ -6,8 +6,10 @@
 #pragma once
 
 #include "Urho3D/Math/BoundingBox.h"
+#include "Urho3D/Math/Vector2.h"
 #include "Urho3D/Math/Vector3.h"
 
+#include <EASTL/unique_ptr.h>
 #include <EASTL/vector.h>
 
 class rcContext;
@@ -16,6 +18,7 @@ struct dtTileCacheContourSet;
 struct dtTileCachePolyMesh;
 struct dtTileCacheAlloc;
 struct rcCompactHeightfield;
+struct rcConfig;
 struct rcContourSet;
 struct rcHeightfield;
 struct rcHeightfieldLayerSet;
@@ -34,6 +37,15 @@ struct URHO3D_API NavAreaStub
     unsigned char areaID_;
 };
 
+/// Detour data of the built navigation mesh tile or tile cache layer. Allocated with dtAlloc.
+struct URHO3D_API NavTileData
+{
+    /// Data.
+    unsigned char* data_{};
+    /// Data size.
+    int dataSize_{};
+};
+
 /// Navigation build data.
 struct URHO3D_API NavBuildData
 {
@@ -42,8 +54,28 @@ struct URHO3D_API NavBuildData
     /// Destructor.
     virtual ~NavBuildData();
 
+    /// Build tile data from the collected geometry.
+    /// Doesn't access the navigation mesh or the scene, so it may be called from any thread.
+    virtual bool BuildTileData() = 0;
+    /// Release built tile data that was not added to the navigation mesh.
+    void ReleaseTileData();
+
+    /// Index of the navigation mesh tile.
+    IntVector2 tileIndex_;
     /// World-space bounding box of the navigation mesh tile.
     BoundingBox worldBoundingBox_;
+    /// Recast configuration of the tile.
+    ea::unique_ptr<rcConfig> config_;
+    /// Whether to use monotone partitioning instead of watershed.
+    bool monotonePartition_{};
+    /// Navigation agent height.
+    float agentHeight_{};
+    /// Navigation agent radius.
+    float agentRadius_{};
+    /// Navigation agent max vertical climb.
+    float agentMaxClimb_{};
+    /// Built tile data, one element per layer. Owned by build data until added to the navigation mesh.
+    ea::vector<NavTileData> tileData_;
     /// Vertices from geometries.
     ea::vector<Vector3> vertices_;
     /// Triangle indices from geometries.
@@ -77,6 +109,9 @@ struct URHO3D_API SimpleNavBuildData : public NavBuildData
     /// Descturctor.
     ~SimpleNavBuildData() override;
 
+    /// Build Detour tile. Implemented in NavigationMesh.cpp.
+    bool BuildTileData() override;
+
     /// Recast contour set.
     rcContourSet* contourSet_;
     /// Recast poly mesh.
@@ -93,6 +128,9 @@ struct URHO3D_API DynamicNavBuildData : public NavBuildData
     /// Destructor.
     ~DynamicNavBuildData() override;
 
+    /// Build compressed tile cache layers. Implemented in DynamicNavigationMesh.cpp.
+    bool BuildTileData() override;
+
     /// TileCache specific recast contour set.
     dtTileCacheContourSet* contourSet_;
     /// TileCache specific recast poly mesh.
@@ -24,6 +24,7 @@
 
 #include "../Core/Context.h"
 #include "../Core/Profiler.h"
+#include "../Core/WorkQueue.h"
 #include "../Graphics/DebugRenderer.h"
 #include "../Graphics/Drawable.h"
 #include "../Graphics/Geometry.h"
@@ -40,6 +41,7 @@
 #include "../Navigation/Navigable.h"
 #include "../Navigation/NavigationEvents.h"
 #include "../Navigation/NavigationMesh.h"
+#include "../Navigation/NavigationPathQueue.h"
 #include "../Navigation/NavigationUtils.h"
 #include "../Navigation/Obstacle.h"
 #include "../Navigation/OffMeshConnection.h"
@@ -47,6 +49,7 @@
 #include "../Physics/CollisionShape.h"
 #endif
 #include "../Scene/Scene.h"
+#include "../Scene/SceneEvents.h"
 
 #include <cfloat>
 #include <Detour/DetourNavMesh.h>
@@ -83,6 +86,9 @@ static const float DEFAULT_DETAIL_SAMPLE_DISTANCE = 6.0f;
 static const float DEFAULT_DETAIL_SAMPLE_MAX_ERROR = 1.0f;
 
 static const int MAX_POLYS = 2048;
+static const unsigned MAX_TILE_BUILD_BATCH = 64;
+static const unsigned DEFAULT_PATH_ITERATION_BUDGET = 4096;
+static const unsigned DEFAULT_PATH_CACHE_SIZE = 256;
 
 /// Temporary data for finding a path.
 struct FindPathData
@@ -130,6 +136,7 @@ NavigationMesh::NavigationMesh(Context* context) :
     navMeshQuery_(nullptr),
     queryFilter_(new dtQueryFilter()),
     pathData_(new FindPathData()),
+    pathQueue_(new NavigationPathQueue(MAX_POLYS, MAX_POLYS)),
     tileSize_(DEFAULT_TILE_SIZE),
     cellSize_(DEFAULT_CELL_SIZE),
     cellHeight_(DEFAULT_CELL_HEIGHT),
@@ -147,8 +154,11 @@ NavigationMesh::NavigationMesh(Context* context) :
     partitionType_(NAVMESH_PARTITION_WATERSHED),
     keepInterResults_(false),
     drawOffMeshConnections_(false),
-    drawNavAreas_(false)
+    drawNavAreas_(false),
+    pathIterationBudget_(DEFAULT_PATH_ITERATION_BUDGET)
 {
+    pathQueue_->SetMaxConcurrentRequests(WorkQueue::GetThreadIndexCount());
+    pathQueue_->SetMaxCacheSize(DEFAULT_PATH_CACHE_SIZE);
 }
 
 NavigationMesh::~NavigationMesh()
@@ -182,6 +192,10 @@ void NavigationMesh::RegisterObject(Context* context)
     URHO3D_ACCESSOR_ATTRIBUTE("Detail Sample Max Error", GetDetailSampleMaxError, SetDetailSampleMaxError, float,
         DEFAULT_DETAIL_SAMPLE_MAX_ERROR, AM_DEFAULT);
     URHO3D_ACCESSOR_ATTRIBUTE("Bounding Box Padding", GetPadding, SetPadding, Vector3, Vector3::ONE, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Path Iteration Budget", GetPathIterationBudget, SetPathIterationBudget, unsigned,
+        DEFAULT_PATH_ITERATION_BUDGET, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Path Cache Size", GetPathCacheSize, SetPathCacheSize, unsigned,
+        DEFAULT_PATH_CACHE_SIZE, AM_DEFAULT);
     URHO3D_MIXED_ACCESSOR_ATTRIBUTE("Navigation Data", GetNavigationDataAttr, SetNavigationDataAttr, ea::vector<unsigned char>,
         Variant::emptyBuffer, AM_DEFAULT | AM_NOEDIT);
     URHO3D_ENUM_ACCESSOR_ATTRIBUTE("Partition Type", GetPartitionType, SetPartitionType, NavmeshPartitionType, navmeshPartitionTypeNames,
@@ -557,6 +571,8 @@ void NavigationMesh::RemoveTile(const IntVector2& tileIndex)
     // Send event
     if (numTilesToRemove > 0)
     {
+        InvalidatePathRequests();
+
         using namespace NavigationTileRemoved;
         VariantMap& eventData = GetContext()->GetEventDataMap();
         eventData[P_NODE] = GetNode();
@@ -576,6 +592,7 @@ void NavigationMesh::RemoveAllTiles()
         if (tile->header)
             navMesh_->removeTile(navMesh_->getTileRef(tile), nullptr, nullptr);
     }
+    InvalidatePathRequests();
 
     // Send event
     using namespace NavigationAllTilesRemoved;
@@ -668,20 +685,115 @@ void NavigationMesh::FindPath(ea::vector<NavigationPathPoint>& dest, const Vecto
         return;
 
     int numPolys = 0;
-    int numPathPoints = 0;
-
     navMeshQuery_->findPath(startRef, endRef, &localStart.x_, &localEnd.x_, queryFilter, pathData_->polys_, &numPolys,
         MAX_POLYS);
+
+    FindStraightPath(dest, localStart, localEnd, pathData_->polys_, numPolys, endRef);
+}
+
+unsigned NavigationMesh::FindPathAsync(const Vector3& start, const Vector3& end, const NavigationPathCallback& callback,
+    const Vector3& extents, const dtQueryFilter* filter)
+{
+    if (!InitializeQuery())
+        return 0;
+
+    // Navigation data is in local space. Transform path points from world to local
+    const Matrix3x4 inverse = node_->GetWorldTransform().Inverse();
+
+    NavigationPathRequest request;
+    request.id_ = nextPathRequestId_++;
+    if (!request.id_)
+        request.id_ = nextPathRequestId_++;
+    request.start_ = inverse * start;
+    request.end_ = inverse * end;
+    request.extents_ = extents;
+    request.filter_ = filter ? filter : queryFilter_.get();
+
+    pathQueue_->Enqueue(request);
+    pathCallbacks_[request.id_] = callback;
+    return request.id_;
+}
+
+bool NavigationMesh::CancelPathRequest(unsigned requestId)
+{
+    pathQueue_->Cancel(requestId);
+    return pathCallbacks_.erase(requestId) != 0;
+}
+
+void NavigationMesh::ProcessPathRequests()
+{
+    if (pathCallbacks_.empty())
+        return;
+
+    URHO3D_PROFILE("ProcessPathRequests");
+
+    ea::vector<NavigationPathRequest> completedRequests;
+    if (!InitializeQuery())
+        pathQueue_->CancelAll(completedRequests);
+    else
+    {
+        if (pathQueue_->GetNavigationMesh() != navMesh_)
+            pathQueue_->SetNavigationMesh(navMesh_);
+        pathQueue_->Update(GetSubsystem<WorkQueue>(), pathIterationBudget_, completedRequests);
+    }
+
+    // Callbacks may cancel other requests or even remove the component
+    WeakPtr<NavigationMesh> self(this);
+    ea::vector<NavigationPathPoint> path;
+    for (const NavigationPathRequest& request : completedRequests)
+    {
+        const auto iter = pathCallbacks_.find(request.id_);
+        if (iter == pathCallbacks_.end())
+            continue;
+
+        const NavigationPathCallback callback = ea::move(iter->second);
+        pathCallbacks_.erase(iter);
+
+        path.clear();
+        if (!request.polys_.empty() && InitializeQuery())
+        {
+            FindStraightPath(path, request.start_, request.end_, request.polys_.data(),
+                static_cast<int>(request.polys_.size()), request.endRef_);
+        }
+
+        if (callback)
+            callback(path);
+        if (self.Expired())
+            return;
+    }
+}
+
+void NavigationMesh::SetPathCacheSize(unsigned size)
+{
+    pathQueue_->SetMaxCacheSize(size);
+}
+
+unsigned NavigationMesh::GetPathCacheSize() const
+{
+    return pathQueue_->GetMaxCacheSize();
+}
+
+unsigned NavigationMesh::GetNumPendingPathRequests() const
+{
+    return pathCallbacks_.size();
+}
+
+void NavigationMesh::FindStraightPath(ea::vector<NavigationPathPoint>& dest, const Vector3& localStart,
+    const Vector3& localEnd, const dtPolyRef* polys, int numPolys, dtPolyRef endRef)
+{
     if (!numPolys)
         return;
 
+    const Matrix3x4& transform = node_->GetWorldTransform();
     Vector3 actualLocalEnd = localEnd;
 
     // If full path was not found, clamp end point to the end polygon
-    if (pathData_->polys_[numPolys - 1] != endRef)
-        navMeshQuery_->closestPointOnPoly(pathData_->polys_[numPolys - 1], &localEnd.x_, &actualLocalEnd.x_, nullptr);
+    if (polys[numPolys - 1] != endRef)
+        navMeshQuery_->closestPointOnPoly(polys[numPolys - 1], &localEnd.x_, &actualLocalEnd.x_, nullptr);
 
-    navMeshQuery_->findStraightPath(&localStart.x_, &actualLocalEnd.x_, pathData_->polys_, numPolys,
+    int numPathPoints = 0;
+
+    navMeshQuery_->findStraightPath(&localStart.x_, &actualLocalEnd.x_, polys, numPolys,
         &pathData_->pathPoints_[0].x_, pathData_->pathFlags_, pathData_->pathPolys_, &numPathPoints, MAX_POLYS);
 
     // Transform path result back to world space
@@ -1274,6 +1386,7 @@ bool NavigationMesh::ReadTile(Deserializer& source, bool silent)
         dtFree(navData);
         return false;
     }
+    InvalidatePathRequests();
 
     if (!silent)
         SendTileAddedEvent(IntVector2(x, z));
@@ -1291,111 +1404,75 @@ void NavigationMesh::SendTileAddedEvent(const IntVector2& tileIndex)
     SendEvent(E_NAVIGATION_TILE_ADDED, eventData);
 }
 
-bool NavigationMesh::BuildTile(ea::vector<NavigationGeometryInfo>& geometryList, int x, int z)
+bool SimpleNavBuildData::BuildTileData()
 {
     URHO3D_PROFILE("BuildNavigationMeshTile");
 
-    // Remove previous tile (if any)
-    navMesh_->removeTile(navMesh_->getTileRefAt(x, z, 0), nullptr, nullptr);
-
-    const BoundingBox tileColumn = GetTileBoundingBoxColumn(IntVector2{x, z});
-    const BoundingBox tileBoundingBox =
-        IsHeightRangeValid() ? tileColumn : CalculateTileBoundingBox(geometryList, tileColumn);
-
-    SimpleNavBuildData build;
-
-    rcConfig cfg;       // NOLINT(hicpp-member-init)
-    memset(&cfg, 0, sizeof(cfg));
-    cfg.cs = cellSize_;
-    cfg.ch = cellHeight_;
-    cfg.walkableSlopeAngle = agentMaxSlope_;
-    cfg.walkableHeight = CeilToInt(agentHeight_ / cfg.ch);
-    cfg.walkableClimb = FloorToInt(agentMaxClimb_ / cfg.ch);
-    cfg.walkableRadius = CeilToInt(agentRadius_ / cfg.cs);
-    cfg.maxEdgeLen = (int)(edgeMaxLength_ / cellSize_);
-    cfg.maxSimplificationError = edgeMaxError_;
-    cfg.minRegionArea = (int)sqrtf(regionMinSize_);
-    cfg.mergeRegionArea = (int)sqrtf(regionMergeSize_);
-    cfg.maxVertsPerPoly = 6;
-    cfg.tileSize = tileSize_;
-    cfg.borderSize = cfg.walkableRadius + 3; // Add padding
-    cfg.width = cfg.tileSize + cfg.borderSize * 2;
-    cfg.height = cfg.tileSize + cfg.borderSize * 2;
-    cfg.detailSampleDist = detailSampleDistance_ < 0.9f ? 0.0f : cellSize_ * detailSampleDistance_;
-    cfg.detailSampleMaxError = cellHeight_ * detailSampleMaxError_;
-
-    rcVcopy(cfg.bmin, &tileBoundingBox.min_.x_);
-    rcVcopy(cfg.bmax, &tileBoundingBox.max_.x_);
-    cfg.bmin[0] -= cfg.borderSize * cfg.cs;
-    cfg.bmin[1] -= padding_.y_;
-    cfg.bmin[2] -= cfg.borderSize * cfg.cs;
-    cfg.bmax[0] += cfg.borderSize * cfg.cs;
-    cfg.bmax[1] += padding_.y_;
-    cfg.bmax[2] += cfg.borderSize * cfg.cs;
+    if (!config_)
+        return false;
 
-    BoundingBox expandedBox(*reinterpret_cast<Vector3*>(cfg.bmin), *reinterpret_cast<Vector3*>(cfg.bmax));
-    GetTileGeometry(&build, geometryList, expandedBox);
+    const rcConfig& cfg = *config_;
 
-    if (build.vertices_.empty() || build.indices_.empty())
+    if (vertices_.empty() || indices_.empty())
         return true; // Nothing to do
 
-    build.heightField_ = rcAllocHeightfield();
-    if (!build.heightField_)
+    heightField_ = rcAllocHeightfield();
+    if (!heightField_)
     {
         URHO3D_LOGERROR("Could not allocate heightfield");
         return false;
     }
 
-    if (!rcCreateHeightfield(build.ctx_, *build.heightField_, cfg.width, cfg.height, cfg.bmin, cfg.bmax, cfg.cs,
+    if (!rcCreateHeightfield(ctx_, *heightField_, cfg.width, cfg.height, cfg.bmin, cfg.bmax, cfg.cs,
         cfg.ch))
     {
         URHO3D_LOGERROR("Could not create heightfield");
         return false;
     }
 
-    const unsigned numTriangles = build.indices_.size() / 3;
-    URHO3D_ASSERT(numTriangles == build.areaIds_.size());
+    const unsigned numTriangles = indices_.size() / 3;
+    URHO3D_ASSERT(numTriangles == areaIds_.size());
 
-    DeduceAreaIds(cfg.walkableSlopeAngle, &build.vertices_[0].x_, &build.indices_[0], numTriangles, &build.areaIds_[0]);
+    DeduceAreaIds(cfg.walkableSlopeAngle, &vertices_[0].x_, &indices_[0], numTriangles, &areaIds_[0]);
 
-    rcRasterizeTriangles(build.ctx_, &build.vertices_[0].x_, build.vertices_.size(), &build.indices_[0],
-        &build.areaIds_[0], numTriangles, *build.heightField_, cfg.walkableClimb);
-    rcFilterLowHangingWalkableObstacles(build.ctx_, cfg.walkableClimb, *build.heightField_);
+    rcRasterizeTriangles(ctx_, &vertices_[0].x_, vertices_.size(), &indices_[0],
+        &areaIds_[0], numTriangles, *heightField_, cfg.walkableClimb);
+    rcFilterLowHangingWalkableObstacles(ctx_, cfg.walkableClimb, *heightField_);
 
-    rcFilterWalkableLowHeightSpans(build.ctx_, cfg.walkableHeight, *build.heightField_);
-    rcFilterLedgeSpans(build.ctx_, cfg.walkableHeight, cfg.walkableClimb, *build.heightField_);
+    rcFilterWalkableLowHeightSpans(ctx_, cfg.walkableHeight, *heightField_);
+    rcFilterLedgeSpans(ctx_, cfg.walkableHeight, cfg.walkableClimb, *heightField_);
 
-    build.compactHeightField_ = rcAllocCompactHeightfield();
-    if (!build.compactHeightField_)
+    compactHeightField_ = rcAllocCompactHeightfield();
+    if (!compactHeightField_)
     {
         URHO3D_LOGERROR("Could not allocate create compact heightfield");
         return false;
     }
-    if (!rcBuildCompactHeightfield(build.ctx_, cfg.walkableHeight, cfg.walkableClimb, *build.heightField_,
-        *build.compactHeightField_))
+    if (!rcBuildCompactHeightfield(ctx_, cfg.walkableHeight, cfg.walkableClimb, *heightField_,
+        *compactHeightField_))
     {
         URHO3D_LOGERROR("Could not build compact heightfield");
         return false;
     }
-    if (!rcErodeWalkableArea(build.ctx_, cfg.walkableRadius, *build.compactHeightField_))
+    if (!rcErodeWalkableArea(ctx_, cfg.walkableRadius, *compactHeightField_))
     {
         URHO3D_LOGERROR("Could not erode compact heightfield");
         return false;
     }
 
     // Mark area volumes
-    for (unsigned i = 0; i < build.navAreas_.size(); ++i)
-        rcMarkBoxArea(build.ctx_, &build.navAreas_[i].bounds_.min_.x_, &build.navAreas_[i].bounds_.max_.x_,
-            build.navAreas_[i].areaID_, *build.compactHeightField_);
+    for (unsigned i = 0; i < navAreas_.size(); ++i)
+        rcMarkBoxArea(ctx_, &navAreas_[i].bounds_.min_.x_, &navAreas_[i].bounds_.max_.x_,
+            navAreas_[i].areaID_, *compactHeightField_);
 
-    if (this->partitionType_ == NAVMESH_PARTITION_WATERSHED)
+    if (!monotonePartition_)
     {
-        if (!rcBuildDistanceField(build.ctx_, *build.compactHeightField_))
+        if (!rcBuildDistanceField(ctx_, *compactHeightField_))
         {
             URHO3D_LOGERROR("Could not build distance field");
             return false;
         }
-        if (!rcBuildRegions(build.ctx_, *build.compactHeightField_, cfg.borderSize, cfg.minRegionArea,
+        if (!rcBuildRegions(ctx_, *compactHeightField_, cfg.borderSize, cfg.minRegionArea,
             cfg.mergeRegionArea))
         {
             URHO3D_LOGERROR("Could not build regions");
@@ -1404,46 +1481,46 @@ bool NavigationMesh::BuildTile(ea::vector<NavigationGeometryInfo>& geometryList,
     }
     else
     {
-        if (!rcBuildRegionsMonotone(build.ctx_, *build.compactHeightField_, cfg.borderSize, cfg.minRegionArea, cfg.mergeRegionArea))
+        if (!rcBuildRegionsMonotone(ctx_, *compactHeightField_, cfg.borderSize, cfg.minRegionArea, cfg.mergeRegionArea))
         {
             URHO3D_LOGERROR("Could not build monotone regions");
             return false;
         }
     }
 
-    build.contourSet_ = rcAllocContourSet();
-    if (!build.contourSet_)
+    contourSet_ = rcAllocContourSet();
+    if (!contourSet_)
     {
         URHO3D_LOGERROR("Could not allocate contour set");
         return false;
     }
-    if (!rcBuildContours(build.ctx_, *build.compactHeightField_, cfg.maxSimplificationError, cfg.maxEdgeLen,
-        *build.contourSet_))
+    if (!rcBuildContours(ctx_, *compactHeightField_, cfg.maxSimplificationError, cfg.maxEdgeLen,
+        *contourSet_))
     {
         URHO3D_LOGERROR("Could not create contours");
         return false;
     }
 
-    build.polyMesh_ = rcAllocPolyMesh();
-    if (!build.polyMesh_)
+    polyMesh_ = rcAllocPolyMesh();
+    if (!polyMesh_)
     {
         URHO3D_LOGERROR("Could not allocate poly mesh");
         return false;
     }
-    if (!rcBuildPolyMesh(build.ctx_, *build.contourSet_, cfg.maxVertsPerPoly, *build.polyMesh_))
+    if (!rcBuildPolyMesh(ctx_, *contourSet_, cfg.maxVertsPerPoly, *polyMesh_))
     {
         URHO3D_LOGERROR("Could not triangulate contours");
         return false;
     }
 
-    build.polyMeshDetail_ = rcAllocPolyMeshDetail();
-    if (!build.polyMeshDetail_)
+    polyMeshDetail_ = rcAllocPolyMeshDetail();
+    if (!polyMeshDetail_)
     {
         URHO3D_LOGERROR("Could not allocate detail mesh");
         return false;
     }
-    if (!rcBuildPolyMeshDetail(build.ctx_, *build.polyMesh_, *build.compactHeightField_, cfg.detailSampleDist,
-        cfg.detailSampleMaxError, *build.polyMeshDetail_))
+    if (!rcBuildPolyMeshDetail(ctx_, *polyMesh_, *compactHeightField_, cfg.detailSampleDist,
+        cfg.detailSampleMaxError, *polyMeshDetail_))
     {
         URHO3D_LOGERROR("Could not build detail mesh");
         return false;
@@ -1451,10 +1528,10 @@ bool NavigationMesh::BuildTile(ea::vector<NavigationGeometryInfo>& geometryList,
 
     // Set polygon flags
     /// \todo Assignment of flags from navigation areas?
-    for (int i = 0; i < build.polyMesh_->npolys; ++i)
+    for (int i = 0; i < polyMesh_->npolys; ++i)
     {
-        if (build.polyMesh_->areas[i] != RC_NULL_AREA)
-            build.polyMesh_->flags[i] = 0x1;
+        if (polyMesh_->areas[i] != RC_NULL_AREA)
+            polyMesh_->flags[i] = 0x1;
     }
 
     unsigned char* navData = nullptr;
@@ -1462,38 +1539,38 @@ bool NavigationMesh::BuildTile(ea::vector<NavigationGeometryInfo>& geometryList,
 
     dtNavMeshCreateParams params;       // NOLINT(hicpp-member-init)
     memset(&params, 0, sizeof params);
-    params.verts = build.polyMesh_->verts;
-    params.vertCount = build.polyMesh_->nverts;
-    params.polys = build.polyMesh_->polys;
-    params.polyAreas = build.polyMesh_->areas;
-    params.polyFlags = build.polyMesh_->flags;
-    params.polyCount = build.polyMesh_->npolys;
-    params.nvp = build.polyMesh_->nvp;
-    params.detailMeshes = build.polyMeshDetail_->meshes;
-    params.detailVerts = build.polyMeshDetail_->verts;
-    params.detailVertsCount = build.polyMeshDetail_->nverts;
-    params.detailTris = build.polyMeshDetail_->tris;
-    params.detailTriCount = build.polyMeshDetail_->ntris;
+    params.verts = polyMesh_->verts;
+    params.vertCount = polyMesh_->nverts;
+    params.polys = polyMesh_->polys;
+    params.polyAreas = polyMesh_->areas;
+    params.polyFlags = polyMesh_->flags;
+    params.polyCount = polyMesh_->npolys;
+    params.nvp = polyMesh_->nvp;
+    params.detailMeshes = polyMeshDetail_->meshes;
+    params.detailVerts = polyMeshDetail_->verts;
+    params.detailVertsCount = polyMeshDetail_->nverts;
+    params.detailTris = polyMeshDetail_->tris;
+    params.detailTriCount = polyMeshDetail_->ntris;
     params.walkableHeight = agentHeight_;
     params.walkableRadius = agentRadius_;
     params.walkableClimb = agentMaxClimb_;
-    params.tileX = x;
-    params.tileY = z;
-    rcVcopy(params.bmin, build.polyMesh_->bmin);
-    rcVcopy(params.bmax, build.polyMesh_->bmax);
+    params.tileX = tileIndex_.x_;
+    params.tileY = tileIndex_.y_;
+    rcVcopy(params.bmin, polyMesh_->bmin);
+    rcVcopy(params.bmax, polyMesh_->bmax);
     params.cs = cfg.cs;
     params.ch = cfg.ch;
     params.buildBvTree = true;
 
     // Add off-mesh connections if have them
-    if (build.offMeshRadii_.size())
+    if (offMeshRadii_.size())
     {
-        params.offMeshConCount = build.offMeshRadii_.size();
-        params.offMeshConVerts = &build.offMeshVertices_[0].x_;
-        params.offMeshConRad = &build.offMeshRadii_[0];
-        params.offMeshConFlags = &build.offMeshFlags_[0];
-        params.offMeshConAreas = &build.offMeshAreas_[0];
-        params.offMeshConDir = &build.offMeshDir_[0];
+        params.offMeshConCount = offMeshRadii_.size();
+        params.offMeshConVerts = &offMeshVertices_[0].x_;
+        params.offMeshConRad = &offMeshRadii_[0];
+        params.offMeshConFlags = &offMeshFlags_[0];
+        params.offMeshConAreas = &offMeshAreas_[0];
+        params.offMeshConDir = &offMeshDir_[0];
     }
 
     if (!dtCreateNavMeshData(&params, &navData, &navDataSize))
@@ -1502,40 +1579,238 @@ bool NavigationMesh::BuildTile(ea::vector<NavigationGeometryInfo>& geometryList,
         return false;
     }
 
-    if (dtStatusFailed(navMesh_->addTile(navData, navDataSize, DT_TILE_FREE_DATA, 0, nullptr)))
+    tileData_.push_back(NavTileData{navData, navDataSize});
+    return true;
+}
+
+void NavigationMesh::PrepareTileBuild(
+    NavBuildData& build, const ea::vector<NavigationGeometryInfo>& geometryList, const IntVector2& tileIndex)
+{
+    const BoundingBox tileColumn = GetTileBoundingBoxColumn(tileIndex);
+    const BoundingBox tileBoundingBox =
+        IsHeightRangeValid() ? tileColumn : CalculateTileBoundingBox(geometryList, tileColumn);
+
+    build.tileIndex_ = tileIndex;
+    build.worldBoundingBox_ = tileBoundingBox;
+    build.monotonePartition_ = partitionType_ == NAVMESH_PARTITION_MONOTONE;
+    build.agentHeight_ = agentHeight_;
+    build.agentRadius_ = agentRadius_;
+    build.agentMaxClimb_ = agentMaxClimb_;
+    build.config_ = ea::make_unique<rcConfig>();
+
+    rcConfig& cfg = *build.config_;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.cs = cellSize_;
+    cfg.ch = cellHeight_;
+    cfg.walkableSlopeAngle = agentMaxSlope_;
+    cfg.walkableHeight = CeilToInt(agentHeight_ / cfg.ch);
+    cfg.walkableClimb = FloorToInt(agentMaxClimb_ / cfg.ch);
+    cfg.walkableRadius = CeilToInt(agentRadius_ / cfg.cs);
+    cfg.maxEdgeLen = (int)(edgeMaxLength_ / cellSize_);
+    cfg.maxSimplificationError = edgeMaxError_;
+    cfg.minRegionArea = (int)sqrtf(regionMinSize_);
+    cfg.mergeRegionArea = (int)sqrtf(regionMergeSize_);
+    cfg.maxVertsPerPoly = 6;
+    cfg.tileSize = tileSize_;
+    cfg.borderSize = cfg.walkableRadius + 3; // Add padding
+    cfg.width = cfg.tileSize + cfg.borderSize * 2;
+    cfg.height = cfg.tileSize + cfg.borderSize * 2;
+    cfg.detailSampleDist = detailSampleDistance_ < 0.9f ? 0.0f : cellSize_ * detailSampleDistance_;
+    cfg.detailSampleMaxError = cellHeight_ * detailSampleMaxError_;
+
+    rcVcopy(cfg.bmin, &tileBoundingBox.min_.x_);
+    rcVcopy(cfg.bmax, &tileBoundingBox.max_.x_);
+    cfg.bmin[0] -= cfg.borderSize * cfg.cs;
+    cfg.bmin[1] -= padding_.y_;
+    cfg.bmin[2] -= cfg.borderSize * cfg.cs;
+    cfg.bmax[0] += cfg.borderSize * cfg.cs;
+    cfg.bmax[1] += padding_.y_;
+    cfg.bmax[2] += cfg.borderSize * cfg.cs;
+
+    BoundingBox expandedBox(*reinterpret_cast<Vector3*>(cfg.bmin), *reinterpret_cast<Vector3*>(cfg.bmax));
+    GetTileGeometry(&build, geometryList, expandedBox);
+}
+
+ea::unique_ptr<NavBuildData> NavigationMesh::CreateTileBuildData()
+{
+    return ea::make_unique<SimpleNavBuildData>();
+}
+
+unsigned NavigationMesh::CommitTileBuild(NavBuildData& build)
+{
+    const IntVector2& tileIndex = build.tileIndex_;
+
+    // Remove previous tile (if any)
+    navMesh_->removeTile(navMesh_->getTileRefAt(tileIndex.x_, tileIndex.y_, 0), nullptr, nullptr);
+    InvalidatePathRequests();
+
+    unsigned numTiles = 0;
+    for (NavTileData& tile : build.tileData_)
     {
-        URHO3D_LOGERROR("Failed to add navigation mesh tile");
-        dtFree(navData);
-        return false;
+        if (dtStatusFailed(navMesh_->addTile(tile.data_, tile.dataSize_, DT_TILE_FREE_DATA, 0, nullptr)))
+        {
+            URHO3D_LOGERROR("Failed to add navigation mesh tile");
+            continue;
+        }
+
+        // Navigation mesh owns the data now
+        tile.data_ = nullptr;
+        ++numTiles;
     }
 
     // Send a notification of the rebuild of this tile to anyone interested
-    {
-        using namespace NavigationAreaRebuilt;
-        VariantMap& eventData = GetContext()->GetEventDataMap();
-        eventData[P_NODE] = GetNode();
-        eventData[P_MESH] = this;
-        eventData[P_BOUNDSMIN] = Variant(tileBoundingBox.min_);
-        eventData[P_BOUNDSMAX] = Variant(tileBoundingBox.max_);
-        SendEvent(E_NAVIGATION_AREA_REBUILT, eventData);
-    }
-    return true;
+    if (numTiles > 0)
+        SendAreaRebuiltEvent(build.worldBoundingBox_);
+
+    return numTiles;
+}
+
+void NavigationMesh::SendAreaRebuiltEvent(const BoundingBox& boundingBox)
+{
+    using namespace NavigationAreaRebuilt;
+    VariantMap& eventData = GetContext()->GetEventDataMap();
+    eventData[P_NODE] = GetNode();
+    eventData[P_MESH] = this;
+    eventData[P_BOUNDSMIN] = Variant(boundingBox.min_);
+    eventData[P_BOUNDSMAX] = Variant(boundingBox.max_);
+    SendEvent(E_NAVIGATION_AREA_REBUILT, eventData);
 }
 
 unsigned NavigationMesh::BuildTilesFromGeometry(
     ea::vector<NavigationGeometryInfo>& geometryList, const IntVector2& from, const IntVector2& to)
 {
+    auto* workQueue = GetSubsystem<WorkQueue>();
+
+    // Build tiles in batches to limit memory used by collected geometry
+    ea::vector<ea::unique_ptr<NavBuildData>> builds;
     unsigned numTiles = 0;
+    const auto buildBatch = [&]()
+    {
+        const auto buildTiles = [&](unsigned beginIndex, unsigned endIndex)
+        {
+            for (unsigned i = beginIndex; i < endIndex; ++i)
+                builds[i]->BuildTileData();
+        };
+
+        if (workQueue)
+            workQueue->ParallelFor(builds.size(), 1, buildTiles);
+        else
+            buildTiles(0, builds.size());
+
+        for (const auto& build : builds)
+            numTiles += CommitTileBuild(*build);
+        builds.clear();
+    };
+
+    for (const IntVector2& tileIndex : IntRect{from, to + IntVector2::ONE})
+    {
+        // Tiles being built asynchronously may contain outdated geometry, rebuild them again when finished
+        if (tilesInProgress_.contains(tileIndex))
+            dirtyTiles_.insert(tileIndex);
+        else
+            dirtyTiles_.erase(tileIndex);
+
+        builds.push_back(CreateTileBuildData());
+        PrepareTileBuild(*builds.back(), geometryList, tileIndex);
+
+        if (builds.size() >= MAX_TILE_BUILD_BATCH)
+            buildBatch();
+    }
+    buildBatch();
+
+    return numTiles;
+}
+
+void NavigationMesh::MarkRegionDirty(const BoundingBox& boundingBox)
+{
+    MarkTilesDirty(GetTileIndex(boundingBox.min_), GetTileIndex(boundingBox.max_));
+}
+
+void NavigationMesh::MarkTilesDirty(const IntVector2& from, const IntVector2& to)
+{
+    for (const IntVector2& tileIndex : IntRect{from, to + IntVector2::ONE})
+        dirtyTiles_.insert(tileIndex);
+}
+
+void NavigationMesh::BuildDirtyTilesAsync()
+{
+    if (dirtyTiles_.empty() || !node_)
+        return;
+
+    if (!navMesh_)
+    {
+        URHO3D_LOGERROR("Navigation mesh must first be built or allocated before it can be partially rebuilt");
+        return;
+    }
+
+    URHO3D_PROFILE("StartNavigationMeshTileBuild");
+
+    ea::vector<NavigationGeometryInfo> geometryList;
+    CollectGeometries(geometryList);
+
+    auto* workQueue = GetSubsystem<WorkQueue>();
+    const WeakPtr<NavigationMesh> weakSelf{this};
+    const unsigned buildGeneration = buildGeneration_;
 
-    for (int z = from.y_; z <= to.y_; ++z)
+    for (auto iter = dirtyTiles_.begin(); iter != dirtyTiles_.end();)
     {
-        for (int x = from.x_; x <= to.x_; ++x)
+        // Tile will be rebuilt again when current build is finished
+        const IntVector2 tileIndex = *iter;
+        if (tilesInProgress_.contains(tileIndex))
         {
-            if (BuildTile(geometryList, x, z))
-                ++numTiles;
+            ++iter;
+            continue;
         }
+
+        iter = dirtyTiles_.erase(iter);
+        tilesInProgress_.insert(tileIndex);
+
+        ea::shared_ptr<NavBuildData> build{CreateTileBuildData()};
+        PrepareTileBuild(*build, geometryList, tileIndex);
+
+        workQueue->PostTask([weakSelf, build, buildGeneration](unsigned /*threadIndex*/, WorkQueue* queue) mutable
+        {
+            build->BuildTileData();
+            queue->PostTaskForMainThread([weakSelf = ea::move(weakSelf), build = ea::move(build), buildGeneration]
+            {
+                if (const auto self = weakSelf.Lock())
+                    self->FinishAsyncTileBuild(*build, buildGeneration);
+            });
+        }, TaskPriority::Low);
     }
-    return numTiles;
+}
+
+void NavigationMesh::FinishAsyncTileBuild(NavBuildData& build, unsigned buildGeneration)
+{
+    if (buildGeneration != buildGeneration_ || !navMesh_)
+        return;
+
+    tilesInProgress_.erase(build.tileIndex_);
+    const unsigned numTiles = CommitTileBuild(build);
+    URHO3D_LOGDEBUG("Rebuilt {} tiles of the navigation mesh asynchronously", numTiles);
+
+    SendTileAddedEvent(build.tileIndex_);
+}
+
+void NavigationMesh::OnSceneSet(Scene* previousScene, Scene* scene)
+{
+    if (scene)
+        SubscribeToEvent(scene, E_SCENESUBSYSTEMUPDATE, URHO3D_HANDLER(NavigationMesh, HandleSceneSubsystemUpdate));
+    else
+        UnsubscribeFromEvent(E_SCENESUBSYSTEMUPDATE);
+}
+
+void NavigationMesh::HandleSceneSubsystemUpdate(StringHash eventType, VariantMap& eventData)
+{
+    if (!dirtyTiles_.empty() && navMesh_ && IsEnabledEffective())
+        BuildDirtyTilesAsync();
+
+    ProcessPathRequests();
+}
+
+void NavigationMesh::InvalidatePathRequests()
+{
+    pathQueue_->Invalidate();
 }
 
 bool NavigationMesh::InitializeQuery()
@@ -1564,6 +1839,14 @@ bool NavigationMesh::InitializeQuery()
 
 void NavigationMesh::ReleaseNavigationMesh()
 {
+    // Discard pending asynchronous builds, they refer to the old navigation mesh
+    ++buildGeneration_;
+    dirtyTiles_.clear();
+    tilesInProgress_.clear();
+
+    // Path requests are restarted when new navigation mesh is ready
+    pathQueue_->SetNavigationMesh(nullptr);
+
     dtFreeNavMesh(navMesh_);
     navMesh_ = nullptr;
 
@@ -28,7 +28,9 @@
 #include "Urho3D/Navigation/NavigationDefs.h"
 #include "Urho3D/Scene/Component.h"
 
+#include <EASTL/functional.h>
 #include <EASTL/unique_ptr.h>
+#include <EASTL/unordered_map.h>
 #include <EASTL/unordered_set.h>
 
 class dtNavMesh;
@@ -47,6 +49,7 @@ enum NavmeshPartitionType
 class Geometry;
 class NavArea;
 class Navigable;
+class NavigationPathQueue;
 
 struct FindPathData;
 struct NavBuildData;
@@ -71,6 +74,9 @@ struct URHO3D_API NavigationPathPoint
     unsigned char areaID_;
 };
 
+/// Callback invoked when asynchronous path request is completed. Path is empty if it was not found.
+using NavigationPathCallback = ea::function<void(const ea::vector<NavigationPathPoint>& path)>;
+
 /// Navigation mesh component. Collects the navigation geometry from child nodes with the Navigable component and responds to path queries.
 class URHO3D_API NavigationMesh : public Component
 {
@@ -157,6 +163,19 @@ public:
     /// Rebuild the navigation mesh allocating sufficient maximum number of tiles. Return true if successful.
     bool Rebuild();
 
+    /// Mark tiles in the bounding box for asynchronous rebuild, e.g. when static geometry was moved.
+    /// Both old and new bounding boxes of the moved geometry should be marked.
+    void MarkRegionDirty(const BoundingBox& boundingBox);
+    /// Mark tiles in the rectangular area for asynchronous rebuild.
+    void MarkTilesDirty(const IntVector2& from, const IntVector2& to);
+    /// Start asynchronous rebuild of dirty tiles. Called automatically on scene update.
+    /// Geometry is collected immediately, tiles are built on WorkQueue threads and added to the mesh on the main thread.
+    void BuildDirtyTilesAsync();
+    /// Return number of tiles waiting for asynchronous rebuild.
+    unsigned GetNumDirtyTiles() const { return dirtyTiles_.size(); }
+    /// Return whether there are dirty tiles or tiles being built asynchronously.
+    bool IsBuildingTiles() const { return !dirtyTiles_.empty() || !tilesInProgress_.empty(); }
+
     /// Enumerate all tiles.
     ea::vector<IntVector2> GetAllTileIndices() const;
     /// Return tile data.
@@ -186,6 +205,16 @@ public:
     void FindPath
         (ea::vector<NavigationPathPoint>& dest, const Vector3& start, const Vector3& end, const Vector3& extents = Vector3::ONE,
             const dtQueryFilter* filter = nullptr);
+    /// Request a path between world space points asynchronously. The path is searched on WorkQueue threads during scene update,
+    /// total number of search iterations per update is limited. The callback is invoked on the main thread with the same path as FindPath would return,
+    /// except that the path may be taken from the cache of recent paths between the same polygons.
+    /// Query filter should stay alive until the request is completed. Return request ID, or 0 if the navigation mesh is not initialized.
+    unsigned FindPathAsync(const Vector3& start, const Vector3& end, const NavigationPathCallback& callback,
+        const Vector3& extents = Vector3::ONE, const dtQueryFilter* filter = nullptr);
+    /// Cancel asynchronous path request without invoking the callback. Return true if the request was pending.
+    bool CancelPathRequest(unsigned requestId);
+    /// Update asynchronous path requests and invoke callbacks of completed ones. Called automatically on scene update.
+    void ProcessPathRequests();
     /// Return a random point on the navigation mesh.
     Vector3 GetRandomPoint(const dtQueryFilter* filter = nullptr, dtPolyRef* randomRef = nullptr);
     /// Return a random point on the navigation mesh within a circle. The circle radius is only a guideline and in practice the returned point may be further away.
@@ -274,6 +303,21 @@ public:
     /// @property
     const Vector3& GetPadding() const { return padding_; }
 
+    /// Set maximum total number of pathfinding iterations per update of asynchronous path requests.
+    /// @property
+    void SetPathIterationBudget(unsigned budget) { pathIterationBudget_ = Max(budget, 1U); }
+    /// Return maximum total number of pathfinding iterations per update of asynchronous path requests.
+    /// @property
+    unsigned GetPathIterationBudget() const { return pathIterationBudget_; }
+    /// Set maximum number of cached paths for asynchronous path requests. Zero disables the cache.
+    /// @property
+    void SetPathCacheSize(unsigned size);
+    /// Return maximum number of cached paths for asynchronous path requests.
+    /// @property
+    unsigned GetPathCacheSize() const;
+    /// Return number of asynchronous path requests waiting for completion.
+    unsigned GetNumPendingPathRequests() const;
+
     /// Get the current cost of an area.
     float GetAreaCost(unsigned areaID) const;
 
@@ -313,8 +357,18 @@ public:
 private:
     /// Read tile data to the navigation mesh.
     bool ReadTile(Deserializer& source, bool silent);
+    /// Find straight path along the corridor of polygons and append it to the destination in world space.
+    void FindStraightPath(ea::vector<NavigationPathPoint>& dest, const Vector3& localStart, const Vector3& localEnd,
+        const dtPolyRef* polys, int numPolys, dtPolyRef endRef);
 
 protected:
+    /// Handle node being assigned to the scene.
+    void OnSceneSet(Scene* previousScene, Scene* scene) override;
+    /// Start asynchronous rebuild of dirty tiles and update asynchronous path requests.
+    void HandleSceneSubsystemUpdate(StringHash eventType, VariantMap& eventData);
+    /// Discard cached paths that may be affected by tile changes. Should be called whenever tiles are changed.
+    void InvalidatePathRequests();
+
     /// Allocate the navigation mesh without building any tiles. Return true if successful.
     virtual bool AllocateMesh(unsigned maxTiles);
     /// Rebuild the navigation mesh allocating sufficient maximum number of tiles. Return true if successful.
@@ -336,8 +390,17 @@ protected:
     void GetTileGeometry(NavBuildData* build, const ea::vector<NavigationGeometryInfo>& geometryList, BoundingBox& box);
     /// Add a triangle mesh to the geometry data.
     void AddTriMeshGeometry(NavBuildData* build, Geometry* geometry, const Matrix3x4& transform, unsigned char areaId);
-    /// Build one tile of the navigation mesh. Return true if successful.
-    bool BuildTile(ea::vector<NavigationGeometryInfo>& geometryList, int x, int z);
+    /// Create build data for one tile.
+    virtual ea::unique_ptr<NavBuildData> CreateTileBuildData();
+    /// Fill tile build data with the build configuration and the tile geometry. Should be called from main thread.
+    void PrepareTileBuild(NavBuildData& build, const ea::vector<NavigationGeometryInfo>& geometryList,
+        const IntVector2& tileIndex);
+    /// Replace tile in the navigation mesh with the built tile data. Return number of added tiles.
+    virtual unsigned CommitTileBuild(NavBuildData& build);
+    /// Add asynchronously built tile to the navigation mesh unless the mesh was released since.
+    void FinishAsyncTileBuild(NavBuildData& build, unsigned buildGeneration);
+    /// Send area rebuilt event.
+    void SendAreaRebuiltEvent(const BoundingBox& boundingBox);
     /// Ensure that the navigation mesh query is initialized. Return true if successful.
     bool InitializeQuery();
     /// Release the navigation mesh and the query.
@@ -356,6 +419,12 @@ protected:
     ea::unique_ptr<dtQueryFilter> queryFilter_;
     /// Temporary data for finding a path.
     ea::unique_ptr<FindPathData> pathData_;
+    /// Queue of asynchronous path requests.
+    ea::unique_ptr<NavigationPathQueue> pathQueue_;
+    /// Callbacks of asynchronous path requests.
+    ea::unordered_map<unsigned, NavigationPathCallback> pathCallbacks_;
+    /// ID of the next asynchronous path request.
+    unsigned nextPathRequestId_{1};
     /// Maximum number of tiles.
     int maxTiles_{DefaultMaxTiles};
     /// Tile size.
@@ -396,8 +465,16 @@ protected:
     bool drawOffMeshConnections_;
     /// Debug draw NavArea components.
     bool drawNavAreas_;
+    /// Maximum total number of pathfinding iterations per update.
+    unsigned pathIterationBudget_{};
     /// NavAreas for this NavMesh.
     ea::vector<WeakPtr<NavArea> > areas_;
+    /// Tiles waiting for asynchronous rebuild.
+    ea::hash_set<IntVector2> dirtyTiles_;
+    /// Tiles that are being built asynchronously.
+    ea::hash_set<IntVector2> tilesInProgress_;
+    /// Incremented when the navigation mesh is released, so stale asynchronous builds are discarded.
+    unsigned buildGeneration_{};
 };
 
 /// Register Navigation library objects.
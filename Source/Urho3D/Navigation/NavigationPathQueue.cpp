@@ -0,0 +1,371 @@
+//
+// Copyright (c) 2025-2025 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../Core/Profiler.h"
+#include "../Core/WorkQueue.h"
+#include "../IO/Log.h"
+#include "../Navigation/NavigationPathQueue.h"
+
+#include <Detour/DetourNavMeshQuery.h>
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+NavigationPathQueue::NavigationPathQueue(unsigned maxNodes, unsigned maxPathLength)
+    : maxNodes_(maxNodes)
+    , maxPathLength_(maxPathLength)
+    , slots_(1)
+{
+}
+
+NavigationPathQueue::~NavigationPathQueue()
+{
+    ReleaseQueries();
+}
+
+void NavigationPathQueue::SetNavigationMesh(dtNavMesh* navMesh)
+{
+    // Queries are bound to the navigation mesh, they are recreated on demand
+    navMesh_ = navMesh;
+    ReleaseQueries();
+    Reset();
+}
+
+void NavigationPathQueue::Invalidate()
+{
+    // Corridors through changed tiles are rejected on validation, only partial corridors may become complete
+    const unsigned oldCacheSize = cache_.size();
+    ea::erase_if(cache_, [](const auto& item) { return item.second.partial_; });
+    if (cache_.size() != oldCacheSize)
+    {
+        const auto isErased = [this](const CacheKey& key) { return cache_.find(key) == cache_.end(); };
+        ea::erase_if(cacheOrder_, isErased);
+    }
+}
+
+void NavigationPathQueue::Reset()
+{
+    cache_.clear();
+    cacheOrder_.clear();
+
+    // Polygons found so far may be gone, search again from scratch
+    for (Slot& slot : slots_)
+    {
+        if (!slot.busy_)
+            continue;
+
+        NavigationPathRequest& request = slot.request_;
+        request.startRef_ = 0;
+        request.endRef_ = 0;
+        request.polys_.clear();
+        request.partial_ = false;
+        request.cached_ = false;
+        slot.started_ = false;
+        slot.finished_ = false;
+        slot.numRestarts_ = 0;
+    }
+}
+
+void NavigationPathQueue::Enqueue(const NavigationPathRequest& request)
+{
+    pendingRequests_.push_back(request);
+}
+
+bool NavigationPathQueue::Cancel(unsigned id)
+{
+    for (Slot& slot : slots_)
+    {
+        if (slot.busy_ && slot.request_.id_ == id)
+        {
+            slot.busy_ = false;
+            --numBusySlots_;
+            return true;
+        }
+    }
+
+    const auto iter = ea::find_if(pendingRequests_.begin(), pendingRequests_.end(),
+        [&](const NavigationPathRequest& request) { return request.id_ == id; });
+    if (iter == pendingRequests_.end())
+        return false;
+
+    pendingRequests_.erase(iter);
+    return true;
+}
+
+void NavigationPathQueue::CancelAll(ea::vector<NavigationPathRequest>& cancelledRequests)
+{
+    for (Slot& slot : slots_)
+    {
+        if (!slot.busy_)
+            continue;
+
+        slot.request_.polys_.clear();
+        cancelledRequests.push_back(ea::move(slot.request_));
+        slot.busy_ = false;
+    }
+    numBusySlots_ = 0;
+
+    for (NavigationPathRequest& request : pendingRequests_)
+        cancelledRequests.push_back(ea::move(request));
+    pendingRequests_.clear();
+}
+
+void NavigationPathQueue::Update(
+    WorkQueue* workQueue, unsigned maxIterations, ea::vector<NavigationPathRequest>& completedRequests)
+{
+    URHO3D_PROFILE("UpdateNavigationPathQueue");
+
+    // Assign queued requests to free queries
+    for (Slot& slot : slots_)
+    {
+        if (pendingRequests_.empty())
+            break;
+        if (slot.busy_)
+            continue;
+
+        slot.request_ = ea::move(pendingRequests_.front());
+        pendingRequests_.pop_front();
+        slot.busy_ = true;
+        slot.started_ = false;
+        slot.finished_ = false;
+        slot.numRestarts_ = 0;
+        ++numBusySlots_;
+    }
+
+    if (numBusySlots_ == 0)
+        return;
+
+    // Allocate queries on the main thread, fail requests if it's impossible
+    busySlots_.clear();
+    for (Slot& slot : slots_)
+    {
+        if (!slot.busy_)
+            continue;
+
+        if (!slot.query_ && navMesh_)
+        {
+            slot.query_ = dtAllocNavMeshQuery();
+            if (slot.query_ && dtStatusFailed(slot.query_->init(navMesh_, maxNodes_)))
+            {
+                dtFreeNavMeshQuery(slot.query_);
+                slot.query_ = nullptr;
+            }
+            if (!slot.query_)
+                URHO3D_LOGERROR("Could not create navigation mesh query for path request");
+        }
+
+        if (slot.query_)
+            busySlots_.push_back(&slot);
+        else
+            slot.finished_ = true;
+    }
+
+    // Each query is touched by one thread only, navigation mesh and cache are read-only
+    const unsigned numSlots = busySlots_.size();
+    const unsigned slotIterations = ea::max(1u, maxIterations / ea::max(1u, numSlots));
+    const auto updateSlots = [&](unsigned beginIndex, unsigned endIndex)
+    {
+        for (unsigned i = beginIndex; i < endIndex; ++i)
+            UpdateSlot(*busySlots_[i], slotIterations);
+    };
+
+    if (workQueue && numSlots > 1)
+        workQueue->ParallelFor(numSlots, 1, updateSlots);
+    else
+        updateSlots(0, numSlots);
+
+    // Deliver results in the order of queries
+    for (Slot& slot : slots_)
+    {
+        if (!slot.busy_ || !slot.finished_)
+            continue;
+
+        if (!slot.request_.cached_ && !slot.request_.polys_.empty())
+            StoreInCache(slot.request_);
+
+        completedRequests.push_back(ea::move(slot.request_));
+        slot.busy_ = false;
+        --numBusySlots_;
+    }
+}
+
+void NavigationPathQueue::UpdateSlot(Slot& slot, unsigned maxIterations)
+{
+    dtNavMeshQuery* query = slot.query_;
+    NavigationPathRequest& request = slot.request_;
+
+    if (!slot.started_)
+    {
+        slot.started_ = true;
+
+        query->findNearestPoly(&request.start_.x_, &request.extents_.x_, request.filter_, &request.startRef_, nullptr);
+        query->findNearestPoly(&request.end_.x_, &request.extents_.x_, request.filter_, &request.endRef_, nullptr);
+        if (!request.startRef_ || !request.endRef_)
+        {
+            slot.finished_ = true;
+            return;
+        }
+
+        if (FetchFromCache(request))
+        {
+            slot.finished_ = true;
+            return;
+        }
+
+        // Navigation mesh may change every update, so don't slice the search again if it was broken once
+        if (slot.numRestarts_ > 0)
+        {
+            int numPolys = 0;
+            request.polys_.resize(maxPathLength_);
+            const dtStatus status = query->findPath(request.startRef_, request.endRef_, &request.start_.x_,
+                &request.end_.x_, request.filter_, request.polys_.data(), &numPolys, static_cast<int>(maxPathLength_));
+            slot.finished_ = true;
+            request.polys_.resize(dtStatusSucceed(status) ? numPolys : 0);
+            request.partial_ = !request.polys_.empty() && request.polys_.back() != request.endRef_;
+            return;
+        }
+
+        const dtStatus status = query->initSlicedFindPath(
+            request.startRef_, request.endRef_, &request.start_.x_, &request.end_.x_, request.filter_);
+        if (dtStatusFailed(status))
+        {
+            slot.finished_ = true;
+            return;
+        }
+    }
+
+    dtStatus status = query->updateSlicedFindPath(static_cast<int>(maxIterations), nullptr);
+    if (dtStatusInProgress(status))
+        return;
+
+    int numPolys = 0;
+    if (dtStatusSucceed(status))
+    {
+        request.polys_.resize(maxPathLength_);
+        status = query->finalizeSlicedFindPath(request.polys_.data(), &numPolys, static_cast<int>(maxPathLength_));
+    }
+
+    // Sliced search fails if polygons disappear during the search, and found corridor may contain removed polygons
+    request.polys_.resize(dtStatusSucceed(status) ? numPolys : 0);
+    if (slot.numRestarts_ == 0 && (request.polys_.empty() || !IsCorridorValid(request.polys_)))
+    {
+        request.polys_.clear();
+        slot.started_ = false;
+        ++slot.numRestarts_;
+        return;
+    }
+
+    slot.finished_ = true;
+    request.partial_ = !request.polys_.empty() && request.polys_.back() != request.endRef_;
+}
+
+bool NavigationPathQueue::IsCorridorValid(const ea::vector<dtPolyRef>& polys) const
+{
+    for (const dtPolyRef ref : polys)
+    {
+        if (!navMesh_->isValidPolyRef(ref))
+            return false;
+    }
+    return true;
+}
+
+bool NavigationPathQueue::FetchFromCache(NavigationPathRequest& request) const
+{
+    const auto iter = cache_.find(CacheKey{request.startRef_, request.endRef_, request.filter_});
+    if (iter == cache_.end() || !IsCorridorValid(iter->second.polys_))
+        return false;
+
+    request.polys_ = iter->second.polys_;
+    request.partial_ = iter->second.partial_;
+    request.cached_ = true;
+    return true;
+}
+
+void NavigationPathQueue::StoreInCache(const NavigationPathRequest& request)
+{
+    if (maxCacheSize_ == 0)
+        return;
+
+    const CacheKey key{request.startRef_, request.endRef_, request.filter_};
+    const auto [iter, inserted] = cache_.emplace(key, CacheEntry{});
+    iter->second.polys_ = request.polys_;
+    iter->second.partial_ = request.partial_;
+    if (!inserted)
+        return;
+
+    cacheOrder_.push_back(key);
+    while (cacheOrder_.size() > maxCacheSize_)
+    {
+        cache_.erase(cacheOrder_.front());
+        cacheOrder_.pop_front();
+    }
+}
+
+void NavigationPathQueue::SetMaxConcurrentRequests(unsigned count)
+{
+    count = ea::max(1u, count);
+    if (count == slots_.size())
+        return;
+
+    // Requests in removed slots are started again later, keep their order
+    for (unsigned i = slots_.size(); i-- > count;)
+    {
+        Slot& slot = slots_[i];
+        if (slot.busy_)
+        {
+            NavigationPathRequest& request = slot.request_;
+            request.polys_.clear();
+            request.partial_ = false;
+            request.cached_ = false;
+            pendingRequests_.push_front(ea::move(request));
+            --numBusySlots_;
+        }
+        dtFreeNavMeshQuery(slot.query_);
+    }
+
+    slots_.resize(count);
+}
+
+void NavigationPathQueue::SetMaxCacheSize(unsigned size)
+{
+    maxCacheSize_ = size;
+    while (cacheOrder_.size() > maxCacheSize_)
+    {
+        cache_.erase(cacheOrder_.front());
+        cacheOrder_.pop_front();
+    }
+}
+
+void NavigationPathQueue::ReleaseQueries()
+{
+    for (Slot& slot : slots_)
+    {
+        dtFreeNavMeshQuery(slot.query_);
+        slot.query_ = nullptr;
+    }
+}
+
+}
@@ -0,0 +1,196 @@
+//
+// Copyright (c) 2025-2025 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "Urho3D/Container/Hash.h"
+#include "Urho3D/Core/NonCopyable.h"
+#include "Urho3D/Math/Vector3.h"
+#include "Urho3D/Navigation/NavigationDefs.h"
+
+#include <EASTL/deque.h>
+#include <EASTL/unordered_map.h>
+#include <EASTL/vector.h>
+
+class dtNavMesh;
+class dtNavMeshQuery;
+class dtQueryFilter;
+
+namespace Urho3D
+{
+
+class WorkQueue;
+
+/// Asynchronous path request. Positions are in the local space of the navigation mesh.
+struct NavigationPathRequest
+{
+    /// Unique ID of the request, never zero.
+    unsigned id_{};
+    /// Start position.
+    Vector3 start_;
+    /// End position.
+    Vector3 end_;
+    /// How far off the navigation mesh the start and end positions can be.
+    Vector3 extents_{Vector3::ONE};
+    /// Query filter. Should stay alive until the request is completed.
+    const dtQueryFilter* filter_{};
+
+    /// Polygon nearest to the start position. Zero if not found.
+    dtPolyRef startRef_{};
+    /// Polygon nearest to the end position. Zero if not found.
+    dtPolyRef endRef_{};
+    /// Found corridor of polygons. Empty if the path was not found.
+    ea::vector<dtPolyRef> polys_;
+    /// Whether the corridor doesn't reach the end polygon.
+    bool partial_{};
+    /// Whether the corridor was taken from the cache.
+    bool cached_{};
+};
+
+/// Queue of asynchronous path requests.
+/// Requests are searched with sliced A* in several Detour queries that are updated in parallel,
+/// each query owns one request until it is completed. Total number of A* iterations per update is limited.
+/// Found corridors are cached by start polygon, end polygon and filter.
+/// Changes of navigation mesh tiles don't restart requests in progress: corridors are validated when found or taken from the cache,
+/// and the search that was broken by the change is repeated once without slicing.
+class URHO3D_API NavigationPathQueue : public NonCopyable
+{
+public:
+    /// Construct. Node pool size and maximum path length are the same for all queries.
+    NavigationPathQueue(unsigned maxNodes, unsigned maxPathLength);
+    /// Destruct.
+    ~NavigationPathQueue();
+
+    /// Set navigation mesh. Requests in progress are restarted and the cache is cleared.
+    void SetNavigationMesh(dtNavMesh* navMesh);
+    /// Discard cached corridors that may be affected by tile changes. Should be called whenever tiles are added or removed.
+    void Invalidate();
+    /// Add request to the end of the queue.
+    void Enqueue(const NavigationPathRequest& request);
+    /// Remove request from the queue. Return true if the request was found.
+    bool Cancel(unsigned id);
+    /// Remove all requests and append them to the output without paths.
+    void CancelAll(ea::vector<NavigationPathRequest>& cancelledRequests);
+    /// Update requests in progress within the budget of A* iterations and append completed requests to the output.
+    /// Queries are updated in parallel if the work queue is provided.
+    void Update(WorkQueue* workQueue, unsigned maxIterations, ea::vector<NavigationPathRequest>& completedRequests);
+
+    /// Set maximum number of requests in progress. Should not be less than number of WorkQueue threads.
+    void SetMaxConcurrentRequests(unsigned count);
+    /// Set maximum number of cached corridors. Oldest corridors are discarded first. Zero disables the cache.
+    void SetMaxCacheSize(unsigned size);
+
+    /// Return navigation mesh.
+    dtNavMesh* GetNavigationMesh() const { return navMesh_; }
+    /// Return maximum number of requests in progress.
+    unsigned GetMaxConcurrentRequests() const { return slots_.size(); }
+    /// Return maximum number of cached corridors.
+    unsigned GetMaxCacheSize() const { return maxCacheSize_; }
+    /// Return number of queued requests and requests in progress.
+    unsigned GetNumRequests() const { return pendingRequests_.size() + numBusySlots_; }
+    /// Return number of cached corridors.
+    unsigned GetNumCachedPaths() const { return cache_.size(); }
+
+private:
+    /// Query owning one request in progress.
+    struct Slot
+    {
+        /// Detour query used for sliced search.
+        dtNavMeshQuery* query_{};
+        /// Request in progress.
+        NavigationPathRequest request_;
+        /// Whether the slot has a request.
+        bool busy_{};
+        /// Whether the sliced search has started.
+        bool started_{};
+        /// Whether the search is finished.
+        bool finished_{};
+        /// Number of searches broken by navigation mesh changes.
+        unsigned numRestarts_{};
+    };
+
+    /// Key of cached corridor.
+    struct CacheKey
+    {
+        dtPolyRef startRef_{};
+        dtPolyRef endRef_{};
+        const dtQueryFilter* filter_{};
+
+        bool operator==(const CacheKey& rhs) const
+        {
+            return startRef_ == rhs.startRef_ && endRef_ == rhs.endRef_ && filter_ == rhs.filter_;
+        }
+
+        unsigned ToHash() const
+        {
+            unsigned hash = 0;
+            CombineHash(hash, MakeHash(startRef_));
+            CombineHash(hash, MakeHash(endRef_));
+            CombineHash(hash, MakeHash(filter_));
+            return hash;
+        }
+    };
+
+    /// Cached corridor.
+    struct CacheEntry
+    {
+        ea::vector<dtPolyRef> polys_;
+        bool partial_{};
+    };
+
+    /// Update sliced search in the slot.
+    void UpdateSlot(Slot& slot, unsigned maxIterations);
+    /// Return whether all polygons of the corridor still exist.
+    bool IsCorridorValid(const ea::vector<dtPolyRef>& polys) const;
+    /// Restart requests in progress and clear the cache.
+    void Reset();
+    /// Try to complete request from the cache. Return true if successful.
+    bool FetchFromCache(NavigationPathRequest& request) const;
+    /// Store found corridor in the cache.
+    void StoreInCache(const NavigationPathRequest& request);
+    /// Release all queries.
+    void ReleaseQueries();
+
+    /// Navigation mesh.
+    dtNavMesh* navMesh_{};
+    /// Node pool size of each query.
+    unsigned maxNodes_{};
+    /// Maximum number of polygons in found corridor.
+    unsigned maxPathLength_{};
+    /// Queries and requests in progress.
+    ea::vector<Slot> slots_;
+    /// Number of slots with requests.
+    unsigned numBusySlots_{};
+    /// Slots updated during current update.
+    ea::vector<Slot*> busySlots_;
+    /// Requests waiting for free query.
+    ea::deque<NavigationPathRequest> pendingRequests_;
+
+    /// Maximum number of cached corridors.
+    unsigned maxCacheSize_{};
+    /// Cached corridors.
+    ea::unordered_map<CacheKey, CacheEntry> cache_;
+    /// Cached corridors from oldest to newest.
+    ea::deque<CacheKey> cacheOrder_;
+};
+
+}
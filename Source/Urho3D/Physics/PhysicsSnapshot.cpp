@@ -0,0 +1,109 @@
+//
+// Copyright (c) 2025-2025 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../Physics/PhysicsSnapshot.h"
+
+#include <Bullet/BulletCollision/NarrowPhaseCollision/btManifoldPoint.h>
+
+#include <EASTL/sort.h>
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+void PhysicsSnapshot::Clear()
+{
+    bodies_.clear();
+    manifolds_.clear();
+    contactPoints_.clear();
+    hasContacts_ = false;
+}
+
+unsigned PhysicsSnapshot::GetDataSize() const
+{
+    return bodies_.size() * sizeof(PhysicsBodySnapshot) + manifolds_.size() * sizeof(PhysicsManifoldSnapshot)
+        + contactPoints_.size();
+}
+
+const PhysicsManifoldSnapshot* PhysicsSnapshot::FindManifold(unsigned componentId0, unsigned componentId1) const
+{
+    const auto iter = ea::lower_bound(manifolds_.begin(), manifolds_.end(), ea::make_pair(componentId0, componentId1),
+        [](const PhysicsManifoldSnapshot& lhs, const ea::pair<unsigned, unsigned>& rhs)
+    { return ea::tie(lhs.componentId0_, lhs.componentId1_) < ea::tie(rhs.first, rhs.second); });
+
+    if (iter == manifolds_.end() || iter->componentId0_ != componentId0 || iter->componentId1_ != componentId1)
+        return nullptr;
+    return iter;
+}
+
+PhysicsSnapshotBuffer::PhysicsSnapshotBuffer(unsigned capacity)
+{
+    SetCapacity(capacity);
+}
+
+void PhysicsSnapshotBuffer::SetCapacity(unsigned capacity)
+{
+    slots_.clear();
+    slots_.resize(ea::max(capacity, 1u));
+}
+
+PhysicsSnapshot& PhysicsSnapshotBuffer::Allocate(NetworkFrame frame)
+{
+    Slot& slot = slots_[FrameToIndex(frame)];
+    slot.frame_ = frame;
+    slot.valid_ = true;
+    slot.snapshot_.Clear();
+    return slot.snapshot_;
+}
+
+const PhysicsSnapshot* PhysicsSnapshotBuffer::Find(NetworkFrame frame) const
+{
+    const Slot& slot = slots_[FrameToIndex(frame)];
+    return slot.valid_ && slot.frame_ == frame ? &slot.snapshot_ : nullptr;
+}
+
+void PhysicsSnapshotBuffer::DiscardFrom(NetworkFrame frame)
+{
+    for (Slot& slot : slots_)
+    {
+        if (slot.frame_ >= frame)
+            slot.valid_ = false;
+    }
+}
+
+void PhysicsSnapshotBuffer::Clear()
+{
+    for (Slot& slot : slots_)
+        slot.valid_ = false;
+}
+
+unsigned PhysicsSnapshotBuffer::FrameToIndex(NetworkFrame frame) const
+{
+    const auto capacity = static_cast<long long>(slots_.size());
+    const auto index = static_cast<long long>(frame) % capacity;
+    return static_cast<unsigned>(index < 0 ? index + capacity : index);
+}
+
+} // namespace Urho3D
@@ -0,0 +1,143 @@
+//
+// Copyright (c) 2025-2025 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "Urho3D/Math/Matrix3x4.h"
+#include "Urho3D/Math/Vector3.h"
+#include "Urho3D/Replica/NetworkId.h"
+
+#include <EASTL/vector.h>
+
+namespace Urho3D
+{
+
+/// Simulation state of one rigid body in PhysicsSnapshot.
+/// Bullet transforms are stored as matrices so that restore is exact.
+struct PhysicsBodySnapshot
+{
+    /// ID of the RigidBody component.
+    unsigned componentId_{};
+    /// Bullet activation state.
+    int activationState_{};
+    /// Time the body spent below sleeping thresholds.
+    float deactivationTime_{};
+    /// World transform of the Bullet body, including center of mass offset.
+    Matrix3x4 worldTransform_;
+    /// Interpolation world transform of the Bullet body.
+    Matrix3x4 interpolationWorldTransform_;
+    /// Linear velocity.
+    Vector3 linearVelocity_;
+    /// Angular velocity.
+    Vector3 angularVelocity_;
+    /// Interpolation linear velocity.
+    Vector3 interpolationLinearVelocity_;
+    /// Interpolation angular velocity.
+    Vector3 interpolationAngularVelocity_;
+};
+
+/// Contact manifold between two rigid bodies in PhysicsSnapshot.
+struct PhysicsManifoldSnapshot
+{
+    /// ID of the first RigidBody component in the manifold.
+    unsigned componentId0_{};
+    /// ID of the second RigidBody component in the manifold.
+    unsigned componentId1_{};
+    /// Index of the first contact point.
+    unsigned firstPoint_{};
+    /// Number of contact points.
+    unsigned numPoints_{};
+};
+
+/// Simulation state of all rigid bodies in PhysicsWorld, used for rollback and resimulation.
+/// Memory is kept between captures, so capture and restore don't allocate once the snapshot is warmed up.
+class URHO3D_API PhysicsSnapshot
+{
+    friend class PhysicsWorld;
+
+public:
+    /// Remove stored state. Memory is kept for reuse.
+    void Clear();
+
+    /// Return rigid body states.
+    const ea::vector<PhysicsBodySnapshot>& GetBodies() const { return bodies_; }
+    /// Return contact manifolds. Empty unless contacts were captured.
+    const ea::vector<PhysicsManifoldSnapshot>& GetManifolds() const { return manifolds_; }
+    /// Return whether contact cache was captured.
+    bool HasContacts() const { return hasContacts_; }
+    /// Return size of stored state in bytes.
+    unsigned GetDataSize() const;
+
+private:
+    /// Return manifold for the pair of components, if any.
+    const PhysicsManifoldSnapshot* FindManifold(unsigned componentId0, unsigned componentId1) const;
+
+    /// Rigid body states.
+    ea::vector<PhysicsBodySnapshot> bodies_;
+    /// Contact manifolds sorted by component IDs.
+    ea::vector<PhysicsManifoldSnapshot> manifolds_;
+    /// Contact points of all manifolds, stored as raw Bullet data.
+    ea::vector<unsigned char> contactPoints_;
+    /// Whether contact cache was captured.
+    bool hasContacts_{};
+};
+
+/// Ring buffer of physics snapshots for the most recent network frames.
+class URHO3D_API PhysicsSnapshotBuffer
+{
+public:
+    /// Construct with capacity in frames.
+    explicit PhysicsSnapshotBuffer(unsigned capacity = 16);
+
+    /// Set capacity in frames. Stored snapshots are discarded.
+    void SetCapacity(unsigned capacity);
+    /// Return capacity in frames.
+    unsigned GetCapacity() const { return slots_.size(); }
+
+    /// Return snapshot to be captured for the frame. Snapshot of the frame that used the same slot is discarded.
+    PhysicsSnapshot& Allocate(NetworkFrame frame);
+    /// Return snapshot of the frame if it is still stored.
+    const PhysicsSnapshot* Find(NetworkFrame frame) const;
+    /// Discard snapshots of the frame and all later frames, e.g. before resimulation.
+    void DiscardFrom(NetworkFrame frame);
+    /// Discard all stored snapshots. Memory is kept for reuse.
+    void Clear();
+
+private:
+    /// Return slot index for the frame.
+    unsigned FrameToIndex(NetworkFrame frame) const;
+
+    struct Slot
+    {
+        /// Frame of the stored snapshot.
+        NetworkFrame frame_{};
+        /// Whether the slot contains snapshot.
+        bool valid_{};
+        /// Snapshot.
+        PhysicsSnapshot snapshot_;
+    };
+
+    /// Snapshot slots indexed by frame modulo capacity.
+    ea::vector<Slot> slots_;
+};
+
+} // namespace Urho3D
@@ -25,11 +25,13 @@
 
 #pragma once
 
+#include "../Math/Matrix3x4.h"
 #include "../Math/Quaternion.h"
 #include "../Math/Vector3.h"
 
 #include <Bullet/LinearMath/btVector3.h>
 #include <Bullet/LinearMath/btQuaternion.h>
+#include <Bullet/LinearMath/btTransform.h>
 
 namespace Urho3D
 {
@@ -54,6 +56,27 @@ inline Quaternion ToQuaternion(const btQuaternion& quaternion)
     return Quaternion(quaternion.w(), quaternion.x(), quaternion.y(), quaternion.z());
 }
 
+/// Convert Bullet transform to matrix without precision loss.
+inline Matrix3x4 ToMatrix3x4(const btTransform& transform)
+{
+    const btMatrix3x3& basis = transform.getBasis();
+    const btVector3& origin = transform.getOrigin();
+    return Matrix3x4(
+        basis[0][0], basis[0][1], basis[0][2], origin.x(),
+        basis[1][0], basis[1][1], basis[1][2], origin.y(),
+        basis[2][0], basis[2][1], basis[2][2], origin.z());
+}
+
+/// Convert matrix to Bullet transform without precision loss. Matrix should not contain scale.
+inline btTransform ToBtTransform(const Matrix3x4& matrix)
+{
+    const btMatrix3x3 basis(
+        matrix.m00_, matrix.m01_, matrix.m02_,
+        matrix.m10_, matrix.m11_, matrix.m12_,
+        matrix.m20_, matrix.m21_, matrix.m22_);
+    return btTransform(basis, btVector3(matrix.m03_, matrix.m13_, matrix.m23_));
+}
+
 inline bool HasWorldScaleChanged(const Vector3& oldWorldScale, const Vector3& newWorldScale)
 {
     Vector3 delta = newWorldScale - oldWorldScale;
@@ -22,11 +22,13 @@
 
 #include "../Precompiled.h"
 
+#include <EASTL/fixed_vector.h>
 #include <EASTL/sort.h>
 
 #include "../Core/Context.h"
 #include "../Core/Mutex.h"
 #include "../Core/Profiler.h"
+#include "../Core/WorkQueue.h"
 #include "../Graphics/DebugRenderer.h"
 #include "../Graphics/Model.h"
 #include "../IO/Log.h"
@@ -35,6 +37,7 @@
 #include "../Physics/CollisionShape.h"
 #include "../Physics/Constraint.h"
 #include "../Physics/PhysicsEvents.h"
+#include "../Physics/PhysicsSnapshot.h"
 #include "../Physics/PhysicsUtils.h"
 #include "../Physics/PhysicsWorld.h"
 #include "../Physics/TriggerAnimator.h"
@@ -51,57 +54,337 @@
 #include <Bullet/BulletCollision/Gimpact/btGImpactCollisionAlgorithm.h>
 #include <Bullet/BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolver.h>
 #include <Bullet/BulletDynamics/Dynamics/btDiscreteDynamicsWorld.h>
+#if BT_THREADSAFE
+#include <Bullet/BulletCollision/CollisionDispatch/btCollisionDispatcherMt.h>
+#include <Bullet/BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolverMt.h>
+#include <Bullet/BulletDynamics/Dynamics/btDiscreteDynamicsWorldMt.h>
+#endif
 #include <BulletCollision/CollisionDispatch/btGhostObject.h>
 
 extern ContactAddedCallback gContactAddedCallback;
 
+/// Interface of Urho3D-specific stepping of Bullet physics world.
+class btCustomDynamicsWorld
+{
+public:
+    virtual ~btCustomDynamicsWorld() = default;
+
+    virtual void customStepSimulation(unsigned clampedSimulationSteps, btScalar fixedTimeStep, btScalar overtime) = 0;
+    virtual btScalar getLocalTime() const = 0;
+};
+
+template <class T>
 ATTRIBUTE_ALIGNED16(class)
-btCustomDiscreteDynamicsWorld : public btDiscreteDynamicsWorld
+btCustomDynamicsWorldImpl : public T, public btCustomDynamicsWorld
 {
 public:
-    using btDiscreteDynamicsWorld::btDiscreteDynamicsWorld;
+    using T::T;
 
-    void customStepSimulation(unsigned clampedSimulationSteps, btScalar fixedTimeStep, btScalar overtime)
+    void customStepSimulation(unsigned clampedSimulationSteps, btScalar fixedTimeStep, btScalar overtime) override
     {
-        m_fixedTimeStep = fixedTimeStep;
-        m_localTime = 0.0f;
+        this->m_fixedTimeStep = fixedTimeStep;
+        this->m_localTime = 0.0f;
 
-        if (getDebugDrawer())
+        if (this->getDebugDrawer())
         {
-            btIDebugDraw* debugDrawer = getDebugDrawer();
+            btIDebugDraw* debugDrawer = this->getDebugDrawer();
             gDisableDeactivation = (debugDrawer->getDebugMode() & btIDebugDraw::DBG_NoDeactivation) != 0;
         }
 
         if (clampedSimulationSteps > 0)
         {
-            saveKinematicState(fixedTimeStep * clampedSimulationSteps);
+            this->saveKinematicState(fixedTimeStep * clampedSimulationSteps);
 
             for (int i = 0; i < clampedSimulationSteps; i++)
             {
                 const bool isLastStep = i + 1 == clampedSimulationSteps;
                 if (isLastStep)
-                    m_localTime = overtime;
+                    this->m_localTime = overtime;
 
                 // Urho3D: apply gravity on each substep
-                applyGravity();
+                this->applyGravity();
 
-                internalSingleStepSimulation(fixedTimeStep);
-                synchronizeMotionStates();
+                this->internalSingleStepSimulation(fixedTimeStep);
+                this->synchronizeMotionStates();
 
                 // Urho3D: clear forces on each substep
-                clearForces();
+                this->clearForces();
             }
         }
         else
         {
-            m_localTime = overtime;
-            synchronizeMotionStates();
+            this->m_localTime = overtime;
+            this->synchronizeMotionStates();
+        }
+
+        this->clearForces();
+    }
+
+    btScalar getLocalTime() const override { return this->m_localTime; }
+};
+
+using btCustomDiscreteDynamicsWorld = btCustomDynamicsWorldImpl<btDiscreteDynamicsWorld>;
+
+#if BT_THREADSAFE
+/// Bullet task scheduler that runs on WorkQueue threads.
+/// Ranges are split into chunks of fixed size regardless of the number of threads,
+/// and partial sums are accumulated in chunk order, so results don't depend on scheduling.
+class btWorkQueueTaskScheduler : public btITaskScheduler
+{
+public:
+    btWorkQueueTaskScheduler()
+        : btITaskScheduler("WorkQueue")
+    {
+    }
+
+    void setWorkQueue(Urho3D::WorkQueue* workQueue) { workQueue_ = workQueue; }
+
+    // Bullet uses per-thread storage indexed by thread index which is assigned on first use,
+    // so report the maximum to keep it valid for any WorkQueue thread.
+    int getMaxNumThreads() const override { return BT_MAX_THREAD_COUNT; }
+    int getNumThreads() const override { return BT_MAX_THREAD_COUNT; }
+    void setNumThreads(int numThreads) override {}
+
+    void parallelFor(int iBegin, int iEnd, int grainSize, const btIParallelForBody& body) override
+    {
+        grainSize = btMax(grainSize, 1);
+        const int numChunks = (iEnd - iBegin + grainSize - 1) / grainSize;
+        if (numChunks <= 1 || !workQueue_)
+        {
+            body.forLoop(iBegin, iEnd);
+            return;
+        }
+
+        workQueue_->ParallelFor(numChunks, 1, [&](unsigned beginChunk, unsigned endChunk)
+        {
+            for (unsigned chunk = beginChunk; chunk < endChunk; ++chunk)
+            {
+                const int chunkBegin = iBegin + static_cast<int>(chunk) * grainSize;
+                body.forLoop(chunkBegin, btMin(chunkBegin + grainSize, iEnd));
+            }
+        });
+    }
+
+    btScalar parallelSum(int iBegin, int iEnd, int grainSize, const btIParallelSumBody& body) override
+    {
+        grainSize = btMax(grainSize, 1);
+        const int numChunks = (iEnd - iBegin + grainSize - 1) / grainSize;
+        if (numChunks <= 1 || !workQueue_)
+            return body.sumLoop(iBegin, iEnd);
+
+        ea::fixed_vector<btScalar, 64> chunkSums(numChunks, btScalar(0));
+        workQueue_->ParallelFor(numChunks, 1, [&](unsigned beginChunk, unsigned endChunk)
+        {
+            for (unsigned chunk = beginChunk; chunk < endChunk; ++chunk)
+            {
+                const int chunkBegin = iBegin + static_cast<int>(chunk) * grainSize;
+                chunkSums[chunk] = body.sumLoop(chunkBegin, btMin(chunkBegin + grainSize, iEnd));
+            }
+        });
+
+        btScalar sum = 0;
+        for (btScalar chunkSum : chunkSums)
+            sum += chunkSum;
+        return sum;
+    }
+
+    static btWorkQueueTaskScheduler* install(Urho3D::WorkQueue* workQueue)
+    {
+        static btWorkQueueTaskScheduler taskScheduler;
+        taskScheduler.setWorkQueue(workQueue);
+        if (btGetTaskScheduler() != &taskScheduler)
+            btSetTaskScheduler(&taskScheduler);
+        return &taskScheduler;
+    }
+
+private:
+    Urho3D::WorkQueue* workQueue_{};
+};
+
+/// Multithreaded collision dispatcher with deterministic order of manifolds.
+class btDeterministicCollisionDispatcherMt : public btCollisionDispatcherMt
+{
+public:
+    using btCollisionDispatcherMt::btCollisionDispatcherMt;
+
+    void dispatchAllCollisionPairs(btOverlappingPairCache* pairCache, const btDispatcherInfo& info, btDispatcher* dispatcher) override
+    {
+        const int numOldManifolds = m_manifoldsPtr.size();
+        btCollisionDispatcherMt::dispatchAllCollisionPairs(pairCache, info, dispatcher);
+
+        // New manifolds are merged in the order of worker threads, sort them by pair of objects.
+        // Manifolds of the same pair are always created by one thread, so stable sort keeps them in order.
+        const int numManifolds = m_manifoldsPtr.size();
+        if (numManifolds - numOldManifolds <= 1)
+            return;
+
+        btPersistentManifold** manifolds = &m_manifoldsPtr[0];
+        ea::stable_sort(manifolds + numOldManifolds, manifolds + numManifolds,
+            [](const btPersistentManifold* lhs, const btPersistentManifold* rhs)
+        {
+            const auto lhsKey = ea::make_pair(getUniqueId(lhs->getBody0()), getUniqueId(lhs->getBody1()));
+            const auto rhsKey = ea::make_pair(getUniqueId(rhs->getBody0()), getUniqueId(rhs->getBody1()));
+            return lhsKey < rhsKey;
+        });
+
+        for (int i = numOldManifolds; i < numManifolds; ++i)
+            m_manifoldsPtr[i]->m_index1a = i;
+    }
+
+private:
+    static int getUniqueId(const btCollisionObject* collisionObject)
+    {
+        const btBroadphaseProxy* proxy = collisionObject->getBroadphaseHandle();
+        return proxy ? proxy->m_uniqueId : -1;
+    }
+};
+
+ATTRIBUTE_ALIGNED16(class)
+btCustomDiscreteDynamicsWorldMt : public btCustomDynamicsWorldImpl<btDiscreteDynamicsWorldMt>
+{
+public:
+    using btCustomDynamicsWorldImpl<btDiscreteDynamicsWorldMt>::btCustomDynamicsWorldImpl;
+
+protected:
+    void createPredictiveContacts(btScalar timeStep) override
+    {
+        // Parallel version appends predictive manifolds in arbitrary order, keep it sequential
+        btDiscreteDynamicsWorld::createPredictiveContacts(timeStep);
+    }
+};
+#endif
+
+/// Read-only view of btDbvtBroadphase that can be queried from multiple threads at once.
+/// btDbvtBroadphase::rayTest shares traversal stack between callers, so ray tests use own stack instead.
+class btConcurrentQueryBroadphase : public btBroadphaseInterface
+{
+public:
+    explicit btConcurrentQueryBroadphase(btDbvtBroadphase* broadphase)
+        : broadphase_(broadphase)
+    {
+    }
+
+    btBroadphaseProxy* createProxy(
+        const btVector3&, const btVector3&, int, void*, int, int, btDispatcher*) override
+    {
+        assert(0);
+        return nullptr;
+    }
+
+    void destroyProxy(btBroadphaseProxy*, btDispatcher*) override { assert(0); }
+
+    void setAabb(btBroadphaseProxy*, const btVector3&, const btVector3&, btDispatcher*) override { assert(0); }
+
+    void getAabb(btBroadphaseProxy* proxy, btVector3& aabbMin, btVector3& aabbMax) const override
+    {
+        broadphase_->getAabb(proxy, aabbMin, aabbMax);
+    }
+
+    void rayTest(const btVector3& rayFrom, const btVector3& rayTo, btBroadphaseRayCallback& rayCallback,
+        const btVector3& aabbMin, const btVector3& aabbMax) override
+    {
+        RayTester tester(rayCallback);
+        for (const btDbvt& tree : broadphase_->m_sets)
+        {
+            tree.rayTestInternal(tree.m_root, rayFrom, rayTo, rayCallback.m_rayDirectionInverse, rayCallback.m_signs,
+                rayCallback.m_lambda_max, aabbMin, aabbMax, stack_, tester);
         }
+    }
+
+    void aabbTest(const btVector3& aabbMin, const btVector3& aabbMax, btBroadphaseAabbCallback& callback) override
+    {
+        // Uses local stack, safe to call concurrently
+        broadphase_->aabbTest(aabbMin, aabbMax, callback);
+    }
+
+    void calculateOverlappingPairs(btDispatcher*) override {}
+
+    btOverlappingPairCache* getOverlappingPairCache() override { return broadphase_->getOverlappingPairCache(); }
+
+    const btOverlappingPairCache* getOverlappingPairCache() const override
+    {
+        return broadphase_->getOverlappingPairCache();
+    }
 
-        clearForces();
+    void getBroadphaseAabb(btVector3& aabbMin, btVector3& aabbMax) const override
+    {
+        broadphase_->getBroadphaseAabb(aabbMin, aabbMax);
     }
 
-    btScalar getLocalTime() const { return m_localTime; }
+    void printStats() override {}
+
+private:
+    struct RayTester : public btDbvt::ICollide
+    {
+        explicit RayTester(btBroadphaseRayCallback& callback)
+            : callback_(callback)
+        {
+        }
+
+        void Process(const btDbvtNode* leaf) override
+        {
+            callback_.process(static_cast<btDbvtProxy*>(leaf->data));
+        }
+
+        btBroadphaseRayCallback& callback_;
+    };
+
+    btDbvtBroadphase* broadphase_{};
+    btAlignedObjectArray<const btDbvtNode*> stack_;
+};
+
+/// Collision world used by one thread to execute batched queries against the broadphase of the physics world.
+/// Owns collision dispatcher so narrowphase algorithms and manifolds are not shared between threads.
+/// Note that default collision configuration is used regardless of PhysicsWorldConfig.
+class btQueryCollisionWorld
+{
+public:
+    explicit btQueryCollisionWorld(btDbvtBroadphase* broadphase)
+        : collisionConfiguration_(GetConstructionInfo())
+        , collisionDispatcher_(&collisionConfiguration_)
+        , broadphase_(broadphase)
+        , world_(&collisionDispatcher_, &broadphase_, &collisionConfiguration_)
+    {
+        btGImpactCollisionAlgorithm::registerAlgorithm(&collisionDispatcher_);
+    }
+
+    /// Return collision world.
+    btCollisionWorld& GetWorld() { return world_; }
+
+private:
+    static btDefaultCollisionConstructionInfo GetConstructionInfo()
+    {
+        // Queries only need a few algorithms and manifolds at once
+        btDefaultCollisionConstructionInfo info;
+        info.m_defaultMaxPersistentManifoldPoolSize = 64;
+        info.m_defaultMaxCollisionAlgorithmPoolSize = 64;
+        return info;
+    }
+
+    btDefaultCollisionConfiguration collisionConfiguration_;
+    btCollisionDispatcher collisionDispatcher_;
+    btConcurrentQueryBroadphase broadphase_;
+    btCollisionWorld world_;
+};
+
+/// Closest convex result callback that ignores specified collision object.
+struct btIgnoreObjectConvexResultCallback : public btCollisionWorld::ClosestConvexResultCallback
+{
+    btIgnoreObjectConvexResultCallback(const btVector3& convexFromWorld, const btVector3& convexToWorld,
+        const btCollisionObject* me)
+        : ClosestConvexResultCallback(convexFromWorld, convexToWorld)
+        , me_(me)
+    {
+    }
+
+    bool needsCollision(btBroadphaseProxy* proxy0) const override
+    {
+        if (proxy0->m_clientObject == me_)
+            return false;
+        return ClosestConvexResultCallback::needsCollision(proxy0);
+    }
+
+    const btCollisionObject* me_{};
 };
 
 namespace Urho3D
@@ -175,6 +458,210 @@ struct PhysicsQueryCallback : public btCollisionWorld::ContactResultCallback
     unsigned collisionMask_;
 };
 
+/// Return empty result of physics raycast.
+static PhysicsRaycastResult GetEmptyRaycastResult()
+{
+    PhysicsRaycastResult result;
+    result.distance_ = M_INFINITY;
+    return result;
+}
+
+/// Execute cast query in the collision world.
+static void ExecuteCastQuery(btCollisionWorld& world, const PhysicsCastQuery& query, PhysicsRaycastResult& result)
+{
+    const btVector3 startPos = ToBtVector3(query.startPos_);
+    const btVector3 endPos = ToBtVector3(query.endPos_);
+
+    if (query.type_ == PhysicsCastQuery::Type::Ray)
+    {
+        btCollisionWorld::ClosestRayResultCallback rayCallback(startPos, endPos);
+        rayCallback.m_collisionFilterGroup = (short)0xffff;
+        rayCallback.m_collisionFilterMask = (short)query.collisionMask_;
+
+        world.rayTest(startPos, endPos, rayCallback);
+
+        if (!rayCallback.hasHit())
+        {
+            result = GetEmptyRaycastResult();
+            return;
+        }
+
+        result.position_ = ToVector3(rayCallback.m_hitPointWorld);
+        result.normal_ = ToVector3(rayCallback.m_hitNormalWorld);
+        result.distance_ = (result.position_ - query.startPos_).Length();
+        result.hitFraction_ = rayCallback.m_closestHitFraction;
+        result.body_ = static_cast<RigidBody*>(rayCallback.m_collisionObject->getUserPointer());
+        return;
+    }
+
+    btSphereShape sphereShape(query.radius_);
+    btConvexShape* shape = query.type_ == PhysicsCastQuery::Type::Sphere
+        ? &sphereShape : static_cast<btConvexShape*>(query.shape_);
+
+    btIgnoreObjectConvexResultCallback convexCallback(startPos, endPos, query.ignoredObject_);
+    convexCallback.m_collisionFilterGroup = (short)0xffff;
+    convexCallback.m_collisionFilterMask = (short)query.collisionMask_;
+
+    world.convexSweepTest(shape, btTransform(ToBtQuaternion(query.startRot_), startPos),
+        btTransform(ToBtQuaternion(query.endRot_), endPos), convexCallback);
+
+    if (!convexCallback.hasHit())
+    {
+        result = GetEmptyRaycastResult();
+        return;
+    }
+
+    result.body_ = static_cast<RigidBody*>(convexCallback.m_hitCollisionObject->getUserPointer());
+    result.position_ = ToVector3(convexCallback.m_hitPointWorld);
+    result.normal_ = ToVector3(convexCallback.m_hitNormalWorld);
+    result.distance_ = convexCallback.m_closestHitFraction * (query.endPos_ - query.startPos_).Length();
+    result.hitFraction_ = convexCallback.m_closestHitFraction;
+}
+
+/// Execute overlap query in the collision world.
+static void ExecuteOverlapQuery(btCollisionWorld& world, const PhysicsOverlapQuery& query, ea::vector<RigidBody*>& result)
+{
+    btSphereShape sphereShape(query.radius_);
+    btBoxShape boxShape(ToBtVector3(query.halfSize_));
+
+    // Temporary object doesn't need to be added to the world for contact test
+    btCollisionObject object;
+    object.setCollisionShape(query.isSphere_ ? static_cast<btCollisionShape*>(&sphereShape) : &boxShape);
+    object.setWorldTransform(btTransform(btQuaternion::getIdentity(), ToBtVector3(query.center_)));
+
+    PhysicsQueryCallback callback(result, query.collisionMask_);
+    world.contactTest(&object, callback);
+}
+
+unsigned PhysicsQueryBatch::AddRaycast(const Ray& ray, float maxDistance, unsigned collisionMask)
+{
+    if (maxDistance >= M_INFINITY)
+        URHO3D_LOGWARNING("Infinite maxDistance in physics raycast is not supported");
+
+    PhysicsCastQuery& query = casts_.emplace_back();
+    query.type_ = PhysicsCastQuery::Type::Ray;
+    query.startPos_ = ray.origin_;
+    query.endPos_ = ray.origin_ + maxDistance * ray.direction_;
+    query.collisionMask_ = collisionMask;
+    return casts_.size() - 1;
+}
+
+unsigned PhysicsQueryBatch::AddSphereCast(const Ray& ray, float radius, float maxDistance, unsigned collisionMask)
+{
+    if (maxDistance >= M_INFINITY)
+        URHO3D_LOGWARNING("Infinite maxDistance in physics sphere cast is not supported");
+
+    PhysicsCastQuery& query = casts_.emplace_back();
+    query.type_ = PhysicsCastQuery::Type::Sphere;
+    query.startPos_ = ray.origin_;
+    query.endPos_ = ray.origin_ + maxDistance * ray.direction_;
+    query.radius_ = radius;
+    query.collisionMask_ = collisionMask;
+    return casts_.size() - 1;
+}
+
+unsigned PhysicsQueryBatch::AddConvexCast(CollisionShape* shape, const Vector3& startPos, const Quaternion& startRot,
+    const Vector3& endPos, const Quaternion& endRot, unsigned collisionMask)
+{
+    // Empty query is added and error is logged for null shape
+    if (!shape || !shape->GetCollisionShape())
+        return AddConvexCast(static_cast<btCollisionShape*>(nullptr), startPos, startRot, endPos, endRot, collisionMask);
+
+    // Take the shape's offset position & rotation into account
+    Node* shapeNode = shape->GetNode();
+    const Vector3 scale = shapeNode ? shapeNode->GetWorldScale() : Vector3::ONE;
+    const Matrix3x4 startTransform(startPos, startRot, scale);
+    const Matrix3x4 endTransform(endPos, endRot, scale);
+
+    const unsigned index = AddConvexCast(shape->GetCollisionShape(), startTransform * shape->GetPosition(),
+        startRot * shape->GetRotation(), endTransform * shape->GetPosition(), endRot * shape->GetRotation(),
+        collisionMask);
+
+    // Ignore the rigid body the shape is attached to
+    if (auto* bodyComp = shape->GetComponent<RigidBody>())
+        casts_[index].ignoredObject_ = bodyComp->GetBody();
+
+    return index;
+}
+
+unsigned PhysicsQueryBatch::AddConvexCast(btCollisionShape* shape, const Vector3& startPos, const Quaternion& startRot,
+    const Vector3& endPos, const Quaternion& endRot, unsigned collisionMask)
+{
+    if (!shape)
+        URHO3D_LOGERROR("Null collision shape for convex cast");
+    else if (!shape->isConvex())
+        URHO3D_LOGERROR("Can not use non-convex collision shape for convex cast");
+
+    PhysicsCastQuery& query = casts_.emplace_back();
+    query.type_ = PhysicsCastQuery::Type::Convex;
+    query.startPos_ = startPos;
+    query.startRot_ = startRot;
+    query.endPos_ = endPos;
+    query.endRot_ = endRot;
+    query.shape_ = shape && shape->isConvex() ? shape : nullptr;
+    query.collisionMask_ = collisionMask;
+    return casts_.size() - 1;
+}
+
+unsigned PhysicsQueryBatch::AddOverlap(const Sphere& sphere, unsigned collisionMask)
+{
+    PhysicsOverlapQuery& query = overlaps_.emplace_back();
+    query.isSphere_ = true;
+    query.center_ = sphere.center_;
+    query.radius_ = sphere.radius_;
+    query.collisionMask_ = collisionMask;
+    return overlaps_.size() - 1;
+}
+
+unsigned PhysicsQueryBatch::AddOverlap(const BoundingBox& box, unsigned collisionMask)
+{
+    PhysicsOverlapQuery& query = overlaps_.emplace_back();
+    query.isSphere_ = false;
+    query.center_ = box.Center();
+    query.halfSize_ = box.HalfSize();
+    query.collisionMask_ = collisionMask;
+    return overlaps_.size() - 1;
+}
+
+void PhysicsQueryBatch::Clear()
+{
+    casts_.clear();
+    overlaps_.clear();
+    castResults_.clear();
+    overlapRanges_.clear();
+    overlapBodies_.clear();
+}
+
+ea::span<RigidBody* const> PhysicsQueryBatch::GetOverlapResult(unsigned index) const
+{
+    const OverlapRange& range = overlapRanges_[index];
+    return {overlapBodies_.data() + range.offset_, range.size_};
+}
+
+void PhysicsQueryBatch::BeginExecution(unsigned numThreads)
+{
+    castResults_.resize(casts_.size());
+    overlapRanges_.resize(overlaps_.size());
+    overlapBodies_.clear();
+
+    threadOverlapBodies_.resize(numThreads);
+    for (auto& threadBodies : threadOverlapBodies_)
+        threadBodies.clear();
+}
+
+void PhysicsQueryBatch::EndExecution()
+{
+    for (OverlapRange& range : overlapRanges_)
+    {
+        const auto& threadBodies = threadOverlapBodies_[range.threadIndex_];
+        const auto begin = threadBodies.begin() + range.offset_;
+
+        range.threadIndex_ = 0;
+        range.offset_ = overlapBodies_.size();
+        overlapBodies_.insert(overlapBodies_.end(), begin, begin + range.size_);
+    }
+}
+
 PhysicsWorld::PhysicsWorld(Context* context)
     : Component(context)
     , fps_(DEFAULT_FPS)
@@ -191,12 +678,43 @@ PhysicsWorld::PhysicsWorld(Context* context)
     else
         collisionConfiguration_ = new btDefaultCollisionConfiguration();
 
-    collisionDispatcher_ = ea::make_unique<btCollisionDispatcher>(collisionConfiguration_);
-    btGImpactCollisionAlgorithm::registerAlgorithm(static_cast<btCollisionDispatcher*>(collisionDispatcher_.get()));
+#if BT_THREADSAFE
+    multiThreaded_ = PhysicsWorld::config.multiThreaded_;
+#else
+    if (PhysicsWorld::config.multiThreaded_)
+        URHO3D_LOGWARNING("Multithreaded physics requires URHO3D_PHYSICS_THREADED build option, using single thread");
+#endif
 
     broadphase_ = ea::make_unique<btDbvtBroadphase>();
-    solver_ = ea::make_unique<btSequentialImpulseConstraintSolver>();
-    world_ = ea::make_unique<btCustomDiscreteDynamicsWorld>(collisionDispatcher_.get(), broadphase_.get(), solver_.get(), collisionConfiguration_);
+
+#if BT_THREADSAFE
+    if (multiThreaded_)
+    {
+        btWorkQueueTaskScheduler::install(GetSubsystem<WorkQueue>());
+
+        const int numSolvers = static_cast<int>(WorkQueue::GetThreadIndexCount());
+        collisionDispatcher_ = ea::make_unique<btDeterministicCollisionDispatcherMt>(collisionConfiguration_, 40);
+        solver_ = ea::make_unique<btConstraintSolverPoolMt>(numSolvers);
+        solverMt_ = ea::make_unique<btSequentialImpulseConstraintSolverMt>();
+
+        auto world = ea::make_unique<btCustomDiscreteDynamicsWorldMt>(collisionDispatcher_.get(), broadphase_.get(),
+            static_cast<btConstraintSolverPoolMt*>(solver_.get()), solverMt_.get(), collisionConfiguration_);
+        customWorld_ = world.get();
+        world_ = ea::move(world);
+    }
+    else
+#endif
+    {
+        collisionDispatcher_ = ea::make_unique<btCollisionDispatcher>(collisionConfiguration_);
+        solver_ = ea::make_unique<btSequentialImpulseConstraintSolver>();
+
+        auto world = ea::make_unique<btCustomDiscreteDynamicsWorld>(
+            collisionDispatcher_.get(), broadphase_.get(), solver_.get(), collisionConfiguration_);
+        customWorld_ = world.get();
+        world_ = ea::move(world);
+    }
+
+    btGImpactCollisionAlgorithm::registerAlgorithm(static_cast<btCollisionDispatcher*>(collisionDispatcher_.get()));
 
     world_->setGravity(ToBtVector3(DEFAULT_GRAVITY));
     world_->getDispatchInfo().m_useContinuous = true;
@@ -226,7 +744,10 @@ PhysicsWorld::~PhysicsWorld()
             (*i)->ReleaseShape();
     }
 
+    queryWorlds_.clear();
+    customWorld_ = nullptr;
     world_.reset();
+    solverMt_.reset();
     solver_.reset();
     broadphase_.reset();
     collisionDispatcher_.reset();
@@ -331,7 +852,7 @@ void PhysicsWorld::Update(float timeStep)
         }
     }
 
-    PostUpdate(timeStep, world_->getLocalTime());
+    PostUpdate(timeStep, customWorld_->getLocalTime());
     simulating_ = false;
     ApplyDelayedWorldTransforms();
 }
@@ -370,7 +891,7 @@ void PhysicsWorld::CustomUpdate(
 
     timeAcc_ = overtime;
     synchronizedStep_ = sync;
-    world_->customStepSimulation(numSteps, fixedTimeStep, overtime);
+    customWorld_->customStepSimulation(numSteps, fixedTimeStep, overtime);
 
     PostUpdate(timeStep, overtime);
     simulating_ = false;
@@ -759,6 +1280,239 @@ void PhysicsWorld::GetCollidingBodies(ea::vector<RigidBody*>& result, const Rigi
     }
 }
 
+void PhysicsWorld::ExecuteQueryBatch(PhysicsQueryBatch& batch)
+{
+    URHO3D_PROFILE("PhysicsQueryBatch");
+
+    if (!WorkQueue::IsProcessingThread())
+    {
+        URHO3D_LOGERROR("Physics query batch should be executed from main thread or WorkQueue thread");
+        return;
+    }
+
+    static const unsigned queryBatchSize = 16;
+
+    const unsigned numThreads = WorkQueue::GetThreadIndexCount();
+    if (queryWorlds_.size() < numThreads)
+        queryWorlds_.resize(numThreads);
+
+    batch.BeginExecution(numThreads);
+
+    const unsigned numCasts = batch.casts_.size();
+    const unsigned numQueries = numCasts + batch.overlaps_.size();
+    auto* broadphase = static_cast<btDbvtBroadphase*>(broadphase_.get());
+    auto* workQueue = GetSubsystem<WorkQueue>();
+    workQueue->ParallelFor(numQueries, queryBatchSize,
+        [&](unsigned beginIndex, unsigned endIndex, unsigned threadIndex)
+    {
+        ea::unique_ptr<btQueryCollisionWorld>& queryWorld = queryWorlds_[threadIndex];
+        if (!queryWorld)
+            queryWorld = ea::make_unique<btQueryCollisionWorld>(broadphase);
+
+        btCollisionWorld& world = queryWorld->GetWorld();
+        ea::vector<RigidBody*>& threadBodies = batch.threadOverlapBodies_[threadIndex];
+        ea::vector<RigidBody*> queryBodies;
+        for (unsigned index = beginIndex; index < endIndex; ++index)
+        {
+            if (index < numCasts)
+            {
+                const PhysicsCastQuery& query = batch.casts_[index];
+                PhysicsRaycastResult& result = batch.castResults_[index];
+                if (query.type_ == PhysicsCastQuery::Type::Convex && !query.shape_)
+                    result = GetEmptyRaycastResult();
+                else
+                    ExecuteCastQuery(world, query, result);
+            }
+            else
+            {
+                const unsigned overlapIndex = index - numCasts;
+
+                // PhysicsQueryCallback checks for duplicates, so collect results of this query separately
+                queryBodies.clear();
+                ExecuteOverlapQuery(world, batch.overlaps_[overlapIndex], queryBodies);
+
+                PhysicsQueryBatch::OverlapRange& range = batch.overlapRanges_[overlapIndex];
+                range.threadIndex_ = threadIndex;
+                range.offset_ = threadBodies.size();
+                range.size_ = queryBodies.size();
+                threadBodies.insert(threadBodies.end(), queryBodies.begin(), queryBodies.end());
+            }
+        }
+    });
+
+    batch.EndExecution();
+}
+
+void PhysicsWorld::CaptureSnapshot(PhysicsSnapshot& snapshot, bool captureContacts) const
+{
+    URHO3D_PROFILE("CapturePhysicsSnapshot");
+
+    snapshot.Clear();
+    snapshot.bodies_.reserve(rigidBodies_.size());
+    for (RigidBody* body : rigidBodies_)
+    {
+        const btRigidBody* btBody = body->GetBody();
+        if (!btBody)
+            continue;
+
+        PhysicsBodySnapshot& bodyState = snapshot.bodies_.emplace_back();
+        bodyState.componentId_ = body->GetID();
+        bodyState.activationState_ = btBody->getActivationState();
+        bodyState.deactivationTime_ = btBody->getDeactivationTime();
+        bodyState.worldTransform_ = ToMatrix3x4(btBody->getWorldTransform());
+        bodyState.interpolationWorldTransform_ = ToMatrix3x4(btBody->getInterpolationWorldTransform());
+        bodyState.linearVelocity_ = ToVector3(btBody->getLinearVelocity());
+        bodyState.angularVelocity_ = ToVector3(btBody->getAngularVelocity());
+        bodyState.interpolationLinearVelocity_ = ToVector3(btBody->getInterpolationLinearVelocity());
+        bodyState.interpolationAngularVelocity_ = ToVector3(btBody->getInterpolationAngularVelocity());
+    }
+
+    if (!captureContacts)
+        return;
+
+    snapshot.hasContacts_ = true;
+    const int numManifolds = collisionDispatcher_->getNumManifolds();
+    for (int i = 0; i < numManifolds; ++i)
+    {
+        const btPersistentManifold* manifold = collisionDispatcher_->getManifoldByIndexInternal(i);
+        const int numContacts = manifold->getNumContacts();
+        if (!numContacts)
+            continue;
+
+        const auto* bodyA = static_cast<RigidBody*>(manifold->getBody0()->getUserPointer());
+        const auto* bodyB = static_cast<RigidBody*>(manifold->getBody1()->getUserPointer());
+        // If it's not a rigidbody, maybe a ghost object
+        if (!bodyA || !bodyB)
+            continue;
+
+        PhysicsManifoldSnapshot& manifoldState = snapshot.manifolds_.emplace_back();
+        manifoldState.componentId0_ = bodyA->GetID();
+        manifoldState.componentId1_ = bodyB->GetID();
+        manifoldState.firstPoint_ = snapshot.contactPoints_.size() / sizeof(btManifoldPoint);
+        manifoldState.numPoints_ = numContacts;
+
+        const unsigned offset = snapshot.contactPoints_.size();
+        snapshot.contactPoints_.resize(offset + numContacts * sizeof(btManifoldPoint));
+        for (int j = 0; j < numContacts; ++j)
+        {
+            btManifoldPoint point = manifold->getContactPoint(j);
+            // Persistent data is owned by the manifold and is not valid after restore
+            point.m_userPersistentData = nullptr;
+            memcpy(&snapshot.contactPoints_[offset + j * sizeof(btManifoldPoint)], &point, sizeof(btManifoldPoint));
+        }
+    }
+
+    // Keep the order of manifolds for the same pair of bodies, they are matched in this order on restore
+    ea::stable_sort(snapshot.manifolds_.begin(), snapshot.manifolds_.end(),
+        [](const PhysicsManifoldSnapshot& lhs, const PhysicsManifoldSnapshot& rhs)
+    { return ea::tie(lhs.componentId0_, lhs.componentId1_) < ea::tie(rhs.componentId0_, rhs.componentId1_); });
+}
+
+void PhysicsWorld::RestoreSnapshot(const PhysicsSnapshot& snapshot)
+{
+    URHO3D_PROFILE("RestorePhysicsSnapshot");
+
+    if (simulating_)
+    {
+        URHO3D_LOGERROR("Physics snapshot cannot be restored during simulation step");
+        return;
+    }
+
+    Scene* scene = GetScene();
+    delayedWorldTransforms_.clear();
+
+    const unsigned numBodies = snapshot.bodies_.size();
+    for (unsigned i = 0; i < numBodies; ++i)
+    {
+        const PhysicsBodySnapshot& bodyState = snapshot.bodies_[i];
+
+        // Bodies are usually stored in the same order as they are in the world
+        RigidBody* body = i < rigidBodies_.size() && rigidBodies_[i]->GetID() == bodyState.componentId_
+            ? rigidBodies_[i]
+            : nullptr;
+        if (!body && scene)
+        {
+            if (Component* component = scene->GetComponent(bodyState.componentId_))
+                body = component->Cast<RigidBody>();
+            if (body && body->GetPhysicsWorld() != this)
+                body = nullptr;
+        }
+
+        btRigidBody* btBody = body ? body->GetBody() : nullptr;
+        if (!btBody)
+            continue;
+
+        btBody->setWorldTransform(ToBtTransform(bodyState.worldTransform_));
+        btBody->setInterpolationWorldTransform(ToBtTransform(bodyState.interpolationWorldTransform_));
+        btBody->setLinearVelocity(ToBtVector3(bodyState.linearVelocity_));
+        btBody->setAngularVelocity(ToBtVector3(bodyState.angularVelocity_));
+        btBody->setInterpolationLinearVelocity(ToBtVector3(bodyState.interpolationLinearVelocity_));
+        btBody->setInterpolationAngularVelocity(ToBtVector3(bodyState.interpolationAngularVelocity_));
+        btBody->forceActivationState(bodyState.activationState_);
+        btBody->setDeactivationTime(bodyState.deactivationTime_);
+        btBody->clearForces();
+        btBody->updateInertiaTensor();
+
+        if (btBody->getBroadphaseHandle())
+            world_->updateSingleAabb(btBody);
+
+        body->ApplyBodyWorldTransform();
+    }
+
+    ApplyDelayedWorldTransforms();
+
+    if (snapshot.hasContacts_)
+        RestoreSnapshotContacts(snapshot);
+}
+
+void PhysicsWorld::RestoreSnapshotContacts(const PhysicsSnapshot& snapshot)
+{
+    snapshotManifoldsUsed_.clear();
+    snapshotManifoldsUsed_.resize(snapshot.manifolds_.size(), false);
+
+    const int numManifolds = collisionDispatcher_->getNumManifolds();
+    for (int i = 0; i < numManifolds; ++i)
+    {
+        btPersistentManifold* manifold = collisionDispatcher_->getManifoldByIndexInternal(i);
+        const auto* bodyA = static_cast<RigidBody*>(manifold->getBody0()->getUserPointer());
+        const auto* bodyB = static_cast<RigidBody*>(manifold->getBody1()->getUserPointer());
+        // If it's not a rigidbody, maybe a ghost object
+        if (!bodyA || !bodyB)
+            continue;
+
+        manifold->clearManifold();
+
+        const unsigned componentId0 = bodyA->GetID();
+        const unsigned componentId1 = bodyB->GetID();
+        const PhysicsManifoldSnapshot* firstManifoldState = snapshot.FindManifold(componentId0, componentId1);
+        if (!firstManifoldState)
+            continue;
+
+        // Match manifolds of the same pair of bodies in the order of capture
+        const auto isSamePair = [&](unsigned index)
+        {
+            const PhysicsManifoldSnapshot& manifoldState = snapshot.manifolds_[index];
+            return manifoldState.componentId0_ == componentId0 && manifoldState.componentId1_ == componentId1;
+        };
+
+        unsigned index = firstManifoldState - snapshot.manifolds_.begin();
+        while (index < snapshot.manifolds_.size() && isSamePair(index) && snapshotManifoldsUsed_[index])
+            ++index;
+        if (index >= snapshot.manifolds_.size() || !isSamePair(index))
+            continue;
+
+        snapshotManifoldsUsed_[index] = true;
+        const PhysicsManifoldSnapshot& manifoldState = snapshot.manifolds_[index];
+        for (unsigned j = 0; j < manifoldState.numPoints_; ++j)
+        {
+            btManifoldPoint point;
+            const unsigned offset = (manifoldState.firstPoint_ + j) * sizeof(btManifoldPoint);
+            memcpy(&point, &snapshot.contactPoints_[offset], sizeof(btManifoldPoint));
+            manifold->addManifoldPoint(point);
+        }
+    }
+}
+
 Vector3 PhysicsWorld::GetGravity() const
 {
     return ToVector3(world_->getGravity());
@@ -861,6 +1615,12 @@ void PhysicsWorld::PreUpdate(float timeStep)
     eventData[P_WORLD] = this;
     eventData[P_TIMESTEP] = timeStep;
     SendEvent(E_PHYSICSPREUPDATE, eventData);
+
+#if BT_THREADSAFE
+    // Task scheduler is global in Bullet, make sure it uses WorkQueue of this context
+    if (multiThreaded_)
+        btWorkQueueTaskScheduler::install(GetSubsystem<WorkQueue>());
+#endif
 }
 
 void PhysicsWorld::PostUpdate(float timeStep, float overtime)
@@ -40,14 +40,17 @@
 #endif
 
 #include <EASTL/optional.h>
+#include <EASTL/span.h>
 #include <EASTL/unique_ptr.h>
 
 class btCollisionConfiguration;
+class btCollisionObject;
 class btCollisionShape;
 class btBroadphaseInterface;
 class btConstraintSolver;
 class btDiscreteDynamicsWorld;
-class btCustomDiscreteDynamicsWorld;
+class btCustomDynamicsWorld;
+class btQueryCollisionWorld;
 class btDispatcher;
 class btDynamicsWorld;
 class btPersistentManifold;
@@ -61,6 +64,7 @@ class Deserializer;
 class Constraint;
 class Model;
 class Node;
+class PhysicsSnapshot;
 class Ray;
 class RigidBody;
 class Scene;
@@ -123,12 +127,132 @@ struct ManifoldPair
 struct PhysicsWorldConfig
 {
     PhysicsWorldConfig() :
-        collisionConfig_(nullptr)
+        collisionConfig_(nullptr),
+        multiThreaded_(false)
     {
     }
 
     /// Override for the collision configuration (default btDefaultCollisionConfiguration).
     btCollisionConfiguration* collisionConfig_;
+    /// Use thread-safe Bullet world with island-parallel solver running on WorkQueue threads.
+    /// Requires URHO3D_PHYSICS_THREADED build option, ignored otherwise.
+    bool multiThreaded_;
+};
+
+/// Swept query in PhysicsQueryBatch.
+struct PhysicsCastQuery
+{
+    /// Type of the swept query.
+    enum class Type
+    {
+        Ray,
+        Sphere,
+        Convex
+    };
+
+    /// Query type.
+    Type type_{};
+    /// Start position.
+    Vector3 startPos_;
+    /// Start rotation. Used by convex casts only.
+    Quaternion startRot_;
+    /// End position.
+    Vector3 endPos_;
+    /// End rotation. Used by convex casts only.
+    Quaternion endRot_;
+    /// Radius of the sphere cast.
+    float radius_{};
+    /// Convex shape of the convex cast.
+    btCollisionShape* shape_{};
+    /// Collision object to be excluded from the results, if any.
+    const btCollisionObject* ignoredObject_{};
+    /// Collision mask.
+    unsigned collisionMask_{};
+};
+
+/// Overlap query in PhysicsQueryBatch.
+struct PhysicsOverlapQuery
+{
+    /// Whether the volume is sphere. Volume is box otherwise.
+    bool isSphere_{};
+    /// Center of the volume.
+    Vector3 center_;
+    /// Half size of the box.
+    Vector3 halfSize_;
+    /// Radius of the sphere.
+    float radius_{};
+    /// Collision mask.
+    unsigned collisionMask_{};
+};
+
+/// Batch of physics world queries that are executed together by PhysicsWorld::ExecuteQueryBatch.
+/// Casts return the closest hit each. Overlaps return ranges in the flat buffer of rigid bodies.
+/// Results are stored in the order of submission and are not affected by the number of worker threads.
+class URHO3D_API PhysicsQueryBatch
+{
+    friend class PhysicsWorld;
+
+public:
+    /// Add raycast and return index of the cast result.
+    unsigned AddRaycast(const Ray& ray, float maxDistance, unsigned collisionMask = M_MAX_UNSIGNED);
+    /// Add swept sphere test and return index of the cast result.
+    unsigned AddSphereCast(const Ray& ray, float radius, float maxDistance, unsigned collisionMask = M_MAX_UNSIGNED);
+    /// Add swept convex test using collision shape and return index of the cast result.
+    /// Rigid body that owns the shape is excluded from the results.
+    unsigned AddConvexCast(CollisionShape* shape, const Vector3& startPos, const Quaternion& startRot,
+        const Vector3& endPos, const Quaternion& endRot, unsigned collisionMask = M_MAX_UNSIGNED);
+    /// Add swept convex test using Bullet collision shape and return index of the cast result.
+    unsigned AddConvexCast(btCollisionShape* shape, const Vector3& startPos, const Quaternion& startRot,
+        const Vector3& endPos, const Quaternion& endRot, unsigned collisionMask = M_MAX_UNSIGNED);
+    /// Add sphere overlap query and return index of the overlap result.
+    unsigned AddOverlap(const Sphere& sphere, unsigned collisionMask = M_MAX_UNSIGNED);
+    /// Add box overlap query and return index of the overlap result.
+    unsigned AddOverlap(const BoundingBox& box, unsigned collisionMask = M_MAX_UNSIGNED);
+    /// Remove all queries and results. Memory is kept for reuse.
+    void Clear();
+
+    /// Return number of cast queries.
+    unsigned GetNumCasts() const { return casts_.size(); }
+    /// Return number of overlap queries.
+    unsigned GetNumOverlaps() const { return overlaps_.size(); }
+    /// Return results of all cast queries.
+    const ea::vector<PhysicsRaycastResult>& GetCastResults() const { return castResults_; }
+    /// Return result of the cast query.
+    const PhysicsRaycastResult& GetCastResult(unsigned index) const { return castResults_[index]; }
+    /// Return rigid bodies found by the overlap query.
+    ea::span<RigidBody* const> GetOverlapResult(unsigned index) const;
+    /// Return rigid bodies found by all overlap queries, stored one query after another.
+    const ea::vector<RigidBody*>& GetOverlapBodies() const { return overlapBodies_; }
+
+private:
+    /// Range of the overlap result in the buffer.
+    struct OverlapRange
+    {
+        /// Index of the thread that executed the query.
+        unsigned threadIndex_{};
+        /// Offset in the buffer.
+        unsigned offset_{};
+        /// Number of rigid bodies.
+        unsigned size_{};
+    };
+
+    /// Allocate results before execution.
+    void BeginExecution(unsigned numThreads);
+    /// Gather overlap results from per-thread buffers after execution.
+    void EndExecution();
+
+    /// Cast queries.
+    ea::vector<PhysicsCastQuery> casts_;
+    /// Overlap queries.
+    ea::vector<PhysicsOverlapQuery> overlaps_;
+    /// Results of cast queries.
+    ea::vector<PhysicsRaycastResult> castResults_;
+    /// Ranges of overlap results in the buffer.
+    ea::vector<OverlapRange> overlapRanges_;
+    /// Rigid bodies found by overlap queries.
+    ea::vector<RigidBody*> overlapBodies_;
+    /// Per-thread buffers for overlap results.
+    ea::vector<ea::vector<RigidBody*>> threadOverlapBodies_;
 };
 
 static const int DEFAULT_FPS = 60;
@@ -234,6 +358,16 @@ public:
     void GetRigidBodies(ea::vector<RigidBody*>& result, const RigidBody* body);
     /// Return rigid bodies that have been in collision with the specified body on the last simulation step. Only returns collisions that were sent as events (depends on collision event mode) and excludes e.g. static-static collisions.
     void GetCollidingBodies(ea::vector<RigidBody*>& result, const RigidBody* body);
+    /// Execute batch of queries in parallel on WorkQueue threads. Should not be called during simulation step.
+    void ExecuteQueryBatch(PhysicsQueryBatch& batch);
+
+    /// Capture simulation state of all rigid bodies into the snapshot. Snapshot memory is reused.
+    /// Contact cache is optional: without it, resimulation may diverge for resting contacts.
+    void CaptureSnapshot(PhysicsSnapshot& snapshot, bool captureContacts = false) const;
+    /// Restore simulation state of rigid bodies from the snapshot and update their nodes.
+    /// Bodies that don't exist anymore are ignored. Bodies that are not in the snapshot are not changed.
+    /// Should not be called during simulation step.
+    void RestoreSnapshot(const PhysicsSnapshot& snapshot);
 
     /// Return gravity.
     /// @property
@@ -293,6 +427,8 @@ public:
 
     /// Return the Bullet physics world.
     btDiscreteDynamicsWorld* GetWorld() const;
+    /// Return whether the Bullet physics world is stepped in multiple threads.
+    bool IsMultiThreaded() const { return multiThreaded_; }
 
     /// Return trimesh collision geometry cache.
     CollisionGeometryDataCache& GetTriMeshCache() { return *triMeshCache_; }
@@ -333,6 +469,8 @@ private:
     /// Send accumulated collision events.
     void SendCollisionEvents();
     void ApplyDelayedWorldTransforms();
+    /// Restore contact cache from the snapshot into existing manifolds.
+    void RestoreSnapshotContacts(const PhysicsSnapshot& snapshot);
 
     /// Bullet collision configuration.
     btCollisionConfiguration* collisionConfiguration_{};
@@ -340,10 +478,18 @@ private:
     ea::unique_ptr<btDispatcher> collisionDispatcher_;
     /// Bullet collision broadphase.
     ea::unique_ptr<btBroadphaseInterface> broadphase_;
-    /// Bullet constraint solver.
+    /// Bullet constraint solver. Pool of solvers for multithreaded world.
     ea::unique_ptr<btConstraintSolver> solver_;
+    /// Bullet multithreaded constraint solver for large islands.
+    ea::unique_ptr<btConstraintSolver> solverMt_;
     /// Bullet physics world.
-    ea::unique_ptr<btCustomDiscreteDynamicsWorld> world_;
+    ea::unique_ptr<btDiscreteDynamicsWorld> world_;
+    /// Custom stepping interface of Bullet physics world.
+    btCustomDynamicsWorld* customWorld_{};
+    /// Whether the world is multithreaded.
+    bool multiThreaded_{};
+    /// Per-thread collision worlds for batched queries.
+    ea::vector<ea::unique_ptr<btQueryCollisionWorld>> queryWorlds_;
     /// Extra weak pointer to scene to allow for cleanup in case the world is destroyed before other components.
     WeakPtr<Scene> scene_;
     /// Rigid bodies in the world.
@@ -358,6 +504,8 @@ private:
     ea::unordered_map<ea::pair<WeakPtr<RigidBody>, WeakPtr<RigidBody> >, ManifoldPair> previousCollisions_;
     /// Delayed (parented) world transform assignments.
     ea::unordered_map<RigidBody*, DelayedWorldTransform> delayedWorldTransforms_;
+    /// Manifolds of the snapshot that were already restored. Used by RestoreSnapshot.
+    ea::vector<bool> snapshotManifoldsUsed_;
     /// Cache for trimesh geometry data by model and LOD level.
     SharedPtr<CollisionGeometryDataCache> triMeshCache_;
     /// Cache for convex geometry data by model and LOD level.
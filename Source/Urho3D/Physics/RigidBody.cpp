@@ -159,6 +159,17 @@ void RigidBody::setWorldTransform(const btTransform& worldTrans)
     if (!body_->isActive()) // Fix #2491
         return;
 
+    ApplyBulletTransform(worldTrans);
+}
+
+void RigidBody::ApplyBodyWorldTransform()
+{
+    if (body_)
+        ApplyBulletTransform(body_->getWorldTransform());
+}
+
+void RigidBody::ApplyBulletTransform(const btTransform& worldTrans)
+{
     Quaternion newWorldRotation = ToQuaternion(worldTrans.getRotation());
     Vector3 newWorldPosition = ToVector3(worldTrans.getOrigin()) - newWorldRotation * centerOfMass_;
     RigidBody* parentRigidBody = nullptr;
@@ -284,6 +284,8 @@ public:
 
     /// Apply new world transform after a simulation step. Called internally.
     void ApplyWorldTransform(const Vector3& newWorldPosition, const Quaternion& newWorldRotation);
+    /// Apply current world transform of the Bullet body to the node, even if the body is inactive. Called internally.
+    void ApplyBodyWorldTransform();
     /// Update mass and inertia to the Bullet rigid body. Readd body to world if necessary: if was in world and the Bullet collision shape to use changed.
     void UpdateMass();
     /// Update gravity parameters to the Bullet rigid body.
@@ -310,6 +312,8 @@ private:
     void RemoveBodyFromWorld();
     /// Mark body dirty.
     void MarkBodyDirty() { readdBody_ = true; }
+    /// Apply Bullet world transform to the node, or delay it if parented to another rigid body.
+    void ApplyBulletTransform(const btTransform& worldTrans);
 
     /// Bullet rigid body.
     ea::unique_ptr<btRigidBody> body_;
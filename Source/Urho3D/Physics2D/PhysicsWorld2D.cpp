@@ -24,6 +24,7 @@
 
 #include "../Core/Context.h"
 #include "../Core/Profiler.h"
+#include "../Core/WorkQueue.h"
 #include "../Graphics/DebugRenderer.h"
 #include "../Graphics/Graphics.h"
 #include "../Graphics/Renderer.h"
@@ -674,16 +675,220 @@ private:
     unsigned collisionMask_;
 };
 
-void PhysicsWorld2D::GetRigidBodies(ea::vector<RigidBody2D*>& results, const Rect& aabb, unsigned collisionMask)
+// Return Box2D query box for the rect.
+static b2AABB ToQueryAabb(const Rect& aabb)
 {
-    AabbQueryCallback callback(results, collisionMask);
-
     b2AABB b2Aabb;
     Vector2 delta(M_EPSILON, M_EPSILON);
     b2Aabb.lowerBound = ToB2Vec2(aabb.min_ - delta);
     b2Aabb.upperBound = ToB2Vec2(aabb.max_ + delta);
+    return b2Aabb;
+}
 
-    world_->QueryAABB(&callback, b2Aabb);
+void PhysicsWorld2D::GetRigidBodies(ea::vector<RigidBody2D*>& results, const Rect& aabb, unsigned collisionMask)
+{
+    AabbQueryCallback callback(results, collisionMask);
+    world_->QueryAABB(&callback, ToQueryAabb(aabb));
+}
+
+// Circle cast call back class.
+class CircleCastCallback : public b2QueryCallback
+{
+public:
+    // Construct.
+    CircleCastCallback(PhysicsRaycastResult2D& result, const PhysicsCastQuery2D& query) :
+        result_(result),
+        collisionMask_(query.collisionMask_),
+        length_((query.endPoint_ - query.startPoint_).Length()),
+        minLambda_(M_INFINITY)
+    {
+        circle_.m_radius = query.radius_;
+        input_.proxyB.Set(&circle_, 0);
+        input_.transformB.Set(ToB2Vec2(query.startPoint_), 0.0f);
+        input_.translationB = ToB2Vec2(query.endPoint_ - query.startPoint_);
+    }
+
+    // Called for each fixture found in the swept AABB.
+    bool ReportFixture(b2Fixture* fixture) override
+    {
+        // Ignore sensor
+        if (fixture->IsSensor())
+            return true;
+
+        if ((fixture->GetFilterData().maskBits & collisionMask_) == 0)
+            return true;
+
+        const b2Shape* shape = fixture->GetShape();
+        input_.transformA = fixture->GetBody()->GetTransform();
+        for (int32 childIndex = 0; childIndex < shape->GetChildCount(); ++childIndex)
+        {
+            input_.proxyA.Set(shape, childIndex);
+
+            b2ShapeCastOutput output;
+            if (b2ShapeCast(&output, &input_) && output.lambda < minLambda_)
+            {
+                minLambda_ = output.lambda;
+
+                result_.position_ = ToVector2(output.point);
+                result_.normal_ = ToVector2(output.normal);
+                result_.distance_ = output.lambda * length_;
+                result_.body_ = (RigidBody2D*)(fixture->GetBody()->GetUserData());
+            }
+        }
+
+        return true;
+    }
+
+private:
+    // Physics raycast result.
+    PhysicsRaycastResult2D& result_;
+    // Collision mask.
+    unsigned collisionMask_;
+    // Cast length.
+    float length_;
+    // Minimum hit fraction.
+    float minLambda_;
+    // Cast circle.
+    b2CircleShape circle_;
+    // Shape cast input.
+    b2ShapeCastInput input_;
+};
+
+// Return empty result of 2D physics raycast.
+static PhysicsRaycastResult2D GetEmptyRaycastResult2D()
+{
+    PhysicsRaycastResult2D result;
+    result.distance_ = M_INFINITY;
+    return result;
+}
+
+unsigned PhysicsQueryBatch2D::AddRaycast(const Vector2& startPoint, const Vector2& endPoint, unsigned collisionMask)
+{
+    return AddCircleCast(startPoint, endPoint, 0.0f, collisionMask);
+}
+
+unsigned PhysicsQueryBatch2D::AddCircleCast(const Vector2& startPoint, const Vector2& endPoint, float radius,
+    unsigned collisionMask)
+{
+    PhysicsCastQuery2D& query = casts_.emplace_back();
+    query.startPoint_ = startPoint;
+    query.endPoint_ = endPoint;
+    query.radius_ = Max(radius, 0.0f);
+    query.collisionMask_ = collisionMask;
+    return casts_.size() - 1;
+}
+
+unsigned PhysicsQueryBatch2D::AddOverlap(const Rect& aabb, unsigned collisionMask)
+{
+    PhysicsOverlapQuery2D& query = overlaps_.emplace_back();
+    query.aabb_ = aabb;
+    query.collisionMask_ = collisionMask;
+    return overlaps_.size() - 1;
+}
+
+void PhysicsQueryBatch2D::Clear()
+{
+    casts_.clear();
+    overlaps_.clear();
+    castResults_.clear();
+    overlapRanges_.clear();
+    overlapBodies_.clear();
+}
+
+ea::span<RigidBody2D* const> PhysicsQueryBatch2D::GetOverlapResult(unsigned index) const
+{
+    const OverlapRange& range = overlapRanges_[index];
+    return {overlapBodies_.data() + range.offset_, range.size_};
+}
+
+void PhysicsQueryBatch2D::BeginExecution(unsigned numThreads)
+{
+    castResults_.resize(casts_.size());
+    overlapRanges_.resize(overlaps_.size());
+    overlapBodies_.clear();
+
+    threadOverlapBodies_.resize(numThreads);
+    for (auto& threadBodies : threadOverlapBodies_)
+        threadBodies.clear();
+}
+
+void PhysicsQueryBatch2D::EndExecution()
+{
+    for (OverlapRange& range : overlapRanges_)
+    {
+        const auto& threadBodies = threadOverlapBodies_[range.threadIndex_];
+        const auto begin = threadBodies.begin() + range.offset_;
+
+        range.threadIndex_ = 0;
+        range.offset_ = overlapBodies_.size();
+        overlapBodies_.insert(overlapBodies_.end(), begin, begin + range.size_);
+    }
+}
+
+void PhysicsWorld2D::ExecuteQueryBatch(PhysicsQueryBatch2D& batch)
+{
+    URHO3D_PROFILE("PhysicsQueryBatch2D");
+
+    if (!WorkQueue::IsProcessingThread())
+    {
+        URHO3D_LOGERROR("Physics query batch should be executed from main thread or WorkQueue thread");
+        return;
+    }
+
+    // Box2D queries use local traversal stacks and don't modify the world, so they can run concurrently
+    static const unsigned queryBatchSize = 32;
+
+    const unsigned numThreads = WorkQueue::GetThreadIndexCount();
+    batch.BeginExecution(numThreads);
+
+    const unsigned numCasts = batch.casts_.size();
+    const unsigned numQueries = numCasts + batch.overlaps_.size();
+    const b2World* world = world_.get();
+    auto* workQueue = GetSubsystem<WorkQueue>();
+    workQueue->ParallelFor(numQueries, queryBatchSize,
+        [&](unsigned beginIndex, unsigned endIndex, unsigned threadIndex)
+    {
+        ea::vector<RigidBody2D*>& threadBodies = batch.threadOverlapBodies_[threadIndex];
+        for (unsigned index = beginIndex; index < endIndex; ++index)
+        {
+            if (index < numCasts)
+            {
+                const PhysicsCastQuery2D& query = batch.casts_[index];
+                PhysicsRaycastResult2D& result = batch.castResults_[index];
+                result = GetEmptyRaycastResult2D();
+
+                if (query.radius_ > 0.0f)
+                {
+                    const Vector2 radius{query.radius_, query.radius_};
+                    b2AABB b2Aabb;
+                    b2Aabb.lowerBound = ToB2Vec2(VectorMin(query.startPoint_, query.endPoint_) - radius);
+                    b2Aabb.upperBound = ToB2Vec2(VectorMax(query.startPoint_, query.endPoint_) + radius);
+
+                    CircleCastCallback callback(result, query);
+                    world->QueryAABB(&callback, b2Aabb);
+                }
+                else
+                {
+                    SingleRayCastCallback callback(result, query.startPoint_, query.collisionMask_);
+                    world->RayCast(&callback, ToB2Vec2(query.startPoint_), ToB2Vec2(query.endPoint_));
+                }
+            }
+            else
+            {
+                const PhysicsOverlapQuery2D& query = batch.overlaps_[index - numCasts];
+                PhysicsQueryBatch2D::OverlapRange& range = batch.overlapRanges_[index - numCasts];
+                range.threadIndex_ = threadIndex;
+                range.offset_ = threadBodies.size();
+
+                AabbQueryCallback callback(threadBodies, query.collisionMask_);
+                world->QueryAABB(&callback, ToQueryAabb(query.aabb_));
+
+                range.size_ = threadBodies.size() - range.offset_;
+            }
+        }
+    });
+
+    batch.EndExecution();
 }
 
 bool PhysicsWorld2D::GetAllowSleeping() const
@@ -27,6 +27,8 @@
 
 #include <Box2D/Box2D.h>
 
+#include <EASTL/span.h>
+
 namespace Urho3D
 {
 
@@ -53,6 +55,90 @@ struct URHO3D_API PhysicsRaycastResult2D
     RigidBody2D* body_{};
 };
 
+/// Swept query in PhysicsQueryBatch2D.
+struct PhysicsCastQuery2D
+{
+    /// Start point.
+    Vector2 startPoint_;
+    /// End point.
+    Vector2 endPoint_;
+    /// Radius of the circle cast. Zero for raycast.
+    float radius_{};
+    /// Collision mask.
+    unsigned collisionMask_{};
+};
+
+/// Overlap query in PhysicsQueryBatch2D.
+struct PhysicsOverlapQuery2D
+{
+    /// Query box.
+    Rect aabb_;
+    /// Collision mask.
+    unsigned collisionMask_{};
+};
+
+/// Batch of 2D physics world queries that are executed together by PhysicsWorld2D::ExecuteQueryBatch.
+/// Casts return the closest hit each. Overlaps return ranges in the flat buffer of rigid bodies.
+/// Results are stored in the order of submission and are not affected by the number of worker threads.
+class URHO3D_API PhysicsQueryBatch2D
+{
+    friend class PhysicsWorld2D;
+
+public:
+    /// Add raycast and return index of the cast result.
+    unsigned AddRaycast(const Vector2& startPoint, const Vector2& endPoint, unsigned collisionMask = M_MAX_UNSIGNED);
+    /// Add swept circle test and return index of the cast result. Shapes overlapping the circle at start are not hit.
+    unsigned AddCircleCast(const Vector2& startPoint, const Vector2& endPoint, float radius,
+        unsigned collisionMask = M_MAX_UNSIGNED);
+    /// Add box overlap query and return index of the overlap result.
+    unsigned AddOverlap(const Rect& aabb, unsigned collisionMask = M_MAX_UNSIGNED);
+    /// Remove all queries and results. Memory is kept for reuse.
+    void Clear();
+
+    /// Return number of cast queries.
+    unsigned GetNumCasts() const { return casts_.size(); }
+    /// Return number of overlap queries.
+    unsigned GetNumOverlaps() const { return overlaps_.size(); }
+    /// Return results of all cast queries.
+    const ea::vector<PhysicsRaycastResult2D>& GetCastResults() const { return castResults_; }
+    /// Return result of the cast query.
+    const PhysicsRaycastResult2D& GetCastResult(unsigned index) const { return castResults_[index]; }
+    /// Return rigid bodies found by the overlap query.
+    ea::span<RigidBody2D* const> GetOverlapResult(unsigned index) const;
+    /// Return rigid bodies found by all overlap queries, stored one query after another.
+    const ea::vector<RigidBody2D*>& GetOverlapBodies() const { return overlapBodies_; }
+
+private:
+    /// Range of the overlap result in the buffer.
+    struct OverlapRange
+    {
+        /// Index of the thread that executed the query.
+        unsigned threadIndex_{};
+        /// Offset in the buffer.
+        unsigned offset_{};
+        /// Number of rigid bodies.
+        unsigned size_{};
+    };
+
+    /// Allocate results before execution.
+    void BeginExecution(unsigned numThreads);
+    /// Gather overlap results from per-thread buffers after execution.
+    void EndExecution();
+
+    /// Cast queries.
+    ea::vector<PhysicsCastQuery2D> casts_;
+    /// Overlap queries.
+    ea::vector<PhysicsOverlapQuery2D> overlaps_;
+    /// Results of cast queries.
+    ea::vector<PhysicsRaycastResult2D> castResults_;
+    /// Ranges of overlap results in the buffer.
+    ea::vector<OverlapRange> overlapRanges_;
+    /// Rigid bodies found by overlap queries.
+    ea::vector<RigidBody2D*> overlapBodies_;
+    /// Per-thread buffers for overlap results.
+    ea::vector<ea::vector<RigidBody2D*>> threadOverlapBodies_;
+};
+
 /// Delayed world transform assignment for parented 2D rigidbodies.
 struct DelayedWorldTransform2D
 {
@@ -172,6 +258,8 @@ public:
     RigidBody2D* GetRigidBody(int screenX, int screenY, unsigned collisionMask = M_MAX_UNSIGNED);
     /// Return rigid bodies by a box query.
     void GetRigidBodies(ea::vector<RigidBody2D*>& results, const Rect& aabb, unsigned collisionMask = M_MAX_UNSIGNED);
+    /// Execute batch of queries in parallel on WorkQueue threads. Should not be called during simulation step.
+    void ExecuteQueryBatch(PhysicsQueryBatch2D& batch);
 
     /// Return whether physics world will automatically simulate during scene update.
     /// @property
@@ -30,9 +30,10 @@ Diligent::VALUE_TYPE GetIndexType(RawBuffer* indexBuffer)
 RawTexture* GetReadableTexture(
     RenderContext* renderContext, TextureType type, RawTexture* texture, RawTexture* backupTexture)
 {
-    if (texture && !renderContext->IsBoundAsRenderTarget(texture))
+    // Texture may be unloaded by ResourceCache
+    if (texture && texture->GetHandles() && !renderContext->IsBoundAsRenderTarget(texture))
         return texture;
-    else if (backupTexture && !renderContext->IsBoundAsRenderTarget(backupTexture))
+    else if (backupTexture && backupTexture->GetHandles() && !renderContext->IsBoundAsRenderTarget(backupTexture))
         return backupTexture;
     else
         return renderContext->GetRenderDevice()->GetDefaultTexture(type);
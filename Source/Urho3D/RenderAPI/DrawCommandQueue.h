@@ -169,6 +169,9 @@ public:
         if (!shaderParameter || !shaderParameter->variable_)
             return;
 
+        if (texture)
+            texture->RequestRestoreIfUnloaded();
+
         shaderResources_.push_back(ShaderResourceData{shaderParameter->variable_, texture, backupTexture, type});
         ++currentShaderResourceGroup_.second;
     }
@@ -391,6 +391,14 @@ void PipelineState::Destroy()
 
 void PipelineState::CreateGPU()
 {
+    // Without render device the pipeline state is only a CPU-side placeholder with empty reflection
+    if (!renderDevice_)
+    {
+        DestroyGPU();
+        reflection_ = MakeShared<ShaderProgramReflection>(ea::span<Diligent::IShader* const>{});
+        return;
+    }
+
     if (const GraphicsPipelineStateDesc* graphicsDesc = desc_.AsGraphics())
         CreateGPU(*graphicsDesc);
     else if (const ComputePipelineStateDesc* computeDesc = desc_.AsCompute())
@@ -63,7 +63,7 @@ void RawShader::CreateGPU()
 {
     DestroyGPU();
 
-    if (bytecode_.IsEmpty())
+    if (bytecode_.IsEmpty() || !renderDevice_)
         return;
 
     Diligent::ShaderCreateInfo createInfo;
@@ -365,6 +365,12 @@ void RawTexture::Destroy()
     DestroyGPU();
 }
 
+void RawTexture::Unload()
+{
+    DestroyGPU();
+    unloaded_ = true;
+}
+
 Diligent::ITextureView* RawTexture::CreateUAV(const RawTextureUAVKey& key)
 {
     if (!handles_)
@@ -438,6 +444,7 @@ bool RawTexture::Create(const RawTextureParams& params)
     Destroy();
 
     params_ = params;
+    unloaded_ = false;
 
     if (!ValidateBindings(params_))
         return false;
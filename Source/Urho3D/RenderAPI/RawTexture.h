@@ -176,6 +176,16 @@ public:
     const RawTextureHandles& GetHandles() const { return handles_; }
     /// @}
 
+    /// Return whether GPU data was unloaded to save memory.
+    bool IsUnloaded() const { return unloaded_; }
+    /// Request restoring of GPU data if it was unloaded. Called automatically when the texture is bound for rendering.
+    /// Data is not restored immediately, backup or default texture is used until then.
+    void RequestRestoreIfUnloaded()
+    {
+        if (unloaded_)
+            OnRestoreRequested();
+    }
+
     /// Internal.
     /// @{
     bool GetLevelsDirty() const { return levelsDirty_; }
@@ -192,6 +202,8 @@ protected:
     bool CreateGPU();
     /// Destroy all GPU resources.
     void DestroyGPU();
+    /// Destroy all GPU resources until the texture is recreated. OnRestoreRequested is called when the texture is bound.
+    void Unload();
 
     /// Called when GPU handles are created.
     virtual void OnCreateGPU() {}
@@ -199,6 +211,8 @@ protected:
     virtual void OnDestroyGPU() {}
     /// Try to recover texture data after device loss.
     virtual bool TryRestore() { return false; }
+    /// Called when unloaded texture is used for rendering.
+    virtual void OnRestoreRequested() {}
 
 private:
     bool InitializeDefaultViews(Diligent::BIND_FLAGS bindFlags);
@@ -212,6 +226,7 @@ private:
 
     bool levelsDirty_{};
     bool resolveDirty_{};
+    bool unloaded_{};
 };
 
 } // namespace Urho3D
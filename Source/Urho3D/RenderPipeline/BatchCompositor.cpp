@@ -441,7 +441,7 @@ void BatchCompositor::FinalizeShadowBatchesComposition()
         {
             workQueue_->PostTask([=](unsigned threadIndex)
             {
-                lightProcessor->GetMutableSplit(splitIndex)->FinalizeShadowBatches();
+                lightProcessor->GetMutableSplit(splitIndex)->FinalizeShadowBatches(workQueue_);
             }, TaskPriority::Immediate);
         }
     }
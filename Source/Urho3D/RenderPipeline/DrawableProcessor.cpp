@@ -286,24 +286,49 @@ void DrawableProcessor::ProcessVisibleDrawables(const ea::vector<Drawable*>& dra
 {
     URHO3D_PROFILE("ProcessVisibleDrawables");
 
-    ForEachParallel(workQueue_, drawables,
-        [&](unsigned /*index*/, Drawable* drawable)
+    if (occlusionBuffers.empty())
+    {
+        ForEachParallel(workQueue_, drawables,
+            [&](unsigned /*index*/, Drawable* drawable)
+        {
+            ProcessVisibleDrawable(drawable);
+        });
+    }
+    else
     {
-        // do occlusion test for occludees if possible
-        if (!occlusionBuffers.empty() && drawable->IsOccludee())
+        static constexpr unsigned occlusionBatchSize = 32;
+        ForEachParallel(workQueue_, occlusionBatchSize, drawables.size(),
+            [&](unsigned beginIndex, unsigned endIndex)
         {
-            // check for visible
-            bool anyPass = false;
-            // may have multiple buffers in stereo and possibly for other cases such as lightspace shadowcaster occlusion, likely not applicable here
-            for (auto o : occlusionBuffers)
-                anyPass |= o->IsVisible(drawable->GetWorldBoundingBox());
+            // Test occludees in batches
+            Drawable* occludees[occlusionBatchSize];
+            BoundingBox boundingBoxes[occlusionBatchSize];
+            bool isVisible[occlusionBatchSize]{};
+            unsigned numOccludees = 0;
+            for (unsigned i = beginIndex; i < endIndex; ++i)
+            {
+                Drawable* drawable = drawables[i];
+                if (drawable->IsOccludee())
+                {
+                    occludees[numOccludees] = drawable;
+                    boundingBoxes[numOccludees] = drawable->GetWorldBoundingBox();
+                    ++numOccludees;
+                }
+                else
+                    ProcessVisibleDrawable(drawable);
+            }
 
-            if (!anyPass)
-                return;
-        }
+            // May have multiple buffers in stereo and possibly for other cases such as lightspace shadowcaster occlusion
+            for (OcclusionBuffer* occlusionBuffer : occlusionBuffers)
+                occlusionBuffer->AreVisible({boundingBoxes, numOccludees}, {isVisible, numOccludees});
 
-        ProcessVisibleDrawable(drawable);
-    });
+            for (unsigned i = 0; i < numOccludees; ++i)
+            {
+                if (isVisible[i])
+                    ProcessVisibleDrawable(occludees[i]);
+            }
+        });
+    }
 
     // Sort lights by component ID for stability
     lights_.resize(lightsTemp_.Size());
@@ -409,6 +434,19 @@ void DrawableProcessor::QueueDrawableGeometryUpdate(unsigned threadIndex, Drawab
         threadedGeometryUpdates_.PushBack(threadIndex, drawable);
 }
 
+void DrawableProcessor::MarkMaterialUsed(Material* material)
+{
+    // Skip if already marked in this frame
+    if (!material->MarkUsed(frameInfo_.frameNumber_))
+        return;
+
+    for (const auto& item : material->GetTextures())
+    {
+        if (Texture* texture = item.second.value_)
+            texture->MarkUsed(frameInfo_.frameNumber_);
+    }
+}
+
 void DrawableProcessor::CheckMaterialForAuxiliaryRenderSurfaces(Material* material)
 {
     // Skip if already checked or not main viewport
@@ -504,6 +542,7 @@ void DrawableProcessor::ProcessVisibleDrawable(Drawable* drawable)
 
             // Check for aux views
             CheckMaterialForAuxiliaryRenderSurfaces(sourceBatch.material_);
+            MarkMaterialUsed(material);
 
             // Update scene passes
             for (DrawableProcessorPass* pass : passes_)
@@ -243,6 +243,7 @@ protected:
     void QueueDrawableUpdate(Drawable* drawable);
     void QueueDrawableGeometryUpdate(unsigned threadIndex, Drawable* drawable);
     void CheckMaterialForAuxiliaryRenderSurfaces(Material* material);
+    void MarkMaterialUsed(Material* material);
 
     FloatRange CalculateBoundingBoxZRange(const BoundingBox& boundingBox) const;
 
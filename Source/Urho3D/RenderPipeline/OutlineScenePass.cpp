@@ -151,7 +151,7 @@ void OutlineScenePass::OnBatchesReady()
     }
 
     BatchCompositor::FillSortKeys(sortedBatches_, deferredBatches_);
-    ea::sort(sortedBatches_.begin(), sortedBatches_.end());
+    batchSorter_.Sort(workQueue_, sortedBatches_);
 
     batchGroup_ = {sortedBatches_};
     batchGroup_.flags_ = BatchRenderFlag::EnableInstancingForStaticGeometry;
@@ -25,6 +25,7 @@
 #include "../Graphics/OutlineGroup.h"
 #include "../RenderPipeline/DrawableProcessor.h"
 #include "../RenderPipeline/PipelineBatchSortKey.h"
+#include "../RenderPipeline/PipelineBatchSorter.h"
 #include "../RenderPipeline/PipelineStateBuilder.h"
 #include "../RenderPipeline/RenderBuffer.h"
 #include "../RenderPipeline/RenderPipelineDefs.h"
@@ -70,6 +71,7 @@ private:
     /// @{
     ShaderProgramDesc shaderProgramDesc_;
     ea::vector<PipelineBatchByState> sortedBatches_;
+    PipelineBatchSorter<PipelineBatchByState> batchSorter_;
     PipelineBatchGroup<PipelineBatchByState> batchGroup_;
     /// @}
 };
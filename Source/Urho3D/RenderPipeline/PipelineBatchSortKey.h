@@ -122,6 +122,9 @@ struct PipelineBatchByState
             return primaryKey_ < rhs.primaryKey_;
         return secondaryKey_ < rhs.secondaryKey_;
     }
+
+    /// Return primary and secondary keys for radix sort. Order is the same as for comparison operator.
+    ea::pair<unsigned long long, unsigned long long> GetRadixSortKeys() const { return {primaryKey_, secondaryKey_}; }
 };
 
 /// Pipeline batch sorted by render order and back to front.
@@ -152,6 +155,15 @@ struct PipelineBatchBackToFront
             return renderOrder_ < rhs.renderOrder_;
         return distance_ > rhs.distance_;
     }
+
+    /// Return primary and secondary keys for radix sort. Order is the same as for comparison operator.
+    ea::pair<unsigned long long, unsigned long long> GetRadixSortKeys() const
+    {
+        // Flip float bits so that unsigned integer order matches descending distance
+        const unsigned distanceBits = FloatToRawIntBits(distance_);
+        const unsigned ascendingBits = (distanceBits & 0x80000000u) ? ~distanceBits : (distanceBits | 0x80000000u);
+        return {(static_cast<unsigned long long>(renderOrder_) << 32ull) | ~ascendingBits, 0ull};
+    }
 };
 
 /// Group of batches to be rendered.
@@ -0,0 +1,162 @@
+//
+// Copyright (c) 2017-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "Urho3D/Precompiled.h"
+
+#include "Urho3D/RenderPipeline/PipelineBatchSorter.h"
+
+#include "Urho3D/Core/WorkQueue.h"
+
+#include <EASTL/sort.h>
+
+#include "Urho3D/DebugNew.h"
+
+namespace Urho3D
+{
+
+namespace
+{
+
+static constexpr unsigned RadixBits = 8;
+static constexpr unsigned NumBuckets = 1u << RadixBits;
+static constexpr unsigned DigitsPerKey = 64 / RadixBits;
+
+/// Small arrays are sorted by comparison.
+static constexpr unsigned MinItemsForRadixSort = 256;
+/// Min number of items processed by one thread.
+static constexpr unsigned MinItemsPerChunk = 8192;
+
+bool CompareItems(const RadixSortItem& lhs, const RadixSortItem& rhs)
+{
+    if (lhs.primaryKey_ != rhs.primaryKey_)
+        return lhs.primaryKey_ < rhs.primaryKey_;
+    return lhs.secondaryKey_ < rhs.secondaryKey_;
+}
+
+/// Return digit of the key. Digits of the secondary key go first.
+unsigned GetDigit(const RadixSortItem& item, unsigned digit)
+{
+    const unsigned long long key = digit < DigitsPerKey ? item.secondaryKey_ : item.primaryKey_;
+    const unsigned shift = (digit % DigitsPerKey) * RadixBits;
+    return static_cast<unsigned>(key >> shift) & (NumBuckets - 1);
+}
+
+}
+
+void RadixSorter::Sort(WorkQueue* workQueue)
+{
+    numPasses_ = 0;
+
+    const unsigned numItems = items_.size();
+    if (numItems < MinItemsForRadixSort)
+    {
+        ea::sort(items_.begin(), items_.end(), CompareItems);
+        return;
+    }
+
+    const unsigned maxChunks = workQueue ? WorkQueue::GetThreadIndexCount() : 1;
+    const unsigned numChunks = Clamp(numItems / MinItemsPerChunk, 1u, maxChunks);
+    const auto getChunkBegin = [&](unsigned chunkIndex)
+    { return static_cast<unsigned>(static_cast<unsigned long long>(numItems) * chunkIndex / numChunks); };
+    const auto forEachChunk = [&](const auto& callback)
+    {
+        if (numChunks == 1)
+            callback(0u, numItems, 0u);
+        else
+        {
+            workQueue->ParallelFor(numChunks, 1, [&](unsigned beginChunk, unsigned endChunk)
+            {
+                for (unsigned chunkIndex = beginChunk; chunkIndex < endChunk; ++chunkIndex)
+                    callback(getChunkBegin(chunkIndex), getChunkBegin(chunkIndex + 1), chunkIndex);
+            });
+        }
+    };
+
+    // Find bits that differ between keys, other bits don't affect the order
+    keyMasks_.resize(numChunks * 2);
+    forEachChunk([&](unsigned beginIndex, unsigned endIndex, unsigned chunkIndex)
+    {
+        RadixSortItem anyBits{0ull, 0ull};
+        RadixSortItem allBits{~0ull, ~0ull};
+        for (unsigned i = beginIndex; i < endIndex; ++i)
+        {
+            anyBits.primaryKey_ |= items_[i].primaryKey_;
+            anyBits.secondaryKey_ |= items_[i].secondaryKey_;
+            allBits.primaryKey_ &= items_[i].primaryKey_;
+            allBits.secondaryKey_ &= items_[i].secondaryKey_;
+        }
+        keyMasks_[chunkIndex * 2] = anyBits;
+        keyMasks_[chunkIndex * 2 + 1] = allBits;
+    });
+
+    RadixSortItem differentBits;
+    for (unsigned chunkIndex = 0; chunkIndex < numChunks; ++chunkIndex)
+    {
+        const RadixSortItem& anyBits = keyMasks_[chunkIndex * 2];
+        const RadixSortItem& allBits = keyMasks_[chunkIndex * 2 + 1];
+        differentBits.primaryKey_ |= anyBits.primaryKey_ ^ allBits.primaryKey_;
+        differentBits.secondaryKey_ |= anyBits.secondaryKey_ ^ allBits.secondaryKey_;
+    }
+
+    tempItems_.resize(numItems);
+    histograms_.resize(numChunks * NumBuckets);
+    for (unsigned digit = 0; digit < 2 * DigitsPerKey; ++digit)
+    {
+        if (GetDigit(differentBits, digit) == 0)
+            continue;
+
+        ++numPasses_;
+
+        forEachChunk([&](unsigned beginIndex, unsigned endIndex, unsigned chunkIndex)
+        {
+            unsigned* histogram = &histograms_[chunkIndex * NumBuckets];
+            ea::fill_n(histogram, NumBuckets, 0u);
+            for (unsigned i = beginIndex; i < endIndex; ++i)
+                ++histogram[GetDigit(items_[i], digit)];
+        });
+
+        // Chunks write buckets in chunk order to keep sort stable
+        unsigned offset = 0;
+        for (unsigned bucket = 0; bucket < NumBuckets; ++bucket)
+        {
+            for (unsigned chunkIndex = 0; chunkIndex < numChunks; ++chunkIndex)
+            {
+                unsigned& count = histograms_[chunkIndex * NumBuckets + bucket];
+                const unsigned bucketSize = count;
+                count = offset;
+                offset += bucketSize;
+            }
+        }
+
+        forEachChunk([&](unsigned beginIndex, unsigned endIndex, unsigned chunkIndex)
+        {
+            unsigned* offsets = &histograms_[chunkIndex * NumBuckets];
+            for (unsigned i = beginIndex; i < endIndex; ++i)
+                tempItems_[offsets[GetDigit(items_[i], digit)]++] = items_[i];
+        });
+
+        items_.swap(tempItems_);
+    }
+}
+
+}
@@ -0,0 +1,139 @@
+//
+// Copyright (c) 2017-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+/// \file
+
+#pragma once
+
+#include "Urho3D/Urho3D.h"
+
+#include <EASTL/algorithm.h>
+#include <EASTL/span.h>
+#include <EASTL/vector.h>
+
+namespace Urho3D
+{
+
+class WorkQueue;
+
+/// Item sorted by RadixSorter: 128-bit key and index of sorted element.
+struct RadixSortItem
+{
+    /// Most significant part of the key.
+    unsigned long long primaryKey_{};
+    /// Least significant part of the key.
+    unsigned long long secondaryKey_{};
+    /// Index of sorted element.
+    unsigned index_{};
+};
+
+/// Parallel LSD radix sort over 128-bit keys.
+/// Digits that are the same for all items are skipped, so sorting cost depends on actual key entropy.
+class URHO3D_API RadixSorter
+{
+public:
+    /// Sort items by key. Order of items with equal keys is unspecified.
+    void Sort(WorkQueue* workQueue);
+
+    /// Return items to be sorted.
+    ea::vector<RadixSortItem>& GetMutableItems() { return items_; }
+    /// Return sorted items.
+    const ea::vector<RadixSortItem>& GetItems() const { return items_; }
+    /// Return number of radix passes performed during last sort.
+    unsigned GetNumPasses() const { return numPasses_; }
+
+private:
+    /// Items.
+    ea::vector<RadixSortItem> items_;
+    /// Temporary buffer for items.
+    ea::vector<RadixSortItem> tempItems_;
+    /// Histograms of current digit for each chunk.
+    ea::vector<unsigned> histograms_;
+    /// OR and AND of the keys for each chunk.
+    ea::vector<RadixSortItem> keyMasks_;
+    /// Number of passes performed during last sort.
+    unsigned numPasses_{};
+};
+
+/// Sorts pipeline batches by radix key.
+/// Order from the previous sort is reused as is if batches are still sorted in this order.
+template <class T> class PipelineBatchSorter
+{
+public:
+    /// Sort batches.
+    void Sort(WorkQueue* workQueue, ea::span<T> batches)
+    {
+        const unsigned numBatches = batches.size();
+        orderReused_ = order_.size() == numBatches && IsSortedInOrder(batches);
+        if (!orderReused_)
+        {
+            ea::vector<RadixSortItem>& items = radixSorter_.GetMutableItems();
+            items.resize(numBatches);
+            for (unsigned i = 0; i < numBatches; ++i)
+            {
+                const auto [primaryKey, secondaryKey] = batches[i].GetRadixSortKeys();
+                items[i] = RadixSortItem{primaryKey, secondaryKey, i};
+            }
+
+            radixSorter_.Sort(workQueue);
+
+            order_.resize(numBatches);
+            for (unsigned i = 0; i < numBatches; ++i)
+                order_[i] = items[i].index_;
+        }
+
+        sortedBatches_.clear();
+        for (unsigned index : order_)
+            sortedBatches_.push_back(batches[index]);
+        ea::copy(sortedBatches_.begin(), sortedBatches_.end(), batches.begin());
+    }
+
+    /// Sort whole vector of batches.
+    void Sort(WorkQueue* workQueue, ea::vector<T>& batches) { Sort(workQueue, ea::span<T>(batches)); }
+
+    /// Return whether previous order was reused during last sort.
+    bool IsOrderReused() const { return orderReused_; }
+
+private:
+    /// Return whether the batches are sorted in previous order.
+    bool IsSortedInOrder(ea::span<const T> batches) const
+    {
+        for (unsigned i = 1; i < order_.size(); ++i)
+        {
+            if (batches[order_[i]] < batches[order_[i - 1]])
+                return false;
+        }
+        return true;
+    }
+
+    /// Radix sorter.
+    RadixSorter radixSorter_;
+    /// Indices of batches in sorted order.
+    ea::vector<unsigned> order_;
+    /// Temporary buffer for sorted batches.
+    ea::vector<T> sortedBatches_;
+    /// Whether previous order was reused.
+    bool orderReused_{};
+};
+
+}
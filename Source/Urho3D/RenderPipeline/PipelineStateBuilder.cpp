@@ -89,7 +89,8 @@ void PipelineStateBuilder::UpdateFrameSettings(bool linearColorSpace)
 SharedPtr<PipelineState> PipelineStateBuilder::CreateBatchPipelineState(
     const BatchStateCreateKey& key, const BatchStateCreateContext& ctx, const PipelineStateOutputDesc& outputDesc)
 {
-    const RenderDeviceCaps& caps = renderDevice_->GetCaps();
+    static const RenderDeviceCaps headlessCaps;
+    const RenderDeviceCaps& caps = renderDevice_ ? renderDevice_->GetCaps() : headlessCaps;
 
     Light* light = key.pixelLight_ ? key.pixelLight_->GetLight() : nullptr;
     const bool hasShadow = key.pixelLight_ && key.pixelLight_->HasShadow();
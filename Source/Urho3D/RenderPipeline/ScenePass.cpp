@@ -57,12 +57,14 @@ void UnorderedScenePass::OnBatchesReady()
     BatchCompositor::FillSortKeys(sortedBaseBatches_, baseBatches_);
     BatchCompositor::FillSortKeys(sortedLightBatches_, lightBatches_, negativeLightBatches_);
 
-    ea::sort(sortedDeferredBatches_.begin(), sortedDeferredBatches_.end());
-    ea::sort(sortedBaseBatches_.begin(), sortedBaseBatches_.end());
+    deferredBatchSorter_.Sort(workQueue_, sortedDeferredBatches_);
+    baseBatchSorter_.Sort(workQueue_, sortedBaseBatches_);
 
     const unsigned numNegativeLightBatches = negativeLightBatches_.Size();
-    ea::sort(sortedLightBatches_.begin(), sortedLightBatches_.end() - numNegativeLightBatches);
-    ea::sort(sortedLightBatches_.end() - numNegativeLightBatches, sortedLightBatches_.end());
+    const unsigned numPositiveLightBatches = sortedLightBatches_.size() - numNegativeLightBatches;
+    const ea::span<PipelineBatchByState> allLightBatches{sortedLightBatches_};
+    lightBatchSorter_.Sort(workQueue_, allLightBatches.subspan(0, numPositiveLightBatches));
+    negativeLightBatchSorter_.Sort(workQueue_, allLightBatches.subspan(numPositiveLightBatches));
 
     deferredBatchGroup_ = { sortedDeferredBatches_ };
     baseBatchGroup_ = { sortedBaseBatches_ };
@@ -131,7 +133,7 @@ void BackToFrontScenePass::OnBatchesReady()
     static const float additiveDistanceFactor = 1 - M_EPSILON;
     static const float subtractiveDistanceFactor = 1 - 2 * M_EPSILON;
 
-    // Validate distances before sorting, NaN may corrupt ea::sort
+    // Validate distances before sorting, NaN may corrupt sort order
     for (PipelineBatchBackToFront& sortedBatch : sortedBatches_)
     {
         if (std::isfinite(sortedBatch.distance_))
@@ -149,7 +151,7 @@ void BackToFrontScenePass::OnBatchesReady()
     for (unsigned i = subtractiveLightBatchesBegin; i < subtractiveLightBatchesEnd; ++i)
         sortedBatches_[i].distance_ *= subtractiveDistanceFactor;
 
-    ea::sort(sortedBatches_.begin(), sortedBatches_.end());
+    batchSorter_.Sort(workQueue_, sortedBatches_);
 
     if (GetFlags().Test(DrawableProcessorPassFlag::RefractionPass))
     {
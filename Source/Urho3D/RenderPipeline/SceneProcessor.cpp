@@ -191,12 +191,12 @@ SceneProcessor::SceneProcessor(RenderPipelineInterface* renderPipeline, const ea
     : Object(renderPipeline->GetContext())
     , graphics_(GetSubsystem<Graphics>())
     , renderDevice_(GetSubsystem<RenderDevice>())
-    , renderContext_(renderDevice_->GetRenderContext())
+    , renderContext_(renderDevice_ ? renderDevice_->GetRenderContext() : nullptr)
     , renderPipeline_(renderPipeline)
     , debugger_(renderPipeline_->GetDebugger())
     , shadowMapAllocator_(shadowMapAllocator)
     , instancingBuffer_(instancingBuffer)
-    , drawQueue_(renderDevice_->GetDefaultQueue())
+    , drawQueue_(renderDevice_ ? renderDevice_->GetDefaultQueue() : nullptr)
     , cameraProcessor_(MakeShared<CameraProcessor>(context_))
     , pipelineStateBuilder_(MakeShared<PipelineStateBuilder>(context_,
         this, cameraProcessor_, shadowMapAllocator_, instancingBuffer_))
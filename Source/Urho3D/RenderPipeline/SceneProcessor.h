@@ -44,7 +44,8 @@ class Viewport;
 struct ShaderParameterDesc;
 struct ShaderResourceDesc;
 
-/// Scene processor for RenderPipeline
+/// Scene processor for RenderPipeline.
+/// Without render device only CPU stages are supported: Update, PrepareDrawablesBeforeRendering and PrepareInstancingBuffer.
 class URHO3D_API SceneProcessor : public Object, public LightProcessorCallback
 {
     URHO3D_OBJECT(SceneProcessor, Object);
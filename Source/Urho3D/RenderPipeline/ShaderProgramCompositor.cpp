@@ -142,7 +142,9 @@ void ShaderProgramCompositor::SetupShaders(ShaderProgramDesc& result, Pass* pass
 void ShaderProgramCompositor::ApplyCommonDefines(ShaderProgramDesc& result,
     DrawableProcessorPassFlags flags, Pass* pass) const
 {
-    const RenderDeviceCaps& caps = GetSubsystem<RenderDevice>()->GetCaps();
+    static const RenderDeviceCaps headlessCaps;
+    auto renderDevice = GetSubsystem<RenderDevice>();
+    const RenderDeviceCaps& caps = renderDevice ? renderDevice->GetCaps() : headlessCaps;
     const bool canReadDepth = settings_.renderBufferManager_.readableDepth_ && caps.readOnlyDepth_;
 
     if (isCameraReversed_)
@@ -50,7 +50,7 @@ ShadowMapRegion ShadowMapRegion::GetSplit(unsigned split, const IntVector2& numS
 ShadowMapAllocator::ShadowMapAllocator(Context* context)
     : Object(context)
     , renderDevice_(context_->GetSubsystem<RenderDevice>())
-    , renderContext_(renderDevice_->GetRenderContext())
+    , renderContext_(renderDevice_ ? renderDevice_->GetRenderContext() : nullptr)
 {
     CacheSettings();
 }
@@ -68,14 +68,15 @@ void ShadowMapAllocator::SetSettings(const ShadowMapAllocatorSettings& settings)
 
 void ShadowMapAllocator::CacheSettings()
 {
-    auto renderDevice = GetSubsystem<RenderDevice>();
+    const TextureFormat depthFormat =
+        renderDevice_ ? renderDevice_->GetDefaultDepthFormat() : TextureFormat::TEX_FORMAT_D24_UNORM_S8_UINT;
 
     shadowOutputDesc_ = {};
     if (settings_.enableVarianceShadowMaps_)
     {
         shadowMapFormat_ = TextureFormat::TEX_FORMAT_RG32_FLOAT;
 
-        shadowOutputDesc_.depthStencilFormat_ = renderDevice->GetDefaultDepthFormat();
+        shadowOutputDesc_.depthStencilFormat_ = depthFormat;
         shadowOutputDesc_.numRenderTargets_ = 1;
         shadowOutputDesc_.renderTargetFormats_[0] = shadowMapFormat_;
         shadowOutputDesc_.multiSample_ = settings_.varianceShadowMapMultiSample_;
@@ -84,7 +85,7 @@ void ShadowMapAllocator::CacheSettings()
     {
         shadowMapFormat_ = settings_.use16bitShadowMaps_ //
             ? TextureFormat::TEX_FORMAT_D16_UNORM //
-            : renderDevice->GetDefaultDepthFormat();
+            : depthFormat;
 
         shadowOutputDesc_.depthStencilFormat_ = shadowMapFormat_;
         shadowOutputDesc_.numRenderTargets_ = 0;
@@ -364,10 +364,10 @@ Matrix4 ShadowSplitProcessor::GetWorldToShadowSpaceMatrix(float subPixelOffset)
     return texAdjust * shadowProj * shadowView;
 }
 
-void ShadowSplitProcessor::FinalizeShadowBatches()
+void ShadowSplitProcessor::FinalizeShadowBatches(WorkQueue* workQueue)
 {
     BatchCompositor::FillSortKeys(sortedShadowBatches_, unsortedShadowBatches_);
-    ea::sort(sortedShadowBatches_.begin(), sortedShadowBatches_.end());
+    shadowBatchSorter_.Sort(workQueue, sortedShadowBatches_);
     shadowBatches_ = { sortedShadowBatches_,
         BatchRenderFlag::EnableInstancingForStaticGeometry | BatchRenderFlag::DisableColorOutput };
 }
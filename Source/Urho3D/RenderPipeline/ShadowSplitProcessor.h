@@ -26,6 +26,7 @@
 #include "../Math/NumericRange.h"
 #include "../RenderPipeline/RenderPipelineDefs.h"
 #include "../RenderPipeline/PipelineBatchSortKey.h"
+#include "../RenderPipeline/PipelineBatchSorter.h"
 #include "../Scene/Node.h"
 
 #include <EASTL/vector.h>
@@ -65,7 +66,7 @@ public:
     /// @}
 
     void FinalizeShadow(const ShadowMapRegion& shadowMap, unsigned pcfKernelSize);
-    void FinalizeShadowBatches();
+    void FinalizeShadowBatches(WorkQueue* workQueue);
 
     /// Return immutable
     /// @{
@@ -131,6 +132,7 @@ private:
     /// @{
     ea::vector<PipelineBatch> unsortedShadowBatches_;
     ea::vector<PipelineBatchByState> sortedShadowBatches_;
+    PipelineBatchSorter<PipelineBatchByState> shadowBatchSorter_;
     PipelineBatchGroup<PipelineBatchByState> shadowBatches_;
     /// @}
 };
@@ -244,6 +244,20 @@ ea::optional<NetworkObjectRelevance> BehaviorNetworkObject::GetRelevanceForClien
     return ea::nullopt;
 }
 
+ea::optional<float> BehaviorNetworkObject::GetRelevanceDistance() const
+{
+    // Only the first behavior is guaranteed to be asked for relevance
+    if (callbackMask_.Test(NetworkCallbackMask::GetRelevanceForClient))
+    {
+        for (const auto& connectedBehavior : behaviors_)
+        {
+            if (connectedBehavior.callbackMask_.Test(NetworkCallbackMask::GetRelevanceForClient))
+                return connectedBehavior.component_->GetRelevanceDistance();
+        }
+    }
+    return ea::nullopt;
+}
+
 void BehaviorNetworkObject::UpdateTransformOnServer()
 {
     BaseClassName::UpdateTransformOnServer();
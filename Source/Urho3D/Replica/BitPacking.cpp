@@ -0,0 +1,219 @@
+// Copyright (c) 2025-2025 the rbfx project.
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT> or the accompanying LICENSE file.
+
+#include "Urho3D/Precompiled.h"
+
+#include "Urho3D/Replica/BitPacking.h"
+
+#include "Urho3D/IO/Deserializer.h"
+#include "Urho3D/IO/Serializer.h"
+
+namespace Urho3D
+{
+
+namespace
+{
+
+/// Quantized values are clamped so zigzag encoding of deltas never overflows.
+static constexpr int MaxQuantizedValue = (1 << 29) - 1;
+
+/// Number of bits used to store number of bits of variable-length integer.
+static constexpr unsigned VarIntLengthBits = 5;
+
+static constexpr float Sqrt2 = 1.41421356f;
+
+int QuantizeFloat(float value, float step)
+{
+    const double maxValue = MaxQuantizedValue;
+    return RoundToInt(Clamp(static_cast<double>(value) / step, -maxValue, maxValue));
+}
+
+}
+
+void BitWriter::WriteBits(unsigned value, unsigned numBits)
+{
+    URHO3D_ASSERT(numBits <= 32);
+    if (numBits == 0)
+        return;
+
+    const unsigned long long mask = (1ull << numBits) - 1;
+    buffer_ |= (value & mask) << numBits_;
+    numBits_ += numBits;
+
+    while (numBits_ >= 8)
+    {
+        dest_.WriteUByte(static_cast<unsigned char>(buffer_ & 0xff));
+        buffer_ >>= 8;
+        numBits_ -= 8;
+    }
+}
+
+void BitWriter::WriteVarInt(int value)
+{
+    // Zigzag encoding keeps small negative values small
+    const auto zigzag = (static_cast<unsigned>(value) << 1) ^ static_cast<unsigned>(value >> 31);
+    const unsigned numBits = zigzag != 0 ? LogBaseTwo(zigzag) + 1 : 0;
+    URHO3D_ASSERT(numBits < (1u << VarIntLengthBits));
+
+    WriteBits(numBits, VarIntLengthBits);
+    WriteBits(zigzag, numBits);
+}
+
+void BitWriter::Flush()
+{
+    if (numBits_ > 0)
+    {
+        dest_.WriteUByte(static_cast<unsigned char>(buffer_ & 0xff));
+        buffer_ = 0;
+        numBits_ = 0;
+    }
+}
+
+unsigned BitReader::ReadBits(unsigned numBits)
+{
+    URHO3D_ASSERT(numBits <= 32);
+    if (numBits == 0)
+        return 0;
+
+    while (numBits_ < numBits)
+    {
+        buffer_ |= static_cast<unsigned long long>(src_.ReadUByte()) << numBits_;
+        numBits_ += 8;
+    }
+
+    const unsigned long long mask = (1ull << numBits) - 1;
+    const auto value = static_cast<unsigned>(buffer_ & mask);
+    buffer_ >>= numBits;
+    numBits_ -= numBits;
+    return value;
+}
+
+int BitReader::ReadVarInt()
+{
+    const unsigned numBits = ReadBits(VarIntLengthBits);
+    const unsigned zigzag = ReadBits(numBits);
+    return static_cast<int>(zigzag >> 1) ^ -static_cast<int>(zigzag & 1);
+}
+
+IntVector3 QuantizeVector3(const Vector3& value, float step)
+{
+    return {QuantizeFloat(value.x_, step), QuantizeFloat(value.y_, step), QuantizeFloat(value.z_, step)};
+}
+
+Vector3 DequantizeVector3(const IntVector3& value, float step)
+{
+    return {value.x_ * step, value.y_ * step, value.z_ * step};
+}
+
+void WriteQuantizedVector3(BitWriter& dest, const IntVector3& value)
+{
+    dest.WriteVarInt(value.x_);
+    dest.WriteVarInt(value.y_);
+    dest.WriteVarInt(value.z_);
+}
+
+IntVector3 ReadQuantizedVector3(BitReader& src)
+{
+    IntVector3 value;
+    value.x_ = src.ReadVarInt();
+    value.y_ = src.ReadVarInt();
+    value.z_ = src.ReadVarInt();
+    return value;
+}
+
+void WriteCompressedQuaternion(BitWriter& dest, const Quaternion& value, unsigned bitsPerComponent)
+{
+    const Quaternion rotation = value.Normalized();
+    const float* components = rotation.Data();
+
+    unsigned largestIndex = 0;
+    for (unsigned i = 1; i < 4; ++i)
+    {
+        if (Abs(components[i]) > Abs(components[largestIndex]))
+            largestIndex = i;
+    }
+
+    // Quaternion and its negation represent the same rotation, so the largest component is always positive
+    const float sign = components[largestIndex] < 0.0f ? -1.0f : 1.0f;
+    const auto maxValue = static_cast<float>((1u << bitsPerComponent) - 1);
+
+    dest.WriteBits(largestIndex, 2);
+    for (unsigned i = 0; i < 4; ++i)
+    {
+        if (i == largestIndex)
+            continue;
+
+        // Other components are within [-1/sqrt(2), 1/sqrt(2)]
+        const float normalized = Clamp((components[i] * sign * Sqrt2 + 1.0f) * 0.5f, 0.0f, 1.0f);
+        dest.WriteBits(static_cast<unsigned>(RoundToInt(normalized * maxValue)), bitsPerComponent);
+    }
+}
+
+Quaternion ReadCompressedQuaternion(BitReader& src, unsigned bitsPerComponent)
+{
+    const auto maxValue = static_cast<float>((1u << bitsPerComponent) - 1);
+    const unsigned largestIndex = src.ReadBits(2);
+
+    float components[4]{};
+    float sumSquares = 0.0f;
+    for (unsigned i = 0; i < 4; ++i)
+    {
+        if (i == largestIndex)
+            continue;
+
+        const float normalized = src.ReadBits(bitsPerComponent) / maxValue;
+        components[i] = (normalized * 2.0f - 1.0f) / Sqrt2;
+        sumSquares += components[i] * components[i];
+    }
+    components[largestIndex] = Sqrt(Max(0.0f, 1.0f - sumSquares));
+
+    return Quaternion(components[0], components[1], components[2], components[3]).Normalized();
+}
+
+void QuantizedVector3Baseline::Update(NetworkFrame frame, const IntVector3& value, unsigned interval)
+{
+    if (!frame_ || interval == 0 || frame - *frame_ >= static_cast<long long>(interval))
+    {
+        frame_ = frame;
+        value_ = value;
+    }
+}
+
+void QuantizedVector3Baseline::Write(BitWriter& dest, NetworkFrame frame, const IntVector3& value) const
+{
+    const bool isAbsolute = !frame_ || *frame_ == frame;
+    dest.WriteBool(isAbsolute);
+    if (isAbsolute)
+    {
+        WriteQuantizedVector3(dest, value);
+    }
+    else
+    {
+        dest.WriteVarInt(static_cast<int>(frame - *frame_));
+        WriteQuantizedVector3(dest, value - value_);
+    }
+}
+
+ea::optional<IntVector3> QuantizedVector3Baseline::Read(BitReader& src, NetworkFrame frame)
+{
+    const bool isAbsolute = src.ReadBool();
+    if (isAbsolute)
+    {
+        const IntVector3 value = ReadQuantizedVector3(src);
+        if (!frame_ || frame > *frame_)
+        {
+            frame_ = frame;
+            value_ = value;
+        }
+        return value;
+    }
+
+    const NetworkFrame baselineFrame = frame - src.ReadVarInt();
+    const IntVector3 delta = ReadQuantizedVector3(src);
+    if (frame_ != baselineFrame)
+        return ea::nullopt;
+    return value_ + delta;
+}
+
+} // namespace Urho3D
@@ -0,0 +1,92 @@
+// Copyright (c) 2025-2025 the rbfx project.
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT> or the accompanying LICENSE file.
+
+#pragma once
+
+#include "Urho3D/Math/Quaternion.h"
+#include "Urho3D/Math/Vector3.h"
+#include "Urho3D/Replica/NetworkId.h"
+
+#include <EASTL/optional.h>
+
+namespace Urho3D
+{
+
+class Deserializer;
+class Serializer;
+
+/// Writes values bit by bit. Bits are flushed to the serializer byte by byte,
+/// the last byte is padded with zeros on Flush or destruction.
+class URHO3D_API BitWriter : public NonCopyable
+{
+public:
+    explicit BitWriter(Serializer& dest) : dest_(dest) {}
+    ~BitWriter() { Flush(); }
+
+    /// Write lower bits of the value. Up to 32 bits.
+    void WriteBits(unsigned value, unsigned numBits);
+    void WriteBool(bool value) { WriteBits(value ? 1 : 0, 1); }
+    /// Write signed integer with variable number of bits. Small values take fewer bits.
+    void WriteVarInt(int value);
+    /// Write incomplete byte if any.
+    void Flush();
+
+private:
+    Serializer& dest_;
+    unsigned long long buffer_{};
+    unsigned numBits_{};
+};
+
+/// Reads values written by BitWriter. Bytes are consumed from the deserializer only when needed,
+/// so the reader consumes exactly as many bytes as the writer has produced.
+class URHO3D_API BitReader : public NonCopyable
+{
+public:
+    explicit BitReader(Deserializer& src) : src_(src) {}
+
+    /// Read bits. Up to 32 bits.
+    unsigned ReadBits(unsigned numBits);
+    bool ReadBool() { return ReadBits(1) != 0; }
+    /// Read signed integer written by WriteVarInt.
+    int ReadVarInt();
+
+private:
+    Deserializer& src_;
+    unsigned long long buffer_{};
+    unsigned numBits_{};
+};
+
+/// Fixed-point quantization of vectors. Step is the size of quantization interval.
+/// @{
+URHO3D_API IntVector3 QuantizeVector3(const Vector3& value, float step);
+URHO3D_API Vector3 DequantizeVector3(const IntVector3& value, float step);
+URHO3D_API void WriteQuantizedVector3(BitWriter& dest, const IntVector3& value);
+URHO3D_API IntVector3 ReadQuantizedVector3(BitReader& src);
+/// @}
+
+/// Smallest-three compression of rotation: index of the largest component and other three components.
+/// @{
+URHO3D_API void WriteCompressedQuaternion(BitWriter& dest, const Quaternion& value, unsigned bitsPerComponent);
+URHO3D_API Quaternion ReadCompressedQuaternion(BitReader& src, unsigned bitsPerComponent);
+/// @}
+
+/// Baseline of delta encoding for quantized vector.
+/// Server and client maintain the same baseline: the latest frame sent as absolute value.
+/// Deltas against unknown baseline cannot be decoded and are dropped until the next absolute value.
+struct URHO3D_API QuantizedVector3Baseline
+{
+    /// Update baseline on server. Value becomes new baseline if there is no baseline or it's older than interval.
+    void Update(NetworkFrame frame, const IntVector3& value, unsigned interval);
+    /// Reset baseline on server so the next updated value is sent as absolute value.
+    void Reset() { frame_ = ea::nullopt; }
+    /// Write absolute value if it's baseline for this frame, delta against baseline otherwise.
+    void Write(BitWriter& dest, NetworkFrame frame, const IntVector3& value) const;
+    /// Read absolute value or delta. Return null if delta cannot be decoded.
+    ea::optional<IntVector3> Read(BitReader& src, NetworkFrame frame);
+
+    ea::optional<NetworkFrame> frame_;
+    IntVector3 value_;
+};
+
+} // namespace Urho3D
@@ -59,14 +59,10 @@ ea::optional<NetworkObjectRelevance> FilteredByDistance::GetRelevanceForClient(A
 
     ReplicationManager* replicationManager = GetNetworkObject()->GetReplicationManager();
     ServerReplicator* serverReplicator = replicationManager->GetServerReplicator();
-    const auto& ownedObjects = serverReplicator->GetNetworkObjectsOwnedByConnection(connection);
+    const NetworkInterestIndex& interestIndex = serverReplicator->GetInterestIndex();
 
-    float distanceToConnectionObjects = M_LARGE_VALUE;
-    for (NetworkObject* networkObject : ownedObjects)
-    {
-        if (const auto distance = networkObject->CalculateDistanceForFiltering(GetNetworkObject()))
-            distanceToConnectionObjects = ea::min(distanceToConnectionObjects, *distance);
-    }
+    const float distanceToConnectionObjects =
+        interestIndex.GetDistanceToConnection(connection, GetNetworkObject(), distance_);
 
     if (distanceToConnectionObjects < distance_)
         return ea::nullopt;
@@ -78,4 +74,11 @@ ea::optional<NetworkObjectRelevance> FilteredByDistance::GetRelevanceForClient(A
     return static_cast<NetworkObjectRelevance>(ea::min(updatePeriod_, maxPeriod));
 }
 
+ea::optional<float> FilteredByDistance::GetRelevanceDistance() const
+{
+    if (isRelevant_)
+        return ea::nullopt;
+    return distance_;
+}
+
 }
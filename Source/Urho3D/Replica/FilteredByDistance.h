@@ -58,6 +58,7 @@ public:
     /// Implement NetworkBehavior.
     /// @{
     ea::optional<NetworkObjectRelevance> GetRelevanceForClient(AbstractConnection* connection) override;
+    ea::optional<float> GetRelevanceDistance() const override;
     /// @}
 
 private:
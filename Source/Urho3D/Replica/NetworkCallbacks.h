@@ -79,6 +79,10 @@ public:
     /// Return whether the component should be replicated for specified client connection, and how frequently.
     /// The first reported valid relevance is used.
     virtual ea::optional<NetworkObjectRelevance> GetRelevanceForClient(AbstractConnection* connection) { return ea::nullopt; }
+    /// Return distance from the origins of distance filtering beyond which the object is irrelevant
+    /// for the connection that doesn't own it. Return none if the object may be relevant at any distance.
+    /// Used by server to skip relevance evaluation of far away objects, should be consistent with GetRelevanceForClient.
+    virtual ea::optional<float> GetRelevanceDistance() const { return ea::nullopt; }
     /// Called when world transform or parent of the object is updated in Server mode.
     virtual void UpdateTransformOnServer() {}
 
@@ -0,0 +1,192 @@
+// Copyright (c) 2025-2025 the rbfx project.
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT> or the accompanying LICENSE file.
+
+#include "Urho3D/Precompiled.h"
+
+#include "Urho3D/Replica/NetworkInterestIndex.h"
+
+#include "Urho3D/Replica/NetworkObject.h"
+#include "Urho3D/Scene/Node.h"
+
+namespace Urho3D
+{
+
+void NetworkInterestIndex::Update(ea::span<NetworkObject* const> networkObjects, unsigned indexUpperBound)
+{
+    objectPositions_.clear();
+    objectPositions_.resize(indexUpperBound);
+    objectOrder_.clear();
+    objectOrder_.resize(indexUpperBound, InvalidOrder);
+    unfilteredObjects_.clear();
+    maxRelevanceDistance_ = 0.0f;
+
+    // Keep allocated cells and lists from previous frame, objects usually don't move far
+    for (auto& [connection, origins] : originsByConnection_)
+        origins.clear();
+    for (auto& [cell, origins] : originCells_)
+        origins.clear();
+    for (auto& [connection, indices] : filteredObjectsByOwner_)
+        indices.clear();
+    for (auto& [cell, objects] : filteredObjectCells_)
+        objects.clear();
+
+    for (unsigned order = 0; order < networkObjects.size(); ++order)
+    {
+        NetworkObject* networkObject = networkObjects[order];
+        const Vector3 position = networkObject->GetNode()->GetWorldPosition();
+        const unsigned index = DeconstructComponentReference(networkObject->GetNetworkId()).first;
+        objectPositions_[index] = position;
+        objectOrder_[index] = order;
+
+        const AbstractConnection* ownerConnection = networkObject->GetOwnerConnection();
+
+        if (const auto relevanceDistance = networkObject->GetRelevanceDistance())
+        {
+            filteredObjectCells_[GetCell(position)].push_back(FilteredObject{index, position, *relevanceDistance});
+            maxRelevanceDistance_ = ea::max(maxRelevanceDistance_, *relevanceDistance);
+            if (ownerConnection)
+                filteredObjectsByOwner_[ownerConnection].push_back(index);
+        }
+        else
+            unfilteredObjects_.push_back(index);
+
+        if (!ownerConnection || !networkObject->IsOriginForDistanceFiltering())
+            continue;
+
+        const Origin origin{ownerConnection, networkObject, position};
+        originsByConnection_[ownerConnection].push_back(origin);
+        originCells_[GetCell(position)].push_back(origin);
+    }
+
+    // Drop stale entries so the maps don't grow indefinitely
+    const auto eraseEmpty = [](auto& container)
+    {
+        for (auto iter = container.begin(); iter != container.end();)
+            iter = iter->second.empty() ? container.erase(iter) : ++iter;
+    };
+    eraseEmpty(originsByConnection_);
+    eraseEmpty(originCells_);
+    eraseEmpty(filteredObjectsByOwner_);
+    eraseEmpty(filteredObjectCells_);
+}
+
+const Vector3& NetworkInterestIndex::GetObjectPosition(const NetworkObject* networkObject) const
+{
+    const unsigned index = DeconstructComponentReference(networkObject->GetNetworkId()).first;
+    return index < objectPositions_.size() ? objectPositions_[index] : Vector3::ZERO;
+}
+
+float NetworkInterestIndex::GetDistanceToConnection(
+    const AbstractConnection* connection, NetworkObject* networkObject, float maxDistance) const
+{
+    const auto iter = originsByConnection_.find(connection);
+    if (iter == originsByConnection_.end())
+        return M_LARGE_VALUE;
+
+    const ea::vector<Origin>& origins = iter->second;
+    const Vector3& position = GetObjectPosition(networkObject);
+    const float maxDistanceSquared = maxDistance * maxDistance;
+    float minDistance = M_LARGE_VALUE;
+
+    // Cached positions are used to skip far away origins, the distance is calculated by the origin itself
+    const auto checkOrigin = [&](const Origin& origin)
+    {
+        if (origin.connection_ != connection || (origin.position_ - position).LengthSquared() >= maxDistanceSquared)
+            return;
+        if (const auto distance = origin.networkObject_->CalculateDistanceForFiltering(networkObject))
+            minDistance = ea::min(minDistance, *distance);
+    };
+
+    // Check origins directly if there are fewer of them than cells to visit
+    const IntVector3 minCell = GetCell(position - Vector3::ONE * maxDistance);
+    const IntVector3 maxCell = GetCell(position + Vector3::ONE * maxDistance);
+    const double numCells = (maxCell.x_ - minCell.x_ + 1.0) * (maxCell.y_ - minCell.y_ + 1.0) * (maxCell.z_ - minCell.z_ + 1.0);
+    if (numCells >= origins.size())
+    {
+        for (const Origin& origin : origins)
+            checkOrigin(origin);
+    }
+    else
+        ForEachInCells(originCells_, position, maxDistance, checkOrigin);
+
+    return minDistance < maxDistance ? minDistance : M_LARGE_VALUE;
+}
+
+unsigned NetworkInterestIndex::GetNumOrigins(const AbstractConnection* connection) const
+{
+    const auto iter = originsByConnection_.find(connection);
+    return iter != originsByConnection_.end() ? iter->second.size() : 0;
+}
+
+void NetworkInterestIndex::CollectRelevanceCandidates(
+    const AbstractConnection* connection, ea::vector<unsigned>& indices) const
+{
+    indices.insert(indices.end(), unfilteredObjects_.begin(), unfilteredObjects_.end());
+
+    const auto ownedIter = filteredObjectsByOwner_.find(connection);
+    if (ownedIter != filteredObjectsByOwner_.end())
+        indices.insert(indices.end(), ownedIter->second.begin(), ownedIter->second.end());
+
+    const auto originsIter = originsByConnection_.find(connection);
+    if (originsIter == originsByConnection_.end())
+        return;
+
+    for (const Origin& origin : originsIter->second)
+    {
+        ForEachInCells(filteredObjectCells_, origin.position_, maxRelevanceDistance_,
+            [&](const FilteredObject& object)
+        {
+            const float distanceSquared = (object.position_ - origin.position_).LengthSquared();
+            if (distanceSquared < object.relevanceDistance_ * object.relevanceDistance_)
+                indices.push_back(object.index_);
+        });
+    }
+}
+
+template <class T, class Callback>
+void NetworkInterestIndex::ForEachInCells(const ea::unordered_map<IntVector3, ea::vector<T>>& cells,
+    const Vector3& position, float distance, const Callback& callback) const
+{
+    const IntVector3 minCell = GetCell(position - Vector3::ONE * distance);
+    const IntVector3 maxCell = GetCell(position + Vector3::ONE * distance);
+
+    // Iterate over non-empty cells if there are fewer of them than cells in the range
+    const double numCells = (maxCell.x_ - minCell.x_ + 1.0) * (maxCell.y_ - minCell.y_ + 1.0) * (maxCell.z_ - minCell.z_ + 1.0);
+    if (numCells >= cells.size())
+    {
+        for (const auto& [cell, elements] : cells)
+        {
+            for (const T& element : elements)
+                callback(element);
+        }
+        return;
+    }
+
+    IntVector3 cell;
+    for (cell.z_ = minCell.z_; cell.z_ <= maxCell.z_; ++cell.z_)
+    {
+        for (cell.y_ = minCell.y_; cell.y_ <= maxCell.y_; ++cell.y_)
+        {
+            for (cell.x_ = minCell.x_; cell.x_ <= maxCell.x_; ++cell.x_)
+            {
+                const auto cellIter = cells.find(cell);
+                if (cellIter == cells.end())
+                    continue;
+
+                for (const T& element : cellIter->second)
+                    callback(element);
+            }
+        }
+    }
+}
+
+IntVector3 NetworkInterestIndex::GetCell(const Vector3& position) const
+{
+    // Clamp to avoid overflow for far away positions and huge query distances
+    static constexpr float maxCellIndex = 1 << 20;
+    const Vector3 cell = VectorFloor(position / cellSize_);
+    return VectorRoundToInt(VectorMax(VectorMin(cell, Vector3::ONE * maxCellIndex), -Vector3::ONE * maxCellIndex));
+}
+
+} // namespace Urho3D
@@ -0,0 +1,92 @@
+// Copyright (c) 2025-2025 the rbfx project.
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT> or the accompanying LICENSE file.
+
+#pragma once
+
+#include "Urho3D/Math/MathDefs.h"
+#include "Urho3D/Math/Vector3.h"
+
+#include <EASTL/span.h>
+#include <EASTL/unordered_map.h>
+#include <EASTL/vector.h>
+
+namespace Urho3D
+{
+
+class AbstractConnection;
+class NetworkObject;
+
+/// Spatial index of NetworkObject-s used for per-connection interest management on server.
+/// Objects that report relevance distance are hashed into uniform grid, so the server only evaluates
+/// relevance of the objects that are close to the origins owned by the connection.
+/// Origins of distance filtering are hashed into the same kind of grid, so relevance queries don't iterate
+/// over all objects owned by the connection. Positions of all objects are cached as well.
+/// Index is rebuilt once per network frame on the main thread and is read-only afterwards,
+/// so it's safe to query it from worker threads.
+class URHO3D_API NetworkInterestIndex
+{
+public:
+    static constexpr float DefaultCellSize = 32.0f;
+    static constexpr unsigned InvalidOrder = M_MAX_UNSIGNED;
+
+    /// Set size of grid cell. Should be comparable with typical filtering distance.
+    void SetCellSize(float cellSize) { cellSize_ = ea::max(cellSize, M_EPSILON); }
+    float GetCellSize() const { return cellSize_; }
+
+    /// Rebuild index from current positions of network objects.
+    /// Objects should be sorted so that parents go before children.
+    void Update(ea::span<NetworkObject* const> networkObjects, unsigned indexUpperBound);
+
+    /// Return cached world position of the object.
+    const Vector3& GetObjectPosition(const NetworkObject* networkObject) const;
+    /// Return order of the object with given index in the list passed to Update.
+    /// Return InvalidOrder if there is no such object.
+    unsigned GetObjectOrder(unsigned index) const { return index < objectOrder_.size() ? objectOrder_[index] : InvalidOrder; }
+    /// Return distance from the object to the closest origin owned by the connection,
+    /// as reported by NetworkObject::CalculateDistanceForFiltering of the origin.
+    /// Return M_LARGE_VALUE if there is no origin closer than maxDistance.
+    float GetDistanceToConnection(
+        const AbstractConnection* connection, NetworkObject* networkObject, float maxDistance) const;
+    /// Return number of filtering origins owned by the connection.
+    unsigned GetNumOrigins(const AbstractConnection* connection) const;
+    /// Append indices of the objects that may be relevant for the connection: objects without relevance distance,
+    /// objects owned by the connection and objects within their relevance distance from any origin of the connection.
+    /// Indices may be repeated.
+    void CollectRelevanceCandidates(const AbstractConnection* connection, ea::vector<unsigned>& indices) const;
+
+private:
+    struct Origin
+    {
+        const AbstractConnection* connection_{};
+        NetworkObject* networkObject_{};
+        Vector3 position_;
+    };
+
+    struct FilteredObject
+    {
+        unsigned index_{};
+        Vector3 position_;
+        float relevanceDistance_{};
+    };
+
+    IntVector3 GetCell(const Vector3& position) const;
+    template <class T, class Callback>
+    void ForEachInCells(const ea::unordered_map<IntVector3, ea::vector<T>>& cells, const Vector3& position,
+        float distance, const Callback& callback) const;
+
+    float cellSize_{DefaultCellSize};
+
+    ea::vector<Vector3> objectPositions_;
+    ea::vector<unsigned> objectOrder_;
+
+    ea::unordered_map<const AbstractConnection*, ea::vector<Origin>> originsByConnection_;
+    ea::unordered_map<IntVector3, ea::vector<Origin>> originCells_;
+
+    ea::vector<unsigned> unfilteredObjects_;
+    ea::unordered_map<const AbstractConnection*, ea::vector<unsigned>> filteredObjectsByOwner_;
+    ea::unordered_map<IntVector3, ea::vector<FilteredObject>> filteredObjectCells_;
+    float maxRelevanceDistance_{};
+};
+
+} // namespace Urho3D
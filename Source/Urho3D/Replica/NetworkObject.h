@@ -84,7 +84,12 @@ public:
 
     /// Calculate distance to another network object, for the purpose of per-connection object filtering.
     /// Return null if this network object cannot be used to evaluate filtering distance.
+    /// Server skips origins whose node is farther than the filtering distance,
+    /// so returned distance should not be less than the distance between the nodes.
     virtual ea::optional<float> CalculateDistanceForFiltering(NetworkObject* otherNetworkObject);
+    /// Return whether the position of this object is used as origin for distance filtering
+    /// of other objects when the object is owned by a connection.
+    virtual bool IsOriginForDistanceFiltering() const { return true; }
 
     /// Set another NetworkObject as parent of this NetworkObject.
     void SetParentNetworkObject(NetworkId parentNetworkId);
@@ -23,6 +23,7 @@
 #include "../Precompiled.h"
 
 #include "../Core/Context.h"
+#include "../IO/Log.h"
 #include "../Network/NetworkEvents.h"
 #include "../Replica/ReplicatedTransform.h"
 #include "../Replica/NetworkSettingsConsts.h"
@@ -39,6 +40,11 @@ const StringVector replicatedRotationModeNames = {
     //"Y"
 };
 
+unsigned ClampRotationBits(unsigned bits)
+{
+    return Clamp(bits, 4u, 16u);
+}
+
 }
 
 ReplicatedTransform::ReplicatedTransform(Context* context)
@@ -68,11 +74,17 @@ void ReplicatedTransform::RegisterObject(Context* context)
     URHO3D_ENUM_ATTRIBUTE("Synchronize Rotation", synchronizeRotation_, replicatedRotationModeNames, DefaultSynchronizeRotation, AM_DEFAULT);
     URHO3D_ATTRIBUTE("Extrapolate Position", bool, extrapolatePosition_, DefaultExtrapolatePosition, AM_DEFAULT);
     URHO3D_ATTRIBUTE("Extrapolate Rotation", bool, extrapolateRotation_, DefaultExtrapolateRotation, AM_DEFAULT);
+    URHO3D_ATTRIBUTE("Quantize", bool, quantize_, DefaultQuantize, AM_DEFAULT);
+    URHO3D_ATTRIBUTE("Position Precision", float, positionPrecision_, DefaultPositionPrecision, AM_DEFAULT);
+    URHO3D_ATTRIBUTE("Velocity Precision", float, velocityPrecision_, DefaultVelocityPrecision, AM_DEFAULT);
+    URHO3D_ATTRIBUTE("Rotation Bits", unsigned, rotationBits_, DefaultRotationBits, AM_DEFAULT);
+    URHO3D_ATTRIBUTE("Baseline Interval", unsigned, baselineInterval_, DefaultBaselineInterval, AM_DEFAULT);
 }
 
 void ReplicatedTransform::InitializeOnServer()
 {
     InitializeCommon();
+    ValidateQuantization();
 
     server_.previousPosition_ = node_->GetWorldPosition();
     server_.previousRotation_ = node_->GetWorldRotation();
@@ -95,7 +107,15 @@ void ReplicatedTransform::WriteSnapshot(NetworkFrame frame, Serializer& dest)
     flags[1] = synchronizeRotation_ != ReplicatedRotationMode::None;
     flags[2] = extrapolatePosition_;
     flags[3] = extrapolateRotation_;
+    flags[4] = quantize_;
     dest.WriteVLE(flags.to_uint32());
+
+    if (quantize_)
+    {
+        dest.WriteFloat(positionPrecision_);
+        dest.WriteFloat(velocityPrecision_);
+        dest.WriteVLE(ClampRotationBits(rotationBits_));
+    }
 }
 
 void ReplicatedTransform::InitializeFromSnapshot(NetworkFrame frame, Deserializer& src, bool isOwned)
@@ -107,6 +127,15 @@ void ReplicatedTransform::InitializeFromSnapshot(NetworkFrame frame, Deserialize
     synchronizeRotation_ = flags[1] ? ReplicatedRotationMode::XYZ : ReplicatedRotationMode::None;
     extrapolatePosition_ = flags[2];
     extrapolateRotation_ = flags[3];
+    quantize_ = flags[4];
+
+    if (quantize_)
+    {
+        positionPrecision_ = src.ReadFloat();
+        velocityPrecision_ = src.ReadFloat();
+        rotationBits_ = src.ReadVLE();
+        ValidateQuantization();
+    }
 
     const auto replicationManager = GetNetworkObject()->GetReplicationManager();
     const unsigned updateFrequency = replicationManager->GetUpdateFrequency();
@@ -121,6 +150,23 @@ void ReplicatedTransform::UpdateTransformOnServer()
     server_.movedDuringFrame_ = true;
 }
 
+void ReplicatedTransform::ValidateQuantization()
+{
+    if (!(positionPrecision_ > 0.0f))
+    {
+        URHO3D_LOGWARNING("ReplicatedTransform position precision must be positive, {} is used instead of {}",
+            DefaultPositionPrecision, positionPrecision_);
+        positionPrecision_ = DefaultPositionPrecision;
+    }
+
+    if (!(velocityPrecision_ > 0.0f))
+    {
+        URHO3D_LOGWARNING("ReplicatedTransform velocity precision must be positive, {} is used instead of {}",
+            DefaultVelocityPrecision, velocityPrecision_);
+        velocityPrecision_ = DefaultVelocityPrecision;
+    }
+}
+
 void ReplicatedTransform::InitializeCommon()
 {
     const auto replicationManager = GetNetworkObject()->GetReplicationManager();
@@ -155,6 +201,8 @@ void ReplicatedTransform::OnServerFrameEnd(NetworkFrame frame)
     if (server_.pendingUploadAttempts_ > 0)
         --server_.pendingUploadAttempts_;
 
+    // Deltas are useless to the client without the baseline, so baseline should not be older than current upload
+    bool resetBaseline = false;
     if (server_.movedDuringFrame_)
     {
         server_.movedDuringFrame_ = false;
@@ -164,11 +212,23 @@ void ReplicatedTransform::OnServerFrameEnd(NetworkFrame frame)
         const bool isRotationDirty = !server_.latestSentRotation_.Equivalent(server_.rotation_, M_LARGE_EPSILON);
         if (isPositionDirty || isRotationDirty)
         {
+            resetBaseline = server_.pendingUploadAttempts_ == 0;
             server_.pendingUploadAttempts_ = numUploadAttempts_;
             server_.latestSentPosition_ = server_.position_;
             server_.latestSentRotation_ = server_.rotation_;
         }
     }
+
+    // Update baseline only on frames when delta is sent so the client has a chance to receive it.
+    // Last upload attempt is always absolute so the client converges even if all previous baselines were lost.
+    if (quantize_ && PrepareUnreliableDelta(frame))
+    {
+        if (resetBaseline || server_.pendingUploadAttempts_ == 1)
+            server_.positionBaseline_.Reset();
+
+        server_.quantizedPosition_ = QuantizeVector3(server_.position_, positionPrecision_);
+        server_.positionBaseline_.Update(frame, server_.quantizedPosition_, baselineInterval_);
+    }
 }
 
 void ReplicatedTransform::InterpolateState(float replicaTimeStep, float inputTimeStep, const NetworkTime& replicaTime, const NetworkTime& inputTime)
@@ -206,6 +266,12 @@ bool ReplicatedTransform::PrepareUnreliableDelta(NetworkFrame frame)
 
 void ReplicatedTransform::WriteUnreliableDelta(NetworkFrame frame, Serializer& dest)
 {
+    if (quantize_)
+    {
+        WriteQuantizedDelta(frame, dest);
+        return;
+    }
+
     if (synchronizePosition_)
     {
         dest.WriteVector3(server_.position_);
@@ -221,6 +287,12 @@ void ReplicatedTransform::WriteUnreliableDelta(NetworkFrame frame, Serializer& d
 
 void ReplicatedTransform::ReadUnreliableDelta(NetworkFrame frame, Deserializer& src)
 {
+    if (quantize_)
+    {
+        ReadQuantizedDelta(frame, src);
+        return;
+    }
+
     if (synchronizePosition_)
     {
         const Vector3 position = src.ReadVector3();
@@ -238,6 +310,49 @@ void ReplicatedTransform::ReadUnreliableDelta(NetworkFrame frame, Deserializer&
     }
 }
 
+void ReplicatedTransform::WriteQuantizedDelta(NetworkFrame frame, Serializer& dest) const
+{
+    BitWriter writer{dest};
+
+    if (synchronizePosition_)
+    {
+        server_.positionBaseline_.Write(writer, frame, server_.quantizedPosition_);
+        WriteQuantizedVector3(writer, QuantizeVector3(server_.velocity_, velocityPrecision_));
+    }
+
+    if (synchronizeRotation_ == ReplicatedRotationMode::XYZ)
+    {
+        WriteCompressedQuaternion(writer, server_.rotation_, ClampRotationBits(rotationBits_));
+        WriteQuantizedVector3(writer, QuantizeVector3(server_.angularVelocity_, velocityPrecision_));
+    }
+}
+
+void ReplicatedTransform::ReadQuantizedDelta(NetworkFrame frame, Deserializer& src)
+{
+    BitReader reader{src};
+
+    if (synchronizePosition_)
+    {
+        const auto position = client_.positionBaseline_.Read(reader, frame);
+        const IntVector3 velocity = ReadQuantizedVector3(reader);
+
+        // Position cannot be decoded if baseline was lost, wait for the next one
+        if (position)
+        {
+            positionTrace_.Set(frame,
+                {DequantizeVector3(*position, positionPrecision_), DequantizeVector3(velocity, velocityPrecision_)});
+        }
+    }
+
+    if (synchronizeRotation_ == ReplicatedRotationMode::XYZ)
+    {
+        const Quaternion rotation = ReadCompressedQuaternion(reader, rotationBits_);
+        const IntVector3 angularVelocity = ReadQuantizedVector3(reader);
+
+        rotationTrace_.Set(frame, {rotation, DequantizeVector3(angularVelocity, velocityPrecision_)});
+    }
+}
+
 PositionAndVelocity ReplicatedTransform::SampleTemporalPosition(const NetworkTime& time) const
 {
     return positionTrace_.SampleValid(time);
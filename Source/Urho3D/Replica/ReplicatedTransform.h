@@ -25,6 +25,7 @@
 #pragma once
 
 #include "../Replica/BehaviorNetworkObject.h"
+#include "../Replica/BitPacking.h"
 #include "../Replica/NetworkValue.h"
 
 namespace Urho3D
@@ -59,6 +60,11 @@ public:
     static constexpr ReplicatedRotationMode DefaultSynchronizeRotation = ReplicatedRotationMode::XYZ;
     static constexpr bool DefaultExtrapolatePosition = true;
     static constexpr bool DefaultExtrapolateRotation = false;
+    static constexpr bool DefaultQuantize = false;
+    static constexpr float DefaultPositionPrecision = 1.0f / 1024.0f;
+    static constexpr float DefaultVelocityPrecision = 1.0f / 1024.0f;
+    static constexpr unsigned DefaultRotationBits = 12;
+    static constexpr unsigned DefaultBaselineInterval = 8;
 
     static constexpr NetworkCallbackFlags CallbackMask =
         NetworkCallbackMask::UpdateTransformOnServer | NetworkCallbackMask::UnreliableDelta | NetworkCallbackMask::InterpolateState;
@@ -92,6 +98,23 @@ public:
     void SetExtrapolateRotation(bool value) { extrapolateRotation_ = value; }
     bool GetExtrapolateRotation() const { return extrapolateRotation_; }
 
+    /// Quantized encoding. Positions and velocities are converted to fixed point with given precision,
+    /// rotations are compressed with smallest-three encoding, positions are delta-encoded against baseline
+    /// that is sent as absolute value every BaselineInterval frames, on the first upload after the object was idle
+    /// and on the last upload attempt. Precisions should be positive. Should be configured before replication.
+    /// @{
+    void SetQuantize(bool value) { quantize_ = value; }
+    bool GetQuantize() const { return quantize_; }
+    void SetPositionPrecision(float value) { positionPrecision_ = value; }
+    float GetPositionPrecision() const { return positionPrecision_; }
+    void SetVelocityPrecision(float value) { velocityPrecision_ = value; }
+    float GetVelocityPrecision() const { return velocityPrecision_; }
+    void SetRotationBits(unsigned value) { rotationBits_ = value; }
+    unsigned GetRotationBits() const { return rotationBits_; }
+    void SetBaselineInterval(unsigned value) { baselineInterval_ = value; }
+    unsigned GetBaselineInterval() const { return baselineInterval_; }
+    /// @}
+
     /// Implement NetworkBehavior.
     /// @{
     void InitializeOnServer() override;
@@ -117,7 +140,10 @@ public:
 
 private:
     void InitializeCommon();
+    void ValidateQuantization();
     void OnServerFrameEnd(NetworkFrame frame);
+    void WriteQuantizedDelta(NetworkFrame frame, Serializer& dest) const;
+    void ReadQuantizedDelta(NetworkFrame frame, Deserializer& src);
 
     /// Attributes independent on the client and the server.
     /// @{
@@ -136,6 +162,11 @@ private:
     ReplicatedRotationMode synchronizeRotation_{DefaultSynchronizeRotation};
     bool extrapolatePosition_{DefaultExtrapolatePosition};
     bool extrapolateRotation_{DefaultExtrapolateRotation};
+    bool quantize_{DefaultQuantize};
+    float positionPrecision_{DefaultPositionPrecision};
+    float velocityPrecision_{DefaultVelocityPrecision};
+    unsigned rotationBits_{DefaultRotationBits};
+    unsigned baselineInterval_{DefaultBaselineInterval};
     /// @}
 
     NetworkValue<PositionAndVelocity> positionTrace_;
@@ -156,6 +187,9 @@ private:
         bool movedDuringFrame_{};
         Vector3 latestSentPosition_;
         Quaternion latestSentRotation_;
+
+        IntVector3 quantizedPosition_;
+        QuantizedVector3Baseline positionBaseline_;
     } server_;
 
     struct ClientData
@@ -165,6 +199,8 @@ private:
 
         bool previousPositionInvalid_{};
         bool previousRotationInvalid_{};
+
+        QuantizedVector3Baseline positionBaseline_;
     } client_;
 };
 
@@ -171,6 +171,8 @@ void ReplicationManager::RegisterObject(Context* context)
     // clang-format off
     URHO3D_ATTRIBUTE("Is Fixed Update Server", bool, attributes_.isFixedUpdateServer_, Attributes{}.isFixedUpdateServer_, AM_DEFAULT);
     URHO3D_ATTRIBUTE("Allow Zero Updates On Server", bool, attributes_.allowZeroUpdatesOnServer_, Attributes{}.allowZeroUpdatesOnServer_, AM_DEFAULT);
+    URHO3D_ATTRIBUTE("Parallel Client Update", bool, attributes_.parallelClientUpdate_, Attributes{}.parallelClientUpdate_, AM_DEFAULT);
+    URHO3D_ATTRIBUTE("Interest Cell Size", float, attributes_.interestCellSize_, Attributes{}.interestCellSize_, AM_DEFAULT);
     // clang-format on
 }
 
@@ -117,6 +117,13 @@ public:
     void SetFixedUpdateServer(bool fixed) { attributes_.isFixedUpdateServer_ = fixed; }
     bool IsAllowZeroUpdatesOnServer() const { return attributes_.allowZeroUpdatesOnServer_; }
     void SetAllowZeroUpdatesOnServer(bool allow) { attributes_.allowZeroUpdatesOnServer_ = allow; }
+    /// Whether to evaluate relevance for different client connections in parallel on server.
+    /// NetworkObject::GetRelevanceForClient should be thread-safe if enabled.
+    bool IsParallelClientUpdate() const { return attributes_.parallelClientUpdate_; }
+    void SetParallelClientUpdate(bool parallel) { attributes_.parallelClientUpdate_ = parallel; }
+    /// Size of grid cell of NetworkInterestIndex on server.
+    float GetInterestCellSize() const { return attributes_.interestCellSize_; }
+    void SetInterestCellSize(float cellSize) { attributes_.interestCellSize_ = cellSize; }
     /// @}
 
     /// Return current state specific to client or server.
@@ -170,6 +177,8 @@ private:
     {
         bool isFixedUpdateServer_{true};
         bool allowZeroUpdatesOnServer_{};
+        bool parallelClientUpdate_{};
+        float interestCellSize_{NetworkInterestIndex::DefaultCellSize};
     } attributes_;
 
     ReplicationManagerMode mode_{};
@@ -9,7 +9,9 @@
 #include "Urho3D/Core/Context.h"
 #include "Urho3D/Core/CoreEvents.h"
 #include "Urho3D/Core/Exception.h"
+#include "Urho3D/Core/Profiler.h"
 #include "Urho3D/Core/Timer.h"
+#include "Urho3D/Core/WorkQueue.h"
 #include "Urho3D/IO/Log.h"
 #include "Urho3D/Math/RandomEngine.h"
 #include "Urho3D/Network/Connection.h"
@@ -23,6 +25,7 @@
 #include "Urho3D/Scene/SceneEvents.h"
 
 #include <EASTL/numeric.h>
+#include <EASTL/sort.h>
 
 namespace Urho3D
 {
@@ -68,13 +71,16 @@ void SharedReplicationState::OnNetworkObjectRemoved(NetworkObject* networkObject
     }
 }
 
-void SharedReplicationState::PrepareForUpdate()
+void SharedReplicationState::PrepareForUpdate(float interestCellSize)
 {
     ResetFrameBuffers();
     InitializeNewObjects();
 
     objectRegistry_->UpdateNetworkObjects();
     objectRegistry_->GetSortedNetworkObjects(sortedNetworkObjects_);
+
+    interestIndex_.SetCellSize(interestCellSize);
+    interestIndex_.Update(sortedNetworkObjects_, GetIndexUpperBound());
 }
 
 void SharedReplicationState::ResetFrameBuffers()
@@ -520,7 +526,7 @@ void ClientReplicationState::SendUpdateObjectsUnreliable(
     }
 }
 
-void ClientReplicationState::UpdateNetworkObjects(SharedReplicationState& sharedState)
+void ClientReplicationState::UpdateNetworkObjects(const SharedReplicationState& sharedState)
 {
     if (!IsSynchronized())
         return;
@@ -546,9 +552,27 @@ void ClientReplicationState::UpdateNetworkObjects(SharedReplicationState& shared
         }
     }
 
-    // Process active components
-    for (NetworkObject* networkObject : sharedState.GetSortedObjects())
+    // Process objects that were relevant and objects that may become relevant according to the interest index.
+    // Objects are processed in the sorted order so parents are processed before children.
+    const ea::vector<NetworkObject*>& sortedObjects = sharedState.GetSortedObjects();
+    const NetworkInterestIndex& interestIndex = sharedState.GetInterestIndex();
+
+    candidateObjects_.clear();
+    interestIndex.CollectRelevanceCandidates(connection_, candidateObjects_);
+    candidateObjects_.insert(candidateObjects_.end(), relevantObjects_.begin(), relevantObjects_.end());
+    for (unsigned& index : candidateObjects_)
+        index = interestIndex.GetObjectOrder(index);
+    ea::sort(candidateObjects_.begin(), candidateObjects_.end());
+    candidateObjects_.erase(ea::unique(candidateObjects_.begin(), candidateObjects_.end()), candidateObjects_.end());
+
+    relevantObjects_.clear();
+    for (unsigned order : candidateObjects_)
     {
+        // Removed objects are sorted last
+        if (order == NetworkInterestIndex::InvalidOrder)
+            break;
+
+        NetworkObject* networkObject = sortedObjects[order];
         const NetworkId networkId = networkObject->GetNetworkId();
         const NetworkId parentNetworkId = networkObject->GetParentNetworkId();
         const unsigned index = GetIndex(networkId);
@@ -566,6 +590,7 @@ void ClientReplicationState::UpdateNetworkObjects(SharedReplicationState& shared
             {
                 objectsRelevanceTimeouts_[index] = relevanceTimeout;
                 pendingUpdatedObjects_.push_back({networkObject, true});
+                relevantObjects_.push_back(index);
             }
         }
         else if (wasRelevant)
@@ -589,12 +614,21 @@ void ClientReplicationState::UpdateNetworkObjects(SharedReplicationState& shared
             }
 
             // Queue non-snapshot update
-            sharedState.QueueDeltaUpdate(networkObject);
             pendingUpdatedObjects_.push_back({networkObject, false});
+            relevantObjects_.push_back(index);
         }
     }
 }
 
+void ClientReplicationState::QueueDeltaUpdates(SharedReplicationState& sharedState) const
+{
+    for (const auto& [networkObject, isSnapshot] : pendingUpdatedObjects_)
+    {
+        if (!isSnapshot)
+            sharedState.QueueDeltaUpdate(networkObject);
+    }
+}
+
 ServerReplicator::ServerReplicator(Scene* scene)
     : Object(scene->GetContext())
     , network_(GetSubsystem<Network>())
@@ -670,15 +704,39 @@ void ServerReplicator::OnNetworkUpdate()
     eventData[P_FRAME] = static_cast<long long>(currentFrame_);
     network_->SendEvent(E_ENDSERVERNETWORKFRAME, eventData);
 
-    sharedState_->PrepareForUpdate();
-    for (auto& [connection, clientState] : connections_)
-        clientState->UpdateNetworkObjects(*sharedState_);
+    sharedState_->PrepareForUpdate(replicationManager_->GetInterestCellSize());
+    UpdateClientStates();
     sharedState_->CookDeltaUpdates(currentFrame_);
 
     for (auto& [connection, clientState] : connections_)
         clientState->SendMessages(currentFrame_, *sharedState_);
 }
 
+void ServerReplicator::UpdateClientStates()
+{
+    URHO3D_PROFILE("UpdateClientStates");
+
+    clientStates_.clear();
+    for (auto& [connection, clientState] : connections_)
+        clientStates_.push_back(clientState);
+
+    const auto updateClientStates = [this](unsigned beginIndex, unsigned endIndex)
+    {
+        for (unsigned i = beginIndex; i < endIndex; ++i)
+            clientStates_[i]->UpdateNetworkObjects(*sharedState_);
+    };
+
+    auto workQueue = GetSubsystem<WorkQueue>();
+    if (workQueue && replicationManager_->IsParallelClientUpdate())
+        workQueue->ParallelFor(clientStates_.size(), 1, updateClientStates);
+    else
+        updateClientStates(0, clientStates_.size());
+
+    // Merge results on the main thread
+    for (ClientReplicationState* clientState : clientStates_)
+        clientState->QueueDeltaUpdates(*sharedState_);
+}
+
 void ServerReplicator::AddConnection(AbstractConnection* connection)
 {
     if (connections_.contains(connection))
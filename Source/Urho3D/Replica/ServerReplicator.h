@@ -30,6 +30,7 @@
 #include "../IO/VectorBuffer.h"
 #include "../Network/ClockSynchronizer.h"
 #include "../Replica/ClientInputStatistics.h"
+#include "../Replica/NetworkInterestIndex.h"
 #include "../Replica/NetworkId.h"
 #include "../Replica/TickSynchronizer.h"
 #include "../Replica/ProtocolMessages.h"
@@ -57,7 +58,7 @@ public:
     explicit SharedReplicationState(NetworkObjectRegistry* objectRegistry);
 
     /// Initial preparation for network update.
-    void PrepareForUpdate();
+    void PrepareForUpdate(float interestCellSize);
     /// Request delta update to be prepared for specified object.
     void QueueDeltaUpdate(NetworkObject* networkObject);
     /// Cook all requested delta updates.
@@ -69,6 +70,7 @@ public:
     const ea::vector<NetworkObject*>& GetSortedObjects() const { return sortedNetworkObjects_; }
     unsigned GetIndexUpperBound() const;
     const ea::unordered_set<NetworkObject*>& GetOwnedObjectsByConnection(AbstractConnection* connection) const;
+    const NetworkInterestIndex& GetInterestIndex() const { return interestIndex_; }
     ea::optional<ConstByteSpan> GetReliableUpdateByIndex(unsigned index) const;
     ea::optional<ConstByteSpan> GetUnreliableUpdateByIndex(unsigned index) const;
     /// @}
@@ -105,6 +107,7 @@ private:
     ea::vector<DeltaBufferSpan> unreliableDeltaUpdateData_;
 
     ea::unordered_map<AbstractConnection*, ea::unordered_set<NetworkObject*>> ownedObjectsByConnection_;
+    NetworkInterestIndex interestIndex_;
 };
 
 /// Clock synchronization state specific to individual client connection.
@@ -172,7 +175,10 @@ public:
         NetworkObjectRegistry* objectRegistry, AbstractConnection* connection, const VariantMap& settings);
 
     /// Perform network update from the perspective of this client connection.
-    void UpdateNetworkObjects(SharedReplicationState& sharedState);
+    /// Doesn't modify shared state, so it's safe to update different connections in parallel.
+    void UpdateNetworkObjects(const SharedReplicationState& sharedState);
+    /// Request delta updates for objects replicated to this client connection.
+    void QueueDeltaUpdates(SharedReplicationState& sharedState) const;
 
     /// Process messages for this client.
     bool ProcessMessage(NetworkMessageId messageId, MemoryBuffer& messageData);
@@ -194,6 +200,10 @@ private:
 
     ea::vector<NetworkObjectRelevance> objectsRelevance_;
     ea::vector<float> objectsRelevanceTimeouts_;
+    /// Indices of objects that are replicated to the client.
+    ea::vector<unsigned> relevantObjects_;
+    /// Orders of objects that are evaluated in current frame.
+    ea::vector<unsigned> candidateObjects_;
 
     ea::vector<NetworkId> pendingRemovedObjects_;
     ea::vector<ea::pair<NetworkObject*, bool>> pendingUpdatedObjects_;
@@ -227,6 +237,7 @@ public:
     unsigned GetFeedbackDelay(AbstractConnection* connection) const;
     const ea::unordered_set<NetworkObject*>& GetNetworkObjectsOwnedByConnection(AbstractConnection* connection) const;
     NetworkObject* GetNetworkObjectOwnedByConnection(AbstractConnection* connection) const;
+    const NetworkInterestIndex& GetInterestIndex() const { return sharedState_->GetInterestIndex(); }
     NetworkTime GetServerTime() const { return NetworkTime{currentFrame_}; }
     unsigned GetUpdateFrequency() const { return updateFrequency_; }
     NetworkFrame GetCurrentFrame() const { return currentFrame_; }
@@ -235,6 +246,7 @@ public:
 private:
     void OnInputReady(float timeStep, bool isUpdateNow, float overtime);
     void OnNetworkUpdate();
+    void UpdateClientStates();
 
     ClientReplicationState* GetClientState(AbstractConnection* connection) const;
 
@@ -251,6 +263,7 @@ private:
 
     SharedPtr<SharedReplicationState> sharedState_;
     ea::unordered_map<AbstractConnection*, SharedPtr<ClientReplicationState>> connections_;
+    ea::vector<ClientReplicationState*> clientStates_;
 };
 
 }
@@ -45,7 +45,7 @@ public:
 
     /// Server-only attributes.
     /// @{
-    bool IsOriginForDistanceFiltering() const { return isOriginForDistanceFiltering_; }
+    bool IsOriginForDistanceFiltering() const override { return isOriginForDistanceFiltering_; }
     void SetOriginForDistanceFiltering(bool isOrigin) { isOriginForDistanceFiltering_ = isOrigin; }
     /// @}
 
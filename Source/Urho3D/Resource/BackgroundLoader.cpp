@@ -26,7 +26,10 @@
 
 #include "../Core/Context.h"
 #include "../Core/Profiler.h"
+#include "../Core/WorkQueue.h"
 #include "../IO/Log.h"
+#include "../IO/MemoryBuffer.h"
+#include "../IO/MemoryMappedFile.h"
 #include "../Resource/BackgroundLoader.h"
 #include "../Resource/ResourceCache.h"
 #include "../Resource/ResourceEvents.h"
@@ -43,8 +46,25 @@ BackgroundLoader::BackgroundLoader(ResourceCache* owner) :
 
 BackgroundLoader::~BackgroundLoader()
 {
-    MutexLock lock(backgroundLoadMutex_);
+    // Stop reading new resources and wait until decoding tasks are finished, they refer to queue items
+    Stop();
+
+    {
+        MutexLock lock(backgroundLoadMutex_);
+        decodeQueue_.clear();
+    }
 
+    for (;;)
+    {
+        {
+            MutexLock lock(backgroundLoadMutex_);
+            if (numDecodingTasks_ == 0)
+                break;
+        }
+        Time::Sleep(1);
+    }
+
+    MutexLock lock(backgroundLoadMutex_);
     backgroundLoadQueue_.clear();
 }
 
@@ -54,60 +74,174 @@ void BackgroundLoader::ThreadFunction()
 
     while (shouldRun_)
     {
+        const unsigned maxDecodingTasks = maxDecodingTasks_.load(std::memory_order_relaxed);
+
         backgroundLoadMutex_.Acquire();
 
-        // Search for a queued resource that has not been loaded yet
-        auto i = backgroundLoadQueue_.begin();
-        while (i != backgroundLoadQueue_.end())
+        // Search for a queued resource that has not been loaded yet.
+        // Don't read too far ahead if decoding is slower than reading.
+        BackgroundLoadItem* item = nullptr;
+        if (maxDecodingTasks == 0 || decodeQueue_.size() < maxDecodingTasks * MaxReadAheadResourcesPerThread)
         {
-            if (i->second.resource_->GetAsyncLoadState() == ASYNC_QUEUED)
-                break;
-            else
-                ++i;
+            for (auto& [key, queuedItem] : backgroundLoadQueue_)
+            {
+                if (queuedItem.resource_->GetAsyncLoadState() == ASYNC_QUEUED)
+                {
+                    item = &queuedItem;
+                    break;
+                }
+            }
         }
 
-        if (i == backgroundLoadQueue_.end())
+        // We can be sure that the item is not removed from the queue as long as it is in the
+        // "queued" or "loading" state
+        if (item)
+            item->resource_->SetAsyncLoadState(ASYNC_LOADING);
+
+        backgroundLoadMutex_.Release();
+
+        if (!item)
         {
             // No resources to load found
-            backgroundLoadMutex_.Release();
             Time::Sleep(5);
+            continue;
         }
+
+        const bool readAhead = maxDecodingTasks > 0;
+        const bool fileFound = ReadResourceFile(*item, readAhead);
+        if (!readAhead || !fileFound)
+            LoadResource(*item, fileFound);
         else
         {
-            BackgroundLoadItem& item = i->second;
-            Resource* resource = item.resource_;
-            // We can be sure that the item is not removed from the queue as long as it is in the
-            // "queued" or "loading" state
-            backgroundLoadMutex_.Release();
-
-            bool success = false;
-            AbstractFilePtr file = owner_->GetFile(resource->GetName(), item.sendEventOnFailure_);
-            if (file)
+            MutexLock lock(backgroundLoadMutex_);
+            decodeQueue_.push_back(item);
+        }
+    }
+}
+
+bool BackgroundLoader::ReadResourceFile(BackgroundLoadItem& item, bool readAhead)
+{
+    URHO3D_PROFILE("ReadBackgroundResource");
+
+    AbstractFilePtr file = owner_->GetFile(item.resource_->GetName(), item.sendEventOnFailure_);
+    if (!file)
+        return false;
+
+    if (auto mappedFile = dynamic_cast<MemoryMappedFile*>(file.Get()))
+    {
+        // Memory-mapped files are not copied, just ask the OS to load them
+        if (readAhead)
+            mappedFile->Prefetch();
+        item.file_ = file;
+    }
+    else if (readAhead && file->GetSize() <= MaxReadAheadFileSize)
+    {
+        item.fileData_.resize(file->GetSize());
+        item.fileData_.resize(file->Read(item.fileData_.data(), item.fileData_.size()));
+        item.fileName_ = file->GetName();
+    }
+    else
+        item.file_ = file;
+
+    return true;
+}
+
+void BackgroundLoader::LoadResource(BackgroundLoadItem& item, bool fileFound)
+{
+    Resource* resource = item.resource_;
+
+    bool success = false;
+    unsigned fileSize = 0;
+    HiresTimer loadTimer;
+    if (item.file_)
+    {
+        fileSize = item.file_->GetSize();
+        success = resource->BeginLoad(*item.file_);
+    }
+    else if (fileFound)
+    {
+        MemoryBuffer buffer(item.fileData_);
+        buffer.SetName(item.fileName_);
+        fileSize = buffer.GetSize();
+        success = resource->BeginLoad(buffer);
+    }
+    const long long loadTimeUs = loadTimer.GetUSec(false);
+
+    item.file_ = nullptr;
+    item.fileData_.set_capacity(0);
+
+    // Process dependencies now
+    // Need to lock the queue again when manipulating other entries
+    ea::pair<StringHash, StringHash> key = ea::make_pair(resource->GetType(), resource->GetNameHash());
+    MutexLock lock(backgroundLoadMutex_);
+    if (item.dependents_.size())
+    {
+        for (auto i = item.dependents_.begin(); i != item.dependents_.end(); ++i)
+        {
+            auto j = backgroundLoadQueue_.find(*i);
+            if (j != backgroundLoadQueue_.end())
+                j->second.dependencies_.erase(key);
+        }
+
+        item.dependents_.clear();
+    }
+
+    if (fileFound)
+    {
+        BackgroundLoadTypeStats& stats = typeStats_[resource->GetType()];
+        ++stats.numResources_;
+        stats.numBytes_ += fileSize;
+        stats.loadTimeUs_ += loadTimeUs;
+    }
+
+    resource->SetAsyncLoadState(success ? ASYNC_SUCCESS : ASYNC_FAIL);
+}
+
+void BackgroundLoader::DecodeResources()
+{
+    for (;;)
+    {
+        BackgroundLoadItem* item = nullptr;
+        {
+            MutexLock lock(backgroundLoadMutex_);
+            if (decodeQueue_.empty())
             {
-                resource->SetAsyncLoadState(ASYNC_LOADING);
-                success = resource->BeginLoad(*file);
+                --numDecodingTasks_;
+                return;
             }
 
-            // Process dependencies now
-            // Need to lock the queue again when manipulating other entries
-            ea::pair<StringHash, StringHash> key = ea::make_pair(resource->GetType(), resource->GetNameHash());
-            backgroundLoadMutex_.Acquire();
-            if (item.dependents_.size())
-            {
-                for (auto i = item.dependents_.begin(); i != item.dependents_.end(); ++i)
-                {
-                    auto j = backgroundLoadQueue_.find(*i);
-                    if (j != backgroundLoadQueue_.end())
-                        j->second.dependencies_.erase(key);
-                }
+            item = decodeQueue_.front();
+            decodeQueue_.pop_front();
+        }
 
-                item.dependents_.clear();
-            }
+        URHO3D_PROFILE("DecodeBackgroundResource");
+        LoadResource(*item, true);
+    }
+}
 
-            resource->SetAsyncLoadState(success ? ASYNC_SUCCESS : ASYNC_FAIL);
-            backgroundLoadMutex_.Release();
+void BackgroundLoader::StartDecoding()
+{
+    if (!Thread::IsMainThread())
+        return;
+
+    // WorkQueue may be initialized after the loader is created
+    if (!workQueue_)
+        workQueue_ = owner_->GetSubsystem<WorkQueue>();
+    const unsigned maxDecodingTasks = workQueue_ && workQueue_->IsMultithreaded() ? workQueue_->GetNumProcessingThreads() - 1 : 0;
+    maxDecodingTasks_.store(maxDecodingTasks, std::memory_order_relaxed);
+
+    unsigned numTasksToStart = 0;
+    {
+        MutexLock lock(backgroundLoadMutex_);
+        while (numDecodingTasks_ < maxDecodingTasks && numDecodingTasks_ < decodeQueue_.size())
+        {
+            ++numDecodingTasks_;
+            ++numTasksToStart;
         }
     }
+
+    for (unsigned i = 0; i < numTasksToStart; ++i)
+        workQueue_->PostTask([this] { DecodeResources(); }, TaskPriority::Low);
 }
 
 bool BackgroundLoader::QueueResource(StringHash type, const ea::string& name, bool sendEventOnFailure, Resource* caller)
@@ -194,6 +328,8 @@ void BackgroundLoader::WaitForResource(StringHash type, StringHash nameHash)
                 AsyncLoadState state = resource->GetAsyncLoadState();
                 if (numDeps > 0 || state == ASYNC_QUEUED || state == ASYNC_LOADING)
                 {
+                    // Resource or its dependencies may be waiting for decoding
+                    StartDecoding();
                     didWait = true;
                     Time::Sleep(1);
                 }
@@ -222,6 +358,8 @@ void BackgroundLoader::FinishResources(int maxMs)
 {
     if (IsStarted())
     {
+        StartDecoding();
+
         HiresTimer timer;
 
         backgroundLoadMutex_.Acquire();
@@ -261,6 +399,18 @@ unsigned BackgroundLoader::GetNumQueuedResources() const
     return backgroundLoadQueue_.size();
 }
 
+unsigned BackgroundLoader::GetNumPendingDecodeResources() const
+{
+    MutexLock lock(backgroundLoadMutex_);
+    return decodeQueue_.size();
+}
+
+ea::unordered_map<StringHash, BackgroundLoadTypeStats> BackgroundLoader::GetTypeStats() const
+{
+    MutexLock lock(backgroundLoadMutex_);
+    return typeStats_;
+}
+
 void BackgroundLoader::FinishBackgroundLoading(BackgroundLoadItem& item)
 {
     Resource* resource = item.resource_;
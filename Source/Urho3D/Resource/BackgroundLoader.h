@@ -22,19 +22,25 @@
 
 #pragma once
 
+#include <EASTL/deque.h>
 #include <EASTL/hash_set.h>
 #include <EASTL/unordered_map.h>
 
 #include "../Core/Mutex.h"
+#include "../Container/ByteVector.h"
 #include "../Container/Ptr.h"
 #include "../Core/Thread.h"
+#include "../IO/AbstractFile.h"
 #include "../Math/StringHash.h"
 
+#include <atomic>
+
 namespace Urho3D
 {
 
 class Resource;
 class ResourceCache;
+class WorkQueue;
 
 /// Queue item for background loading of a resource.
 struct URHO3D_API BackgroundLoadItem
@@ -47,13 +53,41 @@ struct URHO3D_API BackgroundLoadItem
     ea::hash_set<ea::pair<StringHash, StringHash> > dependents_;
     /// Whether to send failure event.
     bool sendEventOnFailure_;
+
+    /// File contents read ahead of decoding.
+    ByteVector fileData_;
+    /// Name of the file read ahead of decoding.
+    ea::string fileName_;
+    /// File that is too big to be read ahead.
+    AbstractFilePtr file_;
+};
+
+/// Background loading statistics of one resource type.
+struct BackgroundLoadTypeStats
+{
+    /// Number of resources that finished BeginLoad.
+    unsigned numResources_{};
+    /// Total size of loaded files in bytes.
+    unsigned long long numBytes_{};
+    /// Total time spent in BeginLoad in microseconds.
+    long long loadTimeUs_{};
+
+    /// Return average load throughput in bytes per second.
+    double GetThroughput() const { return loadTimeUs_ > 0 ? numBytes_ * 1000000.0 / loadTimeUs_ : 0.0; }
 };
 
 /// Background loader of resources. Owned by the ResourceCache.
+/// Background thread reads files ahead into memory, and BeginLoad of read resources is executed in parallel
+/// on WorkQueue worker threads. If there are no worker threads, BeginLoad is executed in background thread.
 /// @nobind
 class URHO3D_API BackgroundLoader : public RefCounted, public Thread
 {
 public:
+    /// Max size of file that is read into memory ahead of decoding.
+    static constexpr unsigned MaxReadAheadFileSize = 16 * 1024 * 1024;
+    /// Max number of resources that are read and wait for decoding, per decoding thread.
+    static constexpr unsigned MaxReadAheadResourcesPerThread = 4;
+
     /// Construct.
     explicit BackgroundLoader(ResourceCache* owner);
 
@@ -72,17 +106,40 @@ public:
 
     /// Return amount of resources in the load queue.
     unsigned GetNumQueuedResources() const;
+    /// Return amount of resources that are read into memory and wait for decoding.
+    unsigned GetNumPendingDecodeResources() const;
+    /// Return load statistics per resource type.
+    ea::unordered_map<StringHash, BackgroundLoadTypeStats> GetTypeStats() const;
 
 private:
+    /// Read file of the queued resource, into memory if read ahead is enabled. Return whether the file is found.
+    bool ReadResourceFile(BackgroundLoadItem& item, bool readAhead);
+    /// Call BeginLoad for the resource and notify dependents.
+    void LoadResource(BackgroundLoadItem& item, bool fileFound);
+    /// Decode resources from the queue until it is empty. Executed in worker threads.
+    void DecodeResources();
+    /// Start decoding tasks if needed. Should be called from main thread.
+    void StartDecoding();
     /// Finish one background loaded resource.
     void FinishBackgroundLoading(BackgroundLoadItem& item);
 
     /// Resource cache.
     ResourceCache* owner_;
+    /// Work queue used for decoding. Accessed from main thread only.
+    WorkQueue* workQueue_{};
     /// Mutex for thread-safe access to the background load queue.
     mutable Mutex backgroundLoadMutex_;
     /// Resources that are queued for background loading.
     ea::unordered_map<ea::pair<StringHash, StringHash>, BackgroundLoadItem> backgroundLoadQueue_;
+
+    /// Max number of decoding tasks running simultaneously. Zero if decoding is done in background thread.
+    std::atomic<unsigned> maxDecodingTasks_{};
+    /// Number of decoding tasks that are started and not finished.
+    unsigned numDecodingTasks_{};
+    /// Resources that are read and wait for decoding.
+    ea::deque<BackgroundLoadItem*> decodeQueue_;
+    /// Load statistics per resource type.
+    ea::unordered_map<StringHash, BackgroundLoadTypeStats> typeStats_;
 };
 
 }
@@ -28,6 +28,7 @@
 #include "../IO/File.h"
 #include "../IO/Log.h"
 #include "../IO/MemoryBuffer.h"
+#include "../IO/MemoryMappedFile.h"
 #include "../IO/Serializer.h"
 #include "../Resource/BinaryFile.h"
 
@@ -51,6 +52,19 @@ void BinaryFile::RegisterObject(Context* context)
 bool BinaryFile::BeginLoad(Deserializer& source)
 {
     source.Seek(0);
+
+    // Reference memory mapped data instead of copying it
+    if (auto mappedFile = dynamic_cast<MemoryMappedFile*>(&source))
+    {
+        buffer_.Clear();
+        mapping_ = mappedFile->GetMapping();
+        mappedData_ = {mappedFile->GetContiguousData(), mappedFile->GetSize()};
+        SetMemoryUse(mappedData_.size());
+        return true;
+    }
+
+    mapping_ = nullptr;
+    mappedData_ = {};
     buffer_.SetData(source, source.GetSize());
     SetMemoryUse(buffer_.GetBuffer().capacity());
     return true;
@@ -58,7 +72,9 @@ bool BinaryFile::BeginLoad(Deserializer& source)
 
 bool BinaryFile::Save(Serializer& dest) const
 {
-    if (dest.Write(buffer_.GetData(), buffer_.GetSize()) != buffer_.GetSize())
+    const ConstByteSpan data = GetSpan();
+    const auto size = static_cast<unsigned>(data.size());
+    if (dest.Write(data.data(), size) != size)
     {
         URHO3D_LOGERROR("Can not save binary file" + GetName());
         return false;
@@ -71,6 +87,8 @@ bool BinaryFile::SaveObjectCallback(const ea::function<void(Archive&)> serialize
 {
     try
     {
+        mapping_ = nullptr;
+        mappedData_ = {};
         buffer_.Clear();
         BinaryOutputArchive archive{GetContext(), AsSerializer()};
         serializeValue(archive);
@@ -88,7 +106,8 @@ bool BinaryFile::LoadObjectCallback(const ea::function<void(Archive&)> serialize
 {
     try
     {
-        MemoryBuffer readBuffer{buffer_.GetBuffer()};
+        const ConstByteSpan data = GetSpan();
+        MemoryBuffer readBuffer{data.data(), static_cast<unsigned>(data.size())};
         BinaryInputArchive archive{GetContext(), readBuffer};
         serializeValue(archive);
         return true;
@@ -102,40 +121,64 @@ bool BinaryFile::LoadObjectCallback(const ea::function<void(Archive&)> serialize
 
 void BinaryFile::Clear()
 {
+    mapping_ = nullptr;
+    mappedData_ = {};
     buffer_.Clear();
 }
 
 void BinaryFile::SetData(const ByteVector& data)
 {
+    mapping_ = nullptr;
+    mappedData_ = {};
     buffer_.SetData(data);
     SetMemoryUse(buffer_.GetBuffer().capacity());
 }
 
 void BinaryFile::SetText(ea::string_view text)
 {
+    mapping_ = nullptr;
+    mappedData_ = {};
     buffer_.SetData(text.data(), static_cast<unsigned>(text.length()));
     SetMemoryUse(static_cast<unsigned>(buffer_.GetBuffer().capacity()));
 }
 
 const ByteVector& BinaryFile::GetData() const
 {
+    DetachMapping();
     return buffer_.GetBuffer();
 }
 
+ConstByteSpan BinaryFile::GetSpan() const
+{
+    if (mapping_)
+        return mappedData_;
+    return {buffer_.GetData(), buffer_.GetSize()};
+}
+
 ea::string_view BinaryFile::GetText() const
 {
-    const unsigned char* data = buffer_.GetData();
-    const unsigned size = buffer_.GetSize();
-    return {reinterpret_cast<const char*>(data), size};
+    const ConstByteSpan data = GetSpan();
+    return {reinterpret_cast<const char*>(data.data()), data.size()};
 }
 
 StringVector BinaryFile::ReadLines() const
 {
     StringVector result;
-    MemoryBuffer readBuffer{buffer_.GetBuffer()};
+    const ConstByteSpan data = GetSpan();
+    MemoryBuffer readBuffer{data.data(), static_cast<unsigned>(data.size())};
     while (!readBuffer.IsEof())
         result.push_back(readBuffer.ReadLine());
     return result;
 }
 
+void BinaryFile::DetachMapping() const
+{
+    if (!mapping_)
+        return;
+
+    buffer_.SetData(mappedData_.data(), static_cast<unsigned>(mappedData_.size()));
+    mapping_ = nullptr;
+    mappedData_ = {};
+}
+
 }
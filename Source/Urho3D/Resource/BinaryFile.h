@@ -30,11 +30,15 @@
 #include "../Resource/Resource.h"
 
 #include <EASTL/functional.h>
+#include <EASTL/shared_ptr.h>
 
 namespace Urho3D
 {
 
+class MemoryMapping;
+
 /// Resource for generic binary file.
+/// If loaded from memory mapped file, the data is referenced from the mapping until it's modified or requested as vector.
 class URHO3D_API BinaryFile : public Resource
 {
     URHO3D_OBJECT(BinaryFile, Resource);
@@ -68,22 +72,32 @@ public:
     void SetData(const ByteVector& data);
     /// Set data from text.
     void SetText(ea::string_view text);
-    /// Return immutable data.
+    /// Return immutable data. Copies the data from the memory mapping if needed.
     const ByteVector& GetData() const;
+    /// Return immutable data without copying.
+    ConstByteSpan GetSpan() const;
     /// Return immutable data as string view.
     ea::string_view GetText() const;
     /// Return data as text lines.
     StringVector ReadLines() const;
 
     /// Return mutable internal buffer.
-    VectorBuffer& GetMutableBuffer() { return buffer_; }
+    VectorBuffer& GetMutableBuffer() { DetachMapping(); return buffer_; }
     /// Cast to Serializer.
-    Serializer& AsSerializer() { return buffer_; }
+    Serializer& AsSerializer() { DetachMapping(); return buffer_; }
     /// Cast to Deserializer.
-    Deserializer& AsDeserializer() { return buffer_; }
+    Deserializer& AsDeserializer() { DetachMapping(); return buffer_; }
 
 private:
-    VectorBuffer buffer_;
+    /// Copy data from the memory mapping into the buffer and release the mapping.
+    void DetachMapping() const;
+
+    /// Owned data. Empty while the data is referenced from the memory mapping.
+    mutable VectorBuffer buffer_;
+    /// Memory mapping that contains the data, if any.
+    mutable ea::shared_ptr<MemoryMapping> mapping_;
+    /// Data in the memory mapping.
+    mutable ConstByteSpan mappedData_;
 };
 
 template <class T, class ... Args>
@@ -572,17 +572,22 @@ bool Image::BeginLoad(Deserializer& source)
             return false;
         }
 
-        // Read the file to buffer.
+        // Read the file to buffer, unless it's already in memory.
         size_t dataSize(source.GetSize());
-        ea::shared_array<uint8_t> data(new uint8_t[dataSize]);
-
-        memset(data.get(), 0, sizeof(uint8_t) * dataSize);
-        source.Seek(0);
-        source.Read(data.get(), dataSize);
+        ea::shared_array<uint8_t> dataBuffer;
+        const uint8_t* data = source.GetContiguousData();
+        if (!data)
+        {
+            dataBuffer = new uint8_t[dataSize];
+            memset(dataBuffer.get(), 0, sizeof(uint8_t) * dataSize);
+            source.Seek(0);
+            source.Read(dataBuffer.get(), dataSize);
+            data = dataBuffer.get();
+        }
 
         WebPBitstreamFeatures features;
 
-        if (WebPGetFeatures(data.get(), dataSize, &features) != VP8_STATUS_OK)
+        if (WebPGetFeatures(data, dataSize, &features) != VP8_STATUS_OK)
         {
             URHO3D_LOGERROR("Error reading WebP image: " + source.GetName());
             return false;
@@ -594,11 +599,11 @@ bool Image::BeginLoad(Deserializer& source)
         bool decodeError(false);
         if (features.has_alpha)
         {
-            decodeError = WebPDecodeRGBAInto(data.get(), dataSize, pixelData.get(), imgSize, 4 * features.width) == nullptr;
+            decodeError = WebPDecodeRGBAInto(data, dataSize, pixelData.get(), imgSize, 4 * features.width) == nullptr;
         }
         else
         {
-            decodeError = WebPDecodeRGBInto(data.get(), dataSize, pixelData.get(), imgSize, 3 * features.width) == nullptr;
+            decodeError = WebPDecodeRGBInto(data, dataSize, pixelData.get(), imgSize, 3 * features.width) == nullptr;
         }
         if (decodeError)
         {
@@ -2118,6 +2123,13 @@ void Image::GetLevels(ea::vector<const Image*>& levels) const
 
 unsigned char* Image::GetImageData(Deserializer& source, int& width, int& height, unsigned& components)
 {
+    // Decode directly from memory if possible
+    if (const unsigned char* data = source.GetContiguousData())
+    {
+        const unsigned dataSize = source.GetSize() - source.GetPosition();
+        return stbi_load_from_memory(data + source.GetPosition(), dataSize, &width, &height, (int*)&components, 0);
+    }
+
     unsigned dataSize = source.GetSize();
 
     ea::shared_array<unsigned char> buffer(new unsigned char[dataSize]);
@@ -34,6 +34,8 @@
 #include <EASTL/array.h>
 #include <EASTL/optional.h>
 
+#include <atomic>
+
 namespace Urho3D
 {
 
@@ -114,6 +116,8 @@ public:
     void SetMemoryUse(unsigned size);
     /// Reset last used timer.
     void ResetUseTimer();
+    /// Mark resource as used in the frame. Return false if already marked in this frame. Safe to call from worker threads.
+    bool MarkUsed(unsigned frameNumber) { return lastUsedFrame_.exchange(frameNumber, std::memory_order_relaxed) != frameNumber; }
     /// Set the asynchronous loading state. Called by ResourceCache. Resources in the middle of asynchronous loading are not normally returned to user.
     void SetAsyncLoadState(AsyncLoadState newState);
     /// Set absolute file name.
@@ -133,6 +137,14 @@ public:
     /// Return time since last use in milliseconds. If referred to elsewhere than in the resource cache, returns always zero.
     /// @property
     unsigned GetUseTimer();
+    /// Return number of the frame when the resource was last used.
+    unsigned GetLastUsedFrame() const { return lastUsedFrame_.load(std::memory_order_relaxed); }
+
+    /// Release resident data (e.g. GPU objects) that can be restored by reloading the resource. Return true if anything was released.
+    /// Resource should stay safe to use while unloaded and should restore itself when actually used.
+    virtual bool UnloadResidentData() { return false; }
+    /// Return whether resident data is currently unloaded.
+    virtual bool IsResidentDataUnloaded() const { return false; }
 
     /// Return the asynchronous loading state.
     AsyncLoadState GetAsyncLoadState() const { return asyncLoadState_; }
@@ -149,6 +161,8 @@ private:
     ea::string absoluteFileName_;
     /// Last used timer.
     Timer useTimer_;
+    /// Number of the frame when the resource was last used.
+    std::atomic<unsigned> lastUsedFrame_{};
     /// Memory use in bytes.
     unsigned memoryUse_;
     /// Asynchronous loading state.
@@ -44,6 +44,8 @@
 #include <Urho3D/Resource/ResourceEvents.h>
 #include <Urho3D/Resource/XMLFile.h>
 
+#include <EASTL/sort.h>
+
 #include "../DebugNew.h"
 
 #include <cstdio>
@@ -132,6 +134,7 @@ bool ResourceCache::AddManualResource(Resource* resource)
     }
 
     resource->ResetUseTimer();
+    resource->MarkUsed(currentFrame_);
     resourceGroups_[resource->GetType()].resources_[resource->GetNameHash()] = resource;
     UpdateResourceGroup(resource->GetType());
     return true;
@@ -319,6 +322,7 @@ bool ResourceCache::ReloadResource(Resource* resource)
     if (success)
     {
         resource->ResetUseTimer();
+        resource->MarkUsed(currentFrame_);
         UpdateResourceGroup(resource->GetType());
         resource->SendEvent(E_RELOADFINISHED);
         return true;
@@ -406,7 +410,7 @@ AbstractFilePtr ResourceCache::GetFile(const ea::string& name, bool sendEventOnF
     const auto* vfs = GetSubsystem<VirtualFileSystem>();
 
     const FileIdentifier resolvedName = GetResolvedIdentifier(FileIdentifier::FromUri(name));
-    auto file = vfs->OpenFile(resolvedName, FILE_READ);
+    auto file = memoryMappedFiles_ ? vfs->OpenMappedFile(resolvedName) : vfs->OpenFile(resolvedName, FILE_READ);
 
     if (!file && sendEventOnFailure)
     {
@@ -471,7 +475,10 @@ Resource* ResourceCache::GetResource(StringHash type, const ea::string& name, bo
 
     const SharedPtr<Resource>& existing = FindResource(type, nameHash);
     if (existing)
+    {
+        existing->MarkUsed(currentFrame_);
         return existing;
+    }
 
     SharedPtr<Resource> resource;
     // Make sure the pointer is non-null and is a Resource subclass
@@ -519,6 +526,7 @@ Resource* ResourceCache::GetResource(StringHash type, const ea::string& name, bo
 
     // Store to cache
     resource->ResetUseTimer();
+    resource->MarkUsed(currentFrame_);
     resourceGroups_[type].resources_[nameHash] = resource;
     UpdateResourceGroup(type);
 
@@ -823,45 +831,159 @@ void ResourceCache::ReleasePackageResources(PackageFile* package, bool force)
 void ResourceCache::UpdateResourceGroup(StringHash type)
 {
     auto i = resourceGroups_.find(type);
-    if (i == resourceGroups_.end())
-        return;
+    if (i != resourceGroups_.end())
+        UpdateResourceGroup(i->second);
+}
+
+void ResourceCache::UpdateResourceGroup(ResourceGroup& group)
+{
+    group.memoryUse_ = 0;
+    for (const auto& [nameHash, resource] : group.resources_)
+        group.memoryUse_ += resource->GetMemoryUse();
+
+    // Per-type budgets never affect resources in use
+    if (group.memoryBudget_ && group.memoryUse_ > group.memoryBudget_)
+        ReleaseLeastRecentlyUsed(&group, group.memoryUse_ - group.memoryBudget_, false);
+}
+
+void ResourceCache::UpdateResidency()
+{
+    URHO3D_PROFILE("UpdateResourceResidency");
+
+    residencyStats_ = {};
+    if (!unloadedResources_.empty())
+        ReloadUsedResources();
 
-    for (;;)
+    bool hasBudget = globalMemoryBudget_ != 0;
+    for (const auto& [type, group] : resourceGroups_)
+        hasBudget = hasBudget || group.memoryBudget_ != 0;
+
+    // Don't scan resources if there is nothing to enforce
+    if (hasBudget)
     {
-        unsigned totalSize = 0;
-        unsigned oldestTimer = 0;
-        auto oldestResource = i->second.resources_.end();
+        unsigned long long totalMemoryUse = 0;
+        for (auto& [type, group] : resourceGroups_)
+        {
+            UpdateResourceGroup(group);
+            totalMemoryUse += group.memoryUse_;
+        }
 
-        for (auto j = i->second.resources_.begin();
-             j != i->second.resources_.end(); ++j)
+        if (globalMemoryBudget_ && totalMemoryUse > globalMemoryBudget_)
         {
-            totalSize += j->second->GetMemoryUse();
-            unsigned useTimer = j->second->GetUseTimer();
-            if (useTimer > oldestTimer)
-            {
-                oldestTimer = useTimer;
-                oldestResource = j;
-            }
+            const bool unloadReferenced = residentDataUnloadFrames_ != 0;
+            ReleaseLeastRecentlyUsed(nullptr, totalMemoryUse - globalMemoryBudget_, unloadReferenced);
         }
+    }
+
+    for (const auto& [type, group] : resourceGroups_)
+        residencyStats_.numResources_ += group.resources_.size();
+    residencyStats_.memoryUse_ = GetTotalMemoryUse();
+    residencyStats_.numNonResident_ = unloadedResources_.size();
+}
 
-        i->second.memoryUse_ = totalSize;
+void ResourceCache::ReloadUsedResources()
+{
+    // Resources may be unloaded again during reloading, so iterate over a copy
+    const auto unloadedResources = ea::move(unloadedResources_);
+    unloadedResources_.clear();
 
-        // If memory budget defined and is exceeded, remove the oldest resource and loop again
-        // (resources in use always return a zero timer and can not be removed)
-        if (i->second.memoryBudget_ && i->second.memoryUse_ > i->second.memoryBudget_ &&
-            oldestResource != i->second.resources_.end())
+    for (const UnloadedResource& item : unloadedResources)
+    {
+        Resource* resource = item.resource_;
+        // Resource may be already restored on use
+        if (!resource || !resource->IsResidentDataUnloaded())
+            continue;
+
+        if (resource->GetLastUsedFrame() == item.lastUsedFrame_)
         {
-            URHO3D_LOGDEBUG("Resource group " + oldestResource->second->GetTypeName() + " over memory budget, releasing resource " +
-                     oldestResource->second->GetName());
-            i->second.resources_.erase(oldestResource);
+            unloadedResources_.push_back(item);
+            continue;
         }
-        else
+
+        URHO3D_LOGDEBUG("Reloading unloaded resource {}", resource->GetName());
+        ReloadResource(resource);
+        ++residencyStats_.numReloaded_;
+    }
+}
+
+unsigned long long ResourceCache::ReleaseLeastRecentlyUsed(
+    ResourceGroup* group, unsigned long long memoryToRelease, bool unloadReferenced)
+{
+    struct Candidate
+    {
+        ResourceGroup* group_{};
+        Resource* resource_{};
+        bool referenced_{};
+        unsigned lastUsedFrame_{};
+    };
+
+    // Unreferenced resources are released first, then resident data of referenced but unused resources is unloaded
+    ea::vector<Candidate> candidates;
+    const auto collectCandidates = [&](ResourceGroup& resourceGroup)
+    {
+        for (const auto& [nameHash, resource] : resourceGroup.resources_)
+        {
+            if (resource->GetMemoryUse() == 0 || resource->GetAsyncLoadState() != ASYNC_DONE)
+                continue;
+
+            const bool referenced = resource->Refs() > 1;
+            const unsigned lastUsedFrame = resource->GetLastUsedFrame();
+            if (referenced && (!unloadReferenced || currentFrame_ - lastUsedFrame < residentDataUnloadFrames_))
+                continue;
+
+            candidates.push_back(Candidate{&resourceGroup, resource, referenced, lastUsedFrame});
+        }
+    };
+
+    if (group)
+        collectCandidates(*group);
+    else
+    {
+        for (auto& [type, resourceGroup] : resourceGroups_)
+            collectCandidates(resourceGroup);
+    }
+
+    ea::sort(candidates.begin(), candidates.end(), [this](const Candidate& lhs, const Candidate& rhs)
+    {
+        if (lhs.referenced_ != rhs.referenced_)
+            return !lhs.referenced_;
+        return currentFrame_ - lhs.lastUsedFrame_ > currentFrame_ - rhs.lastUsedFrame_;
+    });
+
+    unsigned long long releasedMemory = 0;
+    for (const Candidate& candidate : candidates)
+    {
+        if (releasedMemory >= memoryToRelease)
             break;
+
+        Resource* resource = candidate.resource_;
+        const unsigned memoryUse = resource->GetMemoryUse();
+        if (!candidate.referenced_)
+        {
+            URHO3D_LOGDEBUG("Resource cache over memory budget, releasing resource {}", resource->GetName());
+            candidate.group_->resources_.erase(resource->GetNameHash());
+            candidate.group_->memoryUse_ -= memoryUse;
+            releasedMemory += memoryUse;
+            ++residencyStats_.numEvicted_;
+        }
+        else if (resource->UnloadResidentData())
+        {
+            URHO3D_LOGDEBUG("Resource cache over memory budget, unloading resource {}", resource->GetName());
+            const unsigned releasedResourceMemory = memoryUse - ea::min(memoryUse, resource->GetMemoryUse());
+            candidate.group_->memoryUse_ -= releasedResourceMemory;
+            releasedMemory += releasedResourceMemory;
+            unloadedResources_.push_back(UnloadedResource{WeakPtr<Resource>(resource), resource->GetLastUsedFrame()});
+            ++residencyStats_.numUnloaded_;
+        }
     }
+    return releasedMemory;
 }
 
 void ResourceCache::HandleBeginFrame(StringHash eventType, VariantMap& eventData)
 {
+    using namespace BeginFrame;
+    currentFrame_ = eventData[P_FRAMENUMBER].GetUInt();
+
     // Check for background loaded resources that can be finished
 #ifdef URHO3D_THREADING
     {
@@ -869,6 +991,8 @@ void ResourceCache::HandleBeginFrame(StringHash eventType, VariantMap& eventData
         backgroundLoader_->FinishResources(finishBackgroundResourcesMs_);
     }
 #endif
+
+    UpdateResidency();
 }
 
 void ResourceCache::HandleFileChanged(StringHash eventType, VariantMap& eventData)
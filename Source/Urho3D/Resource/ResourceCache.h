@@ -62,6 +62,23 @@ struct ResourceGroup
     ea::unordered_map<StringHash, SharedPtr<Resource> > resources_;
 };
 
+/// Resource residency statistics of the last frame.
+struct ResourceResidencyStats
+{
+    /// Total memory use of all resources after the update.
+    unsigned long long memoryUse_{};
+    /// Number of resources in the cache.
+    unsigned numResources_{};
+    /// Number of unreferenced resources released from the cache.
+    unsigned numEvicted_{};
+    /// Number of referenced resources whose resident data was unloaded.
+    unsigned numUnloaded_{};
+    /// Number of unloaded resources that were used again and reloaded.
+    unsigned numReloaded_{};
+    /// Number of resources that currently have resident data unloaded.
+    unsigned numNonResident_{};
+};
+
 
 /// Optional resource request processor.
 /// Can deny requests, re-route resource file names, or perform other processing per request.
@@ -113,6 +130,12 @@ public:
     /// Set memory budget for a specific resource type, default 0 is unlimited.
     /// @property
     void SetMemoryBudget(StringHash type, unsigned long long budget);
+    /// Set memory budget for all resources, default 0 is unlimited. Enforced once per frame.
+    void SetGlobalMemoryBudget(unsigned long long budget) { globalMemoryBudget_ = budget; }
+    /// Set how many frames referenced resource should stay unused before its resident data may be unloaded when over global memory budget.
+    /// Default 0 disables unloading, so only unreferenced resources are released.
+    /// Only materials of visible drawables and resource lookups mark resources as used, other resources are reloaded on their next use.
+    void SetResidentDataUnloadFrames(unsigned frames) { residentDataUnloadFrames_ = frames; }
     /// Enable or disable returning resources that failed to load. Default false. This may be useful in editing to not lose resource ref attributes.
     /// @property
     void SetReturnFailedResources(bool enable) { returnFailedResources_ = enable; }
@@ -120,6 +143,9 @@ public:
     /// Define whether when getting resources should check package files or directories first. True for packages, false for directories.
     /// @property
     void SetSearchPackagesFirst(bool value) { searchPackagesFirst_ = value; }
+    /// Enable or disable opening resource files as read-only memory-mapped views when possible. Default false.
+    /// Files should not be modified or truncated while mapped.
+    void SetMemoryMappedFiles(bool enable) { memoryMappedFiles_ = enable; }
 
     /// Set how many milliseconds maximum per frame to spend on finishing background loaded resources.
     /// @property
@@ -141,6 +167,8 @@ public:
     /// Return number of pending background-loaded resources.
     /// @property
     unsigned GetNumBackgroundLoadResources() const;
+    /// Return background loader. May be null if threading is disabled.
+    BackgroundLoader* GetBackgroundLoader() const { return backgroundLoader_; }
     /// Return all loaded resources of a specific type.
     void GetResources(ea::vector<Resource*>& result, StringHash type) const;
     /// Return an already loaded resource of specific type & name, or null if not found. Will not load if does not exist. Specifying zero type will search all types.
@@ -172,6 +200,12 @@ public:
     /// Return total memory use for all resources.
     /// @property
     unsigned long long GetTotalMemoryUse() const;
+    /// Return memory budget for all resources.
+    unsigned long long GetGlobalMemoryBudget() const { return globalMemoryBudget_; }
+    /// Return how many frames referenced resource should stay unused before its resident data may be unloaded.
+    unsigned GetResidentDataUnloadFrames() const { return residentDataUnloadFrames_; }
+    /// Return residency statistics of the last frame.
+    const ResourceResidencyStats& GetResidencyStats() const { return residencyStats_; }
     /// Return full absolute file name of resource if possible, or empty if not found.
     ea::string GetResourceFileName(const ea::string& name) const;
 
@@ -182,6 +216,8 @@ public:
     /// Return whether when getting resources should check package files or directories first.
     /// @property
     bool GetSearchPackagesFirst() const { return searchPackagesFirst_; }
+    /// Return whether resource files are opened as memory-mapped views when possible.
+    bool GetMemoryMappedFiles() const { return memoryMappedFiles_; }
 
     /// Return how many milliseconds maximum to spend on finishing background loaded resources.
     /// @property
@@ -213,6 +249,8 @@ public:
     void RouteResourceName(FileIdentifier& name) const;
     /// Clear all resources from resource cache.
     void Clear();
+    /// Enforce memory budgets and reload unloaded resources that are used again. Called automatically every frame.
+    void UpdateResidency();
 
     /// Return canonical resource identifier without resource routing.
     FileIdentifier GetCanonicalIdentifier(const FileIdentifier& name) const;
@@ -228,6 +266,14 @@ private:
     void ReleasePackageResources(PackageFile* package, bool force = false);
     /// Update a resource group. Recalculate memory use and release resources if over memory budget.
     void UpdateResourceGroup(StringHash type);
+    /// Update a resource group. Recalculate memory use and release least recently used unreferenced resources if over memory budget.
+    void UpdateResourceGroup(ResourceGroup& group);
+    /// Reload unloaded resources that were used since they have been unloaded.
+    void ReloadUsedResources();
+    /// Release least recently used unreferenced resources of the group, or of all groups if null.
+    /// Optionally unload resident data of referenced resources. Return amount of released memory.
+    unsigned long long ReleaseLeastRecentlyUsed(
+        ResourceGroup* group, unsigned long long memoryToRelease, bool unloadReferenced);
     /// Handle begin frame event. The finalization of background loaded resources are processed here.
     void HandleBeginFrame(StringHash eventType, VariantMap& eventData);
     /// Handle file changed to reload resource.
@@ -249,10 +295,32 @@ private:
     bool returnFailedResources_;
     /// Search priority flag.
     bool searchPackagesFirst_;
+    /// Whether to open resource files as memory-mapped views.
+    bool memoryMappedFiles_{};
     /// How many milliseconds maximum per frame to spend on finishing background loaded resources.
     int finishBackgroundResourcesMs_;
     /// List of resources that will not be auto-reloaded if reloading event triggers.
     ea::vector<ea::string> ignoreResourceAutoReload_;
+
+    /// Resource with unloaded resident data.
+    struct UnloadedResource
+    {
+        /// Resource.
+        WeakPtr<Resource> resource_;
+        /// Last used frame at the moment of unloading.
+        unsigned lastUsedFrame_{};
+    };
+
+    /// Memory budget for all resources.
+    unsigned long long globalMemoryBudget_{};
+    /// Number of unused frames before resident data may be unloaded.
+    unsigned residentDataUnloadFrames_{};
+    /// Current frame number.
+    unsigned currentFrame_{};
+    /// Resources with unloaded resident data.
+    ea::vector<UnloadedResource> unloadedResources_;
+    /// Residency statistics of the last frame.
+    ResourceResidencyStats residencyStats_;
 };
 
 template <class T> T* ResourceCache::GetExistingResource(const ea::string& name)
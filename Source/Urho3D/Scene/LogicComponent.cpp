@@ -29,6 +29,7 @@
 #include "../Scene/LogicComponent.h"
 #include "../Scene/Scene.h"
 #include "../Scene/SceneEvents.h"
+#include "../Scene/SceneUpdateGraph.h"
 
 namespace Urho3D
 {
@@ -83,6 +84,26 @@ void LogicComponent::SetUpdateEventMask(UpdateEventFlags mask)
     }
 }
 
+void LogicComponent::SetScheduledUpdate(bool enable)
+{
+    if (scheduledUpdate_ != enable)
+    {
+        scheduledUpdate_ = enable;
+        UpdateEventSubscription();
+    }
+}
+
+void LogicComponent::DeclareUpdateAccess(SceneUpdateAccess& access) const
+{
+    access.NodeTransform(node_);
+}
+
+void LogicComponent::ResetUpdateEventSubscription()
+{
+    UnsubscribeFromSceneUpdates(GetScene());
+    UpdateEventSubscription();
+}
+
 void LogicComponent::OnNodeSet(Node* previousNode, Node* currentNode)
 {
     if (node_)
@@ -103,8 +124,7 @@ void LogicComponent::OnSceneSet(Scene* previousScene, Scene* scene)
         UpdateEventSubscription();
     else
     {
-        UnsubscribeFromEvent(GetUpdateEvent());
-        UnsubscribeFromEvent(GetPostUpdateEvent());
+        UnsubscribeFromSceneUpdates(previousScene);
 #if defined(URHO3D_PHYSICS) || defined(URHO3D_PHYSICS2D)
         UnsubscribeFromEvent(E_PHYSICSPRESTEP);
         UnsubscribeFromEvent(E_PHYSICSPOSTSTEP);
@@ -121,27 +141,48 @@ void LogicComponent::UpdateEventSubscription()
 
     bool enabled = IsEnabledEffective();
 
+    // Switch between events and update graph if needed
+    const bool scheduled = scheduledUpdate_ && scene->IsScheduledUpdate();
+    if (scheduled != scheduledSubscription_)
+    {
+        UnsubscribeFromSceneUpdates(scene);
+        scheduledSubscription_ = scheduled;
+    }
+    SceneUpdateGraph* updateGraph = scene->GetUpdateGraph();
+
     bool needUpdate = enabled && ((updateEventMask_ & USE_UPDATE) || !delayedStartCalled_);
     if (needUpdate && !(currentEventMask_ & USE_UPDATE))
     {
-        SubscribeToEvent(scene, GetUpdateEvent(), URHO3D_HANDLER(LogicComponent, HandleSceneUpdate));
+        if (scheduled)
+            updateGraph->Add(GetUpdateEvent(), this);
+        else
+            SubscribeToEvent(scene, GetUpdateEvent(), URHO3D_HANDLER(LogicComponent, HandleSceneUpdate));
         currentEventMask_ |= USE_UPDATE;
     }
     else if (!needUpdate && (currentEventMask_ & USE_UPDATE))
     {
-        UnsubscribeFromEvent(scene, GetUpdateEvent());
+        if (scheduled)
+            updateGraph->Remove(GetUpdateEvent(), this);
+        else
+            UnsubscribeFromEvent(scene, GetUpdateEvent());
         currentEventMask_ &= ~USE_UPDATE;
     }
 
     bool needPostUpdate = enabled && (updateEventMask_ & USE_POSTUPDATE);
     if (needPostUpdate && !(currentEventMask_ & USE_POSTUPDATE))
     {
-        SubscribeToEvent(scene, GetPostUpdateEvent(), URHO3D_HANDLER(LogicComponent, HandleScenePostUpdate));
+        if (scheduled)
+            updateGraph->Add(GetPostUpdateEvent(), this);
+        else
+            SubscribeToEvent(scene, GetPostUpdateEvent(), URHO3D_HANDLER(LogicComponent, HandleScenePostUpdate));
         currentEventMask_ |= USE_POSTUPDATE;
     }
     else if (!needPostUpdate && (currentEventMask_ & USE_POSTUPDATE))
     {
-        UnsubscribeFromEvent(scene, GetPostUpdateEvent());
+        if (scheduled)
+            updateGraph->Remove(GetPostUpdateEvent(), this);
+        else
+            UnsubscribeFromEvent(scene, GetPostUpdateEvent());
         currentEventMask_ &= ~USE_POSTUPDATE;
     }
 
@@ -176,6 +217,47 @@ void LogicComponent::UpdateEventSubscription()
 #endif
 }
 
+void LogicComponent::UnsubscribeFromSceneUpdates(Scene* scene)
+{
+    if (scheduledSubscription_)
+    {
+        if (scene)
+        {
+            SceneUpdateGraph* updateGraph = scene->GetUpdateGraph();
+            updateGraph->Remove(GetUpdateEvent(), this);
+            updateGraph->Remove(GetPostUpdateEvent(), this);
+        }
+    }
+    else
+    {
+        UnsubscribeFromEvent(GetUpdateEvent());
+        UnsubscribeFromEvent(GetPostUpdateEvent());
+    }
+    currentEventMask_ &= ~(USE_UPDATE | USE_POSTUPDATE);
+}
+
+void LogicComponent::ScheduledDelayedStart()
+{
+    DelayedStart();
+    delayedStartCalled_ = true;
+
+    // If did not need actual update events, unsubscribe now
+    Scene* scene = GetScene();
+    if (scene && scheduledSubscription_ && !(updateEventMask_ & USE_UPDATE))
+    {
+        scene->GetUpdateGraph()->Remove(GetUpdateEvent(), this);
+        currentEventMask_ &= ~USE_UPDATE;
+    }
+}
+
+void LogicComponent::ScheduledUpdate(StringHash eventType, float timeStep)
+{
+    if (eventType == GetUpdateEvent())
+        Update(timeStep);
+    else
+        PostUpdate(timeStep);
+}
+
 void LogicComponent::HandleSceneUpdate(StringHash eventType, VariantMap& eventData)
 {
     using namespace SceneUpdate;
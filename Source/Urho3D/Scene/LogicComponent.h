@@ -30,6 +30,8 @@
 namespace Urho3D
 {
 
+class SceneUpdateAccess;
+
 enum UpdateEvent : unsigned
 {
     /// Bitmask for not using any events.
@@ -89,6 +91,19 @@ public:
     /// Return what update events are subscribed to.
     UpdateEventFlags GetUpdateEventMask() const { return updateEventMask_; }
 
+    /// Set whether Update and PostUpdate may be scheduled by the scene instead of being called from events.
+    /// Scheduled updates are called from worker threads if Scene::SetScheduledUpdate is enabled,
+    /// so they must not send events, create or remove nodes and components, or touch undeclared resources.
+    /// Note that this is not an attribute, therefore it should always be called eg. in the subclass constructor.
+    void SetScheduledUpdate(bool enable);
+    /// Return whether the component supports scheduled update.
+    bool IsScheduledUpdate() const { return scheduledUpdate_; }
+    /// Declare resources accessed by scheduled Update and PostUpdate besides own state of the component.
+    /// Called from main thread whenever the scene rebuilds update graph. By default, own node transform is accessed.
+    virtual void DeclareUpdateAccess(SceneUpdateAccess& access) const;
+    /// Re-subscribe to update events. Should be called when scene update mode is changed.
+    void ResetUpdateEventSubscription();
+
     /// Return whether the DelayedStart() function has been called.
     bool IsDelayedStartCalled() const { return delayedStartCalled_; }
 
@@ -99,8 +114,16 @@ protected:
     void OnSceneSet(Scene* previousScene, Scene* scene) override;
 
 private:
+    friend class SceneUpdateGraph;
+
     /// Subscribe/unsubscribe to update events based on current enabled state and update event mask.
     void UpdateEventSubscription();
+    /// Unsubscribe from scene update and post-update events.
+    void UnsubscribeFromSceneUpdates(Scene* scene);
+    /// Execute delayed start before the first scheduled update.
+    void ScheduledDelayedStart();
+    /// Execute scheduled update for given update event.
+    void ScheduledUpdate(StringHash eventType, float timeStep);
     /// Handle scene update event.
     void HandleSceneUpdate(StringHash eventType, VariantMap& eventData);
     /// Handle scene post-update event.
@@ -117,6 +140,10 @@ private:
     UpdateEventFlags currentEventMask_;
     /// Flag for delayed start.
     bool delayedStartCalled_;
+    /// Whether the component supports scheduled update.
+    bool scheduledUpdate_{};
+    /// Whether current scene update subscription uses scene update graph.
+    bool scheduledSubscription_{};
 };
 
 }
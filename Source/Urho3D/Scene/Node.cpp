@@ -933,6 +933,13 @@ void Node::MarkDirty()
     Node *cur = this;
     for (;;)
     {
+        // In batched transform update mode dirty flags are propagated and listeners are notified by the hierarchy
+        if (cur->hierarchy_)
+        {
+            cur->hierarchy_->MarkNodeDirty(cur->hierarchyIndex_);
+            return;
+        }
+
         // Precondition:
         // a) whenever a node is marked dirty, all its children are marked dirty as well.
         // b) whenever a node is cleared from being dirty, all its parents must have been
@@ -945,22 +952,7 @@ void Node::MarkDirty()
         cur->dirty_ = true;
 
         // Notify listener components first, then mark child nodes
-        for (auto i = cur->listeners_.begin(); i !=
-            cur->listeners_.end();)
-        {
-            Component *c = i->Get();
-            if (c)
-            {
-                c->OnMarkedDirty(cur);
-                ++i;
-            }
-            // If listener has expired, erase from list (swap with the last element to avoid O(n^2) behavior)
-            else
-            {
-                *i = cur->listeners_.back();
-                cur->listeners_.pop_back();
-            }
-        }
+        cur->NotifyListeners();
 
         // Tail call optimization: Don't recurse to mark the first child dirty, but
         // instead process it in the context of the current function. If there are more
@@ -978,6 +970,25 @@ void Node::MarkDirty()
     }
 }
 
+void Node::NotifyListeners()
+{
+    for (auto i = listeners_.begin(); i != listeners_.end();)
+    {
+        Component *c = i->Get();
+        if (c)
+        {
+            c->OnMarkedDirty(this);
+            ++i;
+        }
+        // If listener has expired, erase from list (swap with the last element to avoid O(n^2) behavior)
+        else
+        {
+            *i = listeners_.back();
+            listeners_.pop_back();
+        }
+    }
+}
+
 Node* Node::CreateChild(const ea::string& name, unsigned id, bool temporary)
 {
     Node* newNode = CreateChild(id, temporary);
@@ -1319,10 +1330,7 @@ void Node::RemoveListener(Component* component)
 
 Vector3 Node::GetSignedWorldScale() const
 {
-    if (dirty_)
-        UpdateWorldTransform();
-
-    return worldTransform_.SignedScale(worldRotation_.RotationMatrix());
+    return GetWorldTransform().SignedScale(GetWorldRotation().RotationMatrix());
 }
 
 Vector3 Node::LocalToWorld(const Vector3& position) const
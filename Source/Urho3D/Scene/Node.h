@@ -30,6 +30,7 @@
 #include "../Scene/Component.h"
 #include "../Scene/PrefabTypes.h"
 #include "../Scene/Serializable.h"
+#include "../Scene/TransformHierarchy.h"
 
 #include <EASTL/type_traits.h>
 
@@ -110,6 +111,7 @@ class URHO3D_API Node : public Serializable
     URHO3D_OBJECT(Node, Serializable);
 
     friend class Connection;
+    friend class TransformHierarchy;
 
 public:
     /// Construct.
@@ -523,10 +525,7 @@ public:
     /// @property
     Vector3 GetWorldPosition() const
     {
-        if (dirty_)
-            UpdateWorldTransform();
-
-        return worldTransform_.Translation();
+        return GetWorldTransform().Translation();
     }
 
     /// Return position in world space (for Urho2D).
@@ -541,6 +540,9 @@ public:
     /// @property
     Quaternion GetWorldRotation() const
     {
+        if (hierarchy_)
+            return hierarchy_->GetWorldRotation(hierarchyIndex_);
+
         if (dirty_)
             UpdateWorldTransform();
 
@@ -558,40 +560,28 @@ public:
     /// @property
     Vector3 GetWorldDirection() const
     {
-        if (dirty_)
-            UpdateWorldTransform();
-
-        return worldRotation_ * Vector3::FORWARD;
+        return GetWorldRotation() * Vector3::FORWARD;
     }
 
     /// Return node's up vector in world space.
     /// @property
     Vector3 GetWorldUp() const
     {
-        if (dirty_)
-            UpdateWorldTransform();
-
-        return worldRotation_ * Vector3::UP;
+        return GetWorldRotation() * Vector3::UP;
     }
 
     /// Return node's right vector in world space.
     /// @property
     Vector3 GetWorldRight() const
     {
-        if (dirty_)
-            UpdateWorldTransform();
-
-        return worldRotation_ * Vector3::RIGHT;
+        return GetWorldRotation() * Vector3::RIGHT;
     }
 
     /// Return scale in world space.
     /// @property
     Vector3 GetWorldScale() const
     {
-        if (dirty_)
-            UpdateWorldTransform();
-
-        return worldTransform_.Scale();
+        return GetWorldTransform().Scale();
     }
 
     /// Return signed scale in world space. Utilized for Urho2D physics.
@@ -610,6 +600,9 @@ public:
     /// @property
     const Matrix3x4& GetWorldTransform() const
     {
+        if (hierarchy_)
+            return hierarchy_->GetWorldTransform(hierarchyIndex_);
+
         if (dirty_)
             UpdateWorldTransform();
 
@@ -630,7 +623,7 @@ public:
     Vector2 WorldToLocal2D(const Vector2& vector) const;
 
     /// Return whether transform has changed and world transform needs recalculation.
-    bool IsDirty() const { return dirty_; }
+    bool IsDirty() const { return hierarchy_ ? hierarchy_->IsNodeDirty(hierarchyIndex_) : dirty_.load(); }
 
     /// Return number of child scene nodes.
     unsigned GetNumChildren(bool recursive = false) const;
@@ -811,6 +804,8 @@ private:
     Component* SafeCreateComponent(const ea::string& typeName, StringHash type, unsigned id);
     /// Recalculate the world transform.
     void UpdateWorldTransform() const;
+    /// Notify listener components that the node is marked dirty. Expired listeners are removed.
+    void NotifyListeners();
     /// Remove child node by iterator.
     void RemoveChild(ea::vector<SharedPtr<Node> >::iterator i);
     /// Return child nodes recursively.
@@ -835,6 +830,10 @@ private:
     mutable Matrix3x4 worldTransform_;
     /// World transform needs update flag.
     mutable std::atomic_bool dirty_;
+    /// Transform hierarchy that owns world transform of the node in batched transform update mode.
+    TransformHierarchy* hierarchy_{};
+    /// Index of the node in transform hierarchy.
+    unsigned hierarchyIndex_{};
     /// Enabled flag.
     bool enabled_;
     /// Last SetEnabled flag before any SetDeepEnabled.
@@ -27,6 +27,7 @@
 #include "Urho3D/Core/Context.h"
 #include "Urho3D/Core/CoreEvents.h"
 #include "Urho3D/Core/Profiler.h"
+#include "Urho3D/Core/TypedEvent.h"
 #include "Urho3D/Core/WorkQueue.h"
 #include "Urho3D/Graphics/Texture2D.h"
 #include "Urho3D/IO/Archive.h"
@@ -38,13 +39,16 @@
 #include "Urho3D/Resource/XMLArchive.h"
 #include "Urho3D/Resource/XMLFile.h"
 #include "Urho3D/Scene/Component.h"
+#include "Urho3D/Scene/LogicComponent.h"
 #include "Urho3D/Scene/ObjectAnimation.h"
 #include "Urho3D/Scene/PrefabReference.h"
 #include "Urho3D/Scene/PrefabResource.h"
 #include "Urho3D/Scene/SceneEvents.h"
 #include "Urho3D/Scene/SceneResource.h"
+#include "Urho3D/Scene/SceneUpdateGraph.h"
 #include "Urho3D/Scene/ShakeComponent.h"
 #include "Urho3D/Scene/SplinePath.h"
+#include "Urho3D/Scene/TransformHierarchy.h"
 #include "Urho3D/Scene/UnknownComponent.h"
 #include "Urho3D/Scene/ValueAnimation.h"
 
@@ -76,6 +80,7 @@ Scene::Scene(Context* context) :
     lightmaps_(Texture2D::GetTypeStatic())
 {
     SetUpdateEvents(DefaultUpdateEvents);
+    updateGraph_ = ea::make_unique<SceneUpdateGraph>(this);
 
     // Assign an ID to self so that nodes can refer to this node as a parent
     SetID(GetFreeNodeID());
@@ -87,6 +92,9 @@ Scene::Scene(Context* context) :
 
 Scene::~Scene()
 {
+    // Detach nodes while they are still alive
+    transformHierarchy_ = nullptr;
+
     // Remove root-level components first, so that scene subsystems such as the octree destroy themselves. This will speed up
     // the removal of child nodes' components
     RemoveAllComponents();
@@ -747,6 +755,47 @@ void Scene::SetUpdateEnabled(bool enable)
     }
 }
 
+void Scene::SetScheduledUpdate(bool enable)
+{
+    if (scheduledUpdate_ == enable)
+        return;
+
+    scheduledUpdate_ = enable;
+    UpdateHierarchySubscription();
+
+    for (const auto& [id, component] : replicatedComponents_)
+    {
+        if (auto logicComponent = dynamic_cast<LogicComponent*>(component))
+        {
+            if (logicComponent->IsScheduledUpdate())
+                logicComponent->ResetUpdateEventSubscription();
+        }
+    }
+}
+
+void Scene::SetBatchedTransformUpdate(bool enable)
+{
+    if (batchedTransformUpdate_ == enable)
+        return;
+
+    batchedTransformUpdate_ = enable;
+    if (batchedTransformUpdate_)
+        transformHierarchy_ = ea::make_unique<TransformHierarchy>(this);
+    else
+    {
+        // Notify listeners of pending dirty nodes before returning to immediate propagation
+        transformHierarchy_->MarkStructureDirty();
+        transformHierarchy_ = nullptr;
+    }
+    UpdateHierarchySubscription();
+}
+
+void Scene::UpdateTransforms()
+{
+    if (transformHierarchy_)
+        transformHierarchy_->Update();
+}
+
 void Scene::SetTimeScale(float scale)
 {
     timeScale_ = Max(scale, M_EPSILON);
@@ -830,14 +879,36 @@ void Scene::Update(float timeStep)
 
     timeStep *= timeScale_;
 
-    VariantMap& eventData = GetEventDataMap();
-    eventData[SceneUpdate::P_SCENE] = this;
-    eventData[SceneUpdate::P_TIMESTEP] = timeStep;
+    // Commit transforms changed since last update, so listeners are notified before scene update
+    UpdateTransforms();
 
     for (const auto& [eventId, isForced] : cookedUpdateEvents_)
     {
         if (updateEnabled_ || isForced)
+        {
+            // Event data is filled for each event because listeners notified in between may send events too
+            VariantMap& eventData = GetEventDataMap();
+            eventData[SceneUpdate::P_SCENE] = this;
+            eventData[SceneUpdate::P_TIMESTEP] = timeStep;
+
             SendEvent(eventId, eventData);
+            if (scheduledUpdate_)
+                updateGraph_->Update(eventId, timeStep);
+
+            if (eventId == E_SCENEUPDATE)
+            {
+                SceneUpdateTypedEvent typedEvent{this, timeStep};
+                SendTypedEvent(typedEvent);
+            }
+            else if (eventId == E_SCENEPOSTUPDATE)
+            {
+                ScenePostUpdateTypedEvent typedEvent{this, timeStep};
+                SendTypedEvent(typedEvent);
+            }
+
+            // Commit transforms between update phases, so listeners are notified before the next phase
+            UpdateTransforms();
+        }
     }
 
     if (updateEnabled_)
@@ -858,6 +929,10 @@ void Scene::BeginThreadedUpdate()
 
 void Scene::EndThreadedUpdate()
 {
+    // Commit transforms before leaving threaded mode, so listeners handle them as if nodes were marked dirty
+    // from worker threads
+    UpdateTransforms();
+
     if (!threadedUpdate_)
         return;
 
@@ -1047,6 +1122,29 @@ void Scene::HandleUpdate(StringHash eventType, VariantMap& eventData)
     Update(eventData[P_TIMESTEP].GetFloat());
 }
 
+void Scene::UpdateHierarchySubscription()
+{
+    // Transform access is grouped by top-level nodes and transform hierarchy stores flat node list,
+    // so any reparenting invalidates both
+    if (scheduledUpdate_ || batchedTransformUpdate_)
+    {
+        SubscribeToEvent(this, E_NODEADDED, URHO3D_HANDLER(Scene, HandleHierarchyChanged));
+        SubscribeToEvent(this, E_NODEREMOVED, URHO3D_HANDLER(Scene, HandleHierarchyChanged));
+    }
+    else
+    {
+        UnsubscribeFromEvent(this, E_NODEADDED);
+        UnsubscribeFromEvent(this, E_NODEREMOVED);
+    }
+}
+
+void Scene::HandleHierarchyChanged(StringHash eventType, VariantMap& eventData)
+{
+    updateGraph_->MarkDirty();
+    if (transformHierarchy_)
+        transformHierarchy_->MarkStructureDirty();
+}
+
 void Scene::HandleResourceBackgroundLoaded(StringHash eventType, VariantMap& eventData)
 {
     using namespace ResourceBackgroundLoaded;
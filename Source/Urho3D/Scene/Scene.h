@@ -39,7 +39,9 @@ namespace Urho3D
 
 class File;
 class PackageFile;
+class SceneUpdateGraph;
 class Texture2D;
+class TransformHierarchy;
 
 /// TODO: Get rid of "replicated" word in the code. It is not used in the networking code anymore.
 static const unsigned FIRST_REPLICATED_ID = 0x1;
@@ -114,6 +116,23 @@ public:
 
     /// Set whether the scene is updated manually by external code.
     void SetManualUpdate(bool enabled) { manualUpdate_ = enabled; }
+    /// Set whether logic components that support scheduled update are updated in parallel according to
+    /// their declared access instead of receiving update events. Only events from update event list are scheduled.
+    void SetScheduledUpdate(bool enable);
+    /// Return whether scheduled update is enabled.
+    bool IsScheduledUpdate() const { return scheduledUpdate_; }
+    /// Return update graph used for scheduled update.
+    SceneUpdateGraph* GetUpdateGraph() const { return updateGraph_.get(); }
+    /// Set whether node transforms are marked dirty without immediate propagation to children and listeners.
+    /// World transforms are updated in batches and listeners are notified between scene update phases.
+    void SetBatchedTransformUpdate(bool enable);
+    /// Return whether batched transform update is enabled.
+    bool IsBatchedTransformUpdate() const { return batchedTransformUpdate_; }
+    /// Update world transforms of all dirty nodes and notify their listeners if batched transform update is enabled.
+    /// Called automatically during scene update and octree update.
+    void UpdateTransforms();
+    /// Return transform hierarchy used for batched transform update.
+    TransformHierarchy* GetTransformHierarchy() const { return transformHierarchy_.get(); }
 
     /// Create component index. Scene must be empty.
     bool CreateComponentIndex(StringHash componentType);
@@ -296,6 +315,10 @@ public:
 private:
     /// Handle the logic update event to update the scene, if active.
     void HandleUpdate(StringHash eventType, VariantMap& eventData);
+    /// Subscribe to hierarchy changes if scheduled update or batched transform update is enabled.
+    void UpdateHierarchySubscription();
+    /// Handle scene hierarchy change while in scheduled update or batched transform update mode.
+    void HandleHierarchyChanged(StringHash eventType, VariantMap& eventData);
     /// Handle a background loaded resource completing.
     void HandleResourceBackgroundLoaded(StringHash eventType, VariantMap& eventData);
     /// Update asynchronous loading.
@@ -356,6 +379,14 @@ private:
     bool updateEnabled_;
     /// Whether update is invoked manually.
     bool manualUpdate_{};
+    /// Whether scheduled update is enabled.
+    bool scheduledUpdate_{};
+    /// Graph of scheduled component updates.
+    ea::unique_ptr<SceneUpdateGraph> updateGraph_;
+    /// Whether batched transform update is enabled.
+    bool batchedTransformUpdate_{};
+    /// Transform hierarchy used for batched transform update. Exists only if batched transform update is enabled.
+    ea::unique_ptr<TransformHierarchy> transformHierarchy_;
     /// Asynchronous loading flag.
     bool asyncLoading_;
     /// Threaded update flag.
@@ -27,6 +27,8 @@
 namespace Urho3D
 {
 
+class Scene;
+
 /// Scene paused or resumed. Check current scene state via IsUpdateEnabled() method.
 URHO3D_EVENT(E_SCENEUPDATESCHANGED, SceneUpdateChanged)
 {
@@ -56,6 +58,23 @@ URHO3D_SCENE_UPDATE_EVENT(E_SCENEFORCEDPOSTUPDATE, SceneForcedPostUpdate); // Se
 
 /// @}
 
+/// Typed versions of scene update events. Sent by the scene right after corresponding events.
+/// @{
+struct SceneUpdateTypedEvent
+{
+    URHO3D_TYPED_EVENT(SceneUpdateTypedEvent);
+    Scene* scene_{};
+    float timeStep_{};
+};
+
+struct ScenePostUpdateTypedEvent
+{
+    URHO3D_TYPED_EVENT(ScenePostUpdateTypedEvent);
+    Scene* scene_{};
+    float timeStep_{};
+};
+/// @}
+
 /// Network-aware scene update.
 /// In standalone mode, SceneNetworkUpdate is equivalent to SceneUpdate.
 /// In server mode, SceneNetworkUpdate is called once per network frame with fixed timestep.
@@ -207,7 +207,8 @@ bool SceneResource::EndLoad()
             }
             case InternalResourceFormat::Binary:
             {
-                MemoryBuffer readBuffer{loadBinaryFile_->GetData()};
+                const ConstByteSpan data = loadBinaryFile_->GetSpan();
+                MemoryBuffer readBuffer{data.data(), static_cast<unsigned>(data.size())};
                 readBuffer.SeekRelative(BinaryMagicSize);
 
                 BinaryInputArchive archive{GetContext(), readBuffer};
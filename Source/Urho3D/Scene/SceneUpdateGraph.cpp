@@ -0,0 +1,314 @@
+//
+// Copyright (c) 2017-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "Urho3D/Precompiled.h"
+
+#include "Urho3D/Scene/SceneUpdateGraph.h"
+
+#include "Urho3D/Core/Profiler.h"
+#include "Urho3D/Core/WorkQueue.h"
+#include "Urho3D/Scene/LogicComponent.h"
+#include "Urho3D/Scene/Scene.h"
+
+#include "Urho3D/DebugNew.h"
+
+namespace Urho3D
+{
+
+void SceneUpdateAccess::NodeTransform(Node* node)
+{
+    if (node)
+        nodeTransforms_.push_back(node);
+}
+
+void SceneUpdateAccess::Read(StringHash resource)
+{
+    reads_.push_back(resource);
+}
+
+void SceneUpdateAccess::Write(StringHash resource)
+{
+    writes_.push_back(resource);
+}
+
+void SceneUpdateAccess::Clear()
+{
+    nodeTransforms_.clear();
+    reads_.clear();
+    writes_.clear();
+    exclusive_ = false;
+}
+
+SceneUpdateGraph::SceneUpdateGraph(Scene* scene)
+    : scene_(scene)
+    , workQueue_(scene->GetSubsystem<WorkQueue>())
+{
+}
+
+SceneUpdateGraph::~SceneUpdateGraph() = default;
+
+void SceneUpdateGraph::Add(StringHash eventType, LogicComponent* component)
+{
+    if (isExecuting_)
+    {
+        MutexLock lock(pendingOperationsMutex_);
+        pendingOperations_.push_back(PendingOperation{eventType, component, true});
+        return;
+    }
+
+    AddImmediate(eventType, component);
+}
+
+void SceneUpdateGraph::Remove(StringHash eventType, LogicComponent* component)
+{
+    if (isExecuting_)
+    {
+        MutexLock lock(pendingOperationsMutex_);
+        pendingOperations_.push_back(PendingOperation{eventType, component, false});
+        return;
+    }
+
+    RemoveImmediate(eventType, component);
+}
+
+void SceneUpdateGraph::MarkDirty()
+{
+    for (auto& [eventType, phase] : phases_)
+        phase.dirty_ = true;
+}
+
+void SceneUpdateGraph::Update(StringHash eventType, float timeStep)
+{
+    const auto iter = phases_.find(eventType);
+    if (iter == phases_.end())
+        return;
+
+    UpdatePhase& phase = iter->second;
+    if (phase.hasPendingStart_)
+        StartComponents(eventType, phase);
+
+    if (phase.dirty_)
+        RebuildStages(phase);
+
+    if (phase.sortedComponents_.empty())
+        return;
+
+    URHO3D_PROFILE("ScheduledSceneUpdate");
+
+    scene_->BeginThreadedUpdate();
+    isExecuting_ = true;
+
+    const unsigned numStages = phase.stageOffsets_.size() - 1;
+    for (unsigned stageIndex = 0; stageIndex < numStages; ++stageIndex)
+    {
+        const unsigned stageBegin = phase.stageOffsets_[stageIndex];
+        const unsigned stageSize = phase.stageOffsets_[stageIndex + 1] - stageBegin;
+        LogicComponent** components = phase.sortedComponents_.data() + stageBegin;
+
+        const auto updateRange = [&](unsigned beginIndex, unsigned endIndex)
+        {
+            for (unsigned i = beginIndex; i < endIndex; ++i)
+                components[i]->ScheduledUpdate(eventType, timeStep);
+        };
+
+        if (workQueue_)
+            ForEachParallel(workQueue_, ComponentsPerTask, stageSize, updateRange);
+        else
+            updateRange(0, stageSize);
+    }
+
+    isExecuting_ = false;
+    scene_->EndThreadedUpdate();
+
+    ApplyPendingOperations();
+}
+
+unsigned SceneUpdateGraph::GetNumComponents(StringHash eventType) const
+{
+    const auto iter = phases_.find(eventType);
+    return iter != phases_.end() ? iter->second.indices_.size() : 0;
+}
+
+unsigned SceneUpdateGraph::GetNumStages(StringHash eventType) const
+{
+    const auto iter = phases_.find(eventType);
+    if (iter == phases_.end() || iter->second.stageOffsets_.empty())
+        return 0;
+    return iter->second.stageOffsets_.size() - 1;
+}
+
+void SceneUpdateGraph::AddImmediate(StringHash eventType, LogicComponent* component)
+{
+    UpdatePhase& phase = phases_[eventType];
+    if (phase.indices_.contains(component))
+        return;
+
+    phase.indices_.emplace(component, phase.components_.size());
+    phase.components_.push_back(component);
+    phase.dirty_ = true;
+
+    if (!component->IsDelayedStartCalled() && component->GetUpdateEvent() == eventType)
+        phase.hasPendingStart_ = true;
+}
+
+void SceneUpdateGraph::RemoveImmediate(StringHash eventType, LogicComponent* component)
+{
+    const auto phaseIter = phases_.find(eventType);
+    if (phaseIter == phases_.end())
+        return;
+
+    UpdatePhase& phase = phaseIter->second;
+    const auto iter = phase.indices_.find(component);
+    if (iter == phase.indices_.end())
+        return;
+
+    phase.components_[iter->second] = nullptr;
+    phase.indices_.erase(iter);
+    ++phase.numRemoved_;
+    phase.dirty_ = true;
+}
+
+void SceneUpdateGraph::ApplyPendingOperations()
+{
+    if (pendingOperations_.empty())
+        return;
+
+    for (const PendingOperation& operation : pendingOperations_)
+    {
+        if (operation.add_)
+            AddImmediate(operation.eventType_, operation.component_);
+        else
+            RemoveImmediate(operation.eventType_, operation.component_);
+    }
+    pendingOperations_.clear();
+}
+
+void SceneUpdateGraph::StartComponents(StringHash eventType, UpdatePhase& phase)
+{
+    phase.hasPendingStart_ = false;
+
+    // DelayedStart is executed from main thread because it is allowed to modify the scene.
+    // Components added here are appended to the end and started in the same loop.
+    for (unsigned i = 0; i < phase.components_.size(); ++i)
+    {
+        LogicComponent* component = phase.components_[i];
+        if (component && !component->IsDelayedStartCalled())
+            component->ScheduledDelayedStart();
+    }
+}
+
+void SceneUpdateGraph::RebuildStages(UpdatePhase& phase)
+{
+    URHO3D_PROFILE("RebuildSceneUpdateGraph");
+
+    phase.dirty_ = false;
+
+    if (phase.numRemoved_ > 0)
+    {
+        ea::erase(phase.components_, nullptr);
+        for (unsigned i = 0; i < phase.components_.size(); ++i)
+            phase.indices_[phase.components_[i]] = i;
+        phase.numRemoved_ = 0;
+    }
+
+    // Stored stage values are "first stage that doesn't conflict", i.e. last access stage + 1.
+    // For resources, first value is for readers and second is for writers.
+    tempComponentStages_.clear();
+    tempNodeStages_.clear();
+    tempResourceStages_.clear();
+
+    unsigned minStage = 0;
+    unsigned numStages = 0;
+    for (LogicComponent* component : phase.components_)
+    {
+        tempAccess_.Clear();
+        component->DeclareUpdateAccess(tempAccess_);
+
+        unsigned stage = minStage;
+        if (tempAccess_.IsExclusive())
+        {
+            stage = numStages;
+            minStage = stage + 1;
+        }
+        else
+        {
+            for (Node* node : tempAccess_.GetNodeTransforms())
+            {
+                const auto iter = tempNodeStages_.find(GetTopLevelNode(node));
+                if (iter != tempNodeStages_.end())
+                    stage = ea::max(stage, iter->second);
+            }
+            for (StringHash resource : tempAccess_.GetReads())
+            {
+                const auto iter = tempResourceStages_.find(resource);
+                if (iter != tempResourceStages_.end())
+                    stage = ea::max(stage, iter->second.second);
+            }
+            for (StringHash resource : tempAccess_.GetWrites())
+            {
+                const auto iter = tempResourceStages_.find(resource);
+                if (iter != tempResourceStages_.end())
+                    stage = ea::max({stage, iter->second.first, iter->second.second});
+            }
+
+            for (Node* node : tempAccess_.GetNodeTransforms())
+                tempNodeStages_[GetTopLevelNode(node)] = stage + 1;
+            for (StringHash resource : tempAccess_.GetReads())
+            {
+                auto& resourceStages = tempResourceStages_[resource];
+                resourceStages.first = ea::max(resourceStages.first, stage + 1);
+            }
+            for (StringHash resource : tempAccess_.GetWrites())
+                tempResourceStages_[resource].second = stage + 1;
+        }
+
+        numStages = ea::max(numStages, stage + 1);
+        tempComponentStages_.push_back(stage);
+    }
+
+    // Sort components by stages preserving registration order within stage
+    tempStageSizes_.clear();
+    tempStageSizes_.resize(numStages, 0);
+    for (unsigned stage : tempComponentStages_)
+        ++tempStageSizes_[stage];
+
+    phase.stageOffsets_.resize(numStages + 1);
+    phase.stageOffsets_[0] = 0;
+    for (unsigned stage = 0; stage < numStages; ++stage)
+    {
+        phase.stageOffsets_[stage + 1] = phase.stageOffsets_[stage] + tempStageSizes_[stage];
+        tempStageSizes_[stage] = phase.stageOffsets_[stage];
+    }
+
+    phase.sortedComponents_.resize(phase.components_.size());
+    for (unsigned i = 0; i < phase.components_.size(); ++i)
+        phase.sortedComponents_[tempStageSizes_[tempComponentStages_[i]]++] = phase.components_[i];
+}
+
+Node* SceneUpdateGraph::GetTopLevelNode(Node* node) const
+{
+    while (node->GetParent() && node->GetParent() != scene_)
+        node = node->GetParent();
+    return node;
+}
+
+}
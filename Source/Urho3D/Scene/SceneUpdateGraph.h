@@ -0,0 +1,175 @@
+//
+// Copyright (c) 2017-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/// \file
+
+#pragma once
+
+#include "Urho3D/Core/Mutex.h"
+#include "Urho3D/Core/NonCopyable.h"
+#include "Urho3D/Math/StringHash.h"
+
+#include <EASTL/unordered_map.h>
+#include <EASTL/vector.h>
+
+namespace Urho3D
+{
+
+class LogicComponent;
+class Node;
+class Scene;
+class WorkQueue;
+
+/// Set of resources that are read or written by scheduled update of the component.
+/// State owned by the component itself is always accessible and should not be declared.
+class URHO3D_API SceneUpdateAccess
+{
+public:
+    /// Declare access to transforms of the node. World transforms are evaluated lazily and the evaluation
+    /// modifies the node and its children, so transform access is exclusive within top-level node of the scene.
+    void NodeTransform(Node* node);
+    /// Declare read-only access to shared resource, e.g. subsystem or another component.
+    void Read(StringHash resource);
+    /// Declare write access to shared resource.
+    void Write(StringHash resource);
+    /// Declare read-only access to subsystem or shared component of given type.
+    template <class T> void Read() { Read(T::GetTypeStatic()); }
+    /// Declare write access to subsystem or shared component of given type.
+    template <class T> void Write() { Write(T::GetTypeStatic()); }
+    /// Declare that the update may touch anything. Such update is never executed in parallel with others.
+    void Exclusive() { exclusive_ = true; }
+
+    /// Reset all declarations.
+    void Clear();
+
+    /// Return declared node transforms.
+    const ea::vector<Node*>& GetNodeTransforms() const { return nodeTransforms_; }
+    /// Return declared read-only resources.
+    const ea::vector<StringHash>& GetReads() const { return reads_; }
+    /// Return declared writable resources.
+    const ea::vector<StringHash>& GetWrites() const { return writes_; }
+    /// Return whether exclusive access is requested.
+    bool IsExclusive() const { return exclusive_; }
+
+private:
+    ea::vector<Node*> nodeTransforms_;
+    ea::vector<StringHash> reads_;
+    ea::vector<StringHash> writes_;
+    bool exclusive_{};
+};
+
+/// Dependency-aware scheduler of LogicComponent updates used by Scene in scheduled update mode.
+/// Components of each update event are split into stages so that components within a stage
+/// don't access the same resources, and conflicting components keep their registration order.
+/// Stages are executed one by one, components within stage are executed in parallel on WorkQueue.
+class URHO3D_API SceneUpdateGraph : public NonCopyable
+{
+public:
+    /// Number of components processed by one task.
+    static constexpr unsigned ComponentsPerTask = 16;
+
+    /// Construct.
+    explicit SceneUpdateGraph(Scene* scene);
+    /// Destruct.
+    ~SceneUpdateGraph();
+
+    /// Add component to be updated on given update event.
+    void Add(StringHash eventType, LogicComponent* component);
+    /// Remove component from given update event.
+    void Remove(StringHash eventType, LogicComponent* component);
+    /// Invalidate all stages. Should be called whenever declared access may have changed, e.g. on reparenting.
+    void MarkDirty();
+
+    /// Execute components of given update event. Should be called from main thread.
+    void Update(StringHash eventType, float timeStep);
+
+    /// Return number of components for given update event.
+    unsigned GetNumComponents(StringHash eventType) const;
+    /// Return number of stages for given update event. Stages are rebuilt lazily on next update.
+    unsigned GetNumStages(StringHash eventType) const;
+
+private:
+    /// Components and stages of one update event.
+    struct UpdatePhase
+    {
+        /// Components in registration order. Removed components are replaced with null.
+        ea::vector<LogicComponent*> components_;
+        /// Indices of components in components_.
+        ea::unordered_map<LogicComponent*, unsigned> indices_;
+        /// Number of removed components in components_.
+        unsigned numRemoved_{};
+        /// Whether there are components that have not started yet.
+        bool hasPendingStart_{};
+        /// Whether stages should be rebuilt.
+        bool dirty_{true};
+
+        /// Components sorted by stages.
+        ea::vector<LogicComponent*> sortedComponents_;
+        /// Offsets of stages in sortedComponents_, including end offset.
+        ea::vector<unsigned> stageOffsets_;
+    };
+
+    /// Pending modification requested during parallel execution.
+    struct PendingOperation
+    {
+        StringHash eventType_;
+        LogicComponent* component_{};
+        bool add_{};
+    };
+
+    /// Add or remove component immediately.
+    void AddImmediate(StringHash eventType, LogicComponent* component);
+    void RemoveImmediate(StringHash eventType, LogicComponent* component);
+    /// Apply operations posted during parallel execution.
+    void ApplyPendingOperations();
+    /// Call DelayedStart for all components that haven't started yet.
+    void StartComponents(StringHash eventType, UpdatePhase& phase);
+    /// Remove null components and rebuild stages.
+    void RebuildStages(UpdatePhase& phase);
+    /// Return top-level node of the scene that contains the node.
+    Node* GetTopLevelNode(Node* node) const;
+
+    /// Scene.
+    Scene* scene_{};
+    /// Work queue.
+    WorkQueue* workQueue_{};
+    /// Update phases.
+    ea::unordered_map<StringHash, UpdatePhase> phases_;
+
+    /// Whether components are being executed in parallel.
+    bool isExecuting_{};
+    /// Operations posted during execution.
+    ea::vector<PendingOperation> pendingOperations_;
+    /// Mutex for pending operations.
+    Mutex pendingOperationsMutex_;
+
+    /// Temporary buffers used to rebuild stages.
+    /// @{
+    SceneUpdateAccess tempAccess_;
+    ea::vector<unsigned> tempComponentStages_;
+    ea::vector<unsigned> tempStageSizes_;
+    ea::unordered_map<Node*, unsigned> tempNodeStages_;
+    ea::unordered_map<StringHash, ea::pair<unsigned, unsigned>> tempResourceStages_;
+    /// @}
+};
+
+}
@@ -0,0 +1,278 @@
+//
+// Copyright (c) 2017-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "Urho3D/Precompiled.h"
+
+#include "Urho3D/Scene/TransformHierarchy.h"
+
+#include "Urho3D/Core/Profiler.h"
+#include "Urho3D/Core/WorkQueue.h"
+#include "Urho3D/Scene/Scene.h"
+
+#include <EASTL/fixed_vector.h>
+
+#include "Urho3D/DebugNew.h"
+
+namespace Urho3D
+{
+
+TransformHierarchy::TransformHierarchy(Scene* scene)
+    : scene_(scene)
+    , workQueue_(scene->GetSubsystem<WorkQueue>())
+{
+}
+
+TransformHierarchy::~TransformHierarchy()
+{
+    if (!structureDirty_)
+    {
+        UpdateDirtyNodes();
+        DetachNodes();
+    }
+}
+
+void TransformHierarchy::MarkStructureDirty()
+{
+    if (structureDirty_)
+        return;
+
+    // Listeners are notified after detaching, so they observe nodes in the same state as after Node::MarkDirty
+    UpdateDirtyNodes();
+    DetachNodes();
+    NotifyDirtyNodes();
+}
+
+void TransformHierarchy::Update()
+{
+    if (!structureDirty_ && !hasDirtyNodes_.load(std::memory_order_relaxed))
+    {
+        numUpdatedNodes_ = 0;
+        return;
+    }
+
+    URHO3D_PROFILE("UpdateTransformHierarchy");
+
+    if (structureDirty_)
+        AttachNodes();
+
+    UpdateDirtyNodes();
+    NotifyDirtyNodes();
+}
+
+void TransformHierarchy::AttachNodes()
+{
+    URHO3D_PROFILE("AttachTransformHierarchy");
+
+    structureDirty_ = false;
+
+    nodes_.clear();
+    parentIndices_.clear();
+    levelOffsets_.clear();
+
+    for (Node* child : scene_->GetChildren())
+    {
+        nodes_.push_back(child);
+        parentIndices_.push_back(M_MAX_UNSIGNED);
+    }
+
+    // Breadth-first traversal yields nodes sorted by depth
+    unsigned levelBegin = 0;
+    while (levelBegin < nodes_.size())
+    {
+        const unsigned levelEnd = nodes_.size();
+        levelOffsets_.push_back(levelBegin);
+
+        for (unsigned parentIndex = levelBegin; parentIndex < levelEnd; ++parentIndex)
+        {
+            for (Node* child : nodes_[parentIndex]->GetChildren())
+            {
+                nodes_.push_back(child);
+                parentIndices_.push_back(parentIndex);
+            }
+        }
+
+        levelBegin = levelEnd;
+    }
+    if (!nodes_.empty())
+        levelOffsets_.push_back(nodes_.size());
+
+    const unsigned numNodes = nodes_.size();
+    dirtyFlags_ = ea::make_unique<std::atomic<bool>[]>(numNodes);
+    worldTransforms_.resize(numNodes);
+    worldRotations_.resize(numNodes);
+
+    // Nodes that are still dirty after detached mode are updated by the next batch
+    bool hasDirtyNodes = false;
+    for (unsigned i = 0; i < numNodes; ++i)
+    {
+        Node* node = nodes_[i];
+        const bool isDirty = node->dirty_;
+        dirtyFlags_[i].store(isDirty, std::memory_order_relaxed);
+        hasDirtyNodes |= isDirty;
+        if (!isDirty)
+        {
+            worldTransforms_[i] = node->worldTransform_;
+            worldRotations_[i] = node->worldRotation_;
+        }
+
+        node->hierarchy_ = this;
+        node->hierarchyIndex_ = i;
+        node->dirty_ = false;
+    }
+    hasDirtyNodes_.store(hasDirtyNodes, std::memory_order_relaxed);
+}
+
+void TransformHierarchy::DetachNodes()
+{
+    structureDirty_ = true;
+
+    const unsigned numNodes = nodes_.size();
+    for (unsigned i = 0; i < numNodes; ++i)
+    {
+        Node* node = nodes_[i];
+        node->worldTransform_ = worldTransforms_[i];
+        node->worldRotation_ = worldRotations_[i];
+        node->dirty_ = false;
+        node->hierarchy_ = nullptr;
+    }
+
+    nodes_.clear();
+    parentIndices_.clear();
+    levelOffsets_.clear();
+    dirtyFlags_ = nullptr;
+    hasDirtyNodes_.store(false, std::memory_order_relaxed);
+}
+
+void TransformHierarchy::UpdateDirtyNodes()
+{
+    numUpdatedNodes_ = 0;
+    dirtyNodes_.clear();
+    if (!hasDirtyNodes_.load(std::memory_order_relaxed))
+        return;
+
+    // Parents are always on previous levels, so dirty flags are propagated level by level
+    const unsigned numLevels = GetNumLevels();
+    for (unsigned level = 0; level < numLevels; ++level)
+    {
+        const unsigned levelBegin = levelOffsets_[level];
+        const unsigned levelSize = levelOffsets_[level + 1] - levelBegin;
+
+        const auto updateRange = [&](unsigned beginIndex, unsigned endIndex)
+        {
+            UpdateNodes(levelBegin + beginIndex, levelBegin + endIndex);
+        };
+
+        if (workQueue_)
+            ForEachParallel(workQueue_, NodesPerTask, levelSize, updateRange);
+        else
+            updateRange(0, levelSize);
+    }
+
+    const unsigned numNodes = nodes_.size();
+    for (unsigned i = 0; i < numNodes; ++i)
+    {
+        if (dirtyFlags_[i].load(std::memory_order_relaxed))
+        {
+            dirtyFlags_[i].store(false, std::memory_order_relaxed);
+            dirtyNodes_.push_back(nodes_[i]);
+        }
+    }
+    hasDirtyNodes_.store(false, std::memory_order_relaxed);
+    numUpdatedNodes_ = dirtyNodes_.size();
+}
+
+void TransformHierarchy::UpdateNodes(unsigned beginIndex, unsigned endIndex)
+{
+    for (unsigned i = beginIndex; i < endIndex; ++i)
+    {
+        const unsigned parentIndex = parentIndices_[i];
+        const bool isParentDirty = parentIndex != M_MAX_UNSIGNED
+            && dirtyFlags_[parentIndex].load(std::memory_order_relaxed);
+
+        if (isParentDirty)
+            dirtyFlags_[i].store(true, std::memory_order_relaxed);
+        else if (!dirtyFlags_[i].load(std::memory_order_relaxed))
+            continue;
+
+        EvaluateNode(i);
+    }
+}
+
+void TransformHierarchy::NotifyDirtyNodes()
+{
+    // Listeners may update transforms recursively, so iterate over a detached copy of the list
+    ea::vector<Node*> dirtyNodes = ea::move(dirtyNodes_);
+    dirtyNodes_.clear();
+
+    for (Node* node : dirtyNodes)
+        node->NotifyListeners();
+
+    if (dirtyNodes_.empty())
+    {
+        dirtyNodes.clear();
+        dirtyNodes_ = ea::move(dirtyNodes);
+    }
+}
+
+bool TransformHierarchy::IsNodeOrParentDirty(unsigned index) const
+{
+    for (unsigned i = index; i != M_MAX_UNSIGNED; i = parentIndices_[i])
+    {
+        if (dirtyFlags_[i].load(std::memory_order_relaxed))
+            return true;
+    }
+    return false;
+}
+
+void TransformHierarchy::EvaluateDirtyNode(unsigned index) const
+{
+    // Parents above the topmost dirty node are up to date
+    ea::fixed_vector<unsigned, 32> chain;
+    unsigned numDirtyChainNodes = 0;
+    for (unsigned i = index; i != M_MAX_UNSIGNED; i = parentIndices_[i])
+    {
+        chain.push_back(i);
+        if (dirtyFlags_[i].load(std::memory_order_relaxed))
+            numDirtyChainNodes = chain.size();
+    }
+
+    for (unsigned i = numDirtyChainNodes; i > 0; --i)
+        EvaluateNode(chain[i - 1]);
+}
+
+void TransformHierarchy::EvaluateNode(unsigned index) const
+{
+    const Node* node = nodes_[index];
+    const unsigned parentIndex = parentIndices_[index];
+    if (parentIndex == M_MAX_UNSIGNED)
+    {
+        worldTransforms_[index] = node->GetTransformMatrix();
+        worldRotations_[index] = node->rotation_;
+    }
+    else
+    {
+        worldTransforms_[index] = worldTransforms_[parentIndex] * node->GetTransformMatrix();
+        worldRotations_[index] = worldRotations_[parentIndex] * node->rotation_;
+    }
+}
+
+}
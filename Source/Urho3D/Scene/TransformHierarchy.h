@@ -0,0 +1,147 @@
+//
+// Copyright (c) 2017-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/// \file
+
+#pragma once
+
+#include "Urho3D/Core/NonCopyable.h"
+#include "Urho3D/Math/Matrix3x4.h"
+#include "Urho3D/Math/Quaternion.h"
+
+#include <EASTL/unique_ptr.h>
+#include <EASTL/vector.h>
+
+#include <atomic>
+
+namespace Urho3D
+{
+
+class Node;
+class Scene;
+class WorkQueue;
+
+/// Flat storage of scene node hierarchy and world transforms used in batched transform update mode.
+/// While the hierarchy is attached, Node::MarkDirty only sets the dirty flag of the node itself,
+/// and world transforms of nodes are read from this storage.
+/// Update propagates dirty flags level by level, recalculates world transforms of dirty nodes in parallel
+/// and notifies node listeners from the main thread.
+/// Any change of scene structure detaches all nodes until the next update.
+class URHO3D_API TransformHierarchy : public NonCopyable
+{
+public:
+    /// Number of nodes processed by one task.
+    static constexpr unsigned NodesPerTask = 256;
+
+    /// Construct.
+    explicit TransformHierarchy(Scene* scene);
+    /// Destruct. Detaches all nodes.
+    ~TransformHierarchy();
+
+    /// Detach all nodes and invalidate node list. Should be called whenever nodes are added, removed or reparented.
+    void MarkStructureDirty();
+    /// Attach nodes if needed, update world transforms of all dirty nodes and notify their listeners.
+    /// Should be called from main thread.
+    void Update();
+
+    /// Mark node dirty. May be called from worker threads for different nodes.
+    void MarkNodeDirty(unsigned index)
+    {
+        dirtyFlags_[index].store(true, std::memory_order_relaxed);
+        hasDirtyNodes_.store(true, std::memory_order_relaxed);
+    }
+    /// Return whether the node or any of its parents is dirty.
+    bool IsNodeDirty(unsigned index) const
+    {
+        return hasDirtyNodes_.load(std::memory_order_relaxed) && IsNodeOrParentDirty(index);
+    }
+    /// Return world transform of the node. Dirty nodes are evaluated on demand.
+    const Matrix3x4& GetWorldTransform(unsigned index) const
+    {
+        if (IsNodeDirty(index))
+            EvaluateDirtyNode(index);
+        return worldTransforms_[index];
+    }
+    /// Return world rotation of the node. Dirty nodes are evaluated on demand.
+    const Quaternion& GetWorldRotation(unsigned index) const
+    {
+        if (IsNodeDirty(index))
+            EvaluateDirtyNode(index);
+        return worldRotations_[index];
+    }
+
+    /// Return whether the nodes are attached to the hierarchy.
+    bool IsAttached() const { return !structureDirty_; }
+    /// Return number of nodes in the hierarchy. Updated lazily.
+    unsigned GetNumNodes() const { return nodes_.size(); }
+    /// Return number of hierarchy levels. Updated lazily.
+    unsigned GetNumLevels() const { return levelOffsets_.empty() ? 0 : levelOffsets_.size() - 1; }
+    /// Return number of nodes updated during last update.
+    unsigned GetNumUpdatedNodes() const { return numUpdatedNodes_; }
+
+private:
+    /// Collect nodes of the scene sorted by depth and attach them to the hierarchy.
+    void AttachNodes();
+    /// Detach all nodes from the hierarchy and store world transforms in nodes. Dirty nodes should be updated first.
+    void DetachNodes();
+    /// Propagate dirty flags and update world transforms of dirty nodes.
+    /// Dirty nodes are collected into dirtyNodes_ and their dirty flags are reset.
+    void UpdateDirtyNodes();
+    /// Propagate dirty flags and update world transforms of dirty nodes within one level.
+    void UpdateNodes(unsigned beginIndex, unsigned endIndex);
+    /// Notify listeners of nodes collected by UpdateDirtyNodes.
+    void NotifyDirtyNodes();
+    /// Return whether the node or any of its parents has dirty flag.
+    bool IsNodeOrParentDirty(unsigned index) const;
+    /// Evaluate world transform of dirty node and its dirty parents from local transforms.
+    void EvaluateDirtyNode(unsigned index) const;
+    /// Evaluate world transform of the node from world transform of its parent.
+    void EvaluateNode(unsigned index) const;
+
+    /// Scene.
+    Scene* scene_{};
+    /// Work queue.
+    WorkQueue* workQueue_{};
+    /// Whether the nodes are detached and node list should be rebuilt.
+    bool structureDirty_{true};
+    /// Number of nodes updated during last update.
+    unsigned numUpdatedNodes_{};
+
+    /// Nodes sorted by depth.
+    ea::vector<Node*> nodes_;
+    /// Offsets of levels in nodes_, including end offset.
+    ea::vector<unsigned> levelOffsets_;
+    /// Indices of parent nodes. Top-level nodes of the scene have M_MAX_UNSIGNED.
+    ea::vector<unsigned> parentIndices_;
+    /// Whether the node is marked dirty since last update.
+    ea::unique_ptr<std::atomic<bool>[]> dirtyFlags_;
+    /// Whether any node is marked dirty since last update.
+    std::atomic<bool> hasDirtyNodes_{};
+    /// World transforms. Dirty nodes are evaluated on demand, hence mutable.
+    mutable ea::vector<Matrix3x4> worldTransforms_;
+    /// World rotations.
+    mutable ea::vector<Quaternion> worldRotations_;
+    /// Nodes updated during last update whose listeners should be notified.
+    ea::vector<Node*> dirtyNodes_;
+};
+
+}
@@ -27,8 +27,10 @@
 
 #include "../Core/Context.h"
 #include "../Core/CoreEvents.h"
+#include "../Core/FrameProfiler.h"
 #include "../Core/Profiler.h"
 #include "../Engine/Engine.h"
+#include "../Graphics/AnimationScheduler.h"
 #include "../Graphics/Graphics.h"
 #include "../Graphics/GraphicsEvents.h"
 #include "../Graphics/Renderer.h"
@@ -169,6 +171,19 @@ void DebugHud::RenderUI(DebugHudModeFlags mode)
         ui::SetCursorPosX(left_offset);
         ui::Text("Animations %u(%u)", stats.animations_, numChangedAnimations_[0]);
         ui::SetCursorPosX(left_offset);
+        if (auto animationScheduler = GetSubsystem<AnimationScheduler>(); animationScheduler && animationScheduler->IsEnabled())
+        {
+            const AnimationSchedulerStats& animationStats = animationScheduler->GetStats();
+            for (unsigned tier = 0; tier < MAX_ANIMATION_LOD_TIERS; ++tier)
+            {
+                const AnimationLodTierStats& tierStats = animationStats.tiers_[tier];
+                ui::Text("Animation LOD %u: %u/%u (%u interpolated, %u deferred)", tier, tierStats.numUpdated_,
+                    tierStats.numModels_, tierStats.numInterpolated_, tierStats.numDeferred_);
+                ui::SetCursorPosX(left_offset);
+            }
+            ui::Text("Animation time %.2f ms", animationStats.animationTime_ / 1000.0f);
+            ui::SetCursorPosX(left_offset);
+        }
 
         for (auto i = appStats_.begin(); i != appStats_.end(); ++i)
         {
@@ -177,6 +192,9 @@ void DebugHud::RenderUI(DebugHudModeFlags mode)
         }
     }
 
+    if (mode & DEBUGHUD_SHOW_PROFILER)
+        RenderProfilerUI();
+
     if (mode & DEBUGHUD_SHOW_MODE)
     {
         // TODO: Add more stats?
@@ -190,6 +208,28 @@ void DebugHud::RenderUI(DebugHudModeFlags mode)
     }
 }
 
+void DebugHud::RenderProfilerUI()
+{
+    auto profiler = GetSubsystem<FrameProfiler>();
+    if (!profiler || !profiler->IsEnabled())
+        return;
+
+    const float left_offset = ui::GetCursorPos().x;
+
+    ui::Text("Frame %.2f ms", profiler->GetFrameDurationMs());
+    ui::SetCursorPosX(left_offset);
+
+    const auto& frameStats = profiler->GetFrameStats();
+    const unsigned numScopes = ea::min<unsigned>(frameStats.size(), maxProfilerScopes_);
+    for (unsigned i = 0; i < numScopes; ++i)
+    {
+        const FrameProfilerScopeStats& stats = frameStats[i];
+        ui::Text("%.*s %.2f ms (max %.2f ms, x%u)", static_cast<int>(stats.name_.size()), stats.name_.data(),
+            stats.totalMs_, stats.maxMs_, stats.count_);
+        ui::SetCursorPosX(left_offset);
+    }
+}
+
 void DebugHud::OnRenderDebugUI(StringHash, VariantMap&)
 {
     const ImGuiContext& g = *ui::GetCurrentContext();
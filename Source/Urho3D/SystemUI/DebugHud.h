@@ -38,6 +38,7 @@ enum DebugHudMode : unsigned
     DEBUGHUD_SHOW_NONE = 0x0,
     DEBUGHUD_SHOW_STATS = 0x1,
     DEBUGHUD_SHOW_MODE = 0x2,
+    DEBUGHUD_SHOW_PROFILER = 0x4,
     DEBUGHUD_SHOW_ALL = 0x7,
 };
 URHO3D_FLAGSET(DebugHudMode, DebugHudModeFlags);
@@ -85,6 +86,8 @@ public:
 private:
     /// Render debug hud on to entire viewport.
     void OnRenderDebugUI(StringHash, VariantMap&);
+    /// Render frame profiler stats.
+    void RenderProfilerUI();
 
     /// Hashmap containing application specific stats.
     ea::map<ea::string, ea::string> appStats_{};
@@ -95,6 +98,8 @@ private:
     /// Calculated fps
     unsigned fps_ = 0;
     unsigned numChangedAnimations_[2]{};
+    /// Max number of profiler scopes to show.
+    unsigned maxProfilerScopes_{16};
 };
 
 }
@@ -327,10 +327,14 @@ void Renderer2D::HandleBeginViewUpdate(StringHash eventType, VariantMap& eventDa
         URHO3D_PROFILE("CheckDrawableVisibility");
 
         auto* queue = GetSubsystem<WorkQueue>();
-        ForEachParallel(queue, drawables_, [this](unsigned, Drawable2D* drawable)
+        queue->ParallelFor(drawables_.size(), DrawablesPerTask, [this](unsigned beginIndex, unsigned endIndex)
         {
-            if (CheckVisibility(drawable))
-                drawable->MarkInView(frame_);
+            for (unsigned i = beginIndex; i < endIndex; ++i)
+            {
+                Drawable2D* drawable = drawables_[i];
+                if (CheckVisibility(drawable))
+                    drawable->MarkInView(frame_);
+            }
         });
     }
 
@@ -72,6 +72,9 @@ class URHO3D_API Renderer2D : public Drawable
     URHO3D_OBJECT(Renderer2D, Drawable);
 
 public:
+    /// Minimal number of drawables checked for visibility by one task.
+    static constexpr unsigned DrawablesPerTask = 64;
+
     /// Construct.
     explicit Renderer2D(Context* context);
     /// Destruct.
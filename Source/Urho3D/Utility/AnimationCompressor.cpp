@@ -0,0 +1,75 @@
+//
+// Copyright (c) 2022-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Utility/AnimationCompressor.h"
+
+#include "../IO/Log.h"
+#include "../Resource/ResourceCache.h"
+
+namespace Urho3D
+{
+
+AnimationCompressor::AnimationCompressor(Context* context)
+    : AssetTransformer(context)
+{
+}
+
+AnimationCompressor::~AnimationCompressor()
+{
+}
+
+void AnimationCompressor::RegisterObject(Context* context)
+{
+    context->RegisterFactory<AnimationCompressor>(Category_Transformer);
+
+    URHO3D_ATTRIBUTE("Position Tolerance", float, settings_.positionTolerance_, DefaultPositionTolerance, AM_DEFAULT);
+    URHO3D_ATTRIBUTE("Rotation Tolerance", float, settings_.rotationTolerance_, DefaultRotationTolerance, AM_DEFAULT);
+    URHO3D_ATTRIBUTE("Scale Tolerance", float, settings_.scaleTolerance_, DefaultScaleTolerance, AM_DEFAULT);
+}
+
+bool AnimationCompressor::IsApplicable(const AssetTransformerInput& input)
+{
+    return input.inputFileName_.ends_with(".ani", false);
+}
+
+bool AnimationCompressor::Execute(
+    const AssetTransformerInput& input, AssetTransformerOutput& output, const AssetTransformerVector& transformers)
+{
+    auto cache = GetSubsystem<ResourceCache>();
+    auto animation = cache->GetResource<Animation>(input.resourceName_);
+    if (!animation)
+        return false;
+
+    const AnimationCompressionStats stats = animation->CompressTracks(settings_);
+    if (stats.originalKeyFrames_ == 0)
+        return true;
+
+    URHO3D_LOGINFO("Animation '{}' is compressed: {} -> {} keyframes, {} -> {} bytes, "
+        "max error: position {}, rotation {} deg, scale {}",
+        input.resourceName_, stats.originalKeyFrames_, stats.compressedKeyFrames_, stats.originalSize_,
+        stats.compressedSize_, stats.maxPositionError_, stats.maxRotationError_, stats.maxScaleError_);
+
+    animation->SaveFile(animation->GetAbsoluteFileName());
+    return true;
+}
+
+}
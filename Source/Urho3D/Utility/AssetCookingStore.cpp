@@ -0,0 +1,319 @@
+//
+// Copyright (c) 2025-2025 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../Precompiled.h"
+
+#include "../Utility/AssetCookingStore.h"
+
+#include "../Core/ProcessUtils.h"
+#include "../IO/ArchiveSerialization.h"
+#include "../IO/File.h"
+#include "../IO/Log.h"
+#include "../IO/VectorBuffer.h"
+#include "../Resource/JSONFile.h"
+
+#include <EASTL/map.h>
+#include <EASTL/sort.h>
+
+namespace Urho3D
+{
+
+namespace
+{
+
+const ea::string manifestFileName = "Manifest.json";
+const ea::string filesFolderName = "Files/";
+
+ea::string GetDataPath(const AssetTransformerInput& input)
+{
+    return input.originalInputFileName_.substr(
+        0, input.originalInputFileName_.length() - input.originalResourceName_.length());
+}
+
+void AppendFlavorPattern(AssetContentHasher& hasher, const ApplicationFlavorPattern& pattern)
+{
+    const ea::map<ea::string, ApplicationFlavorComponent> sortedComponents(
+        pattern.components_.begin(), pattern.components_.end());
+    hasher.Append(sortedComponents.size());
+    for (const auto& [key, tags] : sortedComponents)
+    {
+        StringVector sortedTags(tags.begin(), tags.end());
+        ea::sort(sortedTags.begin(), sortedTags.end());
+
+        hasher.Append(key);
+        hasher.Append(sortedTags.size());
+        for (const ea::string& tag : sortedTags)
+            hasher.Append(tag);
+    }
+}
+
+ea::optional<ea::string> GetFileContentHash(Context* context, const ea::string& fileName)
+{
+    AssetContentHasher hasher;
+    if (!hasher.AppendFile(context, fileName))
+        return ea::nullopt;
+    return hasher.ToString();
+}
+
+ea::optional<AssetCookingManifest> LoadManifest(Context* context, const ea::string& entryPath)
+{
+    auto jsonFile = MakeShared<JSONFile>(context);
+    AssetCookingManifest manifest;
+    if (!jsonFile->LoadFile(entryPath + manifestFileName) || !jsonFile->LoadObject("Manifest", manifest))
+        return ea::nullopt;
+    return manifest;
+}
+
+} // namespace
+
+void AssetContentHasher::Append(const void* data, unsigned size)
+{
+    const auto bytes = static_cast<const unsigned char*>(data);
+    for (unsigned i = 0; i < size; ++i)
+    {
+        hash_ ^= bytes[i];
+        hash_ *= 0x100000001b3ull;
+    }
+}
+
+void AssetContentHasher::Append(const ea::string& value)
+{
+    Append(value.length());
+    Append(value.data(), value.length());
+}
+
+void AssetContentHasher::Append(unsigned long long value)
+{
+    unsigned char bytes[8];
+    for (unsigned i = 0; i < 8; ++i)
+        bytes[i] = static_cast<unsigned char>(value >> (i * 8));
+    Append(bytes, 8);
+}
+
+bool AssetContentHasher::AppendFile(Context* context, const ea::string& fileName)
+{
+    File file(context, fileName);
+    if (!file.IsOpen())
+        return false;
+
+    const unsigned size = file.GetSize();
+    Append(size);
+
+    unsigned char buffer[64 * 1024];
+    unsigned remaining = size;
+    while (remaining > 0)
+    {
+        const unsigned chunkSize = ea::min(remaining, static_cast<unsigned>(sizeof(buffer)));
+        if (file.Read(buffer, chunkSize) != chunkSize)
+            return false;
+
+        Append(buffer, chunkSize);
+        remaining -= chunkSize;
+    }
+    return true;
+}
+
+ea::string AssetContentHasher::ToString() const
+{
+    return Format("{:016x}", hash_);
+}
+
+void AssetCookingManifest::SerializeInBlock(Archive& archive)
+{
+    SerializeValue(archive, "resourceName", resourceName_);
+    SerializeValue(archive, "outputResourceNames", outputResourceNames_);
+    SerializeValue(archive, "appliedTransformers", appliedTransformers_);
+    SerializeValue(archive, "dependencyHashes", dependencyHashes_);
+}
+
+AssetCookingStore::AssetCookingStore(Context* context)
+    : Object(context)
+{
+}
+
+void AssetCookingStore::SetStorePath(const ea::string& path)
+{
+    storePath_ = path.empty() ? EMPTY_STRING : AddTrailingSlash(path);
+}
+
+ea::string AssetCookingStore::GetEntryPath(const ea::string& key) const
+{
+    return Format("{}{}/{}/", storePath_, key.substr(0, 2), key);
+}
+
+ea::string AssetCookingStore::GetCookingKey(
+    const AssetTransformerInput& input, const AssetTransformerVector& transformers) const
+{
+    return GetCookingKey(input, GetTransformersHash(transformers));
+}
+
+ea::string AssetCookingStore::GetCookingKey(const AssetTransformerInput& input, unsigned long long transformersHash) const
+{
+    AssetContentHasher hasher;
+    hasher.Append(FormatVersion);
+    hasher.Append(input.resourceName_);
+    hasher.Append(input.flavor_.ToString());
+    hasher.Append(transformersHash);
+    if (!hasher.AppendFile(context_, input.inputFileName_))
+        return EMPTY_STRING;
+
+    return hasher.ToString();
+}
+
+unsigned long long AssetCookingStore::GetTransformersHash(const AssetTransformerVector& transformers) const
+{
+    AssetContentHasher hasher;
+    VectorBuffer parameters;
+    hasher.Append(transformers.size());
+    for (AssetTransformer* transformer : transformers)
+    {
+        parameters.Clear();
+        transformer->Save(parameters);
+
+        hasher.Append(transformer->GetTypeName());
+        hasher.Append(transformer->GetVersion());
+        hasher.Append(parameters.GetData(), parameters.GetSize());
+        AppendFlavorPattern(hasher, transformer->GetFlavor());
+    }
+
+    return hasher.GetHash();
+}
+
+ea::optional<AssetTransformerOutput> AssetCookingStore::Restore(
+    const ea::string& key, const AssetTransformerInput& input, const ea::string& outputPath) const
+{
+    if (!IsEnabled() || key.empty())
+        return ea::nullopt;
+
+    auto fs = GetSubsystem<FileSystem>();
+
+    const ea::string entryPath = GetEntryPath(key);
+    if (!fs->FileExists(entryPath + manifestFileName))
+        return ea::nullopt;
+
+    const auto manifest = LoadManifest(context_, entryPath);
+    if (!manifest)
+    {
+        URHO3D_LOGWARNING("Cannot load cooked asset manifest from '{}'", entryPath);
+        return ea::nullopt;
+    }
+
+    if (manifest->resourceName_ != input.resourceName_)
+        return ea::nullopt;
+
+    AssetTransformerOutput output;
+
+    const ea::string dataPath = GetDataPath(input);
+    for (const auto& [dependencyName, dependencyHash] : manifest->dependencyHashes_)
+    {
+        const ea::string dependencyFileName = dataPath + dependencyName;
+        if (GetFileContentHash(context_, dependencyFileName) != dependencyHash)
+            return ea::nullopt;
+
+        output.dependencyModificationTimes_[dependencyName] = fs->GetLastModifiedTime(dependencyFileName, true);
+    }
+
+    for (const ea::string& outputResourceName : manifest->outputResourceNames_)
+    {
+        const ea::string sourceFileName = entryPath + filesFolderName + outputResourceName;
+        const ea::string destinationFileName = outputPath + outputResourceName;
+        if (!fs->CreateDirsRecursive(GetPath(destinationFileName)) || !fs->Copy(sourceFileName, destinationFileName))
+        {
+            URHO3D_LOGWARNING("Cannot restore cooked file '{}' from '{}'", outputResourceName, entryPath);
+            return ea::nullopt;
+        }
+    }
+
+    output.outputResourceNames_ = manifest->outputResourceNames_;
+    output.appliedTransformers_ = manifest->appliedTransformers_;
+    return output;
+}
+
+bool AssetCookingStore::Store(const ea::string& key, const AssetTransformerInput& input,
+    const AssetTransformerOutput& output, const ea::string& outputPath) const
+{
+    // Transformers that modify the source are not reproducible from the source content
+    if (!IsEnabled() || key.empty() || output.sourceModified_)
+        return false;
+
+    auto fs = GetSubsystem<FileSystem>();
+
+    const ea::string entryPath = GetEntryPath(key);
+
+    AssetCookingManifest manifest;
+    manifest.resourceName_ = input.resourceName_;
+    manifest.outputResourceNames_ = output.outputResourceNames_;
+    manifest.appliedTransformers_ = output.appliedTransformers_;
+
+    const ea::string dataPath = GetDataPath(input);
+    for (const auto& [dependencyName, _] : output.dependencyModificationTimes_)
+    {
+        const auto dependencyHash = GetFileContentHash(context_, dataPath + dependencyName);
+        if (!dependencyHash)
+            return false;
+        manifest.dependencyHashes_[dependencyName] = *dependencyHash;
+    }
+
+    // Key doesn't cover dependencies, so existing entry is stale if they have changed since it was stored
+    const bool entryExists = fs->DirExists(entryPath);
+    if (entryExists)
+    {
+        const auto existingManifest = LoadManifest(context_, entryPath);
+        if (existingManifest && existingManifest->resourceName_ == manifest.resourceName_
+            && existingManifest->dependencyHashes_ == manifest.dependencyHashes_)
+            return true;
+    }
+
+    // Populate entry in temporary folder and move it in place at once,
+    // so concurrent readers of shared store never observe partial entry.
+    const ea::string tempPath = Format("{}.{}.tmp/", RemoveTrailingSlash(entryPath), GenerateUUID());
+    const TemporaryDir tempFolderHolder{context_, tempPath};
+
+    for (const ea::string& outputResourceName : output.outputResourceNames_)
+    {
+        const ea::string sourceFileName = outputPath + outputResourceName;
+        const ea::string destinationFileName = tempPath + filesFolderName + outputResourceName;
+        if (!fs->CreateDirsRecursive(GetPath(destinationFileName)) || !fs->Copy(sourceFileName, destinationFileName))
+        {
+            URHO3D_LOGWARNING("Cannot store cooked file '{}' in '{}'", outputResourceName, entryPath);
+            return false;
+        }
+    }
+
+    auto jsonFile = MakeShared<JSONFile>(context_);
+    if (!jsonFile->SaveObject("Manifest", manifest) || !jsonFile->SaveFile(tempPath + manifestFileName))
+        return false;
+
+    // Move stale entry out of the way first. Readers that miss the entry in the meantime will cook the asset
+    if (entryExists)
+    {
+        const ea::string stalePath = Format("{}.{}.stale", RemoveTrailingSlash(entryPath), GenerateUUID());
+        if (fs->Rename(RemoveTrailingSlash(entryPath), stalePath))
+            fs->RemoveDir(stalePath, true);
+    }
+
+    // Another process may have stored the same entry in the meantime, it's fine
+    return fs->Rename(RemoveTrailingSlash(tempPath), RemoveTrailingSlash(entryPath)) || fs->DirExists(entryPath);
+}
+
+} // namespace Urho3D
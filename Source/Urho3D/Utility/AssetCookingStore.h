@@ -0,0 +1,114 @@
+//
+// Copyright (c) 2025-2025 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "../Utility/AssetTransformer.h"
+
+#include <EASTL/optional.h>
+
+namespace Urho3D
+{
+
+/// Incremental 64-bit FNV-1a hash used to address cooked assets.
+class URHO3D_API AssetContentHasher
+{
+public:
+    /// Append raw bytes.
+    void Append(const void* data, unsigned size);
+    /// Append string. String length is hashed too, so the sequence of strings is unambiguous.
+    void Append(const ea::string& value);
+    /// Append integer value.
+    void Append(unsigned long long value);
+    /// Append content of the file. Return false if the file cannot be read.
+    bool AppendFile(Context* context, const ea::string& fileName);
+
+    /// Return current hash value.
+    unsigned long long GetHash() const { return hash_; }
+    /// Return current hash value as a string of 16 hex digits.
+    ea::string ToString() const;
+
+private:
+    unsigned long long hash_{0xcbf29ce484222325ull};
+};
+
+/// Description of cooked asset stored in AssetCookingStore.
+struct URHO3D_API AssetCookingManifest
+{
+    /// Resource name of the source asset.
+    ea::string resourceName_;
+    /// Resource names of the output files.
+    ea::vector<ea::string> outputResourceNames_;
+    /// Types of transformers that were applied to the asset.
+    ea::unordered_set<ea::string> appliedTransformers_;
+    /// Content hashes of other files that were used to generate the output.
+    ea::unordered_map<ea::string, ea::string> dependencyHashes_;
+
+    void SerializeInBlock(Archive& archive);
+};
+
+/// Content-addressed store of cooked assets.
+/// Cooked outputs are keyed by the content of the source file, resource name, flavor
+/// and type, version and parameters of every candidate transformer.
+/// Dependencies discovered during cooking are validated by content on restore.
+/// The store is a plain directory and may be shared between checkouts and machines.
+class URHO3D_API AssetCookingStore : public Object
+{
+    URHO3D_OBJECT(AssetCookingStore, Object);
+
+public:
+    /// Version of the store layout and key format. Increment to invalidate all stored assets.
+    static constexpr unsigned FormatVersion = 2;
+
+    explicit AssetCookingStore(Context* context);
+
+    /// Set path to the store. Empty path disables the store.
+    void SetStorePath(const ea::string& path);
+    const ea::string& GetStorePath() const { return storePath_; }
+    bool IsEnabled() const { return !storePath_.empty(); }
+
+    /// Return cooking key of the asset. Return empty string if the source file cannot be read.
+    ea::string GetCookingKey(const AssetTransformerInput& input, const AssetTransformerVector& transformers) const;
+    /// Return cooking key of the asset for transformers hash returned by GetTransformersHash.
+    /// Safe to call from worker threads.
+    ea::string GetCookingKey(const AssetTransformerInput& input, unsigned long long transformersHash) const;
+    /// Return hash of type, version, parameters and flavor of the transformers.
+    /// Should be called from the main thread because transformers are serialized.
+    unsigned long long GetTransformersHash(const AssetTransformerVector& transformers) const;
+    /// Restore stored outputs into the output path. Return none if there is no valid entry for the key.
+    /// Safe to call from worker threads.
+    ea::optional<AssetTransformerOutput> Restore(
+        const ea::string& key, const AssetTransformerInput& input, const ea::string& outputPath) const;
+    /// Store outputs located in the output path.
+    /// Existing entry is replaced if its dependencies don't match the current ones.
+    bool Store(const ea::string& key, const AssetTransformerInput& input, const AssetTransformerOutput& output,
+        const ea::string& outputPath) const;
+
+    /// Return path to the entry for the key.
+    ea::string GetEntryPath(const ea::string& key) const;
+
+private:
+    ea::string storePath_;
+};
+
+} // namespace Urho3D
@@ -112,6 +112,7 @@ quirks_linux_x64=(
 )
 quirks_linux_clang_x64=(
     '-DURHO3D_PCH=OFF' # Keep PCH disabled somewhere to catch missing includes
+    '-DURHO3D_PHYSICS_THREADED=ON' # Keep multithreaded Bullet built and tested somewhere
 )
 
 # Find msbuild.exe